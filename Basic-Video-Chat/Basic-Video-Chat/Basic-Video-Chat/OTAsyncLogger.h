@@ -0,0 +1,114 @@
+//
+//  OTAsyncLogger.h
+//  Basic-Video-Chat
+//
+//  Copyright (c) 2026 Vonage. All rights reserved.
+//
+
+#ifndef OTAsyncLogger_h
+#define OTAsyncLogger_h
+
+#include <stdarg.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * Logger that never blocks the thread logging a message.
+ *
+ * Each thread writes into its own fixed-size ring, with no lock and no
+ * allocation after the first message of the thread. A background thread
+ * drains the rings, in time order, into a file that is rotated when it gets
+ * too big, or to stderr. Messages below the level are rejected before they
+ * are formatted. When a thread's ring is full its new messages are dropped
+ * and counted rather than waiting.
+ */
+typedef struct otk_logger otk_logger;
+
+enum otk_log_level {
+    OTK_LOG_ERROR = 0,
+    OTK_LOG_WARNING = 1,
+    OTK_LOG_INFO = 2,
+    OTK_LOG_DEBUG = 3,
+    OTK_LOG_VERBOSE = 4,
+};
+
+typedef struct otk_logger_config {
+    /** Messages at or above this level are logged. */
+    enum otk_log_level level;
+    /** File to write to, NULL for stderr. */
+    const char *path;
+    /** The file is rotated when it reaches this size, 0 to never rotate. */
+    uint64_t max_file_bytes;
+    /** Rotated files kept as path.1 to path.N. */
+    uint32_t max_files;
+    /** Messages each thread can have waiting, rounded up to a power of two. */
+    uint32_t ring_capacity;
+    /** How often the background thread writes out waiting messages. */
+    uint32_t flush_interval_ms;
+} otk_logger_config;
+
+typedef struct otk_logger_stats {
+    uint64_t messages_written;
+    /** Messages dropped because their thread's ring was full. */
+    uint64_t messages_dropped;
+    uint64_t bytes_written;
+    uint64_t files_rotated;
+    /** Threads that have logged and still have a ring. */
+    uint32_t threads;
+} otk_logger_stats;
+
+/**
+ * Fills config with the INFO level, stderr, 4 MB files with 3 rotated
+ * files kept, 1024 messages per thread and a 50 ms flush interval.
+ */
+void otk_logger_config_default(otk_logger_config *config);
+
+/** Returns NULL if the file cannot be opened. */
+otk_logger *otk_logger_new(const otk_logger_config *config);
+
+/** Writes out every waiting message and stops the background thread. */
+void otk_logger_delete(otk_logger *logger);
+
+/** Returns whether messages at level would be logged. */
+int otk_logger_enabled(otk_logger *logger, enum otk_log_level level);
+
+void otk_logger_set_level(otk_logger *logger, enum otk_log_level level);
+
+/**
+ * Formats and queues a message. Long messages are truncated. Safe to call
+ * from any thread, including real-time ones once they have logged before.
+ */
+void otk_logger_log(otk_logger *logger, enum otk_log_level level, const char *format, ...)
+    __attribute__((format(printf, 3, 4)));
+
+void otk_logger_logv(otk_logger *logger, enum otk_log_level level, const char *format,
+                     va_list args) __attribute__((format(printf, 3, 0)));
+
+/** Blocks until every message queued before the call is written. */
+void otk_logger_flush(otk_logger *logger);
+
+void otk_logger_get_stats(otk_logger *logger, otk_logger_stats *stats);
+
+/** Process-wide logger used by OTK_LOG_DEFAULT, NULL to log nothing. */
+void otk_logger_set_default(otk_logger *logger);
+otk_logger *otk_logger_default(void);
+
+/** Logs only if the level is enabled, so the arguments are not evaluated otherwise. */
+#define OTK_LOG(logger, level, ...)                                 \
+    do {                                                            \
+        otk_logger *otk_log_logger_ = (logger);                     \
+        if (otk_logger_enabled(otk_log_logger_, (level))) {         \
+            otk_logger_log(otk_log_logger_, (level), __VA_ARGS__);  \
+        }                                                           \
+    } while (0)
+
+#define OTK_LOG_DEFAULT(level, ...) OTK_LOG(otk_logger_default(), level, __VA_ARGS__)
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* OTAsyncLogger_h */
@@ -0,0 +1,110 @@
+//
+//  OTFramePacer.cpp
+//  Basic-Video-Chat
+//
+//  Copyright (c) 2026 Vonage. All rights reserved.
+//
+
+#include "OTFramePacer.h"
+
+#include <chrono>
+#include <mutex>
+
+struct otk_frame_pacer {
+    std::mutex lock;
+    // A frame arrived that has not been handed to a draw yet.
+    bool pending;
+    int64_t pending_since_us;
+    // A draw was requested and has not finished yet.
+    bool drawing;
+    int64_t drawing_since_us;
+    int64_t refresh_period_us;
+    otk_frame_pacer_stats stats;
+};
+
+otk_frame_pacer *otk_frame_pacer_new(void) {
+    otk_frame_pacer *pacer = new otk_frame_pacer();
+    pacer->pending = false;
+    pacer->pending_since_us = 0;
+    pacer->drawing = false;
+    pacer->drawing_since_us = 0;
+    pacer->refresh_period_us = 0;
+    pacer->stats = {};
+    return pacer;
+}
+
+void otk_frame_pacer_delete(otk_frame_pacer *pacer) {
+    delete pacer;
+}
+
+int64_t otk_frame_pacer_now_us(void) {
+    return (int64_t)std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+void otk_frame_pacer_frame_arrived(otk_frame_pacer *pacer, int64_t now_us) {
+    if (pacer == nullptr) {
+        return;
+    }
+    std::lock_guard<std::mutex> guard(pacer->lock);
+    pacer->stats.frames_received++;
+    if (pacer->pending) {
+        // The view only keeps the newest frame.
+        pacer->stats.frames_dropped++;
+    }
+    pacer->pending = true;
+    pacer->pending_since_us = now_us;
+}
+
+int otk_frame_pacer_on_refresh(otk_frame_pacer *pacer,
+                               int64_t refresh_period_us) {
+    if (pacer == nullptr) {
+        return 0;
+    }
+    std::lock_guard<std::mutex> guard(pacer->lock);
+    pacer->refresh_period_us = refresh_period_us;
+    if (!pacer->pending || pacer->drawing) {
+        // Nothing new, or the previous draw is still queued; it will pick
+        // up the newest frame or the next refresh will.
+        pacer->stats.refreshes_skipped++;
+        return 0;
+    }
+    pacer->pending = false;
+    pacer->drawing = true;
+    pacer->drawing_since_us = pacer->pending_since_us;
+    return 1;
+}
+
+void otk_frame_pacer_frame_presented(otk_frame_pacer *pacer, int64_t now_us) {
+    if (pacer == nullptr) {
+        return;
+    }
+    std::lock_guard<std::mutex> guard(pacer->lock);
+    if (!pacer->drawing) {
+        // A redraw the pacer did not ask for, e.g. after a resize.
+        return;
+    }
+    pacer->drawing = false;
+    pacer->stats.frames_presented++;
+    if (pacer->refresh_period_us > 0 &&
+        now_us - pacer->drawing_since_us > pacer->refresh_period_us) {
+        pacer->stats.frames_late++;
+    }
+}
+
+void otk_frame_pacer_draw_cancelled(otk_frame_pacer *pacer) {
+    if (pacer == nullptr) {
+        return;
+    }
+    std::lock_guard<std::mutex> guard(pacer->lock);
+    pacer->drawing = false;
+}
+
+void otk_frame_pacer_get_stats(otk_frame_pacer *pacer,
+                               otk_frame_pacer_stats *stats) {
+    if (pacer == nullptr || stats == nullptr) {
+        return;
+    }
+    std::lock_guard<std::mutex> guard(pacer->lock);
+    *stats = pacer->stats;
+}
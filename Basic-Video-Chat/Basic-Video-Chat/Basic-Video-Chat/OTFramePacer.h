@@ -0,0 +1,78 @@
+//
+//  OTFramePacer.h
+//  Basic-Video-Chat
+//
+//  Copyright (c) 2026 Vonage. All rights reserved.
+//
+
+#ifndef OTFramePacer_h
+#define OTFramePacer_h
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * Decides on which display refreshes a video view has to redraw. A frame is
+ * drawn on the first refresh after it arrives; refreshes with nothing new
+ * are skipped, and no new draw is requested while the previous one is still
+ * in progress.
+ *
+ * All times are in microseconds and passed in by the caller, so the pacer
+ * can be driven by a virtual clock.
+ */
+typedef struct otk_frame_pacer otk_frame_pacer;
+
+typedef struct otk_frame_pacer_stats {
+    /** Frames handed to the view. */
+    uint64_t frames_received;
+    /** Frames drawn. */
+    uint64_t frames_presented;
+    /** Frames replaced by a newer one before they could be drawn. */
+    uint64_t frames_dropped;
+    /** Frames drawn more than one refresh period after they arrived. */
+    uint64_t frames_late;
+    /**
+     * Refreshes that did not redraw, because nothing new had arrived or the
+     * previous draw was still in progress.
+     */
+    uint64_t refreshes_skipped;
+} otk_frame_pacer_stats;
+
+otk_frame_pacer *otk_frame_pacer_new(void);
+
+void otk_frame_pacer_delete(otk_frame_pacer *pacer);
+
+/** Monotonic clock in microseconds. */
+int64_t otk_frame_pacer_now_us(void);
+
+/** Records a new frame. Safe to call from any thread. */
+void otk_frame_pacer_frame_arrived(otk_frame_pacer *pacer, int64_t now_us);
+
+/**
+ * Called on every display refresh with the refresh period. Returns 1 if the
+ * view should redraw, in which case otk_frame_pacer_frame_presented or
+ * otk_frame_pacer_draw_cancelled must follow once it has.
+ */
+int otk_frame_pacer_on_refresh(otk_frame_pacer *pacer,
+                               int64_t refresh_period_us);
+
+/** Records that the draw requested by otk_frame_pacer_on_refresh is done. */
+void otk_frame_pacer_frame_presented(otk_frame_pacer *pacer, int64_t now_us);
+
+/**
+ * Records that the draw requested by otk_frame_pacer_on_refresh could not
+ * show the frame. The next frame to arrive is drawn as usual.
+ */
+void otk_frame_pacer_draw_cancelled(otk_frame_pacer *pacer);
+
+void otk_frame_pacer_get_stats(otk_frame_pacer *pacer,
+                               otk_frame_pacer_stats *stats);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* OTFramePacer_h */
@@ -0,0 +1,359 @@
+//
+//  OTSessionManager.cpp
+//  Basic-Video-Chat
+//
+//  Copyright (c) 2026 Vonage. All rights reserved.
+//
+
+#include "OTSessionManager.h"
+
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+#include <time.h>
+
+static const uint32_t kMaxDefaultWorkers = 4;
+static const uint32_t kMaxWorkers = 64;
+
+typedef std::chrono::steady_clock manager_clock;
+
+namespace {
+
+struct task {
+    otk_session_task run;
+    void *data;
+    manager_clock::time_point posted;
+};
+
+struct session {
+    std::string name;
+    std::deque<task> queue;
+    // Queued for a worker or being run by one.
+    bool scheduled = false;
+    bool accepting = true;
+    std::condition_variable idle;
+    // Keys this session holds and how many times it acquired each.
+    std::unordered_map<std::string, uint32_t> devices;
+    otk_session_usage usage = {};
+    int64_t queue_wait_total_us = 0;
+};
+
+struct device {
+    void *handle = nullptr;
+    otk_device_destroy destroy = nullptr;
+    void *context = nullptr;
+    uint32_t references = 0;
+};
+
+} // namespace
+
+struct otk_session_manager {
+    otk_runtime_api api = {};
+
+    std::mutex lock;
+    std::condition_variable work;
+    bool stopping = false;
+    int next_id = 1;
+    std::unordered_map<int, std::shared_ptr<session>> sessions;
+    // Sessions with tasks, in the order they get a worker.
+    std::deque<std::shared_ptr<session>> ready;
+    std::vector<std::thread> workers;
+
+    // Held while devices are created and destroyed, apart from the task
+    // lock so posting never waits for a camera to open.
+    std::mutex devices_lock;
+    std::unordered_map<std::string, device> devices;
+};
+
+static int64_t elapsed_us(manager_clock::time_point since, manager_clock::time_point until) {
+    return std::chrono::duration_cast<std::chrono::microseconds>(until - since).count();
+}
+
+static int64_t thread_cpu_us() {
+    struct timespec now;
+    if (clock_gettime(CLOCK_THREAD_CPUTIME_ID, &now) != 0) {
+        return 0;
+    }
+    return (int64_t)now.tv_sec * 1000000 + now.tv_nsec / 1000;
+}
+
+static void work_loop(otk_session_manager *manager) {
+    std::unique_lock<std::mutex> guard(manager->lock);
+    while (true) {
+        manager->work.wait(guard, [manager] {
+            return manager->stopping || !manager->ready.empty();
+        });
+        if (manager->ready.empty()) {
+            return;
+        }
+        std::shared_ptr<session> running = std::move(manager->ready.front());
+        manager->ready.pop_front();
+        task next = running->queue.front();
+        running->queue.pop_front();
+        guard.unlock();
+
+        manager_clock::time_point start = manager_clock::now();
+        int64_t cpu_start = thread_cpu_us();
+        next.run(next.data);
+        int64_t cpu_us = thread_cpu_us() - cpu_start;
+        manager_clock::time_point end = manager_clock::now();
+
+        guard.lock();
+        otk_session_usage &usage = running->usage;
+        int64_t wait_us = elapsed_us(next.posted, start);
+        usage.tasks++;
+        usage.task_cpu_us += cpu_us;
+        usage.task_wall_us += elapsed_us(start, end);
+        usage.queue_wait_max_us = std::max(usage.queue_wait_max_us, wait_us);
+        running->queue_wait_total_us += wait_us;
+        // One task per turn, then to the back of the line.
+        if (!running->queue.empty()) {
+            manager->ready.push_back(std::move(running));
+            manager->work.notify_one();
+        } else {
+            running->scheduled = false;
+            running->idle.notify_all();
+        }
+    }
+}
+
+otk_session_manager *otk_session_manager_new(const otk_runtime_api *api, uint32_t workers) {
+    if (workers == 0) {
+        workers = std::clamp(std::thread::hardware_concurrency(), 1u, kMaxDefaultWorkers);
+    }
+    otk_session_manager *manager = new otk_session_manager();
+    if (api != nullptr) {
+        manager->api = *api;
+    }
+    for (uint32_t i = 0; i < std::min(workers, kMaxWorkers); i++) {
+        manager->workers.emplace_back(work_loop, manager);
+    }
+    return manager;
+}
+
+void otk_session_manager_delete(otk_session_manager *manager) {
+    if (manager == nullptr) {
+        return;
+    }
+    std::vector<int> ids;
+    {
+        std::lock_guard<std::mutex> guard(manager->lock);
+        for (auto &entry : manager->sessions) {
+            ids.push_back(entry.first);
+        }
+    }
+    for (int id : ids) {
+        otk_session_manager_remove_session(manager, id);
+    }
+    {
+        std::lock_guard<std::mutex> guard(manager->lock);
+        manager->stopping = true;
+    }
+    manager->work.notify_all();
+    for (std::thread &worker : manager->workers) {
+        worker.join();
+    }
+    delete manager;
+}
+
+int otk_session_manager_add_session(otk_session_manager *manager, const char *name) {
+    if (manager == nullptr) {
+        return 0;
+    }
+    if (!otk_runtime_acquire(&manager->api)) {
+        return 0;
+    }
+    auto added = std::make_shared<session>();
+    added->name = name ? name : "";
+    std::lock_guard<std::mutex> guard(manager->lock);
+    int id = manager->next_id++;
+    manager->sessions.emplace(id, std::move(added));
+    return id;
+}
+
+static std::shared_ptr<session> find_session(otk_session_manager *manager, int id) {
+    auto found = manager->sessions.find(id);
+    return found == manager->sessions.end() ? nullptr : found->second;
+}
+
+int otk_session_manager_post(otk_session_manager *manager, int session,
+                             otk_session_task task, void *data) {
+    if (manager == nullptr || task == nullptr) {
+        return 0;
+    }
+    std::lock_guard<std::mutex> guard(manager->lock);
+    std::shared_ptr<::session> target = find_session(manager, session);
+    if (!target) {
+        return 0;
+    }
+    if (!target->accepting) {
+        target->usage.tasks_rejected++;
+        return 0;
+    }
+    target->queue.push_back({task, data, manager_clock::now()});
+    if (!target->scheduled) {
+        target->scheduled = true;
+        manager->ready.push_back(std::move(target));
+        manager->work.notify_one();
+    }
+    return 1;
+}
+
+void otk_session_manager_stop_session(otk_session_manager *manager, int session) {
+    if (manager == nullptr) {
+        return;
+    }
+    std::unique_lock<std::mutex> guard(manager->lock);
+    std::shared_ptr<::session> target = find_session(manager, session);
+    if (!target) {
+        return;
+    }
+    target->accepting = false;
+    target->idle.wait(guard, [&target] { return !target->scheduled; });
+}
+
+// Drops one of the session's references on a device, destroying it with
+// the last one. Called with the devices lock held.
+static void release_device_locked(otk_session_manager *manager, const std::string &key) {
+    auto found = manager->devices.find(key);
+    if (found == manager->devices.end()) {
+        return;
+    }
+    device &released = found->second;
+    if (--released.references > 0) {
+        return;
+    }
+    if (released.destroy != nullptr) {
+        released.destroy(released.handle, released.context);
+    }
+    manager->devices.erase(found);
+}
+
+void otk_session_manager_remove_session(otk_session_manager *manager, int session) {
+    if (manager == nullptr) {
+        return;
+    }
+    otk_session_manager_stop_session(manager, session);
+    std::shared_ptr<::session> removed;
+    {
+        std::lock_guard<std::mutex> guard(manager->lock);
+        auto found = manager->sessions.find(session);
+        if (found == manager->sessions.end()) {
+            return;
+        }
+        removed = std::move(found->second);
+        manager->sessions.erase(found);
+    }
+    {
+        std::lock_guard<std::mutex> guard(manager->devices_lock);
+        for (auto &held : removed->devices) {
+            for (uint32_t i = 0; i < held.second; i++) {
+                release_device_locked(manager, held.first);
+            }
+        }
+    }
+    otk_runtime_release();
+}
+
+void *otk_session_manager_acquire_device(otk_session_manager *manager, int session,
+                                         const char *key, otk_device_create create,
+                                         otk_device_destroy destroy, void *context) {
+    if (manager == nullptr || key == nullptr) {
+        return nullptr;
+    }
+    std::lock_guard<std::mutex> devices_guard(manager->devices_lock);
+    std::shared_ptr<::session> holder;
+    {
+        std::lock_guard<std::mutex> guard(manager->lock);
+        holder = find_session(manager, session);
+    }
+    if (!holder) {
+        return nullptr;
+    }
+    auto found = manager->devices.find(key);
+    if (found == manager->devices.end()) {
+        if (create == nullptr) {
+            return nullptr;
+        }
+        void *handle = create(context);
+        if (handle == nullptr) {
+            return nullptr;
+        }
+        found = manager->devices.emplace(key, device{handle, destroy, context, 0}).first;
+    }
+    found->second.references++;
+    std::lock_guard<std::mutex> guard(manager->lock);
+    if (holder->devices[key]++ == 0) {
+        holder->usage.devices++;
+    }
+    return found->second.handle;
+}
+
+void otk_session_manager_release_device(otk_session_manager *manager, int session, const char *key) {
+    if (manager == nullptr || key == nullptr) {
+        return;
+    }
+    std::lock_guard<std::mutex> devices_guard(manager->devices_lock);
+    {
+        std::lock_guard<std::mutex> guard(manager->lock);
+        std::shared_ptr<::session> holder = find_session(manager, session);
+        if (!holder) {
+            return;
+        }
+        auto held = holder->devices.find(key);
+        if (held == holder->devices.end()) {
+            return;
+        }
+        if (--held->second == 0) {
+            holder->devices.erase(held);
+            holder->usage.devices--;
+        }
+    }
+    release_device_locked(manager, key);
+}
+
+void otk_session_manager_add_count(otk_session_manager *manager, int session,
+                                   enum otk_session_resource resource, int32_t delta) {
+    if (manager == nullptr || resource < 0 || resource >= OTK_SESSION_RESOURCE_COUNT) {
+        return;
+    }
+    std::lock_guard<std::mutex> guard(manager->lock);
+    std::shared_ptr<::session> target = find_session(manager, session);
+    if (target) {
+        target->usage.counts[resource] += delta;
+    }
+}
+
+int otk_session_manager_get_usage(otk_session_manager *manager, int session,
+                                  otk_session_usage *usage) {
+    if (manager == nullptr || usage == nullptr) {
+        return 0;
+    }
+    std::lock_guard<std::mutex> guard(manager->lock);
+    std::shared_ptr<::session> target = find_session(manager, session);
+    if (!target) {
+        return 0;
+    }
+    *usage = target->usage;
+    usage->tasks_pending = (uint32_t)target->queue.size();
+    if (usage->tasks > 0) {
+        usage->queue_wait_mean_us = target->queue_wait_total_us / (int64_t)usage->tasks;
+    }
+    return 1;
+}
+
+uint32_t otk_session_manager_session_count(otk_session_manager *manager) {
+    if (manager == nullptr) {
+        return 0;
+    }
+    std::lock_guard<std::mutex> guard(manager->lock);
+    return (uint32_t)manager->sessions.size();
+}
@@ -0,0 +1,125 @@
+//
+//  OTSessionManager.h
+//  Basic-Video-Chat
+//
+//  Copyright (c) 2026 Vonage. All rights reserved.
+//
+
+#ifndef OTSessionManager_h
+#define OTSessionManager_h
+
+#include <stddef.h>
+#include <stdint.h>
+#include "OTRuntime.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * Runs several sessions in one process on a shared set of worker threads.
+ *
+ * Each session added holds a reference on the SDK runtime until it is
+ * removed. Work posted for a session runs on the shared workers in the
+ * order it was posted, one task at a time per session, with sessions
+ * taking turns task by task so a busy one does not hold up the others.
+ *
+ * Capture devices and other expensive resources are shared by key: the
+ * first session to acquire a key creates it, later ones get the same one,
+ * and it is destroyed when the last session holding it releases it or is
+ * removed.
+ *
+ * Time spent in each session's tasks, how long they waited for a worker
+ * and the devices and SDK objects it holds are kept per session.
+ */
+typedef struct otk_session_manager otk_session_manager;
+
+typedef void (*otk_session_task)(void *data);
+
+/** Counts the app keeps per session with otk_session_manager_add_count. */
+enum otk_session_resource {
+    OTK_SESSION_PUBLISHERS = 0,
+    OTK_SESSION_SUBSCRIBERS = 1,
+    OTK_SESSION_STREAMS = 2,
+    OTK_SESSION_RESOURCE_COUNT = 3,
+};
+
+typedef struct otk_session_usage {
+    uint64_t tasks;
+    /** Tasks posted once the session was stopping, not run. */
+    uint64_t tasks_rejected;
+    uint32_t tasks_pending;
+    /** CPU time of the workers while running the session's tasks. */
+    int64_t task_cpu_us;
+    int64_t task_wall_us;
+    /** Time from posting a task to a worker starting it. */
+    int64_t queue_wait_mean_us;
+    int64_t queue_wait_max_us;
+    uint32_t devices;
+    int32_t counts[OTK_SESSION_RESOURCE_COUNT];
+} otk_session_usage;
+
+/**
+ * api is passed to otk_runtime_acquire for every session. workers 0 uses
+ * one per core, up to 4.
+ */
+otk_session_manager *otk_session_manager_new(const otk_runtime_api *api, uint32_t workers);
+
+/** Removes the sessions left and stops the workers. */
+void otk_session_manager_delete(otk_session_manager *manager);
+
+/**
+ * Adds a session, initializing the SDK if it is the first in the process.
+ * Returns its id, or 0 if the SDK could not be initialized.
+ */
+int otk_session_manager_add_session(otk_session_manager *manager, const char *name);
+
+/**
+ * Queues task for the session. Returns 0, without running it, once the
+ * session is stopping or if it does not exist.
+ */
+int otk_session_manager_post(otk_session_manager *manager, int session,
+                             otk_session_task task, void *data);
+
+/**
+ * Stops taking tasks for the session and waits for the ones queued. Must
+ * not be called from one of the session's tasks.
+ */
+void otk_session_manager_stop_session(otk_session_manager *manager, int session);
+
+/**
+ * Stops the session, releases its devices and its reference on the SDK,
+ * destroying the SDK if it was the last.
+ */
+void otk_session_manager_remove_session(otk_session_manager *manager, int session);
+
+typedef void *(*otk_device_create)(void *context);
+typedef void (*otk_device_destroy)(void *device, void *context);
+
+/**
+ * Gets the device shared under key, creating it with create if no session
+ * holds it. destroy and context are kept from the call that created it.
+ * Returns NULL if create does. Devices are created and destroyed under a
+ * lock of their own, so create and destroy must not acquire or release
+ * devices themselves.
+ */
+void *otk_session_manager_acquire_device(otk_session_manager *manager, int session,
+                                         const char *key, otk_device_create create,
+                                         otk_device_destroy destroy, void *context);
+
+void otk_session_manager_release_device(otk_session_manager *manager, int session, const char *key);
+
+void otk_session_manager_add_count(otk_session_manager *manager, int session,
+                                   enum otk_session_resource resource, int32_t delta);
+
+/** Returns 0 if there is no such session. */
+int otk_session_manager_get_usage(otk_session_manager *manager, int session,
+                                  otk_session_usage *usage);
+
+uint32_t otk_session_manager_session_count(otk_session_manager *manager);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* OTSessionManager_h */
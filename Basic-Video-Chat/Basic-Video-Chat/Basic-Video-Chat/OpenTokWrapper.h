@@ -8,6 +8,7 @@
 #import <Foundation/Foundation.h>
 #import <opentok/opentok.h>
 #include "VideoRenderView.h"
+#include "OTSessionManager.h"
 
 @protocol OpenTokWrapperDelegate <NSObject>
 @optional
@@ -33,4 +34,10 @@
 - (void)publish;
 - (void)unpublish;
 
+/**
+ Work done on the shared session workers for this session, and the
+ publishers, subscribers and streams it holds.
+ */
+- (otk_session_usage)resourceUsage;
+
 @end
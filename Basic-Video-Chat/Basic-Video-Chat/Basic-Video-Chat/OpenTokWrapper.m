@@ -6,6 +6,7 @@
 //
 
 #include "OpenTokWrapper.h"
+#include "OTAsyncLogger.h"
 
 #define API_KEY ""
 #define SESSION_ID ""
@@ -18,8 +19,32 @@ typedef struct {
   otc_subscriber *subscriber;
   const otc_stream* sub_stream;
   void *open_tok_controller;
+  /** Id in the shared session manager, 0 if the SDK could not be initialized. */
+  int manager_session;
 } SessionData;
 
+static otk_session_manager *sharedSessionManager(void);
+
+static void run_session_block(void *data) {
+  void (^block)(void) = (__bridge_transfer void (^)(void))data;
+  block();
+}
+
+// Runs block on the shared workers, after the session's earlier blocks.
+// Returns NO, without running it, once the wrapper is being torn down.
+// Only SDK calls go there: the wrapper's state, subscriber and stream list
+// included, is only touched on the main queue, which the SDK calls are
+// posted from so they keep the order of the events.
+static BOOL postToSession(SessionData *session_data, void (^block)(void)) {
+  void *data = (__bridge_retained void *)[block copy];
+  if (otk_session_manager_post(sharedSessionManager(), session_data->manager_session,
+                               run_session_block, data)) {
+    return YES;
+  }
+  (void)(__bridge_transfer id)data;
+  return NO;
+}
+
 static void on_subscriber_connected(otc_subscriber *subscriber,
                                     void *user_data,
                                     const otc_stream *stream) {
@@ -93,13 +118,21 @@ static void on_session_stream_received(otc_session *session,
   NSLog(@"on_session_stream_received: sessionId=%s - streamId=%s", otc_session_get_id(session), otc_stream_get_id(stream));
   
   SessionData *session_data_local = (SessionData *)user_data;
-  OpenTokWrapper *openTokWrapper = (__bridge OpenTokWrapper*)session_data_local->open_tok_controller;
+  // Held weakly: the last reference dropped in a block would run dealloc
+  // there. Once it is gone, session_data_local is too.
+  __weak OpenTokWrapper *weakWrapper = (__bridge OpenTokWrapper*)session_data_local->open_tok_controller;
 
   otc_stream *strcpy = otc_stream_copy(stream);
 
   dispatch_async(dispatch_get_main_queue(), ^{
-
+    OpenTokWrapper *openTokWrapper = weakWrapper;
+    if (!openTokWrapper) {
+      otc_stream_delete(strcpy);
+      return;
+    }
     [openTokWrapper.streamObjectList addPointer:strcpy];
+    int manager_session = session_data_local->manager_session;
+    otk_session_manager_add_count(sharedSessionManager(), manager_session, OTK_SESSION_STREAMS, 1);
 
     struct otc_subscriber_callbacks subscriber_callbacks = {0};
     subscriber_callbacks.user_data = session_data_local;
@@ -109,12 +142,17 @@ static void on_session_stream_received(otc_session *session,
     subscriber_callbacks.on_disconnected = on_subscriber_disconnected;
 
     otc_subscriber *subscriber = otc_subscriber_new(strcpy, &subscriber_callbacks);
-    
-    if (otc_session_subscribe(session, subscriber) == OTC_SUCCESS) {
-      session_data_local->subscriber = subscriber;
-      session_data_local->sub_stream = stream;
+    if (subscriber == NULL) {
+      return;
     }
-    otc_stream_delete(strcpy);
+    session_data_local->subscriber = subscriber;
+    session_data_local->sub_stream = strcpy;
+    postToSession(session_data_local, ^{
+      if (otc_session_subscribe(session, subscriber) == OTC_SUCCESS) {
+        otk_session_manager_add_count(sharedSessionManager(), manager_session,
+                                      OTK_SESSION_SUBSCRIBERS, 1);
+      }
+    });
   });
 }
 
@@ -124,15 +162,29 @@ static void on_session_stream_dropped(otc_session *session,
   NSLog(@"on_session_stream_received: sessionId=%s - streamId=%s", otc_session_get_id(session), otc_stream_get_id(stream));
   
   SessionData *session_data_local = (SessionData *)user_data;
-  OpenTokWrapper *openTokWrapper = (__bridge OpenTokWrapper*)session_data_local->open_tok_controller;
+  __weak OpenTokWrapper *weakWrapper = (__bridge OpenTokWrapper*)session_data_local->open_tok_controller;
 
   otc_stream *strcpy = otc_stream_copy(stream);
 
   dispatch_async(dispatch_get_main_queue(), ^{
+    OpenTokWrapper *openTokWrapper = weakWrapper;
+    if (!openTokWrapper) {
+      otc_stream_delete(strcpy);
+      return;
+    }
+    int manager_session = session_data_local->manager_session;
+    otk_session_manager_add_count(sharedSessionManager(), manager_session, OTK_SESSION_STREAMS, -1);
     otc_subscriber *subscriber = session_data_local->subscriber;
-    otc_stream *sub_stream = otc_subscriber_get_stream(subscriber);
-    if (strcmp(otc_stream_get_id(sub_stream), otc_stream_get_id(strcpy)) == 0) {
-        otc_session_unsubscribe(session, subscriber);
+    otc_stream *sub_stream = subscriber != NULL ? otc_subscriber_get_stream(subscriber) : NULL;
+    if (sub_stream != NULL && strcmp(otc_stream_get_id(sub_stream), otc_stream_get_id(strcpy)) == 0) {
+      session_data_local->sub_stream = NULL;
+      // After the subscribe posted with the stream.
+      postToSession(session_data_local, ^{
+        if (otc_session_unsubscribe(session, subscriber) == OTC_SUCCESS) {
+          otk_session_manager_add_count(sharedSessionManager(), manager_session,
+                                        OTK_SESSION_SUBSCRIBERS, -1);
+        }
+      });
     }
 
     for (int i = 0; i < [openTokWrapper.streamObjectList count]; i++) {
@@ -176,9 +228,17 @@ static void on_publisher_stream_created(otc_publisher *publisher,
                                         const otc_stream *stream) {
   NSLog(@"on_session_stream_received: streamId=%s", otc_stream_get_id(stream));
   SessionData* session_data_local = (SessionData*) user_data;
-  OpenTokWrapper *openTokWrapper = (__bridge OpenTokWrapper*)session_data_local->open_tok_controller;
-  session_data_local->pub_stream = stream;
-  [openTokWrapper.streamObjectList addPointer:otc_stream_copy(stream)];
+  __weak OpenTokWrapper *weakWrapper = (__bridge OpenTokWrapper*)session_data_local->open_tok_controller;
+  otc_stream *strcpy = otc_stream_copy(stream);
+  dispatch_async(dispatch_get_main_queue(), ^{
+    OpenTokWrapper *openTokWrapper = weakWrapper;
+    if (openTokWrapper) {
+      session_data_local->pub_stream = strcpy;
+      [openTokWrapper.streamObjectList addPointer:strcpy];
+    } else {
+      otc_stream_delete(strcpy);
+    }
+  });
 }
 
 static void on_publisher_render_frame(otc_publisher *publisher,
@@ -196,16 +256,24 @@ static void on_publisher_stream_destroyed(otc_publisher *publisher,
                                           const otc_stream *stream) {
   NSLog(@"on_publisher_stream_destroyed: streamId=%s", otc_stream_get_id(stream));
   SessionData* session_data_local = (SessionData*) user_data;
-  OpenTokWrapper *openTokWrapper = (__bridge OpenTokWrapper*)session_data_local->open_tok_controller;
+  __weak OpenTokWrapper *weakWrapper = (__bridge OpenTokWrapper*)session_data_local->open_tok_controller;
+  NSString *streamId = [NSString stringWithUTF8String:otc_stream_get_id(stream)];
 
-  for (int i = 0; i < [openTokWrapper.streamObjectList count]; i++)
-  {
-      if (strcmp(otc_stream_get_id(stream), otc_stream_get_id([openTokWrapper.streamObjectList pointerAtIndex:i]))== 0) {
-          otc_stream_delete([openTokWrapper.streamObjectList pointerAtIndex:i]);
-          [openTokWrapper.streamObjectList removePointerAtIndex:i];
-          break;
-      }
-  }
+  dispatch_async(dispatch_get_main_queue(), ^{
+    OpenTokWrapper *openTokWrapper = weakWrapper;
+    if (!openTokWrapper) {
+      return;
+    }
+    session_data_local->pub_stream = NULL;
+    for (int i = 0; i < [openTokWrapper.streamObjectList count]; i++)
+    {
+        if (strcmp(streamId.UTF8String, otc_stream_get_id([openTokWrapper.streamObjectList pointerAtIndex:i]))== 0) {
+            otc_stream_delete([openTokWrapper.streamObjectList pointerAtIndex:i]);
+            [openTokWrapper.streamObjectList removePointerAtIndex:i];
+            break;
+        }
+    }
+  });
 }
 
 static void on_publisher_error(otc_publisher *publisher,
@@ -215,8 +283,42 @@ static void on_publisher_error(otc_publisher *publisher,
   NSLog(@"on_publisher_error: errorString=%s - errorCode=%i", error_string, error_code);
 }
 
+// SDK messages are handed to a background thread instead of NSLog, which
+// would block the SDK thread logging them.
+static otk_logger *sdk_logger = NULL;
+
 static void on_otc_log_message(const char* message) {
-  NSLog(@"on_otc_log_message: message=%s", message);
+  OTK_LOG(sdk_logger, OTK_LOG_INFO, "on_otc_log_message: message=%s", message);
+}
+
+static int init_sdk(void *context) {
+  if (otc_init(NULL) != OTC_SUCCESS) {
+    return 0;
+  }
+  #ifdef CONSOLE_LOGGING
+    if (sdk_logger == NULL) {
+      sdk_logger = otk_logger_new(NULL);
+    }
+    otc_log_set_logger_callback(on_otc_log_message);
+    otc_log_enable(OTC_LOG_LEVEL_ALL);
+  #endif
+  return 1;
+}
+
+static void destroy_sdk(void *context) {
+  otc_destroy();
+}
+
+// Every wrapper in the process runs its session here, so the SDK is
+// initialized once for all of them and destroyed with the last.
+static otk_session_manager *sharedSessionManager(void) {
+  static otk_session_manager *manager = NULL;
+  static dispatch_once_t once;
+  dispatch_once(&once, ^{
+    const otk_runtime_api api = {NULL, init_sdk, destroy_sdk};
+    manager = otk_session_manager_new(&api, 0);
+  });
+  return manager;
 }
 
 @implementation OpenTokWrapper {
@@ -236,16 +338,12 @@ static void on_otc_log_message(const char* message) {
   session_data->open_tok_controller = (__bridge void *)self;
   session_data->publisher = NULL;
   
-  if (otc_init(NULL) != OTC_SUCCESS) {
+  session_data->manager_session = otk_session_manager_add_session(sharedSessionManager(), SESSION_ID);
+  if (session_data->manager_session == 0) {
     NSLog(@"Could not init OpenTok library");
     return;
   }
   
-  #ifdef CONSOLE_LOGGING
-    otc_log_set_logger_callback(on_otc_log_message);
-    otc_log_enable(OTC_LOG_LEVEL_ALL);
-  #endif
-  
   struct otc_session_callbacks session_callbacks = {0};
   session_callbacks.user_data = session_data;
   session_callbacks.on_connected = on_session_connected;
@@ -279,9 +377,14 @@ static void on_otc_log_message(const char* message) {
     otc_session_delete(session_data->session);
     return;
   }
+  otk_session_manager_add_count(sharedSessionManager(), session_data->manager_session,
+                                OTK_SESSION_PUBLISHERS, 1);
 }
 
 - (void)dealloc {
+  // Lets the session's queued SDK calls finish, after which the SDK objects
+  // are only touched here.
+  otk_session_manager_stop_session(sharedSessionManager(), session_data->manager_session);
   [self unsubscribe];
   for (int i = 0; i < [_streamObjectList count]; i++)
     otc_stream_delete([_streamObjectList pointerAtIndex:i]);
@@ -301,15 +404,29 @@ static void on_otc_log_message(const char* message) {
     otc_session_delete(session_data->session);
     session_data->session = NULL;
   }
-    
+  
+  otk_session_usage usage = [self resourceUsage];
+  NSLog(@"Session %d: %llu tasks, %.1f ms CPU, queue wait %.2f ms mean %.2f ms max, "
+        "%u devices, %d publishers, %d subscribers, %d streams",
+        session_data->manager_session, usage.tasks, usage.task_cpu_us / 1000.0,
+        usage.queue_wait_mean_us / 1000.0, usage.queue_wait_max_us / 1000.0, usage.devices,
+        usage.counts[OTK_SESSION_PUBLISHERS], usage.counts[OTK_SESSION_SUBSCRIBERS],
+        usage.counts[OTK_SESSION_STREAMS]);
+  // Destroys the SDK if this was the last session in the process.
+  otk_session_manager_remove_session(sharedSessionManager(), session_data->manager_session);
   free(session_data);
-  otc_destroy();
 }
 
 - (SessionData*)getSessionData {
   return session_data;
 }
 
+- (otk_session_usage)resourceUsage {
+  otk_session_usage usage = {0};
+  otk_session_manager_get_usage(sharedSessionManager(), session_data->manager_session, &usage);
+  return usage;
+}
+
 - (void)connect {
   if (session_data->session != NULL) {
     otc_session_connect(session_data->session, TOKEN);
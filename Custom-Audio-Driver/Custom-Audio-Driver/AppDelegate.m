@@ -6,6 +6,7 @@
 //
 
 #import "AppDelegate.h"
+#include "OTAsyncLogger.h"
 
 @interface AppDelegate ()
 
@@ -21,7 +22,7 @@
 
 
 - (void)applicationWillTerminate:(NSNotification *)aNotification {
-    // Insert code here to tear down your application
+    otk_logger_flush(otk_logger_default());
 }
 
 
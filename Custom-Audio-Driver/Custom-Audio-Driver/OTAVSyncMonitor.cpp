@@ -0,0 +1,299 @@
+//
+//  OTAVSyncMonitor.cpp
+//  Custom-Audio-Driver
+//
+//  Copyright (c) 2026 Vonage. All rights reserved.
+//
+
+#include "OTAVSyncMonitor.h"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstring>
+#include <mutex>
+
+static const size_t kMaxStreams = 16;
+static const size_t kMaxStreamId = 64;
+// Audio reports kept per timeline, about a second at one per callback.
+static const size_t kAnchors = 128;
+// Audio further apart than this is not interpolated across, and a timeline
+// that jumps by more starts over.
+static const int64_t kMaxGapUs = 1000000;
+// How far past the audio reported so far a frame is still compared.
+static const int64_t kMaxExtrapolateUs = 500000;
+// Larger skews mean the two media clocks are not comparable.
+static const double kMaxSkewMs = 2000;
+// Skews kept for the percentiles, about 8 s of 30 fps video.
+static const size_t kWindow = 256;
+static const size_t kMinFrames = 60;
+static const uint64_t kEvaluateEvery = 15;
+// ITU-R BT.1359 detectability: audio ahead of video by 45 ms, behind by 125 ms.
+static const double kVideoLateMs = 45;
+static const double kVideoEarlyMs = 125;
+// Back in sync once the median is within this share of the range.
+static const double kBackInSync = 0.8;
+
+namespace {
+
+struct anchor {
+    int64_t media_us;
+    int64_t play_ns;
+};
+
+// Recent audio, oldest first in ring order.
+struct timeline {
+    std::array<anchor, kAnchors> anchors;
+    size_t head = 0;
+    size_t count = 0;
+
+    void clear() {
+        head = 0;
+        count = 0;
+    }
+
+    const anchor &at(size_t i) const {
+        return anchors[(head + kAnchors - count + i) % kAnchors];
+    }
+
+    void add(int64_t media_us, int64_t play_ns) {
+        if (count > 0) {
+            int64_t last = at(count - 1).media_us;
+            if (media_us < last || media_us - last > kMaxGapUs) {
+                clear();
+            }
+        }
+        anchors[head] = {media_us, play_ns};
+        head = (head + 1) % kAnchors;
+        count = std::min(count + 1, kAnchors);
+    }
+
+    // When media_us was heard, or false with no audio near it.
+    bool play_time(int64_t media_us, double *play_ns) const {
+        if (count == 0) {
+            return false;
+        }
+        const anchor &oldest = at(0);
+        const anchor &newest = at(count - 1);
+        if (media_us >= newest.media_us) {
+            if (media_us - newest.media_us > kMaxExtrapolateUs) {
+                return false;
+            }
+            *play_ns = newest.play_ns + (media_us - newest.media_us) * 1e3;
+            return true;
+        }
+        if (media_us < oldest.media_us) {
+            if (oldest.media_us - media_us > kMaxExtrapolateUs) {
+                return false;
+            }
+            *play_ns = oldest.play_ns - (oldest.media_us - media_us) * 1e3;
+            return true;
+        }
+        // Newest first: video is usually close to the latest audio.
+        for (size_t i = count - 1; i > 0; i--) {
+            const anchor &a = at(i - 1);
+            if (a.media_us > media_us) {
+                continue;
+            }
+            const anchor &b = at(i);
+            if (b.media_us == a.media_us) {
+                *play_ns = (double)a.play_ns;
+            } else {
+                double t = (double)(media_us - a.media_us) / (double)(b.media_us - a.media_us);
+                *play_ns = a.play_ns + t * (double)(b.play_ns - a.play_ns);
+            }
+            return true;
+        }
+        return false;
+    }
+};
+
+struct stream {
+    bool used = false;
+    char id[kMaxStreamId] = {0};
+    timeline audio;
+    std::array<double, kWindow> skews;
+    size_t skew_head = 0;
+    size_t skew_count = 0;
+    uint64_t frames = 0;
+    uint64_t unmapped = 0;
+    int out_of_sync = 0;
+    uint32_t out_of_sync_events = 0;
+
+    void reset() {
+        audio.clear();
+        skew_head = 0;
+        skew_count = 0;
+        frames = 0;
+        unmapped = 0;
+        out_of_sync = 0;
+        out_of_sync_events = 0;
+    }
+};
+
+} // namespace
+
+struct otk_av_sync_monitor {
+    std::mutex lock;
+    timeline mixed;
+    std::array<stream, kMaxStreams> streams;
+    std::array<double, kWindow> scratch;
+};
+
+static stream *find_stream(otk_av_sync_monitor *monitor, const char *stream_id) {
+    for (stream &s : monitor->streams) {
+        if (s.used && std::strncmp(s.id, stream_id, kMaxStreamId - 1) == 0) {
+            return &s;
+        }
+    }
+    return nullptr;
+}
+
+// Sorts the stream's skews into the scratch buffer.
+static size_t sorted_skews(otk_av_sync_monitor *monitor, const stream &s) {
+    std::copy(s.skews.begin(), s.skews.begin() + s.skew_count, monitor->scratch.begin());
+    std::sort(monitor->scratch.begin(), monitor->scratch.begin() + s.skew_count);
+    return s.skew_count;
+}
+
+static double percentile(const double *sorted, size_t count, double p) {
+    double position = p * (double)(count - 1);
+    size_t below = (size_t)position;
+    size_t above = std::min(below + 1, count - 1);
+    return sorted[below] + (position - below) * (sorted[above] - sorted[below]);
+}
+
+static void evaluate(otk_av_sync_monitor *monitor, stream &s) {
+    size_t count = s.skew_count;
+    std::copy(s.skews.begin(), s.skews.begin() + count, monitor->scratch.begin());
+    double *middle = monitor->scratch.data() + count / 2;
+    std::nth_element(monitor->scratch.data(), middle, monitor->scratch.data() + count);
+    double median = *middle;
+    if (!s.out_of_sync) {
+        if (median > kVideoLateMs || median < -kVideoEarlyMs) {
+            s.out_of_sync = 1;
+            s.out_of_sync_events++;
+        }
+    } else if (median < kVideoLateMs * kBackInSync && median > -kVideoEarlyMs * kBackInSync) {
+        s.out_of_sync = 0;
+    }
+}
+
+otk_av_sync_monitor *otk_av_sync_monitor_new(void) {
+    return new otk_av_sync_monitor();
+}
+
+void otk_av_sync_monitor_delete(otk_av_sync_monitor *monitor) {
+    delete monitor;
+}
+
+int otk_av_sync_monitor_add_stream(otk_av_sync_monitor *monitor, const char *stream_id) {
+    if (monitor == nullptr || stream_id == nullptr) {
+        return 0;
+    }
+    std::lock_guard<std::mutex> guard(monitor->lock);
+    if (find_stream(monitor, stream_id) != nullptr) {
+        return 1;
+    }
+    for (stream &s : monitor->streams) {
+        if (!s.used) {
+            s.reset();
+            std::strncpy(s.id, stream_id, kMaxStreamId - 1);
+            s.id[kMaxStreamId - 1] = '\0';
+            s.used = true;
+            return 1;
+        }
+    }
+    return 0;
+}
+
+void otk_av_sync_monitor_remove_stream(otk_av_sync_monitor *monitor, const char *stream_id) {
+    if (monitor == nullptr || stream_id == nullptr) {
+        return;
+    }
+    std::lock_guard<std::mutex> guard(monitor->lock);
+    stream *s = find_stream(monitor, stream_id);
+    if (s != nullptr) {
+        s->used = false;
+    }
+}
+
+void otk_av_sync_monitor_audio(otk_av_sync_monitor *monitor, const char *stream_id,
+                               int64_t media_us, int64_t play_ns) {
+    if (monitor == nullptr) {
+        return;
+    }
+    // Called from audio callbacks; a report is not worth waiting for.
+    std::unique_lock<std::mutex> guard(monitor->lock, std::try_to_lock);
+    if (!guard.owns_lock()) {
+        return;
+    }
+    if (stream_id == nullptr) {
+        monitor->mixed.add(media_us, play_ns);
+        return;
+    }
+    stream *s = find_stream(monitor, stream_id);
+    if (s != nullptr) {
+        s->audio.add(media_us, play_ns);
+    }
+}
+
+void otk_av_sync_monitor_video(otk_av_sync_monitor *monitor, const char *stream_id,
+                               int64_t media_us, int64_t present_ns) {
+    if (monitor == nullptr || stream_id == nullptr) {
+        return;
+    }
+    std::lock_guard<std::mutex> guard(monitor->lock);
+    stream *s = find_stream(monitor, stream_id);
+    if (s == nullptr) {
+        return;
+    }
+    const timeline &audio = s->audio.count > 0 ? s->audio : monitor->mixed;
+    double play_ns = 0;
+    if (!audio.play_time(media_us, &play_ns)) {
+        s->unmapped++;
+        return;
+    }
+    double skew_ms = (present_ns - play_ns) / 1e6;
+    if (std::fabs(skew_ms) > kMaxSkewMs) {
+        s->unmapped++;
+        return;
+    }
+    s->skews[s->skew_head] = skew_ms;
+    s->skew_head = (s->skew_head + 1) % kWindow;
+    s->skew_count = std::min(s->skew_count + 1, kWindow);
+    s->frames++;
+    if (s->skew_count >= kMinFrames && s->frames % kEvaluateEvery == 0) {
+        evaluate(monitor, *s);
+    }
+}
+
+int otk_av_sync_monitor_get_stats(otk_av_sync_monitor *monitor, const char *stream_id,
+                                  otk_av_sync_stats *stats) {
+    if (monitor == nullptr || stream_id == nullptr || stats == nullptr) {
+        return 0;
+    }
+    std::lock_guard<std::mutex> guard(monitor->lock);
+    stream *s = find_stream(monitor, stream_id);
+    if (s == nullptr) {
+        return 0;
+    }
+    *stats = {};
+    stats->frames = s->frames;
+    stats->unmapped = s->unmapped;
+    stats->out_of_sync = s->out_of_sync;
+    stats->out_of_sync_events = s->out_of_sync_events;
+    size_t count = sorted_skews(monitor, *s);
+    if (count > 0) {
+        const double *sorted = monitor->scratch.data();
+        double sum = 0;
+        for (size_t i = 0; i < count; i++) {
+            sum += sorted[i];
+        }
+        stats->mean_ms = sum / count;
+        stats->p5_ms = percentile(sorted, count, 0.05);
+        stats->p50_ms = percentile(sorted, count, 0.5);
+        stats->p95_ms = percentile(sorted, count, 0.95);
+    }
+    return 1;
+}
@@ -0,0 +1,81 @@
+//
+//  OTAVSyncMonitor.h
+//  Custom-Audio-Driver
+//
+//  Copyright (c) 2026 Vonage. All rights reserved.
+//
+
+#ifndef OTAVSyncMonitor_h
+#define OTAVSyncMonitor_h
+
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * Measures lip sync per subscribed stream.
+ *
+ * Audio and video are reported with their media timestamp, in microseconds
+ * on one media clock, and the local time they were heard or shown. For
+ * every video frame the time its media timestamp was heard is interpolated
+ * from the recent audio, and the difference is the skew: positive when the
+ * video is shown after the matching audio, negative when before. The skew
+ * of the last few seconds is kept per stream for percentiles, and a stream
+ * is flagged out of sync when its median leaves the range viewers notice
+ * (audio ahead by more than 45 ms or behind by more than 125 ms, after ITU-R
+ * BT.1359), and back in sync once well within it again.
+ *
+ * Audio can be reported for one stream or, when it is mixed before being
+ * played, for all of them with a NULL stream id. The audio functions never
+ * block: a report that finds the monitor busy is dropped.
+ */
+typedef struct otk_av_sync_monitor otk_av_sync_monitor;
+
+typedef struct otk_av_sync_stats {
+    /** Video frames compared with the audio. */
+    uint64_t frames;
+    /** Video frames with no audio near their timestamp. */
+    uint64_t unmapped;
+    /** Skew of the last few seconds; positive when video is late. */
+    double mean_ms;
+    double p5_ms;
+    double p50_ms;
+    double p95_ms;
+    int out_of_sync;
+    /** Times the stream went out of sync. */
+    uint32_t out_of_sync_events;
+} otk_av_sync_stats;
+
+otk_av_sync_monitor *otk_av_sync_monitor_new(void);
+
+void otk_av_sync_monitor_delete(otk_av_sync_monitor *monitor);
+
+/** Starts monitoring a stream. Returns 0 if too many streams are monitored. */
+int otk_av_sync_monitor_add_stream(otk_av_sync_monitor *monitor, const char *stream_id);
+
+void otk_av_sync_monitor_remove_stream(otk_av_sync_monitor *monitor, const char *stream_id);
+
+/**
+ * Audio with media timestamp media_us was or will be heard at play_ns.
+ * stream_id NULL reports mixed audio, used for every stream without audio
+ * of its own.
+ */
+void otk_av_sync_monitor_audio(otk_av_sync_monitor *monitor, const char *stream_id,
+                               int64_t media_us, int64_t play_ns);
+
+/** The video frame with media timestamp media_us was shown at present_ns. */
+void otk_av_sync_monitor_video(otk_av_sync_monitor *monitor, const char *stream_id,
+                               int64_t media_us, int64_t present_ns);
+
+/** Returns 0 if the stream is not monitored. */
+int otk_av_sync_monitor_get_stats(otk_av_sync_monitor *monitor, const char *stream_id,
+                                  otk_av_sync_stats *stats);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* OTAVSyncMonitor_h */
@@ -0,0 +1,377 @@
+//
+//  OTAsyncLogger.cpp
+//  Custom-Audio-Driver
+//
+//  Copyright (c) 2026 Vonage. All rights reserved.
+//
+
+#include "OTAsyncLogger.h"
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdio>
+#include <ctime>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+// Bytes of message text a slot holds, including the terminating zero.
+static const size_t kMessageBytes = 232;
+
+static const char *const kLevelNames[] = { "ERROR", "WARN", "INFO", "DEBUG", "VERBOSE" };
+
+struct log_slot {
+    int64_t time_us;
+    uint32_t thread_index;
+    uint8_t level;
+    char text[kMessageBytes];
+};
+
+// Single producer (the owning thread), single consumer (the flusher).
+struct log_ring {
+    std::vector<log_slot> slots;
+    uint32_t mask;
+    uint32_t thread_index;
+    alignas(64) std::atomic<uint64_t> head;
+    alignas(64) std::atomic<uint64_t> tail;
+    // Only written by the producer.
+    alignas(64) std::atomic<uint64_t> dropped;
+    // Set when the owning thread exits, so the flusher can drop the ring.
+    std::atomic<bool> abandoned;
+};
+
+struct otk_logger {
+    uint64_t id;
+    otk_logger_config config;
+    std::string path;
+    std::atomic<int> level;
+
+    std::mutex rings_lock;
+    std::vector<std::shared_ptr<log_ring>> rings;
+    uint32_t next_thread_index;
+
+    FILE *file;
+    uint64_t file_bytes;
+
+    std::mutex flush_lock;
+    std::condition_variable flush_wake;
+    std::condition_variable flush_done;
+    bool running;
+    uint64_t flush_requested;
+    uint64_t flush_completed;
+    std::thread flusher;
+
+    // Only written by the flusher.
+    std::atomic<uint64_t> messages_written;
+    std::atomic<uint64_t> dropped_from_abandoned;
+    std::atomic<uint64_t> bytes_written;
+    std::atomic<uint64_t> files_rotated;
+};
+
+struct thread_ring {
+    uint64_t logger_id = 0;
+    std::shared_ptr<log_ring> ring;
+
+    ~thread_ring() {
+        if (ring) {
+            ring->abandoned.store(true, std::memory_order_release);
+        }
+    }
+};
+
+static thread_local thread_ring current_ring;
+static std::atomic<uint64_t> next_logger_id(1);
+static std::atomic<otk_logger *> default_logger(nullptr);
+
+void otk_logger_config_default(otk_logger_config *config) {
+    if (config == nullptr) {
+        return;
+    }
+    config->level = OTK_LOG_INFO;
+    config->path = nullptr;
+    config->max_file_bytes = 4 * 1024 * 1024;
+    config->max_files = 3;
+    config->ring_capacity = 1024;
+    config->flush_interval_ms = 50;
+}
+
+static int64_t wall_clock_us(void) {
+    return (int64_t)std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::system_clock::now().time_since_epoch()).count();
+}
+
+static FILE *open_log_file(otk_logger *logger) {
+    if (logger->path.empty()) {
+        logger->file_bytes = 0;
+        return stderr;
+    }
+    FILE *file = fopen(logger->path.c_str(), "a");
+    if (file != nullptr) {
+        fseek(file, 0, SEEK_END);
+        long size = ftell(file);
+        logger->file_bytes = size > 0 ? (uint64_t)size : 0;
+    }
+    return file;
+}
+
+// Shifts path.N-1 to path.N down to path to path.1 and starts a new file.
+static void rotate(otk_logger *logger) {
+    fclose(logger->file);
+    uint32_t kept = logger->config.max_files;
+    if (kept == 0) {
+        remove(logger->path.c_str());
+    } else {
+        for (uint32_t i = kept; i > 0; i--) {
+            std::string to = logger->path + "." + std::to_string(i);
+            std::string from = i > 1 ? logger->path + "." + std::to_string(i - 1) : logger->path;
+            rename(from.c_str(), to.c_str());
+        }
+    }
+    logger->file = open_log_file(logger);
+    logger->files_rotated.fetch_add(1, std::memory_order_relaxed);
+}
+
+static void write_slot(otk_logger *logger, const log_slot &slot) {
+    if (logger->file == nullptr) {
+        return;
+    }
+    time_t seconds = (time_t)(slot.time_us / 1000000);
+    struct tm local;
+    localtime_r(&seconds, &local);
+    char prefix[64];
+    size_t prefix_length = strftime(prefix, sizeof(prefix), "%Y-%m-%d %H:%M:%S", &local);
+    int written = fprintf(logger->file, "%.*s.%06d [%s] [%u] %s\n",
+                          (int)prefix_length, prefix, (int)(slot.time_us % 1000000),
+                          kLevelNames[slot.level], slot.thread_index, slot.text);
+    if (written > 0) {
+        logger->file_bytes += (uint64_t)written;
+        logger->bytes_written.fetch_add((uint64_t)written, std::memory_order_relaxed);
+    }
+    logger->messages_written.fetch_add(1, std::memory_order_relaxed);
+    if (logger->file != stderr && logger->config.max_file_bytes > 0 &&
+        logger->file_bytes >= logger->config.max_file_bytes) {
+        rotate(logger);
+    }
+}
+
+// Writes out everything queued so far, merging the threads' rings by time.
+static void drain(otk_logger *logger) {
+    std::lock_guard<std::mutex> guard(logger->rings_lock);
+    std::vector<std::shared_ptr<log_ring>> &rings = logger->rings;
+    std::vector<uint64_t> heads(rings.size());
+    for (size_t i = 0; i < rings.size(); i++) {
+        heads[i] = rings[i]->head.load(std::memory_order_acquire);
+    }
+    for (;;) {
+        log_ring *oldest = nullptr;
+        for (size_t i = 0; i < rings.size(); i++) {
+            log_ring *ring = rings[i].get();
+            uint64_t tail = ring->tail.load(std::memory_order_relaxed);
+            if (tail == heads[i]) {
+                continue;
+            }
+            if (oldest == nullptr ||
+                ring->slots[tail & ring->mask].time_us <
+                oldest->slots[oldest->tail.load(std::memory_order_relaxed) & oldest->mask].time_us) {
+                oldest = ring;
+            }
+        }
+        if (oldest == nullptr) {
+            break;
+        }
+        uint64_t tail = oldest->tail.load(std::memory_order_relaxed);
+        write_slot(logger, oldest->slots[tail & oldest->mask]);
+        oldest->tail.store(tail + 1, std::memory_order_release);
+    }
+    if (logger->file != nullptr) {
+        fflush(logger->file);
+    }
+    // Forget the rings of threads that are gone once they are empty.
+    for (size_t i = rings.size(); i > 0; i--) {
+        log_ring *ring = rings[i - 1].get();
+        if (ring->abandoned.load(std::memory_order_acquire) &&
+            ring->tail.load(std::memory_order_relaxed) ==
+            ring->head.load(std::memory_order_acquire)) {
+            logger->dropped_from_abandoned.fetch_add(ring->dropped.load(std::memory_order_relaxed),
+                                                     std::memory_order_relaxed);
+            rings.erase(rings.begin() + (i - 1));
+        }
+    }
+}
+
+static void flusher_main(otk_logger *logger) {
+    std::unique_lock<std::mutex> lock(logger->flush_lock);
+    for (;;) {
+        uint64_t requested = logger->flush_requested;
+        bool running = logger->running;
+        lock.unlock();
+        drain(logger);
+        lock.lock();
+        logger->flush_completed = requested;
+        logger->flush_done.notify_all();
+        if (!running) {
+            return;
+        }
+        logger->flush_wake.wait_for(lock, std::chrono::milliseconds(logger->config.flush_interval_ms),
+                                    [logger, requested] {
+                                        return !logger->running ||
+                                            logger->flush_requested != requested;
+                                    });
+    }
+}
+
+otk_logger *otk_logger_new(const otk_logger_config *config) {
+    otk_logger *logger = new otk_logger();
+    if (config != nullptr) {
+        logger->config = *config;
+    } else {
+        otk_logger_config_default(&logger->config);
+    }
+    uint32_t capacity = 1;
+    while (capacity < logger->config.ring_capacity) {
+        capacity <<= 1;
+    }
+    logger->config.ring_capacity = capacity;
+    if (logger->config.flush_interval_ms == 0) {
+        logger->config.flush_interval_ms = 50;
+    }
+    logger->path = logger->config.path != nullptr ? logger->config.path : "";
+    logger->config.path = nullptr;
+    logger->id = next_logger_id.fetch_add(1);
+    logger->level.store(logger->config.level);
+    logger->next_thread_index = 0;
+    logger->file = open_log_file(logger);
+    if (logger->file == nullptr) {
+        delete logger;
+        return nullptr;
+    }
+    logger->running = true;
+    logger->flush_requested = 0;
+    logger->flush_completed = 0;
+    logger->messages_written.store(0);
+    logger->dropped_from_abandoned.store(0);
+    logger->bytes_written.store(0);
+    logger->files_rotated.store(0);
+    logger->flusher = std::thread(flusher_main, logger);
+    return logger;
+}
+
+void otk_logger_delete(otk_logger *logger) {
+    if (logger == nullptr) {
+        return;
+    }
+    otk_logger *expected = logger;
+    default_logger.compare_exchange_strong(expected, nullptr);
+    {
+        std::lock_guard<std::mutex> guard(logger->flush_lock);
+        logger->running = false;
+    }
+    logger->flush_wake.notify_all();
+    logger->flusher.join();
+    if (logger->file != nullptr && logger->file != stderr) {
+        fclose(logger->file);
+    }
+    delete logger;
+}
+
+int otk_logger_enabled(otk_logger *logger, enum otk_log_level level) {
+    return logger != nullptr && (int)level <= logger->level.load(std::memory_order_relaxed);
+}
+
+void otk_logger_set_level(otk_logger *logger, enum otk_log_level level) {
+    if (logger != nullptr) {
+        logger->level.store(level, std::memory_order_relaxed);
+    }
+}
+
+// Returns the calling thread's ring, creating it on the thread's first
+// message. This is the only place that allocates or locks.
+static log_ring *ring_for_thread(otk_logger *logger) {
+    thread_ring &current = current_ring;
+    if (current.logger_id == logger->id) {
+        return current.ring.get();
+    }
+    if (current.ring) {
+        current.ring->abandoned.store(true, std::memory_order_release);
+    }
+    auto ring = std::make_shared<log_ring>();
+    ring->slots.resize(logger->config.ring_capacity);
+    ring->mask = logger->config.ring_capacity - 1;
+    ring->head.store(0);
+    ring->tail.store(0);
+    ring->dropped.store(0);
+    ring->abandoned.store(false);
+    {
+        std::lock_guard<std::mutex> guard(logger->rings_lock);
+        ring->thread_index = logger->next_thread_index++;
+        logger->rings.push_back(ring);
+    }
+    current.logger_id = logger->id;
+    current.ring = std::move(ring);
+    return current.ring.get();
+}
+
+void otk_logger_logv(otk_logger *logger, enum otk_log_level level, const char *format,
+                     va_list args) {
+    if (!otk_logger_enabled(logger, level)) {
+        return;
+    }
+    log_ring *ring = ring_for_thread(logger);
+    uint64_t head = ring->head.load(std::memory_order_relaxed);
+    if (head - ring->tail.load(std::memory_order_acquire) > ring->mask) {
+        ring->dropped.store(ring->dropped.load(std::memory_order_relaxed) + 1,
+                            std::memory_order_relaxed);
+        return;
+    }
+    log_slot &slot = ring->slots[head & ring->mask];
+    slot.time_us = wall_clock_us();
+    slot.thread_index = ring->thread_index;
+    slot.level = (uint8_t)level;
+    vsnprintf(slot.text, sizeof(slot.text), format, args);
+    ring->head.store(head + 1, std::memory_order_release);
+}
+
+void otk_logger_log(otk_logger *logger, enum otk_log_level level, const char *format, ...) {
+    va_list args;
+    va_start(args, format);
+    otk_logger_logv(logger, level, format, args);
+    va_end(args);
+}
+
+void otk_logger_flush(otk_logger *logger) {
+    if (logger == nullptr) {
+        return;
+    }
+    std::unique_lock<std::mutex> lock(logger->flush_lock);
+    uint64_t requested = ++logger->flush_requested;
+    logger->flush_wake.notify_all();
+    logger->flush_done.wait(lock, [logger, requested] {
+        return logger->flush_completed >= requested;
+    });
+}
+
+void otk_logger_get_stats(otk_logger *logger, otk_logger_stats *stats) {
+    if (logger == nullptr || stats == nullptr) {
+        return;
+    }
+    std::lock_guard<std::mutex> guard(logger->rings_lock);
+    stats->messages_written = logger->messages_written.load(std::memory_order_relaxed);
+    stats->messages_dropped = logger->dropped_from_abandoned.load(std::memory_order_relaxed);
+    for (const std::shared_ptr<log_ring> &ring : logger->rings) {
+        stats->messages_dropped += ring->dropped.load(std::memory_order_relaxed);
+    }
+    stats->bytes_written = logger->bytes_written.load(std::memory_order_relaxed);
+    stats->files_rotated = logger->files_rotated.load(std::memory_order_relaxed);
+    stats->threads = (uint32_t)logger->rings.size();
+}
+
+void otk_logger_set_default(otk_logger *logger) {
+    default_logger.store(logger, std::memory_order_release);
+}
+
+otk_logger *otk_logger_default(void) {
+    return default_logger.load(std::memory_order_acquire);
+}
@@ -0,0 +1,236 @@
+//
+//  OTAudioLevelMeter.cpp
+//  Custom-Audio-Driver
+//
+//  Copyright (c) 2026 Vonage. All rights reserved.
+//
+
+#include "OTAudioLevelMeter.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+
+#if defined(__ARM_NEON) || defined(__ARM_NEON__)
+#include <arm_neon.h>
+#define OTK_LEVEL_NEON 1
+#elif defined(__SSE2__)
+#include <emmintrin.h>
+#define OTK_LEVEL_SSE2 1
+#endif
+
+static const float kSilenceDbfs = -100.0f;
+
+// Voice activity thresholds. A block is speech when it is well above the
+// tracked noise floor, above an absolute minimum and not dominated by
+// high frequency hiss (zero crossing rate).
+static const float kSpeechMarginDb = 9.0f;
+static const float kSpeechMinimumDbfs = -55.0f;
+static const float kSpeechMaxZeroCrossingRate = 0.35f;
+static const float kHangoverSeconds = 0.25f;
+
+// Noise floor follows quiet blocks quickly and rises slowly so speech does
+// not pull it up.
+static const float kNoiseFloorInitialDbfs = -60.0f;
+static const float kNoiseFloorFallFactor = 0.2f;
+static const float kNoiseFloorRiseDbPerSecond = 1.0f;
+static const float kNoiseFloorMinDbfs = -90.0f;
+static const float kNoiseFloorMaxDbfs = -20.0f;
+
+struct otk_audio_level_meter {
+    uint32_t sample_rate;
+
+    // Real-time thread state.
+    float noise_floor_dbfs;
+    float hangover_seconds;
+    uint32_t blocks;
+
+    // Published result, guarded by a sequence counter: odd while the audio
+    // thread is writing. Readers retry instead of blocking the writer.
+    std::atomic<uint32_t> sequence;
+    std::atomic<float> rms_dbfs;
+    std::atomic<float> peak_dbfs;
+    std::atomic<float> published_noise_floor_dbfs;
+    std::atomic<int> voice_active;
+    std::atomic<uint32_t> published_blocks;
+};
+
+void otk_audio_level_sum_squares_scalar(const int16_t *samples,
+                                        uint32_t count,
+                                        uint64_t *sum_squares,
+                                        int32_t *peak) {
+    uint64_t sum = 0;
+    int32_t max = 0;
+    for (uint32_t i = 0; i < count; i++) {
+        int32_t s = samples[i];
+        sum += (uint64_t)(s * s);
+        max = std::max(max, s < 0 ? -s : s);
+    }
+    *sum_squares = sum;
+    *peak = max;
+}
+
+void otk_audio_level_sum_squares(const int16_t *samples,
+                                 uint32_t count,
+                                 uint64_t *sum_squares,
+                                 int32_t *peak) {
+    uint32_t i = 0;
+    uint64_t sum = 0;
+    int32_t max = 0;
+#if OTK_LEVEL_NEON
+    int64x2_t acc = vdupq_n_s64(0);
+    // The largest and smallest sample rather than the largest magnitude,
+    // which does not fit 16 bits for -32768.
+    int16x8_t vmax = vdupq_n_s16(0);
+    int16x8_t vmin = vdupq_n_s16(0);
+    for (; i + 8 <= count; i += 8) {
+        int16x8_t v = vld1q_s16(samples + i);
+        acc = vpadalq_s32(acc, vmull_s16(vget_low_s16(v), vget_low_s16(v)));
+        acc = vpadalq_s32(acc, vmull_s16(vget_high_s16(v), vget_high_s16(v)));
+        vmax = vmaxq_s16(vmax, v);
+        vmin = vminq_s16(vmin, v);
+    }
+    sum = (uint64_t)(vgetq_lane_s64(acc, 0) + vgetq_lane_s64(acc, 1));
+    int16x4_t hi = vmax_s16(vget_low_s16(vmax), vget_high_s16(vmax));
+    hi = vpmax_s16(hi, hi);
+    hi = vpmax_s16(hi, hi);
+    int16x4_t lo = vmin_s16(vget_low_s16(vmin), vget_high_s16(vmin));
+    lo = vpmin_s16(lo, lo);
+    lo = vpmin_s16(lo, lo);
+    max = std::max<int32_t>(vget_lane_s16(hi, 0), -(int32_t)vget_lane_s16(lo, 0));
+#elif OTK_LEVEL_SSE2
+    const __m128i zero = _mm_setzero_si128();
+    __m128i acc = _mm_setzero_si128();
+    // The largest and smallest sample rather than the largest magnitude,
+    // which does not fit 16 bits for -32768.
+    __m128i vmax = _mm_setzero_si128();
+    __m128i vmin = _mm_setzero_si128();
+    for (; i + 8 <= count; i += 8) {
+        __m128i v = _mm_loadu_si128((const __m128i *)(samples + i));
+        // Each 32 bit lane holds the sum of two squares. It only overflows
+        // the signed range for two -32768 samples, so widen it as unsigned.
+        __m128i pairs = _mm_madd_epi16(v, v);
+        acc = _mm_add_epi64(acc, _mm_unpacklo_epi32(pairs, zero));
+        acc = _mm_add_epi64(acc, _mm_unpackhi_epi32(pairs, zero));
+        vmax = _mm_max_epi16(vmax, v);
+        vmin = _mm_min_epi16(vmin, v);
+    }
+    uint64_t lanes[2];
+    _mm_storeu_si128((__m128i *)lanes, acc);
+    sum = lanes[0] + lanes[1];
+    vmax = _mm_max_epi16(vmax, _mm_srli_si128(vmax, 8));
+    vmax = _mm_max_epi16(vmax, _mm_srli_si128(vmax, 4));
+    vmax = _mm_max_epi16(vmax, _mm_srli_si128(vmax, 2));
+    vmin = _mm_min_epi16(vmin, _mm_srli_si128(vmin, 8));
+    vmin = _mm_min_epi16(vmin, _mm_srli_si128(vmin, 4));
+    vmin = _mm_min_epi16(vmin, _mm_srli_si128(vmin, 2));
+    max = std::max<int32_t>((int16_t)_mm_cvtsi128_si32(vmax), -(int32_t)(int16_t)_mm_cvtsi128_si32(vmin));
+#endif
+    if (i < count) {
+        uint64_t tail_sum = 0;
+        int32_t tail_peak = 0;
+        otk_audio_level_sum_squares_scalar(samples + i, count - i, &tail_sum, &tail_peak);
+        sum += tail_sum;
+        max = std::max(max, tail_peak);
+    }
+    *sum_squares = sum;
+    *peak = max;
+}
+
+static uint32_t zero_crossings(const int16_t *samples, uint32_t count) {
+    // Written so the compiler can vectorize it.
+    uint32_t crossings = 0;
+    for (uint32_t i = 1; i < count; i++) {
+        crossings += (uint32_t)((samples[i - 1] ^ samples[i]) < 0);
+    }
+    return crossings;
+}
+
+static float to_dbfs(double value) {
+    if (value <= 0.0) {
+        return kSilenceDbfs;
+    }
+    return std::max(kSilenceDbfs, (float)(20.0 * std::log10(value / 32768.0)));
+}
+
+otk_audio_level_meter *otk_audio_level_meter_new(uint32_t sample_rate) {
+    otk_audio_level_meter *meter = new otk_audio_level_meter();
+    meter->sample_rate = sample_rate > 0 ? sample_rate : 44100;
+    meter->noise_floor_dbfs = kNoiseFloorInitialDbfs;
+    meter->hangover_seconds = 0;
+    meter->blocks = 0;
+    meter->sequence.store(0);
+    meter->rms_dbfs.store(kSilenceDbfs);
+    meter->peak_dbfs.store(kSilenceDbfs);
+    meter->published_noise_floor_dbfs.store(kNoiseFloorInitialDbfs);
+    meter->voice_active.store(0);
+    meter->published_blocks.store(0);
+    return meter;
+}
+
+void otk_audio_level_meter_delete(otk_audio_level_meter *meter) {
+    delete meter;
+}
+
+void otk_audio_level_meter_process(otk_audio_level_meter *meter,
+                                   const int16_t *samples,
+                                   uint32_t count) {
+    if (meter == nullptr || samples == nullptr || count == 0) {
+        return;
+    }
+    uint64_t sum_squares = 0;
+    int32_t peak = 0;
+    otk_audio_level_sum_squares(samples, count, &sum_squares, &peak);
+
+    float rms_dbfs = to_dbfs(std::sqrt((double)sum_squares / count));
+    float peak_dbfs = to_dbfs(peak);
+    float block_seconds = (float)count / meter->sample_rate;
+    float zcr = count > 1 ? (float)zero_crossings(samples, count) / (count - 1) : 0;
+
+    if (rms_dbfs < meter->noise_floor_dbfs) {
+        meter->noise_floor_dbfs += (rms_dbfs - meter->noise_floor_dbfs) * kNoiseFloorFallFactor;
+    } else {
+        meter->noise_floor_dbfs += std::min(rms_dbfs - meter->noise_floor_dbfs,
+                                            kNoiseFloorRiseDbPerSecond * block_seconds);
+    }
+    meter->noise_floor_dbfs = std::clamp(meter->noise_floor_dbfs,
+                                         kNoiseFloorMinDbfs, kNoiseFloorMaxDbfs);
+
+    bool speech = rms_dbfs > meter->noise_floor_dbfs + kSpeechMarginDb &&
+        rms_dbfs > kSpeechMinimumDbfs &&
+        zcr < kSpeechMaxZeroCrossingRate;
+    if (speech) {
+        meter->hangover_seconds = kHangoverSeconds;
+    } else {
+        meter->hangover_seconds = std::max(0.0f, meter->hangover_seconds - block_seconds);
+    }
+    meter->blocks++;
+
+    uint32_t sequence = meter->sequence.load(std::memory_order_relaxed);
+    meter->sequence.store(sequence + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    meter->rms_dbfs.store(rms_dbfs, std::memory_order_relaxed);
+    meter->peak_dbfs.store(peak_dbfs, std::memory_order_relaxed);
+    meter->published_noise_floor_dbfs.store(meter->noise_floor_dbfs, std::memory_order_relaxed);
+    meter->voice_active.store(speech || meter->hangover_seconds > 0, std::memory_order_relaxed);
+    meter->published_blocks.store(meter->blocks, std::memory_order_relaxed);
+    meter->sequence.store(sequence + 2, std::memory_order_release);
+}
+
+void otk_audio_level_meter_get(const otk_audio_level_meter *meter,
+                               otk_audio_level *level) {
+    if (meter == nullptr || level == nullptr) {
+        return;
+    }
+    uint32_t before, after;
+    do {
+        before = meter->sequence.load(std::memory_order_acquire);
+        level->rms_dbfs = meter->rms_dbfs.load(std::memory_order_relaxed);
+        level->peak_dbfs = meter->peak_dbfs.load(std::memory_order_relaxed);
+        level->noise_floor_dbfs = meter->published_noise_floor_dbfs.load(std::memory_order_relaxed);
+        level->voice_active = meter->voice_active.load(std::memory_order_relaxed);
+        level->blocks = meter->published_blocks.load(std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_acquire);
+        after = meter->sequence.load(std::memory_order_relaxed);
+    } while ((before & 1) || before != after);
+}
@@ -0,0 +1,72 @@
+//
+//  OTAudioLevelMeter.h
+//  Custom-Audio-Driver
+//
+//  Copyright (c) 2026 Vonage. All rights reserved.
+//
+
+#ifndef OTAudioLevelMeter_h
+#define OTAudioLevelMeter_h
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * Level and voice activity of the most recent capture callback.
+ */
+typedef struct otk_audio_level {
+    /** RMS level in dBFS, -100 for digital silence. */
+    float rms_dbfs;
+    /** Peak level in dBFS, -100 for digital silence. */
+    float peak_dbfs;
+    /** Current estimate of the background noise level in dBFS. */
+    float noise_floor_dbfs;
+    /** 1 while voice is detected, including the hangover period. */
+    int voice_active;
+    /** Number of blocks processed so far. */
+    uint32_t blocks;
+} otk_audio_level;
+
+typedef struct otk_audio_level_meter otk_audio_level_meter;
+
+otk_audio_level_meter *otk_audio_level_meter_new(uint32_t sample_rate);
+
+void otk_audio_level_meter_delete(otk_audio_level_meter *meter);
+
+/**
+ * Measures one block of mono 16 bit samples. It does not allocate, lock or
+ * block, so it can be called from the real-time audio thread. Must only be
+ * called from one thread at a time.
+ */
+void otk_audio_level_meter_process(otk_audio_level_meter *meter,
+                                   const int16_t *samples,
+                                   uint32_t count);
+
+/**
+ * Reads the latest published result. Lock-free, safe from any thread.
+ */
+void otk_audio_level_meter_get(const otk_audio_level_meter *meter,
+                               otk_audio_level *level);
+
+/**
+ * Sum of squares and absolute peak of a block. Exposed for benchmarking the
+ * vector kernel against the scalar one.
+ */
+void otk_audio_level_sum_squares(const int16_t *samples,
+                                 uint32_t count,
+                                 uint64_t *sum_squares,
+                                 int32_t *peak);
+
+void otk_audio_level_sum_squares_scalar(const int16_t *samples,
+                                        uint32_t count,
+                                        uint64_t *sum_squares,
+                                        int32_t *peak);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* OTAudioLevelMeter_h */
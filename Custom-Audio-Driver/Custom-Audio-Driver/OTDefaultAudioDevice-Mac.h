@@ -11,6 +11,11 @@
 #import <CoreAudio/CoreAudio.h>
 #import <AudioUnit/AudioUnit.h>
 #import "OTAudioDeviceProxy.h"
+#import "OTAudioLevelMeter.h"
+#import "OTTimeStretch.h"
+#import "OTDeviceSwitch.h"
+#import "OTLatencyProbe.h"
+#import "OTAVSyncMonitor.h"
 
 #define kMixerInputBusCount 2
 #define kOutputBus 0
@@ -58,4 +63,46 @@
 - (uint16_t)estimatedCaptureDelay;
 
 - (BOOL)setPlayOutRenderCallback:(AudioUnit)unit;
+
+/**
+ Level and voice activity of the latest capture callback. Lock-free, can be
+ polled from any thread.
+ */
+- (otk_audio_level)captureLevel;
+
+/**
+ Tempo, buffering and gap counters of the playout time stretch. Zero when
+ OT_ENABLE_PLAYOUT_STRETCH is off. Lock-free, can be polled from any thread.
+ */
+- (otk_time_stretch_stats)playoutStretchStats;
+
+/**
+ Time taken and audio dropped by the last input device switches. Zero when
+ OT_ENABLE_SEAMLESS_DEVICE_SWITCH is off.
+ */
+- (otk_device_switch_stats)captureSwitchStats;
+
+/**
+ Measures the round trip from playout to capture by playing count chirps,
+ one a second, in place of the received audio and finding them in the captured
+ audio. Each result is logged next to the estimated render and capture
+ delays. Returns NO when OT_ENABLE_LATENCY_PROBE is off.
+ */
+- (BOOL)startLatencyMeasurement:(uint32_t)count;
+- (void)stopLatencyMeasurement;
+
+/**
+ Round trip statistics of the current or last measurement.
+ */
+- (otk_latency_stats)latencyStats;
+
+/**
+ Render skew monitor fed with the mixed received audio: its hand-off time
+ as the media time, in microseconds, and the time it is heard, both on the
+ CLOCK_UPTIME_RAW clock. Report subscribers' video frames to it the same
+ way, with the time the SDK handed them over and the time they were queued
+ to the view.
+ NULL when OT_ENABLE_AV_SYNC_MONITOR is off.
+ */
+- (otk_av_sync_monitor *)syncMonitor;
 @end
@@ -9,20 +9,70 @@
 #import <AVFoundation/AVFoundation.h>
 #include <mach/mach.h>
 #include <mach/mach_time.h>
+#include "OTAsyncLogger.h"
 
 #define kSampleRate 44100
 
 #define OT_ENABLE_AUDIO_DEBUG 1
 #define RETRY_COUNT 5
 
+// Set to 1 to play received audio through OTTimeStretch, which drains
+// bursts and covers short gaps by changing the tempo instead of dropping or
+// inserting silence. Adds about 40 ms of playout delay, and only helps when
+// the SDK returns short reads rather than concealing gaps itself.
+#define OT_ENABLE_PLAYOUT_STRETCH 0
+// Largest playout callback the stretch handles; larger ones bypass it.
+#define kPlayoutStretchMaxFrames 4096
+
+// Switch input devices by bringing up a unit on the new default device next
+// to the running one and crossfading over to it with OTDeviceSwitch, instead
+// of stopping and recreating the unit. Playout units are DefaultOutput units,
+// which follow the default output device by themselves. Off by default until
+// it has been tried against real device changes; the tests only drive
+// OTDeviceSwitch with simulated callbacks.
+#define OT_ENABLE_SEAMLESS_DEVICE_SWITCH 0
+#define kDeviceSwitchCrossfadeMs 5
+#define kDeviceSwitchMaxFrames 4096
+// Gives up on a new unit that delivers nothing for this long.
+#define kDeviceSwitchTimeout 2.0
+
+// Let -startLatencyMeasurement: play chirps and find them in the captured
+// audio with OTLatencyProbe to measure the device's round trip.
+#define OT_ENABLE_LATENCY_PROBE 1
+// How often the probe looks for chirps in the captured audio.
+#define kLatencyAnalyzeIntervalMs 100
+
+// Report when received audio is handed over and heard to an OTAVSyncMonitor,
+// so subscribers' video can be checked against the local audio path. The
+// SDK's audio is mixed and carries no media timestamp, so this measures the
+// render skew the two local paths add after the SDK, shared by all streams,
+// not lip sync per stream. Off by default: it costs a report per playout
+// callback and is only read by OT_ENABLE_RENDER_SKEW_LOG in ViewController.m.
+#define OT_ENABLE_AV_SYNC_MONITOR 0
+
 #if OT_ENABLE_AUDIO_DEBUG
-#define OT_AUDIO_DEBUG(fmt, ...) NSLog(fmt, ##__VA_ARGS__)
+// Goes through the async logger so the audio threads never wait on NSLog.
+#define OT_AUDIO_DEBUG(fmt, ...) OTK_LOG_DEFAULT(OTK_LOG_DEBUG, fmt, ##__VA_ARGS__)
 #else
 #define OT_AUDIO_DEBUG(fmt, ...)
 #endif
 
 static mach_timebase_info_data_t info;
 
+@class OTDefaultAudioDeviceMac;
+
+// A voice unit and what its callbacks need, passed as their refCon. Capture
+// has two slots so a new unit can run next to the old one while switching
+// devices.
+typedef struct ot_voice_unit {
+    __unsafe_unretained OTDefaultAudioDeviceMac *device;
+    int slot;
+    AudioUnit unit;
+    AudioBufferList *buffer_list;
+    uint32_t buffer_num_frames;
+    uint32_t buffer_size;
+} ot_voice_unit;
+
 static OSStatus recording_cb(void *ref_con,
                              AudioUnitRenderActionFlags *action_flags,
                              const AudioTimeStamp *time_stamp,
@@ -38,15 +88,16 @@ static OSStatus playout_cb(void *ref_con,
                            AudioBufferList *data);
 
 @interface OTDefaultAudioDeviceMac ()
-- (BOOL) setupAudioUnit:(AudioUnit *)voice_unit playout:(BOOL)isPlayout;
+- (BOOL) setupAudioUnit:(ot_voice_unit *)voice_unit playout:(BOOL)isPlayout;
+- (void) switchCaptureUnits;
+- (void) finishCaptureSwitch;
+- (void) abandonCaptureSwitch:(uint32_t)generation;
 @end
 
 @implementation OTDefaultAudioDeviceMac
 {
     OTAudioFormat *_audioFormat;
     
-    AudioUnit recording_voice_unit;
-    AudioUnit playout_voice_unit;
     BOOL playing;
     BOOL playout_initialized;
     BOOL recording;
@@ -62,10 +113,23 @@ static OSStatus playout_cb(void *ref_con,
     
 @public
     id _audioBus;
+    otk_audio_level_meter *_levelMeter;
+    otk_time_stretch *_timeStretch;
+    otk_device_switch *_captureSwitch;
+    // Signalled by the capture callback once the new unit took over.
+    dispatch_source_t _captureSwitchDone;
+    uint32_t _captureSwitchGeneration;
+    int _captureSwitchSlot;
+    CFTimeInterval _captureSwitchStarted;
+    otk_latency_probe *_latencyProbe;
+    dispatch_source_t _latencyTimer;
+    // Echo cancellation is bypassed while chirps play, or it would remove
+    // them from the captured audio before the probe sees them.
+    BOOL _voiceProcessingBypassed;
+    otk_av_sync_monitor *_syncMonitor;
     
-    AudioBufferList *buffer_list;
-    uint32_t buffer_num_frames;
-    uint32_t buffer_size;
+    ot_voice_unit recording_units[2];
+    ot_voice_unit playout_unit;
     uint32_t _recordingDelay;
     uint32_t _playoutDelay;
     uint32_t _playoutDelayMeasurementCounter;
@@ -87,6 +151,32 @@ static OSStatus playout_cb(void *ref_con,
         _safetyQueue = dispatch_queue_create("ot-audio-driver",
                                              DISPATCH_QUEUE_SERIAL);
         _restartRetryCount = 0;
+        _levelMeter = otk_audio_level_meter_new(kSampleRate);
+#if OT_ENABLE_PLAYOUT_STRETCH
+        _timeStretch = otk_time_stretch_new(kSampleRate, kPlayoutStretchMaxFrames);
+#endif
+#if OT_ENABLE_SEAMLESS_DEVICE_SWITCH
+        _captureSwitch = otk_device_switch_new(kSampleRate, kDeviceSwitchMaxFrames, kDeviceSwitchCrossfadeMs);
+        _captureSwitchDone = dispatch_source_create(DISPATCH_SOURCE_TYPE_DATA_OR, 0, 0, _safetyQueue);
+        __weak OTDefaultAudioDeviceMac *weakSelf = self;
+        dispatch_source_set_event_handler(_captureSwitchDone, ^{
+            [weakSelf finishCaptureSwitch];
+        });
+        dispatch_resume(_captureSwitchDone);
+#endif
+#if OT_ENABLE_LATENCY_PROBE
+        mach_timebase_info(&info);
+        _latencyProbe = otk_latency_probe_new(kSampleRate);
+#endif
+#if OT_ENABLE_AV_SYNC_MONITOR
+        mach_timebase_info(&info);
+        _syncMonitor = otk_av_sync_monitor_new();
+#endif
+        for (int slot = 0; slot < 2; slot++) {
+            recording_units[slot].device = self;
+            recording_units[slot].slot = slot;
+        }
+        playout_unit.device = self;
         
         struct AudioObjectPropertyAddress devicePropertyAddress;
         devicePropertyAddress.mSelector = kAudioHardwarePropertyDefaultOutputDevice;
@@ -102,6 +192,11 @@ static OSStatus playout_cb(void *ref_con,
                     case kAudioHardwarePropertyDefaultOutputDevice:
                         [self setDefaultOutput];
                         break;
+                    case kAudioHardwarePropertyDefaultInputDevice:
+                        dispatch_async(self->_safetyQueue, ^() {
+                            [self switchCaptureUnits];
+                        });
+                        break;
                     default:
                         break;
                 }
@@ -114,6 +209,14 @@ static OSStatus playout_cb(void *ref_con,
             NSError *error = [NSError errorWithDomain:NSOSStatusErrorDomain code:status userInfo:nil];
             NSLog(@"error: %@", error.localizedDescription);
         }
+#if OT_ENABLE_SEAMLESS_DEVICE_SWITCH
+        devicePropertyAddress.mSelector = kAudioHardwarePropertyDefaultInputDevice;
+        status = AudioObjectAddPropertyListenerBlock(kAudioObjectSystemObject, &devicePropertyAddress, nil, audioObjectPropertyListenerBlock);
+        if (status != noErr) {
+            NSError *error = [NSError errorWithDomain:NSOSStatusErrorDomain code:status userInfo:nil];
+            NSLog(@"error: %@", error.localizedDescription);
+        }
+#endif
     }
     return self;
 }
@@ -132,6 +235,24 @@ static OSStatus playout_cb(void *ref_con,
 {
     [self removeObservers];
     [self teardownAudio];
+    otk_audio_level_meter_delete(_levelMeter);
+    _levelMeter = NULL;
+    otk_time_stretch_delete(_timeStretch);
+    _timeStretch = NULL;
+    if (_captureSwitchDone) {
+        dispatch_source_cancel(_captureSwitchDone);
+        _captureSwitchDone = nil;
+    }
+    otk_device_switch_delete(_captureSwitch);
+    _captureSwitch = NULL;
+    if (_latencyTimer) {
+        dispatch_source_cancel(_latencyTimer);
+        _latencyTimer = nil;
+    }
+    otk_latency_probe_delete(_latencyProbe);
+    _latencyProbe = NULL;
+    otk_av_sync_monitor_delete(_syncMonitor);
+    _syncMonitor = NULL;
     _audioFormat = nil;
    // [super dealloc];
 }
@@ -197,30 +318,33 @@ static OSStatus playout_cb(void *ref_con,
 - (BOOL)startRendering
 {
     @synchronized(self) {
-        OT_AUDIO_DEBUG(@"AudioDevice - startRendering started with playing flag = %d", playing);
+        OT_AUDIO_DEBUG("AudioDevice - startRendering started with playing flag = %d", playing);
         
         if (playing) {
             return YES;
         }
         
         playing = YES;
+        // Do not resume from audio buffered before the last stop
+        otk_time_stretch_reset(_timeStretch);
+        ot_voice_unit *playout_voice_unit = &playout_unit;
         // Initialize only when playout voice unit is already teardown
-        if(playout_voice_unit == NULL)
+        if(playout_voice_unit->unit == NULL)
         {
-            OT_AUDIO_DEBUG(@"AudioDevice - setupAudioUnit for playout");
+            OT_AUDIO_DEBUG("AudioDevice - setupAudioUnit for playout");
             
-            if (NO == [self setupAudioUnit:&playout_voice_unit playout:YES]) {
-                OT_AUDIO_DEBUG(@"AudioDevice - setupAudioUnit - failed");
+            if (NO == [self setupAudioUnit:playout_voice_unit playout:YES]) {
+                OT_AUDIO_DEBUG("AudioDevice - setupAudioUnit - failed");
                 playing = NO;
                 return NO;
             }
         }
         
-        OSStatus result = AudioOutputUnitStart(playout_voice_unit);
+        OSStatus result = AudioOutputUnitStart(playout_voice_unit->unit);
         if (CheckError(result, @"startRendering.AudioOutputUnitStart")) {
             playing = NO;
         }
-        OT_AUDIO_DEBUG(@"startRendering ended with playing flag = %d", playing);
+        OT_AUDIO_DEBUG("startRendering ended with playing flag = %d", playing);
         return playing;
     }
 }
@@ -228,7 +352,7 @@ static OSStatus playout_cb(void *ref_con,
 - (BOOL)stopRendering
 {
     @synchronized(self) {
-        OT_AUDIO_DEBUG(@"stopRendering started with playing flag = %d", playing);
+        OT_AUDIO_DEBUG("stopRendering started with playing flag = %d", playing);
 
         if (!playing) {
             return YES;
@@ -236,7 +360,7 @@ static OSStatus playout_cb(void *ref_con,
         
         playing = NO;
         
-        OSStatus result = AudioOutputUnitStop(playout_voice_unit);
+        OSStatus result = AudioOutputUnitStop(playout_unit.unit);
         if (CheckError(result, @"stopRendering.AudioOutputUnitStop")) {
             return NO;
         }
@@ -248,10 +372,10 @@ static OSStatus playout_cb(void *ref_con,
         
         if (!recording && !isPlayerInterrupted && !_isResetting)
         {
-            OT_AUDIO_DEBUG(@"teardownAudio from stopRendering");
+            OT_AUDIO_DEBUG("teardownAudio from stopRendering");
             [self teardownAudio];
         }
-        OT_AUDIO_DEBUG(@"stopRendering finshed properly");
+        OT_AUDIO_DEBUG("stopRendering finshed properly");
         return YES;
     }
 }
@@ -265,27 +389,28 @@ static OSStatus playout_cb(void *ref_con,
 {
     NSLog(@"Starting capture");
     @synchronized(self) {
-        OT_AUDIO_DEBUG(@"startCapture started with recording flag = %d", recording);
+        OT_AUDIO_DEBUG("startCapture started with recording flag = %d", recording);
         
         if (recording) {
             return YES;
         }
         
         recording = YES;
+        ot_voice_unit *recording_voice_unit = &recording_units[otk_device_switch_active_slot(_captureSwitch)];
         // Initialize only when recording voice unit is already teardown
-        if(recording_voice_unit == NULL)
+        if(recording_voice_unit->unit == NULL)
         {
-            if (NO == [self setupAudioUnit:&recording_voice_unit playout:NO]) {
+            if (NO == [self setupAudioUnit:recording_voice_unit playout:NO]) {
                 recording = NO;
                 return NO;
             }
         }
         
-        OSStatus result = AudioOutputUnitStart(recording_voice_unit);
+        OSStatus result = AudioOutputUnitStart(recording_voice_unit->unit);
         if (CheckError(result, @"startCapture.AudioOutputUnitStart")) {
             recording = NO;
         }
-        OT_AUDIO_DEBUG(@"startCapture finished with recording flag = %d", recording);
+        OT_AUDIO_DEBUG("startCapture finished with recording flag = %d", recording);
         return recording;
     }
 }
@@ -293,7 +418,7 @@ static OSStatus playout_cb(void *ref_con,
 - (BOOL)stopCapture
 {
     @synchronized(self) {
-        OT_AUDIO_DEBUG(@"stopCapture started with recording flag = %d", recording);
+        OT_AUDIO_DEBUG("stopCapture started with recording flag = %d", recording);
 
         if (!recording) {
             return YES;
@@ -301,7 +426,14 @@ static OSStatus playout_cb(void *ref_con,
         
         recording = NO;
         
-        OSStatus result = AudioOutputUnitStop(recording_voice_unit);
+        // Both slots, in case a device switch is under way
+        OSStatus result = noErr;
+        for (int slot = 0; slot < 2; slot++) {
+            OSStatus stop_result = recording_units[slot].unit ? AudioOutputUnitStop(recording_units[slot].unit) : noErr;
+            if (stop_result != noErr) {
+                result = stop_result;
+            }
+        }
         
         if (CheckError(result, @"stopCapture.AudioOutputUnitStop")) {
             return NO;
@@ -312,10 +444,10 @@ static OSStatus playout_cb(void *ref_con,
         // subscriber is already closed
         if (!playing && !isRecorderInterrupted && !_isResetting)
         {
-            OT_AUDIO_DEBUG(@"teardownAudio from stopCapture");
+            OT_AUDIO_DEBUG("teardownAudio from stopCapture");
             [self teardownAudio];
         }
-        OT_AUDIO_DEBUG(@"stopCapture finshed properly");
+        OT_AUDIO_DEBUG("stopCapture finshed properly");
         return YES;
     }
 }
@@ -335,6 +467,114 @@ static OSStatus playout_cb(void *ref_con,
     return _recordingDelay;
 }
 
+- (otk_audio_level)captureLevel
+{
+    otk_audio_level level = {0};
+    otk_audio_level_meter_get(_levelMeter, &level);
+    return level;
+}
+
+- (otk_time_stretch_stats)playoutStretchStats
+{
+    otk_time_stretch_stats stats = {0};
+    otk_time_stretch_get_stats(_timeStretch, &stats);
+    return stats;
+}
+
+- (otk_device_switch_stats)captureSwitchStats
+{
+    otk_device_switch_stats stats = {0};
+    otk_device_switch_get_stats(_captureSwitch, &stats);
+    return stats;
+}
+
+- (BOOL)startLatencyMeasurement:(uint32_t)count
+{
+    if (!_latencyProbe || count == 0) {
+        return NO;
+    }
+    otk_latency_probe *probe = _latencyProbe;
+    [self setVoiceProcessingBypass:YES];
+    otk_latency_probe_start(probe, count);
+    
+    dispatch_async(_safetyQueue, ^{
+        if (self->_latencyTimer) {
+            return;
+        }
+        dispatch_source_t timer =
+        dispatch_source_create(DISPATCH_SOURCE_TYPE_TIMER, 0, 0,
+                               dispatch_get_global_queue(QOS_CLASS_UTILITY, 0));
+        dispatch_source_set_timer(timer, DISPATCH_TIME_NOW,
+                                  kLatencyAnalyzeIntervalMs * NSEC_PER_MSEC,
+                                  10 * NSEC_PER_MSEC);
+        __weak OTDefaultAudioDeviceMac *weakSelf = self;
+        dispatch_source_set_event_handler(timer, ^{
+            OTDefaultAudioDeviceMac *strongSelf = weakSelf;
+            if (!strongSelf) {
+                return;
+            }
+            if (otk_latency_probe_analyze(probe) > 0) {
+                otk_latency_stats stats;
+                otk_latency_probe_get_stats(probe, &stats);
+                OT_AUDIO_DEBUG("latency probe: round trip %.2f ms (confidence %.1f), "
+                               "estimated %u ms, %u found, %u missed",
+                               stats.last_ms, stats.last_confidence,
+                               strongSelf.estimatedRenderDelay + strongSelf.estimatedCaptureDelay,
+                               stats.measurements, stats.failures);
+            }
+            if (!otk_latency_probe_active(probe)) {
+                dispatch_async(strongSelf->_safetyQueue, ^{
+                    // A new measurement may have started meanwhile.
+                    if (strongSelf->_latencyTimer && !otk_latency_probe_active(probe)) {
+                        dispatch_source_cancel(strongSelf->_latencyTimer);
+                        strongSelf->_latencyTimer = nil;
+                        [strongSelf setVoiceProcessingBypass:NO];
+                    }
+                });
+            }
+        });
+        self->_latencyTimer = timer;
+        dispatch_resume(timer);
+    });
+    return YES;
+}
+
+// Turns the capture units' echo cancellation and other voice processing
+// off or back on, for the units running now and those set up later.
+- (void)setVoiceProcessingBypass:(BOOL)bypass
+{
+    @synchronized(self) {
+        _voiceProcessingBypassed = bypass;
+        UInt32 flag = bypass ? 1 : 0;
+        for (int slot = 0; slot < 2; slot++) {
+            if (recording_units[slot].unit) {
+                CheckError(AudioUnitSetProperty(recording_units[slot].unit,
+                                                kAUVoiceIOProperty_BypassVoiceProcessing,
+                                                kAudioUnitScope_Global, kInputBus,
+                                                &flag, sizeof(flag)),
+                           @"setVoiceProcessingBypass.AudioUnitSetProperty");
+            }
+        }
+    }
+}
+
+- (void)stopLatencyMeasurement
+{
+    otk_latency_probe_stop(_latencyProbe);
+}
+
+- (otk_latency_stats)latencyStats
+{
+    otk_latency_stats stats = {0};
+    otk_latency_probe_get_stats(_latencyProbe, &stats);
+    return stats;
+}
+
+- (otk_av_sync_monitor *)syncMonitor
+{
+    return _syncMonitor;
+}
+
 static NSString* FormatError(OSStatus error)
 {
     uint32_t as_int = CFSwapInt32HostToLittle(error);
@@ -373,21 +613,24 @@ static bool CheckError(OSStatus error, NSString* function) {
     CheckError(error,function);
 }
 
-- (void)disposePlayoutUnit
+- (void)disposeVoiceUnit:(ot_voice_unit *)voice_unit
 {
-    if (playout_voice_unit) {
-        AudioUnitUninitialize(playout_voice_unit);
-        AudioComponentInstanceDispose(playout_voice_unit);
-        playout_voice_unit = NULL;
+    if (voice_unit->unit) {
+        AudioUnitUninitialize(voice_unit->unit);
+        AudioComponentInstanceDispose(voice_unit->unit);
+        voice_unit->unit = NULL;
     }
 }
 
+- (void)disposePlayoutUnit
+{
+    [self disposeVoiceUnit:&playout_unit];
+}
+
 - (void)disposeRecordUnit
 {
-    if (recording_voice_unit) {
-        AudioUnitUninitialize(recording_voice_unit);
-        AudioComponentInstanceDispose(recording_voice_unit);
-        recording_voice_unit = NULL;
+    for (int slot = 0; slot < 2; slot++) {
+        [self disposeVoiceUnit:&recording_units[slot]];
     }
 }
 
@@ -400,21 +643,24 @@ static bool CheckError(OSStatus error, NSString* function) {
 
 - (void)freeupAudioBuffers
 {
-    if (buffer_list && buffer_list->mBuffers[0].mData) {
-        free(buffer_list->mBuffers[0].mData);
-        buffer_list->mBuffers[0].mData = NULL;
-    }
-    
-    if (buffer_list) {
-        free(buffer_list);
-        buffer_list = NULL;
-        buffer_num_frames = 0;
+    for (int slot = 0; slot < 2; slot++) {
+        ot_voice_unit *voice_unit = &recording_units[slot];
+        if (voice_unit->buffer_list && voice_unit->buffer_list->mBuffers[0].mData) {
+            free(voice_unit->buffer_list->mBuffers[0].mData);
+            voice_unit->buffer_list->mBuffers[0].mData = NULL;
+        }
+        
+        if (voice_unit->buffer_list) {
+            free(voice_unit->buffer_list);
+            voice_unit->buffer_list = NULL;
+            voice_unit->buffer_num_frames = 0;
+        }
     }
 }
 
 - (void) onRouteChangeEvent:(NSNotification *) notification
 {
-    OT_AUDIO_DEBUG(@"onRouteChangeEvent %@",notification);
+    OT_AUDIO_DEBUG("onRouteChangeEvent %s", notification.name.UTF8String);
     dispatch_async(_safetyQueue, ^() {
         [self handleRouteChangeEvent:notification];
     });
@@ -442,6 +688,11 @@ static bool CheckError(OSStatus error, NSString* function) {
         
     }
     
+#if OT_ENABLE_SEAMLESS_DEVICE_SWITCH
+    // We've made it here, there's been a legit route change. The playout
+    // unit follows the default output device by itself.
+    [self switchCaptureUnits];
+#else
     @synchronized(self) {
         // We've made it here, there's been a legit route change.
         // Restart the audio units with correct sample rate
@@ -463,6 +714,102 @@ static bool CheckError(OSStatus error, NSString* function) {
         
         _isResetting = NO;
     }
+#endif
+}
+
+// Brings up a capture unit on the current default device in the free slot
+// while the running one keeps going. The capture callback signals
+// _captureSwitchDone once OTDeviceSwitch has crossfaded over to it, and the
+// old unit is disposed then; a timeout gives up on a new unit that never
+// delivers. Nothing waits on the safety queue in between, so device changes
+// and stop requests are handled as they come.
+- (void)switchCaptureUnits
+{
+    @synchronized(self) {
+        if (!recording) {
+            return;
+        }
+        int slot = otk_device_switch_begin(_captureSwitch);
+        if (slot < 0) {
+            OT_AUDIO_DEBUG("AudioDevice - capture switch already in progress");
+            return;
+        }
+        ot_voice_unit *incoming = &recording_units[slot];
+        if (NO == [self setupAudioUnit:incoming playout:NO] ||
+            CheckError(AudioOutputUnitStart(incoming->unit), @"switchCaptureUnits.AudioOutputUnitStart")) {
+            otk_device_switch_cancel(_captureSwitch);
+            [self disposeVoiceUnit:incoming];
+            return;
+        }
+        uint32_t generation = ++_captureSwitchGeneration;
+        _captureSwitchSlot = slot;
+        _captureSwitchStarted = CACurrentMediaTime();
+        __weak OTDefaultAudioDeviceMac *weakSelf = self;
+        dispatch_after(dispatch_time(DISPATCH_TIME_NOW, (int64_t)(kDeviceSwitchTimeout * NSEC_PER_SEC)),
+                       _safetyQueue, ^{
+            [weakSelf abandonCaptureSwitch:generation];
+        });
+    }
+}
+
+// Runs on the safety queue when the capture callback signals that the
+// switch retired: the old unit can go.
+- (void)finishCaptureSwitch
+{
+    @synchronized(self) {
+        if (otk_device_switch_get_state(_captureSwitch) != OTK_DEVICE_SWITCH_RETIRED) {
+            return;
+        }
+        ot_voice_unit *outgoing = &recording_units[1 - _captureSwitchSlot];
+        if (outgoing->unit) {
+            AudioOutputUnitStop(outgoing->unit);
+        }
+        [self disposeVoiceUnit:outgoing];
+        otk_device_switch_finish(_captureSwitch);
+        otk_device_switch_stats stats = {0};
+        otk_device_switch_get_stats(_captureSwitch, &stats);
+        OT_AUDIO_DEBUG("AudioDevice - capture switched in %.1f ms, first audio after %.1f ms, %llu frames dropped",
+                       stats.last_switch_ms, stats.last_first_audio_ms,
+                       (unsigned long long)stats.last_dropped_frames);
+    }
+}
+
+// Runs on the safety queue once a switch timed out. Does nothing if that
+// switch is over.
+- (void)abandonCaptureSwitch:(uint32_t)generation
+{
+    @synchronized(self) {
+        otk_device_switch_state state = otk_device_switch_get_state(_captureSwitch);
+        if (generation != _captureSwitchGeneration || state == OTK_DEVICE_SWITCH_IDLE) {
+            return;
+        }
+        if (state == OTK_DEVICE_SWITCH_RETIRED) {
+            // Retired after the last capture callback, with capture stopped.
+            [self finishCaptureSwitch];
+            return;
+        }
+        ot_voice_unit *incoming = &recording_units[_captureSwitchSlot];
+        ot_voice_unit *outgoing = &recording_units[1 - _captureSwitchSlot];
+        // The new unit never took over, or capture was stopped in the
+        // middle of the crossfade: keep the old one.
+        if (!otk_device_switch_cancel(_captureSwitch)) {
+            if (outgoing->unit) {
+                AudioOutputUnitStop(outgoing->unit);
+            }
+            if (incoming->unit) {
+                AudioOutputUnitStop(incoming->unit);
+            }
+            otk_device_switch_reset(_captureSwitch);
+            if (recording && outgoing->unit) {
+                AudioOutputUnitStart(outgoing->unit);
+            }
+        } else if (incoming->unit) {
+            AudioOutputUnitStop(incoming->unit);
+        }
+        [self disposeVoiceUnit:incoming];
+        OT_AUDIO_DEBUG("AudioDevice - capture switch abandoned after %.1f ms",
+                       (CACurrentMediaTime() - _captureSwitchStarted) * 1000);
+    }
 }
 
 
@@ -491,6 +838,27 @@ static void update_recording_delay(OTDefaultAudioDeviceMac* device) {
     device->_recordingDelay = device->_recordingDelayHWAndOS;
 }
 
+static int64_t host_time_ns(void)
+{
+    return (int64_t)(mach_absolute_time() * info.numer / info.denom);
+}
+
+// Hands captured audio to the SDK. Called by one unit at a time, the
+// active one or while switching the one OTDeviceSwitch picks.
+static void write_capture(void *user_data, const int16_t *samples, size_t frames)
+{
+    OTDefaultAudioDeviceMac *dev = (__bridge OTDefaultAudioDeviceMac*) user_data;
+    otk_audio_level_meter_process(dev->_levelMeter, samples, frames);
+    if (dev->_latencyProbe) {
+        // The callback runs once the last sample is in.
+        otk_latency_probe_capture(dev->_latencyProbe, samples, frames,
+                                  host_time_ns() - (int64_t)frames * NSEC_PER_SEC / kSampleRate);
+    }
+    [dev->_audioBus writeCaptureData:(void *)samples
+                     numberOfSamples:(uint32_t)frames];
+    update_recording_delay(dev);
+}
+
 static OSStatus recording_cb(void *ref_con,
                              AudioUnitRenderActionFlags *action_flags,
                              const AudioTimeStamp *time_stamp,
@@ -498,34 +866,36 @@ static OSStatus recording_cb(void *ref_con,
                              UInt32 num_frames,
                              AudioBufferList *data)
 {
-    OTDefaultAudioDeviceMac *dev = (__bridge OTDefaultAudioDeviceMac*) ref_con;
+    ot_voice_unit *voice_unit = (ot_voice_unit *) ref_con;
+    OTDefaultAudioDeviceMac *dev = voice_unit->device;
     
-    if (!dev->buffer_list || num_frames > dev->buffer_num_frames)
+    if (!voice_unit->buffer_list || num_frames > voice_unit->buffer_num_frames)
     {
-        if (dev->buffer_list) {
-            free(dev->buffer_list->mBuffers[0].mData);
-            free(dev->buffer_list);
+        if (voice_unit->buffer_list) {
+            free(voice_unit->buffer_list->mBuffers[0].mData);
+            free(voice_unit->buffer_list);
         }
         
-        dev->buffer_list =
+        voice_unit->buffer_list =
         (AudioBufferList*)malloc(sizeof(AudioBufferList) + sizeof(AudioBuffer));
-        dev->buffer_list->mNumberBuffers = 1;
-        dev->buffer_list->mBuffers[0].mNumberChannels = 1;
+        voice_unit->buffer_list->mNumberBuffers = 1;
+        voice_unit->buffer_list->mBuffers[0].mNumberChannels = 1;
         
-        dev->buffer_list->mBuffers[0].mDataByteSize = num_frames*sizeof(UInt16);
-        dev->buffer_list->mBuffers[0].mData = malloc(num_frames*sizeof(UInt16));
+        voice_unit->buffer_list->mBuffers[0].mDataByteSize = num_frames*sizeof(UInt16);
+        voice_unit->buffer_list->mBuffers[0].mData = malloc(num_frames*sizeof(UInt16));
         
-        dev->buffer_num_frames = num_frames;
-        dev->buffer_size = dev->buffer_list->mBuffers[0].mDataByteSize;
+        voice_unit->buffer_num_frames = num_frames;
+        voice_unit->buffer_size = voice_unit->buffer_list->mBuffers[0].mDataByteSize;
     }
+    AudioBufferList *buffer_list = voice_unit->buffer_list;
     
     OSStatus status;
-    status = AudioUnitRender(dev->recording_voice_unit,
+    status = AudioUnitRender(voice_unit->unit,
                              action_flags,
                              time_stamp,
                              1,
                              num_frames,
-                             dev->buffer_list);
+                             buffer_list);
     
     if (status != noErr) {
         CheckError(status, @"AudioUnitRender");
@@ -540,7 +910,7 @@ static OSStatus recording_cb(void *ref_con,
         //        int frame = 0;
         //        for (frame = 0; frame < num_frames; ++frame)
         //        {
-        //            int16_t* data = (int16_t*)dev->buffer_list->mBuffers[0].mData;
+        //            int16_t* data = (int16_t*)buffer_list->mBuffers[0].mData;
         //            Float32 sample = (Float32)sin (2 * M_PI * (j / cycleLength));
         //            (data)[frame] = (sample * 32767.0f);
         //            j += 1.0;
@@ -548,15 +918,22 @@ static OSStatus recording_cb(void *ref_con,
         //                j -= cycleLength;
         //        }
         //        startingFrameCount = j;
-        [dev->_audioBus writeCaptureData:dev->buffer_list->mBuffers[0].mData
-                         numberOfSamples:num_frames];
+        if (dev->_captureSwitch) {
+            otk_device_switch_capture(dev->_captureSwitch, voice_unit->slot,
+                                      buffer_list->mBuffers[0].mData, num_frames,
+                                      write_capture, (__bridge void *)dev);
+            if (otk_device_switch_get_state(dev->_captureSwitch) == OTK_DEVICE_SWITCH_RETIRED) {
+                // Coalesced until the safety queue gets to it.
+                dispatch_source_merge_data(dev->_captureSwitchDone, 1);
+            }
+        } else {
+            write_capture((__bridge void *)dev, buffer_list->mBuffers[0].mData, num_frames);
+        }
     }
     // some ocassions, AudioUnitRender only renders part of the buffer and then next
     // call to the AudioUnitRender fails with smaller buffer.
-    if (dev->buffer_size != dev->buffer_list->mBuffers[0].mDataByteSize)
-        dev->buffer_list->mBuffers[0].mDataByteSize = dev->buffer_size;
-    
-    update_recording_delay(dev);
+    if (voice_unit->buffer_size != buffer_list->mBuffers[0].mDataByteSize)
+        buffer_list->mBuffers[0].mDataByteSize = voice_unit->buffer_size;
     
     return noErr;
 }
@@ -571,11 +948,65 @@ static void update_playout_delay(OTDefaultAudioDeviceMac* device) {
             {
             	device->_playoutDelay = (device->_playoutDelay - 500) / 1000;
             }
+            if (device->_timeStretch) {
+                otk_time_stretch_stats stats;
+                otk_time_stretch_get_stats(device->_timeStretch, &stats);
+                device->_playoutDelay += (uint32_t)stats.buffered_ms;
+            }
             // Reset counter
             device->_playoutDelayMeasurementCounter = 0;
     }
 }
 
+// Reads audio to play from the SDK.
+static size_t read_playout(void *user_data, int16_t *samples, size_t frames)
+{
+    OTDefaultAudioDeviceMac *dev = (__bridge OTDefaultAudioDeviceMac*) user_data;
+    size_t count;
+    
+    if (dev->_timeStretch && frames <= kPlayoutStretchMaxFrames) {
+        // Read ahead of playback; short reads are covered by the stretch.
+        size_t wanted = otk_time_stretch_wanted(dev->_timeStretch, frames);
+        uint32_t received = 0;
+        if (wanted > 0) {
+            received = [dev->_audioBus readRenderData:otk_time_stretch_input(dev->_timeStretch)
+                                      numberOfSamples:(uint32_t)wanted];
+        }
+        otk_time_stretch_commit(dev->_timeStretch, wanted, received);
+        otk_time_stretch_read(dev->_timeStretch, samples, frames);
+        count = frames;
+    } else {
+        count =
+        [dev->_audioBus readRenderData:samples
+                       numberOfSamples:(uint32_t)frames];
+        
+        if (count != frames) {
+            //TODO: Not really an error, but conerning. Network issues?
+        }
+    }
+    
+    if (dev->_latencyProbe && otk_latency_probe_active(dev->_latencyProbe)) {
+        // The chirps replace the received audio while they play.
+        if (count < frames) {
+            memset(samples + count, 0, (frames - count) * sizeof(int16_t));
+            count = frames;
+        }
+        otk_latency_probe_render(dev->_latencyProbe, samples, frames, host_time_ns());
+    }
+    
+    if (dev->_syncMonitor) {
+        // The hand-off time stands in for the missing media timestamp;
+        // subscribers report frames the same way. Heard a render delay later.
+        int64_t now_ns = host_time_ns();
+        otk_av_sync_monitor_audio(dev->_syncMonitor, NULL, now_ns / 1000,
+                                  now_ns + (int64_t)dev->_playoutDelay * NSEC_PER_MSEC);
+    }
+    
+    update_playout_delay(dev);
+    
+    return count;
+}
+
 static OSStatus playout_cb(void *ref_con,
                            AudioUnitRenderActionFlags *action_flags,
                            const AudioTimeStamp *time_stamp,
@@ -583,26 +1014,20 @@ static OSStatus playout_cb(void *ref_con,
                            UInt32 num_frames,
                            AudioBufferList *buffer_list)
 {
-    OTDefaultAudioDeviceMac *dev = (__bridge OTDefaultAudioDeviceMac*) ref_con;
+    ot_voice_unit *voice_unit = (ot_voice_unit *) ref_con;
+    OTDefaultAudioDeviceMac *dev = voice_unit->device;
     
     if (!dev->playing) { return 0; }
     
-    uint32_t count =
-    [dev->_audioBus readRenderData:buffer_list->mBuffers[0].mData
-                   numberOfSamples:num_frames];
-    
-    if (count != num_frames) {
-        //TODO: Not really an error, but conerning. Network issues?
-    }
-    
-    update_playout_delay(dev);
+    read_playout((__bridge void *)dev, buffer_list->mBuffers[0].mData, num_frames);
     
     return 0;
 }
 
-- (BOOL)setupAudioUnit:(AudioUnit *)voice_unit playout:(BOOL)isPlayout;
+- (BOOL)setupAudioUnit:(ot_voice_unit *)voice_unit_ref playout:(BOOL)isPlayout;
 {
     OSStatus result;
+    AudioUnit *voice_unit = &voice_unit_ref->unit;
     
     mach_timebase_info(&info);
     
@@ -644,7 +1069,7 @@ static OSStatus playout_cb(void *ref_con,
                              &stream_format, sizeof (stream_format));
         AURenderCallbackStruct input_callback;
         input_callback.inputProc = recording_cb;
-        input_callback.inputProcRefCon = (__bridge void *)(self);
+        input_callback.inputProcRefCon = voice_unit_ref;
         
         AudioUnitSetProperty(*voice_unit,
                              kAudioOutputUnitProperty_SetInputCallback,
@@ -660,6 +1085,12 @@ static OSStatus playout_cb(void *ref_con,
         AudioUnitSetProperty(*voice_unit, kAudioOutputUnitProperty_EnableIO,
                              kAudioUnitScope_Output, kOutputBus, &enable_output,
                              sizeof(enable_output));
+        if (_voiceProcessingBypassed) {
+            UInt32 bypass = 1;
+            AudioUnitSetProperty(*voice_unit, kAUVoiceIOProperty_BypassVoiceProcessing,
+                                 kAudioUnitScope_Global, kInputBus, &bypass,
+                                 sizeof(bypass));
+        }
         
     } else
     {
@@ -708,7 +1139,7 @@ static OSStatus playout_cb(void *ref_con,
         ++failed_initalize_attempts;
         if (failed_initalize_attempts == kMaxInitalizeAttempts) {
             // Max number of initialization attempts exceeded, hence abort.
-            OT_AUDIO_DEBUG(@"AudioDevice - AudioUnit initialize failed %d",result);
+            OT_AUDIO_DEBUG("AudioDevice - AudioUnit initialize failed %d",result);
             return false;
         }
         [NSThread sleepForTimeInterval:0.1f];
@@ -724,9 +1155,10 @@ static OSStatus playout_cb(void *ref_con,
 
 - (BOOL)setPlayOutRenderCallback:(AudioUnit)unit
 {
+    ot_voice_unit *voice_unit = &playout_unit;
     AURenderCallbackStruct render_callback;
     render_callback.inputProc = playout_cb;;
-    render_callback.inputProcRefCon = (__bridge void *)(self);
+    render_callback.inputProcRefCon = voice_unit;
         OSStatus result = AudioUnitSetProperty(unit, kAudioUnitProperty_SetRenderCallback,
                                  kAudioUnitScope_Input, kOutputBus, &render_callback,
                                  sizeof(render_callback));
@@ -0,0 +1,326 @@
+//
+//  OTDeviceSwitch.cpp
+//  Custom-Audio-Driver
+//
+//  Copyright (c) 2026 Vonage. All rights reserved.
+//
+
+#include "OTDeviceSwitch.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <mutex>
+#include <vector>
+
+struct otk_device_switch {
+    uint32_t sample_rate;
+    size_t max_frames;
+    // Equal power gains, fade_in[i] for the new unit and
+    // fade_in[size - 1 - i] for the old one.
+    std::vector<float> fade_in;
+
+    // Single producer, single consumer ring carrying what the new unit
+    // captures during a switch to the callback writing to the SDK.
+    std::vector<int16_t> ring;
+    std::atomic<size_t> ring_read;
+    std::atomic<size_t> ring_write;
+
+    std::atomic<int> state;
+    std::atomic<int> active;
+    std::atomic<int> incoming;
+    // Held by the callback exchanging audio with the SDK.
+    std::atomic<bool> busy;
+
+    // Only touched with busy held, or while idle.
+    size_t fade_position;
+    std::vector<int16_t> scratch;
+
+    std::atomic<uint64_t> switch_frames;
+    std::atomic<int64_t> begin_ns;
+    std::atomic<int64_t> first_audio_ns;
+    std::atomic<int64_t> done_ns;
+
+    std::mutex lock;
+    otk_device_switch_stats stats;
+};
+
+static int64_t now_ns(void) {
+    return (int64_t)std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+static int16_t to_sample(float value) {
+    return (int16_t)std::lrint(std::min(std::max(value, -32768.0f), 32767.0f));
+}
+
+static size_t ring_push(otk_device_switch *device_switch, const int16_t *samples, size_t frames) {
+    const size_t capacity = device_switch->ring.size();
+    size_t write = device_switch->ring_write.load(std::memory_order_relaxed);
+    size_t read = device_switch->ring_read.load(std::memory_order_acquire);
+    frames = std::min(frames, capacity - (write - read));
+    for (size_t i = 0; i < frames; i++) {
+        device_switch->ring[(write + i) % capacity] = samples[i];
+    }
+    device_switch->ring_write.store(write + frames, std::memory_order_release);
+    return frames;
+}
+
+static size_t ring_pop(otk_device_switch *device_switch, int16_t *samples, size_t frames) {
+    const size_t capacity = device_switch->ring.size();
+    size_t read = device_switch->ring_read.load(std::memory_order_relaxed);
+    size_t write = device_switch->ring_write.load(std::memory_order_acquire);
+    frames = std::min(frames, write - read);
+    for (size_t i = 0; i < frames; i++) {
+        samples[i] = device_switch->ring[(read + i) % capacity];
+    }
+    device_switch->ring_read.store(read + frames, std::memory_order_release);
+    return frames;
+}
+
+// Try-lock on the SDK side; the audio threads never wait on each other.
+static bool take_sdk_side(otk_device_switch *device_switch) {
+    return !device_switch->busy.exchange(true, std::memory_order_acquire);
+}
+
+static void release_sdk_side(otk_device_switch *device_switch) {
+    device_switch->busy.store(false, std::memory_order_release);
+}
+
+// Frames handed to or taken from the SDK while switching, to work out how
+// many it missed.
+static void count_switch_frames(otk_device_switch *device_switch, size_t frames) {
+    device_switch->switch_frames.fetch_add(frames, std::memory_order_relaxed);
+}
+
+static void retire(otk_device_switch *device_switch) {
+    device_switch->done_ns.store(now_ns(), std::memory_order_relaxed);
+    device_switch->state.store(OTK_DEVICE_SWITCH_RETIRED, std::memory_order_release);
+}
+
+static void first_audio(otk_device_switch *device_switch) {
+    int expected = OTK_DEVICE_SWITCH_PENDING;
+    if (device_switch->state.compare_exchange_strong(expected, OTK_DEVICE_SWITCH_CROSSFADE,
+                                                     std::memory_order_acq_rel)) {
+        device_switch->first_audio_ns.store(now_ns(), std::memory_order_relaxed);
+    }
+}
+
+// Capture: the old unit keeps writing to the SDK during the crossfade and
+// mixes in what the new one captured, passed over the ring. The new unit
+// takes over once the fade is done, starting with what is left in the ring,
+// so the SDK gets one continuous stream. If the old unit stops delivering,
+// for example because its device was unplugged, the new one takes over as
+// soon as the ring holds a couple of callbacks.
+static void new_unit_capture(otk_device_switch *device_switch, const int16_t *samples, size_t frames,
+                             otk_device_switch_sink sink, void *user_data) {
+    first_audio(device_switch);
+    int state = device_switch->state.load(std::memory_order_acquire);
+    bool stalled = state == OTK_DEVICE_SWITCH_CROSSFADE &&
+        device_switch->ring_write.load(std::memory_order_relaxed) -
+        device_switch->ring_read.load(std::memory_order_acquire) >= 2 * device_switch->max_frames;
+    if ((state != OTK_DEVICE_SWITCH_RETIRED && !stalled) || !take_sdk_side(device_switch)) {
+        ring_push(device_switch, samples, frames);
+        return;
+    }
+    if (device_switch->state.load(std::memory_order_acquire) == OTK_DEVICE_SWITCH_CROSSFADE) {
+        retire(device_switch);
+    }
+    int16_t *pending = device_switch->scratch.data();
+    size_t count;
+    while ((count = ring_pop(device_switch, pending, device_switch->max_frames)) > 0) {
+        sink(user_data, pending, count);
+        count_switch_frames(device_switch, count);
+    }
+    sink(user_data, samples, frames);
+    release_sdk_side(device_switch);
+}
+
+static void old_unit_capture(otk_device_switch *device_switch, const int16_t *samples, size_t frames,
+                             otk_device_switch_sink sink, void *user_data) {
+    if (!take_sdk_side(device_switch)) {
+        return;
+    }
+    int state = device_switch->state.load(std::memory_order_acquire);
+    if (state == OTK_DEVICE_SWITCH_PENDING) {
+        sink(user_data, samples, frames);
+        count_switch_frames(device_switch, frames);
+    } else if (state == OTK_DEVICE_SWITCH_CROSSFADE) {
+        const size_t fade = device_switch->fade_in.size();
+        int16_t *mixed = device_switch->scratch.data();
+        size_t captured = ring_pop(device_switch, mixed, frames);
+        if (captured == 0 && device_switch->fade_position == 0) {
+            // The new unit has nothing queued yet; the old audio goes on
+            // unfaded until it does.
+            sink(user_data, samples, frames);
+            count_switch_frames(device_switch, frames);
+        } else {
+            // The block ends where the new unit's audio does. Going on with
+            // the old unit alone would jump back to its full level, or past
+            // the fade to nothing at all; the rest of the new unit's audio
+            // comes with the next callback.
+            for (size_t i = 0; i < captured && device_switch->fade_position < fade; i++) {
+                size_t position = device_switch->fade_position++;
+                mixed[i] = to_sample(mixed[i] * device_switch->fade_in[position] +
+                                     samples[i] * device_switch->fade_in[fade - 1 - position]);
+            }
+            if (captured > 0) {
+                sink(user_data, mixed, captured);
+                count_switch_frames(device_switch, captured);
+            }
+        }
+        if (device_switch->fade_position >= fade) {
+            retire(device_switch);
+        }
+    }
+    release_sdk_side(device_switch);
+}
+
+static void capture_chunk(otk_device_switch *device_switch, int slot,
+                          const int16_t *samples, size_t frames,
+                          otk_device_switch_sink sink, void *user_data) {
+    int state = device_switch->state.load(std::memory_order_acquire);
+    if (state == OTK_DEVICE_SWITCH_IDLE) {
+        if (slot == device_switch->active.load(std::memory_order_relaxed) && take_sdk_side(device_switch)) {
+            sink(user_data, samples, frames);
+            release_sdk_side(device_switch);
+        }
+    } else if (slot == device_switch->incoming.load(std::memory_order_relaxed)) {
+        new_unit_capture(device_switch, samples, frames, sink, user_data);
+    } else if (state != OTK_DEVICE_SWITCH_RETIRED) {
+        old_unit_capture(device_switch, samples, frames, sink, user_data);
+    }
+}
+
+otk_device_switch *otk_device_switch_new(uint32_t sample_rate, uint32_t max_frames, double crossfade_ms) {
+    if (sample_rate == 0 || max_frames == 0) {
+        return nullptr;
+    }
+    otk_device_switch *device_switch = new otk_device_switch();
+    device_switch->sample_rate = sample_rate;
+    device_switch->max_frames = max_frames;
+    size_t fade = std::max<size_t>(1, (size_t)std::lround(crossfade_ms * sample_rate / 1000));
+    device_switch->fade_in.resize(fade);
+    for (size_t i = 0; i < fade; i++) {
+        device_switch->fade_in[i] = (float)std::sin(M_PI / 2 * (i + 0.5) / fade);
+    }
+    device_switch->ring.resize(4 * (size_t)max_frames + fade);
+    device_switch->ring_read.store(0);
+    device_switch->ring_write.store(0);
+    device_switch->state.store(OTK_DEVICE_SWITCH_IDLE);
+    device_switch->active.store(0);
+    device_switch->incoming.store(-1);
+    device_switch->busy.store(false);
+    device_switch->fade_position = 0;
+    device_switch->scratch.resize(max_frames);
+    device_switch->switch_frames.store(0);
+    device_switch->begin_ns.store(0);
+    device_switch->first_audio_ns.store(0);
+    device_switch->done_ns.store(0);
+    device_switch->stats = otk_device_switch_stats();
+    return device_switch;
+}
+
+void otk_device_switch_delete(otk_device_switch *device_switch) {
+    delete device_switch;
+}
+
+void otk_device_switch_capture(otk_device_switch *device_switch, int slot,
+                               const int16_t *samples, size_t frames,
+                               otk_device_switch_sink sink, void *user_data) {
+    if (device_switch == nullptr || samples == nullptr || sink == nullptr) {
+        return;
+    }
+    for (size_t done = 0; done < frames; done += device_switch->max_frames) {
+        capture_chunk(device_switch, slot, samples + done,
+                      std::min(frames - done, device_switch->max_frames), sink, user_data);
+    }
+}
+
+int otk_device_switch_begin(otk_device_switch *device_switch) {
+    if (device_switch == nullptr ||
+        device_switch->state.load(std::memory_order_acquire) != OTK_DEVICE_SWITCH_IDLE) {
+        return -1;
+    }
+    // Nothing uses the ring while idle: the old unit of the last switch
+    // was stopped before it was finished.
+    device_switch->ring_read.store(0, std::memory_order_relaxed);
+    device_switch->ring_write.store(0, std::memory_order_relaxed);
+    device_switch->switch_frames.store(0, std::memory_order_relaxed);
+    device_switch->begin_ns.store(now_ns(), std::memory_order_relaxed);
+    device_switch->first_audio_ns.store(0, std::memory_order_relaxed);
+    device_switch->done_ns.store(0, std::memory_order_relaxed);
+    device_switch->fade_position = 0;
+    int incoming = 1 - device_switch->active.load(std::memory_order_relaxed);
+    device_switch->incoming.store(incoming, std::memory_order_relaxed);
+    device_switch->state.store(OTK_DEVICE_SWITCH_PENDING, std::memory_order_release);
+    return incoming;
+}
+
+int otk_device_switch_cancel(otk_device_switch *device_switch) {
+    if (device_switch == nullptr) {
+        return 0;
+    }
+    int expected = OTK_DEVICE_SWITCH_PENDING;
+    if (!device_switch->state.compare_exchange_strong(expected, OTK_DEVICE_SWITCH_IDLE,
+                                                      std::memory_order_acq_rel)) {
+        return 0;
+    }
+    std::lock_guard<std::mutex> guard(device_switch->lock);
+    device_switch->stats.cancelled++;
+    return 1;
+}
+
+int otk_device_switch_finish(otk_device_switch *device_switch) {
+    if (device_switch == nullptr ||
+        device_switch->state.load(std::memory_order_acquire) != OTK_DEVICE_SWITCH_RETIRED) {
+        return 0;
+    }
+    int64_t begin = device_switch->begin_ns.load(std::memory_order_relaxed);
+    int64_t first_audio = device_switch->first_audio_ns.load(std::memory_order_relaxed);
+    int64_t done = device_switch->done_ns.load(std::memory_order_relaxed);
+    uint64_t expected = (uint64_t)((double)(done - begin) * device_switch->sample_rate / 1e9);
+    uint64_t delivered = device_switch->switch_frames.load(std::memory_order_relaxed);
+    {
+        std::lock_guard<std::mutex> guard(device_switch->lock);
+        otk_device_switch_stats &stats = device_switch->stats;
+        stats.switches++;
+        stats.last_first_audio_ms = (double)(first_audio - begin) / 1e6;
+        stats.last_switch_ms = (double)(done - begin) / 1e6;
+        stats.last_dropped_frames = expected > delivered ? expected - delivered : 0;
+        stats.dropped_frames += stats.last_dropped_frames;
+    }
+    // incoming keeps naming the new slot, so a callback that still sees the
+    // switch as retired keeps treating it as the SDK side.
+    device_switch->active.store(device_switch->incoming.load(std::memory_order_relaxed), std::memory_order_relaxed);
+    device_switch->state.store(OTK_DEVICE_SWITCH_IDLE, std::memory_order_release);
+    return 1;
+}
+
+void otk_device_switch_reset(otk_device_switch *device_switch) {
+    if (device_switch == nullptr) {
+        return;
+    }
+    device_switch->busy.store(false, std::memory_order_relaxed);
+    device_switch->state.store(OTK_DEVICE_SWITCH_IDLE, std::memory_order_release);
+}
+
+otk_device_switch_state otk_device_switch_get_state(otk_device_switch *device_switch) {
+    if (device_switch == nullptr) {
+        return OTK_DEVICE_SWITCH_IDLE;
+    }
+    return (otk_device_switch_state)device_switch->state.load(std::memory_order_acquire);
+}
+
+int otk_device_switch_active_slot(otk_device_switch *device_switch) {
+    return device_switch != nullptr ? device_switch->active.load(std::memory_order_relaxed) : 0;
+}
+
+void otk_device_switch_get_stats(otk_device_switch *device_switch, otk_device_switch_stats *stats) {
+    if (device_switch == nullptr || stats == nullptr) {
+        return;
+    }
+    std::lock_guard<std::mutex> guard(device_switch->lock);
+    *stats = device_switch->stats;
+}
@@ -0,0 +1,110 @@
+//
+//  OTDeviceSwitch.h
+//  Custom-Audio-Driver
+//
+//  Copyright (c) 2026 Vonage. All rights reserved.
+//
+
+#ifndef OTDeviceSwitch_h
+#define OTDeviceSwitch_h
+
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * Hands capture over from one device unit to another without stopping it.
+ *
+ * The two units live in slots 0 and 1 and pass their slot with every
+ * callback. Only the active slot exchanges audio with the SDK. A switch
+ * goes through these states:
+ *
+ * - PENDING: the new unit has been started and the old one keeps running.
+ * - CROSSFADE: the new unit delivered its first callback and now exchanges
+ *   audio with the SDK; the old one is faded out and the new one faded in,
+ *   with equal power, over a few milliseconds.
+ * - RETIRED: the fade is over and the old unit only gets silence. It can
+ *   be stopped and disposed, then the switch is finished.
+ *
+ * The audio callbacks never lock or allocate: the role of SDK reader or
+ * writer is handed over with a try-lock, and a callback that loses the
+ * race stays silent once. The control functions are meant for a single
+ * control thread.
+ */
+typedef struct otk_device_switch otk_device_switch;
+
+typedef enum otk_device_switch_state {
+    OTK_DEVICE_SWITCH_IDLE = 0,
+    OTK_DEVICE_SWITCH_PENDING = 1,
+    OTK_DEVICE_SWITCH_CROSSFADE = 2,
+    OTK_DEVICE_SWITCH_RETIRED = 3,
+} otk_device_switch_state;
+
+typedef struct otk_device_switch_stats {
+    uint64_t switches;
+    /** Switches given up because the new unit never delivered. */
+    uint64_t cancelled;
+    /** From the start of the last switch to the new unit's first callback. */
+    double last_first_audio_ms;
+    /** From the start of the last switch to the end of the crossfade. */
+    double last_switch_ms;
+    /**
+     * Frames the SDK missed during the last switch, measured against the
+     * wall clock, so accurate to about a callback.
+     */
+    uint64_t last_dropped_frames;
+    uint64_t dropped_frames;
+} otk_device_switch_stats;
+
+/** Called with captured audio for the SDK. */
+typedef void (*otk_device_switch_sink)(void *user_data, const int16_t *samples, size_t frames);
+
+/** Mono 16 bit. Slot 0 starts out active. */
+otk_device_switch *otk_device_switch_new(uint32_t sample_rate, uint32_t max_frames, double crossfade_ms);
+
+void otk_device_switch_delete(otk_device_switch *device_switch);
+
+/** Capture callback of the unit in slot. */
+void otk_device_switch_capture(otk_device_switch *device_switch, int slot,
+                               const int16_t *samples, size_t frames,
+                               otk_device_switch_sink sink, void *user_data);
+
+/**
+ * Starts a switch. Returns the slot to start the new unit in, or -1 while
+ * another switch is in progress.
+ */
+int otk_device_switch_begin(otk_device_switch *device_switch);
+
+/**
+ * Gives up a switch whose new unit has not delivered yet. Returns 1 if the
+ * new unit can be disposed, 0 if it started delivering in the meantime.
+ */
+int otk_device_switch_cancel(otk_device_switch *device_switch);
+
+/**
+ * Completes a retired switch once the old unit is stopped, making the new
+ * slot the active one. Returns 0 if the switch is not retired yet.
+ */
+int otk_device_switch_finish(otk_device_switch *device_switch);
+
+/**
+ * Drops a switch that has not retired, keeping the old slot active. Only
+ * with both units stopped, for example when capture is stopped in the
+ * middle of a switch.
+ */
+void otk_device_switch_reset(otk_device_switch *device_switch);
+
+otk_device_switch_state otk_device_switch_get_state(otk_device_switch *device_switch);
+
+int otk_device_switch_active_slot(otk_device_switch *device_switch);
+
+void otk_device_switch_get_stats(otk_device_switch *device_switch, otk_device_switch_stats *stats);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* OTDeviceSwitch_h */
@@ -0,0 +1,473 @@
+//
+//  OTLatencyProbe.cpp
+//  Custom-Audio-Driver
+//
+//  Copyright (c) 2026 Vonage. All rights reserved.
+//
+
+#include "OTLatencyProbe.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <complex>
+#include <mutex>
+#include <vector>
+
+// Linear chirp over most of the voice band, faded in and out over the
+// first and last tenth so it starts and stops without clicks.
+static const double kChirpMs = 100;
+static const double kChirpStartHz = 300;
+static const double kChirpEndHz = 6000;
+static const double kChirpTaper = 0.1;
+static const float kChirpLevel = 0.25f;
+// One chirp per interval; the echo window of one chirp ends before the next.
+static const double kIntervalMs = 1000;
+// Before the first chirp, so there is captured audio to search before it.
+static const double kLeadInMs = 200;
+// Where the captured chirp is looked for, relative to when it was played.
+static const double kSearchBeforeMs = 20;
+static const double kMaxRoundTripMs = 600;
+// Captured audio kept for analysis.
+static const double kHistoryMs = 3000;
+// A chirp buried in noise peaks at a few times the RMS; a clean one at
+// tens of times.
+static const double kMinConfidence = 8;
+
+static const size_t kMaxPendingChirps = 8;
+
+typedef std::complex<float> complex_t;
+
+namespace {
+
+// Iterative radix-2 FFT of one size.
+struct fft_plan {
+    size_t size = 0;
+    std::vector<complex_t> twiddles;
+    std::vector<uint32_t> reversed;
+
+    explicit fft_plan(size_t n) : size(n), twiddles(n / 2), reversed(n) {
+        for (size_t i = 0; i < n / 2; i++) {
+            twiddles[i] = std::polar(1.0f, (float)(-2 * M_PI * i / n));
+        }
+        int bits = 0;
+        while (((size_t)1 << bits) < n) {
+            bits++;
+        }
+        for (size_t i = 0; i < n; i++) {
+            uint32_t r = 0;
+            for (int b = 0; b < bits; b++) {
+                r |= (uint32_t)((i >> b) & 1) << (bits - 1 - b);
+            }
+            reversed[i] = r;
+        }
+    }
+
+    void run(complex_t *data, bool inverse) const {
+        for (size_t i = 0; i < size; i++) {
+            if (i < reversed[i]) {
+                std::swap(data[i], data[reversed[i]]);
+            }
+        }
+        for (size_t length = 2; length <= size; length <<= 1) {
+            size_t half = length / 2;
+            size_t step = size / length;
+            for (size_t start = 0; start < size; start += length) {
+                for (size_t k = 0; k < half; k++) {
+                    complex_t w = twiddles[k * step];
+                    if (inverse) {
+                        w = std::conj(w);
+                    }
+                    complex_t odd = data[start + k + half] * w;
+                    data[start + k + half] = data[start + k] - odd;
+                    data[start + k] += odd;
+                }
+            }
+        }
+        if (inverse) {
+            float scale = 1.0f / (float)size;
+            for (size_t i = 0; i < size; i++) {
+                data[i] *= scale;
+            }
+        }
+    }
+};
+
+}
+
+static size_t fft_size_for(size_t length) {
+    size_t n = 2;
+    while (n < length) {
+        n <<= 1;
+    }
+    return n;
+}
+
+// Conjugated spectrum of the reference, ready to multiply with a signal's.
+static void reference_spectrum(const fft_plan &plan, const float *reference, size_t length,
+                               std::vector<complex_t> &spectrum) {
+    spectrum.assign(plan.size, complex_t(0, 0));
+    for (size_t i = 0; i < length && i < plan.size; i++) {
+        spectrum[i] = complex_t(reference[i], 0);
+    }
+    plan.run(spectrum.data(), false);
+    for (complex_t &value : spectrum) {
+        value = std::conj(value);
+    }
+}
+
+// Envelope of the cross-correlation: keeping only positive frequencies
+// gives the analytic signal, whose magnitude peaks at the delay without
+// the ripple of the chirp's carrier, even if the path shifts its phase.
+static int correlate(const fft_plan &plan, const std::vector<complex_t> &reference,
+                     size_t reference_length, const float *signal, size_t length,
+                     std::vector<complex_t> &work, double min_confidence,
+                     double *offset, double *confidence) {
+    const size_t n = plan.size;
+    if (length < reference_length || length > n) {
+        return 0;
+    }
+    std::fill(work.begin(), work.end(), complex_t(0, 0));
+    for (size_t i = 0; i < length; i++) {
+        work[i] = complex_t(signal[i], 0);
+    }
+    plan.run(work.data(), false);
+    work[0] *= reference[0];
+    work[n / 2] *= reference[n / 2];
+    for (size_t k = 1; k < n / 2; k++) {
+        work[k] *= 2.0f * reference[k];
+        work[n - k] = complex_t(0, 0);
+    }
+    plan.run(work.data(), true);
+
+    const size_t lags = length - reference_length + 1;
+    size_t best = 0;
+    double best_value = -1;
+    double total = 0;
+    for (size_t k = 0; k < lags; k++) {
+        double value = std::abs(work[k]);
+        total += value * value;
+        if (value > best_value) {
+            best_value = value;
+            best = k;
+        }
+    }
+    double rms = std::sqrt(total / (double)lags);
+    double ratio = rms > 0 ? best_value / rms : 0;
+    if (confidence != nullptr) {
+        *confidence = ratio;
+    }
+    if (ratio < min_confidence) {
+        return 0;
+    }
+    double fraction = 0;
+    if (best > 0 && best + 1 < lags) {
+        double before = std::abs(work[best - 1]);
+        double after = std::abs(work[best + 1]);
+        double curvature = before - 2 * best_value + after;
+        if (curvature < 0) {
+            fraction = 0.5 * (before - after) / curvature;
+        }
+    }
+    *offset = (double)best + fraction;
+    return 1;
+}
+
+struct otk_latency_probe {
+    uint32_t sample_rate;
+    std::vector<float> chirp;
+    size_t interval;
+    size_t search_before;
+    size_t window;
+
+    // Playout thread. Each start() bumps the generation.
+    std::atomic<uint32_t> to_play;
+    std::atomic<uint32_t> generation;
+    uint32_t render_generation;
+    size_t lead_in;
+    size_t chirp_position;
+    size_t until_next;
+    std::atomic<int64_t> played_at_ns[kMaxPendingChirps];
+    std::atomic<uint64_t> played;
+
+    // Capture thread. The anchor maps the captured stream to time and is
+    // published with a sequence count so it is read consistently.
+    std::vector<float> history;
+    std::atomic<uint64_t> captured;
+    std::atomic<uint32_t> anchor_sequence;
+    std::atomic<uint64_t> anchor_index;
+    std::atomic<int64_t> anchor_ns;
+
+    // Analysis thread.
+    fft_plan plan;
+    std::vector<complex_t> chirp_spectrum;
+    std::vector<complex_t> work;
+    std::vector<float> segment;
+    std::atomic<uint64_t> analyzed;
+
+    std::mutex lock;
+    otk_latency_stats stats;
+    double sum_squares;
+
+    explicit otk_latency_probe(size_t fft_size) : plan(fft_size) {}
+};
+
+static size_t ms_to_frames(double ms, uint32_t sample_rate) {
+    return (size_t)std::lround(ms * sample_rate / 1000);
+}
+
+otk_latency_probe *otk_latency_probe_new(uint32_t sample_rate) {
+    if (sample_rate == 0) {
+        return nullptr;
+    }
+    size_t chirp_length = ms_to_frames(kChirpMs, sample_rate);
+    size_t search_before = ms_to_frames(kSearchBeforeMs, sample_rate);
+    size_t window = search_before + ms_to_frames(kMaxRoundTripMs, sample_rate) + chirp_length;
+    otk_latency_probe *probe = new otk_latency_probe(fft_size_for(window));
+    probe->sample_rate = sample_rate;
+    probe->search_before = search_before;
+    probe->window = window;
+    probe->interval = std::max(window, ms_to_frames(kIntervalMs, sample_rate));
+
+    probe->chirp.resize(chirp_length);
+    double duration = (double)chirp_length / sample_rate;
+    double sweep = (kChirpEndHz - kChirpStartHz) / duration;
+    size_t taper = std::max<size_t>(1, (size_t)(chirp_length * kChirpTaper));
+    for (size_t i = 0; i < chirp_length; i++) {
+        double t = (double)i / sample_rate;
+        double gain = 1;
+        size_t edge = std::min(i, chirp_length - 1 - i);
+        if (edge < taper) {
+            gain = 0.5 - 0.5 * std::cos(M_PI * edge / taper);
+        }
+        probe->chirp[i] = (float)(kChirpLevel * gain * std::sin(2 * M_PI * (kChirpStartHz * t + 0.5 * sweep * t * t)));
+    }
+    reference_spectrum(probe->plan, probe->chirp.data(), chirp_length, probe->chirp_spectrum);
+    probe->work.resize(probe->plan.size);
+    probe->segment.resize(window);
+
+    probe->to_play.store(0);
+    probe->generation.store(0);
+    probe->render_generation = 0;
+    probe->lead_in = ms_to_frames(kLeadInMs, sample_rate);
+    probe->chirp_position = chirp_length;
+    probe->until_next = 0;
+    for (size_t i = 0; i < kMaxPendingChirps; i++) {
+        probe->played_at_ns[i].store(0);
+    }
+    probe->played.store(0);
+    probe->history.resize(std::max(2 * window, ms_to_frames(kHistoryMs, sample_rate)));
+    probe->captured.store(0);
+    probe->anchor_sequence.store(0);
+    probe->anchor_index.store(0);
+    probe->anchor_ns.store(0);
+    probe->analyzed.store(0);
+    probe->stats = otk_latency_stats();
+    probe->sum_squares = 0;
+    return probe;
+}
+
+void otk_latency_probe_delete(otk_latency_probe *probe) {
+    delete probe;
+}
+
+void otk_latency_probe_start(otk_latency_probe *probe, uint32_t count) {
+    if (probe == nullptr) {
+        return;
+    }
+    {
+        std::lock_guard<std::mutex> guard(probe->lock);
+        probe->stats = otk_latency_stats();
+        probe->sum_squares = 0;
+    }
+    probe->analyzed.store(probe->played.load(std::memory_order_acquire), std::memory_order_relaxed);
+    probe->generation.fetch_add(1, std::memory_order_relaxed);
+    probe->to_play.store(count, std::memory_order_release);
+}
+
+void otk_latency_probe_stop(otk_latency_probe *probe) {
+    if (probe == nullptr) {
+        return;
+    }
+    probe->to_play.store(0, std::memory_order_release);
+    probe->analyzed.store(probe->played.load(std::memory_order_acquire), std::memory_order_relaxed);
+}
+
+int otk_latency_probe_active(otk_latency_probe *probe) {
+    if (probe == nullptr) {
+        return 0;
+    }
+    return probe->to_play.load(std::memory_order_acquire) > 0 ||
+        probe->analyzed.load(std::memory_order_relaxed) < probe->played.load(std::memory_order_acquire);
+}
+
+void otk_latency_probe_render(otk_latency_probe *probe, int16_t *samples, size_t frames, int64_t time_ns) {
+    if (probe == nullptr || samples == nullptr) {
+        return;
+    }
+    const size_t chirp_length = probe->chirp.size();
+    uint32_t generation = probe->generation.load(std::memory_order_acquire);
+    if (generation != probe->render_generation) {
+        probe->render_generation = generation;
+        probe->until_next = probe->lead_in;
+    }
+    size_t i = 0;
+    while (i < frames) {
+        if (probe->chirp_position < chirp_length) {
+            size_t count = std::min(frames - i, chirp_length - probe->chirp_position);
+            for (size_t k = 0; k < count; k++) {
+                samples[i + k] = (int16_t)std::lrint(probe->chirp[probe->chirp_position + k] * 32767.0f);
+            }
+            probe->chirp_position += count;
+            i += count;
+            continue;
+        }
+        uint32_t left = probe->to_play.load(std::memory_order_acquire);
+        if (left == 0) {
+            break;
+        }
+        if (probe->until_next > 0) {
+            size_t count = std::min(frames - i, probe->until_next);
+            probe->until_next -= count;
+            i += count;
+            continue;
+        }
+        // stop() may have cleared it in the meantime.
+        if (!probe->to_play.compare_exchange_strong(left, left - 1, std::memory_order_acq_rel)) {
+            continue;
+        }
+        uint64_t index = probe->played.load(std::memory_order_relaxed);
+        probe->played_at_ns[index % kMaxPendingChirps].store(
+            time_ns + (int64_t)((double)i * 1e9 / probe->sample_rate), std::memory_order_relaxed);
+        probe->played.store(index + 1, std::memory_order_release);
+        probe->chirp_position = 0;
+        probe->until_next = probe->interval - chirp_length;
+    }
+}
+
+void otk_latency_probe_capture(otk_latency_probe *probe, const int16_t *samples, size_t frames, int64_t time_ns) {
+    if (probe == nullptr || samples == nullptr) {
+        return;
+    }
+    uint64_t index = probe->captured.load(std::memory_order_relaxed);
+    uint32_t sequence = probe->anchor_sequence.load(std::memory_order_relaxed);
+    probe->anchor_sequence.store(sequence + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    probe->anchor_index.store(index, std::memory_order_relaxed);
+    probe->anchor_ns.store(time_ns, std::memory_order_relaxed);
+    probe->anchor_sequence.store(sequence + 2, std::memory_order_release);
+
+    const size_t size = probe->history.size();
+    for (size_t i = 0; i < frames; i++) {
+        probe->history[(index + i) % size] = samples[i] / 32768.0f;
+    }
+    probe->captured.store(index + frames, std::memory_order_release);
+}
+
+static void read_anchor(otk_latency_probe *probe, uint64_t *index, int64_t *time_ns) {
+    uint32_t before, after;
+    do {
+        before = probe->anchor_sequence.load(std::memory_order_acquire);
+        *index = probe->anchor_index.load(std::memory_order_relaxed);
+        *time_ns = probe->anchor_ns.load(std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_acquire);
+        after = probe->anchor_sequence.load(std::memory_order_relaxed);
+    } while (before != after || (before & 1));
+}
+
+static void record(otk_latency_probe *probe, int found, double latency_ms, double confidence) {
+    std::lock_guard<std::mutex> guard(probe->lock);
+    otk_latency_stats &stats = probe->stats;
+    stats.last_confidence = confidence;
+    if (!found) {
+        stats.failures++;
+        return;
+    }
+    stats.measurements++;
+    stats.last_ms = latency_ms;
+    if (stats.measurements == 1) {
+        stats.min_ms = stats.max_ms = latency_ms;
+    }
+    stats.min_ms = std::min(stats.min_ms, latency_ms);
+    stats.max_ms = std::max(stats.max_ms, latency_ms);
+    double delta = latency_ms - stats.mean_ms;
+    stats.mean_ms += delta / stats.measurements;
+    probe->sum_squares += delta * (latency_ms - stats.mean_ms);
+    stats.stddev_ms = stats.measurements > 1 ? std::sqrt(probe->sum_squares / (stats.measurements - 1)) : 0;
+}
+
+int otk_latency_probe_analyze(otk_latency_probe *probe) {
+    if (probe == nullptr) {
+        return 0;
+    }
+    int done = 0;
+    const double rate = probe->sample_rate;
+    const size_t size = probe->history.size();
+    for (;;) {
+        uint64_t next = probe->analyzed.load(std::memory_order_relaxed);
+        uint64_t played = probe->played.load(std::memory_order_acquire);
+        if (next >= played) {
+            break;
+        }
+        if (played - next > kMaxPendingChirps) {
+            // Not analyzed in time; the play times were overwritten.
+            record(probe, 0, 0, 0);
+            probe->analyzed.store(next + 1, std::memory_order_relaxed);
+            continue;
+        }
+        int64_t played_at = probe->played_at_ns[next % kMaxPendingChirps].load(std::memory_order_relaxed);
+        uint64_t anchor_index;
+        int64_t anchor_ns;
+        read_anchor(probe, &anchor_index, &anchor_ns);
+        if (anchor_ns == 0) {
+            break;
+        }
+        double played_index = (double)anchor_index + (double)(played_at - anchor_ns) * rate / 1e9;
+        double start = std::floor(played_index) - (double)probe->search_before;
+        uint64_t captured = probe->captured.load(std::memory_order_acquire);
+        if (start + (double)probe->window > (double)captured) {
+            break;
+        }
+        bool lost = start < 0 || start < (double)captured - (double)size;
+        if (!lost) {
+            uint64_t first = (uint64_t)start;
+            for (size_t i = 0; i < probe->window; i++) {
+                probe->segment[i] = probe->history[(first + i) % size];
+            }
+            // Overwritten while copying?
+            lost = probe->captured.load(std::memory_order_acquire) - first > size;
+        }
+        double offset = 0, confidence = 0;
+        int found = !lost && correlate(probe->plan, probe->chirp_spectrum, probe->chirp.size(),
+                                       probe->segment.data(), probe->window, probe->work,
+                                       kMinConfidence, &offset, &confidence);
+        double latency_ms = (start + offset - played_index) * 1000.0 / rate;
+        record(probe, found, latency_ms, confidence);
+        probe->analyzed.store(next + 1, std::memory_order_relaxed);
+        done++;
+    }
+    return done;
+}
+
+void otk_latency_probe_get_stats(otk_latency_probe *probe, otk_latency_stats *stats) {
+    if (probe == nullptr || stats == nullptr) {
+        return;
+    }
+    std::lock_guard<std::mutex> guard(probe->lock);
+    *stats = probe->stats;
+}
+
+int otk_latency_find(const float *signal, size_t length,
+                     const float *reference, size_t reference_length,
+                     double min_confidence, double *offset, double *confidence) {
+    if (signal == nullptr || reference == nullptr || offset == nullptr ||
+        reference_length == 0 || length < reference_length) {
+        return 0;
+    }
+    fft_plan plan(fft_size_for(length));
+    std::vector<complex_t> spectrum;
+    reference_spectrum(plan, reference, reference_length, spectrum);
+    std::vector<complex_t> work(plan.size);
+    return correlate(plan, spectrum, reference_length, signal, length, work,
+                     min_confidence, offset, confidence);
+}
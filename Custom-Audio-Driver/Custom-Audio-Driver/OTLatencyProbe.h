@@ -0,0 +1,91 @@
+//
+//  OTLatencyProbe.h
+//  Custom-Audio-Driver
+//
+//  Copyright (c) 2026 Vonage. All rights reserved.
+//
+
+#ifndef OTLatencyProbe_h
+#define OTLatencyProbe_h
+
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * Measures the audio round trip of a device by playing a chirp and finding
+ * it in the captured audio.
+ *
+ * While a measurement runs, the playout callback replaces what it plays
+ * with a windowed linear chirp once per interval, and the capture callback
+ * keeps the last few seconds of audio. Both pass the time of their first
+ * sample on the same clock. Analysis runs off the audio threads: it cross
+ * correlates the captured audio with the chirp by FFT and takes the peak,
+ * interpolated to a fraction of a sample, as the chirp's arrival. The
+ * round trip is the time between playing and capturing the chirp's start,
+ * which with callback times is what the SDK sees between writing audio and
+ * getting it back.
+ *
+ * Mono 16 bit. The audio callbacks do not allocate, lock or block.
+ */
+typedef struct otk_latency_probe otk_latency_probe;
+
+typedef struct otk_latency_stats {
+    uint32_t measurements;
+    /** Chirps not found with enough confidence. */
+    uint32_t failures;
+    double last_ms;
+    double mean_ms;
+    /** Spread of the measurements, how stable the round trip is. */
+    double stddev_ms;
+    double min_ms;
+    double max_ms;
+    /** Correlation peak over its RMS for the last chirp found or missed. */
+    double last_confidence;
+} otk_latency_stats;
+
+otk_latency_probe *otk_latency_probe_new(uint32_t sample_rate);
+
+void otk_latency_probe_delete(otk_latency_probe *probe);
+
+/** Plays count chirps, one per interval, and clears the statistics. */
+void otk_latency_probe_start(otk_latency_probe *probe, uint32_t count);
+
+/** Stops playing chirps and drops the ones not analyzed yet. */
+void otk_latency_probe_stop(otk_latency_probe *probe);
+
+/** 1 while chirps are left to play or analyze. */
+int otk_latency_probe_active(otk_latency_probe *probe);
+
+/** Playout callback; time_ns is when the first sample is handed over. */
+void otk_latency_probe_render(otk_latency_probe *probe, int16_t *samples, size_t frames, int64_t time_ns);
+
+/** Capture callback; time_ns is when the first sample was captured. */
+void otk_latency_probe_capture(otk_latency_probe *probe, const int16_t *samples, size_t frames, int64_t time_ns);
+
+/**
+ * Looks for chirps whose echo window has been captured. Allocation free but
+ * too slow for an audio thread; call it periodically from another thread.
+ * Returns the number of chirps analyzed.
+ */
+int otk_latency_probe_analyze(otk_latency_probe *probe);
+
+void otk_latency_probe_get_stats(otk_latency_probe *probe, otk_latency_stats *stats);
+
+/**
+ * Finds where reference starts in signal by FFT cross-correlation. Returns
+ * 1 and the offset in samples, with a fraction, if the correlation peak is
+ * at least min_confidence times its RMS. confidence may be NULL.
+ */
+int otk_latency_find(const float *signal, size_t length,
+                     const float *reference, size_t reference_length,
+                     double min_confidence, double *offset, double *confidence);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* OTLatencyProbe_h */
@@ -0,0 +1,367 @@
+//
+//  OTTimeStretch.cpp
+//  Custom-Audio-Driver
+//
+//  Copyright (c) 2026 Vonage. All rights reserved.
+//
+
+#include "OTTimeStretch.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <cstring>
+#include <vector>
+
+#if defined(__ARM_NEON) || defined(__ARM_NEON__)
+#include <arm_neon.h>
+#define OTK_STRETCH_NEON 1
+#elif defined(__SSE2__)
+#include <emmintrin.h>
+#define OTK_STRETCH_SSE2 1
+#endif
+
+// WSOLA segments: each one starts with an overlap crossfaded into the end
+// of the previous one, and may move up to the seek window to line up with
+// it. Speech pitch periods go up to about 12 ms, so the window covers one.
+static const double kOverlapMs = 5;
+static const double kSequenceMs = 15;
+static const double kSeekMs = 12;
+
+// Playback starts, and restarts after running dry, once this much is
+// buffered.
+static const double kFillMs = 40;
+// Below this, playback slows down, down to kMinRatio when only one
+// segment is left.
+static const double kStretchBelowMs = 30;
+static const double kMinRatio = 0.5;
+// Reads keep up to a callback above the fill level. Above that by this
+// much, playback speeds up until back within a callback of the fill level.
+static const double kShedMarginMs = 20;
+static const double kShedRatio = 1.05;
+// Drained audio beyond which the source is taken to produce audio on
+// demand rather than return what it has, and reading ahead stops.
+static const double kMaxContinuousShedMs = 500;
+
+struct otk_time_stretch {
+    uint32_t sample_rate;
+    size_t overlap;
+    size_t sequence;
+    size_t seek;
+    size_t fill;
+    size_t stretch_below;
+    size_t shed_below;
+    size_t shed_above;
+    size_t read_limit;
+    size_t max_continuous_shed;
+
+    // Real-time thread state. input[position, end) has not been played.
+    std::vector<int16_t> staging;
+    size_t wanted;
+    std::vector<float> input;
+    size_t position;
+    size_t end;
+    std::vector<float> output;
+    size_t output_position;
+    size_t output_end;
+    // Natural continuation of the last segment, matched by the next one,
+    // and where it starts relative to position; SIZE_MAX once skipped past.
+    std::vector<float> tail;
+    size_t continuation;
+    double skip_fraction;
+    bool playing;
+    bool started;
+    bool shedding;
+    bool read_ahead;
+    size_t continuous_shed;
+
+    std::atomic<bool> reset_requested;
+
+    std::atomic<double> ratio;
+    std::atomic<size_t> buffered;
+    std::atomic<uint64_t> shed;
+    std::atomic<uint64_t> stretched;
+    std::atomic<uint64_t> concealed;
+    std::atomic<uint64_t> underruns;
+    std::atomic<uint64_t> short_reads;
+};
+
+static size_t ms_to_frames(double ms, uint32_t sample_rate) {
+    return (size_t)std::lround(ms * sample_rate / 1000);
+}
+
+static float dot(const float *a, const float *b, size_t n) {
+    size_t i = 0;
+    float total = 0;
+#if OTK_STRETCH_NEON
+    float32x4_t sums = vdupq_n_f32(0);
+    for (; i + 4 <= n; i += 4) {
+        sums = vmlaq_f32(sums, vld1q_f32(a + i), vld1q_f32(b + i));
+    }
+    total = vgetq_lane_f32(sums, 0) + vgetq_lane_f32(sums, 1) + vgetq_lane_f32(sums, 2) + vgetq_lane_f32(sums, 3);
+#elif OTK_STRETCH_SSE2
+    __m128 sums = _mm_setzero_ps();
+    for (; i + 4 <= n; i += 4) {
+        sums = _mm_add_ps(sums, _mm_mul_ps(_mm_loadu_ps(a + i), _mm_loadu_ps(b + i)));
+    }
+    float lanes[4];
+    _mm_storeu_ps(lanes, sums);
+    total = lanes[0] + lanes[1] + lanes[2] + lanes[3];
+#endif
+    for (; i < n; i++) {
+        total += a[i] * b[i];
+    }
+    return total;
+}
+
+// Offset in [0, range] where x best matches the tail, by normalized
+// cross-correlation. The natural continuation of the tail, when in range,
+// wins unless another offset is clearly better: on periodic audio offsets a
+// pitch period apart score within rounding of each other, and staying on
+// the continuation keeps a steady tempo an exact copy of the input.
+static size_t best_offset(const float *tail, const float *x, size_t overlap, size_t range, size_t natural) {
+    double energy = 0;
+    for (size_t i = 0; i < overlap; i++) {
+        energy += (double)x[i] * x[i];
+    }
+    size_t best = 0;
+    double best_score = -INFINITY;
+    for (size_t k = 0; k <= range; k++) {
+        double score = dot(tail, x + k, overlap) / std::sqrt(energy + 1e-9);
+        if (score > best_score) {
+            best_score = score;
+            best = k;
+        }
+        energy += (double)x[k + overlap] * x[k + overlap] - (double)x[k] * x[k];
+        energy = std::max(energy, 0.0);
+    }
+    if (natural <= range && natural != best) {
+        const float *y = x + natural;
+        double score = dot(tail, y, overlap) / std::sqrt(dot(y, y, overlap) + 1e-9);
+        if (score >= best_score - 1e-3 * std::fabs(best_score)) {
+            return natural;
+        }
+    }
+    return best;
+}
+
+static float *output_room(otk_time_stretch *stretch, size_t frames) {
+    if (stretch->output_end + frames > stretch->output.size()) {
+        size_t pending = stretch->output_end - stretch->output_position;
+        memmove(stretch->output.data(), stretch->output.data() + stretch->output_position, pending * sizeof(float));
+        stretch->output_position = 0;
+        stretch->output_end = pending;
+    }
+    float *room = stretch->output.data() + stretch->output_end;
+    stretch->output_end += frames;
+    return room;
+}
+
+static void do_reset(otk_time_stretch *stretch) {
+    stretch->position = stretch->end = 0;
+    stretch->output_position = stretch->output_end = 0;
+    std::fill(stretch->tail.begin(), stretch->tail.end(), 0.0f);
+    stretch->continuation = SIZE_MAX;
+    stretch->skip_fraction = 0;
+    stretch->playing = false;
+    stretch->started = false;
+    stretch->shedding = false;
+    stretch->read_ahead = true;
+    stretch->continuous_shed = 0;
+    stretch->ratio.store(1.0, std::memory_order_relaxed);
+    stretch->buffered.store(0, std::memory_order_relaxed);
+}
+
+// Appends one segment of sequence - overlap frames to the output.
+static void produce_segment(otk_time_stretch *stretch) {
+    const size_t overlap = stretch->overlap;
+    const size_t hop = stretch->sequence - overlap;
+    size_t available = stretch->end - stretch->position;
+    float *out = output_room(stretch, hop);
+
+    if (stretch->playing && available < stretch->sequence) {
+        // Ran dry: fade out what was playing and wait for the buffer to
+        // fill up again.
+        for (size_t i = 0; i < overlap; i++) {
+            out[i] = stretch->tail[i] * (float)(overlap - i) / (float)overlap;
+        }
+        std::fill(out + overlap, out + hop, 0.0f);
+        std::fill(stretch->tail.begin(), stretch->tail.end(), 0.0f);
+        stretch->continuation = SIZE_MAX;
+        stretch->playing = false;
+        stretch->shedding = false;
+        stretch->ratio.store(1.0, std::memory_order_relaxed);
+        stretch->underruns.fetch_add(1, std::memory_order_relaxed);
+        stretch->concealed.fetch_add(hop, std::memory_order_relaxed);
+        return;
+    }
+    if (!stretch->playing) {
+        if (available < stretch->fill) {
+            std::fill(out, out + hop, 0.0f);
+            if (stretch->started) {
+                stretch->concealed.fetch_add(hop, std::memory_order_relaxed);
+            }
+            return;
+        }
+        // The tail is silent, so the first segment fades in.
+        stretch->playing = true;
+        stretch->started = true;
+    }
+
+    double ratio = 1;
+    bool shed = stretch->continuous_shed < stretch->max_continuous_shed &&
+                available > (stretch->shedding ? stretch->shed_below : stretch->shed_above);
+    stretch->shedding = shed;
+    if (shed) {
+        ratio = kShedRatio;
+    } else if (available < stretch->stretch_below) {
+        double depth = (double)(available - stretch->sequence) / (double)(stretch->stretch_below - stretch->sequence);
+        ratio = kMinRatio + (1 - kMinRatio) * depth;
+    }
+
+    const float *x = stretch->input.data() + stretch->position;
+    size_t k = best_offset(stretch->tail.data(), x, overlap,
+                           std::min(stretch->seek, available - stretch->sequence), stretch->continuation);
+    x += k;
+    for (size_t i = 0; i < overlap; i++) {
+        out[i] = (stretch->tail[i] * (float)(overlap - i) + x[i] * (float)i) / (float)overlap;
+    }
+    memcpy(out + overlap, x + overlap, (hop - overlap) * sizeof(float));
+    memcpy(stretch->tail.data(), x + hop, overlap * sizeof(float));
+
+    double skip = ratio * (double)hop + stretch->skip_fraction;
+    size_t consumed = std::min((size_t)skip, available);
+    stretch->skip_fraction = skip - (double)consumed;
+    stretch->position += consumed;
+    stretch->continuation = k + hop >= consumed ? k + hop - consumed : SIZE_MAX;
+
+    if (consumed > hop) {
+        stretch->shed.fetch_add(consumed - hop, std::memory_order_relaxed);
+        stretch->continuous_shed += consumed - hop;
+        if (stretch->continuous_shed >= stretch->max_continuous_shed) {
+            stretch->read_ahead = false;
+        }
+    } else {
+        stretch->continuous_shed = 0;
+        if (consumed < hop) {
+            stretch->stretched.fetch_add(hop - consumed, std::memory_order_relaxed);
+        }
+    }
+    stretch->ratio.store(ratio, std::memory_order_relaxed);
+}
+
+otk_time_stretch *otk_time_stretch_new(uint32_t sample_rate, uint32_t max_frames) {
+    if (sample_rate == 0 || max_frames == 0) {
+        return nullptr;
+    }
+    otk_time_stretch *stretch = new otk_time_stretch();
+    stretch->sample_rate = sample_rate;
+    stretch->overlap = std::max<size_t>(1, ms_to_frames(kOverlapMs, sample_rate));
+    stretch->sequence = std::max(2 * stretch->overlap + 1, ms_to_frames(kSequenceMs, sample_rate));
+    stretch->seek = ms_to_frames(kSeekMs, sample_rate);
+    stretch->fill = std::max(stretch->sequence + stretch->seek, ms_to_frames(kFillMs, sample_rate));
+    stretch->stretch_below = std::min(stretch->fill, std::max(stretch->sequence + 1, ms_to_frames(kStretchBelowMs, sample_rate)));
+    size_t margin = ms_to_frames(kShedMarginMs, sample_rate);
+    stretch->shed_below = stretch->fill + max_frames;
+    stretch->shed_above = stretch->shed_below + margin;
+    stretch->read_limit = stretch->shed_above + margin;
+    stretch->max_continuous_shed = ms_to_frames(kMaxContinuousShedMs, sample_rate);
+
+    stretch->staging.resize(stretch->read_limit + max_frames);
+    stretch->input.resize(2 * (stretch->read_limit + max_frames));
+    stretch->output.resize(2 * (stretch->sequence + max_frames));
+    stretch->tail.resize(stretch->overlap);
+    stretch->wanted = 0;
+    stretch->shed.store(0);
+    stretch->stretched.store(0);
+    stretch->concealed.store(0);
+    stretch->underruns.store(0);
+    stretch->short_reads.store(0);
+    stretch->reset_requested.store(false);
+    do_reset(stretch);
+    return stretch;
+}
+
+void otk_time_stretch_delete(otk_time_stretch *stretch) {
+    delete stretch;
+}
+
+size_t otk_time_stretch_wanted(otk_time_stretch *stretch, size_t frames) {
+    if (stretch == nullptr) {
+        return 0;
+    }
+    if (stretch->reset_requested.exchange(false, std::memory_order_acquire)) {
+        do_reset(stretch);
+    }
+    size_t available = stretch->end - stretch->position;
+    size_t limit = (stretch->read_ahead ? stretch->read_limit : stretch->fill) + frames;
+    size_t wanted = limit > available ? limit - available : 0;
+    stretch->wanted = std::min(wanted, stretch->staging.size());
+    return stretch->wanted;
+}
+
+int16_t *otk_time_stretch_input(otk_time_stretch *stretch) {
+    return stretch != nullptr ? stretch->staging.data() : nullptr;
+}
+
+void otk_time_stretch_commit(otk_time_stretch *stretch, size_t requested, size_t received) {
+    if (stretch == nullptr) {
+        return;
+    }
+    received = std::min(received, stretch->wanted);
+    stretch->wanted = 0;
+    if (received < requested) {
+        stretch->short_reads.fetch_add(1, std::memory_order_relaxed);
+        // The source only returns what it has, so reading ahead is safe.
+        stretch->read_ahead = true;
+        stretch->continuous_shed = 0;
+    }
+    if (stretch->end + received > stretch->input.size()) {
+        size_t pending = stretch->end - stretch->position;
+        memmove(stretch->input.data(), stretch->input.data() + stretch->position, pending * sizeof(float));
+        stretch->position = 0;
+        stretch->end = pending;
+    }
+    float *in = stretch->input.data() + stretch->end;
+    for (size_t i = 0; i < received; i++) {
+        in[i] = stretch->staging[i];
+    }
+    stretch->end += received;
+}
+
+void otk_time_stretch_read(otk_time_stretch *stretch, int16_t *out, size_t frames) {
+    if (stretch == nullptr || out == nullptr) {
+        return;
+    }
+    while (stretch->output_end - stretch->output_position < frames) {
+        produce_segment(stretch);
+    }
+    const float *produced = stretch->output.data() + stretch->output_position;
+    for (size_t i = 0; i < frames; i++) {
+        out[i] = (int16_t)std::lrint(std::min(std::max(produced[i], -32768.0f), 32767.0f));
+    }
+    stretch->output_position += frames;
+    stretch->buffered.store(stretch->end - stretch->position + stretch->output_end - stretch->output_position,
+                            std::memory_order_relaxed);
+}
+
+void otk_time_stretch_reset(otk_time_stretch *stretch) {
+    if (stretch == nullptr) {
+        return;
+    }
+    stretch->reset_requested.store(true, std::memory_order_release);
+}
+
+void otk_time_stretch_get_stats(otk_time_stretch *stretch, otk_time_stretch_stats *stats) {
+    if (stretch == nullptr || stats == nullptr) {
+        return;
+    }
+    double ms_per_frame = 1000.0 / stretch->sample_rate;
+    stats->ratio = stretch->ratio.load(std::memory_order_relaxed);
+    stats->buffered_ms = stretch->buffered.load(std::memory_order_relaxed) * ms_per_frame;
+    stats->shed_ms = stretch->shed.load(std::memory_order_relaxed) * ms_per_frame;
+    stats->stretched_ms = stretch->stretched.load(std::memory_order_relaxed) * ms_per_frame;
+    stats->concealed_ms = stretch->concealed.load(std::memory_order_relaxed) * ms_per_frame;
+    stats->underruns = stretch->underruns.load(std::memory_order_relaxed);
+    stats->short_reads = stretch->short_reads.load(std::memory_order_relaxed);
+}
@@ -0,0 +1,89 @@
+//
+//  OTTimeStretch.h
+//  Custom-Audio-Driver
+//
+//  Copyright (c) 2026 Vonage. All rights reserved.
+//
+
+#ifndef OTTimeStretch_h
+#define OTTimeStretch_h
+
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * Adaptive time-scale stage between the SDK and the playout device.
+ *
+ * Audio read from the SDK is buffered here and played back through WSOLA
+ * (waveform similarity overlap-add): segments of the input are overlapped
+ * at the offset where they best match the audio already played, so the
+ * tempo changes without changing the pitch.
+ *
+ * - While more audio than needed is buffered, for example after a network
+ *   burst, playback runs 5% faster until the excess is gone.
+ * - When the SDK delivers less than asked for, the remaining audio is
+ *   stretched down to half speed to cover the gap.
+ * - When nothing is left, the last segment fades out and silence is played
+ *   until the buffer is refilled.
+ *
+ * The stage keeps about 40 ms buffered so it has audio to search and
+ * stretch. It assumes the SDK only returns the audio it has, so asking for
+ * more than one callback's worth reveals audio waiting in its buffers.
+ *
+ * Mono 16 bit. Everything is allocated up front; reading, writing and
+ * processing do not allocate, lock or block, so they can run on the
+ * real-time audio thread. Statistics can be read from any thread.
+ */
+typedef struct otk_time_stretch otk_time_stretch;
+
+typedef struct otk_time_stretch_stats {
+    /** Tempo of the last segment: above 1 draining, below 1 stretching. */
+    double ratio;
+    /** Audio buffered ahead of playback. */
+    double buffered_ms;
+    /** Input skipped by playing faster. */
+    double shed_ms;
+    /** Output added by playing slower. */
+    double stretched_ms;
+    /** Output faded out or silent because nothing was buffered. */
+    double concealed_ms;
+    /** Times the buffer ran dry. */
+    uint64_t underruns;
+    /** Reads that returned less than asked for. */
+    uint64_t short_reads;
+} otk_time_stretch_stats;
+
+/** max_frames is the largest callback the device will ask for. */
+otk_time_stretch *otk_time_stretch_new(uint32_t sample_rate, uint32_t max_frames);
+
+void otk_time_stretch_delete(otk_time_stretch *stretch);
+
+/**
+ * Frames to ask the source for before playing frames more. Returns 0 when
+ * the buffer is full.
+ */
+size_t otk_time_stretch_wanted(otk_time_stretch *stretch, size_t frames);
+
+/** Room for the next frames of input, at most the last wanted count. */
+int16_t *otk_time_stretch_input(otk_time_stretch *stretch);
+
+/** Adds the received frames written to the input, out of requested. */
+void otk_time_stretch_commit(otk_time_stretch *stretch, size_t requested, size_t received);
+
+/** Always fills out with frames samples. */
+void otk_time_stretch_read(otk_time_stretch *stretch, int16_t *out, size_t frames);
+
+/** Drops buffered audio, for example when playout restarts. */
+void otk_time_stretch_reset(otk_time_stretch *stretch);
+
+void otk_time_stretch_get_stats(otk_time_stretch *stretch, otk_time_stretch_stats *stats);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* OTTimeStretch_h */
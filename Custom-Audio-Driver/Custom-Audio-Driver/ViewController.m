@@ -11,6 +11,36 @@
 #import "OTAudioDeviceProxy.h"
 #import "OTAudioKit.h"
 #import "OTDefaultAudioDevice-Mac.h"
+#include "OTAsyncLogger.h"
+#include <time.h>
+
+// Set to 1 to log voice activity changes measured in the capture path
+#define OT_ENABLE_VOICE_ACTIVITY_LOG 0
+#define kVoiceActivityPollInterval 0.1
+
+// Highlight the publisher view while the capture path detects voice, so a
+// speaker can tell the microphone picks them up
+#define OT_ENABLE_SPEAKING_INDICATOR 1
+
+// Set to 1 to log the playout time stretch every few seconds
+#define OT_ENABLE_PLAYOUT_STRETCH_LOG 0
+#define kPlayoutStretchLogInterval 5.0
+
+// Set to 1 to measure the audio round trip with chirps once a subscriber
+// connects. The chirps are audible and replace the received audio.
+#define OT_ENABLE_LATENCY_MEASUREMENT 0
+#define kLatencyMeasurementChirps 10
+
+// Set to 1, with OT_ENABLE_AV_SYNC_MONITOR in OTDefaultAudioDevice-Mac.m, to
+// log every few seconds how far apart the local audio and video paths put
+// what the SDK hands over at the same moment. This is the skew the render
+// paths add after the SDK, not end-to-end lip sync.
+#define OT_ENABLE_RENDER_SKEW_LOG 0
+#define kRenderSkewLogInterval 5.0
+
+// SDK and audio driver messages go to this file in the temporary directory,
+// rotated at 4 MB, through a logger that does not block the calling thread
+#define kLogFileName @"Custom-Audio-Driver.log"
 
 // Replace with your OpenTok API key
 static char* const kApiKey = "";
@@ -23,6 +53,8 @@ otc_session *session = NULL;
 otc_publisher *publisher = NULL;
 OTMTLVideoView *pubView = NULL;
 OTMTLVideoView *subscriberView = NULL;
+OTDefaultAudioDeviceMac *audioDevice = NULL;
+NSString *subscribedStreamId = nil;
 
 bool isConnected = false;
 bool isCamMuted = false;
@@ -39,12 +71,25 @@ bool isMicMuted = false;
     [super viewDidLoad];
     [self.view setFrameSize:CGSizeMake(700, 330)];
     [self setPreferredContentSize:self.view.frame.size];
+    setupLogging();
     otc_init(NULL);
     setupCustomAudioDriver();
+#if OT_ENABLE_VOICE_ACTIVITY_LOG
+    setupVoiceActivityLog();
+#endif
+#if OT_ENABLE_PLAYOUT_STRETCH_LOG
+    setupPlayoutStretchLog();
+#endif
+#if OT_ENABLE_RENDER_SKEW_LOG
+    setupRenderSkewLog();
+#endif
     pubView = [[OTMTLVideoView alloc] initWithFrame:(CGRectMake(0,0,320,240))];
     [self.view addSubview:pubView];
     pubView.wantsLayer = YES;
     pubView.layer.borderWidth = 5;
+#if OT_ENABLE_SPEAKING_INDICATOR
+    setupSpeakingIndicator();
+#endif
     
     subscriberView = [[OTMTLVideoView alloc] initWithFrame:(CGRectMake(325,0,320,240))];
     [self.view addSubview:subscriberView];
@@ -95,13 +140,94 @@ bool isMicMuted = false;
 }
 
 void session_logger_func(const char* message) {
-    NSLog(@"%s",message);
+    OTK_LOG_DEFAULT(OTK_LOG_INFO, "%s", message);
+}
+
+void setupLogging(void){
+    NSString *path = [NSTemporaryDirectory() stringByAppendingPathComponent:kLogFileName];
+    otk_logger_config config;
+    otk_logger_config_default(&config);
+    config.level = OTK_LOG_DEBUG;
+    config.path = path.fileSystemRepresentation;
+    otk_logger *logger = otk_logger_new(&config);
+    if (logger == NULL) {
+        NSLog(@"Could not open log file %@", path);
+        return;
+    }
+    otk_logger_set_default(logger);
+    NSLog(@"Logging to %@", path);
 }
 
 void setupCustomAudioDriver(void){
-    OTDefaultAudioDeviceMac *audioDevice = [[OTDefaultAudioDeviceMac alloc] init];
+    audioDevice = [[OTDefaultAudioDeviceMac alloc] init];
     OTAudioDeviceProxy *audioProxy = [[OTAudioDeviceProxy alloc] initWithAudioDevice:audioDevice];
 }
+
+void setupVoiceActivityLog(void){
+    __block int wasActive = 0;
+    [NSTimer scheduledTimerWithTimeInterval:kVoiceActivityPollInterval repeats:YES block:^(NSTimer *timer) {
+        otk_audio_level level = [audioDevice captureLevel];
+        if (level.voice_active != wasActive) {
+            NSLog(@"Voice %s: rms %.1f dBFS, peak %.1f dBFS, noise floor %.1f dBFS",
+                  level.voice_active ? "started" : "stopped",
+                  level.rms_dbfs, level.peak_dbfs, level.noise_floor_dbfs);
+            wasActive = level.voice_active;
+        }
+    }];
+}
+
+void setupSpeakingIndicator(void){
+    __block BOOL wasSpeaking = NO;
+    [NSTimer scheduledTimerWithTimeInterval:kVoiceActivityPollInterval repeats:YES block:^(NSTimer *timer) {
+        // Nothing is sent while the microphone is muted.
+        BOOL speaking = [audioDevice captureLevel].voice_active && !isMicMuted;
+        if (speaking != wasSpeaking) {
+            pubView.layer.borderColor = (speaking ? NSColor.systemGreenColor : NSColor.blackColor).CGColor;
+            wasSpeaking = speaking;
+        }
+    }];
+}
+
+void setupPlayoutStretchLog(void){
+    [NSTimer scheduledTimerWithTimeInterval:kPlayoutStretchLogInterval repeats:YES block:^(NSTimer *timer) {
+        otk_time_stretch_stats stats = [audioDevice playoutStretchStats];
+        NSLog(@"Playout stretch: ratio %.2f, buffered %.1f ms, shed %.0f ms, stretched %.0f ms, concealed %.0f ms, underruns %llu, short reads %llu",
+              stats.ratio, stats.buffered_ms, stats.shed_ms, stats.stretched_ms, stats.concealed_ms,
+              (unsigned long long)stats.underruns, (unsigned long long)stats.short_reads);
+    }];
+}
+
+void setupRenderSkewLog(void){
+    __block int wasOutOfSync = 0;
+    [NSTimer scheduledTimerWithTimeInterval:kRenderSkewLogInterval repeats:YES block:^(NSTimer *timer) {
+        otk_av_sync_stats stats;
+        if (!subscribedStreamId ||
+            !otk_av_sync_monitor_get_stats(audioDevice.syncMonitor, subscribedStreamId.UTF8String, &stats)) {
+            return;
+        }
+        if (stats.out_of_sync != wasOutOfSync) {
+            NSLog(@"Stream %@ %s", subscribedStreamId, stats.out_of_sync ? "out of sync" : "back in sync");
+            wasOutOfSync = stats.out_of_sync;
+        }
+        NSLog(@"Render skew (video behind audio): p5 %.1f ms, median %.1f ms, p95 %.1f ms, %llu frames, %llu unmapped",
+              stats.p5_ms, stats.p50_ms, stats.p95_ms,
+              (unsigned long long)stats.frames, (unsigned long long)stats.unmapped);
+    }];
+}
+
+void startLatencyMeasurement(void){
+    if (![audioDevice startLatencyMeasurement:kLatencyMeasurementChirps]) {
+        return;
+    }
+    // One chirp a second, plus time for the last echo to be analyzed.
+    [NSTimer scheduledTimerWithTimeInterval:kLatencyMeasurementChirps + 2 repeats:NO block:^(NSTimer *timer) {
+        otk_latency_stats stats = [audioDevice latencyStats];
+        NSLog(@"Round trip: mean %.2f ms, stddev %.2f ms, min %.2f ms, max %.2f ms, %u found, %u missed, estimated %u ms",
+              stats.mean_ms, stats.stddev_ms, stats.min_ms, stats.max_ms,
+              stats.measurements, stats.failures,
+              audioDevice.estimatedRenderDelay + audioDevice.estimatedCaptureDelay);
+    }];
+}
 void setupOpentokSession(void * userdata){
     
     //otc_log_enable(OTC_LOG_LEVEL_ALL);
@@ -183,11 +309,17 @@ void session_on_stream_received(otc_session *session, void *user_data, const otc
     callbacks.on_video_enabled = subscriber_on_video_enabled;
     callbacks.user_data = user_data;
     otc_subscriber *subscriber= otc_subscriber_new(stream, &callbacks);
+    otk_av_sync_monitor_add_stream(audioDevice.syncMonitor, otc_stream_get_id(stream));
+    NSString *streamId = [NSString stringWithUTF8String:otc_stream_get_id(stream)];
+    dispatch_async(dispatch_get_main_queue(), ^{
+        subscribedStreamId = streamId;
+    });
     otc_session_subscribe(session, subscriber);
 }
 
 void session_on_stream_dropped(otc_session *session, void *user_data, const otc_stream *stream) {
     NSLog(@"Stream Dropped");
+    otk_av_sync_monitor_remove_stream(audioDevice.syncMonitor, otc_stream_get_id(stream));
 }
 
 void session_on_error(otc_session *session, void *user_data, const char * msg, enum otc_session_error_code error_code) {
@@ -236,7 +368,21 @@ static void publisher_on_render_frame(otc_publisher *publisher, void *user_data,
 
 
 static void subscriber_on_render_frame(otc_subscriber *subscriber, void *user_data, const otc_video_frame *frame) {
+    otk_av_sync_monitor *syncMonitor = audioDevice.syncMonitor;
+    if (!syncMonitor) {
+        [subscriberView renderVideoFrame:(otc_video_frame*)frame];
+        return;
+    }
+    // Reported like the audio device reports the mixed audio: the hand-off
+    // time as the media time, on the clock the device uses. The frame's own
+    // timestamp is on the sender's clock and cannot be matched to the audio.
+    // The view draws the queued frame on its next refresh, which is not seen.
+    int64_t handoff_ns = (int64_t)clock_gettime_nsec_np(CLOCK_UPTIME_RAW);
     [subscriberView renderVideoFrame:(otc_video_frame*)frame];
+    otk_av_sync_monitor_video(syncMonitor,
+                              otc_stream_get_id(otc_subscriber_get_stream(subscriber)),
+                              handoff_ns / 1000,
+                              (int64_t)clock_gettime_nsec_np(CLOCK_UPTIME_RAW));
 }
 
 static void subscriber_on_video_disabled(otc_subscriber* subscriber, void *user_data, enum otc_video_reason reason) {
@@ -250,6 +396,9 @@ static void subscriber_on_video_enabled(otc_subscriber* subscriber, void *user_d
 static void subscriber_on_connected(otc_subscriber *subscriber, void *user_data, const otc_stream *stream) {
     dispatch_async(dispatch_get_main_queue(), ^{
         subscriberView.hidden = FALSE;
+#if OT_ENABLE_LATENCY_MEASUREMENT
+        startLatencyMeasurement();
+#endif
     });
 }
 
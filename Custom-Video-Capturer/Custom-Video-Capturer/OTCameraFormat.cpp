@@ -0,0 +1,119 @@
+//
+//  OTCameraFormat.cpp
+//  Custom-Video-Capturer
+//
+//  Copyright (c) 2026 Vonage. All rights reserved.
+//
+
+#include "OTCameraFormat.h"
+
+#include <algorithm>
+#include <cmath>
+
+// Ranges are advertised as 29.97 or 30.000030 as often as 30.
+static const double kFrameRateTolerance = 0.01;
+
+// Cropping to another aspect ratio throws away part of every frame.
+static const double kAspectMismatchCost = 1.25;
+static const double kAspectTolerance = 0.01;
+
+// Lower tiers are always preferred, whatever the cost within the tier.
+enum format_tier {
+    TIER_MEETS_ALL = 0,
+    TIER_MEETS_RESOLUTION = 1,
+    TIER_MEETS_FRAME_RATE = 2,
+    TIER_MEETS_NONE = 3,
+};
+
+struct format_score {
+    format_tier tier;
+    double cost;
+    double frame_rate;
+};
+
+double otk_camera_pixel_format_cost(uint32_t pixel_format) {
+    switch (pixel_format) {
+        case OTK_PIXEL_FORMAT_420V:
+        case OTK_PIXEL_FORMAT_420F:
+            return 1.0;
+        case OTK_PIXEL_FORMAT_2VUY:
+        case OTK_PIXEL_FORMAT_YUVS:
+            return 1.5;
+        case OTK_PIXEL_FORMAT_DMB1:
+        case OTK_PIXEL_FORMAT_JPEG:
+            return 3.0;
+        default:
+            return 2.0;
+    }
+}
+
+double otk_camera_frame_rate(int64_t value, int32_t timescale) {
+    if (value <= 0 || timescale <= 0) {
+        return 0;
+    }
+    return (double)timescale / (double)value;
+}
+
+static format_score score(const otk_camera_format &format, const otk_camera_format_request &request) {
+    double area = (double)format.width * format.height;
+    double requested_area = std::max(1.0, (double)request.width * request.height);
+    bool meets_resolution = format.width >= request.width && format.height >= request.height;
+    bool meets_frame_rate = format.max_frame_rate * (1 + kFrameRateTolerance) >= request.frame_rate;
+    double frame_rate = std::min(std::max(request.frame_rate, format.min_frame_rate), format.max_frame_rate);
+
+    format_score result;
+    result.frame_rate = frame_rate;
+    if (meets_resolution && meets_frame_rate) {
+        // Pixels produced per second relative to what was asked for.
+        result.tier = TIER_MEETS_ALL;
+        result.cost = area / requested_area * otk_camera_pixel_format_cost(format.pixel_format);
+        double aspect = (double)format.width / std::max<uint32_t>(1, format.height);
+        double requested_aspect = (double)request.width / std::max<uint32_t>(1, request.height);
+        if (std::fabs(aspect / requested_aspect - 1) > kAspectTolerance) {
+            result.cost *= kAspectMismatchCost;
+        }
+        // A range that cannot go down to the request only gets there by
+        // dropping frames that were captured and converted for nothing.
+        if (format.min_frame_rate > request.frame_rate * (1 + kFrameRateTolerance)) {
+            result.cost *= format.min_frame_rate / request.frame_rate;
+        }
+    } else if (meets_resolution) {
+        // The more of the frame rate, then the smaller.
+        result.tier = TIER_MEETS_RESOLUTION;
+        result.cost = -format.max_frame_rate + area / (requested_area * 1e6);
+    } else if (meets_frame_rate) {
+        // The closer to the size.
+        result.tier = TIER_MEETS_FRAME_RATE;
+        result.cost = -area / requested_area * (1 / otk_camera_pixel_format_cost(format.pixel_format));
+    } else {
+        result.tier = TIER_MEETS_NONE;
+        result.cost = -area * format.max_frame_rate;
+    }
+    return result;
+}
+
+int otk_camera_format_select(const otk_camera_format *formats,
+                             size_t count,
+                             const otk_camera_format_request *request,
+                             otk_camera_format_choice *choice) {
+    if (formats == nullptr || count == 0 || request == nullptr || choice == nullptr) {
+        return 0;
+    }
+    size_t best = 0;
+    format_score best_score = score(formats[0], *request);
+    for (size_t i = 1; i < count; i++) {
+        format_score candidate = score(formats[i], *request);
+        // Ties keep the device's order.
+        if (candidate.tier < best_score.tier ||
+            (candidate.tier == best_score.tier && candidate.cost < best_score.cost)) {
+            best = i;
+            best_score = candidate;
+        }
+    }
+    choice->entry = best;
+    choice->frame_rate = best_score.frame_rate;
+    choice->meets_resolution = best_score.tier == TIER_MEETS_ALL || best_score.tier == TIER_MEETS_RESOLUTION;
+    choice->meets_frame_rate = best_score.tier == TIER_MEETS_ALL || best_score.tier == TIER_MEETS_FRAME_RATE;
+    choice->cost = best_score.cost;
+    return 1;
+}
@@ -0,0 +1,102 @@
+//
+//  OTCameraFormat.h
+//  Custom-Video-Capturer
+//
+//  Copyright (c) 2026 Vonage. All rights reserved.
+//
+
+#ifndef OTCameraFormat_h
+#define OTCameraFormat_h
+
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * Picks the camera format to capture from out of the formats the device
+ * advertises, instead of letting a session preset choose one and scale or
+ * crop it.
+ *
+ * Plain C++, independent of AVFoundation: the capturer flattens the
+ * device's formats into a table, so recorded tables can be replayed.
+ */
+
+/** FourCC codes of the pixel formats the engine knows the cost of. */
+#define OTK_FOURCC(a, b, c, d) \
+    (((uint32_t)(a) << 24) | ((uint32_t)(b) << 16) | ((uint32_t)(c) << 8) | (uint32_t)(d))
+/** NV12, video and full range: delivered as is. */
+#define OTK_PIXEL_FORMAT_420V OTK_FOURCC('4', '2', '0', 'v')
+#define OTK_PIXEL_FORMAT_420F OTK_FOURCC('4', '2', '0', 'f')
+/** Packed 4:2:2, converted to NV12 by the system. */
+#define OTK_PIXEL_FORMAT_2VUY OTK_FOURCC('2', 'v', 'u', 'y')
+#define OTK_PIXEL_FORMAT_YUVS OTK_FOURCC('y', 'u', 'v', 's')
+/** Motion JPEG, decoded by the system before conversion. */
+#define OTK_PIXEL_FORMAT_DMB1 OTK_FOURCC('d', 'm', 'b', '1')
+#define OTK_PIXEL_FORMAT_JPEG OTK_FOURCC('j', 'p', 'e', 'g')
+
+/**
+ * One frame rate range of one device format. A format with several ranges
+ * appears once per range, with the same index.
+ */
+typedef struct otk_camera_format {
+    /** Position of the format in the device's list. */
+    uint32_t index;
+    uint32_t width;
+    uint32_t height;
+    /** FourCC media subtype of the format. */
+    uint32_t pixel_format;
+    double min_frame_rate;
+    double max_frame_rate;
+} otk_camera_format;
+
+typedef struct otk_camera_format_request {
+    uint32_t width;
+    uint32_t height;
+    double frame_rate;
+} otk_camera_format_request;
+
+typedef struct otk_camera_format_choice {
+    /** Entry of the table that was picked. */
+    size_t entry;
+    /** Frame rate to configure, within the entry's range. */
+    double frame_rate;
+    /** Whether the format covers the requested size. */
+    int meets_resolution;
+    /** Whether the format reaches the requested frame rate. */
+    int meets_frame_rate;
+    /** Lower is better; only comparable between choices for one request. */
+    double cost;
+} otk_camera_format_choice;
+
+/**
+ * Relative cost of delivering the pixel format as NV12: 1 for NV12, more
+ * for formats that have to be converted or decoded first.
+ */
+double otk_camera_pixel_format_cost(uint32_t pixel_format);
+
+/**
+ * Frame rate of a frame duration of value/timescale seconds, 0 for an
+ * empty duration.
+ */
+double otk_camera_frame_rate(int64_t value, int32_t timescale);
+
+/**
+ * Picks the cheapest entry that covers the requested size at the requested
+ * frame rate, preferring the same aspect ratio and formats that need no
+ * conversion. When none does, prefers reaching the size at the highest
+ * frame rate, then the biggest size that reaches the frame rate, then the
+ * biggest pixel rate. Returns 0 if the table is empty.
+ */
+int otk_camera_format_select(const otk_camera_format *formats,
+                             size_t count,
+                             const otk_camera_format_request *request,
+                             otk_camera_format_choice *choice);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* OTCameraFormat_h */
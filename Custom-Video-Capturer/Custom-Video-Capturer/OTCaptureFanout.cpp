@@ -0,0 +1,693 @@
+//
+//  OTCaptureFanout.cpp
+//  Custom-Video-Capturer
+//
+//  Copyright (c) 2026 Vonage. All rights reserved.
+//
+
+#include "OTCaptureFanout.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+#if defined(__ARM_NEON) || defined(__ARM_NEON__)
+#include <arm_neon.h>
+#define OTK_FANOUT_NEON 1
+#elif defined(__SSE2__)
+#include <emmintrin.h>
+#define OTK_FANOUT_SSE2 1
+#endif
+
+// Buffers kept per size for reuse; the SDK rarely holds more than a couple
+// of frames of a capturer at once.
+static const size_t kMaxPooledBuffers = 4;
+
+// A size no consumer asked for in this many source frames has its pool
+// dropped, as after the camera changes resolution.
+static const uint64_t kPoolIdleFrames = 90;
+
+// Frames arriving this early, as a fraction of the consumer's interval, are
+// still taken, so capture jitter does not drop every other frame when the
+// rates divide evenly.
+static const int64_t kDecimationToleranceDivisor = 8;
+
+namespace {
+
+struct buffer_pool {
+    std::mutex lock;
+    std::vector<otk_fanout_buffer *> free;
+    bool closed = false;
+};
+
+struct consumer {
+    uint32_t max_width;
+    uint32_t max_height;
+    int64_t interval_us;
+    otk_fanout_deliver deliver;
+    void *user_data;
+    bool active = false;
+    // Whether a frame was taken since the consumer became active.
+    bool started = false;
+    int64_t next_due_us = 0;
+    otk_fanout_consumer_stats stats = {};
+};
+
+struct pool_entry {
+    std::shared_ptr<buffer_pool> pool;
+    uint64_t last_used = 0;
+};
+
+struct scaled_frame {
+    uint32_t width;
+    uint32_t height;
+    otk_fanout_buffer *buffer;
+};
+
+// A frame picked for a consumer, delivered once the lock is released.
+struct delivery {
+    int consumer;
+    otk_fanout_frame frame;
+    otk_fanout_buffer *buffer;
+};
+
+// A deliver callback running now, and the thread running it.
+struct running_delivery {
+    int consumer;
+    std::thread::id thread;
+};
+
+} // namespace
+
+struct otk_fanout_buffer {
+    std::atomic<uint32_t> references{1};
+    uint32_t width = 0;
+    uint32_t height = 0;
+    const uint8_t *planes[2] = {};
+    int strides[2] = {};
+    // Wrapped buffers.
+    otk_fanout_buffer_free free = nullptr;
+    void *context = nullptr;
+    // Scaled buffers, set while they are out of their pool.
+    std::vector<uint8_t> storage;
+    std::shared_ptr<buffer_pool> pool;
+};
+
+struct otk_capture_fanout {
+    // Not held while the deliver callbacks run.
+    std::mutex lock;
+    // Signalled when a deliver callback returns, for removals waiting on it.
+    std::condition_variable delivered;
+    std::vector<running_delivery> running;
+    int next_id = 1;
+    // Ordered, so consumers are called in the order they were added.
+    std::map<int, consumer> consumers;
+    std::unordered_map<uint64_t, pool_entry> pools;
+    std::vector<scaled_frame> scaled;
+    otk_fanout_stats stats = {};
+};
+
+otk_fanout_buffer *otk_fanout_buffer_wrap(uint32_t width, uint32_t height,
+                                          const uint8_t *const planes[2], const int strides[2],
+                                          otk_fanout_buffer_free free, void *context) {
+    if (planes == nullptr || strides == nullptr) {
+        return nullptr;
+    }
+    otk_fanout_buffer *buffer = new otk_fanout_buffer();
+    buffer->width = width;
+    buffer->height = height;
+    for (int i = 0; i < 2; i++) {
+        buffer->planes[i] = planes[i];
+        buffer->strides[i] = strides[i];
+    }
+    buffer->free = free;
+    buffer->context = context;
+    return buffer;
+}
+
+void otk_fanout_buffer_retain(otk_fanout_buffer *buffer) {
+    if (buffer != nullptr) {
+        buffer->references.fetch_add(1, std::memory_order_relaxed);
+    }
+}
+
+void otk_fanout_buffer_release(otk_fanout_buffer *buffer) {
+    if (buffer == nullptr || buffer->references.fetch_sub(1, std::memory_order_acq_rel) != 1) {
+        return;
+    }
+    if (!buffer->pool) {
+        if (buffer->free != nullptr) {
+            buffer->free(buffer->context);
+        }
+        delete buffer;
+        return;
+    }
+    // Pooled buffers do not keep their pool alive while in it.
+    std::shared_ptr<buffer_pool> pool = std::move(buffer->pool);
+    {
+        std::lock_guard<std::mutex> guard(pool->lock);
+        if (!pool->closed && pool->free.size() < kMaxPooledBuffers) {
+            pool->free.push_back(buffer);
+            return;
+        }
+    }
+    delete buffer;
+}
+
+const uint8_t *otk_fanout_buffer_plane(const otk_fanout_buffer *buffer, int plane) {
+    if (buffer == nullptr || plane < 0 || plane > 1) {
+        return nullptr;
+    }
+    return buffer->planes[plane];
+}
+
+int otk_fanout_buffer_stride(const otk_fanout_buffer *buffer, int plane) {
+    if (buffer == nullptr || plane < 0 || plane > 1) {
+        return 0;
+    }
+    return buffer->strides[plane];
+}
+
+static void close_pool(buffer_pool &pool) {
+    std::vector<otk_fanout_buffer *> free;
+    {
+        std::lock_guard<std::mutex> guard(pool.lock);
+        pool.closed = true;
+        free.swap(pool.free);
+    }
+    for (otk_fanout_buffer *buffer : free) {
+        delete buffer;
+    }
+}
+
+otk_capture_fanout *otk_capture_fanout_new(void) {
+    return new otk_capture_fanout();
+}
+
+void otk_capture_fanout_delete(otk_capture_fanout *fanout) {
+    if (fanout == nullptr) {
+        return;
+    }
+    for (auto &entry : fanout->pools) {
+        close_pool(*entry.second.pool);
+    }
+    delete fanout;
+}
+
+int otk_capture_fanout_add_consumer(otk_capture_fanout *fanout,
+                                    uint32_t max_width, uint32_t max_height, double max_frame_rate,
+                                    otk_fanout_deliver deliver, void *user_data) {
+    if (fanout == nullptr || deliver == nullptr) {
+        return 0;
+    }
+    consumer added;
+    added.max_width = max_width;
+    added.max_height = max_height;
+    added.interval_us = max_frame_rate > 0 ? (int64_t)(1000000.0 / max_frame_rate) : 0;
+    added.deliver = deliver;
+    added.user_data = user_data;
+    std::lock_guard<std::mutex> guard(fanout->lock);
+    int id = fanout->next_id++;
+    fanout->consumers.emplace(id, added);
+    fanout->stats.consumers = (uint32_t)fanout->consumers.size();
+    return id;
+}
+
+void otk_capture_fanout_remove_consumer(otk_capture_fanout *fanout, int consumer) {
+    if (fanout == nullptr) {
+        return;
+    }
+    std::unique_lock<std::mutex> guard(fanout->lock);
+    fanout->consumers.erase(consumer);
+    fanout->stats.consumers = (uint32_t)fanout->consumers.size();
+    // Waits for its callback to return, unless that is who is removing it.
+    std::thread::id self = std::this_thread::get_id();
+    fanout->delivered.wait(guard, [&] {
+        return std::none_of(fanout->running.begin(), fanout->running.end(),
+                            [&](const running_delivery &running) {
+                                return running.consumer == consumer && running.thread != self;
+                            });
+    });
+}
+
+void otk_capture_fanout_set_active(otk_capture_fanout *fanout, int consumer, int active) {
+    if (fanout == nullptr) {
+        return;
+    }
+    std::lock_guard<std::mutex> guard(fanout->lock);
+    auto found = fanout->consumers.find(consumer);
+    if (found == fanout->consumers.end()) {
+        return;
+    }
+    if (active && !found->second.active) {
+        found->second.started = false;
+    }
+    found->second.active = active != 0;
+}
+
+static bool fits(uint32_t width, uint32_t height, uint32_t max_width, uint32_t max_height) {
+    return (max_width == 0 || width <= max_width) && (max_height == 0 || height <= max_height);
+}
+
+// Smallest power of two reduction that fits the limits, or the largest one.
+static uint32_t select_factor(uint32_t source_width, uint32_t source_height,
+                              uint32_t max_width, uint32_t max_height) {
+    uint32_t factor = 1;
+    while (factor < OTK_CAPTURE_FANOUT_MAX_FACTOR &&
+           !fits(source_width / factor & ~1u, source_height / factor & ~1u, max_width, max_height) &&
+           (source_width / (factor * 2) & ~1u) > 0 && (source_height / (factor * 2) & ~1u) > 0) {
+        factor *= 2;
+    }
+    return factor;
+}
+
+static void scaled_size(uint32_t source_width, uint32_t source_height, uint32_t factor,
+                        uint32_t *width, uint32_t *height) {
+    if (factor == 1) {
+        *width = source_width;
+        *height = source_height;
+    } else {
+        *width = source_width / factor & ~1u;
+        *height = source_height / factor & ~1u;
+    }
+}
+
+void otk_capture_fanout_output_size(uint32_t source_width, uint32_t source_height,
+                                    uint32_t max_width, uint32_t max_height,
+                                    uint32_t *width, uint32_t *height) {
+    uint32_t factor = select_factor(source_width, source_height, max_width, max_height);
+    scaled_size(source_width, source_height, factor, width, height);
+}
+
+// Decides whether the consumer takes a frame and when the next one is due.
+static bool take_frame(consumer &taker, int64_t timestamp_us) {
+    if (taker.interval_us <= 0) {
+        return true;
+    }
+    int64_t tolerance = taker.interval_us / kDecimationToleranceDivisor;
+    bool early = timestamp_us < taker.next_due_us - tolerance;
+    // Further back than that, the source restarted its clock.
+    bool restarted = timestamp_us < taker.next_due_us - 2 * taker.interval_us;
+    if (taker.started && early && !restarted) {
+        return false;
+    }
+    if (!taker.started || restarted || timestamp_us >= taker.next_due_us + taker.interval_us) {
+        taker.next_due_us = timestamp_us + taker.interval_us;
+    } else {
+        taker.next_due_us += taker.interval_us;
+    }
+    taker.started = true;
+    return true;
+}
+
+// Luma rows, as OTFrameScaler downscales them.
+static void downscale_luma_row_2x(const uint8_t *r0, const uint8_t *r1, uint8_t *dst, int width) {
+    int x = 0;
+#if OTK_FANOUT_NEON
+    for (; x + 16 <= width; x += 16) {
+        uint8x16x2_t a = vld2q_u8(r0 + 2 * x);
+        uint8x16x2_t b = vld2q_u8(r1 + 2 * x);
+        uint16x8_t lo = vaddl_u8(vget_low_u8(a.val[0]), vget_low_u8(a.val[1]));
+        uint16x8_t hi = vaddl_u8(vget_high_u8(a.val[0]), vget_high_u8(a.val[1]));
+        lo = vaddq_u16(lo, vaddl_u8(vget_low_u8(b.val[0]), vget_low_u8(b.val[1])));
+        hi = vaddq_u16(hi, vaddl_u8(vget_high_u8(b.val[0]), vget_high_u8(b.val[1])));
+        vst1q_u8(dst + x, vcombine_u8(vrshrn_n_u16(lo, 2), vrshrn_n_u16(hi, 2)));
+    }
+#elif OTK_FANOUT_SSE2
+    const __m128i even_mask = _mm_set1_epi16(0x00ff);
+    const __m128i round = _mm_set1_epi16(2);
+    for (; x + 16 <= width; x += 16) {
+        __m128i sums[2];
+        for (int half = 0; half < 2; half++) {
+            __m128i a = _mm_loadu_si128((const __m128i *)(r0 + 2 * x + 16 * half));
+            __m128i b = _mm_loadu_si128((const __m128i *)(r1 + 2 * x + 16 * half));
+            __m128i sum = _mm_add_epi16(_mm_and_si128(a, even_mask), _mm_srli_epi16(a, 8));
+            sum = _mm_add_epi16(sum, _mm_and_si128(b, even_mask));
+            sum = _mm_add_epi16(sum, _mm_srli_epi16(b, 8));
+            sums[half] = _mm_srli_epi16(_mm_add_epi16(sum, round), 2);
+        }
+        _mm_storeu_si128((__m128i *)(dst + x), _mm_packus_epi16(sums[0], sums[1]));
+    }
+#endif
+    for (; x < width; x++) {
+        int sum = r0[2 * x] + r0[2 * x + 1] + r1[2 * x] + r1[2 * x + 1];
+        dst[x] = (uint8_t)((sum + 2) >> 2);
+    }
+}
+
+static void downscale_luma_row_4x(const uint8_t *const rows[4], uint8_t *dst, int width) {
+    int x = 0;
+#if OTK_FANOUT_NEON
+    for (; x + 16 <= width; x += 16) {
+        uint16x4_t sums[4];
+        for (int quarter = 0; quarter < 4; quarter++) {
+            int offset = 4 * x + 16 * quarter;
+            uint16x8_t pairs = vpaddlq_u8(vld1q_u8(rows[0] + offset));
+            pairs = vpadalq_u8(pairs, vld1q_u8(rows[1] + offset));
+            pairs = vpadalq_u8(pairs, vld1q_u8(rows[2] + offset));
+            pairs = vpadalq_u8(pairs, vld1q_u8(rows[3] + offset));
+            sums[quarter] = vmovn_u32(vpaddlq_u16(pairs));
+        }
+        uint8x8_t lo = vrshrn_n_u16(vcombine_u16(sums[0], sums[1]), 4);
+        uint8x8_t hi = vrshrn_n_u16(vcombine_u16(sums[2], sums[3]), 4);
+        vst1q_u8(dst + x, vcombine_u8(lo, hi));
+    }
+#elif OTK_FANOUT_SSE2
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i ones = _mm_set1_epi16(1);
+    const __m128i round = _mm_set1_epi32(8);
+    for (; x + 16 <= width; x += 16) {
+        __m128i sums[4];
+        for (int quarter = 0; quarter < 4; quarter++) {
+            int offset = 4 * x + 16 * quarter;
+            __m128i lo = zero;
+            __m128i hi = zero;
+            for (int row = 0; row < 4; row++) {
+                __m128i v = _mm_loadu_si128((const __m128i *)(rows[row] + offset));
+                lo = _mm_add_epi16(lo, _mm_unpacklo_epi8(v, zero));
+                hi = _mm_add_epi16(hi, _mm_unpackhi_epi8(v, zero));
+            }
+            __m128i pairs = _mm_packs_epi32(_mm_madd_epi16(lo, ones), _mm_madd_epi16(hi, ones));
+            __m128i blocks = _mm_madd_epi16(pairs, ones);
+            sums[quarter] = _mm_srli_epi32(_mm_add_epi32(blocks, round), 4);
+        }
+        __m128i lo = _mm_packs_epi32(sums[0], sums[1]);
+        __m128i hi = _mm_packs_epi32(sums[2], sums[3]);
+        _mm_storeu_si128((__m128i *)(dst + x), _mm_packus_epi16(lo, hi));
+    }
+#endif
+    for (; x < width; x++) {
+        int sum = 0;
+        for (int row = 0; row < 4; row++) {
+            const uint8_t *p = rows[row] + 4 * x;
+            sum += p[0] + p[1] + p[2] + p[3];
+        }
+        dst[x] = (uint8_t)((sum + 8) >> 4);
+    }
+}
+
+// Chroma rows hold interleaved U and V; width counts the pairs.
+static void downscale_chroma_row_2x(const uint8_t *r0, const uint8_t *r1, uint8_t *dst, int width) {
+    int x = 0;
+#if OTK_FANOUT_NEON
+    for (; x + 8 <= width; x += 8) {
+        // Even and odd pairs, each lane pair still U then V.
+        uint16x8x2_t a = vld2q_u16((const uint16_t *)(r0 + 4 * x));
+        uint16x8x2_t b = vld2q_u16((const uint16_t *)(r1 + 4 * x));
+        uint8x16_t a0 = vreinterpretq_u8_u16(a.val[0]);
+        uint8x16_t a1 = vreinterpretq_u8_u16(a.val[1]);
+        uint8x16_t b0 = vreinterpretq_u8_u16(b.val[0]);
+        uint8x16_t b1 = vreinterpretq_u8_u16(b.val[1]);
+        uint16x8_t lo = vaddl_u8(vget_low_u8(a0), vget_low_u8(a1));
+        uint16x8_t hi = vaddl_u8(vget_high_u8(a0), vget_high_u8(a1));
+        lo = vaddq_u16(lo, vaddl_u8(vget_low_u8(b0), vget_low_u8(b1)));
+        hi = vaddq_u16(hi, vaddl_u8(vget_high_u8(b0), vget_high_u8(b1)));
+        vst1q_u8(dst + 2 * x, vcombine_u8(vrshrn_n_u16(lo, 2), vrshrn_n_u16(hi, 2)));
+    }
+#elif OTK_FANOUT_SSE2
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i round = _mm_set1_epi16(2);
+    for (; x + 8 <= width; x += 8) {
+        __m128i sums[2];
+        for (int half = 0; half < 2; half++) {
+            __m128i a = _mm_loadu_si128((const __m128i *)(r0 + 4 * x + 16 * half));
+            __m128i b = _mm_loadu_si128((const __m128i *)(r1 + 4 * x + 16 * half));
+            // Column sums of four pairs each, as U V U V ... in 16 bits.
+            __m128i lo = _mm_add_epi16(_mm_unpacklo_epi8(a, zero), _mm_unpacklo_epi8(b, zero));
+            __m128i hi = _mm_add_epi16(_mm_unpackhi_epi8(a, zero), _mm_unpackhi_epi8(b, zero));
+            // Adds the odd pair of each 64 bits to the even one, then keeps
+            // the even ones.
+            lo = _mm_add_epi16(lo, _mm_srli_epi64(lo, 32));
+            hi = _mm_add_epi16(hi, _mm_srli_epi64(hi, 32));
+            lo = _mm_shuffle_epi32(lo, _MM_SHUFFLE(3, 1, 2, 0));
+            hi = _mm_shuffle_epi32(hi, _MM_SHUFFLE(3, 1, 2, 0));
+            sums[half] = _mm_srli_epi16(_mm_add_epi16(_mm_unpacklo_epi64(lo, hi), round), 2);
+        }
+        _mm_storeu_si128((__m128i *)(dst + 2 * x), _mm_packus_epi16(sums[0], sums[1]));
+    }
+#endif
+    for (; x < width; x++) {
+        for (int c = 0; c < 2; c++) {
+            int sum = r0[4 * x + c] + r0[4 * x + 2 + c] + r1[4 * x + c] + r1[4 * x + 2 + c];
+            dst[2 * x + c] = (uint8_t)((sum + 2) >> 2);
+        }
+    }
+}
+
+static void downscale_chroma_row_4x(const uint8_t *const rows[4], uint8_t *dst, int width) {
+    int x = 0;
+#if OTK_FANOUT_NEON
+    for (; x + 8 <= width; x += 8) {
+        uint16x8_t lo = vdupq_n_u16(0);
+        uint16x8_t hi = vdupq_n_u16(0);
+        for (int row = 0; row < 4; row++) {
+            // Pairs 4n, 4n + 1, 4n + 2 and 4n + 3 of eight blocks.
+            uint16x8x4_t v = vld4q_u16((const uint16_t *)(rows[row] + 8 * x));
+            for (int k = 0; k < 4; k++) {
+                uint8x16_t bytes = vreinterpretq_u8_u16(v.val[k]);
+                lo = vaddw_u8(lo, vget_low_u8(bytes));
+                hi = vaddw_u8(hi, vget_high_u8(bytes));
+            }
+        }
+        vst1q_u8(dst + 2 * x, vcombine_u8(vrshrn_n_u16(lo, 4), vrshrn_n_u16(hi, 4)));
+    }
+#elif OTK_FANOUT_SSE2
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i round = _mm_set1_epi16(8);
+    for (; x + 8 <= width; x += 8) {
+        __m128i blocks[4];
+        for (int quarter = 0; quarter < 4; quarter++) {
+            int offset = 8 * x + 16 * quarter;
+            __m128i lo = zero;
+            __m128i hi = zero;
+            for (int row = 0; row < 4; row++) {
+                __m128i v = _mm_loadu_si128((const __m128i *)(rows[row] + offset));
+                lo = _mm_add_epi16(lo, _mm_unpacklo_epi8(v, zero));
+                hi = _mm_add_epi16(hi, _mm_unpackhi_epi8(v, zero));
+            }
+            // Four pairs in each: add the odd pairs, then the upper halves.
+            lo = _mm_add_epi16(lo, _mm_srli_epi64(lo, 32));
+            hi = _mm_add_epi16(hi, _mm_srli_epi64(hi, 32));
+            lo = _mm_add_epi16(lo, _mm_srli_si128(lo, 8));
+            hi = _mm_add_epi16(hi, _mm_srli_si128(hi, 8));
+            blocks[quarter] = _mm_unpacklo_epi32(lo, hi);
+        }
+        __m128i lo = _mm_srli_epi16(_mm_add_epi16(_mm_unpacklo_epi64(blocks[0], blocks[1]), round), 4);
+        __m128i hi = _mm_srli_epi16(_mm_add_epi16(_mm_unpacklo_epi64(blocks[2], blocks[3]), round), 4);
+        _mm_storeu_si128((__m128i *)(dst + 2 * x), _mm_packus_epi16(lo, hi));
+    }
+#endif
+    for (; x < width; x++) {
+        for (int c = 0; c < 2; c++) {
+            int sum = 0;
+            for (int row = 0; row < 4; row++) {
+                const uint8_t *p = rows[row] + 8 * x + c;
+                sum += p[0] + p[2] + p[4] + p[6];
+            }
+            dst[2 * x + c] = (uint8_t)((sum + 8) >> 4);
+        }
+    }
+}
+
+// Box-filters a plane by factor, 2 or 4; width is in pixels for luma and
+// in pairs for chroma.
+static void downscale_plane(const uint8_t *src, int src_stride, uint8_t *dst, int dst_stride,
+                            int width, int height, int factor, bool chroma) {
+    for (int y = 0; y < height; y++) {
+        const uint8_t *row = src + (size_t)y * factor * src_stride;
+        uint8_t *out = dst + (size_t)y * dst_stride;
+        if (factor == 2) {
+            if (chroma) {
+                downscale_chroma_row_2x(row, row + src_stride, out, width);
+            } else {
+                downscale_luma_row_2x(row, row + src_stride, out, width);
+            }
+        } else {
+            const uint8_t *rows[4] = {
+                row, row + src_stride, row + 2 * src_stride, row + 3 * src_stride
+            };
+            if (chroma) {
+                downscale_chroma_row_4x(rows, out, width);
+            } else {
+                downscale_luma_row_4x(rows, out, width);
+            }
+        }
+    }
+}
+
+static otk_fanout_buffer *take_pooled_buffer(otk_capture_fanout *fanout, uint32_t width, uint32_t height) {
+    uint64_t key = ((uint64_t)width << 32) | height;
+    pool_entry &entry = fanout->pools[key];
+    if (!entry.pool) {
+        entry.pool = std::make_shared<buffer_pool>();
+    }
+    entry.last_used = fanout->stats.frames_in;
+    otk_fanout_buffer *buffer = nullptr;
+    {
+        std::lock_guard<std::mutex> guard(entry.pool->lock);
+        if (!entry.pool->free.empty()) {
+            buffer = entry.pool->free.back();
+            entry.pool->free.pop_back();
+        }
+    }
+    if (buffer == nullptr) {
+        buffer = new otk_fanout_buffer();
+        buffer->width = width;
+        buffer->height = height;
+        buffer->storage.resize((size_t)width * height + (size_t)width * (height / 2));
+        buffer->planes[0] = buffer->storage.data();
+        buffer->planes[1] = buffer->storage.data() + (size_t)width * height;
+        buffer->strides[0] = (int)width;
+        buffer->strides[1] = (int)width;
+        fanout->stats.buffers_allocated++;
+    }
+    buffer->references.store(1, std::memory_order_relaxed);
+    buffer->pool = entry.pool;
+    return buffer;
+}
+
+static otk_fanout_buffer *scale_frame(otk_capture_fanout *fanout, const otk_fanout_buffer *source,
+                                      uint32_t factor, uint32_t width, uint32_t height) {
+    otk_fanout_buffer *scaled = take_pooled_buffer(fanout, width, height);
+    auto start = std::chrono::steady_clock::now();
+    uint8_t *luma = scaled->storage.data();
+    uint8_t *chroma = luma + (size_t)width * height;
+    downscale_plane(source->planes[0], source->strides[0], luma, scaled->strides[0],
+                    (int)width, (int)height, (int)factor, false);
+    downscale_plane(source->planes[1], source->strides[1], chroma, scaled->strides[1],
+                    (int)width / 2, (int)height / 2, (int)factor, true);
+    fanout->stats.scales++;
+    fanout->stats.scale_us += std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::steady_clock::now() - start).count();
+    return scaled;
+}
+
+static void prune_pools(otk_capture_fanout *fanout) {
+    for (auto entry = fanout->pools.begin(); entry != fanout->pools.end();) {
+        if (fanout->stats.frames_in - entry->second.last_used > kPoolIdleFrames) {
+            close_pool(*entry->second.pool);
+            entry = fanout->pools.erase(entry);
+        } else {
+            ++entry;
+        }
+    }
+}
+
+void otk_capture_fanout_push(otk_capture_fanout *fanout, otk_fanout_buffer *buffer,
+                             int64_t timestamp_us, const uint8_t *metadata, size_t metadata_size) {
+    if (fanout == nullptr || buffer == nullptr) {
+        return;
+    }
+    std::vector<delivery> deliveries;
+    std::unique_lock<std::mutex> guard(fanout->lock);
+    deliveries.reserve(fanout->consumers.size());
+    fanout->stats.frames_in++;
+    fanout->scaled.clear();
+    for (auto &entry : fanout->consumers) {
+        consumer &target = entry.second;
+        if (!target.active) {
+            continue;
+        }
+        uint32_t factor = select_factor(buffer->width, buffer->height,
+                                        target.max_width, target.max_height);
+        uint32_t width, height;
+        scaled_size(buffer->width, buffer->height, factor, &width, &height);
+        target.stats.width = width;
+        target.stats.height = height;
+        if (!take_frame(target, timestamp_us)) {
+            target.stats.frames_decimated++;
+            continue;
+        }
+        otk_fanout_buffer *delivered = nullptr;
+        if (factor == 1) {
+            delivered = buffer;
+            target.stats.frames_shared++;
+        } else {
+            for (const scaled_frame &done : fanout->scaled) {
+                if (done.width == width && done.height == height) {
+                    delivered = done.buffer;
+                    break;
+                }
+            }
+            if (delivered == nullptr) {
+                delivered = scale_frame(fanout, buffer, factor, width, height);
+                fanout->scaled.push_back({width, height, delivered});
+            }
+            target.stats.frames_scaled++;
+        }
+        otk_fanout_frame frame = {};
+        frame.width = delivered->width;
+        frame.height = delivered->height;
+        for (int i = 0; i < 2; i++) {
+            frame.planes[i] = delivered->planes[i];
+            frame.strides[i] = delivered->strides[i];
+        }
+        frame.timestamp_us = timestamp_us;
+        frame.metadata = metadata;
+        frame.metadata_size = metadata_size;
+        otk_fanout_buffer_retain(delivered);
+        deliveries.push_back({entry.first, frame, delivered});
+    }
+    for (const scaled_frame &done : fanout->scaled) {
+        otk_fanout_buffer_release(done.buffer);
+    }
+    fanout->scaled.clear();
+    prune_pools(fanout);
+
+    // The callbacks run without the lock, so a slow consumer does not hold
+    // up the others' settings and stats, and a callback may call back in.
+    // A consumer removed in the meantime is skipped.
+    std::thread::id self = std::this_thread::get_id();
+    for (const delivery &pending : deliveries) {
+        auto found = fanout->consumers.find(pending.consumer);
+        if (found != fanout->consumers.end() && found->second.active) {
+            otk_fanout_deliver deliver = found->second.deliver;
+            void *user_data = found->second.user_data;
+            fanout->running.push_back({pending.consumer, self});
+            guard.unlock();
+            deliver(&pending.frame, pending.buffer, user_data);
+            guard.lock();
+            auto running = std::find_if(fanout->running.begin(), fanout->running.end(),
+                                        [&](const running_delivery &entry) {
+                                            return entry.consumer == pending.consumer &&
+                                                   entry.thread == self;
+                                        });
+            fanout->running.erase(running);
+            fanout->delivered.notify_all();
+            found = fanout->consumers.find(pending.consumer);
+            if (found != fanout->consumers.end()) {
+                found->second.stats.frames_delivered++;
+            }
+        }
+        otk_fanout_buffer_release(pending.buffer);
+    }
+}
+
+int otk_capture_fanout_get_consumer_stats(otk_capture_fanout *fanout, int consumer,
+                                          otk_fanout_consumer_stats *stats) {
+    if (fanout == nullptr || stats == nullptr) {
+        return 0;
+    }
+    std::lock_guard<std::mutex> guard(fanout->lock);
+    auto found = fanout->consumers.find(consumer);
+    if (found == fanout->consumers.end()) {
+        return 0;
+    }
+    *stats = found->second.stats;
+    return 1;
+}
+
+void otk_capture_fanout_get_stats(otk_capture_fanout *fanout, otk_fanout_stats *stats) {
+    if (fanout == nullptr || stats == nullptr) {
+        return;
+    }
+    std::lock_guard<std::mutex> guard(fanout->lock);
+    *stats = fanout->stats;
+}
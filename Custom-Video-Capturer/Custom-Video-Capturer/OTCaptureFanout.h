@@ -0,0 +1,154 @@
+//
+//  OTCaptureFanout.h
+//  Custom-Video-Capturer
+//
+//  Copyright (c) 2026 Vonage. All rights reserved.
+//
+
+#ifndef OTCaptureFanout_h
+#define OTCaptureFanout_h
+
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * Fans the frames of one capture source out to several consumers, such as
+ * the video capturers of two publishers sharing a camera.
+ *
+ * Each consumer asks for a largest size and a highest frame rate. Frames
+ * are dropped per consumer to keep under its rate, judged on their
+ * timestamps, and reduced by the smallest power of two that fits its size,
+ * with a box filter using SSE2 or NEON when available. A consumer whose
+ * size the source already fits gets the source buffer itself; consumers
+ * that need the same reduction share one scaled buffer, so a frame is
+ * scaled once per size whatever the number of consumers.
+ *
+ * Buffers are reference counted. A consumer that keeps a frame past its
+ * callback, as the SDK does with the frames a capturer provides, retains
+ * the buffer and releases it when done. Scaled buffers go back to a pool
+ * of their size once released.
+ *
+ * Frames are NV12. Plain C++, independent of AVFoundation and the SDK.
+ */
+typedef struct otk_capture_fanout otk_capture_fanout;
+typedef struct otk_fanout_buffer otk_fanout_buffer;
+
+/** Largest reduction; consumers asking for less get a quarter of the source. */
+#define OTK_CAPTURE_FANOUT_MAX_FACTOR 4
+
+/** An NV12 frame: a luma plane and an interleaved chroma plane. */
+typedef struct otk_fanout_frame {
+    uint32_t width;
+    uint32_t height;
+    const uint8_t *planes[2];
+    int strides[2];
+    int64_t timestamp_us;
+    /** Valid during the deliver callback only. */
+    const uint8_t *metadata;
+    size_t metadata_size;
+} otk_fanout_frame;
+
+/**
+ * Receives a frame for a consumer. buffer holds the planes and is only
+ * borrowed; retain it to use the planes after returning.
+ */
+typedef void (*otk_fanout_deliver)(const otk_fanout_frame *frame, otk_fanout_buffer *buffer,
+                                   void *user_data);
+
+typedef void (*otk_fanout_buffer_free)(void *context);
+
+typedef struct otk_fanout_consumer_stats {
+    uint32_t width;
+    uint32_t height;
+    uint64_t frames_delivered;
+    /** Frames dropped to keep under the consumer's frame rate. */
+    uint64_t frames_decimated;
+    /** Frames delivered in the source buffer, without a copy. */
+    uint64_t frames_shared;
+    uint64_t frames_scaled;
+} otk_fanout_consumer_stats;
+
+typedef struct otk_fanout_stats {
+    uint64_t frames_in;
+    /** Scaled buffers made, at most one per size and frame. */
+    uint64_t scales;
+    int64_t scale_us;
+    /** Scaled buffers allocated rather than taken from a pool. */
+    uint64_t buffers_allocated;
+    uint32_t consumers;
+} otk_fanout_stats;
+
+/**
+ * Wraps planes owned by the caller in a buffer with one reference, calling
+ * free with context once the last is released.
+ */
+otk_fanout_buffer *otk_fanout_buffer_wrap(uint32_t width, uint32_t height,
+                                          const uint8_t *const planes[2], const int strides[2],
+                                          otk_fanout_buffer_free free, void *context);
+
+void otk_fanout_buffer_retain(otk_fanout_buffer *buffer);
+
+/** Safe from any thread, also after the fanout was deleted. */
+void otk_fanout_buffer_release(otk_fanout_buffer *buffer);
+
+/** Plane 0 is luma, 1 interleaved chroma. NULL for any other plane. */
+const uint8_t *otk_fanout_buffer_plane(const otk_fanout_buffer *buffer, int plane);
+
+int otk_fanout_buffer_stride(const otk_fanout_buffer *buffer, int plane);
+
+otk_capture_fanout *otk_capture_fanout_new(void);
+
+/** Buffers still held by consumers stay valid until they release them. */
+void otk_capture_fanout_delete(otk_capture_fanout *fanout);
+
+/**
+ * Adds a consumer getting frames no larger than max_width by max_height,
+ * 0 for no limit, at no more than max_frame_rate, 0 for every frame. It
+ * starts inactive. Returns its id.
+ */
+int otk_capture_fanout_add_consumer(otk_capture_fanout *fanout,
+                                    uint32_t max_width, uint32_t max_height, double max_frame_rate,
+                                    otk_fanout_deliver deliver, void *user_data);
+
+/**
+ * Once it returns the consumer's callback is not running and is not called
+ * again. May be called from a deliver callback, including the consumer's
+ * own, in which case that call returns first.
+ */
+void otk_capture_fanout_remove_consumer(otk_capture_fanout *fanout, int consumer);
+
+/** Frames are only delivered to active consumers. */
+void otk_capture_fanout_set_active(otk_capture_fanout *fanout, int consumer, int active);
+
+/**
+ * Size the consumer gets frames of from a source of source_width by
+ * source_height: the source itself if it fits the limits, otherwise the
+ * source divided by 2 or 4 and rounded down to even dimensions.
+ */
+void otk_capture_fanout_output_size(uint32_t source_width, uint32_t source_height,
+                                    uint32_t max_width, uint32_t max_height,
+                                    uint32_t *width, uint32_t *height);
+
+/**
+ * Delivers a source frame to the active consumers, from the capture thread.
+ * The callbacks run one after another without the fanout's lock held. The
+ * caller keeps its reference on buffer and releases it afterwards.
+ */
+void otk_capture_fanout_push(otk_capture_fanout *fanout, otk_fanout_buffer *buffer,
+                             int64_t timestamp_us, const uint8_t *metadata, size_t metadata_size);
+
+/** Returns 0 if there is no such consumer. */
+int otk_capture_fanout_get_consumer_stats(otk_capture_fanout *fanout, int consumer,
+                                          otk_fanout_consumer_stats *stats);
+
+void otk_capture_fanout_get_stats(otk_capture_fanout *fanout, otk_fanout_stats *stats);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* OTCaptureFanout_h */
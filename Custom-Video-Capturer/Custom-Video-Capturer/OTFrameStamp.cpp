@@ -0,0 +1,214 @@
+//
+//  OTFrameStamp.cpp
+//  Custom-Video-Capturer
+//
+//  Copyright (c) 2026 Vonage. All rights reserved.
+//
+
+#include "OTFrameStamp.h"
+
+#include <algorithm>
+#include <chrono>
+#include <mutex>
+#include <vector>
+
+// "OTF" followed by the encoding version.
+static const uint8_t kStampMagic[3] = { 'O', 'T', 'F' };
+static const uint8_t kStampVersion = 1;
+
+// A jump forward bigger than this is treated as a publisher restart rather
+// than as lost frames.
+static const int32_t kMaxSequenceGap = 1000;
+
+static void put_le32(uint8_t *p, uint32_t v) {
+    p[0] = (uint8_t)v;
+    p[1] = (uint8_t)(v >> 8);
+    p[2] = (uint8_t)(v >> 16);
+    p[3] = (uint8_t)(v >> 24);
+}
+
+static uint32_t get_le32(const uint8_t *p) {
+    return (uint32_t)p[0] | ((uint32_t)p[1] << 8) |
+        ((uint32_t)p[2] << 16) | ((uint32_t)p[3] << 24);
+}
+
+uint64_t otk_frame_stamp_now_us(void) {
+    return (uint64_t)std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+size_t otk_frame_stamp_encode(const otk_frame_stamp *stamp,
+                              uint8_t *buffer,
+                              size_t size) {
+    if (stamp == nullptr || buffer == nullptr || size < OTK_FRAME_STAMP_SIZE) {
+        return 0;
+    }
+    buffer[0] = kStampMagic[0];
+    buffer[1] = kStampMagic[1];
+    buffer[2] = kStampMagic[2];
+    buffer[3] = kStampVersion;
+    put_le32(buffer + 4, stamp->publisher_id);
+    put_le32(buffer + 8, stamp->sequence);
+    put_le32(buffer + 12, (uint32_t)stamp->capture_time_us);
+    put_le32(buffer + 16, (uint32_t)(stamp->capture_time_us >> 32));
+    return OTK_FRAME_STAMP_SIZE;
+}
+
+int otk_frame_stamp_decode(const uint8_t *buffer,
+                           size_t size,
+                           otk_frame_stamp *stamp) {
+    if (buffer == nullptr || stamp == nullptr || size < OTK_FRAME_STAMP_SIZE) {
+        return 0;
+    }
+    if (buffer[0] != kStampMagic[0] || buffer[1] != kStampMagic[1] ||
+        buffer[2] != kStampMagic[2] || buffer[3] != kStampVersion) {
+        return 0;
+    }
+    stamp->publisher_id = get_le32(buffer + 4);
+    stamp->sequence = get_le32(buffer + 8);
+    stamp->capture_time_us = (uint64_t)get_le32(buffer + 12) |
+        ((uint64_t)get_le32(buffer + 16) << 32);
+    return 1;
+}
+
+struct otk_frame_latency_tracker {
+    std::mutex lock;
+
+    // Ring of the most recent latencies.
+    std::vector<int64_t> latencies;
+    size_t next_latency;
+    size_t latency_count;
+
+    // Sequence tracking. Bit i of received_mask is set when frame
+    // highest_sequence - i has been seen.
+    bool has_sequence;
+    uint32_t publisher_id;
+    uint32_t highest_sequence;
+    uint64_t received_mask;
+
+    uint64_t frames_received;
+    uint64_t frames_lost;
+    uint64_t frames_reordered;
+    uint64_t frames_duplicated;
+};
+
+static void reset_sequence(otk_frame_latency_tracker *tracker,
+                           const otk_frame_stamp *stamp) {
+    tracker->has_sequence = true;
+    tracker->publisher_id = stamp->publisher_id;
+    tracker->highest_sequence = stamp->sequence;
+    tracker->received_mask = 1;
+}
+
+static void track_sequence(otk_frame_latency_tracker *tracker,
+                           const otk_frame_stamp *stamp) {
+    if (!tracker->has_sequence || tracker->publisher_id != stamp->publisher_id) {
+        reset_sequence(tracker, stamp);
+        return;
+    }
+    int32_t diff = (int32_t)(stamp->sequence - tracker->highest_sequence);
+    if (diff > kMaxSequenceGap || diff < -kMaxSequenceGap) {
+        reset_sequence(tracker, stamp);
+    } else if (diff > 0) {
+        tracker->frames_lost += (uint64_t)(diff - 1);
+        tracker->received_mask = diff >= 64 ? 0 : tracker->received_mask << diff;
+        tracker->received_mask |= 1;
+        tracker->highest_sequence = stamp->sequence;
+    } else if (diff == 0) {
+        tracker->frames_duplicated++;
+    } else {
+        int back = -diff;
+        if (back < 64 && (tracker->received_mask & (1ull << back))) {
+            tracker->frames_duplicated++;
+            return;
+        }
+        if (back < 64) {
+            tracker->received_mask |= (1ull << back);
+        }
+        // It was counted as lost when the sequence jumped over it.
+        tracker->frames_reordered++;
+        if (tracker->frames_lost > 0) {
+            tracker->frames_lost--;
+        }
+    }
+}
+
+static int64_t percentile(const std::vector<int64_t> &sorted, int pct) {
+    if (sorted.empty()) {
+        return 0;
+    }
+    size_t index = (sorted.size() - 1) * (size_t)pct / 100;
+    return sorted[index];
+}
+
+otk_frame_latency_tracker *otk_frame_latency_tracker_new(uint32_t window_size) {
+    otk_frame_latency_tracker *tracker = new otk_frame_latency_tracker();
+    tracker->latencies.resize(window_size > 0 ? window_size : 1);
+    otk_frame_latency_tracker_reset(tracker);
+    return tracker;
+}
+
+void otk_frame_latency_tracker_delete(otk_frame_latency_tracker *tracker) {
+    delete tracker;
+}
+
+void otk_frame_latency_tracker_reset(otk_frame_latency_tracker *tracker) {
+    std::lock_guard<std::mutex> guard(tracker->lock);
+    tracker->next_latency = 0;
+    tracker->latency_count = 0;
+    tracker->has_sequence = false;
+    tracker->publisher_id = 0;
+    tracker->highest_sequence = 0;
+    tracker->received_mask = 0;
+    tracker->frames_received = 0;
+    tracker->frames_lost = 0;
+    tracker->frames_reordered = 0;
+    tracker->frames_duplicated = 0;
+}
+
+void otk_frame_latency_tracker_add(otk_frame_latency_tracker *tracker,
+                                   const otk_frame_stamp *stamp,
+                                   uint64_t present_time_us) {
+    if (tracker == nullptr || stamp == nullptr) {
+        return;
+    }
+    std::lock_guard<std::mutex> guard(tracker->lock);
+    uint64_t duplicates = tracker->frames_duplicated;
+    track_sequence(tracker, stamp);
+    if (duplicates != tracker->frames_duplicated) {
+        return;
+    }
+    tracker->frames_received++;
+    tracker->latencies[tracker->next_latency] =
+        (int64_t)(present_time_us - stamp->capture_time_us);
+    tracker->next_latency = (tracker->next_latency + 1) % tracker->latencies.size();
+    tracker->latency_count = std::min(tracker->latency_count + 1,
+                                      tracker->latencies.size());
+}
+
+void otk_frame_latency_tracker_get_stats(otk_frame_latency_tracker *tracker,
+                                         otk_frame_latency_stats *stats) {
+    if (tracker == nullptr || stats == nullptr) {
+        return;
+    }
+    std::vector<int64_t> window;
+    {
+        std::lock_guard<std::mutex> guard(tracker->lock);
+        stats->frames_received = tracker->frames_received;
+        stats->frames_lost = tracker->frames_lost;
+        stats->frames_reordered = tracker->frames_reordered;
+        stats->frames_duplicated = tracker->frames_duplicated;
+        window.assign(tracker->latencies.begin(),
+                      tracker->latencies.begin() + tracker->latency_count);
+    }
+    std::sort(window.begin(), window.end());
+    stats->window_samples = (uint32_t)window.size();
+    stats->latency_p50_us = percentile(window, 50);
+    stats->latency_p95_us = percentile(window, 95);
+    stats->latency_p99_us = percentile(window, 99);
+    stats->latency_max_us = window.empty() ? 0 : window.back();
+    int64_t floor = window.empty() ? 0 : window.front();
+    stats->relative_p50_us = stats->latency_p50_us - floor;
+    stats->relative_p95_us = stats->latency_p95_us - floor;
+    stats->relative_p99_us = stats->latency_p99_us - floor;
+}
@@ -0,0 +1,109 @@
+//
+//  OTFrameStamp.h
+//  Custom-Video-Capturer
+//
+//  Copyright (c) 2026 Vonage. All rights reserved.
+//
+
+#ifndef OTFrameStamp_h
+#define OTFrameStamp_h
+
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * Size in bytes of an encoded frame stamp. It fits comfortably in the
+ * frame metadata (see otc_video_frame_set_metadata).
+ */
+#define OTK_FRAME_STAMP_SIZE 20
+
+/**
+ * Header stamped into the metadata of every published frame when glass to
+ * glass measurement is enabled.
+ */
+typedef struct otk_frame_stamp {
+    /** Identifies the publisher that produced the frame. */
+    uint32_t publisher_id;
+    /** Increases by one for every captured frame. */
+    uint32_t sequence;
+    /** Monotonic capture time in microseconds (see otk_frame_stamp_now_us). */
+    uint64_t capture_time_us;
+} otk_frame_stamp;
+
+/**
+ * Latency, loss and reordering statistics for one stream.
+ * Latencies are in microseconds.
+ */
+typedef struct otk_frame_latency_stats {
+    uint64_t frames_received;
+    uint64_t frames_lost;
+    uint64_t frames_reordered;
+    uint64_t frames_duplicated;
+    /** Number of samples the percentiles below were computed from. */
+    uint32_t window_samples;
+    /**
+     * End to end latency. Only meaningful when publisher and subscriber share
+     * the same monotonic clock, i.e. they run on the same machine.
+     */
+    int64_t latency_p50_us;
+    int64_t latency_p95_us;
+    int64_t latency_p99_us;
+    int64_t latency_max_us;
+    /**
+     * Latency relative to the lowest latency seen in the window. The clock
+     * offset between machines cancels out, so this is valid across hosts.
+     */
+    int64_t relative_p50_us;
+    int64_t relative_p95_us;
+    int64_t relative_p99_us;
+} otk_frame_latency_stats;
+
+typedef struct otk_frame_latency_tracker otk_frame_latency_tracker;
+
+/** Monotonic clock used for the capture and presentation times. */
+uint64_t otk_frame_stamp_now_us(void);
+
+/**
+ * Encodes the stamp into buffer. Returns the number of bytes written or 0 if
+ * the buffer is smaller than OTK_FRAME_STAMP_SIZE.
+ */
+size_t otk_frame_stamp_encode(const otk_frame_stamp *stamp,
+                              uint8_t *buffer,
+                              size_t size);
+
+/**
+ * Decodes a stamp from frame metadata. Returns 1 on success, or 0 if the
+ * metadata was not produced by otk_frame_stamp_encode.
+ */
+int otk_frame_stamp_decode(const uint8_t *buffer,
+                           size_t size,
+                           otk_frame_stamp *stamp);
+
+/**
+ * Creates a tracker keeping the latency of the last window_size frames.
+ */
+otk_frame_latency_tracker *otk_frame_latency_tracker_new(uint32_t window_size);
+
+void otk_frame_latency_tracker_delete(otk_frame_latency_tracker *tracker);
+
+/**
+ * Records a frame presented at present_time_us. Safe to call from any thread.
+ */
+void otk_frame_latency_tracker_add(otk_frame_latency_tracker *tracker,
+                                   const otk_frame_stamp *stamp,
+                                   uint64_t present_time_us);
+
+void otk_frame_latency_tracker_get_stats(otk_frame_latency_tracker *tracker,
+                                         otk_frame_latency_stats *stats);
+
+void otk_frame_latency_tracker_reset(otk_frame_latency_tracker *tracker);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* OTFrameStamp_h */
@@ -11,8 +11,13 @@
 #import "OTMTLVideoRenderer.h"
 #import <Metal/Metal.h>
 #import <MetalKit/MetalKit.h>
+#include "OTFrameStamp.h"
 
 @interface OTMTLVideoView : OTBaseVideoView <MTKViewDelegate, OTVideoRender>
 
+/* Optional. Frames carrying an OTFrameStamp in their metadata are recorded
+ * here at the moment they are drawn. The view does not own the tracker. */
+@property (nonatomic, assign) otk_frame_latency_tracker *latencyTracker;
+
 @end
 
@@ -214,6 +214,19 @@
     
 }
 
+- (void)recordFrameStamp:(otc_video_frame *)frame {
+    otk_frame_latency_tracker *tracker = _latencyTracker;
+    if (tracker == NULL) {
+        return;
+    }
+    size_t size = 0;
+    const uint8_t *metadata = otc_video_frame_get_metadata(frame, &size);
+    otk_frame_stamp stamp;
+    if (otk_frame_stamp_decode(metadata, size, &stamp)) {
+        otk_frame_latency_tracker_add(tracker, &stamp, otk_frame_stamp_now_us());
+    }
+}
+
 - (void)mtkView:(MTKView *)view drawableSizeWillChange:(CGSize)size {
 }
 
@@ -239,6 +252,7 @@
         // the one used by |view|.
         //NSLog(@"Width: %d",otc_video_frame_get_width(frame));
         [_mlRenderer drawFrame:frame viewSize:view.frame.size];
+        [self recordFrameStamp:frame];
         otc_video_frame_delete(frame);
         frame = nil;
     }
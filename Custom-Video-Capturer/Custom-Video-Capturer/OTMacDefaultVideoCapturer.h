@@ -4,6 +4,8 @@
 #import <Foundation/Foundation.h>
 #import <AVFoundation/AVFoundation.h>
 #import "OTVideoKit.h"
+#include "OTStartupTimeline.h"
+#include "OTCaptureFanout.h"
 
 
 typedef NS_ENUM(int32_t, OTMacDefaultVideoCapturerErrorCode) {
@@ -62,8 +64,52 @@ typedef NS_ENUM(int32_t, OTMacDefaultVideoCapturerErrorCode) {
 @property (readonly) NSArray* availableCameraPositions;
 - (BOOL)toggleCameraPosition;
 
+/**
+ Opt-in. When enabled every captured frame carries an OTFrameStamp header
+ (publisher id, sequence number and capture time) in its metadata, so
+ subscribers can measure glass to glass latency.
+ */
+@property (nonatomic, assign) BOOL frameStampingEnabled;
+@property (nonatomic, assign) uint32_t frameStampPublisherId;
+
+/**
+ On by default. Picks the device format that covers the capture size at
+ the initial frame rate most cheaply (see OTCameraFormat.h) instead of
+ using a session preset, which may make the camera scale or crop. Falls
+ back to the preset when no format can be chosen.
+ */
+@property (nonatomic, assign) BOOL nativeFormatSelection;
+
+/**
+ Optional. When set, camera authorization, the capture session starting and
+ the first captured frame are marked on it.
+ */
+@property (nonatomic, assign) otk_startup_timeline *startupTimeline;
+
+/**
+ Optional. When set, captured frames are pushed to it instead of being
+ provided to otcVideoCapturer, so the publishers whose capturers consume
+ it share this camera (see OTVideoCaptureProxy).
+ */
+@property (nonatomic, assign) otk_capture_fanout *fanout;
+
 - (enum OTMacDefaultVideoCapturerErrorCode)captureError;
+/**
+ Asks for camera access and starts the capture session before the SDK
+ initializes the capturer, so it can run while the session connects.
+ Blocks until the camera is running or has failed; call it off the main
+ thread. initCapture then reuses the running session.
+ */
+- (BOOL)prewarmCapture;
+/** Stops a pre-warmed session the SDK never initialized. */
+- (void)cancelPrewarm;
 - (void)initCapture;
+/**
+ For a capturer shared through a fanout: the first publisher to acquire it
+ initializes and starts it, the last to release it stops and releases it.
+ */
+- (void)acquireSharedCapture;
+- (void)releaseSharedCapture;
 - (int32_t) startCapture;
 - (void) stopRunningAVCaptureSession;
 
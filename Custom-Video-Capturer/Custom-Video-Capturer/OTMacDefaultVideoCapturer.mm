@@ -3,6 +3,9 @@
 #import "OTVideoKit.h"
 #include <OpenTok/OpenTok.h>
 #import <CoreVideo/CoreVideo.h>
+#include "OTFrameStamp.h"
+#include "OTCameraFormat.h"
+#include <vector>
 
 #define kTimespanWithNoFramesBeforeRaisingAnError 20.0
 
@@ -30,6 +33,20 @@
     enum OTMacDefaultVideoCapturerErrorCode _captureErrorCode;
     
     BOOL isFirstFrame;
+    
+    uint32_t _frameStampSequence;
+    
+    // Set between initCapture and releaseCapture.
+    BOOL _initialized;
+    BOOL _firstFrameMarked;
+    BOOL _prewarmCancelled;
+    
+    // Locked from choosing its format until the session runs, so the
+    // session does not reconfigure it in between.
+    AVCaptureDevice *_formatLockedDevice;
+    
+    // Publishers holding the capture, when shared through a fanout.
+    uint32_t _sharedUsers;
 }
 
 @synthesize captureSession = _captureSession;
@@ -51,6 +68,7 @@
                       [OTVideoFormat videoFormatNV12WithWidth:_captureWidth
                                                        height:_captureHeight]];
         isFirstFrame = false;
+        _nativeFormatSelection = YES;
     }
     return self;
 }
@@ -159,14 +177,14 @@
                                objectAtIndex:0];
     
     CMTime bestDuration = firstRange.minFrameDuration;
-    double bestFrameRate = bestDuration.timescale / bestDuration.value;
+    double bestFrameRate = otk_camera_frame_rate(bestDuration.value, bestDuration.timescale);
     CMTime currentDuration;
     double currentFrameRate;
     for (AVFrameRateRange* range in
          _videoInput.device.activeFormat.videoSupportedFrameRateRanges)
     {
         currentDuration = range.minFrameDuration;
-        currentFrameRate = currentDuration.timescale / currentDuration.value;
+        currentFrameRate = otk_camera_frame_rate(currentDuration.value, currentDuration.timescale);
         if (currentFrameRate > bestFrameRate) {
             bestFrameRate = currentFrameRate;
         }
@@ -182,12 +200,7 @@
 
 - (double) activeFrameRate {
     CMTime minFrameDuration = _videoInput.device.activeVideoMinFrameDuration;
-    double framesPerSecond = 0;
-    if (minFrameDuration.timescale && minFrameDuration.value) {
-        framesPerSecond = minFrameDuration.timescale / minFrameDuration.value;
-    }
-    
-    return framesPerSecond;
+    return otk_camera_frame_rate(minFrameDuration.value, minFrameDuration.timescale);
 }
 
 - (AVFrameRateRange*)frameRateRangeForFrameRate:(double)frameRate {
@@ -403,7 +416,7 @@
                                                   object:nil];
     [self stopCapture];
 
-    
+    _initialized = NO;
     _captureSession = nil;
     _videoOutput = nil;
     _videoInput = nil;
@@ -490,6 +503,10 @@
     
     [_captureSession addInput:_videoInput];
     
+    if (_nativeFormatSelection && ![self selectNativeFormatForDevice:videoDevice]) {
+        NSLog(@"No native format chosen, using session preset %@", _capturePreset);
+    }
+    
     //-- Create the output for the capture session.
     _videoOutput = [[AVCaptureVideoDataOutput alloc] init];
     [_videoOutput setAlwaysDiscardsLateVideoFrames:YES];
@@ -517,6 +534,58 @@
 
     NSLog(@"About to run capture session");
     [_captureSession startRunning];
+    [_formatLockedDevice unlockForConfiguration];
+    _formatLockedDevice = nil;
+    otk_startup_timeline_mark(_startupTimeline, OTK_STARTUP_CAPTURE_READY, otk_startup_now_us());
+}
+
+- (BOOL)selectNativeFormatForDevice:(AVCaptureDevice *)device {
+    NSArray<AVCaptureDeviceFormat *> *deviceFormats = device.formats;
+    std::vector<otk_camera_format> formats;
+    for (NSUInteger i = 0; i < deviceFormats.count; i++) {
+        CMFormatDescriptionRef description = deviceFormats[i].formatDescription;
+        CMVideoDimensions dimensions = CMVideoFormatDescriptionGetDimensions(description);
+        for (AVFrameRateRange *range in deviceFormats[i].videoSupportedFrameRateRanges) {
+            formats.push_back({ (uint32_t)i, (uint32_t)dimensions.width, (uint32_t)dimensions.height,
+                                CMFormatDescriptionGetMediaSubType(description),
+                                range.minFrameRate, range.maxFrameRate });
+        }
+    }
+    // The size the preset would have given.
+    otk_camera_format_request request = { _captureWidth, _captureHeight,
+                                          OTK_MAC_DEFAULT_VIDEO_CAPTURE_INITIAL_FRAMERATE };
+    otk_camera_format_choice choice;
+    if (!otk_camera_format_select(formats.data(), formats.size(), &request, &choice)) {
+        return NO;
+    }
+    const otk_camera_format &selected = formats[choice.entry];
+    AVCaptureDeviceFormat *format = deviceFormats[selected.index];
+    
+    NSError *error;
+    if (![device lockForConfiguration:&error]) {
+        NSLog(@"Could not lock %@ to set its format: %@", device.localizedName, error);
+        return NO;
+    }
+    device.activeFormat = format;
+    // The range's own duration when running at its maximum, 29.97 is not 1/30.
+    CMTime duration = CMTimeMake(1000, (int32_t)llround(choice.frame_rate * 1000));
+    for (AVFrameRateRange *range in format.videoSupportedFrameRateRanges) {
+        if (choice.frame_rate >= range.maxFrameRate) {
+            duration = range.minFrameDuration;
+            break;
+        }
+    }
+    device.activeVideoMinFrameDuration = duration;
+    device.activeVideoMaxFrameDuration = duration;
+    _formatLockedDevice = device;
+    
+    NSLog(@"Capturing %ux%u at %.2f fps from format %@ for %ux%u at %.0f fps%s%s",
+          selected.width, selected.height, choice.frame_rate, format,
+          request.width, request.height, request.frame_rate,
+          choice.meets_resolution ? "" : ", below the requested size",
+          choice.meets_frame_rate ? "" : ", below the requested frame rate");
+    [self updateCaptureFormatWithWidth:selected.width height:selected.height];
+    return YES;
 }
 
 - (void)captureSessionError:(NSNotification *)notification {
@@ -528,16 +597,90 @@
     [self callDelegateOnError:err captureError:captureSessionError];
 }
 
+- (BOOL)prewarmCapture {
+    dispatch_sync(_capture_queue, ^{
+        self->_prewarmCancelled = NO;
+    });
+    // Waiting here instead of in setupAudioVideoSession keeps the capture
+    // queue free while the permission prompt is up.
+    if (@available(macOS 10.14, *)) {
+        AVAuthorizationStatus status = [AVCaptureDevice authorizationStatusForMediaType:AVMediaTypeVideo];
+        if (status == AVAuthorizationStatusNotDetermined) {
+            dispatch_semaphore_t answered = dispatch_semaphore_create(0);
+            [AVCaptureDevice requestAccessForMediaType:AVMediaTypeVideo completionHandler:^(BOOL granted) {
+                dispatch_semaphore_signal(answered);
+            }];
+            dispatch_semaphore_wait(answered, DISPATCH_TIME_FOREVER);
+            status = [AVCaptureDevice authorizationStatusForMediaType:AVMediaTypeVideo];
+        }
+        if (status != AVAuthorizationStatusAuthorized) {
+            otk_startup_timeline_fail(_startupTimeline, OTK_STARTUP_CAMERA_AUTHORIZED, otk_startup_now_us());
+            return NO;
+        }
+    }
+    otk_startup_timeline_mark(_startupTimeline, OTK_STARTUP_CAMERA_AUTHORIZED, otk_startup_now_us());
+    
+    __block BOOL running = NO;
+    dispatch_sync(_capture_queue, ^{
+        if (self->_captureSession == nil && !self->_prewarmCancelled) {
+            [self setupAudioVideoSession];
+        }
+        running = self->_captureSession.isRunning;
+    });
+    return running;
+}
+
+- (void)cancelPrewarm {
+    dispatch_sync(_capture_queue, ^{
+        // Also stops a pre-warm still waiting for camera access.
+        self->_prewarmCancelled = YES;
+        if (self->_initialized || self->_captureSession == nil) {
+            return;
+        }
+        [[NSNotificationCenter defaultCenter] removeObserver:self
+                                                        name:AVCaptureSessionRuntimeErrorNotification
+                                                      object:nil];
+        [self stopRunningAVCaptureSession];
+        self->_captureSession = nil;
+        self->_videoOutput = nil;
+        self->_videoInput = nil;
+    });
+}
+
 - (void)initCapture {
     // Changing all AVCaptureSession configuration calls from async to sync
     // fixes deadlocks causing from external capturer while default capturer
     // deallocating, and also setting framerate and resolution while executing
     // the session setup
+    otk_startup_timeline_mark(_startupTimeline, OTK_STARTUP_CAPTURE_INIT, otk_startup_now_us());
     dispatch_sync(_capture_queue, ^{
-        [self setupAudioVideoSession];
+        self->_initialized = YES;
+        // Already running if it was pre-warmed.
+        if (self->_captureSession == nil) {
+            [self setupAudioVideoSession];
+        }
     });
 }
 
+- (void)acquireSharedCapture {
+    @synchronized (self) {
+        if (_sharedUsers++ == 0) {
+            [self initCapture];
+            [self startCapture];
+        }
+    }
+}
+
+- (void)releaseSharedCapture {
+    @synchronized (self) {
+        if (_sharedUsers == 0 || --_sharedUsers > 0) {
+            return;
+        }
+        [self stopCapture];
+        [self releaseCapture];
+    }
+}
+
 - (void)initBlackFrameSender {
     _blackFrameTimer = dispatch_source_create(DISPATCH_SOURCE_TYPE_TIMER,
                                                      0, 0, _capture_queue);
@@ -579,6 +722,8 @@
             [self->_videoFrame.planes addPointer:yPlane];
             [self->_videoFrame.planes addPointer:uvPlane];
             
+            self->_videoFrame.metadata = self.frameStampingEnabled ? [self nextFrameStamp] : nil;
+            
             [self consumeFrame:self->_videoFrame];
         });
         
@@ -589,6 +734,24 @@
 
 - (void)consumeFrame:(OTVideoFrame*)objcFrame
 {
+    if (_fanout) {
+        // Copied, as the black frame is freed with the capture while the
+        // SDK may still hold frames of it. Four a second, 320x240.
+        uint32_t width = objcFrame.format.imageWidth;
+        uint32_t height = objcFrame.format.imageHeight;
+        size_t lumaSize = (size_t)width * height;
+        uint8_t *copy = static_cast<uint8_t *>(malloc(lumaSize * 3 / 2));
+        memcpy(copy, [objcFrame.planes pointerAtIndex:0], lumaSize);
+        memcpy(copy + lumaSize, [objcFrame.planes pointerAtIndex:1], lumaSize / 2);
+        const uint8_t *planes[2] = { copy, copy + lumaSize };
+        int strides[2] = { (int)width, (int)width };
+        otk_fanout_buffer *buffer = otk_fanout_buffer_wrap(width, height, planes, strides, free, copy);
+        otk_capture_fanout_push(_fanout, buffer, (int64_t)(CMTimeGetSeconds(objcFrame.timestamp) * 1000000.0),
+                                (const uint8_t *)objcFrame.metadata.bytes, objcFrame.metadata.length);
+        otk_fanout_buffer_release(buffer);
+        return;
+    }
+    
     enum otc_video_frame_format format = OTC_VIDEO_FRAME_FORMAT_UNKNOWN;
     if (objcFrame.format.pixelFormat == OTPixelFormatI420) {
         format = OTC_VIDEO_FRAME_FORMAT_YUV420P;
@@ -648,6 +811,7 @@ void consumeOBJCFrame_release(void *user_data) {
 }
 
 - (int32_t) startCapture {
+    _firstFrameMarked = NO;
     _capturing = YES;
     if (!_blackFrameTimer) {
         // Do no set timer if blackframe is being sent
@@ -733,22 +897,74 @@ didOutputSampleBuffer:(CMSampleBufferRef)sampleBuffer
     }
     if (self.noFramesCapturedTimer)
         [self invalidateNoFramesTimerSettingItUpAgain:NO];
+    if (!_firstFrameMarked) {
+        _firstFrameMarked = YES;
+        otk_startup_timeline_mark(_startupTimeline, OTK_STARTUP_FIRST_CAPTURED_FRAME, otk_startup_now_us());
+    }
 
     CMTime time = CMSampleBufferGetPresentationTimeStamp(sampleBuffer);
     CVImageBufferRef imageBuffer = CMSampleBufferGetImageBuffer(sampleBuffer);
    
     [self consumeImageBuffer:imageBuffer
                    timestamp:time
-                    metadata:nil];
+                    metadata:self.frameStampingEnabled ? [self nextFrameStamp] : nil];
     
 }
 
+- (NSData *)nextFrameStamp {
+    otk_frame_stamp stamp;
+    stamp.publisher_id = self.frameStampPublisherId;
+    stamp.sequence = _frameStampSequence++;
+    stamp.capture_time_us = otk_frame_stamp_now_us();
+    uint8_t buffer[OTK_FRAME_STAMP_SIZE];
+    size_t size = otk_frame_stamp_encode(&stamp, buffer, sizeof(buffer));
+    return [NSData dataWithBytes:buffer length:size];
+}
+
+static void releaseFanoutPixelBuffer(void *context) {
+    CVPixelBufferRef buffer = (CVPixelBufferRef)context;
+    CVPixelBufferUnlockBaseAddress(buffer, kCVPixelBufferLock_ReadOnly);
+    CVPixelBufferRelease(buffer);
+}
+
+// Hands the camera's buffer to the fanout's consumers without a copy; the
+// last of them to release it gives it back to the camera.
+- (BOOL)pushImageBuffer:(CVImageBufferRef)frame
+              timestamp:(CMTime)ts
+               metadata:(NSData* _Nullable)metadata {
+    uint32_t pixelFormat = CVPixelBufferGetPixelFormatType(frame);
+    if (pixelFormat != kCVPixelFormatType_420YpCbCr8BiPlanarVideoRange &&
+        pixelFormat != kCVPixelFormatType_420YpCbCr8BiPlanarFullRange) {
+        return NO;
+    }
+    CVPixelBufferRetain(frame);
+    CVPixelBufferLockBaseAddress(frame, kCVPixelBufferLock_ReadOnly);
+    const uint8_t *planes[2] = {
+        (const uint8_t *)CVPixelBufferGetBaseAddressOfPlane(frame, 0),
+        (const uint8_t *)CVPixelBufferGetBaseAddressOfPlane(frame, 1),
+    };
+    int strides[2] = {
+        (int)CVPixelBufferGetBytesPerRowOfPlane(frame, 0),
+        (int)CVPixelBufferGetBytesPerRowOfPlane(frame, 1),
+    };
+    otk_fanout_buffer *buffer = otk_fanout_buffer_wrap((uint32_t)CVPixelBufferGetWidth(frame),
+                                                       (uint32_t)CVPixelBufferGetHeight(frame),
+                                                       planes, strides, releaseFanoutPixelBuffer, frame);
+    otk_capture_fanout_push(_fanout, buffer, (int64_t)(CMTimeGetSeconds(ts) * 1000000.0),
+                            (const uint8_t *)metadata.bytes, metadata.length);
+    otk_fanout_buffer_release(buffer);
+    return YES;
+}
+
 - (BOOL)consumeImageBuffer:(CVImageBufferRef)frame
                  timestamp:(CMTime)ts
                   metadata:(NSData* _Nullable)metadata {
     if (!frame || CFGetTypeID(frame) != CVPixelBufferGetTypeID()) {
         return NO;
     }
+    if (_fanout) {
+        return [self pushImageBuffer:frame timestamp:ts metadata:metadata];
+    }
     
     BOOL success = YES;
     otc_video_frame *otc_frame = [OTVideoFrame convertPixelBufferToOTCFrame:frame];
@@ -0,0 +1,490 @@
+//
+//  OTSignalChannel.cpp
+//  Custom-Video-Capturer
+//
+//  Copyright (c) 2026 Vonage. All rights reserved.
+//
+
+#include "OTSignalChannel.h"
+
+#include <algorithm>
+#include <mutex>
+#include <random>
+#include <string>
+#include <string.h>
+#include <unordered_map>
+#include <vector>
+
+// "OTS" followed by the encoding version.
+static const uint8_t kBatchMagic[3] = { 'O', 'T', 'S' };
+static const uint8_t kBatchVersion = 1;
+// Magic, version and sender id.
+static const size_t kBatchHeaderSize = 8;
+// Longest varint written, for a 64 bit value.
+static const size_t kMaxVarintSize = 10;
+
+static const int64_t kDefaultWindowUs = 50000;
+
+// Rates are counted in buckets of a tenth of a second over the last second.
+static const int64_t kRateBucketUs = 100000;
+static const size_t kRateBuckets = 10;
+
+static const char kBase64Alphabet[] =
+    "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+
+namespace {
+
+struct pending_update {
+    std::string key;
+    std::vector<uint8_t> data;
+    int64_t queued_us;
+};
+
+struct handler {
+    otk_signal_channel_handler run = nullptr;
+    void *user_data = nullptr;
+};
+
+struct rate_counter {
+    int64_t bucket_ids[kRateBuckets] = {};
+    uint64_t counts[kRateBuckets] = {};
+
+    void add(int64_t now_us, uint64_t count) {
+        int64_t id = now_us / kRateBucketUs + 1;
+        size_t slot = (size_t)(id % (int64_t)kRateBuckets);
+        if (bucket_ids[slot] != id) {
+            bucket_ids[slot] = id;
+            counts[slot] = 0;
+        }
+        counts[slot] += count;
+    }
+
+    double per_second(int64_t now_us) const {
+        int64_t id = now_us / kRateBucketUs + 1;
+        uint64_t total = 0;
+        for (size_t i = 0; i < kRateBuckets; i++) {
+            if (bucket_ids[i] > id - (int64_t)kRateBuckets && bucket_ids[i] <= id) {
+                total += counts[i];
+            }
+        }
+        return (double)total * 1000000.0 / (double)(kRateBucketUs * (int64_t)kRateBuckets);
+    }
+};
+
+} // namespace
+
+struct otk_signal_channel {
+    std::string type;
+    int64_t window_us = kDefaultWindowUs;
+    // Largest batch before base64, so the encoded one fits a signal.
+    size_t max_batch_size = 0;
+    uint32_t sender_id = 0;
+    otk_signal_channel_send send = nullptr;
+    void *user_data = nullptr;
+
+    // Held while a batch is packed and sent, so batches go out in order.
+    std::mutex send_lock;
+
+    std::mutex lock;
+    std::vector<pending_update> pending;
+    // Position in pending of the update each coalesced key has queued.
+    std::unordered_map<std::string, size_t> coalesced;
+    int64_t batch_started_us = 0;
+    std::unordered_map<std::string, handler> handlers;
+    handler fallback;
+
+    otk_signal_channel_stats stats = {};
+    int64_t added_latency_total_us = 0;
+    uint64_t updates_sent = 0;
+    rate_counter update_rate;
+    rate_counter signal_rate;
+};
+
+static void put_le32(uint8_t *p, uint32_t v) {
+    p[0] = (uint8_t)v;
+    p[1] = (uint8_t)(v >> 8);
+    p[2] = (uint8_t)(v >> 16);
+    p[3] = (uint8_t)(v >> 24);
+}
+
+static uint32_t get_le32(const uint8_t *p) {
+    return (uint32_t)p[0] | ((uint32_t)p[1] << 8) |
+        ((uint32_t)p[2] << 16) | ((uint32_t)p[3] << 24);
+}
+
+static size_t varint_size(uint64_t v) {
+    size_t size = 1;
+    while (v >= 0x80) {
+        v >>= 7;
+        size++;
+    }
+    return size;
+}
+
+static void put_varint(std::vector<uint8_t> &out, uint64_t v) {
+    while (v >= 0x80) {
+        out.push_back((uint8_t)(v | 0x80));
+        v >>= 7;
+    }
+    out.push_back((uint8_t)v);
+}
+
+static bool get_varint(const uint8_t *&p, const uint8_t *end, uint64_t &v) {
+    v = 0;
+    for (unsigned shift = 0; shift < 64 && p < end; shift += 7) {
+        uint8_t byte = *p++;
+        v |= (uint64_t)(byte & 0x7F) << shift;
+        if ((byte & 0x80) == 0) {
+            return true;
+        }
+    }
+    return false;
+}
+
+static size_t encoded_update_size(const pending_update &update) {
+    return 1 + update.key.size() + varint_size(update.data.size()) + update.data.size();
+}
+
+static std::string base64_encode(const std::vector<uint8_t> &in) {
+    std::string out;
+    out.reserve((in.size() + 2) / 3 * 4);
+    size_t i = 0;
+    for (; i + 3 <= in.size(); i += 3) {
+        uint32_t v = ((uint32_t)in[i] << 16) | ((uint32_t)in[i + 1] << 8) | in[i + 2];
+        out.push_back(kBase64Alphabet[(v >> 18) & 0x3F]);
+        out.push_back(kBase64Alphabet[(v >> 12) & 0x3F]);
+        out.push_back(kBase64Alphabet[(v >> 6) & 0x3F]);
+        out.push_back(kBase64Alphabet[v & 0x3F]);
+    }
+    size_t left = in.size() - i;
+    if (left > 0) {
+        uint32_t v = (uint32_t)in[i] << 16;
+        if (left == 2) {
+            v |= (uint32_t)in[i + 1] << 8;
+        }
+        out.push_back(kBase64Alphabet[(v >> 18) & 0x3F]);
+        out.push_back(kBase64Alphabet[(v >> 12) & 0x3F]);
+        out.push_back(left == 2 ? kBase64Alphabet[(v >> 6) & 0x3F] : '=');
+        out.push_back('=');
+    }
+    return out;
+}
+
+static int base64_value(char c) {
+    if (c >= 'A' && c <= 'Z') return c - 'A';
+    if (c >= 'a' && c <= 'z') return c - 'a' + 26;
+    if (c >= '0' && c <= '9') return c - '0' + 52;
+    if (c == '+') return 62;
+    if (c == '/') return 63;
+    return -1;
+}
+
+static bool base64_decode(const char *in, size_t size, std::vector<uint8_t> &out) {
+    if (size % 4 != 0) {
+        return false;
+    }
+    out.clear();
+    out.reserve(size / 4 * 3);
+    for (size_t i = 0; i < size; i += 4) {
+        bool last = i + 4 == size;
+        int padding = last ? (in[i + 3] == '=') + (in[i + 2] == '=') : 0;
+        if (padding == 1 && in[i + 2] == '=') {
+            return false;
+        }
+        uint32_t v = 0;
+        for (int j = 0; j < 4 - padding; j++) {
+            int value = base64_value(in[i + j]);
+            if (value < 0) {
+                return false;
+            }
+            v |= (uint32_t)value << (18 - 6 * j);
+        }
+        out.push_back((uint8_t)(v >> 16));
+        if (padding < 2) {
+            out.push_back((uint8_t)(v >> 8));
+        }
+        if (padding < 1) {
+            out.push_back((uint8_t)v);
+        }
+    }
+    return true;
+}
+
+static void start_batch(std::vector<uint8_t> &batch, uint32_t sender_id) {
+    batch.assign(kBatchMagic, kBatchMagic + sizeof(kBatchMagic));
+    batch.push_back(kBatchVersion);
+    batch.resize(kBatchHeaderSize);
+    put_le32(batch.data() + 4, sender_id);
+}
+
+// Packs the updates into as few batches as fit a signal, in order. Called
+// with the send lock held.
+static std::vector<std::string> pack(otk_signal_channel *channel,
+                                     const std::vector<pending_update> &updates,
+                                     std::vector<const pending_update *> &packed) {
+    std::vector<std::string> signals;
+    std::vector<uint8_t> batch;
+    std::vector<uint8_t> body;
+    size_t count = 0;
+    auto finish = [&]() {
+        if (count == 0) {
+            return;
+        }
+        start_batch(batch, channel->sender_id);
+        put_varint(batch, count);
+        batch.insert(batch.end(), body.begin(), body.end());
+        signals.push_back(base64_encode(batch));
+        body.clear();
+        count = 0;
+    };
+    for (const pending_update &update : updates) {
+        size_t size = encoded_update_size(update);
+        if (kBatchHeaderSize + kMaxVarintSize + size > channel->max_batch_size) {
+            continue;
+        }
+        if (kBatchHeaderSize + kMaxVarintSize + body.size() + size > channel->max_batch_size) {
+            finish();
+        }
+        body.push_back((uint8_t)update.key.size());
+        body.insert(body.end(), update.key.begin(), update.key.end());
+        put_varint(body, update.data.size());
+        body.insert(body.end(), update.data.begin(), update.data.end());
+        packed.push_back(&update);
+        count++;
+    }
+    finish();
+    return signals;
+}
+
+// Sends the queued updates. Called with the send lock held.
+static void send_pending(otk_signal_channel *channel, int64_t now_us) {
+    std::vector<pending_update> updates;
+    {
+        std::lock_guard<std::mutex> guard(channel->lock);
+        updates.swap(channel->pending);
+        channel->coalesced.clear();
+    }
+    if (updates.empty()) {
+        return;
+    }
+    std::vector<const pending_update *> packed;
+    std::vector<std::string> signals = pack(channel, updates, packed);
+
+    uint64_t sent = 0;
+    uint64_t failed = 0;
+    uint64_t bytes = 0;
+    for (const std::string &signal : signals) {
+        if (channel->send(channel->type.c_str(), signal.c_str(), channel->user_data)) {
+            sent++;
+            bytes += signal.size();
+        } else {
+            failed++;
+        }
+    }
+
+    std::lock_guard<std::mutex> guard(channel->lock);
+    otk_signal_channel_stats &stats = channel->stats;
+    stats.updates_dropped += updates.size() - packed.size();
+    stats.signals_sent += sent;
+    stats.send_failures += failed;
+    stats.bytes_sent += bytes;
+    channel->signal_rate.add(now_us, sent);
+    for (const pending_update *update : packed) {
+        int64_t latency_us = std::max<int64_t>(now_us - update->queued_us, 0);
+        channel->added_latency_total_us += latency_us;
+        stats.added_latency_max_us = std::max(stats.added_latency_max_us, latency_us);
+    }
+    channel->updates_sent += packed.size();
+}
+
+otk_signal_channel *otk_signal_channel_new(const otk_signal_channel_config *config,
+                                           otk_signal_channel_send send, void *user_data) {
+    if (config == nullptr || config->type == nullptr || config->type[0] == '\0' || send == nullptr) {
+        return nullptr;
+    }
+    otk_signal_channel *channel = new otk_signal_channel();
+    channel->type = config->type;
+    if (config->window_us > 0) {
+        channel->window_us = config->window_us;
+    }
+    size_t max_signal_size = OTK_SIGNAL_CHANNEL_MAX_SIGNAL_SIZE;
+    if (config->max_signal_size > 0) {
+        max_signal_size = std::min(config->max_signal_size, max_signal_size);
+    }
+    channel->max_batch_size = max_signal_size / 4 * 3;
+    channel->sender_id = std::random_device()();
+    channel->send = send;
+    channel->user_data = user_data;
+    return channel;
+}
+
+void otk_signal_channel_delete(otk_signal_channel *channel) {
+    delete channel;
+}
+
+static int queue_update(otk_signal_channel *channel, const char *key,
+                        const uint8_t *data, size_t size, int64_t now_us, bool coalesce) {
+    if (channel == nullptr || key == nullptr || (data == nullptr && size > 0)) {
+        return 0;
+    }
+    size_t key_size = strlen(key);
+    if (key_size > OTK_SIGNAL_CHANNEL_MAX_KEY_SIZE) {
+        return 0;
+    }
+    std::lock_guard<std::mutex> guard(channel->lock);
+    channel->stats.updates++;
+    channel->update_rate.add(now_us, 1);
+    bool started = channel->pending.empty();
+    if (started) {
+        channel->batch_started_us = now_us;
+    }
+    if (coalesce) {
+        auto found = channel->coalesced.find(std::string(key, key_size));
+        if (found != channel->coalesced.end()) {
+            pending_update &queued = channel->pending[found->second];
+            queued.data.assign(data, data + size);
+            queued.queued_us = now_us;
+            channel->stats.updates_coalesced++;
+            return 0;
+        }
+        channel->coalesced.emplace(std::string(key, key_size), channel->pending.size());
+    }
+    channel->pending.push_back({std::string(key, key_size), std::vector<uint8_t>(data, data + size), now_us});
+    return started ? 1 : 0;
+}
+
+int otk_signal_channel_update(otk_signal_channel *channel, const char *key,
+                              const uint8_t *data, size_t size, int64_t now_us) {
+    return queue_update(channel, key, data, size, now_us, true);
+}
+
+int otk_signal_channel_append(otk_signal_channel *channel, const char *key,
+                              const uint8_t *data, size_t size, int64_t now_us) {
+    return queue_update(channel, key, data, size, now_us, false);
+}
+
+int64_t otk_signal_channel_poll(otk_signal_channel *channel, int64_t now_us) {
+    if (channel == nullptr) {
+        return 0;
+    }
+    std::lock_guard<std::mutex> send_guard(channel->send_lock);
+    {
+        std::lock_guard<std::mutex> guard(channel->lock);
+        if (channel->pending.empty()) {
+            return 0;
+        }
+        int64_t due_us = channel->batch_started_us + channel->window_us;
+        if (now_us < due_us) {
+            return due_us - now_us;
+        }
+    }
+    send_pending(channel, now_us);
+    return 0;
+}
+
+void otk_signal_channel_flush(otk_signal_channel *channel, int64_t now_us) {
+    if (channel == nullptr) {
+        return;
+    }
+    std::lock_guard<std::mutex> send_guard(channel->send_lock);
+    send_pending(channel, now_us);
+}
+
+void otk_signal_channel_set_handler(otk_signal_channel *channel, const char *key,
+                                    otk_signal_channel_handler run, void *user_data) {
+    if (channel == nullptr) {
+        return;
+    }
+    std::lock_guard<std::mutex> guard(channel->lock);
+    if (key == nullptr) {
+        channel->fallback = {run, user_data};
+    } else if (run == nullptr) {
+        channel->handlers.erase(key);
+    } else {
+        channel->handlers[key] = {run, user_data};
+    }
+}
+
+namespace {
+
+struct received_update {
+    std::string key;
+    const uint8_t *data;
+    size_t size;
+    handler target;
+};
+
+} // namespace
+
+int otk_signal_channel_receive(otk_signal_channel *channel, const char *type, const char *data) {
+    if (channel == nullptr || type == nullptr || data == nullptr || channel->type != type) {
+        return 0;
+    }
+    std::vector<uint8_t> batch;
+    std::vector<received_update> updates;
+    bool valid = base64_decode(data, strlen(data), batch) && batch.size() >= kBatchHeaderSize &&
+        memcmp(batch.data(), kBatchMagic, sizeof(kBatchMagic)) == 0 && batch[3] == kBatchVersion;
+    if (valid && get_le32(batch.data() + 4) == channel->sender_id) {
+        return 1;
+    }
+    if (valid) {
+        const uint8_t *p = batch.data() + kBatchHeaderSize;
+        const uint8_t *end = batch.data() + batch.size();
+        uint64_t count = 0;
+        valid = get_varint(p, end, count);
+        for (uint64_t i = 0; valid && i < count; i++) {
+            uint64_t size = 0;
+            if (p >= end || (size_t)(end - p) < 1u + *p) {
+                valid = false;
+                break;
+            }
+            std::string key((const char *)p + 1, *p);
+            p += 1 + key.size();
+            if (!get_varint(p, end, size) || size > (uint64_t)(end - p)) {
+                valid = false;
+                break;
+            }
+            updates.push_back({std::move(key), p, (size_t)size, {}});
+            p += size;
+        }
+        valid = valid && p == end;
+    }
+
+    {
+        std::lock_guard<std::mutex> guard(channel->lock);
+        otk_signal_channel_stats &stats = channel->stats;
+        if (!valid) {
+            stats.decode_errors++;
+            return 1;
+        }
+        stats.signals_received++;
+        stats.updates_received += updates.size();
+        for (received_update &update : updates) {
+            auto found = channel->handlers.find(update.key);
+            update.target = found != channel->handlers.end() ? found->second : channel->fallback;
+            if (update.target.run == nullptr) {
+                stats.updates_unhandled++;
+            }
+        }
+    }
+    for (const received_update &update : updates) {
+        if (update.target.run != nullptr) {
+            update.target.run(update.key.c_str(), update.data, update.size, update.target.user_data);
+        }
+    }
+    return 1;
+}
+
+void otk_signal_channel_get_stats(otk_signal_channel *channel, int64_t now_us,
+                                  otk_signal_channel_stats *stats) {
+    if (channel == nullptr || stats == nullptr) {
+        return;
+    }
+    std::lock_guard<std::mutex> guard(channel->lock);
+    *stats = channel->stats;
+    stats->updates_per_second = channel->update_rate.per_second(now_us);
+    stats->signals_per_second = channel->signal_rate.per_second(now_us);
+    if (channel->updates_sent > 0) {
+        stats->added_latency_mean_us = channel->added_latency_total_us / (int64_t)channel->updates_sent;
+    }
+}
@@ -0,0 +1,132 @@
+//
+//  OTSignalChannel.h
+//  Custom-Video-Capturer
+//
+//  Copyright (c) 2026 Vonage. All rights reserved.
+//
+
+#ifndef OTSignalChannel_h
+#define OTSignalChannel_h
+
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * Carries high-rate application state, such as cursor positions,
+ * annotations or telemetry, over session signals in batches.
+ *
+ * Updates are queued under a key. Within a batching window a later update
+ * of a key replaces the one queued before it, unless it is appended, in
+ * which case every update is kept in order. Once the window has passed
+ * since the first update queued, the batch is packed into as few signals
+ * as fit the signal size limit, as binary encoded in base64.
+ *
+ * A received signal is decoded in one go and each update handed to the
+ * handler of its key, so the receiving thread is entered once per batch
+ * rather than once per update. Batches the channel sent itself are ignored.
+ *
+ * Plain C++, independent of the SDK: signals are sent through a callback
+ * and times are passed in, so batching and decoding can run anywhere.
+ */
+typedef struct otk_signal_channel otk_signal_channel;
+
+/** Longest signal data the SDK accepts, in bytes. */
+#define OTK_SIGNAL_CHANNEL_MAX_SIGNAL_SIZE 8192
+
+/** Longest key, in bytes. */
+#define OTK_SIGNAL_CHANNEL_MAX_KEY_SIZE 255
+
+/** Sends one signal. Returns 0 if it could not be sent. */
+typedef int (*otk_signal_channel_send)(const char *type, const char *data, void *user_data);
+
+/** Receives one update of key; data is valid during the call only. */
+typedef void (*otk_signal_channel_handler)(const char *key, const uint8_t *data, size_t size,
+                                           void *user_data);
+
+typedef struct otk_signal_channel_config {
+    /** Signal type of the batches, also used to recognize received ones. */
+    const char *type;
+    /** How long updates are held to be batched. 0 for 50 ms. */
+    int64_t window_us;
+    /** Largest signal sent, at most OTK_SIGNAL_CHANNEL_MAX_SIGNAL_SIZE. 0 for that. */
+    size_t max_signal_size;
+} otk_signal_channel_config;
+
+typedef struct otk_signal_channel_stats {
+    uint64_t updates;
+    /** Updates replaced by a later one of their key before being sent. */
+    uint64_t updates_coalesced;
+    /** Updates too large for a signal, never sent. */
+    uint64_t updates_dropped;
+    uint64_t signals_sent;
+    uint64_t send_failures;
+    uint64_t bytes_sent;
+    /** Over the last second. */
+    double updates_per_second;
+    double signals_per_second;
+    /** Time from an update being queued to its signal being sent. */
+    int64_t added_latency_mean_us;
+    int64_t added_latency_max_us;
+    uint64_t signals_received;
+    uint64_t updates_received;
+    /** Received updates whose key has no handler. */
+    uint64_t updates_unhandled;
+    uint64_t decode_errors;
+} otk_signal_channel_stats;
+
+/** Returns NULL if config has no type or send is NULL. */
+otk_signal_channel *otk_signal_channel_new(const otk_signal_channel_config *config,
+                                           otk_signal_channel_send send, void *user_data);
+
+/** Drops the updates not sent yet. */
+void otk_signal_channel_delete(otk_signal_channel *channel);
+
+/**
+ * Queues data under key, replacing the update of key queued in the current
+ * window if any. Returns 1 if it started a batch: otk_signal_channel_poll
+ * should then be called once the window has passed. Safe from any thread.
+ */
+int otk_signal_channel_update(otk_signal_channel *channel, const char *key,
+                              const uint8_t *data, size_t size, int64_t now_us);
+
+/** Same as otk_signal_channel_update but keeps every update of key. */
+int otk_signal_channel_append(otk_signal_channel *channel, const char *key,
+                              const uint8_t *data, size_t size, int64_t now_us);
+
+/**
+ * Sends the batch if the window has passed since it started, calling send
+ * from this thread. Returns the microseconds left until it is due, or 0 if
+ * nothing is queued any more.
+ */
+int64_t otk_signal_channel_poll(otk_signal_channel *channel, int64_t now_us);
+
+/** Sends whatever is queued now. */
+void otk_signal_channel_flush(otk_signal_channel *channel, int64_t now_us);
+
+/**
+ * Calls handler for every received update of key, NULL to stop. A NULL key
+ * sets the handler of the keys without one of their own. user_data must
+ * outlive the channel.
+ */
+void otk_signal_channel_set_handler(otk_signal_channel *channel, const char *key,
+                                    otk_signal_channel_handler handler, void *user_data);
+
+/**
+ * Decodes a received signal and calls the handlers of its updates from this
+ * thread. Returns 0 if it is not one of the channel's signals, so the app
+ * can handle it otherwise.
+ */
+int otk_signal_channel_receive(otk_signal_channel *channel, const char *type, const char *data);
+
+void otk_signal_channel_get_stats(otk_signal_channel *channel, int64_t now_us,
+                                  otk_signal_channel_stats *stats);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* OTSignalChannel_h */
@@ -0,0 +1,226 @@
+//
+//  OTStartupTimeline.cpp
+//  Custom-Video-Capturer
+//
+//  Copyright (c) 2026 Vonage. All rights reserved.
+//
+
+#include "OTStartupTimeline.h"
+
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <cstdio>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+static const char *const kMilestoneNames[OTK_STARTUP_MILESTONE_COUNT] = {
+    "connect requested",
+    "camera authorized",
+    "microphone authorized",
+    "capture ready",
+    "session connected",
+    "publish requested",
+    "capture init",
+    "first captured frame",
+    "publisher stream created",
+    "first remote frame",
+};
+
+enum milestone_state {
+    MILESTONE_PENDING,
+    MILESTONE_REACHED,
+    MILESTONE_FAILED,
+};
+
+struct otk_startup_timeline {
+    std::mutex lock;
+    int64_t origin_us;
+    milestone_state state[OTK_STARTUP_MILESTONE_COUNT];
+    int64_t time_us[OTK_STARTUP_MILESTONE_COUNT];
+};
+
+// Shared by the handle and the stage threads, so either can go first.
+struct prewarm_state {
+    std::mutex lock;
+    std::condition_variable done;
+    size_t running;
+    size_t failed;
+};
+
+struct otk_startup_prewarm {
+    std::shared_ptr<prewarm_state> state;
+};
+
+const char *otk_startup_milestone_name(enum otk_startup_milestone milestone) {
+    if (milestone < 0 || milestone >= OTK_STARTUP_MILESTONE_COUNT) {
+        return "unknown";
+    }
+    return kMilestoneNames[milestone];
+}
+
+int64_t otk_startup_now_us(void) {
+    return (int64_t)std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+otk_startup_timeline *otk_startup_timeline_new(void) {
+    otk_startup_timeline *timeline = new otk_startup_timeline();
+    otk_startup_timeline_reset(timeline, otk_startup_now_us());
+    return timeline;
+}
+
+void otk_startup_timeline_delete(otk_startup_timeline *timeline) {
+    delete timeline;
+}
+
+void otk_startup_timeline_reset(otk_startup_timeline *timeline, int64_t now_us) {
+    if (timeline == nullptr) {
+        return;
+    }
+    std::lock_guard<std::mutex> guard(timeline->lock);
+    timeline->origin_us = now_us;
+    for (int i = 0; i < OTK_STARTUP_MILESTONE_COUNT; i++) {
+        timeline->state[i] = MILESTONE_PENDING;
+        timeline->time_us[i] = 0;
+    }
+}
+
+static int record(otk_startup_timeline *timeline,
+                  enum otk_startup_milestone milestone,
+                  milestone_state state,
+                  int64_t now_us) {
+    if (timeline == nullptr || milestone < 0 || milestone >= OTK_STARTUP_MILESTONE_COUNT) {
+        return 0;
+    }
+    std::lock_guard<std::mutex> guard(timeline->lock);
+    if (timeline->state[milestone] != MILESTONE_PENDING) {
+        return 0;
+    }
+    timeline->state[milestone] = state;
+    timeline->time_us[milestone] = now_us - timeline->origin_us;
+    return 1;
+}
+
+int otk_startup_timeline_mark(otk_startup_timeline *timeline,
+                              enum otk_startup_milestone milestone,
+                              int64_t now_us) {
+    return record(timeline, milestone, MILESTONE_REACHED, now_us);
+}
+
+void otk_startup_timeline_fail(otk_startup_timeline *timeline,
+                               enum otk_startup_milestone milestone,
+                               int64_t now_us) {
+    record(timeline, milestone, MILESTONE_FAILED, now_us);
+}
+
+int64_t otk_startup_timeline_elapsed_us(otk_startup_timeline *timeline,
+                                        enum otk_startup_milestone milestone) {
+    if (timeline == nullptr || milestone < 0 || milestone >= OTK_STARTUP_MILESTONE_COUNT) {
+        return -1;
+    }
+    std::lock_guard<std::mutex> guard(timeline->lock);
+    return timeline->state[milestone] == MILESTONE_REACHED ? timeline->time_us[milestone] : -1;
+}
+
+size_t otk_startup_timeline_format(otk_startup_timeline *timeline,
+                                   char *buffer,
+                                   size_t size) {
+    if (size > 0) {
+        buffer[0] = '\0';
+    }
+    if (timeline == nullptr) {
+        return 0;
+    }
+    std::vector<int> order;
+    milestone_state state[OTK_STARTUP_MILESTONE_COUNT];
+    int64_t time_us[OTK_STARTUP_MILESTONE_COUNT];
+    {
+        std::lock_guard<std::mutex> guard(timeline->lock);
+        std::copy(timeline->state, timeline->state + OTK_STARTUP_MILESTONE_COUNT, state);
+        std::copy(timeline->time_us, timeline->time_us + OTK_STARTUP_MILESTONE_COUNT, time_us);
+    }
+    for (int i = 0; i < OTK_STARTUP_MILESTONE_COUNT; i++) {
+        if (state[i] != MILESTONE_PENDING) {
+            order.push_back(i);
+        }
+    }
+    std::stable_sort(order.begin(), order.end(), [&](int a, int b) {
+        return time_us[a] < time_us[b];
+    });
+
+    std::string text;
+    int64_t previous_us = 0;
+    char line[128];
+    for (int i : order) {
+        int length = snprintf(line, sizeof(line), "%9.1f ms  (+%7.1f ms)  %s%s\n",
+                              time_us[i] / 1000.0, (time_us[i] - previous_us) / 1000.0,
+                              kMilestoneNames[i], state[i] == MILESTONE_FAILED ? " FAILED" : "");
+        text.append(line, (size_t)std::min<int>(length, (int)sizeof(line) - 1));
+        previous_us = time_us[i];
+    }
+    if (size > 0) {
+        size_t copied = std::min(text.size(), size - 1);
+        std::copy(text.begin(), text.begin() + (ptrdiff_t)copied, buffer);
+        buffer[copied] = '\0';
+    }
+    return text.size();
+}
+
+otk_startup_prewarm *otk_startup_prewarm_start(otk_startup_timeline *timeline,
+                                               const otk_startup_stage *stages,
+                                               size_t count) {
+    otk_startup_prewarm *prewarm = new otk_startup_prewarm();
+    prewarm->state = std::make_shared<prewarm_state>();
+    prewarm->state->running = count;
+    prewarm->state->failed = 0;
+    for (size_t i = 0; i < count; i++) {
+        otk_startup_stage stage = stages[i];
+        std::shared_ptr<prewarm_state> state = prewarm->state;
+        std::thread([timeline, stage, state]() {
+            int result = stage.run != nullptr ? stage.run(stage.user_data) : 0;
+            if (result == 0) {
+                otk_startup_timeline_mark(timeline, stage.milestone, otk_startup_now_us());
+            } else {
+                otk_startup_timeline_fail(timeline, stage.milestone, otk_startup_now_us());
+            }
+            std::lock_guard<std::mutex> guard(state->lock);
+            state->running--;
+            if (result != 0) {
+                state->failed++;
+            }
+            state->done.notify_all();
+        }).detach();
+    }
+    return prewarm;
+}
+
+size_t otk_startup_prewarm_wait(otk_startup_prewarm *prewarm, int64_t timeout_ms) {
+    if (prewarm == nullptr) {
+        return 0;
+    }
+    prewarm_state &state = *prewarm->state;
+    std::unique_lock<std::mutex> guard(state.lock);
+    if (timeout_ms < 0) {
+        state.done.wait(guard, [&state]() { return state.running == 0; });
+    } else {
+        state.done.wait_for(guard, std::chrono::milliseconds(timeout_ms),
+                            [&state]() { return state.running == 0; });
+    }
+    return state.running;
+}
+
+size_t otk_startup_prewarm_failed(otk_startup_prewarm *prewarm) {
+    if (prewarm == nullptr) {
+        return 0;
+    }
+    std::lock_guard<std::mutex> guard(prewarm->state->lock);
+    return prewarm->state->failed;
+}
+
+void otk_startup_prewarm_delete(otk_startup_prewarm *prewarm) {
+    delete prewarm;
+}
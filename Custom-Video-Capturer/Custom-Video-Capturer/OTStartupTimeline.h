@@ -0,0 +1,123 @@
+//
+//  OTStartupTimeline.h
+//  Custom-Video-Capturer
+//
+//  Copyright (c) 2026 Vonage. All rights reserved.
+//
+
+#ifndef OTStartupTimeline_h
+#define OTStartupTimeline_h
+
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * Records when each startup milestone is reached, from the moment the user
+ * asks to connect to the first remote frame on screen, and runs pre-warm
+ * stages concurrently with signaling.
+ *
+ * Independent of the SDK and of AVFoundation: stages are plain functions,
+ * so the scheduling can be exercised with stubs.
+ */
+typedef struct otk_startup_timeline otk_startup_timeline;
+typedef struct otk_startup_prewarm otk_startup_prewarm;
+
+enum otk_startup_milestone {
+    OTK_STARTUP_CONNECT_REQUESTED = 0,
+    OTK_STARTUP_CAMERA_AUTHORIZED = 1,
+    OTK_STARTUP_MICROPHONE_AUTHORIZED = 2,
+    /** The capture session is configured and running. */
+    OTK_STARTUP_CAPTURE_READY = 3,
+    OTK_STARTUP_SESSION_CONNECTED = 4,
+    OTK_STARTUP_PUBLISH_REQUESTED = 5,
+    /** The SDK initialized the capturer. */
+    OTK_STARTUP_CAPTURE_INIT = 6,
+    OTK_STARTUP_FIRST_CAPTURED_FRAME = 7,
+    OTK_STARTUP_PUBLISHER_STREAM_CREATED = 8,
+    OTK_STARTUP_FIRST_REMOTE_FRAME = 9,
+    OTK_STARTUP_MILESTONE_COUNT = 10,
+};
+
+/** Returns a short name for the milestone, e.g. "session connected". */
+const char *otk_startup_milestone_name(enum otk_startup_milestone milestone);
+
+/** Monotonic clock in microseconds, for the now_us arguments below. */
+int64_t otk_startup_now_us(void);
+
+otk_startup_timeline *otk_startup_timeline_new(void);
+
+void otk_startup_timeline_delete(otk_startup_timeline *timeline);
+
+/** Forgets every milestone and measures from now_us on. */
+void otk_startup_timeline_reset(otk_startup_timeline *timeline, int64_t now_us);
+
+/**
+ * Records the milestone unless it was already reached. Returns 1 if this
+ * call recorded it. Safe to call from any thread.
+ */
+int otk_startup_timeline_mark(otk_startup_timeline *timeline,
+                              enum otk_startup_milestone milestone,
+                              int64_t now_us);
+
+/** Records that the milestone failed; it will not be reached. */
+void otk_startup_timeline_fail(otk_startup_timeline *timeline,
+                               enum otk_startup_milestone milestone,
+                               int64_t now_us);
+
+/** Microseconds from the reset to the milestone, -1 if not reached. */
+int64_t otk_startup_timeline_elapsed_us(otk_startup_timeline *timeline,
+                                        enum otk_startup_milestone milestone);
+
+/**
+ * Writes the reached and failed milestones in time order, one per line,
+ * with the time since the reset and since the previous milestone. Like
+ * snprintf, returns the full length and always terminates buffer.
+ */
+size_t otk_startup_timeline_format(otk_startup_timeline *timeline,
+                                   char *buffer,
+                                   size_t size);
+
+/**
+ * A pre-warm stage. run is called on its own thread and returns 0 on
+ * success, after which the stage's milestone is marked. Otherwise the
+ * milestone is marked as failed.
+ */
+typedef struct otk_startup_stage {
+    const char *name;
+    enum otk_startup_milestone milestone;
+    int (*run)(void *user_data);
+    void *user_data;
+} otk_startup_stage;
+
+/**
+ * Starts every stage at once and returns without waiting. The timeline must
+ * outlive the stages.
+ */
+otk_startup_prewarm *otk_startup_prewarm_start(otk_startup_timeline *timeline,
+                                               const otk_startup_stage *stages,
+                                               size_t count);
+
+/**
+ * Waits up to timeout_ms (-1 for ever) for every stage to finish. Returns
+ * the number of stages still running.
+ */
+size_t otk_startup_prewarm_wait(otk_startup_prewarm *prewarm, int64_t timeout_ms);
+
+/** Returns the number of stages that failed so far. */
+size_t otk_startup_prewarm_failed(otk_startup_prewarm *prewarm);
+
+/**
+ * Releases the handle without waiting; stages still running finish on
+ * their own.
+ */
+void otk_startup_prewarm_delete(otk_startup_prewarm *prewarm);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* OTStartupTimeline_h */
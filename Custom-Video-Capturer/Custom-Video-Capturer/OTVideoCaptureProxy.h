@@ -12,6 +12,9 @@
 #include <AppKit/AppKit.h>
 #include <OpenTok/OpenTok.h>
 #include "OTVideoKit.h"
+#include "OTCaptureFanout.h"
+
+@class OTMacDefaultVideoCapturer;
 
 /* .....................................*/
 
@@ -20,6 +23,19 @@
 @property (readonly) struct otc_video_capturer_callbacks* otc_video_capture_driver;
 @property (strong) id<OTVideoCapture> videoCapture;
 - (id)init;
+/**
+ A capturer taking its frames from a camera shared with other publishers
+ through fanout, no larger than maxWidth by maxHeight and at no more than
+ maxFrameRate, 0 for no limit. The camera runs while any of them is
+ initialized; set capturer.fanout to fanout before using it.
+ */
+- (id)initWithSharedCapturer:(OTMacDefaultVideoCapturer *)capturer
+                      fanout:(otk_capture_fanout *)fanout
+                    maxWidth:(uint32_t)maxWidth
+                   maxHeight:(uint32_t)maxHeight
+                maxFrameRate:(double)maxFrameRate;
+/** The proxy's consumer in the fanout while initialized, otherwise 0. */
+@property (readonly) int fanoutConsumer;
 @end
 
 otc_bool otc_video_capture_init(const otc_video_capturer *capturer,
@@ -11,7 +11,21 @@
     struct otc_video_capturer_callbacks _otcVideoCapture;
     otc_video_capturer * _capturer;
     __strong id<OTVideoCapture> _videoCapture;
+    
+    // Set when sharing a camera through a fanout.
+    otk_capture_fanout *_fanout;
+    int _fanoutConsumer;
+    uint32_t _maxWidth;
+    uint32_t _maxHeight;
+    double _maxFrameRate;
+    const otc_video_capturer *_sharedCapturer;
 }
+static otc_bool fanout_capture_init(const otc_video_capturer *capturer, void *user_data);
+static otc_bool fanout_capture_release(const otc_video_capturer *capturer, void *user_data);
+static otc_bool fanout_capture_start(const otc_video_capturer *capturer, void *user_data);
+static otc_bool fanout_capture_stop(const otc_video_capturer *capturer, void *user_data);
+static otc_bool fanout_capture_settings(const otc_video_capturer *capturer, void *user_data,
+                                        struct otc_video_capturer_settings *settings);
 static NSString *const kVideoContentHintKeyPath = @"_videoCapture.videoContentHint";
 
 #pragma mark - Object Lifecycle
@@ -37,6 +51,32 @@ static NSString *const kVideoContentHintKeyPath = @"_videoCapture.videoContentHi
     return self;
 }
 
+- (id)initWithSharedCapturer:(OTMacDefaultVideoCapturer *)capturer
+                      fanout:(otk_capture_fanout *)fanout
+                    maxWidth:(uint32_t)maxWidth
+                   maxHeight:(uint32_t)maxHeight
+                maxFrameRate:(double)maxFrameRate {
+    self = [super init];
+    if (self) {
+        _videoCapture = capturer;
+        _fanout = fanout;
+        _maxWidth = maxWidth;
+        _maxHeight = maxHeight;
+        _maxFrameRate = maxFrameRate;
+        _otcVideoCapture.init = fanout_capture_init;
+        _otcVideoCapture.destroy = fanout_capture_release;
+        _otcVideoCapture.start = fanout_capture_start;
+        _otcVideoCapture.stop = fanout_capture_stop;
+        _otcVideoCapture.get_capture_settings = fanout_capture_settings;
+        _otcVideoCapture.user_data = (__bridge void *)self;
+    }
+    return self;
+}
+
+- (int)fanoutConsumer {
+    return _fanoutConsumer;
+}
+
 - (struct otc_video_capturer_callbacks*) otc_video_capture_driver {
     return &_otcVideoCapture;
 }
@@ -97,4 +137,111 @@ otc_bool otc_video_capture_settings(const otc_video_capturer *capturer,
     return (result == 0);
 }
 
+#pragma mark - Shared capture
+
+static const uint8_t *fanout_frame_get_plane(void *user_data, enum otc_video_frame_plane plane) {
+    return otk_fanout_buffer_plane((const otk_fanout_buffer *)user_data, (int)plane);
+}
+
+static int fanout_frame_get_plane_stride(void *user_data, enum otc_video_frame_plane plane) {
+    return otk_fanout_buffer_stride((const otk_fanout_buffer *)user_data, (int)plane);
+}
+
+static void fanout_frame_release(void *user_data) {
+    otk_fanout_buffer_release((otk_fanout_buffer *)user_data);
+}
+
+// Runs on the camera's queue, outside the fanout's lock. Removing the
+// consumer from another thread waits for this to return; the publisher must
+// still not be deleted from its callbacks.
+static void fanout_deliver(const otk_fanout_frame *frame, otk_fanout_buffer *buffer,
+                           void *user_data)
+{
+    OTVideoCaptureProxy *proxy = (__bridge OTVideoCaptureProxy *)user_data;
+    struct otc_video_frame_planar_memory_callbacks cb = {0};
+    cb.user_data = buffer;
+    cb.get_plane = fanout_frame_get_plane;
+    cb.get_plane_stride = fanout_frame_get_plane_stride;
+    cb.release = fanout_frame_release;
+    
+    // The frame keeps the buffer until the SDK is done with it.
+    otk_fanout_buffer_retain(buffer);
+    otc_video_frame *otc_frame =
+    otc_video_frame_new_planar_memory_wrapper(OTC_VIDEO_FRAME_FORMAT_NV12,
+                                              (int)frame->width, (int)frame->height,
+                                              OTC_TRUE, &cb);
+    if (otc_frame == NULL) {
+        otk_fanout_buffer_release(buffer);
+        return;
+    }
+    if (frame->metadata != NULL) {
+        otc_video_frame_set_metadata(otc_frame, frame->metadata, frame->metadata_size);
+    }
+    otc_video_capturer_provide_frame(proxy->_sharedCapturer, 0, otc_frame);
+    otc_video_frame_delete(otc_frame);
+}
+
+static otc_bool fanout_capture_init(const otc_video_capturer *capturer,
+                             void *user_data)
+{
+    OTVideoCaptureProxy *proxy = (__bridge OTVideoCaptureProxy *)user_data;
+    proxy->_sharedCapturer = capturer;
+    proxy->_fanoutConsumer = otk_capture_fanout_add_consumer(proxy->_fanout,
+                                                             proxy->_maxWidth, proxy->_maxHeight,
+                                                             proxy->_maxFrameRate,
+                                                             fanout_deliver, user_data);
+    [(OTMacDefaultVideoCapturer *)proxy->_videoCapture acquireSharedCapture];
+    return true;
+}
+
+static otc_bool fanout_capture_release(const otc_video_capturer *capturer,
+                                void *user_data)
+{
+    OTVideoCaptureProxy *proxy = (__bridge OTVideoCaptureProxy *)user_data;
+    otk_capture_fanout_remove_consumer(proxy->_fanout, proxy->_fanoutConsumer);
+    proxy->_fanoutConsumer = 0;
+    [(OTMacDefaultVideoCapturer *)proxy->_videoCapture releaseSharedCapture];
+    return true;
+}
+
+static otc_bool fanout_capture_start(const otc_video_capturer *capturer,
+                              void *user_data)
+{
+    OTVideoCaptureProxy *proxy = (__bridge OTVideoCaptureProxy *)user_data;
+    otk_capture_fanout_set_active(proxy->_fanout, proxy->_fanoutConsumer, 1);
+    return true;
+}
+
+static otc_bool fanout_capture_stop(const otc_video_capturer *capturer,
+                             void *user_data)
+{
+    OTVideoCaptureProxy *proxy = (__bridge OTVideoCaptureProxy *)user_data;
+    otk_capture_fanout_set_active(proxy->_fanout, proxy->_fanoutConsumer, 0);
+    return true;
+}
+
+static otc_bool fanout_capture_settings(const otc_video_capturer *capturer,
+                                 void *user_data,
+                                 struct otc_video_capturer_settings *settings)
+{
+    OTVideoCaptureProxy *proxy = (__bridge OTVideoCaptureProxy *)user_data;
+    OTMacDefaultVideoCapturer *source = (OTMacDefaultVideoCapturer *)proxy->_videoCapture;
+    uint32_t width = 0;
+    uint32_t height = 0;
+    otk_capture_fanout_output_size((uint32_t)[source getCaptureWidth],
+                                   (uint32_t)[source getCaptureHeight],
+                                   proxy->_maxWidth, proxy->_maxHeight, &width, &height);
+    double fps = source.activeFrameRate;
+    if (proxy->_maxFrameRate > 0 && (fps <= 0 || proxy->_maxFrameRate < fps)) {
+        fps = proxy->_maxFrameRate;
+    }
+    settings->format = OTC_VIDEO_FRAME_FORMAT_NV12;
+    settings->width = (int)width;
+    settings->height = (int)height;
+    settings->fps = (int)fps;
+    settings->expected_delay = 0;
+    settings->mirror_on_local_render = OTC_FALSE;
+    return true;
+}
+
 @end
@@ -10,6 +10,39 @@
 #import "OTMTLVideoView.h"
 #import "OTMacDefaultVideoCapturer.h"
 #import "OTVideoCaptureProxy.h"
+#import "OTFrameStamp.h"
+#import "OTStartupTimeline.h"
+#import "OTSignalChannel.h"
+
+// Set to 1 to stamp published frames and log glass to glass latency,
+// frame loss and reordering for the preview and the subscriber.
+#define OT_ENABLE_FRAME_STAMPS 0
+#define kFrameStampWindowSize 300
+#define kFrameStampReportInterval 5.0
+
+// Set to 0 to open the camera only once the session is connected and the
+// SDK asks for it. Otherwise camera and microphone access and the capture
+// session are set up while the session connects. The startup timeline is
+// logged either way when the first remote frame is drawn.
+#define OT_ENABLE_STARTUP_PREWARM 1
+
+// Set to 1 to publish a second, smaller stream from the same camera. Both
+// publishers take their frames from one capture session, the second one
+// scaled down and at a lower frame rate.
+#define OT_ENABLE_SHARED_CAMERA 0
+#define kSharedCameraMaxWidth 320
+#define kSharedCameraMaxHeight 180
+#define kSharedCameraMaxFrameRate 15.0
+#define kSharedCameraReportInterval 10.0
+
+// Set to 1 to send the mouse position over the view to the other
+// participants as batched signals, coalesced within kSignalChannelWindowUs,
+// and log how many signals are sent and the latency batching adds.
+#define OT_ENABLE_SIGNAL_CHANNEL 0
+#define kSignalChannelType "otk-batch"
+#define kSignalChannelWindowUs 50000
+#define kSignalChannelReportInterval 5.0
+
 // Replace with your OpenTok API key
 static char* const kApiKey = "";
 // Replace with your generated session ID
@@ -25,6 +58,16 @@ OTVideoCaptureProxy *videoProxy = NULL;
 bool isConnected = false;
 bool isCamMuted = false;
 bool isMicMuted = false;
+otk_frame_latency_tracker *pubLatencyTracker = NULL;
+otk_frame_latency_tracker *subLatencyTracker = NULL;
+otk_startup_timeline *startupTimeline = NULL;
+otk_startup_prewarm *startupPrewarm = NULL;
+otc_publisher *sharedPublisher = NULL;
+OTVideoCaptureProxy *sharedVideoProxy = NULL;
+otk_capture_fanout *captureFanout = NULL;
+otk_signal_channel *signalChannel = NULL;
+dispatch_queue_t signalQueue = NULL;
+NSPoint remoteCursor;
 
 @implementation ViewController
 @synthesize statusLbl;
@@ -48,7 +91,22 @@ bool isMicMuted = false;
     subscriberView.layer.borderWidth = 5;
     subscriberView.hidden = TRUE;
     setupPublisher((__bridge void*)self);
+    startupTimeline = otk_startup_timeline_new();
+    ((OTMacDefaultVideoCapturer *)videoProxy.videoCapture).startupTimeline = startupTimeline;
     
+#if OT_ENABLE_FRAME_STAMPS
+    setupFrameStamps();
+#endif
+#if OT_ENABLE_SIGNAL_CHANNEL
+    setupSignalChannel((__bridge void*)self);
+#endif
+}
+
+- (void)viewDidAppear {
+    [super viewDidAppear];
+#if OT_ENABLE_SIGNAL_CHANNEL
+    self.view.window.acceptsMouseMovedEvents = YES;
+#endif
 }
 - (IBAction)connectBtn:(id)sender {
     NSLog(@"Connect Clicked");
@@ -57,6 +115,11 @@ bool isMicMuted = false;
         otc_session_disconnect(session);
     }
     else{
+        otk_startup_timeline_reset(startupTimeline, otk_startup_now_us());
+        otk_startup_timeline_mark(startupTimeline, OTK_STARTUP_CONNECT_REQUESTED, otk_startup_now_us());
+#if OT_ENABLE_STARTUP_PREWARM
+        startPrewarm();
+#endif
         setupOpentokSession((__bridge void*)self);
     }
 }
@@ -90,6 +153,154 @@ bool isMicMuted = false;
     }
 }
 
+void logFrameStampStats(const char *name, otk_frame_latency_tracker *tracker) {
+    otk_frame_latency_stats stats;
+    otk_frame_latency_tracker_get_stats(tracker, &stats);
+    if (stats.window_samples == 0) {
+        return;
+    }
+    NSLog(@"%s: received=%llu lost=%llu reordered=%llu latency p50/p95/p99=%.1f/%.1f/%.1f ms "
+          "(relative p50/p95/p99=%.1f/%.1f/%.1f ms)",
+          name, stats.frames_received, stats.frames_lost, stats.frames_reordered,
+          stats.latency_p50_us / 1000.0, stats.latency_p95_us / 1000.0, stats.latency_p99_us / 1000.0,
+          stats.relative_p50_us / 1000.0, stats.relative_p95_us / 1000.0, stats.relative_p99_us / 1000.0);
+}
+
+void setupFrameStamps(void) {
+    OTMacDefaultVideoCapturer *capturer = (OTMacDefaultVideoCapturer *)videoProxy.videoCapture;
+    capturer.frameStampPublisherId = arc4random();
+    capturer.frameStampingEnabled = YES;
+    
+    pubLatencyTracker = otk_frame_latency_tracker_new(kFrameStampWindowSize);
+    subLatencyTracker = otk_frame_latency_tracker_new(kFrameStampWindowSize);
+    pubView.latencyTracker = pubLatencyTracker;
+    subscriberView.latencyTracker = subLatencyTracker;
+    
+    [NSTimer scheduledTimerWithTimeInterval:kFrameStampReportInterval repeats:YES block:^(NSTimer *timer) {
+        logFrameStampStats("publisher preview", pubLatencyTracker);
+        logFrameStampStats("subscriber", subLatencyTracker);
+    }];
+}
+
+static int signal_channel_send(const char *type, const char *data, void *user_data) {
+    if (session == NULL || !isConnected) {
+        return 0;
+    }
+    return otc_session_send_signal(session, type, data) == OTC_SUCCESS;
+}
+
+// Sends the batch once the window has passed, on a queue of its own so the
+// main thread never waits for the SDK.
+void scheduleSignalPoll(int64_t delay_us) {
+    dispatch_after(dispatch_time(DISPATCH_TIME_NOW, delay_us * NSEC_PER_USEC), signalQueue, ^{
+        int64_t left_us = otk_signal_channel_poll(signalChannel, otk_startup_now_us());
+        if (left_us > 0) {
+            scheduleSignalPoll(left_us);
+        }
+    });
+}
+
+void sendSignalUpdate(const char *key, const void *data, size_t size, BOOL coalesce) {
+    if (!isConnected) {
+        return;
+    }
+    int started = coalesce ?
+        otk_signal_channel_update(signalChannel, key, (const uint8_t *)data, size, otk_startup_now_us()) :
+        otk_signal_channel_append(signalChannel, key, (const uint8_t *)data, size, otk_startup_now_us());
+    if (started) {
+        scheduleSignalPoll(kSignalChannelWindowUs);
+    }
+}
+
+static void remote_cursor_handler(const char *key, const uint8_t *data, size_t size, void *user_data) {
+    float position[2];
+    if (size != sizeof(position)) {
+        return;
+    }
+    memcpy(position, data, sizeof(position));
+    remoteCursor = NSMakePoint(position[0], position[1]);
+}
+
+static void remote_click_handler(const char *key, const uint8_t *data, size_t size, void *user_data) {
+    NSLog(@"Remote click at %.2f, %.2f", remoteCursor.x, remoteCursor.y);
+}
+
+void setupSignalChannel(void * userdata) {
+    ViewController *v = (__bridge ViewController *)userdata;
+    otk_signal_channel_config config = {0};
+    config.type = kSignalChannelType;
+    config.window_us = kSignalChannelWindowUs;
+    signalChannel = otk_signal_channel_new(&config, signal_channel_send, NULL);
+    signalQueue = dispatch_queue_create("com.vonage.signal-channel", DISPATCH_QUEUE_SERIAL);
+    otk_signal_channel_set_handler(signalChannel, "cursor", remote_cursor_handler, NULL);
+    otk_signal_channel_set_handler(signalChannel, "click", remote_click_handler, NULL);
+    
+    // The position is sent relative to the view, the latest one per window;
+    // every click is sent.
+    NSEventMask mask = NSEventMaskMouseMoved | NSEventMaskLeftMouseDragged | NSEventMaskLeftMouseDown;
+    [NSEvent addLocalMonitorForEventsMatchingMask:mask handler:^NSEvent *(NSEvent *event) {
+        NSPoint point = [v.view convertPoint:event.locationInWindow fromView:nil];
+        float position[2] = {
+            (float)(point.x / v.view.bounds.size.width),
+            (float)(point.y / v.view.bounds.size.height),
+        };
+        sendSignalUpdate("cursor", position, sizeof(position), YES);
+        if (event.type == NSEventTypeLeftMouseDown) {
+            sendSignalUpdate("click", NULL, 0, NO);
+        }
+        return event;
+    }];
+    
+    [NSTimer scheduledTimerWithTimeInterval:kSignalChannelReportInterval repeats:YES block:^(NSTimer *timer) {
+        otk_signal_channel_stats stats;
+        otk_signal_channel_get_stats(signalChannel, otk_startup_now_us(), &stats);
+        NSLog(@"Signal channel: updates %.1f/s signals %.1f/s (sent=%llu failed=%llu coalesced=%llu) "
+              "added latency mean/max=%.1f/%.1f ms, received=%llu updates=%llu errors=%llu",
+              stats.updates_per_second, stats.signals_per_second, stats.signals_sent,
+              stats.send_failures, stats.updates_coalesced,
+              stats.added_latency_mean_us / 1000.0, stats.added_latency_max_us / 1000.0,
+              stats.signals_received, stats.updates_received, stats.decode_errors);
+    }];
+}
+
+static int prewarm_camera(void *user_data) {
+    OTMacDefaultVideoCapturer *capturer = (__bridge OTMacDefaultVideoCapturer *)user_data;
+    return [capturer prewarmCapture] ? 0 : -1;
+}
+
+// The SDK opens the microphone itself, only the permission prompt is moved
+// out of the way.
+static int prewarm_microphone(void *user_data) {
+    if (@available(macOS 10.14, *)) {
+        AVAuthorizationStatus status = [AVCaptureDevice authorizationStatusForMediaType:AVMediaTypeAudio];
+        if (status == AVAuthorizationStatusNotDetermined) {
+            dispatch_semaphore_t answered = dispatch_semaphore_create(0);
+            [AVCaptureDevice requestAccessForMediaType:AVMediaTypeAudio completionHandler:^(BOOL granted) {
+                dispatch_semaphore_signal(answered);
+            }];
+            dispatch_semaphore_wait(answered, DISPATCH_TIME_FOREVER);
+            status = [AVCaptureDevice authorizationStatusForMediaType:AVMediaTypeAudio];
+        }
+        return status == AVAuthorizationStatusAuthorized ? 0 : -1;
+    }
+    return 0;
+}
+
+void startPrewarm(void) {
+    otk_startup_stage stages[] = {
+        { "camera", OTK_STARTUP_CAPTURE_READY, prewarm_camera, (__bridge void *)videoProxy.videoCapture },
+        { "microphone", OTK_STARTUP_MICROPHONE_AUTHORIZED, prewarm_microphone, NULL },
+    };
+    otk_startup_prewarm_delete(startupPrewarm);
+    startupPrewarm = otk_startup_prewarm_start(startupTimeline, stages, sizeof(stages) / sizeof(stages[0]));
+}
+
+void logStartupTimeline(void) {
+    char timeline[1024];
+    otk_startup_timeline_format(startupTimeline, timeline, sizeof(timeline));
+    NSLog(@"Startup timeline:\n%s", timeline);
+}
+
 void session_logger_func(const char* message) {
     NSLog(@"%s",message);
 }
@@ -129,7 +340,12 @@ void setupOpentokSession(void * userdata){
 void session_on_connected(otc_session *session, void *user_data) {
     NSLog(@"Session Connected");
     isConnected = true;
+    otk_startup_timeline_mark(startupTimeline, OTK_STARTUP_SESSION_CONNECTED, otk_startup_now_us());
+    otk_startup_timeline_mark(startupTimeline, OTK_STARTUP_PUBLISH_REQUESTED, otk_startup_now_us());
     otc_session_publish(session, publisher);
+    if (sharedPublisher != NULL) {
+        otc_session_publish(session, sharedPublisher);
+    }
 
     ViewController *v = (__bridge ViewController *)user_data;
     dispatch_async(dispatch_get_main_queue(), ^{
@@ -143,6 +359,7 @@ void session_on_connected(otc_session *session, void *user_data) {
 
 void session_on_disconnected(otc_session *session, void *user_data) {
     NSLog(@"Session Disconnected");
+    [(OTMacDefaultVideoCapturer *)videoProxy.videoCapture cancelPrewarm];
     ViewController *v = (__bridge ViewController *)user_data;
     dispatch_async(dispatch_get_main_queue(), ^{
         [v.statusLbl setStringValue:@"Disconnected"];
@@ -177,6 +394,9 @@ void session_on_stream_received(otc_session *session, void *user_data, const otc
     callbacks.on_video_enabled = subscriber_on_video_enabled;
     callbacks.on_error = subscriber_on_error;
     callbacks.user_data = user_data;
+    if (subLatencyTracker) {
+        otk_frame_latency_tracker_reset(subLatencyTracker);
+    }
     otc_subscriber *subscriber= otc_subscriber_new(stream, &callbacks);
     otc_session_subscribe(session, subscriber);
 }
@@ -187,10 +407,22 @@ void session_on_stream_dropped(otc_session *session, void *user_data, const otc_
 
 void session_on_error(otc_session *session, void *user_data, const char * msg, enum otc_session_error_code error_code) {
     NSLog(@"Connection Error: %s, code=%d",msg,error_code);
+    if (!isConnected) {
+        [(OTMacDefaultVideoCapturer *)videoProxy.videoCapture cancelPrewarm];
+    }
 }
 
 void session_on_signal_received(otc_session *session, void *user_data, const char *type, const char *signal,
                                 const otc_connection *connection) {
+    if (signalChannel != NULL && type != NULL && signal != NULL && strcmp(type, kSignalChannelType) == 0) {
+        // One hop to the main thread per batch, whatever its number of updates.
+        char *batch = strdup(signal);
+        dispatch_async(dispatch_get_main_queue(), ^{
+            otk_signal_channel_receive(signalChannel, kSignalChannelType, batch);
+            free(batch);
+        });
+        return;
+    }
     NSLog(@"Received: %s",signal);
     
 }
@@ -206,8 +438,56 @@ void session_on_reconnect_succeess(otc_session *session, void *user_data) {
 void session_on_mute_forced(otc_session *session, void *user_data, otc_on_mute_forced_info *mute_info) {
     
 }
+void logSharedCamera(void) {
+    otk_fanout_stats stats;
+    otk_capture_fanout_get_stats(captureFanout, &stats);
+    NSLog(@"Shared camera: frames=%llu scales=%llu (%.1f ms) buffers=%llu",
+          stats.frames_in, stats.scales, stats.scale_us / 1000.0, stats.buffers_allocated);
+    OTVideoCaptureProxy *proxies[] = { videoProxy, sharedVideoProxy };
+    for (int i = 0; i < 2; i++) {
+        otk_fanout_consumer_stats consumer;
+        if (!otk_capture_fanout_get_consumer_stats(captureFanout, proxies[i].fanoutConsumer, &consumer)) {
+            continue;
+        }
+        NSLog(@"  publisher %d: %ux%u delivered=%llu decimated=%llu shared=%llu scaled=%llu",
+              i, consumer.width, consumer.height, consumer.frames_delivered,
+              consumer.frames_decimated, consumer.frames_shared, consumer.frames_scaled);
+    }
+}
+
+void setupSharedCamera(void * userdata) {
+    OTMacDefaultVideoCapturer *camera = [[OTMacDefaultVideoCapturer alloc] init];
+    captureFanout = otk_capture_fanout_new();
+    camera.fanout = captureFanout;
+    videoProxy = [[OTVideoCaptureProxy alloc] initWithSharedCapturer:camera
+                                                              fanout:captureFanout
+                                                            maxWidth:0
+                                                           maxHeight:0
+                                                        maxFrameRate:0];
+    sharedVideoProxy = [[OTVideoCaptureProxy alloc] initWithSharedCapturer:camera
+                                                                    fanout:captureFanout
+                                                                  maxWidth:kSharedCameraMaxWidth
+                                                                 maxHeight:kSharedCameraMaxHeight
+                                                              maxFrameRate:kSharedCameraMaxFrameRate];
+    
+    // No preview of its own, the main publisher's shows the same camera.
+    struct otc_publisher_callbacks publisher_callbacks = {0};
+    publisher_callbacks.user_data = userdata;
+    publisher_callbacks.on_error = publisher_on_error;
+    sharedPublisher = otc_publisher_new("Mac Publisher (small)", sharedVideoProxy.otc_video_capture_driver,
+                                        &publisher_callbacks);
+    
+    [NSTimer scheduledTimerWithTimeInterval:kSharedCameraReportInterval repeats:YES block:^(NSTimer *timer) {
+        logSharedCamera();
+    }];
+}
+
 void setupPublisher(void * userdata){
+#if OT_ENABLE_SHARED_CAMERA
+    setupSharedCamera(userdata);
+#else
     videoProxy = [[OTVideoCaptureProxy alloc] init];
+#endif
     struct otc_publisher_callbacks publisher_callbacks = {0};
     publisher_callbacks.on_stream_created = publisher_on_stream_created;
     publisher_callbacks.on_render_frame = publisher_on_render_frame;
@@ -221,7 +501,7 @@ void setupPublisher(void * userdata){
 }
 
 void publisher_on_stream_created(otc_publisher *publisher, void *user_data, const otc_stream *stream) {
-   
+    otk_startup_timeline_mark(startupTimeline, OTK_STARTUP_PUBLISHER_STREAM_CREATED, otk_startup_now_us());
     NSLog(@"Publisher stream created");
 }
 
@@ -240,6 +520,11 @@ static void publisher_on_error(otc_publisher *publisher, void *user_data, const
 
 static void subscriber_on_render_frame(otc_subscriber *subscriber, void *user_data, const otc_video_frame *frame) {
     [subscriberView renderVideoFrame:(otc_video_frame*)frame];
+    if (otk_startup_timeline_mark(startupTimeline, OTK_STARTUP_FIRST_REMOTE_FRAME, otk_startup_now_us())) {
+        dispatch_async(dispatch_get_main_queue(), ^{
+            logStartupTimeline();
+        });
+    }
 }
 
 static void subscriber_on_error(otc_subscriber *subscriber, void *user_data, const char *error_string, enum otc_subscriber_error_code error_code){
@@ -0,0 +1,526 @@
+//
+//  OTAudioChain.cpp
+//  Media-Transformers
+//
+//  Copyright (c) 2026 Vonage. All rights reserved.
+//
+
+#include "OTAudioChain.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <mutex>
+#include <vector>
+
+#if defined(__ARM_NEON) || defined(__ARM_NEON__)
+#include <arm_neon.h>
+#define OTK_AUDIO_NEON 1
+#elif defined(__SSE2__)
+#include <emmintrin.h>
+#define OTK_AUDIO_SSE2 1
+#endif
+
+static const double kPi = 3.14159265358979323846;
+
+// Below this, state is flushed to zero instead of decaying into denormals.
+static const float kDenormalFloor = 1e-20f;
+
+// AGC time constants: turn down fast on loud blocks, come back up slowly.
+static const double kAgcAttackMs = 50;
+static const double kAgcReleaseMs = 600;
+
+// Largest float that converts to a valid int16.
+static const float kInt16Max = 32767.0f / 32768.0f;
+
+struct biquad {
+    float b0, b1, b2, a1, a2;
+};
+
+struct stage_timer {
+    std::atomic<uint64_t> blocks;
+    std::atomic<uint64_t> total_ns;
+    std::atomic<uint64_t> max_ns;
+    std::atomic<uint64_t> histogram[OTK_AUDIO_STAGE_HISTOGRAM_BUCKETS];
+};
+
+struct otk_audio_chain {
+    size_t max_frames;
+    size_t max_channels;
+    std::vector<float> scratch;
+
+    // Written by otk_audio_chain_configure, picked up by the audio thread
+    // when the generation moved and the lock is free.
+    std::mutex pending_lock;
+    otk_audio_chain_config pending;
+    std::atomic<uint32_t> pending_generation;
+
+    // Audio thread only.
+    otk_audio_chain_config config;
+    uint32_t generation;
+    int sample_rate;
+    biquad high_pass;
+    std::vector<float> high_pass_state;
+    double agc_gain_db;
+    float agc_gain;
+    float gain;
+    float limiter_gain;
+
+    stage_timer timers[OTK_AUDIO_STAGE_COUNT];
+};
+
+static inline float db_to_linear(double db) {
+    return (float)std::pow(10.0, db / 20);
+}
+
+static inline double linear_to_db(double linear) {
+    return 20 * std::log10(std::max(linear, 1e-10));
+}
+
+static int64_t now_ns() {
+    return (int64_t)std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+// Multiplies x by a gain going linearly from g0 to g1 over the block.
+static void apply_ramp(float *x, size_t n, float g0, float g1) {
+    if (n == 0) {
+        return;
+    }
+    float step = (g1 - g0) / (float)n;
+    size_t i = 0;
+#if OTK_AUDIO_NEON
+    const float start[4] = { 0, 1, 2, 3 };
+    float32x4_t g = vmlaq_n_f32(vdupq_n_f32(g0), vld1q_f32(start), step);
+    const float32x4_t increment = vdupq_n_f32(4 * step);
+    for (; i + 4 <= n; i += 4) {
+        vst1q_f32(x + i, vmulq_f32(vld1q_f32(x + i), g));
+        g = vaddq_f32(g, increment);
+    }
+#elif OTK_AUDIO_SSE2
+    __m128 g = _mm_add_ps(_mm_set1_ps(g0), _mm_mul_ps(_mm_setr_ps(0, 1, 2, 3), _mm_set1_ps(step)));
+    const __m128 increment = _mm_set1_ps(4 * step);
+    for (; i + 4 <= n; i += 4) {
+        _mm_storeu_ps(x + i, _mm_mul_ps(_mm_loadu_ps(x + i), g));
+        g = _mm_add_ps(g, increment);
+    }
+#endif
+    for (; i < n; i++) {
+        x[i] *= g0 + step * (float)i;
+    }
+}
+
+static double sum_squares(const float *x, size_t n) {
+    size_t i = 0;
+    float total = 0;
+#if OTK_AUDIO_NEON
+    float32x4_t sums = vdupq_n_f32(0);
+    for (; i + 4 <= n; i += 4) {
+        float32x4_t v = vld1q_f32(x + i);
+        sums = vmlaq_f32(sums, v, v);
+    }
+    total = vgetq_lane_f32(sums, 0) + vgetq_lane_f32(sums, 1) + vgetq_lane_f32(sums, 2) + vgetq_lane_f32(sums, 3);
+#elif OTK_AUDIO_SSE2
+    __m128 sums = _mm_setzero_ps();
+    for (; i + 4 <= n; i += 4) {
+        __m128 v = _mm_loadu_ps(x + i);
+        sums = _mm_add_ps(sums, _mm_mul_ps(v, v));
+    }
+    float lanes[4];
+    _mm_storeu_ps(lanes, sums);
+    total = lanes[0] + lanes[1] + lanes[2] + lanes[3];
+#endif
+    for (; i < n; i++) {
+        total += x[i] * x[i];
+    }
+    return total;
+}
+
+static float peak_abs(const float *x, size_t n) {
+    size_t i = 0;
+    float peak = 0;
+#if OTK_AUDIO_NEON
+    float32x4_t peaks = vdupq_n_f32(0);
+    for (; i + 4 <= n; i += 4) {
+        peaks = vmaxq_f32(peaks, vabsq_f32(vld1q_f32(x + i)));
+    }
+    peak = std::max(std::max(vgetq_lane_f32(peaks, 0), vgetq_lane_f32(peaks, 1)),
+                    std::max(vgetq_lane_f32(peaks, 2), vgetq_lane_f32(peaks, 3)));
+#elif OTK_AUDIO_SSE2
+    const __m128 magnitude = _mm_castsi128_ps(_mm_set1_epi32(0x7fffffff));
+    __m128 peaks = _mm_setzero_ps();
+    for (; i + 4 <= n; i += 4) {
+        peaks = _mm_max_ps(peaks, _mm_and_ps(_mm_loadu_ps(x + i), magnitude));
+    }
+    float lanes[4];
+    _mm_storeu_ps(lanes, peaks);
+    peak = std::max(std::max(lanes[0], lanes[1]), std::max(lanes[2], lanes[3]));
+#endif
+    for (; i < n; i++) {
+        peak = std::max(peak, std::fabs(x[i]));
+    }
+    return peak;
+}
+
+static void clip(float *x, size_t n, float low, float high) {
+    size_t i = 0;
+#if OTK_AUDIO_NEON
+    const float32x4_t lows = vdupq_n_f32(low), highs = vdupq_n_f32(high);
+    for (; i + 4 <= n; i += 4) {
+        vst1q_f32(x + i, vminq_f32(vmaxq_f32(vld1q_f32(x + i), lows), highs));
+    }
+#elif OTK_AUDIO_SSE2
+    const __m128 lows = _mm_set1_ps(low), highs = _mm_set1_ps(high);
+    for (; i + 4 <= n; i += 4) {
+        _mm_storeu_ps(x + i, _mm_min_ps(_mm_max_ps(_mm_loadu_ps(x + i), lows), highs));
+    }
+#endif
+    for (; i < n; i++) {
+        x[i] = std::min(std::max(x[i], low), high);
+    }
+}
+
+static void int16_to_float(const int16_t *in, float *out, size_t n) {
+    const float scale = 1.0f / 32768;
+    size_t i = 0;
+#if OTK_AUDIO_NEON
+    for (; i + 8 <= n; i += 8) {
+        int16x8_t v = vld1q_s16(in + i);
+        vst1q_f32(out + i, vmulq_n_f32(vcvtq_f32_s32(vmovl_s16(vget_low_s16(v))), scale));
+        vst1q_f32(out + i + 4, vmulq_n_f32(vcvtq_f32_s32(vmovl_s16(vget_high_s16(v))), scale));
+    }
+#elif OTK_AUDIO_SSE2
+    const __m128 scales = _mm_set1_ps(scale);
+    for (; i + 8 <= n; i += 8) {
+        __m128i v = _mm_loadu_si128((const __m128i *)(in + i));
+        __m128i lo = _mm_srai_epi32(_mm_unpacklo_epi16(v, v), 16);
+        __m128i hi = _mm_srai_epi32(_mm_unpackhi_epi16(v, v), 16);
+        _mm_storeu_ps(out + i, _mm_mul_ps(_mm_cvtepi32_ps(lo), scales));
+        _mm_storeu_ps(out + i + 4, _mm_mul_ps(_mm_cvtepi32_ps(hi), scales));
+    }
+#endif
+    for (; i < n; i++) {
+        out[i] = in[i] * scale;
+    }
+}
+
+// Rounds to nearest; the input is clipped to the int16 range first.
+static void float_to_int16(float *in, int16_t *out, size_t n) {
+    clip(in, n, -1.0f, kInt16Max);
+    size_t i = 0;
+#if OTK_AUDIO_NEON
+    const uint32x4_t sign = vdupq_n_u32(0x80000000u);
+    const uint32x4_t half = vreinterpretq_u32_f32(vdupq_n_f32(0.5f));
+    for (; i + 8 <= n; i += 8) {
+        int32x4_t words[2];
+        for (int j = 0; j < 2; j++) {
+            float32x4_t v = vmulq_n_f32(vld1q_f32(in + i + 4 * j), 32768.0f);
+            // Add +/-0.5 and truncate: round half away from zero.
+            float32x4_t offset = vreinterpretq_f32_u32(vorrq_u32(vandq_u32(vreinterpretq_u32_f32(v), sign), half));
+            words[j] = vcvtq_s32_f32(vaddq_f32(v, offset));
+        }
+        vst1q_s16(out + i, vcombine_s16(vqmovn_s32(words[0]), vqmovn_s32(words[1])));
+    }
+#elif OTK_AUDIO_SSE2
+    const __m128 scale = _mm_set1_ps(32768.0f);
+    for (; i + 8 <= n; i += 8) {
+        __m128i lo = _mm_cvtps_epi32(_mm_mul_ps(_mm_loadu_ps(in + i), scale));
+        __m128i hi = _mm_cvtps_epi32(_mm_mul_ps(_mm_loadu_ps(in + i + 4), scale));
+        _mm_storeu_si128((__m128i *)(out + i), _mm_packs_epi32(lo, hi));
+    }
+#endif
+    for (; i < n; i++) {
+        out[i] = (int16_t)std::lrint(in[i] * 32768.0f);
+    }
+}
+
+// RBJ cookbook high-pass with Q = 1/sqrt(2).
+static biquad high_pass_coefficients(double hz, int sample_rate) {
+    double w0 = 2 * kPi * std::min(std::max(hz, 1.0), sample_rate * 0.45) / sample_rate;
+    double cos_w0 = std::cos(w0);
+    double alpha = std::sin(w0) / (2 * std::sqrt(0.5));
+    double a0 = 1 + alpha;
+    biquad q;
+    q.b0 = (float)((1 + cos_w0) / 2 / a0);
+    q.b1 = (float)(-(1 + cos_w0) / a0);
+    q.b2 = q.b0;
+    q.a1 = (float)(-2 * cos_w0 / a0);
+    q.a2 = (float)((1 - alpha) / a0);
+    return q;
+}
+
+// Each output depends on the previous ones, so channels are filtered one by
+// one in transposed direct form II.
+static void run_high_pass(otk_audio_chain *chain, float *x, size_t frames, size_t channels) {
+    const biquad &q = chain->high_pass;
+    for (size_t c = 0; c < channels; c++) {
+        float z1 = chain->high_pass_state[2 * c];
+        float z2 = chain->high_pass_state[2 * c + 1];
+        for (size_t i = 0; i < frames; i++) {
+            float in = x[i * channels + c];
+            float out = q.b0 * in + z1;
+            z1 = q.b1 * in - q.a1 * out + z2;
+            z2 = q.b2 * in - q.a2 * out;
+            x[i * channels + c] = out;
+        }
+        chain->high_pass_state[2 * c] = std::fabs(z1) < kDenormalFloor ? 0 : z1;
+        chain->high_pass_state[2 * c + 1] = std::fabs(z2) < kDenormalFloor ? 0 : z2;
+    }
+}
+
+static void run_agc(otk_audio_chain *chain, float *x, size_t n, double block_ms) {
+    const otk_audio_chain_config &config = chain->config;
+    double level_db = linear_to_db(std::sqrt(sum_squares(x, n) / (double)n));
+    if (level_db >= config.agc_gate_dbfs) {
+        double target = std::min<double>(std::max<double>(config.agc_target_dbfs - level_db,
+                                                          -config.agc_max_gain_db),
+                                         config.agc_max_gain_db);
+        double time_constant = target < chain->agc_gain_db ? kAgcAttackMs : kAgcReleaseMs;
+        chain->agc_gain_db += (target - chain->agc_gain_db) * (1 - std::exp(-block_ms / time_constant));
+    }
+    float gain = db_to_linear(chain->agc_gain_db);
+    apply_ramp(x, n, chain->agc_gain, gain);
+    chain->agc_gain = gain;
+}
+
+static void run_gain(otk_audio_chain *chain, float *x, size_t n) {
+    float gain = db_to_linear(chain->config.gain_db);
+    apply_ramp(x, n, chain->gain, gain);
+    chain->gain = gain;
+}
+
+static void run_limiter(otk_audio_chain *chain, float *x, size_t n, double block_ms) {
+    float ceiling = db_to_linear(chain->config.limiter_ceiling_dbfs);
+    float peak = peak_abs(x, n);
+    float needed = peak > ceiling ? ceiling / peak : 1.0f;
+    if (needed < chain->limiter_gain) {
+        // Attack at once: a ramp would let the start of the block through.
+        chain->limiter_gain = needed;
+        apply_ramp(x, n, needed, needed);
+    } else {
+        double release = std::max<double>(chain->config.limiter_release_ms, 1);
+        float gain = chain->limiter_gain +
+                     (1 - chain->limiter_gain) * (float)(1 - std::exp(-block_ms / release));
+        gain = std::min(gain, needed);
+        apply_ramp(x, n, chain->limiter_gain, gain);
+        chain->limiter_gain = gain;
+    }
+    clip(x, n, -ceiling, ceiling);
+}
+
+static void record(stage_timer &timer, int64_t elapsed_ns) {
+    uint64_t ns = (uint64_t)std::max<int64_t>(elapsed_ns, 1);
+    int bucket = std::min(OTK_AUDIO_STAGE_HISTOGRAM_BUCKETS - 1, 63 - __builtin_clzll(ns));
+    timer.blocks.fetch_add(1, std::memory_order_relaxed);
+    timer.total_ns.fetch_add(ns, std::memory_order_relaxed);
+    timer.histogram[bucket].fetch_add(1, std::memory_order_relaxed);
+    if (ns > timer.max_ns.load(std::memory_order_relaxed)) {
+        timer.max_ns.store(ns, std::memory_order_relaxed);
+    }
+}
+
+// Picks up a new configuration; stages that stay enabled keep their state.
+static void update_config(otk_audio_chain *chain, size_t channels, int sample_rate) {
+    uint32_t generation = chain->pending_generation.load(std::memory_order_acquire);
+    bool rate_changed = sample_rate != chain->sample_rate;
+    if (generation == chain->generation && !rate_changed) {
+        return;
+    }
+    otk_audio_chain_config previous = chain->config;
+    if (generation != chain->generation) {
+        std::unique_lock<std::mutex> guard(chain->pending_lock, std::try_to_lock);
+        if (guard.owns_lock()) {
+            chain->config = chain->pending;
+            chain->generation = generation;
+        }
+    }
+    const otk_audio_chain_config &config = chain->config;
+    if (rate_changed || config.high_pass_hz != previous.high_pass_hz) {
+        chain->high_pass = high_pass_coefficients(config.high_pass_hz, sample_rate);
+    }
+    if (rate_changed || (config.high_pass_enabled && !previous.high_pass_enabled)) {
+        std::fill(chain->high_pass_state.begin(), chain->high_pass_state.begin() + 2 * channels, 0.0f);
+    }
+    if (config.agc_enabled && !previous.agc_enabled) {
+        chain->agc_gain_db = 0;
+        chain->agc_gain = 1;
+    }
+    if (config.gain_enabled && !previous.gain_enabled) {
+        chain->gain = 1;
+    }
+    if (config.limiter_enabled && !previous.limiter_enabled) {
+        chain->limiter_gain = 1;
+    }
+    chain->sample_rate = sample_rate;
+}
+
+otk_audio_chain_config otk_audio_chain_default_config(void) {
+    otk_audio_chain_config config;
+    config.high_pass_enabled = 1;
+    config.high_pass_hz = 80;
+    config.agc_enabled = 1;
+    config.agc_target_dbfs = -20;
+    config.agc_max_gain_db = 12;
+    config.agc_gate_dbfs = -50;
+    config.gain_enabled = 0;
+    config.gain_db = 0;
+    config.limiter_enabled = 1;
+    config.limiter_ceiling_dbfs = -1;
+    config.limiter_release_ms = 100;
+    return config;
+}
+
+otk_audio_chain *otk_audio_chain_new(const otk_audio_chain_config *config,
+                                     size_t max_frames,
+                                     size_t max_channels) {
+    if (max_frames == 0 || max_channels == 0) {
+        return nullptr;
+    }
+    otk_audio_chain *chain = new otk_audio_chain();
+    chain->max_frames = max_frames;
+    chain->max_channels = max_channels;
+    chain->scratch.resize(max_frames * max_channels);
+    chain->pending = config != nullptr ? *config : otk_audio_chain_default_config();
+    chain->pending_generation.store(1);
+    chain->config = chain->pending;
+    chain->generation = 1;
+    chain->sample_rate = 0;
+    chain->high_pass_state.assign(2 * max_channels, 0.0f);
+    chain->agc_gain_db = 0;
+    chain->agc_gain = 1;
+    chain->gain = 1;
+    chain->limiter_gain = 1;
+    for (stage_timer &timer : chain->timers) {
+        timer.blocks.store(0);
+        timer.total_ns.store(0);
+        timer.max_ns.store(0);
+        for (std::atomic<uint64_t> &bucket : timer.histogram) {
+            bucket.store(0);
+        }
+    }
+    return chain;
+}
+
+void otk_audio_chain_delete(otk_audio_chain *chain) {
+    delete chain;
+}
+
+void otk_audio_chain_configure(otk_audio_chain *chain, const otk_audio_chain_config *config) {
+    if (chain == nullptr || config == nullptr) {
+        return;
+    }
+    std::lock_guard<std::mutex> guard(chain->pending_lock);
+    chain->pending = *config;
+    chain->pending_generation.fetch_add(1, std::memory_order_release);
+}
+
+int otk_audio_chain_process_float(otk_audio_chain *chain,
+                                  float *samples,
+                                  size_t frames,
+                                  size_t channels,
+                                  int sample_rate) {
+    if (chain == nullptr || samples == nullptr || frames == 0 || channels == 0 || sample_rate <= 0 ||
+        frames > chain->max_frames || channels > chain->max_channels) {
+        return 0;
+    }
+    update_config(chain, channels, sample_rate);
+    const otk_audio_chain_config &config = chain->config;
+    size_t n = frames * channels;
+    double block_ms = 1000.0 * (double)frames / sample_rate;
+
+    int64_t started = now_ns();
+    if (config.high_pass_enabled) {
+        run_high_pass(chain, samples, frames, channels);
+        int64_t now = now_ns();
+        record(chain->timers[OTK_AUDIO_STAGE_HIGH_PASS], now - started);
+        started = now;
+    }
+    if (config.agc_enabled) {
+        run_agc(chain, samples, n, block_ms);
+        int64_t now = now_ns();
+        record(chain->timers[OTK_AUDIO_STAGE_AGC], now - started);
+        started = now;
+    }
+    if (config.gain_enabled) {
+        run_gain(chain, samples, n);
+        int64_t now = now_ns();
+        record(chain->timers[OTK_AUDIO_STAGE_GAIN], now - started);
+        started = now;
+    }
+    if (config.limiter_enabled) {
+        run_limiter(chain, samples, n, block_ms);
+        record(chain->timers[OTK_AUDIO_STAGE_LIMITER], now_ns() - started);
+    }
+    return 1;
+}
+
+int otk_audio_chain_process_int16(otk_audio_chain *chain,
+                                  int16_t *samples,
+                                  size_t frames,
+                                  size_t channels,
+                                  int sample_rate) {
+    if (chain == nullptr || samples == nullptr || frames > chain->max_frames || channels > chain->max_channels) {
+        return 0;
+    }
+    float *scratch = chain->scratch.data();
+    size_t n = frames * channels;
+    int16_to_float(samples, scratch, n);
+    if (!otk_audio_chain_process_float(chain, scratch, frames, channels, sample_rate)) {
+        return 0;
+    }
+    float_to_int16(scratch, samples, n);
+    return 1;
+}
+
+void otk_audio_chain_get_stage_stats(otk_audio_chain *chain,
+                                     enum otk_audio_stage stage,
+                                     otk_audio_stage_stats *stats) {
+    if (chain == nullptr || stats == nullptr || stage < 0 || stage >= OTK_AUDIO_STAGE_COUNT) {
+        return;
+    }
+    const stage_timer &timer = chain->timers[stage];
+    stats->blocks = timer.blocks.load(std::memory_order_relaxed);
+    stats->total_ns = timer.total_ns.load(std::memory_order_relaxed);
+    stats->max_ns = timer.max_ns.load(std::memory_order_relaxed);
+    for (int i = 0; i < OTK_AUDIO_STAGE_HISTOGRAM_BUCKETS; i++) {
+        stats->histogram[i] = timer.histogram[i].load(std::memory_order_relaxed);
+    }
+}
+
+uint64_t otk_audio_stage_stats_percentile_ns(const otk_audio_stage_stats *stats, double fraction) {
+    if (stats == nullptr) {
+        return 0;
+    }
+    uint64_t total = 0;
+    for (uint64_t count : stats->histogram) {
+        total += count;
+    }
+    if (total == 0) {
+        return 0;
+    }
+    uint64_t wanted = (uint64_t)std::ceil(std::min(std::max(fraction, 0.0), 1.0) * (double)total);
+    uint64_t seen = 0;
+    for (int i = 0; i < OTK_AUDIO_STAGE_HISTOGRAM_BUCKETS; i++) {
+        seen += stats->histogram[i];
+        if (seen >= std::max<uint64_t>(wanted, 1)) {
+            return (uint64_t)2 << i;
+        }
+    }
+    return (uint64_t)2 << (OTK_AUDIO_STAGE_HISTOGRAM_BUCKETS - 1);
+}
+
+const char *otk_audio_stage_name(enum otk_audio_stage stage) {
+    switch (stage) {
+        case OTK_AUDIO_STAGE_HIGH_PASS:
+            return "high-pass";
+        case OTK_AUDIO_STAGE_AGC:
+            return "agc";
+        case OTK_AUDIO_STAGE_GAIN:
+            return "gain";
+        case OTK_AUDIO_STAGE_LIMITER:
+            return "limiter";
+        default:
+            return "unknown";
+    }
+}
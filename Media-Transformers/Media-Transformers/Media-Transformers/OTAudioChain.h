@@ -0,0 +1,117 @@
+//
+//  OTAudioChain.h
+//  Media-Transformers
+//
+//  Copyright (c) 2026 Vonage. All rights reserved.
+//
+
+#ifndef OTAudioChain_h
+#define OTAudioChain_h
+
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * Chain of cheap audio stages run in place on interleaved blocks, meant for
+ * a custom audio transformer. The stages always run in this order, each one
+ * skipped when disabled:
+ *
+ *   high-pass -> automatic gain control -> gain -> peak limiter
+ *
+ * Blocks are processed as float; int16 blocks are converted in a buffer
+ * allocated up front, so processing never allocates or blocks. A new
+ * configuration is picked up at the start of the next block without
+ * touching the state of the stages it leaves enabled. Gain changes are
+ * ramped over a block so they do not click. The time every stage takes on
+ * every block is recorded in a histogram.
+ */
+typedef struct otk_audio_chain otk_audio_chain;
+
+enum otk_audio_stage {
+    OTK_AUDIO_STAGE_HIGH_PASS = 0,
+    OTK_AUDIO_STAGE_AGC = 1,
+    OTK_AUDIO_STAGE_GAIN = 2,
+    OTK_AUDIO_STAGE_LIMITER = 3,
+    OTK_AUDIO_STAGE_COUNT = 4,
+};
+
+typedef struct otk_audio_chain_config {
+    /** Second order Butterworth, removes rumble and DC. */
+    int high_pass_enabled;
+    float high_pass_hz;
+
+    /** Moves the block level towards the target, within +/- max gain. */
+    int agc_enabled;
+    float agc_target_dbfs;
+    float agc_max_gain_db;
+    /** Blocks quieter than this keep the current gain, so silence is not boosted. */
+    float agc_gate_dbfs;
+
+    int gain_enabled;
+    float gain_db;
+
+    /** Peaks above the ceiling are turned down at once and recover over the release time. */
+    int limiter_enabled;
+    float limiter_ceiling_dbfs;
+    float limiter_release_ms;
+} otk_audio_chain_config;
+
+/** Histogram bucket i counts blocks that took [2^i, 2^(i+1)) ns. */
+#define OTK_AUDIO_STAGE_HISTOGRAM_BUCKETS 32
+
+typedef struct otk_audio_stage_stats {
+    uint64_t blocks;
+    uint64_t total_ns;
+    uint64_t max_ns;
+    uint64_t histogram[OTK_AUDIO_STAGE_HISTOGRAM_BUCKETS];
+} otk_audio_stage_stats;
+
+/** High-pass at 80 Hz, AGC to -20 dBFS within 12 dB, limiter at -1 dBFS; gain off. */
+otk_audio_chain_config otk_audio_chain_default_config(void);
+
+/** Blocks of up to max_frames frames of up to max_channels channels. */
+otk_audio_chain *otk_audio_chain_new(const otk_audio_chain_config *config,
+                                     size_t max_frames,
+                                     size_t max_channels);
+
+void otk_audio_chain_delete(otk_audio_chain *chain);
+
+/** Safe from any thread while blocks are being processed. */
+void otk_audio_chain_configure(otk_audio_chain *chain, const otk_audio_chain_config *config);
+
+/**
+ * Processes an interleaved block in place. Returns 0, leaving the block
+ * untouched, on bad arguments or a block larger than the chain was created
+ * for.
+ */
+int otk_audio_chain_process_int16(otk_audio_chain *chain,
+                                  int16_t *samples,
+                                  size_t frames,
+                                  size_t channels,
+                                  int sample_rate);
+
+/** Same with samples in [-1, 1]. */
+int otk_audio_chain_process_float(otk_audio_chain *chain,
+                                  float *samples,
+                                  size_t frames,
+                                  size_t channels,
+                                  int sample_rate);
+
+void otk_audio_chain_get_stage_stats(otk_audio_chain *chain,
+                                     enum otk_audio_stage stage,
+                                     otk_audio_stage_stats *stats);
+
+/** Upper bound of the bucket holding the given fraction of blocks; 0 if none. */
+uint64_t otk_audio_stage_stats_percentile_ns(const otk_audio_stage_stats *stats, double fraction);
+
+const char *otk_audio_stage_name(enum otk_audio_stage stage);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* OTAudioChain_h */
@@ -0,0 +1,474 @@
+//
+//  OTBackgroundBlur.cpp
+//  Media-Transformers
+//
+//  Copyright (c) 2026 Vonage. All rights reserved.
+//
+
+#include "OTBackgroundBlur.h"
+#include "OTBandPool.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <mutex>
+#include <vector>
+
+#if defined(__ARM_NEON) || defined(__ARM_NEON__)
+#include <arm_neon.h>
+#define OTK_BLUR_NEON 1
+#elif defined(__SSE2__)
+#include <emmintrin.h>
+#define OTK_BLUR_SSE2 1
+#endif
+
+// Box sums are kept in 16 bits, so a window holds at most 257 pixels.
+static const uint32_t kMaxRadius = 127;
+
+// Bands per thread; more than one evens out bands that finish early.
+static const uint32_t kBandsPerThread = 3;
+
+struct blur_preset {
+    int passes;
+    // Luma radius at 720 rows; scaled with the frame height.
+    double radius_at_720p;
+};
+
+// Repeated passes widen the blur, so later presets use a smaller box for a
+// similar look.
+static const blur_preset kPresets[] = {
+    { 1, 12.0 },
+    { 2, 9.0 },
+    { 3, 7.5 },
+};
+
+enum blur_phase {
+    PHASE_HORIZONTAL,
+    PHASE_VERTICAL,
+    PHASE_BLEND,
+};
+
+struct blur_plane {
+    uint8_t *frame;
+    int stride;
+    uint32_t width;
+    uint32_t height;
+    uint32_t radius;
+    // Scratch planes with a stride of width: horizontal passes write to
+    // across, vertical passes to blurred.
+    uint8_t *across;
+    uint8_t *blurred;
+    const uint8_t *mask;
+    uint32_t bands;
+};
+
+struct blur_run {
+    blur_plane planes[3];
+    int pass;
+    blur_phase phase;
+};
+
+struct otk_background_blur {
+    otk_band_pool *pool;
+
+    std::mutex lock;
+    enum otk_blur_preset preset;
+    std::vector<uint8_t> source_mask;
+    uint32_t source_width;
+    uint32_t source_height;
+    uint32_t mask_generation;
+
+    // Only touched by the frame being processed.
+    std::vector<uint8_t> scratch[3][2];
+    std::vector<uint8_t> masks[3];
+    uint32_t masks_width;
+    uint32_t masks_height;
+    uint32_t masks_generation;
+
+    uint64_t frames;
+    int64_t last_frame_us;
+    int64_t total_frame_us;
+    uint32_t radius;
+};
+
+static inline uint32_t clamp_index(int64_t i, uint32_t size) {
+    return (uint32_t)std::min<int64_t>(std::max<int64_t>(i, 0), (int64_t)size - 1);
+}
+
+// Rounded sum / window with 16-bit arithmetic. recip is 65536 / window
+// rounded up, so the result is at most one above the exact quotient.
+static inline uint8_t box_divide(uint16_t sum, uint16_t half, uint16_t recip) {
+    return (uint8_t)(((uint32_t)(uint16_t)(sum + half) * recip) >> 16);
+}
+
+static void horizontal_row(const uint8_t *src, uint8_t *dst, uint32_t width, uint32_t radius,
+                           std::vector<uint16_t> &prefix) {
+    uint32_t window = 2 * radius + 1;
+    uint16_t half = (uint16_t)(window / 2);
+    uint16_t recip = (uint16_t)((65536 + window - 1) / window);
+    // Prefix sums over the row extended with its edge pixels. They wrap
+    // around in 16 bits, but differences over one window are still exact.
+    prefix.resize(width + window);
+    uint16_t *p = prefix.data();
+    uint16_t running = 0;
+    p[0] = 0;
+    for (uint32_t j = 1; j <= radius; j++) {
+        p[j] = running = (uint16_t)(running + src[0]);
+    }
+    for (uint32_t x = 0; x < width; x++) {
+        p[radius + 1 + x] = running = (uint16_t)(running + src[x]);
+    }
+    for (uint32_t j = radius + width + 1; j < width + window; j++) {
+        p[j] = running = (uint16_t)(running + src[width - 1]);
+    }
+    uint32_t x = 0;
+#if OTK_BLUR_NEON
+    const uint16x8_t halves = vdupq_n_u16(half);
+    const uint16x4_t recips = vdup_n_u16(recip);
+    for (; x + 8 <= width; x += 8) {
+        uint16x8_t sum = vaddq_u16(vsubq_u16(vld1q_u16(p + x + window), vld1q_u16(p + x)), halves);
+        uint16x4_t lo = vshrn_n_u32(vmull_u16(vget_low_u16(sum), recips), 16);
+        uint16x4_t hi = vshrn_n_u32(vmull_u16(vget_high_u16(sum), recips), 16);
+        vst1_u8(dst + x, vmovn_u16(vcombine_u16(lo, hi)));
+    }
+#elif OTK_BLUR_SSE2
+    const __m128i halves = _mm_set1_epi16((short)half);
+    const __m128i recips = _mm_set1_epi16((short)recip);
+    for (; x + 16 <= width; x += 16) {
+        __m128i sum0 = _mm_sub_epi16(_mm_loadu_si128((const __m128i *)(p + x + window)),
+                                     _mm_loadu_si128((const __m128i *)(p + x)));
+        __m128i sum1 = _mm_sub_epi16(_mm_loadu_si128((const __m128i *)(p + x + 8 + window)),
+                                     _mm_loadu_si128((const __m128i *)(p + x + 8)));
+        sum0 = _mm_mulhi_epu16(_mm_add_epi16(sum0, halves), recips);
+        sum1 = _mm_mulhi_epu16(_mm_add_epi16(sum1, halves), recips);
+        _mm_storeu_si128((__m128i *)(dst + x), _mm_packus_epi16(sum0, sum1));
+    }
+#endif
+    for (; x < width; x++) {
+        dst[x] = box_divide((uint16_t)(p[x + window] - p[x]), half, recip);
+    }
+}
+
+// Writes the averages in sums to dst, then slides the window one row down.
+static void vertical_row(uint16_t *sums, const uint8_t *add, const uint8_t *sub, uint8_t *dst,
+                         uint32_t width, uint16_t half, uint16_t recip) {
+    uint32_t x = 0;
+#if OTK_BLUR_NEON
+    const uint16x8_t halves = vdupq_n_u16(half);
+    const uint16x4_t recips = vdup_n_u16(recip);
+    for (; x + 8 <= width; x += 8) {
+        uint16x8_t sum = vld1q_u16(sums + x);
+        uint16x8_t rounded = vaddq_u16(sum, halves);
+        uint16x4_t lo = vshrn_n_u32(vmull_u16(vget_low_u16(rounded), recips), 16);
+        uint16x4_t hi = vshrn_n_u32(vmull_u16(vget_high_u16(rounded), recips), 16);
+        vst1_u8(dst + x, vmovn_u16(vcombine_u16(lo, hi)));
+        sum = vsubq_u16(vaddw_u8(sum, vld1_u8(add + x)), vmovl_u8(vld1_u8(sub + x)));
+        vst1q_u16(sums + x, sum);
+    }
+#elif OTK_BLUR_SSE2
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i halves = _mm_set1_epi16((short)half);
+    const __m128i recips = _mm_set1_epi16((short)recip);
+    for (; x + 16 <= width; x += 16) {
+        __m128i sum0 = _mm_loadu_si128((const __m128i *)(sums + x));
+        __m128i sum1 = _mm_loadu_si128((const __m128i *)(sums + x + 8));
+        __m128i out0 = _mm_mulhi_epu16(_mm_add_epi16(sum0, halves), recips);
+        __m128i out1 = _mm_mulhi_epu16(_mm_add_epi16(sum1, halves), recips);
+        _mm_storeu_si128((__m128i *)(dst + x), _mm_packus_epi16(out0, out1));
+        __m128i a = _mm_loadu_si128((const __m128i *)(add + x));
+        __m128i s = _mm_loadu_si128((const __m128i *)(sub + x));
+        sum0 = _mm_sub_epi16(_mm_add_epi16(sum0, _mm_unpacklo_epi8(a, zero)), _mm_unpacklo_epi8(s, zero));
+        sum1 = _mm_sub_epi16(_mm_add_epi16(sum1, _mm_unpackhi_epi8(a, zero)), _mm_unpackhi_epi8(s, zero));
+        _mm_storeu_si128((__m128i *)(sums + x), sum0);
+        _mm_storeu_si128((__m128i *)(sums + x + 8), sum1);
+    }
+#endif
+    for (; x < width; x++) {
+        dst[x] = box_divide(sums[x], half, recip);
+        sums[x] = (uint16_t)(sums[x] + add[x] - sub[x]);
+    }
+}
+
+// frame = (frame * a + blurred * (256 - a) + 128) / 256, a = mask scaled to 0..256.
+static void blend_row(uint8_t *frame, const uint8_t *blurred, const uint8_t *mask, uint32_t width) {
+    uint32_t x = 0;
+#if OTK_BLUR_NEON
+    const uint16x8_t full = vdupq_n_u16(256);
+    for (; x + 8 <= width; x += 8) {
+        uint16x8_t m = vmovl_u8(vld1_u8(mask + x));
+        uint16x8_t a = vaddq_u16(m, vshrq_n_u16(m, 7));
+        uint16x8_t t = vmulq_u16(vmovl_u8(vld1_u8(frame + x)), a);
+        t = vmlaq_u16(t, vmovl_u8(vld1_u8(blurred + x)), vsubq_u16(full, a));
+        vst1_u8(frame + x, vrshrn_n_u16(t, 8));
+    }
+#elif OTK_BLUR_SSE2
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i full = _mm_set1_epi16(256);
+    const __m128i round = _mm_set1_epi16(128);
+    for (; x + 16 <= width; x += 16) {
+        __m128i f = _mm_loadu_si128((const __m128i *)(frame + x));
+        __m128i b = _mm_loadu_si128((const __m128i *)(blurred + x));
+        __m128i m = _mm_loadu_si128((const __m128i *)(mask + x));
+        __m128i out[2];
+        for (int half = 0; half < 2; half++) {
+            __m128i fh = half ? _mm_unpackhi_epi8(f, zero) : _mm_unpacklo_epi8(f, zero);
+            __m128i bh = half ? _mm_unpackhi_epi8(b, zero) : _mm_unpacklo_epi8(b, zero);
+            __m128i mh = half ? _mm_unpackhi_epi8(m, zero) : _mm_unpacklo_epi8(m, zero);
+            __m128i a = _mm_add_epi16(mh, _mm_srli_epi16(mh, 7));
+            __m128i t = _mm_add_epi16(_mm_mullo_epi16(fh, a), _mm_mullo_epi16(bh, _mm_sub_epi16(full, a)));
+            out[half] = _mm_srli_epi16(_mm_add_epi16(t, round), 8);
+        }
+        _mm_storeu_si128((__m128i *)(frame + x), _mm_packus_epi16(out[0], out[1]));
+    }
+#endif
+    for (; x < width; x++) {
+        uint32_t a = mask[x] + (mask[x] >> 7);
+        frame[x] = (uint8_t)((frame[x] * a + blurred[x] * (256 - a) + 128) >> 8);
+    }
+}
+
+static void horizontal_band(const blur_plane &plane, int pass, uint32_t first, uint32_t last) {
+    thread_local std::vector<uint16_t> prefix;
+    for (uint32_t y = first; y < last; y++) {
+        const uint8_t *src = pass == 0 ? plane.frame + (size_t)y * plane.stride :
+                                         plane.blurred + (size_t)y * plane.width;
+        horizontal_row(src, plane.across + (size_t)y * plane.width, plane.width, plane.radius, prefix);
+    }
+}
+
+static void vertical_band(const blur_plane &plane, uint32_t first, uint32_t last) {
+    thread_local std::vector<uint16_t> sums;
+    uint32_t width = plane.width;
+    int64_t radius = plane.radius;
+    uint32_t window = 2 * plane.radius + 1;
+    uint16_t half = (uint16_t)(window / 2);
+    uint16_t recip = (uint16_t)((65536 + window - 1) / window);
+    const uint8_t *src = plane.across;
+
+    sums.assign(width, 0);
+    for (int64_t k = -radius; k <= radius; k++) {
+        const uint8_t *row = src + (size_t)clamp_index((int64_t)first + k, plane.height) * width;
+        for (uint32_t x = 0; x < width; x++) {
+            sums[x] = (uint16_t)(sums[x] + row[x]);
+        }
+    }
+    for (uint32_t y = first; y < last; y++) {
+        const uint8_t *add = src + (size_t)clamp_index((int64_t)y + radius + 1, plane.height) * width;
+        const uint8_t *sub = src + (size_t)clamp_index((int64_t)y - radius, plane.height) * width;
+        vertical_row(sums.data(), add, sub, plane.blurred + (size_t)y * width, width, half, recip);
+    }
+}
+
+static void blend_band(const blur_plane &plane, uint32_t first, uint32_t last) {
+    for (uint32_t y = first; y < last; y++) {
+        blend_row(plane.frame + (size_t)y * plane.stride, plane.blurred + (size_t)y * plane.width,
+                  plane.mask + (size_t)y * plane.width, plane.width);
+    }
+}
+
+static void run_band(void *user_data, uint32_t band, uint32_t) {
+    blur_run *run = (blur_run *)user_data;
+    int index = 0;
+    while (band >= run->planes[index].bands) {
+        band -= run->planes[index].bands;
+        index++;
+    }
+    const blur_plane &plane = run->planes[index];
+    uint32_t first, last;
+    otk_band_rows(band, plane.bands, plane.height, &first, &last);
+    switch (run->phase) {
+        case PHASE_HORIZONTAL:
+            horizontal_band(plane, run->pass, first, last);
+            break;
+        case PHASE_VERTICAL:
+            vertical_band(plane, first, last);
+            break;
+        case PHASE_BLEND:
+            blend_band(plane, first, last);
+            break;
+    }
+}
+
+static void scale_mask(const uint8_t *src, uint32_t src_width, uint32_t src_height,
+                       uint8_t *dst, uint32_t width, uint32_t height) {
+    for (uint32_t y = 0; y < height; y++) {
+        const uint8_t *row = src + (size_t)((uint64_t)y * src_height / height) * src_width;
+        for (uint32_t x = 0; x < width; x++) {
+            dst[(size_t)y * width + x] = row[(uint64_t)x * src_width / width];
+        }
+    }
+}
+
+void otk_background_blur_portrait_mask(uint8_t *mask, uint32_t width, uint32_t height) {
+    if (mask == nullptr) {
+        return;
+    }
+    // Head and shoulders: an ellipse that widens below its center and runs
+    // off the bottom of the frame, feathered over its outer 20%.
+    const double center_x = width * 0.5, center_y = height * 0.6;
+    const double radius_x = width * 0.22, radius_y = height * 0.5;
+    const double inner = 0.8;
+    for (uint32_t y = 0; y < height; y++) {
+        double dy = (y + 0.5 - center_y) / radius_y;
+        double widen = dy > 0 ? 1 + 0.8 * std::min(dy, 1.0) : 1;
+        for (uint32_t x = 0; x < width; x++) {
+            double dx = (x + 0.5 - center_x) / (radius_x * widen);
+            double distance = std::sqrt(dx * dx + dy * dy);
+            double keep = std::min(1.0, std::max(0.0, (1 - distance) / (1 - inner)));
+            mask[(size_t)y * width + x] = (uint8_t)std::lround(keep * 255);
+        }
+    }
+}
+
+otk_background_blur *otk_background_blur_new(enum otk_blur_preset preset, uint32_t threads) {
+    otk_background_blur *blur = new otk_background_blur();
+    blur->pool = otk_band_pool_new(threads);
+    blur->preset = preset;
+    blur->source_width = 0;
+    blur->source_height = 0;
+    blur->mask_generation = 0;
+    blur->masks_width = 0;
+    blur->masks_height = 0;
+    blur->masks_generation = 0;
+    blur->frames = 0;
+    blur->last_frame_us = 0;
+    blur->total_frame_us = 0;
+    blur->radius = 0;
+    return blur;
+}
+
+void otk_background_blur_delete(otk_background_blur *blur) {
+    if (blur == nullptr) {
+        return;
+    }
+    otk_band_pool_delete(blur->pool);
+    delete blur;
+}
+
+void otk_background_blur_set_preset(otk_background_blur *blur, enum otk_blur_preset preset) {
+    if (blur == nullptr) {
+        return;
+    }
+    std::lock_guard<std::mutex> guard(blur->lock);
+    blur->preset = preset;
+}
+
+void otk_background_blur_set_mask(otk_background_blur *blur,
+                                  const uint8_t *mask,
+                                  uint32_t width,
+                                  uint32_t height,
+                                  uint32_t stride) {
+    if (blur == nullptr || mask == nullptr || width == 0 || height == 0 || stride < width) {
+        return;
+    }
+    std::lock_guard<std::mutex> guard(blur->lock);
+    blur->source_mask.resize((size_t)width * height);
+    for (uint32_t y = 0; y < height; y++) {
+        std::copy(mask + (size_t)y * stride, mask + (size_t)y * stride + width,
+                  blur->source_mask.begin() + (ptrdiff_t)((size_t)y * width));
+    }
+    blur->source_width = width;
+    blur->source_height = height;
+    blur->mask_generation++;
+}
+
+// Scales the mask to the luma and chroma sizes when either changed.
+static void update_masks(otk_background_blur *blur, uint32_t width, uint32_t height) {
+    uint32_t chroma_width = (width + 1) / 2, chroma_height = (height + 1) / 2;
+    std::lock_guard<std::mutex> guard(blur->lock);
+    if (blur->masks_width == width && blur->masks_height == height &&
+        blur->masks_generation == blur->mask_generation) {
+        return;
+    }
+    blur->masks[0].resize((size_t)width * height);
+    if (blur->source_mask.empty()) {
+        otk_background_blur_portrait_mask(blur->masks[0].data(), width, height);
+    } else {
+        scale_mask(blur->source_mask.data(), blur->source_width, blur->source_height,
+                   blur->masks[0].data(), width, height);
+    }
+    blur->masks[1].resize((size_t)chroma_width * chroma_height);
+    scale_mask(blur->masks[0].data(), width, height, blur->masks[1].data(), chroma_width, chroma_height);
+    blur->masks_width = width;
+    blur->masks_height = height;
+    blur->masks_generation = blur->mask_generation;
+}
+
+int otk_background_blur_process(otk_background_blur *blur,
+                                 uint8_t *y, int y_stride,
+                                 uint8_t *u, int u_stride,
+                                 uint8_t *v, int v_stride,
+                                 uint32_t width,
+                                 uint32_t height) {
+    if (blur == nullptr || y == nullptr || u == nullptr || v == nullptr ||
+        width < 2 || height < 2 || y_stride < (int)width ||
+        u_stride < (int)(width + 1) / 2 || v_stride < (int)(width + 1) / 2) {
+        return 0;
+    }
+    auto started = std::chrono::steady_clock::now();
+    enum otk_blur_preset preset;
+    {
+        std::lock_guard<std::mutex> guard(blur->lock);
+        preset = blur->preset;
+    }
+    const blur_preset &settings = kPresets[std::min<int>(std::max<int>(preset, 0), OTK_BLUR_QUALITY)];
+    update_masks(blur, width, height);
+
+    uint32_t radius = (uint32_t)std::lround(settings.radius_at_720p * height / 720.0);
+    radius = std::min(kMaxRadius, std::max(1u, radius));
+    uint32_t chroma_radius = std::max(1u, radius / 2);
+    uint32_t band_target = otk_band_pool_threads(blur->pool) * kBandsPerThread;
+
+    blur_run run;
+    uint8_t *frames[3] = { y, u, v };
+    int strides[3] = { y_stride, u_stride, v_stride };
+    uint32_t total_bands = 0;
+    for (int i = 0; i < 3; i++) {
+        blur_plane &plane = run.planes[i];
+        plane.frame = frames[i];
+        plane.stride = strides[i];
+        plane.width = i == 0 ? width : (width + 1) / 2;
+        plane.height = i == 0 ? height : (height + 1) / 2;
+        plane.radius = i == 0 ? radius : chroma_radius;
+        for (int j = 0; j < 2; j++) {
+            blur->scratch[i][j].resize((size_t)plane.width * plane.height);
+        }
+        plane.across = blur->scratch[i][0].data();
+        plane.blurred = blur->scratch[i][1].data();
+        plane.mask = blur->masks[i == 0 ? 0 : 1].data();
+        plane.bands = std::min(plane.height, band_target);
+        total_bands += plane.bands;
+    }
+
+    // Each pass needs every row of the previous one, so the pool waits
+    // between phases.
+    for (run.pass = 0; run.pass < settings.passes; run.pass++) {
+        run.phase = PHASE_HORIZONTAL;
+        otk_band_pool_run(blur->pool, total_bands, run_band, &run);
+        run.phase = PHASE_VERTICAL;
+        otk_band_pool_run(blur->pool, total_bands, run_band, &run);
+    }
+    run.phase = PHASE_BLEND;
+    otk_band_pool_run(blur->pool, total_bands, run_band, &run);
+
+    int64_t elapsed = (int64_t)std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::steady_clock::now() - started).count();
+    std::lock_guard<std::mutex> guard(blur->lock);
+    blur->frames++;
+    blur->last_frame_us = elapsed;
+    blur->total_frame_us += elapsed;
+    blur->radius = radius;
+    return 1;
+}
+
+void otk_background_blur_get_stats(otk_background_blur *blur, otk_blur_stats *stats) {
+    if (blur == nullptr || stats == nullptr) {
+        return;
+    }
+    std::lock_guard<std::mutex> guard(blur->lock);
+    stats->frames = blur->frames;
+    stats->last_frame_us = blur->last_frame_us;
+    stats->average_frame_us = blur->frames ? blur->total_frame_us / (int64_t)blur->frames : 0;
+    stats->threads = otk_band_pool_threads(blur->pool);
+    stats->radius = blur->radius;
+}
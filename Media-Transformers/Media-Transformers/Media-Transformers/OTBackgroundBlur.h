@@ -0,0 +1,86 @@
+//
+//  OTBackgroundBlur.h
+//  Media-Transformers
+//
+//  Copyright (c) 2026 Vonage. All rights reserved.
+//
+
+#ifndef OTBackgroundBlur_h
+#define OTBackgroundBlur_h
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * Background blur for I420 frames, run as a custom video transformer.
+ *
+ * Each plane is blurred with repeated separable box filters, which
+ * approach a Gaussian and cost the same whatever the radius, then blended
+ * with the original through a mask: 255 keeps the pixel sharp, 0 replaces
+ * it with the blurred one. Every pass splits the planes into bands of rows
+ * processed in parallel (see OTBandPool.h), with SSE2 or NEON kernels when
+ * available.
+ */
+typedef struct otk_background_blur otk_background_blur;
+
+enum otk_blur_preset {
+    /** One box pass: blockier, about three times cheaper than QUALITY. */
+    OTK_BLUR_FAST = 0,
+    /** Two passes, a triangle filter. */
+    OTK_BLUR_BALANCED = 1,
+    /** Three passes, close to a Gaussian. */
+    OTK_BLUR_QUALITY = 2,
+};
+
+typedef struct otk_blur_stats {
+    uint64_t frames;
+    int64_t last_frame_us;
+    int64_t average_frame_us;
+    /** Threads working on each frame, including the caller's. */
+    uint32_t threads;
+    /** Luma blur radius used for the last frame. */
+    uint32_t radius;
+} otk_blur_stats;
+
+/** threads counts the calling thread; 0 for one per core. */
+otk_background_blur *otk_background_blur_new(enum otk_blur_preset preset, uint32_t threads);
+
+void otk_background_blur_delete(otk_background_blur *blur);
+
+/** Takes effect from the next frame. */
+void otk_background_blur_set_preset(otk_background_blur *blur, enum otk_blur_preset preset);
+
+/**
+ * Copies the mask, which is scaled to every frame size. Until a mask is
+ * set a portrait mask is used (see otk_background_blur_portrait_mask).
+ */
+void otk_background_blur_set_mask(otk_background_blur *blur,
+                                  const uint8_t *mask,
+                                  uint32_t width,
+                                  uint32_t height,
+                                  uint32_t stride);
+
+/**
+ * Fills mask with a feathered ellipse around the center and lower part of
+ * the frame, where a person facing a webcam usually is.
+ */
+void otk_background_blur_portrait_mask(uint8_t *mask, uint32_t width, uint32_t height);
+
+/** Blurs the background of an I420 frame in place. Returns 0 on bad arguments. */
+int otk_background_blur_process(otk_background_blur *blur,
+                                 uint8_t *y, int y_stride,
+                                 uint8_t *u, int u_stride,
+                                 uint8_t *v, int v_stride,
+                                 uint32_t width,
+                                 uint32_t height);
+
+void otk_background_blur_get_stats(otk_background_blur *blur, otk_blur_stats *stats);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* OTBackgroundBlur_h */
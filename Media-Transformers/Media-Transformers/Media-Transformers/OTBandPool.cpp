@@ -0,0 +1,149 @@
+//
+//  OTBandPool.cpp
+//  Media-Transformers
+//
+//  Copyright (c) 2026 Vonage. All rights reserved.
+//
+
+#include "OTBandPool.h"
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+struct otk_band_pool {
+    std::vector<std::thread> workers;
+
+    std::mutex lock;
+    std::condition_variable started;
+    std::condition_variable finished;
+    bool stopping;
+
+    // The current run, published under lock with a new generation.
+    uint32_t generation;
+    otk_band_fn fn;
+    void *user_data;
+    uint32_t band_count;
+    // Generation in the high half and next band in the low half, so a
+    // worker still finishing the previous run cannot claim a band of this
+    // one with the previous function.
+    std::atomic<uint64_t> ticket;
+    std::atomic<uint32_t> bands_done;
+};
+
+// Claims and processes bands of the given run until none are left.
+static void work(otk_band_pool *pool, uint32_t generation, otk_band_fn fn, void *user_data,
+                 uint32_t band_count) {
+    uint64_t ticket = pool->ticket.load(std::memory_order_acquire);
+    while (true) {
+        if ((uint32_t)(ticket >> 32) != generation || (uint32_t)ticket >= band_count) {
+            return;
+        }
+        if (!pool->ticket.compare_exchange_weak(ticket, ticket + 1, std::memory_order_acq_rel)) {
+            continue;
+        }
+        fn(user_data, (uint32_t)ticket, band_count);
+        if (pool->bands_done.fetch_add(1, std::memory_order_acq_rel) + 1 == band_count) {
+            std::lock_guard<std::mutex> guard(pool->lock);
+            pool->finished.notify_all();
+        }
+        ticket = pool->ticket.load(std::memory_order_acquire);
+    }
+}
+
+static void worker_main(otk_band_pool *pool) {
+    uint32_t seen = 0;
+    while (true) {
+        uint32_t generation;
+        otk_band_fn fn;
+        void *user_data;
+        uint32_t band_count;
+        {
+            std::unique_lock<std::mutex> guard(pool->lock);
+            pool->started.wait(guard, [&]() { return pool->stopping || pool->generation != seen; });
+            if (pool->stopping) {
+                return;
+            }
+            seen = generation = pool->generation;
+            fn = pool->fn;
+            user_data = pool->user_data;
+            band_count = pool->band_count;
+        }
+        work(pool, generation, fn, user_data, band_count);
+    }
+}
+
+otk_band_pool *otk_band_pool_new(uint32_t threads) {
+    if (threads == 0) {
+        threads = std::max(1u, std::thread::hardware_concurrency());
+    }
+    otk_band_pool *pool = new otk_band_pool();
+    pool->stopping = false;
+    pool->generation = 0;
+    pool->fn = nullptr;
+    pool->user_data = nullptr;
+    pool->band_count = 0;
+    pool->ticket.store(0);
+    pool->bands_done.store(0);
+    for (uint32_t i = 1; i < threads; i++) {
+        pool->workers.emplace_back(worker_main, pool);
+    }
+    return pool;
+}
+
+void otk_band_pool_delete(otk_band_pool *pool) {
+    if (pool == nullptr) {
+        return;
+    }
+    {
+        std::lock_guard<std::mutex> guard(pool->lock);
+        pool->stopping = true;
+    }
+    pool->started.notify_all();
+    for (std::thread &worker : pool->workers) {
+        worker.join();
+    }
+    delete pool;
+}
+
+uint32_t otk_band_pool_threads(otk_band_pool *pool) {
+    return pool != nullptr ? (uint32_t)pool->workers.size() + 1 : 1;
+}
+
+void otk_band_pool_run(otk_band_pool *pool, uint32_t band_count, otk_band_fn fn, void *user_data) {
+    if (band_count == 0 || fn == nullptr) {
+        return;
+    }
+    if (pool == nullptr || pool->workers.empty() || band_count == 1) {
+        for (uint32_t band = 0; band < band_count; band++) {
+            fn(user_data, band, band_count);
+        }
+        return;
+    }
+    uint32_t generation;
+    {
+        std::lock_guard<std::mutex> guard(pool->lock);
+        generation = ++pool->generation;
+        pool->fn = fn;
+        pool->user_data = user_data;
+        pool->band_count = band_count;
+        pool->bands_done.store(0, std::memory_order_relaxed);
+        pool->ticket.store((uint64_t)generation << 32, std::memory_order_release);
+    }
+    pool->started.notify_all();
+    work(pool, generation, fn, user_data, band_count);
+
+    std::unique_lock<std::mutex> guard(pool->lock);
+    pool->finished.wait(guard, [&]() {
+        return pool->bands_done.load(std::memory_order_acquire) == band_count;
+    });
+}
+
+void otk_band_rows(uint32_t band, uint32_t band_count, uint32_t height,
+                   uint32_t *first, uint32_t *last) {
+    *first = (uint32_t)((uint64_t)height * band / band_count);
+    *last = (uint32_t)((uint64_t)height * (band + 1) / band_count);
+}
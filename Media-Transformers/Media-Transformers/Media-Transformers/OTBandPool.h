@@ -0,0 +1,50 @@
+//
+//  OTBandPool.h
+//  Media-Transformers
+//
+//  Copyright (c) 2026 Vonage. All rights reserved.
+//
+
+#ifndef OTBandPool_h
+#define OTBandPool_h
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * Fixed set of worker threads that split a frame into bands of rows and
+ * process them in parallel. The calling thread works on bands too and
+ * otk_band_pool_run returns once every band is done, so a transformer can
+ * run one pass after the other.
+ *
+ * One run at a time per pool.
+ */
+typedef struct otk_band_pool otk_band_pool;
+
+/** Processes one band; bands are numbered from 0 to band_count - 1. */
+typedef void (*otk_band_fn)(void *user_data, uint32_t band, uint32_t band_count);
+
+/** threads counts the calling thread; 0 for one per core. */
+otk_band_pool *otk_band_pool_new(uint32_t threads);
+
+/** Stops and joins the workers. */
+void otk_band_pool_delete(otk_band_pool *pool);
+
+/** Threads working on a run, including the calling thread. */
+uint32_t otk_band_pool_threads(otk_band_pool *pool);
+
+/** Calls fn once for every band, in parallel, and waits for all of them. */
+void otk_band_pool_run(otk_band_pool *pool, uint32_t band_count, otk_band_fn fn, void *user_data);
+
+/** Rows [first, last) of band out of band_count over height rows. */
+void otk_band_rows(uint32_t band, uint32_t band_count, uint32_t height,
+                   uint32_t *first, uint32_t *last);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* OTBandPool_h */
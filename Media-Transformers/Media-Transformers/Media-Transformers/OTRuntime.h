@@ -0,0 +1,59 @@
+//
+//  OTRuntime.h
+//  Media-Transformers
+//
+//  Copyright (c) 2026 Vonage. All rights reserved.
+//
+
+#ifndef OTRuntime_h
+#define OTRuntime_h
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * Process-wide reference count on the SDK, so the sessions of one process
+ * share a single otc_init and the SDK is destroyed once the last of them
+ * is gone.
+ *
+ * The SDK is reached through otk_runtime_api, which the first reference
+ * passes in; the app passes functions calling otc_init and otc_destroy.
+ * Initializing and destroying happen under a lock, so a reference taken
+ * while the SDK is being destroyed waits and initializes it again.
+ */
+typedef struct otk_runtime_api {
+    void *context;
+    /** Returns 1 on success. */
+    int (*init)(void *context);
+    void (*destroy)(void *context);
+} otk_runtime_api;
+
+typedef struct otk_runtime_stats {
+    int32_t references;
+    uint32_t inits;
+    uint32_t destroys;
+    uint32_t init_failures;
+    /** Time the last successful init took. */
+    int64_t last_init_us;
+} otk_runtime_stats;
+
+/**
+ * Takes a reference, initializing the SDK with api if there was none.
+ * Later references keep the api of the first. Returns 0, without a
+ * reference, if the SDK could not be initialized.
+ */
+int otk_runtime_acquire(const otk_runtime_api *api);
+
+/** Drops a reference, destroying the SDK with the last one. */
+void otk_runtime_release(void);
+
+void otk_runtime_get_stats(otk_runtime_stats *stats);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* OTRuntime_h */
@@ -0,0 +1,291 @@
+//
+//  OTTemporalDenoise.cpp
+//  Media-Transformers
+//
+//  Copyright (c) 2026 Vonage. All rights reserved.
+//
+
+#include "OTTemporalDenoise.h"
+#include "OTBandPool.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <mutex>
+#include <vector>
+
+#if defined(__ARM_NEON) || defined(__ARM_NEON__)
+#include <arm_neon.h>
+#define OTK_DENOISE_NEON 1
+#elif defined(__SSE2__)
+#include <emmintrin.h>
+#define OTK_DENOISE_SSE2 1
+#endif
+
+// Bands per thread; more than one evens out bands that finish early.
+static const uint32_t kBandsPerThread = 2;
+
+struct denoise_plane {
+    uint8_t *frame;
+    int stride;
+    uint32_t width;
+    uint32_t height;
+    // Previous output with a stride of width.
+    uint8_t *previous;
+    uint8_t threshold;
+    uint32_t bands;
+    // Where this plane's bands start in the motion counts.
+    uint32_t first_band;
+};
+
+struct denoise_run {
+    denoise_plane planes[3];
+    uint8_t strength;
+    // Only filled for the first frame after a reset.
+    bool reference_only;
+    uint32_t *motion;
+};
+
+struct otk_temporal_denoise {
+    otk_band_pool *pool;
+
+    std::mutex lock;
+    otk_denoise_params params;
+    bool reset;
+
+    // Only touched by the frame being processed.
+    std::vector<uint8_t> previous[3];
+    uint32_t width;
+    uint32_t height;
+    std::vector<uint32_t> motion;
+
+    uint64_t frames;
+    int64_t last_frame_us;
+    int64_t total_frame_us;
+    double motion_ratio;
+};
+
+// k = strength * 2 * (threshold - difference) / threshold, at most strength.
+// As a 16-bit multiplier: k = ((threshold - difference) * slope) >> 8.
+static uint16_t motion_slope(uint8_t strength, uint8_t threshold) {
+    if (threshold == 0) {
+        return 0;
+    }
+    return (uint16_t)std::min<uint32_t>(65535, 512u * strength / threshold);
+}
+
+// Filters one row in place and stores it as the next reference. Returns the
+// number of pixels taken as motion. Every path rounds the blend the same
+// way, (t + 128) >> 8, so x86 and ARM give the same output bit for bit.
+static uint32_t denoise_row(uint8_t *frame, uint8_t *previous, uint32_t width,
+                            uint8_t threshold, uint16_t slope, uint8_t strength) {
+    uint32_t motion = 0;
+    uint32_t x = 0;
+#if OTK_DENOISE_NEON
+    const uint8x16_t thresholds = vdupq_n_u8(threshold);
+    const uint16x4_t slopes = vdup_n_u16(slope);
+    const uint16x8_t strengths = vdupq_n_u16(strength);
+    const uint16x8_t full = vdupq_n_u16(256);
+    const uint16x8_t round = vdupq_n_u16(128);
+    uint32x4_t counts = vdupq_n_u32(0);
+    for (; x + 16 <= width; x += 16) {
+        uint8x16_t c = vld1q_u8(frame + x);
+        uint8x16_t p = vld1q_u8(previous + x);
+        uint8x16_t r = vqsubq_u8(thresholds, vabdq_u8(c, p));
+        counts = vpadalq_u16(counts, vpaddlq_u8(vshrq_n_u8(vceqq_u8(r, vdupq_n_u8(0)), 7)));
+        uint8x8_t out[2];
+        for (int half = 0; half < 2; half++) {
+            uint16x8_t rh = vmovl_u8(half ? vget_high_u8(r) : vget_low_u8(r));
+            uint16x8_t k = vcombine_u16(vshrn_n_u32(vmull_u16(vget_low_u16(rh), slopes), 8),
+                                        vshrn_n_u32(vmull_u16(vget_high_u16(rh), slopes), 8));
+            k = vminq_u16(k, strengths);
+            uint16x8_t t = vmulq_u16(vmovl_u8(half ? vget_high_u8(c) : vget_low_u8(c)), vsubq_u16(full, k));
+            t = vmlaq_u16(t, vmovl_u8(half ? vget_high_u8(p) : vget_low_u8(p)), k);
+            out[half] = vshrn_n_u16(vaddq_u16(t, round), 8);
+        }
+        uint8x16_t result = vcombine_u8(out[0], out[1]);
+        vst1q_u8(frame + x, result);
+        vst1q_u8(previous + x, result);
+    }
+    motion += vgetq_lane_u32(counts, 0) + vgetq_lane_u32(counts, 1) +
+              vgetq_lane_u32(counts, 2) + vgetq_lane_u32(counts, 3);
+#elif OTK_DENOISE_SSE2
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i thresholds = _mm_set1_epi8((char)threshold);
+    const __m128i slopes = _mm_set1_epi16((short)slope);
+    const __m128i strengths = _mm_set1_epi16(strength);
+    const __m128i full = _mm_set1_epi16(256);
+    const __m128i round = _mm_set1_epi16(128);
+    for (; x + 16 <= width; x += 16) {
+        __m128i c = _mm_loadu_si128((const __m128i *)(frame + x));
+        __m128i p = _mm_loadu_si128((const __m128i *)(previous + x));
+        __m128i d = _mm_or_si128(_mm_subs_epu8(c, p), _mm_subs_epu8(p, c));
+        __m128i r = _mm_subs_epu8(thresholds, d);
+        motion += (uint32_t)__builtin_popcount(_mm_movemask_epi8(_mm_cmpeq_epi8(r, zero)));
+        __m128i out[2];
+        for (int half = 0; half < 2; half++) {
+            __m128i rh = half ? _mm_unpackhi_epi8(r, zero) : _mm_unpacklo_epi8(r, zero);
+            __m128i ch = half ? _mm_unpackhi_epi8(c, zero) : _mm_unpacklo_epi8(c, zero);
+            __m128i ph = half ? _mm_unpackhi_epi8(p, zero) : _mm_unpacklo_epi8(p, zero);
+            __m128i k = _mm_min_epi16(_mm_mulhi_epu16(_mm_slli_epi16(rh, 8), slopes), strengths);
+            __m128i t = _mm_add_epi16(_mm_mullo_epi16(ch, _mm_sub_epi16(full, k)), _mm_mullo_epi16(ph, k));
+            out[half] = _mm_srli_epi16(_mm_add_epi16(t, round), 8);
+        }
+        __m128i result = _mm_packus_epi16(out[0], out[1]);
+        _mm_storeu_si128((__m128i *)(frame + x), result);
+        _mm_storeu_si128((__m128i *)(previous + x), result);
+    }
+#endif
+    for (; x < width; x++) {
+        uint32_t c = frame[x], p = previous[x];
+        uint32_t d = c > p ? c - p : p - c;
+        uint32_t r = d < threshold ? threshold - d : 0;
+        uint32_t k = std::min<uint32_t>(strength, (r * slope) >> 8);
+        motion += r == 0;
+        frame[x] = previous[x] = (uint8_t)((c * (256 - k) + p * k + 128) >> 8);
+    }
+    return motion;
+}
+
+static void run_band(void *user_data, uint32_t band, uint32_t) {
+    denoise_run *run = (denoise_run *)user_data;
+    int index = 0;
+    while (band >= run->planes[index].first_band + run->planes[index].bands) {
+        index++;
+    }
+    const denoise_plane &plane = run->planes[index];
+    uint32_t first, last;
+    otk_band_rows(band - plane.first_band, plane.bands, plane.height, &first, &last);
+    uint16_t slope = motion_slope(run->strength, plane.threshold);
+    uint32_t motion = 0;
+    for (uint32_t y = first; y < last; y++) {
+        uint8_t *row = plane.frame + (size_t)y * plane.stride;
+        uint8_t *previous = plane.previous + (size_t)y * plane.width;
+        if (run->reference_only) {
+            memcpy(previous, row, plane.width);
+            motion += plane.width;
+        } else {
+            motion += denoise_row(row, previous, plane.width, plane.threshold, slope, run->strength);
+        }
+    }
+    run->motion[band] = motion;
+}
+
+otk_denoise_params otk_temporal_denoise_default_params(void) {
+    otk_denoise_params params;
+    params.strength = 160;
+    params.luma_threshold = 16;
+    params.chroma_threshold = 10;
+    return params;
+}
+
+otk_temporal_denoise *otk_temporal_denoise_new(const otk_denoise_params *params, uint32_t threads) {
+    otk_temporal_denoise *denoise = new otk_temporal_denoise();
+    denoise->pool = otk_band_pool_new(threads);
+    denoise->params = params != nullptr ? *params : otk_temporal_denoise_default_params();
+    denoise->reset = true;
+    denoise->width = 0;
+    denoise->height = 0;
+    denoise->frames = 0;
+    denoise->last_frame_us = 0;
+    denoise->total_frame_us = 0;
+    denoise->motion_ratio = 0;
+    return denoise;
+}
+
+void otk_temporal_denoise_delete(otk_temporal_denoise *denoise) {
+    if (denoise == nullptr) {
+        return;
+    }
+    otk_band_pool_delete(denoise->pool);
+    delete denoise;
+}
+
+void otk_temporal_denoise_set_params(otk_temporal_denoise *denoise, const otk_denoise_params *params) {
+    if (denoise == nullptr || params == nullptr) {
+        return;
+    }
+    std::lock_guard<std::mutex> guard(denoise->lock);
+    denoise->params = *params;
+}
+
+void otk_temporal_denoise_reset(otk_temporal_denoise *denoise) {
+    if (denoise == nullptr) {
+        return;
+    }
+    std::lock_guard<std::mutex> guard(denoise->lock);
+    denoise->reset = true;
+}
+
+int otk_temporal_denoise_process(otk_temporal_denoise *denoise,
+                                 uint8_t *y, int y_stride,
+                                 uint8_t *u, int u_stride,
+                                 uint8_t *v, int v_stride,
+                                 uint32_t width,
+                                 uint32_t height) {
+    if (denoise == nullptr || y == nullptr || u == nullptr || v == nullptr ||
+        width == 0 || height == 0 || y_stride < (int)width ||
+        u_stride < (int)(width + 1) / 2 || v_stride < (int)(width + 1) / 2) {
+        return 0;
+    }
+    auto started = std::chrono::steady_clock::now();
+    denoise_run run;
+    {
+        std::lock_guard<std::mutex> guard(denoise->lock);
+        run.strength = denoise->params.strength;
+        run.reference_only = denoise->reset;
+        denoise->reset = false;
+        run.planes[0].threshold = denoise->params.luma_threshold;
+        run.planes[1].threshold = run.planes[2].threshold = denoise->params.chroma_threshold;
+    }
+    if (width != denoise->width || height != denoise->height) {
+        denoise->width = width;
+        denoise->height = height;
+        run.reference_only = true;
+    }
+
+    uint32_t band_target = otk_band_pool_threads(denoise->pool) * kBandsPerThread;
+    uint8_t *frames[3] = { y, u, v };
+    int strides[3] = { y_stride, u_stride, v_stride };
+    uint32_t total_bands = 0;
+    for (int i = 0; i < 3; i++) {
+        denoise_plane &plane = run.planes[i];
+        plane.frame = frames[i];
+        plane.stride = strides[i];
+        plane.width = i == 0 ? width : (width + 1) / 2;
+        plane.height = i == 0 ? height : (height + 1) / 2;
+        denoise->previous[i].resize((size_t)plane.width * plane.height);
+        plane.previous = denoise->previous[i].data();
+        plane.bands = std::min(plane.height, band_target);
+        plane.first_band = total_bands;
+        total_bands += plane.bands;
+    }
+    denoise->motion.resize(total_bands);
+    run.motion = denoise->motion.data();
+    otk_band_pool_run(denoise->pool, total_bands, run_band, &run);
+
+    uint64_t motion = 0;
+    for (uint32_t band = 0; band < run.planes[0].bands; band++) {
+        motion += run.motion[band];
+    }
+    int64_t elapsed = (int64_t)std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::steady_clock::now() - started).count();
+    std::lock_guard<std::mutex> guard(denoise->lock);
+    denoise->frames++;
+    denoise->last_frame_us = elapsed;
+    denoise->total_frame_us += elapsed;
+    denoise->motion_ratio = (double)motion / ((double)width * height);
+    return 1;
+}
+
+void otk_temporal_denoise_get_stats(otk_temporal_denoise *denoise, otk_denoise_stats *stats) {
+    if (denoise == nullptr || stats == nullptr) {
+        return;
+    }
+    std::lock_guard<std::mutex> guard(denoise->lock);
+    stats->frames = denoise->frames;
+    stats->last_frame_us = denoise->last_frame_us;
+    stats->average_frame_us = denoise->frames ? denoise->total_frame_us / (int64_t)denoise->frames : 0;
+    stats->threads = otk_band_pool_threads(denoise->pool);
+    stats->motion_ratio = denoise->motion_ratio;
+}
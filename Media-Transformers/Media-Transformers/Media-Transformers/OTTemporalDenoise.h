@@ -0,0 +1,85 @@
+//
+//  OTTemporalDenoise.h
+//  Media-Transformers
+//
+//  Copyright (c) 2026 Vonage. All rights reserved.
+//
+
+#ifndef OTTemporalDenoise_h
+#define OTTemporalDenoise_h
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * Motion adaptive temporal denoise for I420 frames, run as a custom video
+ * transformer before the encoder.
+ *
+ * Every pixel is averaged with the same pixel of the previous output:
+ *
+ *   out = (cur * (256 - k) + prev * k) / 256
+ *
+ * k is the strength while the two differ by less than half the motion
+ * threshold, falls to 0 at the threshold and stays 0 above it, so sensor
+ * noise is smoothed out while moving edges pass through untouched instead
+ * of ghosting. The previous output is kept in one buffer per plane that is
+ * only reallocated when the frame size changes. Rows are split into bands
+ * processed in parallel (see OTBandPool.h), with SSE2 or NEON kernels when
+ * available.
+ */
+typedef struct otk_temporal_denoise otk_temporal_denoise;
+
+typedef struct otk_denoise_params {
+    /** Weight of the previous frame out of 256 on still pixels; 0 disables the filter. */
+    uint8_t strength;
+    /** Differences from this value up count as motion. */
+    uint8_t luma_threshold;
+    uint8_t chroma_threshold;
+} otk_denoise_params;
+
+typedef struct otk_denoise_stats {
+    uint64_t frames;
+    int64_t last_frame_us;
+    int64_t average_frame_us;
+    /** Threads working on each frame, including the caller's. */
+    uint32_t threads;
+    /** Share of luma pixels of the last frame left unfiltered as motion. */
+    double motion_ratio;
+} otk_denoise_stats;
+
+/** Suited to a webcam in low light: strength 160, thresholds 16 and 10. */
+otk_denoise_params otk_temporal_denoise_default_params(void);
+
+/** threads counts the calling thread; 0 for one per core. */
+otk_temporal_denoise *otk_temporal_denoise_new(const otk_denoise_params *params, uint32_t threads);
+
+void otk_temporal_denoise_delete(otk_temporal_denoise *denoise);
+
+/** Takes effect from the next frame. */
+void otk_temporal_denoise_set_params(otk_temporal_denoise *denoise, const otk_denoise_params *params);
+
+/** Drops the previous frame, so the next one passes through unfiltered. */
+void otk_temporal_denoise_reset(otk_temporal_denoise *denoise);
+
+/**
+ * Denoises an I420 frame in place. The first frame, and the first one after
+ * a size change or a reset, only becomes the reference. Returns 0 on bad
+ * arguments.
+ */
+int otk_temporal_denoise_process(otk_temporal_denoise *denoise,
+                                 uint8_t *y, int y_stride,
+                                 uint8_t *u, int u_stride,
+                                 uint8_t *v, int v_stride,
+                                 uint32_t width,
+                                 uint32_t height);
+
+void otk_temporal_denoise_get_stats(otk_temporal_denoise *denoise, otk_denoise_stats *stats);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* OTTemporalDenoise_h */
@@ -6,6 +6,10 @@
 //
 
 #include "OpenTokWrapper.h"
+#include "OTRuntime.h"
+#include "OTBackgroundBlur.h"
+#include "OTTemporalDenoise.h"
+#include "OTAudioChain.h"
 
 #define API_KEY ""
 // Replace with your generated session ID
@@ -13,6 +17,25 @@
 // Replace with your generated token
 #define TOKEN ""
 
+// Set to 1 to blur with the sample's own multithreaded transformer instead
+// of the Vonage BackgroundBlur one. It has no segmentation: what stays sharp
+// is a fixed ellipse in the middle of the frame, not the person.
+#define OT_USE_CUSTOM_BACKGROUND_BLUR 0
+#define OT_BACKGROUND_BLUR_PRESET OTK_BLUR_BALANCED
+
+// Set to 1 to denoise the camera before the encoder. Compare the bitrate and
+// frame time logged with the publisher video stats with this on and off.
+#define OT_ENABLE_TEMPORAL_DENOISE 0
+
+// Set to 1 to run the sample's own audio stages (high-pass, AGC, gain,
+// limiter) after the Vonage noise suppression. Their per-block cost is
+// logged when publishing stops. Its AGC works on top of the SDK's own, so
+// disable one of them before judging the sound.
+#define OT_ENABLE_CUSTOM_AUDIO_CHAIN 0
+// 100 ms of 48 kHz stereo, well above the 10 ms blocks the SDK delivers.
+#define OT_AUDIO_CHAIN_MAX_FRAMES 4800
+#define OT_AUDIO_CHAIN_MAX_CHANNELS 2
+
 typedef struct {
   otc_session *session;
   otc_publisher *publisher;
@@ -257,24 +280,139 @@ void on_transform_logo(void* user_data, struct otc_video_frame* frame)
     CGContextRelease(context);
 }
 
+/**
+ * Called when video frame is available to be transformed. Blurs everything
+ * outside the blur engine's mask.
+ * @param user_data The otk_background_blur the transformer was created with.
+ * @param frame The video frame to be transformed.
+ */
+void on_transform_blur(void* user_data, struct otc_video_frame* frame)
+{
+    if (otc_video_frame_get_format(frame) != OTC_VIDEO_FRAME_FORMAT_YUV420P) {
+        return;
+    }
+    otk_background_blur_process((otk_background_blur *)user_data,
+                                (uint8_t*)otc_video_frame_get_plane_binary_data(frame, OTC_VIDEO_FRAME_PLANE_Y),
+                                otc_video_frame_get_plane_stride(frame, OTC_VIDEO_FRAME_PLANE_Y),
+                                (uint8_t*)otc_video_frame_get_plane_binary_data(frame, OTC_VIDEO_FRAME_PLANE_U),
+                                otc_video_frame_get_plane_stride(frame, OTC_VIDEO_FRAME_PLANE_U),
+                                (uint8_t*)otc_video_frame_get_plane_binary_data(frame, OTC_VIDEO_FRAME_PLANE_V),
+                                otc_video_frame_get_plane_stride(frame, OTC_VIDEO_FRAME_PLANE_V),
+                                otc_video_frame_get_width(frame),
+                                otc_video_frame_get_height(frame));
+}
+
+/**
+ * Called when video frame is available to be transformed. Averages still
+ * pixels with the previous frame to remove sensor noise.
+ * @param user_data The otk_temporal_denoise the transformer was created with.
+ * @param frame The video frame to be transformed.
+ */
+void on_transform_denoise(void* user_data, struct otc_video_frame* frame)
+{
+    if (otc_video_frame_get_format(frame) != OTC_VIDEO_FRAME_FORMAT_YUV420P) {
+        return;
+    }
+    otk_temporal_denoise_process((otk_temporal_denoise *)user_data,
+                                 (uint8_t*)otc_video_frame_get_plane_binary_data(frame, OTC_VIDEO_FRAME_PLANE_Y),
+                                 otc_video_frame_get_plane_stride(frame, OTC_VIDEO_FRAME_PLANE_Y),
+                                 (uint8_t*)otc_video_frame_get_plane_binary_data(frame, OTC_VIDEO_FRAME_PLANE_U),
+                                 otc_video_frame_get_plane_stride(frame, OTC_VIDEO_FRAME_PLANE_U),
+                                 (uint8_t*)otc_video_frame_get_plane_binary_data(frame, OTC_VIDEO_FRAME_PLANE_V),
+                                 otc_video_frame_get_plane_stride(frame, OTC_VIDEO_FRAME_PLANE_V),
+                                 otc_video_frame_get_width(frame),
+                                 otc_video_frame_get_height(frame));
+}
+
+/**
+ * Called when audio data is available to be transformed. Runs the custom
+ * audio stages on it in place.
+ * @param user_data The otk_audio_chain the transformer was created with.
+ * @param audio_data The audio data to be transformed.
+ */
+void on_transform_audio(void* user_data, struct otc_audio_data* audio_data)
+{
+    if (audio_data->bits_per_sample != 16) {
+        return;
+    }
+    otk_audio_chain_process_int16((otk_audio_chain *)user_data,
+                                  (int16_t*)audio_data->sample_buffer,
+                                  audio_data->number_of_samples,
+                                  audio_data->number_of_channels,
+                                  audio_data->sample_rate);
+}
+
 /**
  * Variables holding media transformers
  */
+otc_video_transformer *temporal_denoise;
+otk_temporal_denoise *temporal_denoise_engine;
 otc_video_transformer *background_blur;
+otk_background_blur *background_blur_engine;
 otc_video_transformer *logo_watermark;
 otc_audio_transformer *ns;
+otc_audio_transformer *audio_chain;
+otk_audio_chain *audio_chain_engine;
 
 /**
  * Disable Video Transformers
  * Make sure to call otc_video_transformer_delete(otc_video_transformer * transformer) to release any dynamically allocated memory
  */
 static void disable_tranformers(otc_publisher *publisher) {
+    if (background_blur == NULL) {
+        return;
+    }
+    if (temporal_denoise != NULL) {
+        otc_video_transformer_delete(temporal_denoise);
+    }
     otc_video_transformer_delete(background_blur);
     otc_video_transformer_delete(logo_watermark);
     otc_publisher_set_video_transformers(publisher, NULL, NULL);
+    temporal_denoise = NULL;
+    background_blur = NULL;
+    logo_watermark = NULL;
+
+    if (temporal_denoise_engine != NULL) {
+        otk_denoise_stats stats = {0};
+        otk_temporal_denoise_get_stats(temporal_denoise_engine, &stats);
+        NSLog(@"temporal denoise: %llu frames, average %lld us, last %lld us, %u threads, motion %.1f%%",
+              stats.frames, stats.average_frame_us, stats.last_frame_us, stats.threads, stats.motion_ratio * 100);
+        otk_temporal_denoise_delete(temporal_denoise_engine);
+        temporal_denoise_engine = NULL;
+    }
+
+    if (background_blur_engine != NULL) {
+        otk_blur_stats stats = {0};
+        otk_background_blur_get_stats(background_blur_engine, &stats);
+        NSLog(@"background blur: %llu frames, average %lld us, last %lld us, %u threads, radius %u",
+              stats.frames, stats.average_frame_us, stats.last_frame_us, stats.threads, stats.radius);
+        otk_background_blur_delete(background_blur_engine);
+        background_blur_engine = NULL;
+    }
     
     otc_audio_transformer_delete(ns);
+    if (audio_chain != NULL) {
+        otc_audio_transformer_delete(audio_chain);
+    }
     otc_publisher_set_audio_transformers(publisher, NULL, NULL);
+    ns = NULL;
+    audio_chain = NULL;
+
+    if (audio_chain_engine != NULL) {
+        for (int stage = 0; stage < OTK_AUDIO_STAGE_COUNT; stage++) {
+            otk_audio_stage_stats stats = {0};
+            otk_audio_chain_get_stage_stats(audio_chain_engine, stage, &stats);
+            if (stats.blocks == 0) {
+                continue;
+            }
+            NSLog(@"audio chain %s: %llu blocks, average %.2f us, p50 < %.2f us, p99 < %.2f us, max %.2f us",
+                  otk_audio_stage_name(stage), stats.blocks, stats.total_ns / 1000.0 / stats.blocks,
+                  otk_audio_stage_stats_percentile_ns(&stats, 0.5) / 1000.0,
+                  otk_audio_stage_stats_percentile_ns(&stats, 0.99) / 1000.0, stats.max_ns / 1000.0);
+        }
+        otk_audio_chain_delete(audio_chain_engine);
+        audio_chain_engine = NULL;
+    }
 }
 
 /**
@@ -282,14 +420,31 @@ static void disable_tranformers(otc_publisher *publisher) {
  */
 static void enable_tranformers(otc_publisher *publisher) {
 
+#if OT_ENABLE_TEMPORAL_DENOISE
+    // Create temporal denoise from the sample's own engine; it runs first so
+    // the other transformers work on the cleaned up frame
+    temporal_denoise_engine = otk_temporal_denoise_new(NULL, 0);
+    temporal_denoise = otc_video_transformer_create(OTC_MEDIA_TRANSFORMER_TYPE_CUSTOM, "TemporalDenoise", NULL, on_transform_denoise, temporal_denoise_engine);
+#endif
+
+#if OT_USE_CUSTOM_BACKGROUND_BLUR
+    // Create background blur from the sample's own engine, one thread per core
+    background_blur_engine = otk_background_blur_new(OT_BACKGROUND_BLUR_PRESET, 0);
+    background_blur = otc_video_transformer_create(OTC_MEDIA_TRANSFORMER_TYPE_CUSTOM, "BackgroundBlur", NULL, on_transform_blur, background_blur_engine);
+#else
     // Create background blur from enum
     background_blur = otc_video_transformer_create(OTC_MEDIA_TRANSFORMER_TYPE_VONAGE, "BackgroundBlur","{\"radius\":\"High\"}", NULL, NULL);
+#endif
 
     logo_watermark = otc_video_transformer_create(OTC_MEDIA_TRANSFORMER_TYPE_CUSTOM, "logo", NULL, on_transform_logo, NULL);
 
     // Array of video transformers
     otc_video_transformer *video_transformers[] = {
-        /* Vonage Transformer - Background Blur */
+#if OT_ENABLE_TEMPORAL_DENOISE
+        /* Custom Transformer - Temporal Denoise */
+        temporal_denoise,
+#endif
+        /* Background Blur, Vonage or custom */
         background_blur,
         /* Vonage Transformer - Logo watermark */
         logo_watermark};
@@ -299,16 +454,64 @@ static void enable_tranformers(otc_publisher *publisher) {
     // Create noise suppression from enum
     ns = otc_audio_transformer_create(OTC_MEDIA_TRANSFORMER_TYPE_VONAGE, "NoiseSuppression","", NULL, NULL);
     
+#if OT_ENABLE_CUSTOM_AUDIO_CHAIN
+    // Create the custom audio stages with their default settings
+    audio_chain_engine = otk_audio_chain_new(NULL, OT_AUDIO_CHAIN_MAX_FRAMES, OT_AUDIO_CHAIN_MAX_CHANNELS);
+    audio_chain = otc_audio_transformer_create(OTC_MEDIA_TRANSFORMER_TYPE_CUSTOM, "AudioChain", NULL, on_transform_audio, audio_chain_engine);
+#endif
+
     // Array of audio transformers
     otc_audio_transformer *audio_transformers[] = {
         /* Vonage Transformer - Noise Suppression */
-        ns};
+        ns,
+#if OT_ENABLE_CUSTOM_AUDIO_CHAIN
+        /* Custom Transformer - High-pass, AGC, gain and limiter */
+        audio_chain,
+#endif
+    };
     
     otc_publisher_set_audio_transformers(publisher, audio_transformers, sizeof(audio_transformers) / sizeof(audio_transformers[0]));
 }
 
+/**
+ * Logs the publisher's video bitrate, to compare runs with
+ * OT_ENABLE_TEMPORAL_DENOISE on and off. The time spent denoising is logged
+ * when publishing stops.
+ */
+static void on_publisher_video_stats(otc_publisher *publisher,
+                                     void *user_data,
+                                     struct otc_publisher_video_stats video_stats[],
+                                     size_t number_of_stats) {
+  static int64_t last_bytes_sent = 0;
+  static NSTimeInterval last_time = 0;
+  int64_t bytes_sent = 0;
+  for (size_t i = 0; i < number_of_stats; i++) {
+    bytes_sent += video_stats[i].bytes_sent;
+  }
+  NSTimeInterval now = [[NSProcessInfo processInfo] systemUptime];
+  if (last_time > 0 && now > last_time && bytes_sent >= last_bytes_sent) {
+    NSLog(@"on_publisher_video_stats: %.0f kbps, denoise %s",
+          (bytes_sent - last_bytes_sent) * 8 / (now - last_time) / 1000,
+          OT_ENABLE_TEMPORAL_DENOISE ? "on" : "off");
+  }
+  last_bytes_sent = bytes_sent;
+  last_time = now;
+}
+
+static int init_sdk(void *context) {
+  return otc_init(NULL) == OTC_SUCCESS;
+}
+
+static void destroy_sdk(void *context) {
+  otc_destroy();
+}
+
+// Wrappers share one otc_init, the SDK being destroyed with the last of them.
+static const otk_runtime_api runtime_api = {NULL, init_sdk, destroy_sdk};
+
 @implementation OpenTokWrapper {
   SessionData *session_data;
+  BOOL runtime_acquired;
 }
 
 - (id)init {
@@ -324,10 +527,11 @@ static void enable_tranformers(otc_publisher *publisher) {
   session_data->open_tok_controller = (__bridge void *)self;
   session_data->publisher = NULL;
   
-  if (otc_init(NULL) != OTC_SUCCESS) {
+  if (!otk_runtime_acquire(&runtime_api)) {
     NSLog(@"Could not init OpenTok library");
     return;
   }
+  runtime_acquired = YES;
   
   #ifdef CONSOLE_LOGGING
     otc_log_set_logger_callback(on_otc_log_message);
@@ -357,6 +561,7 @@ static void enable_tranformers(otc_publisher *publisher) {
   publisher_callbacks.on_render_frame = on_publisher_render_frame;
   publisher_callbacks.on_stream_destroyed = on_publisher_stream_destroyed;
   publisher_callbacks.on_error = on_publisher_error;
+  publisher_callbacks.on_video_stats = on_publisher_video_stats;
   
   session_data->publisher = otc_publisher_new("opentok-macos-sdk-samples",
                                               NULL, /* Use WebRTC's video capturer. */
@@ -391,7 +596,9 @@ static void enable_tranformers(otc_publisher *publisher) {
   }
     
   free(session_data);
-  otc_destroy();
+  if (runtime_acquired) {
+    otk_runtime_release();
+  }
 }
 
 - (SessionData*)getSessionData {
@@ -423,6 +630,7 @@ static void enable_tranformers(otc_publisher *publisher) {
 - (void)unpublish {
   if ((session_data->session != NULL) && (session_data->publisher != NULL)) {
     otc_session_unpublish(session_data->session, session_data->publisher);
+    disable_tranformers(session_data->publisher);
   }
 }
 
@@ -9,6 +9,7 @@
 #import <Cocoa/Cocoa.h>
 #import <Foundation/Foundation.h>
 #import <opentok/opentok.h>
+#include "OTFramePacer.h"
 
 @interface VideoRenderView : NSOpenGLView<NSUserNotificationCenterDelegate>
 
@@ -19,4 +20,7 @@
 - (void) stopRecording;
 - (BOOL) isRecording;
 
+/* Counts of frames presented, dropped and late, and of refreshes skipped */
+- (otk_frame_pacer_stats)presentationStats;
+
 @end
@@ -11,6 +11,7 @@
 #import <OpenGL/OpenGL.h>
 #import <OpenGL/glu.h>
 #import <AVFoundation/AVFoundation.h>
+#import <CoreVideo/CoreVideo.h>
 
 #import <mach/mach_time.h>
 #define SKWTimestamp() (((double)mach_absolute_time()) * 1.0e-09)
@@ -120,14 +121,37 @@ static const GLsizei kNumTextures = 3 * kNumTextureSets;
     AVAssetWriter *videoWriter;
     AVAssetWriterInput* writerInput;
     int frameCount;
+    int64_t recordingStartUs;
     BOOL recording;
     
     NSString *filePath;
+    
+    // The view is redrawn on display refreshes, and only when a new frame
+    // arrived since the last draw.
+    CVDisplayLinkRef _displayLink;
+    otk_frame_pacer *_pacer;
+    BOOL _frameDirty;
+    BOOL _hasTextures;
+}
+
+static CVReturn display_link_callback(CVDisplayLinkRef displayLink,
+                                      const CVTimeStamp *now,
+                                      const CVTimeStamp *outputTime,
+                                      CVOptionFlags flagsIn,
+                                      CVOptionFlags *flagsOut,
+                                      void *context) {
+    VideoRenderView *view = (__bridge VideoRenderView *)context;
+    [view displayWillRefresh:outputTime];
+    return kCVReturnSuccess;
 }
 
 - (void) awakeFromNib
 {
+    if (_pacer) {
+        return;
+    }
     _frameLock = [[NSLock alloc] init];
+    _pacer = otk_frame_pacer_new();
     _renderingEnabled = YES;
     _videoFrame = NULL;
     frameCount = 1;
@@ -156,17 +180,48 @@ static const GLsizei kNumTextures = 3 * kNumTextureSets;
     
     [self setOpenGLContext:context];
     
-    NSTimer *updateTimer = [NSTimer timerWithTimeInterval:1.0f/30.0f target:self selector:@selector(idle:) userInfo:nil repeats:YES];
-    [[NSRunLoop currentRunLoop] addTimer:updateTimer forMode:NSDefaultRunLoopMode];
+    if (CVDisplayLinkCreateWithActiveCGDisplays(&_displayLink) == kCVReturnSuccess) {
+        CVDisplayLinkSetOutputCallback(_displayLink, display_link_callback, (__bridge void *)self);
+        CVDisplayLinkStart(_displayLink);
+    } else {
+        NSLog(@"No display link, video will not be drawn");
+    }
 }
 
-- (void)idle:(NSTimer*)timer
+// Runs on the display link thread.
+- (void)displayWillRefresh:(const CVTimeStamp *)outputTime
 {
-    [self setNeedsDisplay:YES];
+    int64_t period_us = 0;
+    if (outputTime->videoTimeScale > 0) {
+        period_us = outputTime->videoRefreshPeriod * 1000000 / outputTime->videoTimeScale;
+    }
+    if (otk_frame_pacer_on_refresh(_pacer, period_us)) {
+        __weak VideoRenderView *weakSelf = self;
+        dispatch_async(dispatch_get_main_queue(), ^{
+            [weakSelf setNeedsDisplay:YES];
+        });
+    }
+}
+
+- (void)viewDidMoveToWindow {
+    [super viewDidMoveToWindow];
+    NSNumber *screenNumber = self.window.screen.deviceDescription[@"NSScreenNumber"];
+    if (_displayLink && screenNumber) {
+        CVDisplayLinkSetCurrentCGDisplay(_displayLink, [screenNumber unsignedIntValue]);
+    }
+}
+
+- (otk_frame_pacer_stats)presentationStats {
+    otk_frame_pacer_stats stats = {0};
+    otk_frame_pacer_get_stats(_pacer, &stats);
+    return stats;
 }
 
 - (void)prepareOpenGL {
     [super prepareOpenGL];
+    // Swap on vertical blank so draws line up with the display link.
+    GLint swapInterval = 1;
+    [[self openGLContext] setValues:&swapInterval forParameter:NSOpenGLContextParameterSwapInterval];
     [self setupGL];
 }
 
@@ -218,6 +273,7 @@ static const GLsizei kNumTextures = 3 * kNumTextureSets;
     [videoWriter startWriting];
 
     frameCount = 0;
+    recordingStartUs = otk_frame_pacer_now_us();
     [videoWriter startSessionAtSourceTime:CMTimeMake(frameCount, 30)];
     
     recording = YES;
@@ -267,7 +323,19 @@ static const GLsizei kNumTextures = 3 * kNumTextureSets;
 }
 
 - (void)dealloc {
+    if (_displayLink) {
+        CVDisplayLinkStop(_displayLink);
+        CVDisplayLinkRelease(_displayLink);
+        _displayLink = NULL;
+    }
     [self stopRecording];
+    [_frameLock lock];
+    if (_videoFrame) {
+        otc_video_frame_delete(_videoFrame);
+        _videoFrame = NULL;
+    }
+    [_frameLock unlock];
+    otk_frame_pacer_delete(_pacer);
 }
 
 void releasecallback( void *releaseRefCon, const void *baseAddress ) {
@@ -282,9 +350,13 @@ void releasecallback( void *releaseRefCon, const void *baseAddress ) {
 
     [_frameLock lock];
 
-    if (_videoFrame && _isInitialized) {
+    // Redraws that are not for a new frame (resize, expose) reuse the
+    // textures uploaded last time.
+    BOOL newFrame = _frameDirty;
+
+    if (_videoFrame && _isInitialized && (newFrame || _hasTextures)) {
         
-        if (recording) {
+        if (recording && newFrame) {
             
             CMSampleBufferRef sample;
 
@@ -295,8 +367,10 @@ void releasecallback( void *releaseRefCon, const void *baseAddress ) {
             CMVideoFormatDescriptionRef videoInfo = NULL;
             CMVideoFormatDescriptionCreateForImageBuffer(NULL, pixel_buffer, &videoInfo);
             
-            CMTime frameTime = CMTimeMake(frameCount, 30);
-            CMSampleTimingInfo timing = {CMTimeMake(1, 30), frameTime, kCMTimeInvalid};
+            // Frames are only appended when they arrive, so stamp them with
+            // the time since recording started rather than a fixed rate.
+            CMTime frameTime = CMTimeMake(otk_frame_pacer_now_us() - recordingStartUs, 1000000);
+            CMSampleTimingInfo timing = {kCMTimeInvalid, frameTime, kCMTimeInvalid};
             
             CMSampleBufferCreateForImageBuffer(kCFAllocatorDefault, pixel_buffer, YES, NULL, NULL, videoInfo, &timing, &sample);
 
@@ -358,9 +432,17 @@ void releasecallback( void *releaseRefCon, const void *baseAddress ) {
         _vertices[14] = 0;
         _vertices[15] = 0;
         
-        if (![self updateTextureSizesForFrame:_videoFrame] ||
-            ![self updateTextureDataForFrame:_videoFrame]) {
-            return;
+        if (newFrame) {
+            if (![self updateTextureSizesForFrame:_videoFrame] ||
+                ![self updateTextureDataForFrame:_videoFrame]) {
+                [_frameLock unlock];
+                // Otherwise the pacer waits for this draw forever and
+                // never asks for another one.
+                otk_frame_pacer_draw_cancelled(_pacer);
+                return;
+            }
+            _hasTextures = YES;
+            _frameDirty = NO;
         }
         
         
@@ -375,10 +457,13 @@ void releasecallback( void *releaseRefCon, const void *baseAddress ) {
         _lastDrawnWidth = otc_video_frame_get_width(_videoFrame);
         _lastDrawnHeight = otc_video_frame_get_height(_videoFrame);
     }
-    frameCount++;
+    if (newFrame) {
+        frameCount++;
+    }
     [_frameLock unlock];
 
     [[self openGLContext] flushBuffer];
+    otk_frame_pacer_frame_presented(_pacer, otk_frame_pacer_now_us());
 }
 
 
@@ -399,9 +484,11 @@ void releasecallback( void *releaseRefCon, const void *baseAddress ) {
         otc_video_frame_delete(_videoFrame);
         _videoFrame = NULL;
     }
+    _frameDirty = YES;
+    _hasTextures = NO;
     [_frameLock unlock];
     
-    //[self performSelectorOnMainThread:@selector(setNeedsDisplay:) withObject:@YES waitUntilDone:NO];
+    otk_frame_pacer_frame_arrived(_pacer, otk_frame_pacer_now_us());
 
     return YES;
 }
@@ -415,10 +502,11 @@ void releasecallback( void *releaseRefCon, const void *baseAddress ) {
         }
         
         _videoFrame = otc_video_frame_copy(frame);
+        _frameDirty = YES;
         
         [_frameLock unlock];
         
-        //[self performSelectorOnMainThread:@selector(setNeedsDisplay:) withObject:@YES waitUntilDone:NO];
+        otk_frame_pacer_frame_arrived(_pacer, otk_frame_pacer_now_us());
         return YES;
     }
     return NO;
@@ -454,6 +542,9 @@ void releasecallback( void *releaseRefCon, const void *baseAddress ) {
     glDeleteProgram(_program);
     _program = 0;
     glDeleteTextures(kNumTextures, _textures);
+    _hasTextures = NO;
+    _lastDrawnWidth = 0;
+    _lastDrawnHeight = 0;
     _isInitialized = NO;
 }
 
@@ -6,6 +6,7 @@
 //
 
 #include "OpenTokWrapper.h"
+#include "OTRuntime.h"
 
 #define API_KEY ""
 #define SESSION_ID ""
@@ -293,8 +294,20 @@ static otc_bool get_video_capturer_capture_settings(const otc_video_capturer *ca
   return OTC_TRUE;
 }
 
+static int init_sdk(void *context) {
+  return otc_init(NULL) == OTC_SUCCESS;
+}
+
+static void destroy_sdk(void *context) {
+  otc_destroy();
+}
+
+// Wrappers share one otc_init, the SDK being destroyed with the last of them.
+static const otk_runtime_api runtime_api = {NULL, init_sdk, destroy_sdk};
+
 @implementation OpenTokWrapper {
   SessionData *session_data;
+  BOOL runtime_acquired;
 }
 
 - (id)init {
@@ -319,10 +332,11 @@ static otc_bool get_video_capturer_capture_settings(const otc_video_capturer *ca
   session_data->open_tok_controller = (__bridge void *)self;
   session_data->publisher = NULL;
   
-  if (otc_init(NULL) != OTC_SUCCESS) {
+  if (!otk_runtime_acquire(&runtime_api)) {
     NSLog(@"Could not init OpenTok library");
     return;
   }
+  runtime_acquired = YES;
   
   #ifdef CONSOLE_LOGGING
     otc_log_set_logger_callback(on_otc_log_message);
@@ -403,7 +417,9 @@ static otc_bool get_video_capturer_capture_settings(const otc_video_capturer *ca
   }
     
   free(session_data);
-  otc_destroy();
+  if (runtime_acquired) {
+    otk_runtime_release();
+  }
 }
 
 - (SessionData*)getSessionData {
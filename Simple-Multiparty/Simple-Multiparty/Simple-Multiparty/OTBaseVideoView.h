@@ -36,8 +36,13 @@ NS_ASSUME_NONNULL_BEGIN
 
 @protocol OTRendererDelegate <NSObject>
 
+@optional
 - (void)renderer:(OTBaseVideoView *)renderer
  didReceiveFrame:(otc_video_frame*)frame;
 
+/* Called on the main thread when the size the view draws at changes, in pixels */
+- (void)renderer:(OTBaseVideoView *)renderer
+didChangeViewSize:(CGSize)size;
+
 @end
 NS_ASSUME_NONNULL_END
@@ -0,0 +1,498 @@
+//
+//  OTFrameExport.cpp
+//  Simple-Multiparty
+//
+//  Copyright (c) 2026 Vonage. All rights reserved.
+//
+
+#include "OTFrameExport.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <string>
+#include <unordered_map>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+static const char *const kPrefix = "/otk-";
+static const uint32_t kMagic = 0x4f544652; // "OTFR"
+static const uint32_t kVersion = 1;
+// Planes, slots and the published counter start on their own cache line.
+static const uint64_t kAlignment = 64;
+static const size_t kMaxStreamIdLength = 256;
+static const uint32_t kMinSlots = 2;
+static const uint32_t kMaxSlots = 1024;
+static const uint32_t kMaxDimension = 16384;
+// Tries before a reader racing the exporter gives up on a call.
+static const int kReadAttempts = 4;
+
+static_assert(std::atomic<uint64_t>::is_always_lock_free, "ring counters are shared between processes");
+static_assert(std::atomic<uint32_t>::is_always_lock_free, "ring flags are shared between processes");
+
+namespace {
+
+// Written once before the magic is published, except for the counters.
+struct ring_header {
+    std::atomic<uint32_t> magic;
+    uint32_t version;
+    uint32_t slot_count;
+    uint32_t max_width;
+    uint32_t max_height;
+    std::atomic<uint32_t> closed;
+    uint64_t slots_offset;
+    uint64_t slot_size;
+    uint64_t data_offset;
+    uint64_t capacity;
+    char stream_id[kMaxStreamIdLength];
+    alignas(kAlignment) std::atomic<uint64_t> published;
+};
+
+// The frame fields are only meaningful while generation is even and the
+// same before and after reading them.
+struct slot_header {
+    std::atomic<uint64_t> generation;
+    uint64_t number;
+    int64_t timestamp;
+    int64_t exported_ns;
+    uint32_t width;
+    uint32_t height;
+    uint32_t strides[3];
+    uint64_t offsets[3];
+};
+
+struct ring {
+    std::mutex lock;
+    std::string name;
+    uint8_t *base = nullptr;
+    size_t size = 0;
+    ring_header *header = nullptr;
+    otk_frame_export_stats stats = {};
+
+    ~ring() {
+        if (base != nullptr) {
+            munmap(base, size);
+        }
+    }
+};
+
+} // namespace
+
+struct otk_frame_exporter {
+    std::string prefix;
+    uint32_t slots = 0;
+    uint32_t max_width = 0;
+    uint32_t max_height = 0;
+    std::mutex lock;
+    // Shared so a frame being written keeps its ring mapped while the
+    // stream is removed.
+    std::unordered_map<std::string, std::shared_ptr<ring>> rings;
+};
+
+struct otk_frame_reader {
+    uint8_t *base = nullptr;
+    size_t size = 0;
+    const ring_header *header = nullptr;
+    uint64_t next = 0;
+    char stream_id[kMaxStreamIdLength] = {0};
+    otk_frame_reader_stats stats = {};
+};
+
+static uint64_t align(uint64_t value) {
+    return (value + kAlignment - 1) / kAlignment * kAlignment;
+}
+
+static uint32_t chroma_size(uint32_t size) {
+    return (size + 1) / 2;
+}
+
+static int64_t now_ns() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+static void plane_size(int plane, uint32_t width, uint32_t height, uint32_t *plane_width,
+                       uint32_t *plane_height) {
+    *plane_width = plane == 0 ? width : chroma_size(width);
+    *plane_height = plane == 0 ? height : chroma_size(height);
+}
+
+// Planes of a slot holding a frame up to width by height, with rows padded
+// to the alignment.
+static uint64_t frame_capacity(uint32_t width, uint32_t height) {
+    uint64_t capacity = 0;
+    for (int plane = 0; plane < 3; plane++) {
+        uint32_t plane_width, plane_height;
+        plane_size(plane, width, height, &plane_width, &plane_height);
+        capacity += align(plane_width) * plane_height;
+    }
+    return capacity;
+}
+
+static uint64_t slot_offset(const ring_header *header, uint64_t number) {
+    return header->slots_offset + (number % header->slot_count) * header->slot_size;
+}
+
+int otk_frame_ring_name(const char *prefix, const char *stream_id, char *name) {
+    if (name == nullptr) {
+        return 0;
+    }
+    // 48 bits of FNV-1a, leaving room in 31 characters for an application
+    // group prefix.
+    uint64_t hash = 0xcbf29ce484222325ull;
+    for (const char *c = stream_id ? stream_id : ""; *c != '\0'; c++) {
+        hash = (hash ^ (uint8_t)*c) * 0x100000001b3ull;
+    }
+    int length = std::snprintf(name, OTK_FRAME_RING_NAME_SIZE, "%s%012llx", prefix ? prefix : kPrefix,
+                               (unsigned long long)(hash >> 16));
+    return length > 0 && length < OTK_FRAME_RING_NAME_SIZE ? 1 : 0;
+}
+
+static std::shared_ptr<ring> create_ring(otk_frame_exporter *exporter, const char *stream_id) {
+    char name[OTK_FRAME_RING_NAME_SIZE];
+    if (!otk_frame_ring_name(exporter->prefix.c_str(), stream_id, name)) {
+        return nullptr;
+    }
+    uint64_t capacity = frame_capacity(exporter->max_width, exporter->max_height);
+    uint64_t slots_offset = align(sizeof(ring_header));
+    uint64_t data_offset = align(sizeof(slot_header));
+    uint64_t slot_size = align(data_offset + capacity);
+    uint64_t size = slots_offset + slot_size * exporter->slots;
+
+    // A ring of the same name was left by a process that did not exit cleanly.
+    shm_unlink(name);
+    int fd = shm_open(name, O_RDWR | O_CREAT | O_EXCL, S_IRUSR | S_IWUSR);
+    if (fd < 0) {
+        return nullptr;
+    }
+    void *base = MAP_FAILED;
+    if (ftruncate(fd, (off_t)size) == 0) {
+        base = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    }
+    close(fd);
+    if (base == MAP_FAILED) {
+        shm_unlink(name);
+        return nullptr;
+    }
+
+    auto created = std::make_shared<ring>();
+    created->name = name;
+    created->base = static_cast<uint8_t *>(base);
+    created->size = size;
+    ring_header *header = new (base) ring_header();
+    header->version = kVersion;
+    header->slot_count = exporter->slots;
+    header->max_width = exporter->max_width;
+    header->max_height = exporter->max_height;
+    header->slots_offset = slots_offset;
+    header->slot_size = slot_size;
+    header->data_offset = data_offset;
+    header->capacity = capacity;
+    std::strncpy(header->stream_id, stream_id, kMaxStreamIdLength - 1);
+    for (uint32_t i = 0; i < exporter->slots; i++) {
+        new (created->base + slot_offset(header, i)) slot_header();
+    }
+    header->magic.store(kMagic, std::memory_order_release);
+    created->header = header;
+    return created;
+}
+
+static void close_ring(ring &closing) {
+    closing.header->closed.store(1, std::memory_order_release);
+    shm_unlink(closing.name.c_str());
+}
+
+otk_frame_exporter *otk_frame_exporter_new(const char *prefix, uint32_t slots,
+                                           uint32_t max_width, uint32_t max_height) {
+    otk_frame_exporter *exporter = new otk_frame_exporter();
+    exporter->prefix = prefix ? prefix : kPrefix;
+    exporter->slots = std::clamp(slots, kMinSlots, kMaxSlots);
+    exporter->max_width = std::clamp<uint32_t>(max_width, 2, kMaxDimension);
+    exporter->max_height = std::clamp<uint32_t>(max_height, 2, kMaxDimension);
+    return exporter;
+}
+
+void otk_frame_exporter_delete(otk_frame_exporter *exporter) {
+    if (exporter == nullptr) {
+        return;
+    }
+    for (auto &entry : exporter->rings) {
+        close_ring(*entry.second);
+    }
+    delete exporter;
+}
+
+int otk_frame_exporter_add_stream(otk_frame_exporter *exporter, const char *stream_id) {
+    if (exporter == nullptr || stream_id == nullptr) {
+        return 0;
+    }
+    std::lock_guard<std::mutex> guard(exporter->lock);
+    if (exporter->rings.count(stream_id) > 0) {
+        return 1;
+    }
+    std::shared_ptr<ring> created = create_ring(exporter, stream_id);
+    if (!created) {
+        return 0;
+    }
+    exporter->rings.emplace(stream_id, std::move(created));
+    return 1;
+}
+
+void otk_frame_exporter_remove_stream(otk_frame_exporter *exporter, const char *stream_id) {
+    if (exporter == nullptr || stream_id == nullptr) {
+        return;
+    }
+    std::lock_guard<std::mutex> guard(exporter->lock);
+    auto found = exporter->rings.find(stream_id);
+    if (found == exporter->rings.end()) {
+        return;
+    }
+    // Unlinked now, so a stream added again gets a ring of its own even
+    // while a frame is still being written to this one.
+    close_ring(*found->second);
+    exporter->rings.erase(found);
+}
+
+static std::shared_ptr<ring> find_ring(otk_frame_exporter *exporter, const char *stream_id) {
+    std::lock_guard<std::mutex> guard(exporter->lock);
+    auto found = exporter->rings.find(stream_id);
+    return found == exporter->rings.end() ? nullptr : found->second;
+}
+
+int otk_frame_exporter_write(otk_frame_exporter *exporter, const char *stream_id,
+                             int64_t timestamp, uint32_t width, uint32_t height,
+                             const uint8_t *const planes[3], const int strides[3]) {
+    if (exporter == nullptr || stream_id == nullptr || planes == nullptr || strides == nullptr) {
+        return 0;
+    }
+    std::shared_ptr<ring> target = find_ring(exporter, stream_id);
+    if (!target) {
+        return 0;
+    }
+    // Only ever contended if the SDK renders a stream from two threads.
+    std::lock_guard<std::mutex> guard(target->lock);
+    ring_header *header = target->header;
+    if (width == 0 || height == 0 || width > header->max_width || height > header->max_height) {
+        target->stats.too_large++;
+        return 0;
+    }
+    uint64_t number = header->published.load(std::memory_order_relaxed);
+    slot_header *slot = reinterpret_cast<slot_header *>(target->base + slot_offset(header, number));
+    uint8_t *data = reinterpret_cast<uint8_t *>(slot) + header->data_offset;
+    uint64_t generation = slot->generation.load(std::memory_order_relaxed);
+    slot->generation.store(generation + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+
+    slot->number = number;
+    slot->timestamp = timestamp;
+    slot->width = width;
+    slot->height = height;
+    uint64_t offset = 0;
+    for (int plane = 0; plane < 3; plane++) {
+        uint32_t plane_width, plane_height;
+        plane_size(plane, width, height, &plane_width, &plane_height);
+        uint64_t stride = align(plane_width);
+        slot->strides[plane] = (uint32_t)stride;
+        slot->offsets[plane] = offset;
+        for (uint32_t y = 0; y < plane_height; y++) {
+            std::memcpy(data + offset + y * stride, planes[plane] + (ptrdiff_t)y * strides[plane],
+                        plane_width);
+        }
+        offset += stride * plane_height;
+    }
+    slot->exported_ns = now_ns();
+
+    slot->generation.store(generation + 2, std::memory_order_release);
+    header->published.store(number + 1, std::memory_order_release);
+    target->stats.frames++;
+    target->stats.bytes += offset;
+    return 1;
+}
+
+int otk_frame_exporter_get_stats(otk_frame_exporter *exporter, const char *stream_id,
+                                 otk_frame_export_stats *stats) {
+    if (exporter == nullptr || stream_id == nullptr || stats == nullptr) {
+        return 0;
+    }
+    std::shared_ptr<ring> target = find_ring(exporter, stream_id);
+    if (!target) {
+        return 0;
+    }
+    std::lock_guard<std::mutex> guard(target->lock);
+    *stats = target->stats;
+    return 1;
+}
+
+// The header comes from another process, so nothing it says is trusted
+// further than the mapping.
+static bool valid_header(const ring_header *header, size_t size) {
+    if (header->version != kVersion ||
+        header->slot_count < kMinSlots || header->slot_count > kMaxSlots ||
+        header->max_width == 0 || header->max_width > kMaxDimension ||
+        header->max_height == 0 || header->max_height > kMaxDimension) {
+        return false;
+    }
+    uint64_t capacity = frame_capacity(header->max_width, header->max_height);
+    if (header->capacity < capacity || header->capacity > size ||
+        header->slots_offset < sizeof(ring_header) || header->slots_offset > size ||
+        header->data_offset < sizeof(slot_header) || header->data_offset > size ||
+        header->slot_size < header->data_offset + header->capacity ||
+        header->slot_size % kAlignment != 0 || header->data_offset % kAlignment != 0) {
+        return false;
+    }
+    return header->slot_size <= (size - header->slots_offset) / header->slot_count;
+}
+
+otk_frame_reader *otk_frame_reader_open(const char *name) {
+    if (name == nullptr) {
+        return nullptr;
+    }
+    int fd = shm_open(name, O_RDONLY, 0);
+    if (fd < 0) {
+        return nullptr;
+    }
+    struct stat info;
+    void *base = MAP_FAILED;
+    if (fstat(fd, &info) == 0 && (size_t)info.st_size >= sizeof(ring_header)) {
+        base = mmap(nullptr, (size_t)info.st_size, PROT_READ, MAP_SHARED, fd, 0);
+    }
+    close(fd);
+    if (base == MAP_FAILED) {
+        return nullptr;
+    }
+    size_t size = (size_t)info.st_size;
+    const ring_header *header = static_cast<const ring_header *>(base);
+    if (header->magic.load(std::memory_order_acquire) != kMagic || !valid_header(header, size)) {
+        munmap(base, size);
+        return nullptr;
+    }
+    otk_frame_reader *reader = new otk_frame_reader();
+    reader->base = static_cast<uint8_t *>(base);
+    reader->size = size;
+    reader->header = header;
+    std::memcpy(reader->stream_id, header->stream_id, kMaxStreamIdLength - 1);
+    uint64_t published = header->published.load(std::memory_order_acquire);
+    reader->next = published > 0 ? published - 1 : 0;
+    return reader;
+}
+
+void otk_frame_reader_close(otk_frame_reader *reader) {
+    if (reader == nullptr) {
+        return;
+    }
+    munmap(reader->base, reader->size);
+    delete reader;
+}
+
+const char *otk_frame_reader_stream_id(otk_frame_reader *reader) {
+    return reader ? reader->stream_id : nullptr;
+}
+
+// Planes must lie in the slot; a torn or hostile header could say anything.
+static bool valid_frame(const ring_header *header, const otk_exported_frame &frame,
+                        const uint64_t offsets[3]) {
+    if (frame.width == 0 || frame.height == 0 ||
+        frame.width > header->max_width || frame.height > header->max_height) {
+        return false;
+    }
+    for (int plane = 0; plane < 3; plane++) {
+        uint32_t plane_width, plane_height;
+        plane_size(plane, frame.width, frame.height, &plane_width, &plane_height);
+        uint64_t stride = (uint32_t)frame.strides[plane];
+        if (frame.strides[plane] <= 0 || stride < plane_width || offsets[plane] > header->capacity ||
+            stride * (plane_height - 1) + plane_width > header->capacity - offsets[plane]) {
+            return false;
+        }
+    }
+    return true;
+}
+
+int otk_frame_reader_next(otk_frame_reader *reader, int latest, otk_exported_frame *frame) {
+    if (reader == nullptr || frame == nullptr) {
+        return 0;
+    }
+    const ring_header *header = reader->header;
+    uint64_t slots = header->slot_count;
+    for (int attempt = 0; attempt < kReadAttempts; attempt++) {
+        uint64_t published = header->published.load(std::memory_order_acquire);
+        if (reader->next >= published) {
+            return 0;
+        }
+        // The slot after the newest frame may already be rewritten.
+        uint64_t oldest = published >= slots ? published - (slots - 1) : 0;
+        uint64_t number = latest ? published - 1 : std::max(reader->next, oldest);
+        const slot_header *slot =
+            reinterpret_cast<const slot_header *>(reader->base + slot_offset(header, number));
+        uint64_t generation = slot->generation.load(std::memory_order_acquire);
+        if (generation & 1) {
+            continue;
+        }
+        otk_exported_frame read = {};
+        uint64_t offsets[3];
+        uint64_t slot_number = slot->number;
+        read.number = number;
+        read.timestamp = slot->timestamp;
+        read.exported_ns = slot->exported_ns;
+        read.width = slot->width;
+        read.height = slot->height;
+        for (int plane = 0; plane < 3; plane++) {
+            read.strides[plane] = (int)std::min<uint32_t>(slot->strides[plane], INT32_MAX);
+            offsets[plane] = slot->offsets[plane];
+        }
+        read.generation = generation;
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if (slot->generation.load(std::memory_order_relaxed) != generation || slot_number != number) {
+            continue;
+        }
+        reader->stats.skipped += number - reader->next;
+        reader->next = number + 1;
+        if (!valid_frame(header, read, offsets)) {
+            reader->stats.skipped++;
+            continue;
+        }
+        const uint8_t *data = reinterpret_cast<const uint8_t *>(slot) + header->data_offset;
+        for (int plane = 0; plane < 3; plane++) {
+            read.planes[plane] = data + offsets[plane];
+        }
+        reader->stats.frames++;
+        *frame = read;
+        return 1;
+    }
+    return 0;
+}
+
+int otk_frame_reader_valid(otk_frame_reader *reader, const otk_exported_frame *frame) {
+    if (reader == nullptr || frame == nullptr) {
+        return 0;
+    }
+    std::atomic_thread_fence(std::memory_order_acquire);
+    const slot_header *slot = reinterpret_cast<const slot_header *>(
+        reader->base + slot_offset(reader->header, frame->number));
+    if (slot->generation.load(std::memory_order_relaxed) != frame->generation) {
+        reader->stats.torn++;
+        return 0;
+    }
+    return 1;
+}
+
+int otk_frame_reader_closed(otk_frame_reader *reader) {
+    if (reader == nullptr) {
+        return 1;
+    }
+    return reader->header->closed.load(std::memory_order_acquire) ? 1 : 0;
+}
+
+void otk_frame_reader_get_stats(otk_frame_reader *reader, otk_frame_reader_stats *stats) {
+    if (reader == nullptr || stats == nullptr) {
+        return;
+    }
+    *stats = reader->stats;
+}
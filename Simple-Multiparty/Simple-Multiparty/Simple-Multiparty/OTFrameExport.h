@@ -0,0 +1,162 @@
+//
+//  OTFrameExport.h
+//  Simple-Multiparty
+//
+//  Copyright (c) 2026 Vonage. All rights reserved.
+//
+
+#ifndef OTFrameExport_h
+#define OTFrameExport_h
+
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * Exports subscriber frames to other processes through one POSIX shared
+ * memory ring per stream.
+ *
+ * A ring is a header followed by a fixed number of slots, each big enough
+ * for an I420 frame of the largest size it was created for. The exporter
+ * copies each frame into the next slot, so a frame is copied once however
+ * many processes read it, and readers use the planes in place.
+ *
+ * Slots are guarded by a generation counter that is odd while the slot is
+ * being written, and the header counts the frames published. Nothing is
+ * locked between processes: the exporter never waits for a reader, and a
+ * reader that falls more than a ring behind skips to the frames still
+ * there. Since a frame can be overwritten while it is read, a reader checks
+ * otk_frame_reader_valid after using it and drops whatever it computed if
+ * the frame changed underneath.
+ *
+ * The reader half only depends on this file and OTFrameExport.cpp, so
+ * analytics processes can build it without the SDK, on macOS or Linux.
+ */
+typedef struct otk_frame_exporter otk_frame_exporter;
+typedef struct otk_frame_reader otk_frame_reader;
+
+/**
+ * Longest ring name, with the terminating NUL; macOS does not allow longer
+ * shared memory names.
+ */
+#define OTK_FRAME_RING_NAME_SIZE 32
+
+typedef struct otk_frame_export_stats {
+    uint64_t frames;
+    uint64_t bytes;
+    /** Frames larger than the slots, not exported. */
+    uint64_t too_large;
+} otk_frame_export_stats;
+
+/**
+ * Writes the shared memory name of a stream's ring to name, which holds
+ * OTK_FRAME_RING_NAME_SIZE bytes: prefix followed by a hash of the stream
+ * id, the same on every process. prefix NULL is "/otk-"; a sandboxed app
+ * must use its application group followed by a slash. Returns 0 if the
+ * prefix is too long for a name.
+ */
+int otk_frame_ring_name(const char *prefix, const char *stream_id, char *name);
+
+/**
+ * Rings are named with prefix, see otk_frame_ring_name. Each gets slots
+ * slots of an I420 frame up to max_width by max_height. Readers can fall
+ * slots - 1 frames behind without skipping.
+ */
+otk_frame_exporter *otk_frame_exporter_new(const char *prefix, uint32_t slots,
+                                           uint32_t max_width, uint32_t max_height);
+
+/** Removes the rings of the streams still exported. */
+void otk_frame_exporter_delete(otk_frame_exporter *exporter);
+
+/**
+ * Creates the stream's ring, replacing one left behind by a process that
+ * did not remove it. Returns 0 if the shared memory cannot be created or
+ * the prefix is too long.
+ */
+int otk_frame_exporter_add_stream(otk_frame_exporter *exporter, const char *stream_id);
+
+/**
+ * Marks the ring closed for its readers and removes its name. Readers keep
+ * their mapping until they close it.
+ */
+void otk_frame_exporter_remove_stream(otk_frame_exporter *exporter, const char *stream_id);
+
+/**
+ * Publishes an I420 frame of the stream. Returns 0 if the stream is not
+ * exported or the frame does not fit a slot. Safe to call from the render
+ * thread while streams are added and removed.
+ */
+int otk_frame_exporter_write(otk_frame_exporter *exporter, const char *stream_id,
+                             int64_t timestamp, uint32_t width, uint32_t height,
+                             const uint8_t *const planes[3], const int strides[3]);
+
+/** Returns 0 if the stream is not exported. */
+int otk_frame_exporter_get_stats(otk_frame_exporter *exporter, const char *stream_id,
+                                 otk_frame_export_stats *stats);
+
+/** A frame in a ring, read in place. */
+typedef struct otk_exported_frame {
+    /** Frames published before this one. */
+    uint64_t number;
+    int64_t timestamp;
+    /** When it was published, on std::chrono::steady_clock. */
+    int64_t exported_ns;
+    uint32_t width;
+    uint32_t height;
+    const uint8_t *planes[3];
+    int strides[3];
+    /** Slot generation the frame was read at. */
+    uint64_t generation;
+} otk_exported_frame;
+
+typedef struct otk_frame_reader_stats {
+    uint64_t frames;
+    /** Frames overwritten before they were read. */
+    uint64_t skipped;
+    /** Frames overwritten while they were read. */
+    uint64_t torn;
+} otk_frame_reader_stats;
+
+/**
+ * Maps a ring read-only. Returns NULL if it does not exist or is not
+ * initialized yet. Reading starts at the newest frame. A reader is used
+ * from one thread; threads that each need the frames open their own.
+ */
+otk_frame_reader *otk_frame_reader_open(const char *name);
+
+void otk_frame_reader_close(otk_frame_reader *reader);
+
+/** Stream id the ring was created for. */
+const char *otk_frame_reader_stream_id(otk_frame_reader *reader);
+
+/**
+ * Gets the next frame, or with latest set the newest one, skipping the rest.
+ * Returns 0 if no frame was published since the last one read. The planes
+ * point into the ring and stay mapped until the reader is closed. The next
+ * frame is the oldest, the first to be overwritten, so a reader slower than
+ * the frames arrive should ask for the latest.
+ */
+int otk_frame_reader_next(otk_frame_reader *reader, int latest, otk_exported_frame *frame);
+
+/**
+ * Returns 1 if the frame was not overwritten since it was read, so what
+ * was computed from its planes holds. Call after using them.
+ */
+int otk_frame_reader_valid(otk_frame_reader *reader, const otk_exported_frame *frame);
+
+/**
+ * Returns 1 once the exporter removed the stream or exited cleanly. A new
+ * ring for the same stream needs the reader to be opened again.
+ */
+int otk_frame_reader_closed(otk_frame_reader *reader);
+
+void otk_frame_reader_get_stats(otk_frame_reader *reader, otk_frame_reader_stats *stats);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* OTFrameExport_h */
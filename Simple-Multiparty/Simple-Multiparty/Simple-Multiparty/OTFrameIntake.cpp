@@ -0,0 +1,124 @@
+//
+//  OTFrameIntake.cpp
+//  Simple-Multiparty
+//
+//  Copyright (c) 2026 Vonage. All rights reserved.
+//
+
+#include "OTFrameIntake.h"
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+
+struct otk_frame_intake {
+    int64_t hidden_refresh_us;
+    std::atomic<uint32_t> hidden_reasons;
+    // Time the last frame was kept while hidden. Reset when the view becomes
+    // hidden so the first hidden frame is kept.
+    std::atomic<int64_t> last_hidden_copy_us;
+
+    std::atomic<uint64_t> frames_copied;
+    std::atomic<uint64_t> frames_skipped;
+    std::atomic<uint64_t> bytes_copied;
+    std::atomic<uint64_t> bytes_skipped;
+    std::atomic<uint64_t> resumes;
+};
+
+// Marks that no frame has been kept since the view became hidden.
+static const int64_t kNoHiddenCopy = INT64_MIN;
+
+otk_frame_intake *otk_frame_intake_new(int64_t hidden_refresh_us) {
+    otk_frame_intake *intake = new otk_frame_intake();
+    intake->hidden_refresh_us = hidden_refresh_us;
+    intake->hidden_reasons.store(0);
+    intake->last_hidden_copy_us.store(kNoHiddenCopy);
+    intake->frames_copied.store(0);
+    intake->frames_skipped.store(0);
+    intake->bytes_copied.store(0);
+    intake->bytes_skipped.store(0);
+    intake->resumes.store(0);
+    return intake;
+}
+
+void otk_frame_intake_delete(otk_frame_intake *intake) {
+    delete intake;
+}
+
+int64_t otk_frame_intake_now_us(void) {
+    return (int64_t)std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+enum otk_view_visibility_change otk_frame_intake_set_hidden_reason(otk_frame_intake *intake,
+                                                                   enum otk_view_hidden_reason reason,
+                                                                   int set) {
+    if (intake == nullptr) {
+        return OTK_VIEW_VISIBILITY_UNCHANGED;
+    }
+    uint32_t before = set ? intake->hidden_reasons.fetch_or(reason)
+                          : intake->hidden_reasons.fetch_and(~(uint32_t)reason);
+    uint32_t after = set ? before | reason : before & ~(uint32_t)reason;
+    if (before == 0 && after != 0) {
+        intake->last_hidden_copy_us.store(kNoHiddenCopy);
+        return OTK_VIEW_BECAME_HIDDEN;
+    }
+    if (before != 0 && after == 0) {
+        intake->resumes.fetch_add(1, std::memory_order_relaxed);
+        return OTK_VIEW_BECAME_VISIBLE;
+    }
+    return OTK_VIEW_VISIBILITY_UNCHANGED;
+}
+
+uint32_t otk_frame_intake_hidden_reasons(otk_frame_intake *intake) {
+    return intake != nullptr ? intake->hidden_reasons.load() : 0;
+}
+
+static enum otk_frame_intake_decision count(otk_frame_intake *intake,
+                                            enum otk_frame_intake_decision decision,
+                                            uint64_t frame_bytes) {
+    if (decision == OTK_FRAME_INTAKE_COPY) {
+        intake->frames_copied.fetch_add(1, std::memory_order_relaxed);
+        intake->bytes_copied.fetch_add(frame_bytes, std::memory_order_relaxed);
+    } else {
+        intake->frames_skipped.fetch_add(1, std::memory_order_relaxed);
+        intake->bytes_skipped.fetch_add(frame_bytes, std::memory_order_relaxed);
+    }
+    return decision;
+}
+
+enum otk_frame_intake_decision otk_frame_intake_on_frame(otk_frame_intake *intake,
+                                                         uint64_t frame_bytes,
+                                                         int64_t now_us) {
+    if (intake == nullptr) {
+        return OTK_FRAME_INTAKE_COPY;
+    }
+    if (intake->hidden_reasons.load(std::memory_order_acquire) == 0) {
+        return count(intake, OTK_FRAME_INTAKE_COPY, frame_bytes);
+    }
+    if (intake->hidden_refresh_us <= 0) {
+        return count(intake, OTK_FRAME_INTAKE_SKIP, frame_bytes);
+    }
+    int64_t last = intake->last_hidden_copy_us.load(std::memory_order_relaxed);
+    if (last != kNoHiddenCopy && now_us - last < intake->hidden_refresh_us) {
+        return count(intake, OTK_FRAME_INTAKE_SKIP, frame_bytes);
+    }
+    // Frames come from a single thread, but use a CAS anyway so two
+    // callers cannot both keep a frame for the same period.
+    if (!intake->last_hidden_copy_us.compare_exchange_strong(last, now_us)) {
+        return count(intake, OTK_FRAME_INTAKE_SKIP, frame_bytes);
+    }
+    return count(intake, OTK_FRAME_INTAKE_COPY, frame_bytes);
+}
+
+void otk_frame_intake_get_stats(otk_frame_intake *intake,
+                                otk_frame_intake_stats *stats) {
+    if (intake == nullptr || stats == nullptr) {
+        return;
+    }
+    stats->frames_copied = intake->frames_copied.load(std::memory_order_relaxed);
+    stats->frames_skipped = intake->frames_skipped.load(std::memory_order_relaxed);
+    stats->bytes_copied = intake->bytes_copied.load(std::memory_order_relaxed);
+    stats->bytes_skipped = intake->bytes_skipped.load(std::memory_order_relaxed);
+    stats->resumes = intake->resumes.load(std::memory_order_relaxed);
+}
@@ -0,0 +1,96 @@
+//
+//  OTFrameIntake.h
+//  Simple-Multiparty
+//
+//  Copyright (c) 2026 Vonage. All rights reserved.
+//
+
+#ifndef OTFrameIntake_h
+#define OTFrameIntake_h
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * Decides whether a video view copies an incoming frame, based on whether
+ * anything of the view can be seen.
+ *
+ * While the view is visible every frame is copied. While it is hidden frames
+ * are rejected before the copy, except for one every hidden_refresh_us, so
+ * the view always holds a recent frame it can show as soon as it is visible
+ * again.
+ */
+typedef struct otk_frame_intake otk_frame_intake;
+
+/** Reasons a view cannot be seen. Any of them makes the view hidden. */
+enum otk_view_hidden_reason {
+    OTK_VIEW_OCCLUDED = 1 << 0,
+    OTK_VIEW_MINIMIZED = 1 << 1,
+    OTK_VIEW_APP_INACTIVE = 1 << 2,
+    OTK_VIEW_ZERO_SIZE = 1 << 3,
+    OTK_VIEW_RENDERING_DISABLED = 1 << 4,
+    OTK_VIEW_HIDDEN = 1 << 5,
+};
+
+enum otk_frame_intake_decision {
+    OTK_FRAME_INTAKE_SKIP = 0,
+    OTK_FRAME_INTAKE_COPY = 1,
+};
+
+enum otk_view_visibility_change {
+    OTK_VIEW_VISIBILITY_UNCHANGED = 0,
+    OTK_VIEW_BECAME_VISIBLE = 1,
+    OTK_VIEW_BECAME_HIDDEN = 2,
+};
+
+typedef struct otk_frame_intake_stats {
+    uint64_t frames_copied;
+    uint64_t frames_skipped;
+    uint64_t bytes_copied;
+    /** Memory bandwidth saved by not copying skipped frames. */
+    uint64_t bytes_skipped;
+    /** Times the view went from hidden to visible. */
+    uint64_t resumes;
+} otk_frame_intake_stats;
+
+/**
+ * Creates an intake for a visible view. hidden_refresh_us is how often a
+ * frame is still kept while hidden, 0 to keep none.
+ */
+otk_frame_intake *otk_frame_intake_new(int64_t hidden_refresh_us);
+
+void otk_frame_intake_delete(otk_frame_intake *intake);
+
+/** Monotonic clock in microseconds, for the now_us arguments below. */
+int64_t otk_frame_intake_now_us(void);
+
+/**
+ * Sets or clears one hidden reason. Returns whether the view became visible
+ * or hidden because of it. Safe to call from any thread.
+ */
+enum otk_view_visibility_change otk_frame_intake_set_hidden_reason(otk_frame_intake *intake,
+                                                                   enum otk_view_hidden_reason reason,
+                                                                   int set);
+
+/** Returns the current set of hidden reasons, 0 when visible. */
+uint32_t otk_frame_intake_hidden_reasons(otk_frame_intake *intake);
+
+/**
+ * Called for every incoming frame of frame_bytes bytes, before copying it.
+ * Lock-free, safe from the thread delivering frames.
+ */
+enum otk_frame_intake_decision otk_frame_intake_on_frame(otk_frame_intake *intake,
+                                                         uint64_t frame_bytes,
+                                                         int64_t now_us);
+
+void otk_frame_intake_get_stats(otk_frame_intake *intake,
+                                otk_frame_intake_stats *stats);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* OTFrameIntake_h */
@@ -0,0 +1,300 @@
+//
+//  OTFrameScaler.cpp
+//  Simple-Multiparty
+//
+//  Copyright (c) 2026 Vonage. All rights reserved.
+//
+
+#include "OTFrameScaler.h"
+
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#if defined(__ARM_NEON) || defined(__ARM_NEON__)
+#include <arm_neon.h>
+#define OTK_SCALER_NEON 1
+#elif defined(__SSE2__)
+#include <emmintrin.h>
+#define OTK_SCALER_SSE2 1
+#endif
+
+// Rows of the pooled planes start on this boundary.
+static const int kStrideAlignment = 32;
+
+struct scaler_pool {
+    std::mutex lock;
+    std::vector<struct scaled_buffer *> free;
+    uint32_t max_pooled;
+    bool detached;
+
+    std::atomic<uint64_t> frames_scaled;
+    std::atomic<uint64_t> bytes_in;
+    std::atomic<uint64_t> bytes_out;
+    std::atomic<uint64_t> buffers_allocated;
+};
+
+struct scaled_buffer {
+    // First member, so the public frame pointer is the buffer pointer.
+    otk_scaled_frame frame;
+    std::vector<uint8_t> storage;
+    std::shared_ptr<scaler_pool> pool;
+};
+
+struct otk_frame_scaler {
+    std::shared_ptr<scaler_pool> pool;
+};
+
+int otk_frame_scaler_select_factor(int frame_width,
+                                   int frame_height,
+                                   int view_width,
+                                   int view_height) {
+    if (view_width <= 0 || view_height <= 0) {
+        return 1;
+    }
+    int factor = 1;
+    while (factor < OTK_FRAME_SCALER_MAX_FACTOR &&
+           frame_width / (factor * 2) >= view_width &&
+           frame_height / (factor * 2) >= view_height) {
+        factor *= 2;
+    }
+    return factor;
+}
+
+otk_frame_scaler *otk_frame_scaler_new(uint32_t max_pooled) {
+    otk_frame_scaler *scaler = new otk_frame_scaler();
+    scaler->pool = std::make_shared<scaler_pool>();
+    scaler->pool->max_pooled = max_pooled;
+    scaler->pool->detached = false;
+    scaler->pool->frames_scaled.store(0);
+    scaler->pool->bytes_in.store(0);
+    scaler->pool->bytes_out.store(0);
+    scaler->pool->buffers_allocated.store(0);
+    return scaler;
+}
+
+void otk_frame_scaler_delete(otk_frame_scaler *scaler) {
+    if (scaler == nullptr) {
+        return;
+    }
+    {
+        std::lock_guard<std::mutex> guard(scaler->pool->lock);
+        for (scaled_buffer *buffer : scaler->pool->free) {
+            delete buffer;
+        }
+        scaler->pool->free.clear();
+        scaler->pool->detached = true;
+    }
+    delete scaler;
+}
+
+static void downscale_row_2x(const uint8_t *r0, const uint8_t *r1, uint8_t *dst, int width) {
+    int x = 0;
+#if OTK_SCALER_NEON
+    for (; x + 16 <= width; x += 16) {
+        uint8x16x2_t a = vld2q_u8(r0 + 2 * x);
+        uint8x16x2_t b = vld2q_u8(r1 + 2 * x);
+        uint16x8_t lo = vaddl_u8(vget_low_u8(a.val[0]), vget_low_u8(a.val[1]));
+        uint16x8_t hi = vaddl_u8(vget_high_u8(a.val[0]), vget_high_u8(a.val[1]));
+        lo = vaddq_u16(lo, vaddl_u8(vget_low_u8(b.val[0]), vget_low_u8(b.val[1])));
+        hi = vaddq_u16(hi, vaddl_u8(vget_high_u8(b.val[0]), vget_high_u8(b.val[1])));
+        vst1q_u8(dst + x, vcombine_u8(vrshrn_n_u16(lo, 2), vrshrn_n_u16(hi, 2)));
+    }
+#elif OTK_SCALER_SSE2
+    const __m128i even_mask = _mm_set1_epi16(0x00ff);
+    const __m128i round = _mm_set1_epi16(2);
+    for (; x + 16 <= width; x += 16) {
+        __m128i sums[2];
+        for (int half = 0; half < 2; half++) {
+            __m128i a = _mm_loadu_si128((const __m128i *)(r0 + 2 * x + 16 * half));
+            __m128i b = _mm_loadu_si128((const __m128i *)(r1 + 2 * x + 16 * half));
+            __m128i sum = _mm_add_epi16(_mm_and_si128(a, even_mask), _mm_srli_epi16(a, 8));
+            sum = _mm_add_epi16(sum, _mm_and_si128(b, even_mask));
+            sum = _mm_add_epi16(sum, _mm_srli_epi16(b, 8));
+            sums[half] = _mm_srli_epi16(_mm_add_epi16(sum, round), 2);
+        }
+        _mm_storeu_si128((__m128i *)(dst + x), _mm_packus_epi16(sums[0], sums[1]));
+    }
+#endif
+    for (; x < width; x++) {
+        int sum = r0[2 * x] + r0[2 * x + 1] + r1[2 * x] + r1[2 * x + 1];
+        dst[x] = (uint8_t)((sum + 2) >> 2);
+    }
+}
+
+static void downscale_row_4x(const uint8_t *const rows[4], uint8_t *dst, int width) {
+    int x = 0;
+#if OTK_SCALER_NEON
+    for (; x + 16 <= width; x += 16) {
+        uint16x4_t sums[4];
+        for (int quarter = 0; quarter < 4; quarter++) {
+            int offset = 4 * x + 16 * quarter;
+            // Pairwise sums of each row, accumulated over the four rows, then
+            // pairwise again: four 4x4 block sums.
+            uint16x8_t pairs = vpaddlq_u8(vld1q_u8(rows[0] + offset));
+            pairs = vpadalq_u8(pairs, vld1q_u8(rows[1] + offset));
+            pairs = vpadalq_u8(pairs, vld1q_u8(rows[2] + offset));
+            pairs = vpadalq_u8(pairs, vld1q_u8(rows[3] + offset));
+            sums[quarter] = vmovn_u32(vpaddlq_u16(pairs));
+        }
+        uint8x8_t lo = vrshrn_n_u16(vcombine_u16(sums[0], sums[1]), 4);
+        uint8x8_t hi = vrshrn_n_u16(vcombine_u16(sums[2], sums[3]), 4);
+        vst1q_u8(dst + x, vcombine_u8(lo, hi));
+    }
+#elif OTK_SCALER_SSE2
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i ones = _mm_set1_epi16(1);
+    const __m128i round = _mm_set1_epi32(8);
+    for (; x + 16 <= width; x += 16) {
+        __m128i sums[4];
+        for (int quarter = 0; quarter < 4; quarter++) {
+            int offset = 4 * x + 16 * quarter;
+            // Column sums over the four rows, then adjacent columns twice.
+            __m128i lo = zero;
+            __m128i hi = zero;
+            for (int row = 0; row < 4; row++) {
+                __m128i v = _mm_loadu_si128((const __m128i *)(rows[row] + offset));
+                lo = _mm_add_epi16(lo, _mm_unpacklo_epi8(v, zero));
+                hi = _mm_add_epi16(hi, _mm_unpackhi_epi8(v, zero));
+            }
+            __m128i pairs = _mm_packs_epi32(_mm_madd_epi16(lo, ones), _mm_madd_epi16(hi, ones));
+            __m128i blocks = _mm_madd_epi16(pairs, ones);
+            sums[quarter] = _mm_srli_epi32(_mm_add_epi32(blocks, round), 4);
+        }
+        __m128i lo = _mm_packs_epi32(sums[0], sums[1]);
+        __m128i hi = _mm_packs_epi32(sums[2], sums[3]);
+        _mm_storeu_si128((__m128i *)(dst + x), _mm_packus_epi16(lo, hi));
+    }
+#endif
+    for (; x < width; x++) {
+        int sum = 0;
+        for (int row = 0; row < 4; row++) {
+            const uint8_t *p = rows[row] + 4 * x;
+            sum += p[0] + p[1] + p[2] + p[3];
+        }
+        dst[x] = (uint8_t)((sum + 8) >> 4);
+    }
+}
+
+void otk_downscale_plane(const uint8_t *src,
+                         int src_stride,
+                         uint8_t *dst,
+                         int dst_stride,
+                         int dst_width,
+                         int dst_height,
+                         int factor) {
+    for (int y = 0; y < dst_height; y++) {
+        const uint8_t *row = src + (size_t)y * factor * src_stride;
+        uint8_t *out = dst + (size_t)y * dst_stride;
+        if (factor == 2) {
+            downscale_row_2x(row, row + src_stride, out, dst_width);
+        } else if (factor == 4) {
+            const uint8_t *rows[4] = {
+                row, row + src_stride, row + 2 * src_stride, row + 3 * src_stride
+            };
+            downscale_row_4x(rows, out, dst_width);
+        }
+    }
+}
+
+static int aligned_stride(int width) {
+    return (width + kStrideAlignment - 1) / kStrideAlignment * kStrideAlignment;
+}
+
+static scaled_buffer *acquire_buffer(otk_frame_scaler *scaler, int width, int height) {
+    {
+        std::lock_guard<std::mutex> guard(scaler->pool->lock);
+        std::vector<scaled_buffer *> &free = scaler->pool->free;
+        while (!free.empty()) {
+            scaled_buffer *buffer = free.back();
+            free.pop_back();
+            if (buffer->frame.width == width && buffer->frame.height == height) {
+                return buffer;
+            }
+            // The view or the frame changed size; buffers of the old size
+            // are not needed anymore.
+            delete buffer;
+        }
+    }
+    scaled_buffer *buffer = new scaled_buffer();
+    int chroma_width = width / 2;
+    int chroma_height = height / 2;
+    int luma_stride = aligned_stride(width);
+    int chroma_stride = aligned_stride(chroma_width);
+    size_t luma_size = (size_t)luma_stride * height;
+    size_t chroma_size = (size_t)chroma_stride * chroma_height;
+    buffer->storage.resize(luma_size + 2 * chroma_size);
+    buffer->frame.width = width;
+    buffer->frame.height = height;
+    buffer->frame.planes[0] = buffer->storage.data();
+    buffer->frame.planes[1] = buffer->storage.data() + luma_size;
+    buffer->frame.planes[2] = buffer->storage.data() + luma_size + chroma_size;
+    buffer->frame.strides[0] = luma_stride;
+    buffer->frame.strides[1] = chroma_stride;
+    buffer->frame.strides[2] = chroma_stride;
+    buffer->pool = scaler->pool;
+    scaler->pool->buffers_allocated.fetch_add(1, std::memory_order_relaxed);
+    return buffer;
+}
+
+otk_scaled_frame *otk_frame_scaler_scale_i420(otk_frame_scaler *scaler,
+                                              const uint8_t *const src_planes[3],
+                                              const int src_strides[3],
+                                              int width,
+                                              int height,
+                                              int factor) {
+    if (scaler == nullptr || (factor != 2 && factor != 4)) {
+        return nullptr;
+    }
+    // Even sizes keep every chroma sample inside the source chroma planes.
+    int dst_width = width / factor & ~1;
+    int dst_height = height / factor & ~1;
+    if (dst_width <= 0 || dst_height <= 0) {
+        return nullptr;
+    }
+    scaled_buffer *buffer = acquire_buffer(scaler, dst_width, dst_height);
+    otk_scaled_frame *frame = &buffer->frame;
+    otk_downscale_plane(src_planes[0], src_strides[0], frame->planes[0], frame->strides[0],
+                        dst_width, dst_height, factor);
+    for (int plane = 1; plane < 3; plane++) {
+        otk_downscale_plane(src_planes[plane], src_strides[plane],
+                            frame->planes[plane], frame->strides[plane],
+                            dst_width / 2, dst_height / 2, factor);
+    }
+    scaler_pool *pool = scaler->pool.get();
+    pool->frames_scaled.fetch_add(1, std::memory_order_relaxed);
+    pool->bytes_in.fetch_add((uint64_t)width * height * 3 / 2, std::memory_order_relaxed);
+    pool->bytes_out.fetch_add((uint64_t)dst_width * dst_height * 3 / 2,
+                              std::memory_order_relaxed);
+    return frame;
+}
+
+void otk_scaled_frame_release(otk_scaled_frame *frame) {
+    if (frame == nullptr) {
+        return;
+    }
+    scaled_buffer *buffer = (scaled_buffer *)frame;
+    std::shared_ptr<scaler_pool> pool = std::move(buffer->pool);
+    {
+        std::lock_guard<std::mutex> guard(pool->lock);
+        if (!pool->detached && pool->free.size() < pool->max_pooled) {
+            buffer->pool = pool;
+            pool->free.push_back(buffer);
+            return;
+        }
+    }
+    delete buffer;
+}
+
+void otk_frame_scaler_get_stats(otk_frame_scaler *scaler,
+                                otk_frame_scaler_stats *stats) {
+    if (scaler == nullptr || stats == nullptr) {
+        return;
+    }
+    scaler_pool *pool = scaler->pool.get();
+    stats->frames_scaled = pool->frames_scaled.load(std::memory_order_relaxed);
+    stats->bytes_in = pool->bytes_in.load(std::memory_order_relaxed);
+    stats->bytes_out = pool->bytes_out.load(std::memory_order_relaxed);
+    stats->buffers_allocated = pool->buffers_allocated.load(std::memory_order_relaxed);
+}
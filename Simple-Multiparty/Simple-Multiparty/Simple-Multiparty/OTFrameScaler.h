@@ -0,0 +1,100 @@
+//
+//  OTFrameScaler.h
+//  Simple-Multiparty
+//
+//  Copyright (c) 2026 Vonage. All rights reserved.
+//
+
+#ifndef OTFrameScaler_h
+#define OTFrameScaler_h
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * Downscales I420 frames on intake for views much smaller than the frame, so
+ * the view copies and uploads a view-sized frame instead of the full one.
+ *
+ * Frames are reduced by a power of two with a box filter (each output pixel
+ * is the average of a 2x2 or 4x4 block), using SSE2 or NEON when available.
+ * The GPU still does the remaining, less than 2x, minification. Output
+ * buffers come from a pool owned by the scaler and go back to it when
+ * released.
+ */
+typedef struct otk_frame_scaler otk_frame_scaler;
+
+/** Largest downscale factor; 4 cuts the bytes per frame by 16. */
+#define OTK_FRAME_SCALER_MAX_FACTOR 4
+
+/** A downscaled I420 frame. Planes are Y, U, V. */
+typedef struct otk_scaled_frame {
+    int width;
+    int height;
+    uint8_t *planes[3];
+    int strides[3];
+} otk_scaled_frame;
+
+typedef struct otk_frame_scaler_stats {
+    uint64_t frames_scaled;
+    /** Bytes of the source frames that were scaled. */
+    uint64_t bytes_in;
+    /** Bytes of the scaled frames; the view copies these instead. */
+    uint64_t bytes_out;
+    /** Buffers allocated because the pool had none of the right size. */
+    uint64_t buffers_allocated;
+} otk_frame_scaler_stats;
+
+/**
+ * Returns the downscale factor (1, 2 or 4) for a frame drawn in a view of
+ * view_width x view_height pixels: the largest one that keeps the frame at
+ * least as big as the view in both directions. 1 means no downscale.
+ */
+int otk_frame_scaler_select_factor(int frame_width,
+                                   int frame_height,
+                                   int view_width,
+                                   int view_height);
+
+/** max_pooled is the number of free buffers kept for reuse. */
+otk_frame_scaler *otk_frame_scaler_new(uint32_t max_pooled);
+
+/** Frames not released yet stay valid and are freed on release. */
+void otk_frame_scaler_delete(otk_frame_scaler *scaler);
+
+/**
+ * Downscales an I420 frame by factor (2 or 4). Output sizes are rounded down
+ * to even numbers. Returns NULL for any other factor or if the frame is too
+ * small. Release the result with otk_scaled_frame_release.
+ */
+otk_scaled_frame *otk_frame_scaler_scale_i420(otk_frame_scaler *scaler,
+                                              const uint8_t *const src_planes[3],
+                                              const int src_strides[3],
+                                              int width,
+                                              int height,
+                                              int factor);
+
+/** Returns the frame to its scaler's pool. Safe to call from any thread. */
+void otk_scaled_frame_release(otk_scaled_frame *frame);
+
+void otk_frame_scaler_get_stats(otk_frame_scaler *scaler,
+                                otk_frame_scaler_stats *stats);
+
+/**
+ * Box-filters one plane by factor (2 or 4) into dst_width x dst_height. The
+ * source must hold at least factor times as many rows and columns.
+ */
+void otk_downscale_plane(const uint8_t *src,
+                         int src_stride,
+                         uint8_t *dst,
+                         int dst_stride,
+                         int dst_width,
+                         int dst_height,
+                         int factor);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* OTFrameScaler_h */
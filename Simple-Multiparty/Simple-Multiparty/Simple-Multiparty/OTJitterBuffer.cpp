@@ -0,0 +1,255 @@
+//
+//  OTJitterBuffer.cpp
+//  Simple-Multiparty
+//
+//  Copyright (c) 2026 Vonage. All rights reserved.
+//
+
+#include "OTJitterBuffer.h"
+
+#include <algorithm>
+#include <chrono>
+#include <deque>
+#include <mutex>
+#include <vector>
+
+// Number of recent frames the jitter is measured over.
+static const size_t kJitterWindow = 128;
+
+// A timestamp jump bigger than this (either way) is a new stream, not jitter.
+static const int64_t kMaxTimestampJumpUs = 2000000;
+
+struct queued_frame {
+    void *frame;
+    int64_t timestamp_us;
+    int64_t arrival_us;
+};
+
+struct otk_jitter_buffer {
+    std::mutex lock;
+    otk_jitter_buffer_config config;
+    std::deque<queued_frame> queue;
+
+    // Transit time (arrival minus timestamp) of the recent frames. The
+    // smallest one is taken as the network delay without jitter.
+    std::vector<int64_t> transits;
+    size_t next_transit;
+    size_t transit_count;
+    int64_t base_transit_us;
+
+    int64_t target_delay_us;
+    int64_t jitter_p95_us;
+    bool has_last_push;
+    int64_t last_timestamp_us;
+    int64_t last_push_us;
+
+    bool has_last_present;
+    int64_t last_present_us;
+    int64_t last_present_timestamp_us;
+
+    uint64_t frames_received;
+    uint64_t frames_presented;
+    uint64_t frames_dropped;
+    int64_t total_added_latency_us;
+    int64_t total_judder_us;
+    uint64_t judder_samples;
+};
+
+void otk_jitter_buffer_config_default(otk_jitter_buffer_config *config) {
+    if (config == nullptr) {
+        return;
+    }
+    config->capacity = 8;
+    config->timestamp_rate = 1000000;
+    config->min_delay_us = 5000;
+    config->max_delay_us = 100000;
+    config->delay_margin_us = 2000;
+    config->shrink_us_per_second = 10000;
+    config->release = nullptr;
+    config->release_user_data = nullptr;
+}
+
+static void release(otk_jitter_buffer *buffer, void *frame) {
+    if (buffer->config.release != nullptr && frame != nullptr) {
+        buffer->config.release(frame, buffer->config.release_user_data);
+    }
+}
+
+static void reset_timing(otk_jitter_buffer *buffer) {
+    buffer->next_transit = 0;
+    buffer->transit_count = 0;
+    buffer->base_transit_us = 0;
+    buffer->target_delay_us = buffer->config.min_delay_us;
+    buffer->jitter_p95_us = 0;
+    buffer->has_last_push = false;
+    buffer->has_last_present = false;
+}
+
+static void release_queue(otk_jitter_buffer *buffer) {
+    for (const queued_frame &queued : buffer->queue) {
+        release(buffer, queued.frame);
+    }
+    buffer->queue.clear();
+}
+
+otk_jitter_buffer *otk_jitter_buffer_new(const otk_jitter_buffer_config *config) {
+    otk_jitter_buffer *buffer = new otk_jitter_buffer();
+    if (config != nullptr) {
+        buffer->config = *config;
+    } else {
+        otk_jitter_buffer_config_default(&buffer->config);
+    }
+    buffer->config.capacity = std::max<uint32_t>(buffer->config.capacity, 1);
+    if (buffer->config.timestamp_rate <= 0) {
+        buffer->config.timestamp_rate = 1000000;
+    }
+    buffer->transits.resize(kJitterWindow);
+    reset_timing(buffer);
+    buffer->frames_received = 0;
+    buffer->frames_presented = 0;
+    buffer->frames_dropped = 0;
+    buffer->total_added_latency_us = 0;
+    buffer->total_judder_us = 0;
+    buffer->judder_samples = 0;
+    return buffer;
+}
+
+void otk_jitter_buffer_delete(otk_jitter_buffer *buffer) {
+    if (buffer == nullptr) {
+        return;
+    }
+    release_queue(buffer);
+    delete buffer;
+}
+
+int64_t otk_jitter_buffer_now_us(void) {
+    return (int64_t)std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+// Recomputes the base transit and the target delay after a new transit
+// sample. Sorting 128 values per frame is cheap next to a frame copy.
+static void update_target_delay(otk_jitter_buffer *buffer, int64_t elapsed_us) {
+    std::vector<int64_t> window(buffer->transits.begin(),
+                                buffer->transits.begin() + buffer->transit_count);
+    std::sort(window.begin(), window.end());
+    buffer->base_transit_us = window.front();
+    int64_t p95 = window[(window.size() - 1) * 95 / 100] - window.front();
+    buffer->jitter_p95_us = p95;
+
+    const otk_jitter_buffer_config &config = buffer->config;
+    int64_t wanted = std::clamp(p95 + config.delay_margin_us,
+                                config.min_delay_us, config.max_delay_us);
+    if (wanted >= buffer->target_delay_us) {
+        buffer->target_delay_us = wanted;
+    } else {
+        int64_t shrink = config.shrink_us_per_second * elapsed_us / 1000000;
+        buffer->target_delay_us = std::max(wanted, buffer->target_delay_us - shrink);
+    }
+}
+
+void otk_jitter_buffer_push(otk_jitter_buffer *buffer,
+                            void *frame,
+                            int64_t timestamp,
+                            int64_t now_us) {
+    if (buffer == nullptr) {
+        return;
+    }
+    std::lock_guard<std::mutex> guard(buffer->lock);
+    // Split to avoid overflowing for large timestamps.
+    int64_t rate = buffer->config.timestamp_rate;
+    int64_t timestamp_us = timestamp / rate * 1000000 + timestamp % rate * 1000000 / rate;
+    if (buffer->has_last_push) {
+        int64_t jump = timestamp_us - buffer->last_timestamp_us;
+        if (jump > kMaxTimestampJumpUs || jump < -kMaxTimestampJumpUs) {
+            // The queued frames belong to the old timeline: they would all
+            // be due at once, or after a backwards jump never.
+            buffer->frames_dropped += buffer->queue.size();
+            release_queue(buffer);
+            reset_timing(buffer);
+        } else if (jump <= 0) {
+            // Out of order or repeated; the newer frame is already queued.
+            buffer->frames_received++;
+            buffer->frames_dropped++;
+            release(buffer, frame);
+            return;
+        }
+    }
+    int64_t elapsed_us = buffer->has_last_push ? now_us - buffer->last_push_us : 0;
+    buffer->has_last_push = true;
+    buffer->last_timestamp_us = timestamp_us;
+    buffer->last_push_us = now_us;
+    buffer->frames_received++;
+
+    buffer->transits[buffer->next_transit] = now_us - timestamp_us;
+    buffer->next_transit = (buffer->next_transit + 1) % buffer->transits.size();
+    buffer->transit_count = std::min(buffer->transit_count + 1, buffer->transits.size());
+    update_target_delay(buffer, elapsed_us);
+
+    if (buffer->queue.size() >= buffer->config.capacity) {
+        release(buffer, buffer->queue.front().frame);
+        buffer->queue.pop_front();
+        buffer->frames_dropped++;
+    }
+    buffer->queue.push_back({ frame, timestamp_us, now_us });
+}
+
+void *otk_jitter_buffer_pop(otk_jitter_buffer *buffer, int64_t now_us) {
+    if (buffer == nullptr) {
+        return nullptr;
+    }
+    std::lock_guard<std::mutex> guard(buffer->lock);
+    int64_t offset = buffer->base_transit_us + buffer->target_delay_us;
+    queued_frame due = { nullptr, 0, 0 };
+    while (!buffer->queue.empty() &&
+           buffer->queue.front().timestamp_us + offset <= now_us) {
+        if (due.frame != nullptr) {
+            release(buffer, due.frame);
+            buffer->frames_dropped++;
+        }
+        due = buffer->queue.front();
+        buffer->queue.pop_front();
+    }
+    if (due.frame == nullptr) {
+        return nullptr;
+    }
+    buffer->frames_presented++;
+    buffer->total_added_latency_us += now_us - due.arrival_us;
+    if (buffer->has_last_present) {
+        int64_t presented_interval = now_us - buffer->last_present_us;
+        int64_t timestamp_interval = due.timestamp_us - buffer->last_present_timestamp_us;
+        int64_t judder = presented_interval - timestamp_interval;
+        buffer->total_judder_us += judder < 0 ? -judder : judder;
+        buffer->judder_samples++;
+    }
+    buffer->has_last_present = true;
+    buffer->last_present_us = now_us;
+    buffer->last_present_timestamp_us = due.timestamp_us;
+    return due.frame;
+}
+
+void otk_jitter_buffer_flush(otk_jitter_buffer *buffer) {
+    if (buffer == nullptr) {
+        return;
+    }
+    std::lock_guard<std::mutex> guard(buffer->lock);
+    release_queue(buffer);
+    reset_timing(buffer);
+}
+
+void otk_jitter_buffer_get_stats(otk_jitter_buffer *buffer,
+                                 otk_jitter_buffer_stats *stats) {
+    if (buffer == nullptr || stats == nullptr) {
+        return;
+    }
+    std::lock_guard<std::mutex> guard(buffer->lock);
+    stats->frames_received = buffer->frames_received;
+    stats->frames_presented = buffer->frames_presented;
+    stats->frames_dropped = buffer->frames_dropped;
+    stats->target_delay_us = buffer->target_delay_us;
+    stats->jitter_p95_us = buffer->jitter_p95_us;
+    stats->average_added_latency_us = buffer->frames_presented > 0 ?
+        buffer->total_added_latency_us / (int64_t)buffer->frames_presented : 0;
+    stats->average_judder_us = buffer->judder_samples > 0 ?
+        buffer->total_judder_us / (int64_t)buffer->judder_samples : 0;
+}
@@ -0,0 +1,105 @@
+//
+//  OTJitterBuffer.h
+//  Simple-Multiparty
+//
+//  Copyright (c) 2026 Vonage. All rights reserved.
+//
+
+#ifndef OTJitterBuffer_h
+#define OTJitterBuffer_h
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * Small render queue that presents frames at the pace of their timestamps
+ * instead of their arrival times.
+ *
+ * Each frame is scheduled at its timestamp, mapped to the local clock, plus a
+ * target delay. The target delay follows the recent arrival jitter: it grows
+ * as soon as frames arrive later than usual and shrinks slowly while arrival
+ * is stable.
+ *
+ * A timestamp jump of more than 2 s either way starts a new timeline: the
+ * frames queued until then are dropped and the timing history forgotten.
+ *
+ * Frames are opaque to the buffer. Frames it drops, or still holds when it
+ * is flushed or deleted, are handed to the release callback.
+ */
+typedef struct otk_jitter_buffer otk_jitter_buffer;
+
+typedef void (*otk_jitter_buffer_release_cb)(void *frame, void *user_data);
+
+typedef struct otk_jitter_buffer_config {
+    /** Frames kept at most; the oldest is dropped when a new one arrives. */
+    uint32_t capacity;
+    /** Timestamp units per second (1000000 for microseconds). */
+    int64_t timestamp_rate;
+    int64_t min_delay_us;
+    int64_t max_delay_us;
+    /** Added on top of the measured jitter. */
+    int64_t delay_margin_us;
+    /** How fast the target delay comes down when arrival is stable. */
+    int64_t shrink_us_per_second;
+    otk_jitter_buffer_release_cb release;
+    void *release_user_data;
+} otk_jitter_buffer_config;
+
+typedef struct otk_jitter_buffer_stats {
+    uint64_t frames_received;
+    uint64_t frames_presented;
+    /** Frames dropped because a newer one was due or the queue was full. */
+    uint64_t frames_dropped;
+    /** Current target delay. */
+    int64_t target_delay_us;
+    /** 95th percentile of arrival jitter over the recent window. */
+    int64_t jitter_p95_us;
+    /** Average time a presented frame spent in the buffer. */
+    int64_t average_added_latency_us;
+    /**
+     * Average difference between the interval two frames were presented at and
+     * the interval of their timestamps. Lower is smoother.
+     */
+    int64_t average_judder_us;
+} otk_jitter_buffer_stats;
+
+/**
+ * Fills config with 8 frames, microsecond timestamps, a 5 to 100 ms target
+ * delay with a 2 ms margin, and a 10 ms per second shrink rate.
+ */
+void otk_jitter_buffer_config_default(otk_jitter_buffer_config *config);
+
+otk_jitter_buffer *otk_jitter_buffer_new(const otk_jitter_buffer_config *config);
+
+/** Releases the frames still queued. */
+void otk_jitter_buffer_delete(otk_jitter_buffer *buffer);
+
+/** Monotonic clock in microseconds, for the now_us arguments below. */
+int64_t otk_jitter_buffer_now_us(void);
+
+/** Queues a frame that arrived at now_us. Safe to call from any thread. */
+void otk_jitter_buffer_push(otk_jitter_buffer *buffer,
+                            void *frame,
+                            int64_t timestamp,
+                            int64_t now_us);
+
+/**
+ * Returns the newest frame due at now_us, or NULL if none is due. Older due
+ * frames are dropped. The caller owns the returned frame.
+ */
+void *otk_jitter_buffer_pop(otk_jitter_buffer *buffer, int64_t now_us);
+
+/** Releases every queued frame and forgets the timing history. */
+void otk_jitter_buffer_flush(otk_jitter_buffer *buffer);
+
+void otk_jitter_buffer_get_stats(otk_jitter_buffer *buffer,
+                                 otk_jitter_buffer_stats *stats);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* OTJitterBuffer_h */
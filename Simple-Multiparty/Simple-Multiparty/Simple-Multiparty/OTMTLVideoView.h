@@ -11,8 +11,24 @@
 #import "OTMTLVideoRenderer.h"
 #import <Metal/Metal.h>
 #import <MetalKit/MetalKit.h>
+#include "OTJitterBuffer.h"
+#include "OTFrameIntake.h"
+#include "OTFrameScaler.h"
 
 @interface OTMTLVideoView : OTBaseVideoView <MTKViewDelegate, OTVideoRender>
 
+/* Present frames at the pace of their timestamps rather than as they arrive */
+@property (nonatomic, assign) BOOL jitterBufferEnabled;
+
+- (otk_jitter_buffer_stats)jitterBufferStats;
+
+/* Copy frames at a view-sized resolution when they are much bigger than the view */
+@property (nonatomic, assign) BOOL downscaleOnIntake;
+
+- (otk_frame_scaler_stats)downscaleStats;
+
+/* Frames copied and skipped while the view could not be seen */
+- (otk_frame_intake_stats)intakeStats;
+
 @end
 
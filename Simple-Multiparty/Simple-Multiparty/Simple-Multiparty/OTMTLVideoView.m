@@ -52,6 +52,36 @@
     __weak id<OTRendererDelegate> _delegate;
     int _viewWidth;
     int _viewHeight;
+    otk_jitter_buffer *_jitterBuffer;
+    otk_frame_intake *_intake;
+    __weak NSWindow *_observedWindow;
+    otk_frame_scaler *_scaler;
+    int _pixelWidth;
+    int _pixelHeight;
+}
+
+// While hidden, still keep one frame a second so the view is not stale when
+// it shows up again.
+static const int64_t kHiddenFrameRefreshUs = 1000000;
+
+// Downscaled buffers kept for reuse: enough for a full jitter buffer plus
+// the frame being drawn and the one being filled.
+static const uint32_t kScaledFramePoolSize = 10;
+
+static void jitter_buffer_release_frame(void *frame, void *user_data) {
+    otc_video_frame_delete((otc_video_frame *)frame);
+}
+
+static const uint8_t *scaled_frame_get_plane(void *user_data, enum otc_video_frame_plane plane) {
+    return ((otk_scaled_frame *)user_data)->planes[plane];
+}
+
+static int scaled_frame_get_plane_stride(void *user_data, enum otc_video_frame_plane plane) {
+    return ((otk_scaled_frame *)user_data)->strides[plane];
+}
+
+static void scaled_frame_release(void *user_data) {
+    otk_scaled_frame_release((otk_scaled_frame *)user_data);
 }
 
 @synthesize delegate = _delegate;
@@ -74,6 +104,9 @@
     _frameLock = [[NSLock alloc] init];
     _renderingEnabled = YES;
     _clearRenderer = 0;
+    if (!_intake) {
+        _intake = otk_frame_intake_new(kHiddenFrameRefreshUs);
+    }
     
     _viewWidth = self.frame.size.width;
     _viewHeight = self.frame.size.height;
@@ -112,21 +145,55 @@
     _mlRenderer = nil;
     [_frameLock lock];
     _videoFrame = nil;
+    otk_jitter_buffer_delete(_jitterBuffer);
+    _jitterBuffer = NULL;
+    otk_frame_scaler_delete(_scaler);
+    _scaler = NULL;
     [_frameLock unlock];
     _frameLock = nil;
+    otk_frame_intake_delete(_intake);
+    _intake = NULL;
 }
 
 #pragma mark - Private Methods
 
 - (void)didBecomeActive {
-    if (_renderingEnabled)
-    {
-        _mtkView.paused = NO;
-    }
+    // Resumes rendering unless the view is still hidden for another reason.
+    [self setHiddenReason:OTK_VIEW_APP_INACTIVE hidden:NO];
 }
 
 - (void)willResignActive {
-    _mtkView.paused = YES;
+    [self setHiddenReason:OTK_VIEW_APP_INACTIVE hidden:YES];
+}
+
+- (void)setHiddenReason:(enum otk_view_hidden_reason)reason hidden:(BOOL)hidden {
+    switch (otk_frame_intake_set_hidden_reason(_intake, reason, hidden)) {
+        case OTK_VIEW_BECAME_VISIBLE:
+            // Draw the frame kept while hidden right away.
+            if (_renderingEnabled)
+            {
+                _mtkView.paused = NO;
+            }
+            break;
+        case OTK_VIEW_BECAME_HIDDEN:
+            _mtkView.paused = YES;
+            break;
+        default:
+            break;
+    }
+}
+
+- (void)windowOcclusionDidChange:(NSNotification *)notification {
+    BOOL visible = (self.window.occlusionState & NSWindowOcclusionStateVisible) != 0;
+    [self setHiddenReason:OTK_VIEW_OCCLUDED hidden:!visible];
+}
+
+- (void)windowDidMiniaturize:(NSNotification *)notification {
+    [self setHiddenReason:OTK_VIEW_MINIMIZED hidden:YES];
+}
+
+- (void)windowDidDeminiaturize:(NSNotification *)notification {
+    [self setHiddenReason:OTK_VIEW_MINIMIZED hidden:NO];
 }
 
 - (BOOL)setupMTL {
@@ -174,6 +241,7 @@
 
 - (void)setRenderingEnabled:(BOOL)renderingEnabled {
      _renderingEnabled = renderingEnabled;
+    [self setHiddenReason:OTK_VIEW_RENDERING_DISABLED hidden:!renderingEnabled];
     if (_renderingEnabled)
     {
         OSAtomicTestAndClear(1, &_clearRenderer);
@@ -185,6 +253,63 @@
     OSAtomicTestAndSet(1, &_clearRenderer);
 }
 
+- (BOOL)jitterBufferEnabled {
+    return _jitterBuffer != NULL;
+}
+
+- (void)setJitterBufferEnabled:(BOOL)jitterBufferEnabled {
+    [_frameLock lock];
+    if (jitterBufferEnabled && !_jitterBuffer) {
+        otk_jitter_buffer_config config;
+        // The default configuration takes frame timestamps in microseconds.
+        otk_jitter_buffer_config_default(&config);
+        config.release = jitter_buffer_release_frame;
+        _jitterBuffer = otk_jitter_buffer_new(&config);
+    } else if (!jitterBufferEnabled && _jitterBuffer) {
+        otk_jitter_buffer_delete(_jitterBuffer);
+        _jitterBuffer = NULL;
+    }
+    [_frameLock unlock];
+}
+
+- (otk_jitter_buffer_stats)jitterBufferStats {
+    otk_jitter_buffer_stats stats = {0};
+    [_frameLock lock];
+    otk_jitter_buffer_get_stats(_jitterBuffer, &stats);
+    [_frameLock unlock];
+    return stats;
+}
+
+- (BOOL)downscaleOnIntake {
+    return _scaler != NULL;
+}
+
+- (void)setDownscaleOnIntake:(BOOL)downscaleOnIntake {
+    [_frameLock lock];
+    if (downscaleOnIntake && !_scaler) {
+        _scaler = otk_frame_scaler_new(kScaledFramePoolSize);
+    } else if (!downscaleOnIntake && _scaler) {
+        // Frames still queued return their buffers when they are deleted.
+        otk_frame_scaler_delete(_scaler);
+        _scaler = NULL;
+    }
+    [_frameLock unlock];
+}
+
+- (otk_frame_scaler_stats)downscaleStats {
+    otk_frame_scaler_stats stats = {0};
+    [_frameLock lock];
+    otk_frame_scaler_get_stats(_scaler, &stats);
+    [_frameLock unlock];
+    return stats;
+}
+
+- (otk_frame_intake_stats)intakeStats {
+    otk_frame_intake_stats stats = {0};
+    otk_frame_intake_get_stats(_intake, &stats);
+    return stats;
+}
+
 #pragma mark - UIView
 
 - (void)layoutSubviews {
@@ -196,6 +321,81 @@
         _viewWidth = _mtkView.frame.size.width;
         _viewHeight = _mtkView.frame.size.height;
     }
+    [self setHiddenReason:OTK_VIEW_ZERO_SIZE
+                   hidden:self.bounds.size.width < 1 || self.bounds.size.height < 1];
+    [self notifyViewSize];
+}
+
+// NSView has no layoutSubviews, so forward size changes to it.
+- (void)setFrameSize:(NSSize)newSize {
+    [super setFrameSize:newSize];
+    if (_mtkView) {
+        [self layoutSubviews];
+    }
+}
+
+- (void)viewDidMoveToWindow {
+    [super viewDidMoveToWindow];
+    NSNotificationCenter *notificationCenter = [NSNotificationCenter defaultCenter];
+    if (_observedWindow) {
+        [notificationCenter removeObserver:self
+                                      name:NSWindowDidChangeOcclusionStateNotification
+                                    object:_observedWindow];
+        [notificationCenter removeObserver:self
+                                      name:NSWindowDidMiniaturizeNotification
+                                    object:_observedWindow];
+        [notificationCenter removeObserver:self
+                                      name:NSWindowDidDeminiaturizeNotification
+                                    object:_observedWindow];
+    }
+    _observedWindow = self.window;
+    if (_observedWindow) {
+        [notificationCenter addObserver:self
+                               selector:@selector(windowOcclusionDidChange:)
+                                   name:NSWindowDidChangeOcclusionStateNotification
+                                 object:_observedWindow];
+        [notificationCenter addObserver:self
+                               selector:@selector(windowDidMiniaturize:)
+                                   name:NSWindowDidMiniaturizeNotification
+                                 object:_observedWindow];
+        [notificationCenter addObserver:self
+                               selector:@selector(windowDidDeminiaturize:)
+                                   name:NSWindowDidDeminiaturizeNotification
+                                 object:_observedWindow];
+        [self windowOcclusionDidChange:nil];
+        [self setHiddenReason:OTK_VIEW_MINIMIZED hidden:_observedWindow.miniaturized];
+    } else {
+        // Not in a window, so nothing of it can be seen.
+        [self setHiddenReason:OTK_VIEW_OCCLUDED hidden:YES];
+    }
+    // The backing scale is only known once in a window.
+    [self notifyViewSize];
+}
+
+- (void)viewDidHide {
+    [super viewDidHide];
+    [self setHiddenReason:OTK_VIEW_HIDDEN hidden:YES];
+}
+
+- (void)viewDidUnhide {
+    [super viewDidUnhide];
+    [self setHiddenReason:OTK_VIEW_HIDDEN hidden:NO];
+}
+
+- (void)viewDidChangeBackingProperties {
+    [super viewDidChangeBackingProperties];
+    [self notifyViewSize];
+}
+
+- (void)notifyViewSize {
+    CGSize size = [self convertSizeToBacking:self.bounds.size];
+    @synchronized (self) {
+        _pixelWidth = size.width;
+        _pixelHeight = size.height;
+    }
+    if ([_delegate respondsToSelector:@selector(renderer:didChangeViewSize:)]) {
+        [_delegate renderer:self didChangeViewSize:size];
+    }
 }
 
 - (void)getVideoViewSize:(int *)width height:(int *)height {
@@ -209,11 +409,31 @@
 
 - (void)renderVideoFrame:(otc_video_frame*)frame {
     assert(OTC_VIDEO_FRAME_FORMAT_YUV420P == otc_video_frame_get_format(frame));
+    // Decide before copying: a hidden view does not need the frame.
+    uint64_t frameBytes = (uint64_t)otc_video_frame_get_width(frame) *
+        otc_video_frame_get_height(frame) * 3 / 2;
+    if (otk_frame_intake_on_frame(_intake, frameBytes, otk_frame_intake_now_us()) ==
+        OTK_FRAME_INTAKE_SKIP) {
+        if ([_delegate respondsToSelector:@selector(renderer:didReceiveFrame:)]) {
+            [_delegate renderer:self didReceiveFrame:frame];
+        }
+        return;
+    }
     [_frameLock lock];
-    if(_videoFrame)
-        otc_video_frame_delete(_videoFrame);
-    _videoFrame = nil;
-    _videoFrame = otc_video_frame_copy(frame);
+    otc_video_frame *intakeFrame = [self downscaledFrame:frame];
+    if (intakeFrame == NULL) {
+        intakeFrame = otc_video_frame_copy(frame);
+    }
+    if (_jitterBuffer) {
+        otk_jitter_buffer_push(_jitterBuffer, intakeFrame,
+                               otc_video_frame_get_timestamp(frame),
+                               otk_jitter_buffer_now_us());
+    } else {
+        if(_videoFrame)
+            otc_video_frame_delete(_videoFrame);
+        _videoFrame = nil;
+        _videoFrame = intakeFrame;
+    }
     _lastFrameTime = otc_video_frame_get_timestamp(frame);
     [_frameLock unlock];
    
@@ -223,6 +443,54 @@
     
 }
 
+// Returns a pooled copy of the frame at the smallest power of two downscale
+// that still covers the view, or NULL when the frame is not much bigger than
+// the view. Called with the frame lock held.
+- (otc_video_frame *)downscaledFrame:(otc_video_frame *)frame {
+    if (!_scaler) {
+        return NULL;
+    }
+    int viewWidth, viewHeight;
+    @synchronized (self) {
+        viewWidth = _pixelWidth;
+        viewHeight = _pixelHeight;
+    }
+    int width = otc_video_frame_get_width(frame);
+    int height = otc_video_frame_get_height(frame);
+    int factor = otk_frame_scaler_select_factor(width, height, viewWidth, viewHeight);
+    if (factor == 1) {
+        return NULL;
+    }
+    const uint8_t *planes[3] = {
+        otc_video_frame_get_plane_binary_data(frame, OTC_VIDEO_FRAME_PLANE_Y),
+        otc_video_frame_get_plane_binary_data(frame, OTC_VIDEO_FRAME_PLANE_U),
+        otc_video_frame_get_plane_binary_data(frame, OTC_VIDEO_FRAME_PLANE_V)
+    };
+    int strides[3] = {
+        otc_video_frame_get_plane_stride(frame, OTC_VIDEO_FRAME_PLANE_Y),
+        otc_video_frame_get_plane_stride(frame, OTC_VIDEO_FRAME_PLANE_U),
+        otc_video_frame_get_plane_stride(frame, OTC_VIDEO_FRAME_PLANE_V)
+    };
+    otk_scaled_frame *scaled = otk_frame_scaler_scale_i420(_scaler, planes, strides,
+                                                           width, height, factor);
+    if (scaled == NULL) {
+        return NULL;
+    }
+    struct otc_video_frame_planar_memory_callbacks cb = {0};
+    cb.user_data = scaled;
+    cb.get_plane = scaled_frame_get_plane;
+    cb.get_plane_stride = scaled_frame_get_plane_stride;
+    cb.release = scaled_frame_release;
+    otc_video_frame *scaledFrame =
+        otc_video_frame_new_planar_memory_wrapper(OTC_VIDEO_FRAME_FORMAT_YUV420P,
+                                                  scaled->width,
+                                                  scaled->height,
+                                                  OTC_TRUE,
+                                                  &cb);
+    otc_video_frame_set_timestamp(scaledFrame, otc_video_frame_get_timestamp(frame));
+    return scaledFrame;
+}
+
 - (void)mtkView:(MTKView *)view drawableSizeWillChange:(CGSize)size {
 }
 
@@ -241,7 +509,9 @@
     }
     otc_video_frame * frame = nil;
     [_frameLock lock];
-    if (_videoFrame) {
+    if (_jitterBuffer) {
+        frame = otk_jitter_buffer_pop(_jitterBuffer, otk_jitter_buffer_now_us());
+    } else if (_videoFrame) {
         frame = _videoFrame;
         _videoFrame = nil;
     }
@@ -0,0 +1,154 @@
+//
+//  OTPreferredResolution.cpp
+//  Simple-Multiparty
+//
+//  Copyright (c) 2026 Vonage. All rights reserved.
+//
+
+#include "OTPreferredResolution.h"
+
+#include <algorithm>
+#include <chrono>
+
+struct otk_preferred_resolution {
+    otk_preferred_resolution_config config;
+
+    uint32_t view_width;
+    uint32_t view_height;
+    float max_frame_rate;
+    // Time of the last view change that mattered, -1 once it has been
+    // handled.
+    int64_t changed_ms;
+
+    int current_step;
+    float current_frame_rate;
+};
+
+void otk_preferred_resolution_config_default(otk_preferred_resolution_config *config) {
+    if (config == nullptr) {
+        return;
+    }
+    *config = {};
+    config->steps[0] = { 320, 180, 15 };
+    config->steps[1] = { 640, 360, 30 };
+    config->steps[2] = { 1280, 720, 30 };
+    config->steps[3] = { 1920, 1080, 30 };
+    config->step_count = 4;
+    config->debounce_ms = 500;
+    config->step_down_margin = 0.9f;
+}
+
+static bool fits(const otk_resolution_step &step,
+                 uint32_t width,
+                 uint32_t height,
+                 float margin) {
+    return width <= step.width * margin && height <= step.height * margin;
+}
+
+int otk_preferred_resolution_select_step(const otk_preferred_resolution_config *config,
+                                         uint32_t width,
+                                         uint32_t height,
+                                         int current_step) {
+    if (config == nullptr || config->step_count == 0) {
+        return -1;
+    }
+    int last = (int)std::min<uint32_t>(config->step_count,
+                                       OTK_PREFERRED_RESOLUTION_MAX_STEPS) - 1;
+    // Smallest step that covers the view; the largest if none does.
+    int step = last;
+    for (int i = 0; i <= last; i++) {
+        if (fits(config->steps[i], width, height, 1.0f)) {
+            step = i;
+            break;
+        }
+    }
+    if (current_step < 0 || current_step > last || step >= current_step) {
+        return step;
+    }
+    // Going down: only move as far as the margin allows.
+    while (current_step > step &&
+           fits(config->steps[current_step - 1], width, height,
+                config->step_down_margin)) {
+        current_step--;
+    }
+    return current_step;
+}
+
+otk_preferred_resolution *otk_preferred_resolution_new(const otk_preferred_resolution_config *config) {
+    otk_preferred_resolution *resolution = new otk_preferred_resolution();
+    if (config != nullptr) {
+        resolution->config = *config;
+    } else {
+        otk_preferred_resolution_config_default(&resolution->config);
+    }
+    resolution->view_width = 0;
+    resolution->view_height = 0;
+    resolution->max_frame_rate = 0;
+    resolution->changed_ms = -1;
+    resolution->current_step = -1;
+    resolution->current_frame_rate = 0;
+    return resolution;
+}
+
+void otk_preferred_resolution_delete(otk_preferred_resolution *resolution) {
+    delete resolution;
+}
+
+int64_t otk_preferred_resolution_now_ms(void) {
+    return (int64_t)std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+void otk_preferred_resolution_set_view(otk_preferred_resolution *resolution,
+                                       uint32_t width,
+                                       uint32_t height,
+                                       float max_frame_rate,
+                                       int64_t now_ms) {
+    if (resolution == nullptr) {
+        return;
+    }
+    if (width == resolution->view_width && height == resolution->view_height &&
+        max_frame_rate == resolution->max_frame_rate) {
+        return;
+    }
+    resolution->view_width = width;
+    resolution->view_height = height;
+    resolution->max_frame_rate = max_frame_rate;
+    resolution->changed_ms = now_ms;
+}
+
+int otk_preferred_resolution_poll(otk_preferred_resolution *resolution,
+                                  int64_t now_ms,
+                                  otk_preferred_video *preferred) {
+    if (resolution == nullptr || preferred == nullptr ||
+        resolution->changed_ms < 0 ||
+        now_ms - resolution->changed_ms < resolution->config.debounce_ms) {
+        return 0;
+    }
+    resolution->changed_ms = -1;
+    if (resolution->view_width == 0 || resolution->view_height == 0) {
+        return 0;
+    }
+    int step = otk_preferred_resolution_select_step(&resolution->config,
+                                                    resolution->view_width,
+                                                    resolution->view_height,
+                                                    resolution->current_step);
+    if (step < 0) {
+        return 0;
+    }
+    const otk_resolution_step &selected = resolution->config.steps[step];
+    float frame_rate = selected.frame_rate;
+    if (resolution->max_frame_rate > 0) {
+        frame_rate = std::min(frame_rate, resolution->max_frame_rate);
+    }
+    if (step == resolution->current_step &&
+        frame_rate == resolution->current_frame_rate) {
+        return 0;
+    }
+    resolution->current_step = step;
+    resolution->current_frame_rate = frame_rate;
+    preferred->width = selected.width;
+    preferred->height = selected.height;
+    preferred->frame_rate = frame_rate;
+    return 1;
+}
@@ -0,0 +1,101 @@
+//
+//  OTPreferredResolution.h
+//  Simple-Multiparty
+//
+//  Copyright (c) 2026 Vonage. All rights reserved.
+//
+
+#ifndef OTPreferredResolution_h
+#define OTPreferredResolution_h
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * Maps the size of the view a subscriber is drawn in to the preferred
+ * resolution and frame rate to request (see
+ * otc_subscriber_set_preferred_resolution and
+ * otc_subscriber_set_preferred_framerate).
+ *
+ * View sizes are bucketed to a ladder matching the simulcast layers so small
+ * resize steps do not produce new requests, and a new size only takes effect
+ * once it has been stable for the debounce period.
+ */
+typedef struct otk_preferred_resolution otk_preferred_resolution;
+
+#define OTK_PREFERRED_RESOLUTION_MAX_STEPS 8
+
+typedef struct otk_resolution_step {
+    uint32_t width;
+    uint32_t height;
+    float frame_rate;
+} otk_resolution_step;
+
+typedef struct otk_preferred_resolution_config {
+    /** Steps ordered from smallest to largest. */
+    otk_resolution_step steps[OTK_PREFERRED_RESOLUTION_MAX_STEPS];
+    uint32_t step_count;
+    /** How long the view size must be stable before a new request. */
+    int64_t debounce_ms;
+    /**
+     * A view only moves down a step once it is this fraction of the smaller
+     * step or less, so a view right at a boundary does not flip between two.
+     */
+    float step_down_margin;
+} otk_preferred_resolution_config;
+
+typedef struct otk_preferred_video {
+    uint32_t width;
+    uint32_t height;
+    float frame_rate;
+} otk_preferred_video;
+
+/**
+ * Fills config with a 180p/360p/720p/1080p ladder, 15 fps for the smallest
+ * step and 30 fps for the others, and a 500 ms debounce.
+ */
+void otk_preferred_resolution_config_default(otk_preferred_resolution_config *config);
+
+otk_preferred_resolution *otk_preferred_resolution_new(const otk_preferred_resolution_config *config);
+
+void otk_preferred_resolution_delete(otk_preferred_resolution *resolution);
+
+/** Monotonic clock in milliseconds, for the now_ms arguments below. */
+int64_t otk_preferred_resolution_now_ms(void);
+
+/**
+ * Reports the view size in pixels and the highest frame rate the view can
+ * show (for example the display refresh rate), or 0 for no limit.
+ */
+void otk_preferred_resolution_set_view(otk_preferred_resolution *resolution,
+                                       uint32_t width,
+                                       uint32_t height,
+                                       float max_frame_rate,
+                                       int64_t now_ms);
+
+/**
+ * Returns 1 and fills preferred when a new setting should be requested: the
+ * view has been stable for the debounce period and maps to a different step
+ * or frame rate than the last one returned. Returns 0 otherwise.
+ */
+int otk_preferred_resolution_poll(otk_preferred_resolution *resolution,
+                                  int64_t now_ms,
+                                  otk_preferred_video *preferred);
+
+/**
+ * Index of the ladder step for a view, given the currently selected step
+ * (-1 if none). Exposed for testing the bucketing on its own.
+ */
+int otk_preferred_resolution_select_step(const otk_preferred_resolution_config *config,
+                                         uint32_t width,
+                                         uint32_t height,
+                                         int current_step);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* OTPreferredResolution_h */
@@ -0,0 +1,263 @@
+//
+//  OTReconnectTracker.cpp
+//  Simple-Multiparty
+//
+//  Copyright (c) 2026 Vonage. All rights reserved.
+//
+
+#include "OTReconnectTracker.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <map>
+#include <mutex>
+#include <string>
+#include <vector>
+
+enum stream_state {
+    STREAM_ATTACHED,
+    // Dropped while reconnecting, window kept.
+    STREAM_KEPT,
+    // Attached, no frame rendered since the session reconnected.
+    STREAM_AWAITING_FRAME,
+};
+
+struct tracked_stream {
+    stream_state state;
+    int64_t dropped_ms;
+    int64_t awaiting_since_ms;
+};
+
+struct otk_reconnect_tracker {
+    std::mutex lock;
+    int64_t grace_ms;
+    enum otk_session_state state;
+    int64_t reconnect_started_ms;
+    int64_t reconnected_ms;
+    std::map<std::string, tracked_stream> streams;
+    // Streams in STREAM_AWAITING_FRAME, read without the lock on every frame.
+    std::atomic<uint32_t> awaiting;
+
+    otk_reconnect_stats stats;
+    int64_t total_reconnect_ms;
+    int64_t total_first_frame_ms;
+};
+
+otk_reconnect_tracker *otk_reconnect_tracker_new(int64_t grace_ms) {
+    otk_reconnect_tracker *tracker = new otk_reconnect_tracker();
+    tracker->grace_ms = grace_ms;
+    tracker->state = OTK_SESSION_DISCONNECTED;
+    tracker->reconnect_started_ms = 0;
+    tracker->reconnected_ms = 0;
+    tracker->awaiting.store(0);
+    tracker->stats = {};
+    tracker->total_reconnect_ms = 0;
+    tracker->total_first_frame_ms = 0;
+    return tracker;
+}
+
+void otk_reconnect_tracker_delete(otk_reconnect_tracker *tracker) {
+    delete tracker;
+}
+
+int64_t otk_reconnect_tracker_now_ms(void) {
+    return (int64_t)std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+enum otk_session_state otk_reconnect_tracker_state(otk_reconnect_tracker *tracker) {
+    if (tracker == nullptr) {
+        return OTK_SESSION_DISCONNECTED;
+    }
+    std::lock_guard<std::mutex> guard(tracker->lock);
+    return tracker->state;
+}
+
+void otk_reconnect_tracker_on_connected(otk_reconnect_tracker *tracker) {
+    if (tracker == nullptr) {
+        return;
+    }
+    std::lock_guard<std::mutex> guard(tracker->lock);
+    tracker->state = OTK_SESSION_CONNECTED;
+}
+
+void otk_reconnect_tracker_on_reconnecting(otk_reconnect_tracker *tracker, int64_t now_ms) {
+    if (tracker == nullptr) {
+        return;
+    }
+    std::lock_guard<std::mutex> guard(tracker->lock);
+    if (tracker->state == OTK_SESSION_RECONNECTING) {
+        return;
+    }
+    tracker->state = OTK_SESSION_RECONNECTING;
+    tracker->reconnect_started_ms = now_ms;
+}
+
+void otk_reconnect_tracker_on_reconnected(otk_reconnect_tracker *tracker, int64_t now_ms) {
+    if (tracker == nullptr) {
+        return;
+    }
+    std::lock_guard<std::mutex> guard(tracker->lock);
+    if (tracker->state != OTK_SESSION_RECONNECTING) {
+        tracker->state = OTK_SESSION_CONNECTED;
+        return;
+    }
+    tracker->state = OTK_SESSION_CONNECTED;
+    tracker->reconnected_ms = now_ms;
+    int64_t duration = now_ms - tracker->reconnect_started_ms;
+    tracker->stats.reconnections++;
+    tracker->stats.last_reconnect_ms = duration;
+    tracker->total_reconnect_ms += duration;
+    tracker->stats.average_reconnect_ms = tracker->total_reconnect_ms / tracker->stats.reconnections;
+    uint32_t awaiting = 0;
+    for (auto &entry : tracker->streams) {
+        tracked_stream &stream = entry.second;
+        if (stream.state != STREAM_KEPT) {
+            stream.state = STREAM_AWAITING_FRAME;
+            stream.awaiting_since_ms = now_ms;
+            awaiting++;
+        }
+    }
+    tracker->awaiting.store(awaiting, std::memory_order_release);
+}
+
+void otk_reconnect_tracker_on_disconnected(otk_reconnect_tracker *tracker,
+                                           otk_reconnect_release_cb release,
+                                           void *user_data) {
+    if (tracker == nullptr) {
+        return;
+    }
+    std::vector<std::string> kept;
+    {
+        std::lock_guard<std::mutex> guard(tracker->lock);
+        tracker->state = OTK_SESSION_DISCONNECTED;
+        for (const auto &entry : tracker->streams) {
+            if (entry.second.state == STREAM_KEPT) {
+                kept.push_back(entry.first);
+            }
+        }
+        tracker->stats.streams_released += (uint32_t)kept.size();
+        tracker->streams.clear();
+        tracker->awaiting.store(0, std::memory_order_release);
+    }
+    if (release != nullptr) {
+        for (const std::string &stream_id : kept) {
+            release(stream_id.c_str(), user_data);
+        }
+    }
+}
+
+enum otk_stream_attach_action otk_reconnect_tracker_on_stream_received(otk_reconnect_tracker *tracker,
+                                                                       const char *stream_id,
+                                                                       int64_t now_ms) {
+    if (tracker == nullptr || stream_id == nullptr) {
+        return OTK_STREAM_NEW;
+    }
+    std::lock_guard<std::mutex> guard(tracker->lock);
+    auto found = tracker->streams.find(stream_id);
+    if (found != tracker->streams.end() && found->second.state == STREAM_KEPT) {
+        // Measured from reconnected, or from now if it came back while the
+        // session was still reconnecting.
+        tracked_stream &stream = found->second;
+        stream.state = STREAM_AWAITING_FRAME;
+        stream.awaiting_since_ms = tracker->state == OTK_SESSION_RECONNECTING ?
+            now_ms : std::max(tracker->reconnected_ms, stream.dropped_ms);
+        tracker->awaiting.fetch_add(1, std::memory_order_release);
+        tracker->stats.streams_reattached++;
+        return OTK_STREAM_REATTACH;
+    }
+    if (found != tracker->streams.end() && found->second.state == STREAM_AWAITING_FRAME) {
+        tracker->awaiting.fetch_sub(1, std::memory_order_release);
+    }
+    tracker->streams[stream_id] = { STREAM_ATTACHED, 0, 0 };
+    return OTK_STREAM_NEW;
+}
+
+enum otk_stream_drop_action otk_reconnect_tracker_on_stream_dropped(otk_reconnect_tracker *tracker,
+                                                                    const char *stream_id,
+                                                                    int64_t now_ms) {
+    if (tracker == nullptr || stream_id == nullptr) {
+        return OTK_STREAM_RELEASE;
+    }
+    std::lock_guard<std::mutex> guard(tracker->lock);
+    auto found = tracker->streams.find(stream_id);
+    if (found == tracker->streams.end()) {
+        return OTK_STREAM_RELEASE;
+    }
+    if (found->second.state == STREAM_AWAITING_FRAME) {
+        tracker->awaiting.fetch_sub(1, std::memory_order_release);
+    }
+    if (tracker->state != OTK_SESSION_RECONNECTING) {
+        tracker->streams.erase(found);
+        return OTK_STREAM_RELEASE;
+    }
+    found->second.state = STREAM_KEPT;
+    found->second.dropped_ms = now_ms;
+    return OTK_STREAM_KEEP;
+}
+
+void otk_reconnect_tracker_on_frame(otk_reconnect_tracker *tracker,
+                                    const char *stream_id,
+                                    int64_t now_ms) {
+    if (tracker == nullptr || stream_id == nullptr ||
+        tracker->awaiting.load(std::memory_order_acquire) == 0) {
+        return;
+    }
+    std::lock_guard<std::mutex> guard(tracker->lock);
+    auto found = tracker->streams.find(stream_id);
+    if (found == tracker->streams.end() || found->second.state != STREAM_AWAITING_FRAME) {
+        return;
+    }
+    tracked_stream &stream = found->second;
+    stream.state = STREAM_ATTACHED;
+    tracker->awaiting.fetch_sub(1, std::memory_order_release);
+    int64_t first_frame_ms = now_ms - stream.awaiting_since_ms;
+    tracker->stats.first_frames++;
+    tracker->stats.last_first_frame_ms = first_frame_ms;
+    tracker->total_first_frame_ms += first_frame_ms;
+    tracker->stats.average_first_frame_ms = tracker->total_first_frame_ms / tracker->stats.first_frames;
+}
+
+size_t otk_reconnect_tracker_release_expired(otk_reconnect_tracker *tracker,
+                                             int64_t now_ms,
+                                             otk_reconnect_release_cb release,
+                                             void *user_data) {
+    if (tracker == nullptr) {
+        return 0;
+    }
+    std::vector<std::string> expired;
+    {
+        std::lock_guard<std::mutex> guard(tracker->lock);
+        if (tracker->state == OTK_SESSION_RECONNECTING) {
+            // Nothing can come back before the session does.
+            return 0;
+        }
+        for (auto it = tracker->streams.begin(); it != tracker->streams.end();) {
+            const tracked_stream &stream = it->second;
+            int64_t since = std::max(stream.dropped_ms, tracker->reconnected_ms);
+            if (stream.state == STREAM_KEPT && now_ms - since >= tracker->grace_ms) {
+                expired.push_back(it->first);
+                it = tracker->streams.erase(it);
+            } else {
+                ++it;
+            }
+        }
+        tracker->stats.streams_released += (uint32_t)expired.size();
+    }
+    if (release != nullptr) {
+        for (const std::string &stream_id : expired) {
+            release(stream_id.c_str(), user_data);
+        }
+    }
+    return expired.size();
+}
+
+void otk_reconnect_tracker_get_stats(otk_reconnect_tracker *tracker,
+                                     otk_reconnect_stats *stats) {
+    if (tracker == nullptr || stats == nullptr) {
+        return;
+    }
+    std::lock_guard<std::mutex> guard(tracker->lock);
+    *stats = tracker->stats;
+}
@@ -0,0 +1,119 @@
+//
+//  OTReconnectTracker.h
+//  Simple-Multiparty
+//
+//  Copyright (c) 2026 Vonage. All rights reserved.
+//
+
+#ifndef OTReconnectTracker_h
+#define OTReconnectTracker_h
+
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * Follows a session through reconnections so subscriber windows and their
+ * renderers survive a network blip instead of being rebuilt.
+ *
+ * A stream dropped while the session is reconnecting is kept rather than
+ * released. If the same stream comes back it is reattached to what was
+ * kept. If it is still gone grace_ms after the session reconnected, it is
+ * released. After a reconnection it also measures how long each stream
+ * takes to render its first frame again.
+ *
+ * Independent of the SDK: feed it the session events with their times.
+ * Safe to call from any thread.
+ */
+typedef struct otk_reconnect_tracker otk_reconnect_tracker;
+
+enum otk_session_state {
+    OTK_SESSION_DISCONNECTED = 0,
+    OTK_SESSION_CONNECTED = 1,
+    OTK_SESSION_RECONNECTING = 2,
+};
+
+enum otk_stream_drop_action {
+    /** Tear the stream's window down as usual. */
+    OTK_STREAM_RELEASE = 0,
+    /** Keep the window and renderer; the stream may come back. */
+    OTK_STREAM_KEEP = 1,
+};
+
+enum otk_stream_attach_action {
+    /** A stream that was not kept; create its window. */
+    OTK_STREAM_NEW = 0,
+    /** A kept stream came back; reuse its window. */
+    OTK_STREAM_REATTACH = 1,
+};
+
+typedef struct otk_reconnect_stats {
+    uint32_t reconnections;
+    /** Time from reconnection start to reconnected, for the last one. */
+    int64_t last_reconnect_ms;
+    int64_t average_reconnect_ms;
+    uint32_t streams_reattached;
+    uint32_t streams_released;
+    /** Time from reconnected to the first frame of each stream afterwards. */
+    int64_t last_first_frame_ms;
+    int64_t average_first_frame_ms;
+    uint32_t first_frames;
+} otk_reconnect_stats;
+
+/** Called for each kept stream that is released. */
+typedef void (*otk_reconnect_release_cb)(const char *stream_id, void *user_data);
+
+otk_reconnect_tracker *otk_reconnect_tracker_new(int64_t grace_ms);
+
+void otk_reconnect_tracker_delete(otk_reconnect_tracker *tracker);
+
+/** Monotonic clock in milliseconds, for the now_ms arguments below. */
+int64_t otk_reconnect_tracker_now_ms(void);
+
+enum otk_session_state otk_reconnect_tracker_state(otk_reconnect_tracker *tracker);
+
+void otk_reconnect_tracker_on_connected(otk_reconnect_tracker *tracker);
+
+void otk_reconnect_tracker_on_reconnecting(otk_reconnect_tracker *tracker, int64_t now_ms);
+
+/** Every stream still attached is expected to render a first frame again. */
+void otk_reconnect_tracker_on_reconnected(otk_reconnect_tracker *tracker, int64_t now_ms);
+
+/** Forgets every stream; kept ones are passed to release. */
+void otk_reconnect_tracker_on_disconnected(otk_reconnect_tracker *tracker,
+                                           otk_reconnect_release_cb release,
+                                           void *user_data);
+
+enum otk_stream_attach_action otk_reconnect_tracker_on_stream_received(otk_reconnect_tracker *tracker,
+                                                                       const char *stream_id,
+                                                                       int64_t now_ms);
+
+enum otk_stream_drop_action otk_reconnect_tracker_on_stream_dropped(otk_reconnect_tracker *tracker,
+                                                                    const char *stream_id,
+                                                                    int64_t now_ms);
+
+/**
+ * Called for every rendered frame. Cheap unless the stream is waiting for
+ * its first frame after a reconnection.
+ */
+void otk_reconnect_tracker_on_frame(otk_reconnect_tracker *tracker,
+                                    const char *stream_id,
+                                    int64_t now_ms);
+
+/** Releases kept streams whose grace period is over. Returns how many. */
+size_t otk_reconnect_tracker_release_expired(otk_reconnect_tracker *tracker,
+                                             int64_t now_ms,
+                                             otk_reconnect_release_cb release,
+                                             void *user_data);
+
+void otk_reconnect_tracker_get_stats(otk_reconnect_tracker *tracker,
+                                     otk_reconnect_stats *stats);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* OTReconnectTracker_h */
@@ -0,0 +1,76 @@
+//
+//  OTRuntime.cpp
+//  Simple-Multiparty
+//
+//  Copyright (c) 2026 Vonage. All rights reserved.
+//
+
+#include "OTRuntime.h"
+
+#include <chrono>
+#include <mutex>
+
+namespace {
+
+struct runtime {
+    std::mutex lock;
+    otk_runtime_api api = {};
+    otk_runtime_stats stats = {};
+};
+
+} // namespace
+
+// Never destroyed, so references dropped during static destruction are safe.
+static runtime &shared_runtime() {
+    static runtime *instance = new runtime();
+    return *instance;
+}
+
+int otk_runtime_acquire(const otk_runtime_api *api) {
+    runtime &shared = shared_runtime();
+    std::lock_guard<std::mutex> guard(shared.lock);
+    if (shared.stats.references > 0) {
+        shared.stats.references++;
+        return 1;
+    }
+    if (api == nullptr || api->init == nullptr) {
+        shared.stats.init_failures++;
+        return 0;
+    }
+    auto start = std::chrono::steady_clock::now();
+    if (!api->init(api->context)) {
+        shared.stats.init_failures++;
+        return 0;
+    }
+    shared.stats.last_init_us = std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::steady_clock::now() - start).count();
+    shared.api = *api;
+    shared.stats.inits++;
+    shared.stats.references = 1;
+    return 1;
+}
+
+void otk_runtime_release(void) {
+    runtime &shared = shared_runtime();
+    std::lock_guard<std::mutex> guard(shared.lock);
+    if (shared.stats.references <= 0) {
+        return;
+    }
+    if (--shared.stats.references > 0) {
+        return;
+    }
+    if (shared.api.destroy != nullptr) {
+        shared.api.destroy(shared.api.context);
+    }
+    shared.api = {};
+    shared.stats.destroys++;
+}
+
+void otk_runtime_get_stats(otk_runtime_stats *stats) {
+    if (stats == nullptr) {
+        return;
+    }
+    runtime &shared = shared_runtime();
+    std::lock_guard<std::mutex> guard(shared.lock);
+    *stats = shared.stats;
+}
@@ -0,0 +1,716 @@
+//
+//  OTSessionTrace.cpp
+//  Simple-Multiparty
+//
+//  Copyright (c) 2026 Vonage. All rights reserved.
+//
+
+#include "OTSessionTrace.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdio>
+#include <cstring>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+static const char kMagic[8] = {'O', 'T', 'K', 'T', 'R', 'A', 'C', 'E'};
+static const uint32_t kVersion = 1;
+static const size_t kHeaderSize = 16;
+static const uint32_t kSubsample = 4;
+// Past this much waiting to be written, frames are recorded as hashes.
+static const size_t kMaxPendingBytes = 64 << 20;
+// Written as soon as this much is pending, otherwise every flush interval.
+static const size_t kFlushBytes = 1 << 20;
+static const auto kFlushInterval = std::chrono::milliseconds(200);
+// Bounds on what a replayed record may ask for.
+static const uint32_t kMaxDimension = 16384;
+static const uint64_t kMaxStreamIdLength = 256;
+static const uint32_t kMaxAudioSamples = 1 << 20;
+static const int64_t kLateUs = 1000;
+
+enum record_type : uint8_t {
+    RECORD_STREAM_NAME = 1,
+    RECORD_SESSION = 2,
+    RECORD_STREAM_RECEIVED = 3,
+    RECORD_STREAM_DROPPED = 4,
+    RECORD_FRAME = 5,
+    RECORD_AUDIO_READ = 6,
+};
+
+typedef std::chrono::steady_clock trace_clock;
+
+static int64_t elapsed_us(trace_clock::time_point since) {
+    return std::chrono::duration_cast<std::chrono::microseconds>(trace_clock::now() - since).count();
+}
+
+static uint32_t chroma_size(uint32_t size) {
+    return (size + 1) / 2;
+}
+
+static uint32_t subsampled_size(uint32_t size) {
+    return (size + kSubsample - 1) / kSubsample;
+}
+
+static uint64_t mix(uint64_t hash, uint64_t value) {
+    hash ^= value;
+    hash *= 0x9e3779b97f4a7c15ull;
+    return hash ^ (hash >> 29);
+}
+
+// Rows are hashed separately so padding is skipped, 32 bytes at a time in
+// four independent lanes so the multiplies overlap.
+static uint64_t hash_plane(uint64_t hash, const uint8_t *plane, int stride,
+                           uint32_t width, uint32_t height) {
+    for (uint32_t y = 0; y < height; y++) {
+        const uint8_t *row = plane + (ptrdiff_t)y * stride;
+        uint32_t x = 0;
+        uint64_t lanes[4] = {hash, hash + 1, hash + 2, hash + 3};
+        for (; x + 32 <= width; x += 32) {
+            for (int lane = 0; lane < 4; lane++) {
+                uint64_t word;
+                std::memcpy(&word, row + x + 8 * lane, 8);
+                lanes[lane] = mix(lanes[lane], word);
+            }
+        }
+        hash = mix(mix(lanes[0], lanes[1]), mix(lanes[2], lanes[3]));
+        for (; x + 8 <= width; x += 8) {
+            uint64_t word;
+            std::memcpy(&word, row + x, 8);
+            hash = mix(hash, word);
+        }
+        uint64_t tail = 0;
+        for (uint32_t shift = 0; x < width; x++, shift += 8) {
+            tail |= (uint64_t)row[x] << shift;
+        }
+        hash = mix(hash, tail ^ ((uint64_t)width << 56));
+    }
+    return hash;
+}
+
+uint64_t otk_trace_hash_i420(const uint8_t *const planes[3], const int strides[3],
+                             uint32_t width, uint32_t height) {
+    if (planes == nullptr || strides == nullptr) {
+        return 0;
+    }
+    uint64_t hash = mix(0xcbf29ce484222325ull, ((uint64_t)width << 32) | height);
+    hash = hash_plane(hash, planes[0], strides[0], width, height);
+    hash = hash_plane(hash, planes[1], strides[1], chroma_size(width), chroma_size(height));
+    hash = hash_plane(hash, planes[2], strides[2], chroma_size(width), chroma_size(height));
+    return hash;
+}
+
+struct otk_trace_recorder {
+    FILE *file = nullptr;
+    otk_trace_frames frames = OTK_TRACE_FRAMES_NONE;
+
+    std::mutex lock;
+    std::condition_variable wake;
+    bool stopping = false;
+    std::vector<uint8_t> pending;
+    trace_clock::time_point start;
+    int64_t last_us = 0;
+    std::unordered_map<std::string, uint64_t> stream_indexes;
+    otk_trace_recorder_stats stats = {};
+
+    std::thread writer;
+};
+
+static void put_u8(std::vector<uint8_t> &out, uint8_t value) {
+    out.push_back(value);
+}
+
+static void put_varint(std::vector<uint8_t> &out, uint64_t value) {
+    while (value >= 0x80) {
+        out.push_back((uint8_t)(value | 0x80));
+        value >>= 7;
+    }
+    out.push_back((uint8_t)value);
+}
+
+static void put_signed(std::vector<uint8_t> &out, int64_t value) {
+    put_varint(out, ((uint64_t)value << 1) ^ (uint64_t)(value >> 63));
+}
+
+static void put_u32(std::vector<uint8_t> &out, uint32_t value) {
+    for (int i = 0; i < 4; i++) {
+        out.push_back((uint8_t)(value >> (8 * i)));
+    }
+}
+
+static void put_u64(std::vector<uint8_t> &out, uint64_t value) {
+    for (int i = 0; i < 8; i++) {
+        out.push_back((uint8_t)(value >> (8 * i)));
+    }
+}
+
+// Starts a record; called with the lock held so times never go backwards.
+static void begin_record(otk_trace_recorder *recorder, record_type type) {
+    int64_t now_us = elapsed_us(recorder->start);
+    put_u8(recorder->pending, type);
+    put_varint(recorder->pending, (uint64_t)std::max<int64_t>(0, now_us - recorder->last_us));
+    recorder->last_us = std::max(recorder->last_us, now_us);
+    recorder->stats.events++;
+}
+
+static uint64_t stream_index(otk_trace_recorder *recorder, const char *stream_id) {
+    std::string id(stream_id, strnlen(stream_id, kMaxStreamIdLength));
+    auto found = recorder->stream_indexes.find(id);
+    if (found != recorder->stream_indexes.end()) {
+        return found->second;
+    }
+    uint64_t index = recorder->stream_indexes.size();
+    recorder->stream_indexes.emplace(id, index);
+    begin_record(recorder, RECORD_STREAM_NAME);
+    put_varint(recorder->pending, index);
+    put_varint(recorder->pending, id.size());
+    recorder->pending.insert(recorder->pending.end(), id.begin(), id.end());
+    return index;
+}
+
+static void finish_record(otk_trace_recorder *recorder) {
+    if (recorder->pending.size() >= kFlushBytes) {
+        recorder->wake.notify_one();
+    }
+}
+
+static void write_loop(otk_trace_recorder *recorder) {
+    std::vector<uint8_t> writing;
+    std::unique_lock<std::mutex> guard(recorder->lock);
+    while (true) {
+        recorder->wake.wait_for(guard, kFlushInterval, [recorder] {
+            return recorder->stopping || recorder->pending.size() >= kFlushBytes;
+        });
+        bool stopping = recorder->stopping;
+        writing.clear();
+        writing.swap(recorder->pending);
+        bool failed = recorder->stats.write_failed;
+        guard.unlock();
+        size_t written = 0;
+        if (!writing.empty() && !failed) {
+            written = std::fwrite(writing.data(), 1, writing.size(), recorder->file);
+            if (written == writing.size()) {
+                failed = std::fflush(recorder->file) != 0;
+            } else {
+                failed = true;
+            }
+        }
+        guard.lock();
+        recorder->stats.bytes_written += written;
+        recorder->stats.write_failed = failed ? 1 : 0;
+        if (stopping) {
+            return;
+        }
+    }
+}
+
+otk_trace_recorder *otk_trace_recorder_new(const char *path, otk_trace_frames frames) {
+    if (path == nullptr) {
+        return nullptr;
+    }
+    FILE *file = std::fopen(path, "wb");
+    if (file == nullptr) {
+        return nullptr;
+    }
+    otk_trace_recorder *recorder = new otk_trace_recorder();
+    recorder->file = file;
+    recorder->frames = std::clamp(frames, OTK_TRACE_FRAMES_NONE, OTK_TRACE_FRAMES_FULL);
+    for (char c : kMagic) {
+        put_u8(recorder->pending, (uint8_t)c);
+    }
+    put_u32(recorder->pending, kVersion);
+    put_u32(recorder->pending, (uint32_t)recorder->frames);
+    recorder->start = trace_clock::now();
+    recorder->writer = std::thread(write_loop, recorder);
+    return recorder;
+}
+
+void otk_trace_recorder_delete(otk_trace_recorder *recorder) {
+    if (recorder == nullptr) {
+        return;
+    }
+    {
+        std::lock_guard<std::mutex> guard(recorder->lock);
+        recorder->stopping = true;
+    }
+    recorder->wake.notify_one();
+    recorder->writer.join();
+    std::fclose(recorder->file);
+    delete recorder;
+}
+
+void otk_trace_record_session(otk_trace_recorder *recorder, otk_trace_session_event event) {
+    if (recorder == nullptr) {
+        return;
+    }
+    std::lock_guard<std::mutex> guard(recorder->lock);
+    begin_record(recorder, RECORD_SESSION);
+    put_u8(recorder->pending, (uint8_t)event);
+    finish_record(recorder);
+}
+
+static void record_stream(otk_trace_recorder *recorder, record_type type, const char *stream_id) {
+    if (recorder == nullptr || stream_id == nullptr) {
+        return;
+    }
+    std::lock_guard<std::mutex> guard(recorder->lock);
+    uint64_t index = stream_index(recorder, stream_id);
+    begin_record(recorder, type);
+    put_varint(recorder->pending, index);
+    finish_record(recorder);
+}
+
+void otk_trace_record_stream_received(otk_trace_recorder *recorder, const char *stream_id) {
+    record_stream(recorder, RECORD_STREAM_RECEIVED, stream_id);
+}
+
+void otk_trace_record_stream_dropped(otk_trace_recorder *recorder, const char *stream_id) {
+    record_stream(recorder, RECORD_STREAM_DROPPED, stream_id);
+}
+
+static void put_subsampled(std::vector<uint8_t> &out, const uint8_t *plane, int stride,
+                           uint32_t width, uint32_t height) {
+    for (uint32_t y = 0; y < height; y += kSubsample) {
+        const uint8_t *row = plane + (ptrdiff_t)y * stride;
+        for (uint32_t x = 0; x < width; x += kSubsample) {
+            out.push_back(row[x]);
+        }
+    }
+}
+
+static void put_plane(std::vector<uint8_t> &out, const uint8_t *plane, int stride,
+                      uint32_t width, uint32_t height) {
+    for (uint32_t y = 0; y < height; y++) {
+        const uint8_t *row = plane + (ptrdiff_t)y * stride;
+        out.insert(out.end(), row, row + width);
+    }
+}
+
+void otk_trace_record_frame(otk_trace_recorder *recorder, const char *stream_id,
+                            int64_t timestamp, uint32_t width, uint32_t height,
+                            const uint8_t *const planes[3], const int strides[3]) {
+    if (recorder == nullptr || stream_id == nullptr ||
+        width == 0 || height == 0 || width > kMaxDimension || height > kMaxDimension) {
+        return;
+    }
+    otk_trace_frames content = recorder->frames;
+    if (planes == nullptr || strides == nullptr ||
+        planes[0] == nullptr || planes[1] == nullptr || planes[2] == nullptr) {
+        content = OTK_TRACE_FRAMES_NONE;
+    }
+    // Hashed outside the lock; it is the expensive part.
+    uint64_t hash = content >= OTK_TRACE_FRAMES_HASH ? otk_trace_hash_i420(planes, strides, width, height) : 0;
+
+    std::lock_guard<std::mutex> guard(recorder->lock);
+    if (content > OTK_TRACE_FRAMES_HASH && recorder->pending.size() > kMaxPendingBytes) {
+        content = OTK_TRACE_FRAMES_HASH;
+        recorder->stats.payloads_dropped++;
+    }
+    uint64_t index = stream_index(recorder, stream_id);
+    begin_record(recorder, RECORD_FRAME);
+    std::vector<uint8_t> &out = recorder->pending;
+    put_varint(out, index);
+    put_signed(out, timestamp);
+    put_varint(out, width);
+    put_varint(out, height);
+    put_u8(out, (uint8_t)content);
+    if (content >= OTK_TRACE_FRAMES_HASH) {
+        put_u64(out, hash);
+    }
+    uint32_t chroma_width = chroma_size(width);
+    uint32_t chroma_height = chroma_size(height);
+    if (content == OTK_TRACE_FRAMES_SUBSAMPLED) {
+        put_subsampled(out, planes[0], strides[0], width, height);
+        put_subsampled(out, planes[1], strides[1], chroma_width, chroma_height);
+        put_subsampled(out, planes[2], strides[2], chroma_width, chroma_height);
+    } else if (content == OTK_TRACE_FRAMES_FULL) {
+        put_plane(out, planes[0], strides[0], width, height);
+        put_plane(out, planes[1], strides[1], chroma_width, chroma_height);
+        put_plane(out, planes[2], strides[2], chroma_width, chroma_height);
+    }
+    finish_record(recorder);
+}
+
+void otk_trace_record_audio_read(otk_trace_recorder *recorder, uint32_t requested,
+                                 uint32_t returned, const int16_t *samples) {
+    if (recorder == nullptr) {
+        return;
+    }
+    returned = std::min(returned, kMaxAudioSamples);
+    std::lock_guard<std::mutex> guard(recorder->lock);
+    begin_record(recorder, RECORD_AUDIO_READ);
+    std::vector<uint8_t> &out = recorder->pending;
+    put_varint(out, requested);
+    put_varint(out, returned);
+    put_u8(out, samples != nullptr ? 1 : 0);
+    if (samples != nullptr) {
+        for (uint32_t i = 0; i < returned; i++) {
+            out.push_back((uint8_t)samples[i]);
+            out.push_back((uint8_t)((uint16_t)samples[i] >> 8));
+        }
+    }
+    finish_record(recorder);
+}
+
+void otk_trace_recorder_get_stats(otk_trace_recorder *recorder, otk_trace_recorder_stats *stats) {
+    if (recorder == nullptr || stats == nullptr) {
+        return;
+    }
+    std::lock_guard<std::mutex> guard(recorder->lock);
+    *stats = recorder->stats;
+}
+
+namespace {
+
+// Buffered reader that fails once instead of at every field.
+struct trace_reader {
+    FILE *file = nullptr;
+    std::vector<uint8_t> buffer;
+    size_t position = 0;
+    size_t length = 0;
+    bool failed = false;
+
+    bool fill() {
+        if (position < length) {
+            return true;
+        }
+        length = std::fread(buffer.data(), 1, buffer.size(), file);
+        position = 0;
+        return length > 0;
+    }
+
+    // False at the end of the file, which is only fine between records.
+    bool at_end() {
+        return !fill();
+    }
+
+    uint8_t u8() {
+        if (failed || !fill()) {
+            failed = true;
+            return 0;
+        }
+        return buffer[position++];
+    }
+
+    uint64_t varint() {
+        uint64_t value = 0;
+        for (int shift = 0; shift < 64; shift += 7) {
+            uint8_t byte = u8();
+            value |= (uint64_t)(byte & 0x7f) << shift;
+            if (!(byte & 0x80)) {
+                return value;
+            }
+        }
+        failed = true;
+        return 0;
+    }
+
+    int64_t signed_varint() {
+        uint64_t value = varint();
+        return (int64_t)(value >> 1) ^ -(int64_t)(value & 1);
+    }
+
+    uint64_t u64() {
+        uint64_t value = 0;
+        for (int i = 0; i < 8; i++) {
+            value |= (uint64_t)u8() << (8 * i);
+        }
+        return value;
+    }
+
+    void bytes(uint8_t *out, size_t count) {
+        while (count > 0 && !failed) {
+            if (!fill()) {
+                failed = true;
+                return;
+            }
+            size_t chunk = std::min(count, length - position);
+            std::memcpy(out, buffer.data() + position, chunk);
+            position += chunk;
+            out += chunk;
+            count -= chunk;
+        }
+    }
+};
+
+} // namespace
+
+struct otk_trace_replay {
+    trace_reader reader;
+    otk_trace_frames frames = OTK_TRACE_FRAMES_NONE;
+    std::atomic<bool> stop_requested{false};
+
+    std::vector<std::string> stream_ids;
+    // Replayed frame planes and recorded samples, grown as needed.
+    std::vector<uint8_t> planes[3];
+    std::vector<uint8_t> recorded;
+    std::vector<int16_t> samples;
+
+    std::mutex stats_lock;
+    otk_trace_replay_stats stats = {};
+};
+
+otk_trace_replay *otk_trace_replay_open(const char *path) {
+    if (path == nullptr) {
+        return nullptr;
+    }
+    FILE *file = std::fopen(path, "rb");
+    if (file == nullptr) {
+        return nullptr;
+    }
+    uint8_t header[kHeaderSize];
+    if (std::fread(header, 1, sizeof(header), file) != sizeof(header) ||
+        std::memcmp(header, kMagic, sizeof(kMagic)) != 0) {
+        std::fclose(file);
+        return nullptr;
+    }
+    uint32_t version = 0;
+    uint32_t frames = 0;
+    for (int i = 0; i < 4; i++) {
+        version |= (uint32_t)header[8 + i] << (8 * i);
+        frames |= (uint32_t)header[12 + i] << (8 * i);
+    }
+    if (version != kVersion || frames > OTK_TRACE_FRAMES_FULL) {
+        std::fclose(file);
+        return nullptr;
+    }
+    otk_trace_replay *replay = new otk_trace_replay();
+    replay->reader.file = file;
+    replay->reader.buffer.resize(1 << 16);
+    replay->frames = (otk_trace_frames)frames;
+    return replay;
+}
+
+void otk_trace_replay_delete(otk_trace_replay *replay) {
+    if (replay == nullptr) {
+        return;
+    }
+    std::fclose(replay->reader.file);
+    delete replay;
+}
+
+otk_trace_frames otk_trace_replay_frames(otk_trace_replay *replay) {
+    return replay != nullptr ? replay->frames : OTK_TRACE_FRAMES_NONE;
+}
+
+static void upscale_plane(uint8_t *out, uint32_t width, uint32_t height, const uint8_t *in) {
+    uint32_t in_width = subsampled_size(width);
+    for (uint32_t y = 0; y < height; y++) {
+        const uint8_t *row = in + (size_t)(y / kSubsample) * in_width;
+        uint8_t *out_row = out + (size_t)y * width;
+        for (uint32_t x = 0; x < width; x++) {
+            out_row[x] = row[x / kSubsample];
+        }
+    }
+}
+
+// A moving gradient, so scaling and upload see changing content.
+static void pattern_plane(uint8_t *out, uint32_t width, uint32_t height, uint64_t seed, bool chroma) {
+    for (uint32_t y = 0; y < height; y++) {
+        std::memset(out + (size_t)y * width, chroma ? 128 : (int)((seed + y) & 0xff), width);
+    }
+}
+
+// Reads a frame record after its type and time.
+static bool read_frame(otk_trace_replay *replay, uint64_t *index, otk_trace_frame *frame) {
+    trace_reader &reader = replay->reader;
+    *index = reader.varint();
+    frame->timestamp = reader.signed_varint();
+    uint64_t width = reader.varint();
+    uint64_t height = reader.varint();
+    uint8_t content = reader.u8();
+    if (reader.failed || *index >= replay->stream_ids.size() ||
+        width == 0 || height == 0 || width > kMaxDimension || height > kMaxDimension ||
+        content > OTK_TRACE_FRAMES_FULL) {
+        return false;
+    }
+    frame->width = (uint32_t)width;
+    frame->height = (uint32_t)height;
+    frame->content = (otk_trace_frames)content;
+    frame->hash = content >= OTK_TRACE_FRAMES_HASH ? reader.u64() : 0;
+
+    const uint32_t widths[3] = {frame->width, chroma_size(frame->width), chroma_size(frame->width)};
+    const uint32_t heights[3] = {frame->height, chroma_size(frame->height), chroma_size(frame->height)};
+    for (int p = 0; p < 3; p++) {
+        std::vector<uint8_t> &plane = replay->planes[p];
+        size_t size = (size_t)widths[p] * heights[p];
+        if (plane.size() < size) {
+            plane.resize(size);
+        }
+        if (content == OTK_TRACE_FRAMES_FULL) {
+            reader.bytes(plane.data(), size);
+        } else if (content == OTK_TRACE_FRAMES_SUBSAMPLED) {
+            size_t recorded = (size_t)subsampled_size(widths[p]) * subsampled_size(heights[p]);
+            replay->recorded.resize(recorded);
+            reader.bytes(replay->recorded.data(), recorded);
+            upscale_plane(plane.data(), widths[p], heights[p], replay->recorded.data());
+        } else {
+            uint64_t seed = content == OTK_TRACE_FRAMES_HASH ? frame->hash : replay->stats.frames;
+            pattern_plane(plane.data(), widths[p], heights[p], seed, p > 0);
+        }
+        frame->planes[p] = plane.data();
+        frame->strides[p] = (int)widths[p];
+    }
+    return !reader.failed;
+}
+
+int otk_trace_replay_run(otk_trace_replay *replay, const otk_trace_replay_callbacks *callbacks,
+                         double speed) {
+    if (replay == nullptr) {
+        return -1;
+    }
+    otk_trace_replay_callbacks none = {};
+    const otk_trace_replay_callbacks &cb = callbacks != nullptr ? *callbacks : none;
+    trace_reader &reader = replay->reader;
+    std::fseek(reader.file, kHeaderSize, SEEK_SET);
+    reader.position = 0;
+    reader.length = 0;
+    reader.failed = false;
+    replay->stream_ids.clear();
+    replay->stop_requested.store(false);
+    {
+        std::lock_guard<std::mutex> guard(replay->stats_lock);
+        replay->stats = {};
+    }
+
+    trace_clock::time_point start = trace_clock::now();
+    int64_t recorded_us = 0;
+    while (!replay->stop_requested.load(std::memory_order_relaxed) && !reader.at_end()) {
+        uint8_t type = reader.u8();
+        recorded_us += (int64_t)reader.varint();
+        if (reader.failed) {
+            return -1;
+        }
+
+        // Parsed before waiting, so the wait absorbs the parsing time.
+        uint64_t index = 0;
+        uint8_t event = 0;
+        otk_trace_frame frame = {};
+        uint32_t requested = 0;
+        uint32_t returned = 0;
+        bool has_samples = false;
+        switch (type) {
+            case RECORD_STREAM_NAME: {
+                index = reader.varint();
+                uint64_t length = reader.varint();
+                if (reader.failed || index != replay->stream_ids.size() || length > kMaxStreamIdLength) {
+                    return -1;
+                }
+                std::string id(length, '\0');
+                reader.bytes((uint8_t *)id.data(), length);
+                replay->stream_ids.push_back(id);
+                break;
+            }
+            case RECORD_SESSION:
+                event = reader.u8();
+                break;
+            case RECORD_STREAM_RECEIVED:
+            case RECORD_STREAM_DROPPED:
+                index = reader.varint();
+                if (index >= replay->stream_ids.size()) {
+                    return -1;
+                }
+                break;
+            case RECORD_FRAME:
+                if (!read_frame(replay, &index, &frame)) {
+                    return -1;
+                }
+                break;
+            case RECORD_AUDIO_READ: {
+                uint64_t requested_samples = reader.varint();
+                uint64_t returned_samples = reader.varint();
+                has_samples = reader.u8() != 0;
+                if (requested_samples > UINT32_MAX || returned_samples > kMaxAudioSamples) {
+                    return -1;
+                }
+                requested = (uint32_t)requested_samples;
+                returned = (uint32_t)returned_samples;
+                if (has_samples) {
+                    replay->recorded.resize((size_t)returned * 2);
+                    reader.bytes(replay->recorded.data(), replay->recorded.size());
+                    replay->samples.resize(returned);
+                    for (uint32_t i = 0; i < returned; i++) {
+                        replay->samples[i] = (int16_t)(replay->recorded[2 * i] |
+                                                       (replay->recorded[2 * i + 1] << 8));
+                    }
+                }
+                break;
+            }
+            default:
+                return -1;
+        }
+        if (reader.failed) {
+            return -1;
+        }
+        if (type == RECORD_STREAM_NAME) {
+            continue;
+        }
+
+        int64_t late_us = 0;
+        if (speed > 0) {
+            auto due = start + std::chrono::microseconds((int64_t)(recorded_us / speed));
+            std::this_thread::sleep_until(due);
+            late_us = std::chrono::duration_cast<std::chrono::microseconds>(trace_clock::now() - due).count();
+        }
+
+        const char *stream_id = index < replay->stream_ids.size() ? replay->stream_ids[index].c_str() : nullptr;
+        switch (type) {
+            case RECORD_SESSION:
+                if (cb.on_session_event) {
+                    cb.on_session_event(cb.user_data, (otk_trace_session_event)event);
+                }
+                break;
+            case RECORD_STREAM_RECEIVED:
+                if (cb.on_stream_received) {
+                    cb.on_stream_received(cb.user_data, stream_id);
+                }
+                break;
+            case RECORD_STREAM_DROPPED:
+                if (cb.on_stream_dropped) {
+                    cb.on_stream_dropped(cb.user_data, stream_id);
+                }
+                break;
+            case RECORD_FRAME:
+                if (cb.on_frame) {
+                    cb.on_frame(cb.user_data, stream_id, &frame);
+                }
+                break;
+            case RECORD_AUDIO_READ:
+                if (cb.on_audio_read) {
+                    cb.on_audio_read(cb.user_data, requested, returned,
+                                     has_samples ? replay->samples.data() : nullptr);
+                }
+                break;
+        }
+
+        std::lock_guard<std::mutex> guard(replay->stats_lock);
+        otk_trace_replay_stats &stats = replay->stats;
+        stats.events++;
+        stats.frames += type == RECORD_FRAME;
+        stats.audio_reads += type == RECORD_AUDIO_READ;
+        stats.late_events += late_us > kLateUs;
+        stats.max_late_us = std::max(stats.max_late_us, late_us);
+        stats.recorded_us = recorded_us;
+        stats.elapsed_us = elapsed_us(start);
+    }
+    return 0;
+}
+
+void otk_trace_replay_stop(otk_trace_replay *replay) {
+    if (replay != nullptr) {
+        replay->stop_requested.store(true, std::memory_order_relaxed);
+    }
+}
+
+void otk_trace_replay_get_stats(otk_trace_replay *replay, otk_trace_replay_stats *stats) {
+    if (replay == nullptr || stats == nullptr) {
+        return;
+    }
+    std::lock_guard<std::mutex> guard(replay->stats_lock);
+    *stats = replay->stats;
+}
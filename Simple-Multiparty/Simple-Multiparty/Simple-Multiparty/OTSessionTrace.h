@@ -0,0 +1,162 @@
+//
+//  OTSessionTrace.h
+//  Simple-Multiparty
+//
+//  Copyright (c) 2026 Vonage. All rights reserved.
+//
+
+#ifndef OTSessionTrace_h
+#define OTSessionTrace_h
+
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * Records the session, stream, frame and audio callbacks of a session to
+ * a binary trace, and replays a trace through callbacks, at the recorded
+ * pace or as fast as possible, so a performance run can be repeated
+ * without a live session.
+ *
+ * The trace starts with "OTKTRACE", a version and the frame content, all
+ * little endian. Each record is a type byte, the microseconds since the
+ * previous record as a varint, and the record's fields. Stream ids are
+ * written once and then referred to by index.
+ *
+ * Recording only appends to a memory buffer under a lock; a background
+ * thread writes it to the file. If the file falls far behind, frames are
+ * recorded with their hash only until it catches up.
+ */
+typedef struct otk_trace_recorder otk_trace_recorder;
+typedef struct otk_trace_replay otk_trace_replay;
+
+/** What is kept of each frame; each level includes the ones before. */
+typedef enum otk_trace_frames {
+    /** Size and timestamp. */
+    OTK_TRACE_FRAMES_NONE = 0,
+    /** A 64 bit hash of the pixels. */
+    OTK_TRACE_FRAMES_HASH = 1,
+    /** Every 4th pixel of every 4th row of each plane. */
+    OTK_TRACE_FRAMES_SUBSAMPLED = 2,
+    /** All pixels. */
+    OTK_TRACE_FRAMES_FULL = 3,
+} otk_trace_frames;
+
+typedef enum otk_trace_session_event {
+    OTK_TRACE_CONNECTED = 0,
+    OTK_TRACE_DISCONNECTED = 1,
+    OTK_TRACE_RECONNECTING = 2,
+    OTK_TRACE_RECONNECTED = 3,
+    OTK_TRACE_ERROR = 4,
+} otk_trace_session_event;
+
+typedef struct otk_trace_recorder_stats {
+    uint64_t events;
+    uint64_t bytes_written;
+    /** Frames recorded with their hash only because the file fell behind. */
+    uint64_t payloads_dropped;
+    /** Set once a write to the file failed; nothing more is written. */
+    int write_failed;
+} otk_trace_recorder_stats;
+
+/** Returns NULL if the file cannot be created. */
+otk_trace_recorder *otk_trace_recorder_new(const char *path, otk_trace_frames frames);
+
+/** Writes what is left and closes the file. */
+void otk_trace_recorder_delete(otk_trace_recorder *recorder);
+
+void otk_trace_record_session(otk_trace_recorder *recorder, otk_trace_session_event event);
+
+void otk_trace_record_stream_received(otk_trace_recorder *recorder, const char *stream_id);
+
+void otk_trace_record_stream_dropped(otk_trace_recorder *recorder, const char *stream_id);
+
+/** An I420 frame handed to a renderer. */
+void otk_trace_record_frame(otk_trace_recorder *recorder, const char *stream_id,
+                            int64_t timestamp, uint32_t width, uint32_t height,
+                            const uint8_t *const planes[3], const int strides[3]);
+
+/**
+ * An audio device read that asked for requested mono 16 bit samples and
+ * got returned. samples, if not NULL, are recorded too.
+ */
+void otk_trace_record_audio_read(otk_trace_recorder *recorder, uint32_t requested,
+                                 uint32_t returned, const int16_t *samples);
+
+void otk_trace_recorder_get_stats(otk_trace_recorder *recorder, otk_trace_recorder_stats *stats);
+
+/** Hash stored with frames, over the visible pixels only. */
+uint64_t otk_trace_hash_i420(const uint8_t *const planes[3], const int strides[3],
+                             uint32_t width, uint32_t height);
+
+/**
+ * A replayed frame. The planes are rebuilt from what was recorded: exact
+ * for FULL, scaled up for SUBSAMPLED and a pattern seeded by the hash
+ * otherwise, so the renderers get the same amount of work. Valid during
+ * the callback only.
+ */
+typedef struct otk_trace_frame {
+    int64_t timestamp;
+    uint32_t width;
+    uint32_t height;
+    const uint8_t *planes[3];
+    int strides[3];
+    otk_trace_frames content;
+    /** 0 when the content is NONE. */
+    uint64_t hash;
+} otk_trace_frame;
+
+/** Callbacks left NULL are skipped. All are called on the replaying thread. */
+typedef struct otk_trace_replay_callbacks {
+    void *user_data;
+    void (*on_session_event)(void *user_data, otk_trace_session_event event);
+    void (*on_stream_received)(void *user_data, const char *stream_id);
+    void (*on_stream_dropped)(void *user_data, const char *stream_id);
+    void (*on_frame)(void *user_data, const char *stream_id, const otk_trace_frame *frame);
+    void (*on_audio_read)(void *user_data, uint32_t requested, uint32_t returned,
+                          const int16_t *samples);
+} otk_trace_replay_callbacks;
+
+typedef struct otk_trace_replay_stats {
+    uint64_t events;
+    uint64_t frames;
+    uint64_t audio_reads;
+    /** Events dispatched more than a millisecond after they were due. */
+    uint64_t late_events;
+    int64_t max_late_us;
+    /** Recorded length of the events replayed. */
+    int64_t recorded_us;
+    /** Time the replay took. */
+    int64_t elapsed_us;
+} otk_trace_replay_stats;
+
+/** Returns NULL if the file cannot be read or is not a trace. */
+otk_trace_replay *otk_trace_replay_open(const char *path);
+
+void otk_trace_replay_delete(otk_trace_replay *replay);
+
+otk_trace_frames otk_trace_replay_frames(otk_trace_replay *replay);
+
+/**
+ * Replays the whole trace on the calling thread. speed 1 keeps the recorded
+ * pace, 2 twice as fast; 0 or less does not wait at all. Returns 0 at the
+ * end of the trace or when stopped, -1 if a record is malformed; the
+ * records before it have been replayed. A trace can be run more than once.
+ */
+int otk_trace_replay_run(otk_trace_replay *replay, const otk_trace_replay_callbacks *callbacks,
+                         double speed);
+
+/** Makes a run on another thread return after the current event. */
+void otk_trace_replay_stop(otk_trace_replay *replay);
+
+/** Of the current or last run. */
+void otk_trace_replay_get_stats(otk_trace_replay *replay, otk_trace_replay_stats *stats);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* OTSessionTrace_h */
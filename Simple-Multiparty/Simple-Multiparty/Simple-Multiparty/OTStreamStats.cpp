@@ -0,0 +1,568 @@
+//
+//  OTStreamStats.cpp
+//  Simple-Multiparty
+//
+//  Copyright (c) 2026 Vonage. All rights reserved.
+//
+
+#include "OTStreamStats.h"
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cmath>
+#include <cstdarg>
+#include <cstdio>
+#include <limits>
+#include <mutex>
+#include <vector>
+
+// One bucket per second. 61 so the oldest second of the 60 second window is
+// still there while the current second is being filled.
+static const int kBuckets = 61;
+
+// Histogram bins: bin 0 holds values below 1/8, then two bins per octave.
+static const int kBins = 42;
+static const double kBinScale = 8.0;
+
+static const int kWindowSeconds[OTK_WINDOW_COUNT] = { 1, 10, 60 };
+static const char *const kWindowNames[OTK_WINDOW_COUNT] = { "1s", "10s", "60s" };
+static const char *const kMetricNames[OTK_METRIC_COUNT] = {
+    "video_bitrate_kbps",
+    "video_packet_loss_percent",
+    "audio_bitrate_kbps",
+    "audio_packet_loss_percent",
+    "frame_rate",
+};
+static const char *const kRoleNames[] = { "publisher", "subscriber" };
+
+// Histograms kept per metric for the windows longer than one second.
+static const int kWin10 = 0;
+static const int kWin60 = 1;
+static const int kHistogramWindows = 2;
+
+static const size_t kStreamIdBytes = 64;
+
+struct counter_state {
+    bool valid;
+    int64_t packets;
+    int64_t packets_lost;
+    int64_t bytes;
+    int64_t time_ms;
+};
+
+struct otk_stream_stats {
+    std::mutex lock;
+    uint32_t max_streams;
+    bool started;
+    int64_t current_second;
+
+    // Per stream.
+    std::vector<uint8_t> active;
+    std::vector<std::array<char, kStreamIdBytes>> ids;
+    std::vector<uint8_t> roles;
+    std::vector<int64_t> first_seconds;
+    std::vector<counter_state> counters;      // [stream][media]
+
+    // Per stream, metric and bucket, one array per field.
+    std::vector<double> sums;
+    std::vector<uint32_t> counts;
+    std::vector<float> minimums;
+    std::vector<float> maximums;
+    std::vector<uint8_t> bucket_bins;         // [stream][metric][bucket][bin]
+    std::vector<uint32_t> window_bins;        // [stream][metric][window][bin]
+    std::vector<uint32_t> frames;             // [stream][bucket]
+};
+
+static size_t bucket_index(int slot, int metric, int bucket) {
+    return ((size_t)slot * OTK_METRIC_COUNT + metric) * kBuckets + bucket;
+}
+
+static size_t window_index(int slot, int metric, int window) {
+    return (((size_t)slot * OTK_METRIC_COUNT + metric) * kHistogramWindows + window) * kBins;
+}
+
+static int bucket_of(int64_t second) {
+    return (int)(second % kBuckets);
+}
+
+static int bin_of(double value) {
+    double scaled = value * kBinScale;
+    if (!(scaled >= 1.0)) {
+        return 0;
+    }
+    int bin = 1 + (int)(2.0 * std::log2(scaled));
+    return std::min(bin, kBins - 1);
+}
+
+// Geometric middle of a bin.
+static double bin_value(int bin) {
+    if (bin == 0) {
+        return 0.0;
+    }
+    return std::exp2((bin - 1 + 0.5) / 2.0) / kBinScale;
+}
+
+otk_stream_stats *otk_stream_stats_new(uint32_t max_streams) {
+    otk_stream_stats *stats = new otk_stream_stats();
+    size_t streams = max_streams;
+    size_t buckets = streams * OTK_METRIC_COUNT * kBuckets;
+    stats->max_streams = max_streams;
+    stats->started = false;
+    stats->current_second = 0;
+    stats->active.assign(streams, 0);
+    stats->ids.resize(streams);
+    stats->roles.assign(streams, 0);
+    stats->first_seconds.assign(streams, 0);
+    stats->counters.assign(streams * 2, counter_state{});
+    stats->sums.assign(buckets, 0.0);
+    stats->counts.assign(buckets, 0);
+    stats->minimums.assign(buckets, 0.0f);
+    stats->maximums.assign(buckets, 0.0f);
+    stats->bucket_bins.assign(buckets * kBins, 0);
+    stats->window_bins.assign(streams * OTK_METRIC_COUNT * kHistogramWindows * kBins, 0);
+    stats->frames.assign(streams * kBuckets, 0);
+    return stats;
+}
+
+void otk_stream_stats_delete(otk_stream_stats *stats) {
+    delete stats;
+}
+
+int64_t otk_stream_stats_now_ms(void) {
+    return (int64_t)std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+static void clear_bucket(otk_stream_stats *stats, int slot, int bucket) {
+    for (int metric = 0; metric < OTK_METRIC_COUNT; metric++) {
+        size_t index = bucket_index(slot, metric, bucket);
+        stats->sums[index] = 0.0;
+        stats->counts[index] = 0;
+        stats->minimums[index] = std::numeric_limits<float>::infinity();
+        stats->maximums[index] = -std::numeric_limits<float>::infinity();
+        std::fill_n(&stats->bucket_bins[index * kBins], kBins, 0);
+    }
+    stats->frames[(size_t)slot * kBuckets + bucket] = 0;
+}
+
+static void clear_stream(otk_stream_stats *stats, int slot) {
+    for (int bucket = 0; bucket < kBuckets; bucket++) {
+        clear_bucket(stats, slot, bucket);
+    }
+    std::fill_n(&stats->window_bins[window_index(slot, 0, 0)],
+                OTK_METRIC_COUNT * kHistogramWindows * kBins, 0);
+    stats->counters[(size_t)slot * 2] = counter_state{};
+    stats->counters[(size_t)slot * 2 + 1] = counter_state{};
+}
+
+static void record(otk_stream_stats *stats, int slot, int metric, double value) {
+    size_t index = bucket_index(slot, metric, bucket_of(stats->current_second));
+    stats->sums[index] += value;
+    stats->counts[index]++;
+    stats->minimums[index] = std::min(stats->minimums[index], (float)value);
+    stats->maximums[index] = std::max(stats->maximums[index], (float)value);
+    uint8_t &bin = stats->bucket_bins[index * kBins + bin_of(value)];
+    if (bin < UINT8_MAX) {
+        bin++;
+    }
+}
+
+// Moves the finished second into the window histograms and drops the one
+// that just left the 10 second window.
+static void close_second(otk_stream_stats *stats, int64_t second) {
+    int bucket = bucket_of(second);
+    int expired10 = bucket_of(second - 10 + kBuckets);
+    for (uint32_t slot = 0; slot < stats->max_streams; slot++) {
+        if (!stats->active[slot]) {
+            continue;
+        }
+        if (second > stats->first_seconds[slot]) {
+            record(stats, slot, OTK_METRIC_FRAME_RATE,
+                   stats->frames[(size_t)slot * kBuckets + bucket]);
+        }
+        for (int metric = 0; metric < OTK_METRIC_COUNT; metric++) {
+            const uint8_t *added = &stats->bucket_bins[bucket_index(slot, metric, bucket) * kBins];
+            const uint8_t *removed = &stats->bucket_bins[bucket_index(slot, metric, expired10) * kBins];
+            uint32_t *win10 = &stats->window_bins[window_index(slot, metric, kWin10)];
+            uint32_t *win60 = &stats->window_bins[window_index(slot, metric, kWin60)];
+            for (int bin = 0; bin < kBins; bin++) {
+                win10[bin] += added[bin] - removed[bin];
+                win60[bin] += added[bin];
+            }
+        }
+    }
+}
+
+// Reuses the bucket of the second that just left the 60 second window.
+static void open_second(otk_stream_stats *stats, int64_t second) {
+    int bucket = bucket_of(second);
+    for (uint32_t slot = 0; slot < stats->max_streams; slot++) {
+        if (!stats->active[slot]) {
+            continue;
+        }
+        for (int metric = 0; metric < OTK_METRIC_COUNT; metric++) {
+            const uint8_t *removed = &stats->bucket_bins[bucket_index(slot, metric, bucket) * kBins];
+            uint32_t *win60 = &stats->window_bins[window_index(slot, metric, kWin60)];
+            for (int bin = 0; bin < kBins; bin++) {
+                win60[bin] -= removed[bin];
+            }
+        }
+        clear_bucket(stats, slot, bucket);
+    }
+}
+
+static void advance(otk_stream_stats *stats, int64_t now_ms) {
+    int64_t second = now_ms / 1000;
+    if (!stats->started) {
+        stats->started = true;
+        stats->current_second = second;
+        return;
+    }
+    if (second <= stats->current_second) {
+        return;
+    }
+    if (second - stats->current_second > kBuckets) {
+        // Nothing was recorded for longer than the longest window.
+        for (uint32_t slot = 0; slot < stats->max_streams; slot++) {
+            if (stats->active[slot]) {
+                clear_stream(stats, slot);
+                stats->first_seconds[slot] = second;
+            }
+        }
+        stats->current_second = second;
+        return;
+    }
+    while (stats->current_second < second) {
+        close_second(stats, stats->current_second);
+        stats->current_second++;
+        open_second(stats, stats->current_second);
+    }
+}
+
+static bool valid_slot(otk_stream_stats *stats, int slot) {
+    return slot >= 0 && (uint32_t)slot < stats->max_streams && stats->active[slot];
+}
+
+int otk_stream_stats_add(otk_stream_stats *stats,
+                         const char *stream_id,
+                         enum otk_stream_role role,
+                         int64_t now_ms) {
+    if (stats == nullptr) {
+        return -1;
+    }
+    std::lock_guard<std::mutex> guard(stats->lock);
+    advance(stats, now_ms);
+    for (uint32_t slot = 0; slot < stats->max_streams; slot++) {
+        if (stats->active[slot]) {
+            continue;
+        }
+        clear_stream(stats, slot);
+        // Kept as given; the exports escape it.
+        std::array<char, kStreamIdBytes> &id = stats->ids[slot];
+        size_t length = 0;
+        for (const char *c = stream_id != nullptr ? stream_id : "";
+             *c != '\0' && length + 1 < id.size(); c++) {
+            id[length++] = *c;
+        }
+        id[length] = '\0';
+        stats->roles[slot] = (uint8_t)role;
+        stats->first_seconds[slot] = stats->current_second;
+        stats->active[slot] = 1;
+        return (int)slot;
+    }
+    return -1;
+}
+
+void otk_stream_stats_remove(otk_stream_stats *stats, int slot) {
+    if (stats == nullptr) {
+        return;
+    }
+    std::lock_guard<std::mutex> guard(stats->lock);
+    if (valid_slot(stats, slot)) {
+        stats->active[slot] = 0;
+    }
+}
+
+void otk_stream_stats_add_counters(otk_stream_stats *stats,
+                                   int slot,
+                                   enum otk_stream_media media,
+                                   int64_t packets,
+                                   int64_t packets_lost,
+                                   int64_t bytes,
+                                   int64_t now_ms) {
+    if (stats == nullptr) {
+        return;
+    }
+    std::lock_guard<std::mutex> guard(stats->lock);
+    if (!valid_slot(stats, slot)) {
+        return;
+    }
+    advance(stats, now_ms);
+    counter_state &last = stats->counters[(size_t)slot * 2 + media];
+    if (last.valid && now_ms > last.time_ms) {
+        int64_t delta_packets = packets - last.packets;
+        int64_t delta_lost = packets_lost - last.packets_lost;
+        int64_t delta_bytes = bytes - last.bytes;
+        if (delta_packets >= 0 && delta_lost >= 0 && delta_bytes >= 0) {
+            bool video = media == OTK_STREAM_VIDEO;
+            // Bytes per millisecond times 8 is kbit/s.
+            double kbps = (double)delta_bytes * 8.0 / (double)(now_ms - last.time_ms);
+            record(stats, slot, video ? OTK_METRIC_VIDEO_BITRATE_KBPS : OTK_METRIC_AUDIO_BITRATE_KBPS,
+                   kbps);
+            // Publishers report packets sent, lost ones included; subscribers
+            // report packets received.
+            int64_t expected = stats->roles[slot] == OTK_STREAM_PUBLISHER ?
+                delta_packets : delta_packets + delta_lost;
+            if (expected > 0) {
+                double loss = 100.0 * (double)std::min(delta_lost, expected) / (double)expected;
+                record(stats, slot,
+                       video ? OTK_METRIC_VIDEO_PACKET_LOSS_PERCENT : OTK_METRIC_AUDIO_PACKET_LOSS_PERCENT,
+                       loss);
+            }
+        }
+    }
+    last.valid = true;
+    last.packets = packets;
+    last.packets_lost = packets_lost;
+    last.bytes = bytes;
+    last.time_ms = now_ms;
+}
+
+void otk_stream_stats_add_frame(otk_stream_stats *stats, int slot, int64_t now_ms) {
+    if (stats == nullptr) {
+        return;
+    }
+    std::lock_guard<std::mutex> guard(stats->lock);
+    if (!valid_slot(stats, slot)) {
+        return;
+    }
+    advance(stats, now_ms);
+    stats->frames[(size_t)slot * kBuckets + bucket_of(stats->current_second)]++;
+}
+
+static double percentile(const uint32_t *bins, uint64_t total, double fraction) {
+    uint64_t target = std::max<uint64_t>(1, (uint64_t)std::ceil(fraction * (double)total));
+    uint64_t seen = 0;
+    for (int bin = 0; bin < kBins; bin++) {
+        seen += bins[bin];
+        if (seen >= target) {
+            return bin_value(bin);
+        }
+    }
+    return bin_value(kBins - 1);
+}
+
+static void summarize(otk_stream_stats *stats, int slot, int metric, int window,
+                      otk_stats_summary *summary) {
+    *summary = otk_stats_summary{};
+    double sum = 0.0;
+    double minimum = std::numeric_limits<double>::infinity();
+    double maximum = -std::numeric_limits<double>::infinity();
+    uint32_t samples = 0;
+    for (int age = 1; age <= kWindowSeconds[window]; age++) {
+        size_t index = bucket_index(slot, metric, bucket_of(stats->current_second - age + kBuckets));
+        if (stats->counts[index] == 0) {
+            continue;
+        }
+        samples += stats->counts[index];
+        sum += stats->sums[index];
+        minimum = std::min(minimum, (double)stats->minimums[index]);
+        maximum = std::max(maximum, (double)stats->maximums[index]);
+    }
+    if (samples == 0) {
+        return;
+    }
+    uint32_t bins[kBins];
+    if (window == OTK_WINDOW_1S) {
+        const uint8_t *last = &stats->bucket_bins[
+            bucket_index(slot, metric, bucket_of(stats->current_second - 1 + kBuckets)) * kBins];
+        std::copy(last, last + kBins, bins);
+    } else {
+        const uint32_t *source = &stats->window_bins[
+            window_index(slot, metric, window == OTK_WINDOW_10S ? kWin10 : kWin60)];
+        std::copy(source, source + kBins, bins);
+    }
+    uint64_t total = 0;
+    for (int bin = 0; bin < kBins; bin++) {
+        total += bins[bin];
+    }
+    summary->samples = samples;
+    summary->average = sum / samples;
+    summary->minimum = minimum;
+    summary->maximum = maximum;
+    summary->p50 = std::clamp(percentile(bins, total, 0.5), minimum, maximum);
+    summary->p95 = std::clamp(percentile(bins, total, 0.95), minimum, maximum);
+}
+
+int otk_stream_stats_get_summary(otk_stream_stats *stats,
+                                 int slot,
+                                 enum otk_stream_metric metric,
+                                 enum otk_stats_window window,
+                                 int64_t now_ms,
+                                 otk_stats_summary *summary) {
+    if (stats == nullptr || summary == nullptr || metric < 0 || metric >= OTK_METRIC_COUNT ||
+        window < 0 || window >= OTK_WINDOW_COUNT) {
+        return 0;
+    }
+    std::lock_guard<std::mutex> guard(stats->lock);
+    if (!valid_slot(stats, slot)) {
+        return 0;
+    }
+    advance(stats, now_ms);
+    summarize(stats, slot, metric, window, summary);
+    return 1;
+}
+
+struct text_writer {
+    char *buffer;
+    size_t size;
+    size_t length;
+};
+
+__attribute__((format(printf, 2, 3)))
+static void append(text_writer *writer, const char *format, ...) {
+    va_list args;
+    va_start(args, format);
+    char *out = writer->length < writer->size ? writer->buffer + writer->length : nullptr;
+    size_t room = out != nullptr ? writer->size - writer->length : 0;
+    int written = vsnprintf(out, room, format, args);
+    va_end(args);
+    if (written > 0) {
+        writer->length += (size_t)written;
+    }
+}
+
+// Stream ids come from the network, so they are escaped wherever they are
+// quoted: a JSON string, or a Prometheus label value when json is false.
+static void append_quoted(text_writer *writer, const char *text, bool json) {
+    append(writer, "\"");
+    for (const unsigned char *c = (const unsigned char *)text; *c != '\0'; c++) {
+        if (*c == '"' || *c == '\\') {
+            append(writer, "\\%c", *c);
+        } else if (*c == '\n') {
+            append(writer, "\\n");
+        } else if (json && *c < 0x20) {
+            append(writer, "\\u%04x", *c);
+        } else {
+            append(writer, "%c", *c);
+        }
+    }
+    append(writer, "\"");
+}
+
+// JSON has no NaN or infinity, so those are written as null.
+static void append_json_number(text_writer *writer, const char *name, double value) {
+    if (std::isfinite(value)) {
+        append(writer, ",\"%s\":%.2f", name, value);
+    } else {
+        append(writer, ",\"%s\":null", name);
+    }
+}
+
+static void append_prometheus_number(text_writer *writer, double value) {
+    if (std::isnan(value)) {
+        append(writer, "NaN");
+    } else if (std::isinf(value)) {
+        append(writer, "%s", value > 0 ? "+Inf" : "-Inf");
+    } else {
+        append(writer, "%.2f", value);
+    }
+}
+
+static size_t finish(text_writer *writer) {
+    if (writer->size > 0 && writer->length >= writer->size) {
+        writer->buffer[writer->size - 1] = '\0';
+    }
+    return writer->length;
+}
+
+size_t otk_stream_stats_export_json(otk_stream_stats *stats,
+                                    int64_t now_ms,
+                                    char *buffer,
+                                    size_t size) {
+    text_writer writer = { buffer, buffer != nullptr ? size : 0, 0 };
+    if (writer.size > 0) {
+        buffer[0] = '\0';
+    }
+    if (stats == nullptr) {
+        return 0;
+    }
+    std::lock_guard<std::mutex> guard(stats->lock);
+    advance(stats, now_ms);
+    append(&writer, "{\"second\":%lld,\"streams\":[", (long long)stats->current_second);
+    bool first_stream = true;
+    for (uint32_t slot = 0; slot < stats->max_streams; slot++) {
+        if (!stats->active[slot]) {
+            continue;
+        }
+        append(&writer, "%s{\"id\":", first_stream ? "" : ",");
+        append_quoted(&writer, stats->ids[slot].data(), true);
+        append(&writer, ",\"role\":\"%s\",\"metrics\":{", kRoleNames[stats->roles[slot]]);
+        first_stream = false;
+        for (int metric = 0; metric < OTK_METRIC_COUNT; metric++) {
+            append(&writer, "%s\"%s\":{", metric > 0 ? "," : "", kMetricNames[metric]);
+            for (int window = 0; window < OTK_WINDOW_COUNT; window++) {
+                otk_stats_summary summary;
+                summarize(stats, slot, metric, window, &summary);
+                append(&writer, "%s\"%s\":{\"samples\":%u", window > 0 ? "," : "",
+                       kWindowNames[window], summary.samples);
+                if (summary.samples > 0) {
+                    append_json_number(&writer, "avg", summary.average);
+                    append_json_number(&writer, "min", summary.minimum);
+                    append_json_number(&writer, "max", summary.maximum);
+                    append_json_number(&writer, "p50", summary.p50);
+                    append_json_number(&writer, "p95", summary.p95);
+                }
+                append(&writer, "}");
+            }
+            append(&writer, "}");
+        }
+        append(&writer, "}}");
+    }
+    append(&writer, "]}\n");
+    return finish(&writer);
+}
+
+size_t otk_stream_stats_export_prometheus(otk_stream_stats *stats,
+                                          int64_t now_ms,
+                                          char *buffer,
+                                          size_t size) {
+    text_writer writer = { buffer, buffer != nullptr ? size : 0, 0 };
+    if (writer.size > 0) {
+        buffer[0] = '\0';
+    }
+    if (stats == nullptr) {
+        return 0;
+    }
+    std::lock_guard<std::mutex> guard(stats->lock);
+    advance(stats, now_ms);
+    for (int metric = 0; metric < OTK_METRIC_COUNT; metric++) {
+        append(&writer, "# TYPE otk_stream_%s gauge\n", kMetricNames[metric]);
+        for (uint32_t slot = 0; slot < stats->max_streams; slot++) {
+            if (!stats->active[slot]) {
+                continue;
+            }
+            for (int window = 0; window < OTK_WINDOW_COUNT; window++) {
+                otk_stats_summary summary;
+                summarize(stats, slot, metric, window, &summary);
+                if (summary.samples == 0) {
+                    continue;
+                }
+                const double values[] = {
+                    summary.average, summary.minimum, summary.maximum, summary.p50, summary.p95
+                };
+                const char *const names[] = { "avg", "min", "max", "p50", "p95" };
+                for (int i = 0; i < 5; i++) {
+                    append(&writer, "otk_stream_%s{stream=", kMetricNames[metric]);
+                    append_quoted(&writer, stats->ids[slot].data(), false);
+                    append(&writer, ",role=\"%s\",window=\"%s\",stat=\"%s\"} ",
+                           kRoleNames[stats->roles[slot]], kWindowNames[window], names[i]);
+                    append_prometheus_number(&writer, values[i]);
+                    append(&writer, "\n");
+                }
+            }
+        }
+    }
+    return finish(&writer);
+}
@@ -0,0 +1,132 @@
+//
+//  OTStreamStats.h
+//  Simple-Multiparty
+//
+//  Copyright (c) 2026 Vonage. All rights reserved.
+//
+
+#ifndef OTStreamStats_h
+#define OTStreamStats_h
+
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * Rolling 1, 10 and 60 second statistics for the publisher and subscriber
+ * streams of a session, fed from the SDK stats callbacks.
+ *
+ * Memory is allocated once for a fixed number of streams and laid out as
+ * one array per field, so closing a second walks contiguous memory. Each
+ * update only touches the current one-second bucket. Percentiles come from
+ * per-window log-scale histograms that are updated as seconds enter and
+ * leave the windows, so reading them does not sort anything.
+ *
+ * Windows cover the last complete seconds; the second in progress is not
+ * included. Safe to use from any thread.
+ */
+typedef struct otk_stream_stats otk_stream_stats;
+
+enum otk_stream_role {
+    OTK_STREAM_PUBLISHER = 0,
+    OTK_STREAM_SUBSCRIBER = 1,
+};
+
+enum otk_stream_media {
+    OTK_STREAM_VIDEO = 0,
+    OTK_STREAM_AUDIO = 1,
+};
+
+enum otk_stream_metric {
+    OTK_METRIC_VIDEO_BITRATE_KBPS = 0,
+    OTK_METRIC_VIDEO_PACKET_LOSS_PERCENT = 1,
+    OTK_METRIC_AUDIO_BITRATE_KBPS = 2,
+    OTK_METRIC_AUDIO_PACKET_LOSS_PERCENT = 3,
+    OTK_METRIC_FRAME_RATE = 4,
+    OTK_METRIC_COUNT = 5,
+};
+
+enum otk_stats_window {
+    OTK_WINDOW_1S = 0,
+    OTK_WINDOW_10S = 1,
+    OTK_WINDOW_60S = 2,
+    OTK_WINDOW_COUNT = 3,
+};
+
+typedef struct otk_stats_summary {
+    uint32_t samples;
+    double average;
+    double minimum;
+    double maximum;
+    /** Percentiles are accurate to within about 20% (half an octave). */
+    double p50;
+    double p95;
+} otk_stats_summary;
+
+otk_stream_stats *otk_stream_stats_new(uint32_t max_streams);
+
+void otk_stream_stats_delete(otk_stream_stats *stats);
+
+/** Monotonic clock in milliseconds, for the now_ms arguments below. */
+int64_t otk_stream_stats_now_ms(void);
+
+/**
+ * Starts tracking a stream. Returns its slot, used by the calls below, or -1
+ * when max_streams are already tracked.
+ */
+int otk_stream_stats_add(otk_stream_stats *stats,
+                         const char *stream_id,
+                         enum otk_stream_role role,
+                         int64_t now_ms);
+
+void otk_stream_stats_remove(otk_stream_stats *stats, int slot);
+
+/**
+ * Adds the cumulative counters reported by the SDK for one media type.
+ * Bitrate and packet loss are computed from the change since the previous
+ * call; a counter going backwards starts over.
+ */
+void otk_stream_stats_add_counters(otk_stream_stats *stats,
+                                   int slot,
+                                   enum otk_stream_media media,
+                                   int64_t packets,
+                                   int64_t packets_lost,
+                                   int64_t bytes,
+                                   int64_t now_ms);
+
+/** Counts a rendered video frame, for the frame rate. */
+void otk_stream_stats_add_frame(otk_stream_stats *stats, int slot, int64_t now_ms);
+
+/** Returns 0 if the slot is not in use. */
+int otk_stream_stats_get_summary(otk_stream_stats *stats,
+                                 int slot,
+                                 enum otk_stream_metric metric,
+                                 enum otk_stats_window window,
+                                 int64_t now_ms,
+                                 otk_stats_summary *summary);
+
+/**
+ * Writes every stream's summaries as JSON into buffer. Like snprintf, returns
+ * the full length even when it does not fit, and always terminates buffer.
+ * Stream ids are escaped, and values that are not finite are written as null
+ * (NaN or +Inf/-Inf in the Prometheus format).
+ */
+size_t otk_stream_stats_export_json(otk_stream_stats *stats,
+                                    int64_t now_ms,
+                                    char *buffer,
+                                    size_t size);
+
+/** Same as otk_stream_stats_export_json, in the Prometheus text format. */
+size_t otk_stream_stats_export_prometheus(otk_stream_stats *stats,
+                                          int64_t now_ms,
+                                          char *buffer,
+                                          size_t size);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* OTStreamStats_h */
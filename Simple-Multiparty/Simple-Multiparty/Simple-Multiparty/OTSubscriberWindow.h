@@ -9,14 +9,28 @@
 #import "ViewController.h"
 #import "OTMTLVideoView.h"
 #include <OpenTok/opentok.h>
+#include "OTVideoPolicy.h"
+#include "OTPreferredResolution.h"
 
-@interface OTSubscriberWindow : NSWindowController
+@interface OTSubscriberWindow : NSWindowController <OTRendererDelegate>
 
 @property (weak) ViewController *viewController;
 @property (assign) IBOutlet OTMTLVideoView *videoView;
 @property (assign) IBOutlet NSTextField *streamLabel;
+/** When set, visibility, audio level and the Video checkbox are reported to it. */
+@property (assign) otk_video_policy *videoPolicy;
+@property (readonly) NSString *streamId;
+/** Slot of the subscriber's stream in the session's otk_stream_stats, -1 for none. */
+@property (assign) int statsSlot;
 
 - (void) setSubscriber:(otc_subscriber *)subs;
+/** Sets up a window for a stream replayed from a trace, with no subscriber. */
+- (void) setReplayedStreamId:(NSString *)streamId;
 - (otc_subscriber *) getSubscriber;
+/** Drops the subscriber but keeps the stream, the view and the policy entry. */
+- (void) detachSubscriber;
+/** Gives a detached window the new subscriber for the same stream. */
+- (void) reattachSubscriber:(otc_subscriber *)subs;
+- (void) audioLevelUpdated:(float)audioLevel;
 
 @end
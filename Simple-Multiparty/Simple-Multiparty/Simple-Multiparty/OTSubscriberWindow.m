@@ -9,8 +9,12 @@
 #import <Foundation/Foundation.h>
 #import <opentok/opentok.h>
 
+// Slightly longer than the default debounce period of OTPreferredResolution
+#define kPreferredResolutionPollDelay 0.55
+
 @interface OTSubscriberWindow () {
     otc_subscriber *subscriber;
+    otk_preferred_resolution *preferredResolution;
 }
 
 @end
@@ -25,10 +29,100 @@
     subscriber = NULL;
 }
 
+- (void)dealloc {
+    [[NSNotificationCenter defaultCenter] removeObserver:self];
+    otk_preferred_resolution_delete(preferredResolution);
+}
+
 - (void)setSubscriber:(otc_subscriber *)subs {
     subscriber = subs;
+    [self attachStreamId:[NSString stringWithUTF8String:otc_stream_get_id(otc_subscriber_get_stream(subs))]];
+}
+
+- (void)setReplayedStreamId:(NSString *)streamId {
+    subscriber = NULL;
+    [self attachStreamId:streamId];
+}
+
+- (void)attachStreamId:(NSString *)streamId {
+    _streamId = streamId;
+    
+    [_streamLabel setStringValue:_streamId];
     
-    [_streamLabel setStringValue:[NSString stringWithUTF8String:otc_stream_get_id(otc_subscriber_get_stream(subs))]];
+    // Ask for the simulcast layer that matches the size the video is drawn at.
+    otk_preferred_resolution_delete(preferredResolution);
+    preferredResolution = otk_preferred_resolution_new(NULL);
+    _videoView.delegate = self;
+    [self renderer:_videoView didChangeViewSize:[_videoView convertSizeToBacking:_videoView.bounds.size]];
+    
+    if (_videoPolicy) {
+        otk_video_policy_add(_videoPolicy, _streamId.UTF8String, otk_video_policy_now_ms());
+        // Minimizing the window also changes its occlusion state.
+        [[NSNotificationCenter defaultCenter] addObserver:self
+                                                 selector:@selector(windowDidChangeOcclusionState:)
+                                                     name:NSWindowDidChangeOcclusionStateNotification
+                                                   object:self.window];
+    }
+}
+
+- (void)detachSubscriber {
+    subscriber = NULL;
+}
+
+- (void)reattachSubscriber:(otc_subscriber *)subs {
+    subscriber = subs;
+    
+    // The new subscriber starts from the SDK defaults.
+    otk_preferred_resolution_delete(preferredResolution);
+    preferredResolution = otk_preferred_resolution_new(NULL);
+    [self renderer:_videoView didChangeViewSize:[_videoView convertSizeToBacking:_videoView.bounds.size]];
+    
+    if (_videoPolicy) {
+        otc_subscriber_set_subscribe_to_video(subscriber,
+            otk_video_policy_is_subscribed(_videoPolicy, _streamId.UTF8String) ? OTC_TRUE : OTC_FALSE);
+    }
+}
+
+#pragma mark - OTRendererDelegate
+
+- (void)renderer:(OTBaseVideoView *)renderer didChangeViewSize:(CGSize)size {
+    if (!preferredResolution) {
+        return;
+    }
+    float maxFrameRate = 0;
+    if (@available(macOS 12.0, *)) {
+        maxFrameRate = (float)self.window.screen.maximumFramesPerSecond;
+    }
+    otk_preferred_resolution_set_view(preferredResolution, (uint32_t)size.width, (uint32_t)size.height,
+                                      maxFrameRate, otk_preferred_resolution_now_ms());
+    // Resizing sends many sizes in a row, only the one that is still current
+    // after the debounce period is applied.
+    __weak OTSubscriberWindow *weakSelf = self;
+    dispatch_after(dispatch_time(DISPATCH_TIME_NOW, (int64_t)(kPreferredResolutionPollDelay * NSEC_PER_SEC)), dispatch_get_main_queue(), ^{
+        [weakSelf applyPreferredResolution];
+    });
+}
+
+- (void)applyPreferredResolution {
+    otk_preferred_video preferred;
+    if (subscriber &&
+        otk_preferred_resolution_poll(preferredResolution, otk_preferred_resolution_now_ms(), &preferred)) {
+        NSLog(@"Preferred video for stream %@: %ux%u at %.0f fps",
+              _streamId, preferred.width, preferred.height, preferred.frame_rate);
+        otc_subscriber_set_preferred_resolution(subscriber, preferred.width, preferred.height);
+        otc_subscriber_set_preferred_framerate(subscriber, preferred.frame_rate);
+    }
+}
+
+- (void)windowDidChangeOcclusionState:(NSNotification *)notification {
+    BOOL visible = (self.window.occlusionState & NSWindowOcclusionStateVisible) &&
+        !self.window.isMiniaturized;
+    otk_video_policy_set_visible(_videoPolicy, _streamId.UTF8String, visible ? 1 : 0);
+}
+
+- (void)audioLevelUpdated:(float)audioLevel {
+    otk_video_policy_set_audio_level(_videoPolicy, _streamId.UTF8String,
+                                     audioLevel, otk_video_policy_now_ms());
 }
 
 - (otc_subscriber *) getSubscriber {
@@ -37,6 +131,12 @@
 
 -(IBAction)onVideo:(id)sender {
     int state = (int)[(NSButton *)sender state];
+    if (_videoPolicy) {
+        // Checked leaves the decision to the policy, unchecked forces video off.
+        otk_video_policy_set_override(_videoPolicy, _streamId.UTF8String,
+                                      state == 1 ? OTK_VIDEO_OVERRIDE_NONE : OTK_VIDEO_OVERRIDE_OFF);
+        return;
+    }
     if(subscriber) {
         otc_subscriber_set_subscribe_to_video(subscriber, state == 1 ? OTC_TRUE : OTC_FALSE );
     }
@@ -0,0 +1,212 @@
+//
+//  OTVideoPolicy.cpp
+//  Simple-Multiparty
+//
+//  Copyright (c) 2026 Vonage. All rights reserved.
+//
+
+#include "OTVideoPolicy.h"
+
+#include <algorithm>
+#include <chrono>
+#include <map>
+#include <mutex>
+#include <string>
+#include <utility>
+#include <vector>
+
+struct participant {
+    uint64_t join_order;
+    bool visible;
+    // Time the participant last spoke, or joined if it never has.
+    int64_t last_active_ms;
+    enum otk_video_override video_override;
+    bool subscribed;
+    // Time the desired state started to differ from subscribed, -1 if it
+    // does not.
+    int64_t pending_since_ms;
+};
+
+struct otk_video_policy {
+    std::mutex lock;
+    otk_video_policy_config config;
+    std::map<std::string, participant> participants;
+    uint64_t next_join_order;
+};
+
+void otk_video_policy_config_default(otk_video_policy_config *config) {
+    if (config == nullptr) {
+        return;
+    }
+    config->max_active_videos = 4;
+    config->speaking_level = 0.1f;
+    config->enable_delay_ms = 300;
+    config->disable_delay_ms = 2000;
+}
+
+otk_video_policy *otk_video_policy_new(const otk_video_policy_config *config) {
+    otk_video_policy *policy = new otk_video_policy();
+    if (config != nullptr) {
+        policy->config = *config;
+    } else {
+        otk_video_policy_config_default(&policy->config);
+    }
+    policy->next_join_order = 0;
+    return policy;
+}
+
+void otk_video_policy_delete(otk_video_policy *policy) {
+    delete policy;
+}
+
+int64_t otk_video_policy_now_ms(void) {
+    return (int64_t)std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+void otk_video_policy_add(otk_video_policy *policy,
+                          const char *participant_id,
+                          int64_t now_ms) {
+    if (policy == nullptr || participant_id == nullptr) {
+        return;
+    }
+    std::lock_guard<std::mutex> guard(policy->lock);
+    participant p;
+    p.join_order = policy->next_join_order++;
+    p.visible = true;
+    p.last_active_ms = now_ms;
+    p.video_override = OTK_VIDEO_OVERRIDE_NONE;
+    p.subscribed = true;
+    p.pending_since_ms = -1;
+    policy->participants[participant_id] = p;
+}
+
+void otk_video_policy_remove(otk_video_policy *policy,
+                             const char *participant_id) {
+    if (policy == nullptr || participant_id == nullptr) {
+        return;
+    }
+    std::lock_guard<std::mutex> guard(policy->lock);
+    policy->participants.erase(participant_id);
+}
+
+void otk_video_policy_set_visible(otk_video_policy *policy,
+                                  const char *participant_id,
+                                  int visible) {
+    if (policy == nullptr || participant_id == nullptr) {
+        return;
+    }
+    std::lock_guard<std::mutex> guard(policy->lock);
+    auto it = policy->participants.find(participant_id);
+    if (it != policy->participants.end()) {
+        it->second.visible = visible != 0;
+    }
+}
+
+void otk_video_policy_set_audio_level(otk_video_policy *policy,
+                                      const char *participant_id,
+                                      float audio_level,
+                                      int64_t now_ms) {
+    if (policy == nullptr || participant_id == nullptr) {
+        return;
+    }
+    std::lock_guard<std::mutex> guard(policy->lock);
+    auto it = policy->participants.find(participant_id);
+    if (it != policy->participants.end() &&
+        audio_level >= policy->config.speaking_level) {
+        it->second.last_active_ms = std::max(it->second.last_active_ms, now_ms);
+    }
+}
+
+void otk_video_policy_set_override(otk_video_policy *policy,
+                                   const char *participant_id,
+                                   enum otk_video_override video_override) {
+    if (policy == nullptr || participant_id == nullptr) {
+        return;
+    }
+    std::lock_guard<std::mutex> guard(policy->lock);
+    auto it = policy->participants.find(participant_id);
+    if (it != policy->participants.end()) {
+        it->second.video_override = video_override;
+    }
+}
+
+// Returns true if the participant ranks among the max_active_videos most
+// recently active participants. A hidden participant keeps its slot until
+// its video is actually turned off, so the number of videos does not
+// overshoot while the disable delay runs.
+static bool is_recent_speaker(const otk_video_policy *policy,
+                              const participant &p) {
+    uint32_t limit = policy->config.max_active_videos;
+    if (limit == 0) {
+        return true;
+    }
+    uint32_t ahead = 0;
+    for (const auto &entry : policy->participants) {
+        const participant &other = entry.second;
+        if (&other == &p || (!other.visible && !other.subscribed) ||
+            other.video_override == OTK_VIDEO_OVERRIDE_OFF) {
+            continue;
+        }
+        if (other.last_active_ms > p.last_active_ms ||
+            (other.last_active_ms == p.last_active_ms &&
+             other.join_order < p.join_order)) {
+            ahead++;
+        }
+    }
+    return ahead < limit;
+}
+
+int otk_video_policy_update(otk_video_policy *policy,
+                            int64_t now_ms,
+                            otk_video_policy_change_cb callback,
+                            void *user_data) {
+    if (policy == nullptr) {
+        return 0;
+    }
+    std::vector<std::pair<std::string, bool>> changes;
+    {
+        std::lock_guard<std::mutex> guard(policy->lock);
+        for (auto &entry : policy->participants) {
+            participant &p = entry.second;
+            bool desired;
+            bool immediate = false;
+            if (p.video_override != OTK_VIDEO_OVERRIDE_NONE) {
+                desired = p.video_override == OTK_VIDEO_OVERRIDE_ON;
+                immediate = true;
+            } else {
+                desired = p.visible && is_recent_speaker(policy, p);
+            }
+            if (desired == p.subscribed) {
+                p.pending_since_ms = -1;
+                continue;
+            }
+            if (p.pending_since_ms < 0) {
+                p.pending_since_ms = now_ms;
+            }
+            int64_t delay = desired ? policy->config.enable_delay_ms
+                                    : policy->config.disable_delay_ms;
+            if (immediate || now_ms - p.pending_since_ms >= delay) {
+                p.subscribed = desired;
+                p.pending_since_ms = -1;
+                changes.emplace_back(entry.first, desired);
+            }
+        }
+    }
+    if (callback != nullptr) {
+        for (const auto &change : changes) {
+            callback(change.first.c_str(), change.second ? 1 : 0, user_data);
+        }
+    }
+    return (int)changes.size();
+}
+
+int otk_video_policy_is_subscribed(otk_video_policy *policy,
+                                   const char *participant_id) {
+    if (policy == nullptr || participant_id == nullptr) {
+        return 0;
+    }
+    std::lock_guard<std::mutex> guard(policy->lock);
+    auto it = policy->participants.find(participant_id);
+    return it != policy->participants.end() && it->second.subscribed ? 1 : 0;
+}
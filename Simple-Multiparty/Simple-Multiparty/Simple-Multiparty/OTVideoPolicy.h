@@ -0,0 +1,107 @@
+//
+//  OTVideoPolicy.h
+//  Simple-Multiparty
+//
+//  Copyright (c) 2026 Vonage. All rights reserved.
+//
+
+#ifndef OTVideoPolicy_h
+#define OTVideoPolicy_h
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * Decides which subscribers should receive video. A participant gets video
+ * when its view is visible and it is among the most recently active
+ * speakers. Changes only take effect once the new decision has held for a
+ * while, so a window briefly covered or a speaker briefly out-talked does not
+ * make the video flap.
+ */
+typedef struct otk_video_policy otk_video_policy;
+
+typedef struct otk_video_policy_config {
+    /** Number of most recently active speakers that keep video, 0 for all. */
+    uint32_t max_active_videos;
+    /** Audio level (0 to 1, see on_audio_level_updated) that counts as speaking. */
+    float speaking_level;
+    /** How long a participant must qualify before its video is turned back on. */
+    int64_t enable_delay_ms;
+    /** How long a participant must not qualify before its video is turned off. */
+    int64_t disable_delay_ms;
+} otk_video_policy_config;
+
+enum otk_video_override {
+    /** The policy decides. */
+    OTK_VIDEO_OVERRIDE_NONE = 0,
+    /** Always subscribe to video. */
+    OTK_VIDEO_OVERRIDE_ON = 1,
+    /** Never subscribe to video. */
+    OTK_VIDEO_OVERRIDE_OFF = 2,
+};
+
+/**
+ * Called from otk_video_policy_update for every participant whose video
+ * subscription should change.
+ */
+typedef void (*otk_video_policy_change_cb)(const char *participant_id,
+                                           int subscribe_to_video,
+                                           void *user_data);
+
+/** Fills config with the defaults used by the sample. */
+void otk_video_policy_config_default(otk_video_policy_config *config);
+
+otk_video_policy *otk_video_policy_new(const otk_video_policy_config *config);
+
+void otk_video_policy_delete(otk_video_policy *policy);
+
+/** Monotonic clock in milliseconds, for the now_ms arguments below. */
+int64_t otk_video_policy_now_ms(void);
+
+/**
+ * Adds a participant. It starts visible and subscribed to video, which is
+ * how otc_subscriber_new leaves a new subscriber.
+ */
+void otk_video_policy_add(otk_video_policy *policy,
+                          const char *participant_id,
+                          int64_t now_ms);
+
+void otk_video_policy_remove(otk_video_policy *policy,
+                             const char *participant_id);
+
+void otk_video_policy_set_visible(otk_video_policy *policy,
+                                  const char *participant_id,
+                                  int visible);
+
+void otk_video_policy_set_audio_level(otk_video_policy *policy,
+                                      const char *participant_id,
+                                      float audio_level,
+                                      int64_t now_ms);
+
+/** Overrides take effect on the next update, without the delay. */
+void otk_video_policy_set_override(otk_video_policy *policy,
+                                   const char *participant_id,
+                                   enum otk_video_override video_override);
+
+/**
+ * Re-evaluates every participant and reports the changes through callback.
+ * The callback is invoked without the policy lock held.
+ * Returns the number of changes.
+ */
+int otk_video_policy_update(otk_video_policy *policy,
+                            int64_t now_ms,
+                            otk_video_policy_change_cb callback,
+                            void *user_data);
+
+/** Returns 1 if the participant is currently meant to receive video. */
+int otk_video_policy_is_subscribed(otk_video_policy *policy,
+                                   const char *participant_id);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* OTVideoPolicy_h */
@@ -9,6 +9,60 @@
 #import <OpenTok/opentok.h>
 #import "OTMTLVideoView.h"
 #import "OTSubscriberWindow.h"
+#import "OTVideoPolicy.h"
+#import "OTStreamStats.h"
+#import "OTReconnectTracker.h"
+#import "OTSessionTrace.h"
+#import "OTFrameExport.h"
+#import "OTRuntime.h"
+#import <stdatomic.h>
+
+// Set to 0 to keep video on for every subscriber regardless of visibility
+// and speaker activity
+#define OT_ENABLE_VIDEO_POLICY 1
+#define kVideoPolicyUpdateInterval 0.25
+
+// Set to 1 to present subscriber frames at the pace of their timestamps
+// instead of as soon as they arrive, at the cost of up to 100 ms of delay
+#define OT_ENABLE_JITTER_BUFFER 0
+
+// Set to 0 to copy frames at full resolution even into small views
+#define OT_ENABLE_DOWNSCALE_ON_INTAKE 1
+
+// Set to 0 to stop collecting bitrate, packet loss and frame rate per stream.
+// Snapshots are written to the temporary directory as stream-stats.json and
+// stream-stats.prom
+#define OT_ENABLE_STREAM_STATS 1
+#define kMaxStatsStreams 64
+#define kStreamStatsExportInterval 10.0
+
+// Set to 0 to close subscriber windows as soon as their stream drops, even
+// while the session is reconnecting. Otherwise the window, its renderer and
+// its policy entry wait kReconnectGraceSeconds for the stream to come back.
+#define OT_ENABLE_FAST_RECONNECT 1
+#define kReconnectGraceSeconds 10
+#define kReconnectReleaseInterval 1.0
+
+// Set to 1 to record the session and stream callbacks and the subscriber
+// frames to session-trace.bin in the temporary directory
+#define OT_ENABLE_SESSION_TRACE 0
+#define kSessionTraceFrames OTK_TRACE_FRAMES_HASH
+// Set to 1 to replay session-trace.bin into subscriber windows instead of
+// connecting, for repeatable performance runs. A speed of 0 replays as
+// fast as possible
+#define OT_REPLAY_SESSION_TRACE 0
+#define kSessionReplaySpeed 1.0
+#define kSessionTraceFileName @"session-trace.bin"
+
+// Set to 1 to publish each subscriber's frames to a shared memory ring for
+// other processes to read (see OTFrameExport.h). The app is sandboxed, so
+// the prefix has to be an application group of its entitlements followed
+// by a slash
+#define OT_ENABLE_FRAME_EXPORT 0
+#define kFrameExportPrefix "/otk-"
+#define kFrameExportSlots 6
+#define kFrameExportMaxWidth 1920
+#define kFrameExportMaxHeight 1080
 
 // Replace with your OpenTok API key
 static char* const kApiKey = "";
@@ -23,10 +77,24 @@ typedef struct {
     void *view_controller;
 } SessionData;
 
+// The publisher callbacks only get the preview as user data, so the stats
+// and the publisher's slot are kept here.
+static otk_stream_stats *stream_stats = NULL;
+static atomic_int publisher_stats_slot = -1;
+// Used from the session and subscriber callbacks, before they reach the main
+// thread, so the stream events are seen in the order the SDK sends them.
+static otk_reconnect_tracker *reconnect_tracker = NULL;
+static otk_trace_recorder *session_trace = NULL;
+static otk_frame_exporter *frame_exporter = NULL;
+
 @interface ViewController () {
     SessionData *session_data;
     OTMTLVideoView *pubView;
     NSMutableArray<OTSubscriberWindow*> *arraySubscribersView;
+    otk_video_policy *videoPolicy;
+    NSTimer *videoPolicyTimer;
+    NSTimer *streamStatsTimer;
+    NSTimer *reconnectTimer;
 }
 
 @property (nonatomic, assign) BOOL isConnected;
@@ -42,6 +110,47 @@ typedef struct {
 @synthesize muteCamBtn;
 @synthesize muteMicBtn;
 
+static int init_sdk(void *context) {
+    return otc_init(NULL) == OTC_SUCCESS;
+}
+
+// Runs on the main thread from the policy timer.
+static void video_policy_on_change(const char *participant_id, int subscribe_to_video, void *user_data) {
+    ViewController *vc = (__bridge ViewController *)user_data;
+    for (OTSubscriberWindow *subscriberWindow in vc->arraySubscribersView) {
+        if (strcmp(subscriberWindow.streamId.UTF8String, participant_id) == 0) {
+            NSLog(@"Video %s for stream %s", subscribe_to_video ? "enabled" : "disabled", participant_id);
+            // A detached window picks the decision up when it is reattached.
+            if ([subscriberWindow getSubscriber]) {
+                otc_subscriber_set_subscribe_to_video([subscriberWindow getSubscriber],
+                                                      subscribe_to_video ? OTC_TRUE : OTC_FALSE);
+            }
+            break;
+        }
+    }
+}
+
+static void releaseSubscriberWindow(ViewController *vc, NSUInteger index);
+
+// Runs on the main thread for each kept stream that did not come back.
+static void reconnect_on_release(const char *stream_id, void *user_data) {
+    ViewController *vc = (__bridge ViewController *)user_data;
+    for (NSUInteger i = 0; i < vc->arraySubscribersView.count; i++) {
+        if (strcmp(vc->arraySubscribersView[i].streamId.UTF8String, stream_id) == 0) {
+            NSLog(@"Stream %s did not come back after reconnecting", stream_id);
+            releaseSubscriberWindow(vc, i);
+            break;
+        }
+    }
+}
+
+// Collects the kept streams on the SDK thread, for their windows to be
+// released on the main thread.
+static void reconnect_collect_kept(const char *stream_id, void *user_data) {
+    NSMutableArray<NSString *> *kept = (__bridge NSMutableArray<NSString *> *)user_data;
+    [kept addObject:[NSString stringWithUTF8String:stream_id]];
+}
+
 - (void)viewDidLoad {
     [super viewDidLoad];
     [self.view setFrameSize:CGSizeMake(400, 330)];
@@ -50,15 +159,72 @@ typedef struct {
     session_data = calloc(1, sizeof(SessionData));
     session_data->view_controller = (__bridge void *)self;
     
-    otc_init(NULL);
+    // Held for the life of the app: the session and publisher are never
+    // deleted, so the SDK is not destroyed.
+    const otk_runtime_api runtime_api = {NULL, init_sdk, NULL};
+    otk_runtime_acquire(&runtime_api);
+#if OT_ENABLE_STREAM_STATS
+    stream_stats = otk_stream_stats_new(kMaxStatsStreams);
+    streamStatsTimer = [NSTimer scheduledTimerWithTimeInterval:kStreamStatsExportInterval repeats:YES block:^(NSTimer *timer) {
+        exportStreamStats();
+    }];
+#endif
     pubView = [[OTMTLVideoView alloc] initWithFrame:(CGRectMake(40,0,320,240))];
     [self.view addSubview:pubView];
     pubView.wantsLayer = YES;
     pubView.layer.borderWidth = 5;
+#if OT_ENABLE_DOWNSCALE_ON_INTAKE
+    pubView.downscaleOnIntake = YES;
+#endif
     
     setupPublisher(session_data);
     
     arraySubscribersView = [[NSMutableArray alloc] init];
+    
+    __weak ViewController *weakSelf = self;
+#if OT_ENABLE_VIDEO_POLICY
+    videoPolicy = otk_video_policy_new(NULL);
+    videoPolicyTimer = [NSTimer scheduledTimerWithTimeInterval:kVideoPolicyUpdateInterval repeats:YES block:^(NSTimer *timer) {
+        ViewController *vc = weakSelf;
+        if (vc) {
+            otk_video_policy_update(vc->videoPolicy, otk_video_policy_now_ms(),
+                                    video_policy_on_change, (__bridge void *)vc);
+        }
+    }];
+#endif
+#if OT_ENABLE_FAST_RECONNECT
+    reconnect_tracker = otk_reconnect_tracker_new(kReconnectGraceSeconds * 1000);
+    reconnectTimer = [NSTimer scheduledTimerWithTimeInterval:kReconnectReleaseInterval repeats:YES block:^(NSTimer *timer) {
+        ViewController *vc = weakSelf;
+        if (vc) {
+            otk_reconnect_tracker_release_expired(reconnect_tracker, otk_reconnect_tracker_now_ms(),
+                                                  reconnect_on_release, (__bridge void *)vc);
+        }
+    }];
+#endif
+#if OT_ENABLE_FRAME_EXPORT
+    frame_exporter = otk_frame_exporter_new(kFrameExportPrefix, kFrameExportSlots,
+                                            kFrameExportMaxWidth, kFrameExportMaxHeight);
+#endif
+    NSString *tracePath = [NSTemporaryDirectory() stringByAppendingPathComponent:kSessionTraceFileName];
+#if OT_REPLAY_SESSION_TRACE
+    [connectBtn setEnabled:FALSE];
+    startSessionReplay(self, tracePath);
+#elif OT_ENABLE_SESSION_TRACE
+    session_trace = otk_trace_recorder_new(tracePath.UTF8String, kSessionTraceFrames);
+    NSLog(@"Recording session trace to %@", tracePath);
+#endif
+}
+
+- (void)dealloc {
+    [videoPolicyTimer invalidate];
+    otk_video_policy_delete(videoPolicy);
+    [streamStatsTimer invalidate];
+    [reconnectTimer invalidate];
+    otk_trace_recorder_delete(session_trace);
+    session_trace = NULL;
+    otk_frame_exporter_delete(frame_exporter);
+    frame_exporter = NULL;
 }
 - (void) viewWillDisappear {
     for (OTSubscriberWindow* w in arraySubscribersView) {
@@ -71,8 +237,9 @@ typedef struct {
     NSLog(@"Connect Clicked");
     [connectBtn setEnabled:FALSE];
     if (_isConnected){
-        for (OTSubscriberWindow* w in arraySubscribersView) {
-            [w close];
+        // Released like dropped streams, so nothing they hold outlives them.
+        while (arraySubscribersView.count > 0) {
+            releaseSubscriberWindow(self, arraySubscribersView.count - 1);
         }
         otc_session_disconnect(session_data->session);
     }
@@ -110,6 +277,21 @@ typedef struct {
     }
 }
 
+static void writeStreamStats(size_t (*export_stats)(otk_stream_stats *, int64_t, char *, size_t),
+                             NSString *fileName) {
+    int64_t now = otk_stream_stats_now_ms();
+    NSMutableData *data = [NSMutableData dataWithLength:export_stats(stream_stats, now, NULL, 0) + 1];
+    size_t length = export_stats(stream_stats, now, data.mutableBytes, data.length);
+    data.length = MIN(length, data.length - 1);
+    NSString *path = [NSTemporaryDirectory() stringByAppendingPathComponent:fileName];
+    [data writeToFile:path atomically:YES];
+}
+
+void exportStreamStats(void) {
+    writeStreamStats(otk_stream_stats_export_json, @"stream-stats.json");
+    writeStreamStats(otk_stream_stats_export_prometheus, @"stream-stats.prom");
+}
+
 void session_logger_func(const char* message) {
     NSLog(@"%s",message);
 }
@@ -152,6 +334,8 @@ void session_on_connected(otc_session *session, void *user_data) {
     SessionData *session_data = (SessionData *)user_data;
     ViewController *vc = (__bridge ViewController *)session_data->view_controller;
     vc.isConnected = YES;
+    otk_reconnect_tracker_on_connected(reconnect_tracker);
+    otk_trace_record_session(session_trace, OTK_TRACE_CONNECTED);
     dispatch_async(dispatch_get_main_queue(), ^{
         [vc.statusLbl setStringValue:@"Connected"];
         [vc.connectBtn setEnabled:TRUE];
@@ -163,6 +347,7 @@ void session_on_connected(otc_session *session, void *user_data) {
 
 void session_on_disconnected(otc_session *session, void *user_data) {
     NSLog(@"Session Disconnected");
+    otk_trace_record_session(session_trace, OTK_TRACE_DISCONNECTED);
     SessionData *session_data = (SessionData *)user_data;
     ViewController *vc = (__bridge ViewController *)session_data->view_controller;
     dispatch_async(dispatch_get_main_queue(), ^{
@@ -173,6 +358,17 @@ void session_on_disconnected(otc_session *session, void *user_data) {
         //subscriberView.hidden = TRUE;
     });
     vc.isConnected = NO;
+    // The tracker is told here, in order with the other session callbacks;
+    // only the windows of the streams it kept are released on the main thread.
+    NSMutableArray<NSString *> *kept = [NSMutableArray array];
+    otk_reconnect_tracker_on_disconnected(reconnect_tracker, reconnect_collect_kept, (__bridge void *)kept);
+    if (kept.count > 0) {
+        dispatch_async(dispatch_get_main_queue(), ^{
+            for (NSString *stream_id in kept) {
+                reconnect_on_release(stream_id.UTF8String, (__bridge void *)vc);
+            }
+        });
+    }
 }
 
 void on_connection_created(otc_session *session, void *user_data, const otc_connection *connection)
@@ -185,30 +381,64 @@ void on_connection_dropped(otc_session *session, void *user_data, const otc_conn
     NSLog(@"Connection Destroyed");
 }
 
+static OTSubscriberWindow *newSubscriberWindow(ViewController *vc, const char *stream_id) {
+    OTSubscriberWindow *subscriberWindow = [[OTSubscriberWindow alloc] initWithWindowNibName:@"OTSubscriberWindow"];
+    subscriberWindow.shouldCascadeWindows = YES;
+    [subscriberWindow loadWindow];
+    subscriberWindow.videoView.wantsLayer = YES;
+    subscriberWindow.videoView.layer.borderWidth = 5;
+    subscriberWindow.videoView.hidden = NO;
+    subscriberWindow.videoPolicy = vc->videoPolicy;
+#if OT_ENABLE_JITTER_BUFFER
+    subscriberWindow.videoView.jitterBufferEnabled = YES;
+#endif
+#if OT_ENABLE_DOWNSCALE_ON_INTAKE
+    subscriberWindow.videoView.downscaleOnIntake = YES;
+#endif
+    
+    subscriberWindow.statsSlot = otk_stream_stats_add(stream_stats, stream_id,
+                                                      OTK_STREAM_SUBSCRIBER,
+                                                      otk_stream_stats_now_ms());
+    if (frame_exporter) {
+        char ring_name[OTK_FRAME_RING_NAME_SIZE];
+        otk_frame_ring_name(kFrameExportPrefix, stream_id, ring_name);
+        if (otk_frame_exporter_add_stream(frame_exporter, stream_id)) {
+            NSLog(@"Exporting frames of stream %s to %s", stream_id, ring_name);
+        } else {
+            NSLog(@"Could not create %s to export frames of stream %s", ring_name, stream_id);
+        }
+    }
+    return subscriberWindow;
+}
+
 void session_on_stream_received(otc_session *session, void *user_data, const otc_stream *stream) {
     NSLog(@"Stream Received");
     
     SessionData *session_data = (SessionData *)user_data;
     ViewController *vc = (__bridge ViewController *)session_data->view_controller;
     otc_stream *strcpy = otc_stream_copy(stream);
+    otk_trace_record_stream_received(session_trace, otc_stream_get_id(stream));
+    enum otk_stream_attach_action action =
+        otk_reconnect_tracker_on_stream_received(reconnect_tracker, otc_stream_get_id(stream),
+                                                 otk_reconnect_tracker_now_ms());
 
     dispatch_async(dispatch_get_main_queue(), ^{
+        if (action == OTK_STREAM_REATTACH) {
+            for (OTSubscriberWindow *subscriberWindow in vc->arraySubscribersView) {
+                if (strcmp(subscriberWindow.streamId.UTF8String, otc_stream_get_id(strcpy)) == 0) {
+                    NSLog(@"Reattaching stream %@", subscriberWindow.streamId);
+                    struct otc_subscriber_callbacks callbacks = subscriberCallbacks(subscriberWindow);
+                    otc_subscriber *subscriber = otc_subscriber_new(strcpy, &callbacks);
+                    otc_session_subscribe(session, subscriber);
+                    [subscriberWindow reattachSubscriber:subscriber];
+                    otc_stream_delete(strcpy);
+                    return;
+                }
+            }
+        }
         
-        OTSubscriberWindow *subscriberWindow = [[OTSubscriberWindow alloc] initWithWindowNibName:@"OTSubscriberWindow"];
-        subscriberWindow.shouldCascadeWindows = YES;
-        [subscriberWindow loadWindow];
-        subscriberWindow.videoView.wantsLayer = YES;
-        subscriberWindow.videoView.layer.borderWidth = 5;
-        subscriberWindow.videoView.hidden = NO;
-        
-        struct otc_subscriber_callbacks callbacks = {0};
-        callbacks.on_video_data_received = subscriber_on_video_data_received;
-        callbacks.on_render_frame = subscriber_on_render_frame;
-        callbacks.on_connected = subscriber_on_connected;
-        callbacks.on_disconnected = subscriber_on_disconnected;
-        callbacks.on_video_disabled = subscriber_on_video_disabled;
-        callbacks.on_video_enabled = subscriber_on_video_enabled;
-        callbacks.user_data = (__bridge void*)subscriberWindow.videoView;
+        OTSubscriberWindow *subscriberWindow = newSubscriberWindow(vc, otc_stream_get_id(strcpy));
+        struct otc_subscriber_callbacks callbacks = subscriberCallbacks(subscriberWindow);
         otc_subscriber *subscriber = otc_subscriber_new(strcpy, &callbacks);
         otc_session_subscribe(session, subscriber);
         
@@ -220,32 +450,90 @@ void session_on_stream_received(otc_session *session, void *user_data, const otc
     });
 }
 
+static struct otc_subscriber_callbacks subscriberCallbacks(OTSubscriberWindow *subscriberWindow) {
+    struct otc_subscriber_callbacks callbacks = {0};
+    callbacks.on_video_data_received = subscriber_on_video_data_received;
+    callbacks.on_render_frame = subscriber_on_render_frame;
+    callbacks.on_connected = subscriber_on_connected;
+    callbacks.on_disconnected = subscriber_on_disconnected;
+    callbacks.on_video_disabled = subscriber_on_video_disabled;
+    callbacks.on_video_enabled = subscriber_on_video_enabled;
+    callbacks.on_audio_level_updated = subscriber_on_audio_level_updated;
+    callbacks.on_video_stats = subscriber_on_video_stats;
+    callbacks.on_audio_stats = subscriber_on_audio_stats;
+    callbacks.user_data = (__bridge void*)subscriberWindow;
+    return callbacks;
+}
+
+static void releaseSubscriberWindow(ViewController *vc, NSUInteger index) {
+    OTSubscriberWindow *subscriberWindow = [vc->arraySubscribersView objectAtIndex:index];
+    otc_subscriber *subscriber_to_delete = [subscriberWindow getSubscriber];
+    if (subscriber_to_delete) {
+        otc_session_unsubscribe(vc->session_data->session, subscriber_to_delete);
+    }
+    otk_video_policy_remove(vc->videoPolicy, subscriberWindow.streamId.UTF8String);
+    otk_stream_stats_remove(stream_stats, subscriberWindow.statsSlot);
+    otk_frame_export_stats exported;
+    if (otk_frame_exporter_get_stats(frame_exporter, subscriberWindow.streamId.UTF8String, &exported)) {
+        NSLog(@"Frame export for stream %@: %llu frames, %.1f MB, %llu too large",
+              subscriberWindow.streamId, exported.frames, exported.bytes / 1e6, exported.too_large);
+        otk_frame_exporter_remove_stream(frame_exporter, subscriberWindow.streamId.UTF8String);
+    }
+    if (subscriberWindow.videoView.jitterBufferEnabled) {
+        otk_jitter_buffer_stats stats = [subscriberWindow.videoView jitterBufferStats];
+        NSLog(@"Jitter buffer for stream %@: %llu presented, %llu dropped, "
+              "delay %.1f ms, jitter p95 %.1f ms, added latency %.1f ms, judder %.1f ms",
+              subscriberWindow.streamId, stats.frames_presented, stats.frames_dropped,
+              stats.target_delay_us / 1000.0, stats.jitter_p95_us / 1000.0,
+              stats.average_added_latency_us / 1000.0, stats.average_judder_us / 1000.0);
+    }
+    otk_frame_intake_stats intake = [subscriberWindow.videoView intakeStats];
+    NSLog(@"Frame intake for stream %@: %llu copied, %llu skipped while hidden "
+          "(%.1f MB not copied), %llu resumes",
+          subscriberWindow.streamId, intake.frames_copied, intake.frames_skipped,
+          intake.bytes_skipped / 1e6, intake.resumes);
+    if (subscriberWindow.videoView.downscaleOnIntake) {
+        otk_frame_scaler_stats scaler = [subscriberWindow.videoView downscaleStats];
+        NSLog(@"Downscale on intake for stream %@: %llu frames, %.1f MB copied "
+              "instead of %.1f MB, %llu buffers allocated",
+              subscriberWindow.streamId, scaler.frames_scaled, scaler.bytes_out / 1e6,
+              scaler.bytes_in / 1e6, scaler.buffers_allocated);
+    }
+    [subscriberWindow close];
+    [vc->arraySubscribersView removeObjectAtIndex:index];
+}
+
 void session_on_stream_dropped(otc_session *session, void *user_data, const otc_stream *stream) {
     NSLog(@"Stream Dropped");
     
     SessionData *session_data = (SessionData *)user_data;
     ViewController *vc = (__bridge ViewController *)session_data->view_controller;
     otc_stream *strcpy = otc_stream_copy(stream);
+    otk_trace_record_stream_dropped(session_trace, otc_stream_get_id(stream));
+    enum otk_stream_drop_action action =
+        otk_reconnect_tracker_on_stream_dropped(reconnect_tracker, otc_stream_get_id(stream),
+                                                otk_reconnect_tracker_now_ms());
 
     dispatch_async(dispatch_get_main_queue(), ^{
         int indexToDelete = -1;
         const char* stream_id = otc_stream_get_id(strcpy);
+        // Matched by the window's stream id, a detached window has no subscriber.
         for (int i=0; i<[vc->arraySubscribersView count]; i++) {
             OTSubscriberWindow *subscriberWindow = [vc->arraySubscribersView objectAtIndex:i];
-            otc_subscriber *subscriber = [subscriberWindow getSubscriber];
-            otc_stream *sub_stream = otc_subscriber_get_stream(subscriber);
-            const char* sub_stream_id = otc_stream_get_id(sub_stream);
-            if (strcmp(sub_stream_id, stream_id) == 0) {
+            if (strcmp(subscriberWindow.streamId.UTF8String, stream_id) == 0) {
                 indexToDelete = i;
                 break;
             }
         }
-        if (indexToDelete > -1) {
+        if (indexToDelete > -1 && action == OTK_STREAM_KEEP) {
             OTSubscriberWindow *subscriberWindow = [vc->arraySubscribersView objectAtIndex:indexToDelete];
-            otc_subscriber *subscriber_to_delete = [subscriberWindow getSubscriber];
-            otc_session_unsubscribe(session, subscriber_to_delete);
-            [subscriberWindow close];
-            [vc->arraySubscribersView removeObjectAtIndex:indexToDelete];
+            NSLog(@"Keeping stream %@ while reconnecting", subscriberWindow.streamId);
+            if ([subscriberWindow getSubscriber]) {
+                otc_session_unsubscribe(session, [subscriberWindow getSubscriber]);
+                [subscriberWindow detachSubscriber];
+            }
+        } else if (indexToDelete > -1) {
+            releaseSubscriberWindow(vc, indexToDelete);
         }
         otc_stream_delete(strcpy);
     });
@@ -253,6 +541,7 @@ void session_on_stream_dropped(otc_session *session, void *user_data, const otc_
 
 void session_on_error(otc_session *session, void *user_data, const char * msg, enum otc_session_error_code error_code) {
     NSLog(@"Connection Error: %s, code=%d",msg,error_code);
+    otk_trace_record_session(session_trace, OTK_TRACE_ERROR);
 }
 
 void session_on_signal_received(otc_session *session, void *user_data, const char *type, const char *signal,
@@ -261,11 +550,28 @@ void session_on_signal_received(otc_session *session, void *user_data, const cha
 }
 
 void session_on_reconnect_start(otc_session *session, void *user_data) {
-
+    NSLog(@"Session Reconnecting");
+    otk_trace_record_session(session_trace, OTK_TRACE_RECONNECTING);
+    SessionData *session_data = (SessionData *)user_data;
+    ViewController *vc = (__bridge ViewController *)session_data->view_controller;
+    otk_reconnect_tracker_on_reconnecting(reconnect_tracker, otk_reconnect_tracker_now_ms());
+    dispatch_async(dispatch_get_main_queue(), ^{
+        [vc.statusLbl setStringValue:@"Reconnecting..."];
+    });
 }
 
 void session_on_reconnect_succeess(otc_session *session, void *user_data) {
-
+    SessionData *session_data = (SessionData *)user_data;
+    ViewController *vc = (__bridge ViewController *)session_data->view_controller;
+    otk_reconnect_tracker_on_reconnected(reconnect_tracker, otk_reconnect_tracker_now_ms());
+    otk_trace_record_session(session_trace, OTK_TRACE_RECONNECTED);
+    otk_reconnect_stats stats;
+    otk_reconnect_tracker_get_stats(reconnect_tracker, &stats);
+    NSLog(@"Session Reconnected in %lld ms (%u reconnections, average %lld ms)",
+          stats.last_reconnect_ms, stats.reconnections, stats.average_reconnect_ms);
+    dispatch_async(dispatch_get_main_queue(), ^{
+        [vc.statusLbl setStringValue:@"Connected"];
+    });
 }
 
 void session_on_mute_forced(otc_session *session, void *user_data, otc_on_mute_forced_info *mute_info) {
@@ -280,31 +586,124 @@ void setupPublisher(void *user_data) {
     publisher_callbacks.on_render_frame = publisher_on_render_frame;
     publisher_callbacks.user_data = (__bridge void*)vc->pubView;
     publisher_callbacks.on_stream_destroyed = publisher_on_stream_destroyed;
+    publisher_callbacks.on_video_stats = publisher_on_video_stats;
+    publisher_callbacks.on_audio_stats = publisher_on_audio_stats;
     
     session_data->publisher = otc_publisher_new("Mac Publisher", NULL, &publisher_callbacks);
     NSLog(@"Publisher created : %p", session_data->publisher);
 }
 
 void publisher_on_stream_created(otc_publisher *publisher, void *user_data, const otc_stream *stream) {
-    
+    atomic_store(&publisher_stats_slot,
+                 otk_stream_stats_add(stream_stats, otc_stream_get_id(stream),
+                                      OTK_STREAM_PUBLISHER, otk_stream_stats_now_ms()));
 }
 
 void publisher_on_stream_destroyed(otc_publisher *publisher, void *user_data, const otc_stream *stream){
-    
+    otk_stream_stats_remove(stream_stats, atomic_exchange(&publisher_stats_slot, -1));
 }
 
 static void publisher_on_render_frame(otc_publisher *publisher, void *user_data, const otc_video_frame *frame) {
     OTMTLVideoView *videoView = (__bridge OTMTLVideoView *)user_data;
     [videoView renderVideoFrame:(otc_video_frame*)frame];
+    otk_stream_stats_add_frame(stream_stats, atomic_load(&publisher_stats_slot),
+                               otk_stream_stats_now_ms());
+}
+
+// The publisher reports one entry per subscriber connection (one when routed);
+// they are added up into a single stream.
+static void publisher_on_video_stats(otc_publisher *publisher, void *user_data,
+                                     struct otc_publisher_video_stats video_stats[],
+                                     size_t number_of_stats) {
+    int64_t packets = 0, packets_lost = 0, bytes = 0;
+    for (size_t i = 0; i < number_of_stats; i++) {
+        packets += video_stats[i].packets_sent;
+        packets_lost += video_stats[i].packets_lost;
+        bytes += video_stats[i].bytes_sent;
+    }
+    otk_stream_stats_add_counters(stream_stats, atomic_load(&publisher_stats_slot), OTK_STREAM_VIDEO,
+                                  packets, packets_lost, bytes, otk_stream_stats_now_ms());
+}
+
+static void publisher_on_audio_stats(otc_publisher *publisher, void *user_data,
+                                     struct otc_publisher_audio_stats audio_stats[],
+                                     size_t number_of_stats) {
+    int64_t packets = 0, packets_lost = 0, bytes = 0;
+    for (size_t i = 0; i < number_of_stats; i++) {
+        packets += audio_stats[i].packets_sent;
+        packets_lost += audio_stats[i].packets_lost;
+        bytes += audio_stats[i].bytes_sent;
+    }
+    otk_stream_stats_add_counters(stream_stats, atomic_load(&publisher_stats_slot), OTK_STREAM_AUDIO,
+                                  packets, packets_lost, bytes, otk_stream_stats_now_ms());
 }
 
 static void subscriber_on_video_data_received(otc_subscriber* subscriber, void* user_data) {
     
 }
 
+// Returns NO for frames that are not I420.
+static BOOL getI420Planes(const otc_video_frame *frame, const uint8_t *planes[3], int strides[3]) {
+    if (otc_video_frame_get_format(frame) != OTC_VIDEO_FRAME_FORMAT_YUV420P) {
+        return NO;
+    }
+    const enum otc_video_frame_plane plane_ids[3] = {
+        OTC_VIDEO_FRAME_PLANE_Y, OTC_VIDEO_FRAME_PLANE_U, OTC_VIDEO_FRAME_PLANE_V
+    };
+    for (int i = 0; i < 3; i++) {
+        planes[i] = otc_video_frame_get_plane_binary_data(frame, plane_ids[i]);
+        strides[i] = otc_video_frame_get_plane_stride(frame, plane_ids[i]);
+    }
+    return YES;
+}
+
+// Shared by the subscriber callback and the trace replay.
+static void renderSubscriberFrame(OTSubscriberWindow *subscriberWindow, const char *stream_id,
+                                  const otc_video_frame *frame) {
+    [subscriberWindow.videoView renderVideoFrame:(otc_video_frame*)frame];
+    otk_stream_stats_add_frame(stream_stats, subscriberWindow.statsSlot, otk_stream_stats_now_ms());
+    otk_reconnect_tracker_on_frame(reconnect_tracker, stream_id, otk_reconnect_tracker_now_ms());
+    const uint8_t *planes[3];
+    int strides[3];
+    if (frame_exporter && getI420Planes(frame, planes, strides)) {
+        otk_frame_exporter_write(frame_exporter, stream_id, otc_video_frame_get_timestamp(frame),
+                                 otc_video_frame_get_width(frame), otc_video_frame_get_height(frame),
+                                 planes, strides);
+    }
+}
+
 static void subscriber_on_render_frame(otc_subscriber *subscriber, void *user_data, const otc_video_frame *frame) {
-    OTMTLVideoView *videoView = (__bridge OTMTLVideoView *)user_data;
-    [videoView renderVideoFrame:(otc_video_frame*)frame];
+    OTSubscriberWindow *subscriberWindow = (__bridge OTSubscriberWindow *)user_data;
+    const char *stream_id = otc_stream_get_id(otc_subscriber_get_stream(subscriber));
+    renderSubscriberFrame(subscriberWindow, stream_id, frame);
+    const uint8_t *planes[3];
+    int strides[3];
+    if (session_trace && getI420Planes(frame, planes, strides)) {
+        otk_trace_record_frame(session_trace, stream_id, otc_video_frame_get_timestamp(frame),
+                               otc_video_frame_get_width(frame), otc_video_frame_get_height(frame),
+                               planes, strides);
+    }
+}
+
+static void subscriber_on_video_stats(otc_subscriber *subscriber, void *user_data,
+                                      struct otc_subscriber_video_stats video_stats) {
+    OTSubscriberWindow *subscriberWindow = (__bridge OTSubscriberWindow *)user_data;
+    otk_stream_stats_add_counters(stream_stats, subscriberWindow.statsSlot, OTK_STREAM_VIDEO,
+                                  video_stats.packets_received, video_stats.packets_lost,
+                                  video_stats.bytes_received, otk_stream_stats_now_ms());
+}
+
+static void subscriber_on_audio_stats(otc_subscriber *subscriber, void *user_data,
+                                      struct otc_subscriber_audio_stats audio_stats) {
+    OTSubscriberWindow *subscriberWindow = (__bridge OTSubscriberWindow *)user_data;
+    otk_stream_stats_add_counters(stream_stats, subscriberWindow.statsSlot, OTK_STREAM_AUDIO,
+                                  audio_stats.packets_received, audio_stats.packets_lost,
+                                  audio_stats.bytes_received, otk_stream_stats_now_ms());
+}
+
+static void subscriber_on_audio_level_updated(otc_subscriber *subscriber, void *user_data, float audio_level) {
+    OTSubscriberWindow *subscriberWindow = (__bridge OTSubscriberWindow *)user_data;
+    [subscriberWindow audioLevelUpdated:audio_level];
 }
 
 static void subscriber_on_video_disabled(otc_subscriber* subscriber, void *user_data, enum otc_video_reason reason) {
@@ -323,6 +722,105 @@ static void subscriber_on_disconnected(otc_subscriber *subscriber, void *user_da
     NSLog(@"subscriber_on_disconnected");
 }
 
+#pragma mark -
+#pragma mark Session trace replay
+
+// Windows of the replayed streams, only used on the replay thread.
+static NSMutableDictionary<NSString *, OTSubscriberWindow *> *replayed_windows = nil;
+
+static void replay_on_session_event(void *user_data, otk_trace_session_event event) {
+    NSLog(@"Replayed session event %d", event);
+}
+
+static void replay_on_stream_received(void *user_data, const char *stream_id) {
+    ViewController *vc = (__bridge ViewController *)user_data;
+    NSString *streamId = [NSString stringWithUTF8String:stream_id];
+    __block OTSubscriberWindow *subscriberWindow = nil;
+    dispatch_sync(dispatch_get_main_queue(), ^{
+        subscriberWindow = newSubscriberWindow(vc, stream_id);
+        [subscriberWindow setReplayedStreamId:streamId];
+        [vc->arraySubscribersView addObject:subscriberWindow];
+        [subscriberWindow showWindow:vc];
+    });
+    replayed_windows[streamId] = subscriberWindow;
+}
+
+static void replay_on_stream_dropped(void *user_data, const char *stream_id) {
+    ViewController *vc = (__bridge ViewController *)user_data;
+    NSString *streamId = [NSString stringWithUTF8String:stream_id];
+    OTSubscriberWindow *subscriberWindow = replayed_windows[streamId];
+    if (!subscriberWindow) {
+        return;
+    }
+    [replayed_windows removeObjectForKey:streamId];
+    dispatch_sync(dispatch_get_main_queue(), ^{
+        NSUInteger index = [vc->arraySubscribersView indexOfObject:subscriberWindow];
+        if (index != NSNotFound) {
+            releaseSubscriberWindow(vc, index);
+        }
+    });
+}
+
+static const uint8_t *replayed_frame_get_plane(void *user_data, enum otc_video_frame_plane plane) {
+    return ((const otk_trace_frame *)user_data)->planes[plane];
+}
+
+static int replayed_frame_get_plane_stride(void *user_data, enum otc_video_frame_plane plane) {
+    return ((const otk_trace_frame *)user_data)->strides[plane];
+}
+
+static void replayed_frame_release(void *user_data) {
+}
+
+static void replay_on_frame(void *user_data, const char *stream_id, const otk_trace_frame *trace_frame) {
+    OTSubscriberWindow *subscriberWindow = replayed_windows[[NSString stringWithUTF8String:stream_id]];
+    if (!subscriberWindow) {
+        return;
+    }
+    // The planes are only valid during the callback; copies of the frame
+    // must not share them.
+    struct otc_video_frame_planar_memory_callbacks cb = {0};
+    cb.user_data = (void *)trace_frame;
+    cb.get_plane = replayed_frame_get_plane;
+    cb.get_plane_stride = replayed_frame_get_plane_stride;
+    cb.release = replayed_frame_release;
+    otc_video_frame *frame =
+        otc_video_frame_new_planar_memory_wrapper(OTC_VIDEO_FRAME_FORMAT_YUV420P,
+                                                  trace_frame->width,
+                                                  trace_frame->height,
+                                                  OTC_FALSE,
+                                                  &cb);
+    otc_video_frame_set_timestamp(frame, trace_frame->timestamp);
+    renderSubscriberFrame(subscriberWindow, stream_id, frame);
+    otc_video_frame_delete(frame);
+}
+
+void startSessionReplay(ViewController *vc, NSString *path) {
+    otk_trace_replay *replay = otk_trace_replay_open(path.UTF8String);
+    if (!replay) {
+        NSLog(@"Could not open session trace %@", path);
+        return;
+    }
+    replayed_windows = [NSMutableDictionary dictionary];
+    dispatch_async(dispatch_get_global_queue(QOS_CLASS_USER_INTERACTIVE, 0), ^{
+        otk_trace_replay_callbacks callbacks = {0};
+        callbacks.user_data = (__bridge void *)vc;
+        callbacks.on_session_event = replay_on_session_event;
+        callbacks.on_stream_received = replay_on_stream_received;
+        callbacks.on_stream_dropped = replay_on_stream_dropped;
+        callbacks.on_frame = replay_on_frame;
+        int result = otk_trace_replay_run(replay, &callbacks, kSessionReplaySpeed);
+        otk_trace_replay_stats stats;
+        otk_trace_replay_get_stats(replay, &stats);
+        NSLog(@"Replayed %@%s: %llu events, %llu frames, %.1f s recorded in %.1f s, "
+              "%llu events late, at most %.1f ms",
+              path, result == 0 ? "" : " up to a malformed record",
+              stats.events, stats.frames, stats.recorded_us / 1e6, stats.elapsed_us / 1e6,
+              stats.late_events, stats.max_late_us / 1000.0);
+        otk_trace_replay_delete(replay);
+    });
+}
+
 - (void)setRepresentedObject:(id)representedObject {
     [super setRepresentedObject:representedObject];
 }
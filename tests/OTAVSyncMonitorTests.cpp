@@ -0,0 +1,172 @@
+//
+//  OTAVSyncMonitorTests.cpp
+//  tests
+//
+//  Copyright (c) 2026 Vonage. All rights reserved.
+//
+
+#include "OTAVSyncMonitor.h"
+#include "OTTest.h"
+
+#include <atomic>
+#include <random>
+#include <thread>
+
+// Audio every 10 ms, heard audio_delay_ms after its timestamp, and video
+// at 30 fps, shown video_delay_ms after its timestamp, from start on.
+static void play(otk_av_sync_monitor *monitor, const char *stream_id, bool own_audio, double start,
+                 double seconds, double audio_delay_ms, double video_delay_ms, double jitter_ms,
+                 std::mt19937 &random) {
+    std::normal_distribution<double> jitter(0, jitter_ms);
+    double next_video = start;
+    for (double t = start; t < start + seconds; t += 0.010) {
+        otk_av_sync_monitor_audio(monitor, own_audio ? stream_id : nullptr, std::llround(t * 1e6),
+                                  std::llround((t + audio_delay_ms / 1e3) * 1e9 + jitter(random) * 1e6));
+        for (; next_video <= t; next_video += 1.0 / 30) {
+            otk_av_sync_monitor_video(monitor, stream_id, std::llround(next_video * 1e6),
+                                      std::llround((next_video + video_delay_ms / 1e3) * 1e9 + jitter(random) * 1e6));
+        }
+    }
+}
+
+// Mixed audio heard 60 ms after its timestamp while the video delay moves
+// in and out of the range viewers notice.
+static void test_skew_and_sync_range() {
+    std::mt19937 random(1);
+    otk_av_sync_monitor *monitor = otk_av_sync_monitor_new();
+    otk_av_sync_stats stats;
+    OTK_CHECK(!otk_av_sync_monitor_get_stats(monitor, "a", &stats));
+    OTK_CHECK(otk_av_sync_monitor_add_stream(monitor, "a"));
+    OTK_CHECK(otk_av_sync_monitor_add_stream(monitor, "b"));
+
+    play(monitor, "a", false, 0, 10, 60, 70, 2, random);
+    otk_av_sync_monitor_get_stats(monitor, "a", &stats);
+    OTK_CHECK_NEAR(stats.p50_ms, 10, 0.5);
+    OTK_CHECK_NEAR(stats.mean_ms, 10, 0.5);
+    OTK_CHECK(stats.p5_ms < stats.p50_ms && stats.p95_ms > stats.p50_ms);
+    OTK_CHECK(stats.frames == 300);
+    OTK_CHECK(!stats.out_of_sync && stats.out_of_sync_events == 0);
+    // No video on b.
+    otk_av_sync_monitor_get_stats(monitor, "b", &stats);
+    OTK_CHECK(stats.frames == 0);
+
+    // Video 80 ms late is out of sync...
+    play(monitor, "a", false, 10, 10, 60, 140, 2, random);
+    otk_av_sync_monitor_get_stats(monitor, "a", &stats);
+    OTK_CHECK_NEAR(stats.p50_ms, 80, 0.5);
+    OTK_CHECK(stats.out_of_sync && stats.out_of_sync_events == 1);
+    // ...and back in sync once it catches up.
+    play(monitor, "a", false, 20, 10, 60, 60, 2, random);
+    otk_av_sync_monitor_get_stats(monitor, "a", &stats);
+    OTK_CHECK_NEAR(stats.p50_ms, 0, 0.5);
+    OTK_CHECK(!stats.out_of_sync && stats.out_of_sync_events == 1);
+
+    // Video 100 ms early is tolerated, 150 ms is not.
+    play(monitor, "a", false, 30, 10, 160, 60, 2, random);
+    otk_av_sync_monitor_get_stats(monitor, "a", &stats);
+    OTK_CHECK_NEAR(stats.p50_ms, -100, 0.5);
+    OTK_CHECK(!stats.out_of_sync);
+    play(monitor, "a", false, 40, 10, 210, 60, 2, random);
+    otk_av_sync_monitor_get_stats(monitor, "a", &stats);
+    OTK_CHECK_NEAR(stats.p50_ms, -150, 0.5);
+    OTK_CHECK(stats.out_of_sync && stats.out_of_sync_events == 2);
+    otk_av_sync_monitor_delete(monitor);
+}
+
+// A stream's own audio takes precedence over the mix.
+static void test_own_audio() {
+    std::mt19937 random(2);
+    otk_av_sync_monitor *monitor = otk_av_sync_monitor_new();
+    otk_av_sync_monitor_add_stream(monitor, "b");
+    for (double t = 0; t < 5; t += 0.01) {
+        otk_av_sync_monitor_audio(monitor, nullptr, (int64_t)(t * 1e6), (int64_t)(t * 1e9) + 999000000);
+    }
+    play(monitor, "b", true, 0, 5, 20, 50, 0, random);
+    otk_av_sync_stats stats;
+    otk_av_sync_monitor_get_stats(monitor, "b", &stats);
+    OTK_CHECK_NEAR(stats.p50_ms, 30, 0.01);
+    OTK_CHECK_NEAR(stats.p95_ms, 30, 0.01);
+    otk_av_sync_monitor_remove_stream(monitor, "b");
+    OTK_CHECK(!otk_av_sync_monitor_get_stats(monitor, "b", &stats));
+    otk_av_sync_monitor_delete(monitor);
+}
+
+static void test_timelines() {
+    otk_av_sync_monitor *monitor = otk_av_sync_monitor_new();
+    otk_av_sync_monitor_add_stream(monitor, "c");
+    for (int i = 0; i < 100; i++) {
+        otk_av_sync_monitor_audio(monitor, "c", i * 10000, (int64_t)i * 10000000);
+    }
+    // Media timestamps far from the audio's, or heard and shown 5 s apart:
+    // the clocks are not comparable.
+    for (int i = 0; i < 30; i++) {
+        otk_av_sync_monitor_video(monitor, "c", 5000000000LL + i * 33333, (int64_t)i * 33333000);
+    }
+    for (int i = 0; i < 30; i++) {
+        otk_av_sync_monitor_video(monitor, "c", i * 33333, (int64_t)i * 33333000 + 5000000000LL);
+    }
+    otk_av_sync_stats stats;
+    otk_av_sync_monitor_get_stats(monitor, "c", &stats);
+    OTK_CHECK(stats.unmapped == 60 && stats.frames == 0);
+
+    // Audio going back in media time starts a new timeline.
+    for (int i = 0; i < 50; i++) {
+        otk_av_sync_monitor_audio(monitor, "c", 100000 + i * 10000, 7000000000LL + (int64_t)i * 10000000);
+    }
+    otk_av_sync_monitor_video(monitor, "c", 300000, 7200000000LL + 5000000);
+    otk_av_sync_monitor_get_stats(monitor, "c", &stats);
+    OTK_CHECK(stats.frames == 1);
+    OTK_CHECK_NEAR(stats.p50_ms, 5, 1e-6);
+
+    // Sixteen streams at most.
+    int added = 0;
+    for (int i = 0; i < 40; i++) {
+        char stream_id[8];
+        std::snprintf(stream_id, sizeof(stream_id), "s%d", i);
+        added += otk_av_sync_monitor_add_stream(monitor, stream_id);
+    }
+    OTK_CHECK(added == 15);
+    otk_av_sync_monitor_delete(monitor);
+    otk_av_sync_monitor_delete(nullptr);
+}
+
+// Audio, video and readers on their own threads. Video is never dropped;
+// audio may be.
+static void test_threads() {
+    otk_av_sync_monitor *monitor = otk_av_sync_monitor_new();
+    otk_av_sync_monitor_add_stream(monitor, "t");
+    std::atomic<bool> stop(false);
+    std::thread audio([&] {
+        for (int i = 0; i < 200000; i++) {
+            otk_av_sync_monitor_audio(monitor, nullptr, i * 10000LL, i * 10000000LL + 50000000);
+        }
+    });
+    std::thread video([&] {
+        for (int i = 0; i < 60000; i++) {
+            otk_av_sync_monitor_video(monitor, "t", i * 33333LL, i * 33333000LL + 60000000);
+        }
+    });
+    std::thread reader([&] {
+        while (!stop) {
+            otk_av_sync_stats stats;
+            otk_av_sync_monitor_get_stats(monitor, "t", &stats);
+        }
+    });
+    audio.join();
+    video.join();
+    stop = true;
+    reader.join();
+    otk_av_sync_stats stats;
+    otk_av_sync_monitor_get_stats(monitor, "t", &stats);
+    OTK_CHECK(stats.frames + stats.unmapped == 60000);
+    otk_av_sync_monitor_delete(monitor);
+}
+
+int main(int argc, char **argv) {
+    otk_test_init(argc, argv);
+    test_skew_and_sync_range();
+    test_own_audio();
+    test_timelines();
+    test_threads();
+    return otk_test_result();
+}
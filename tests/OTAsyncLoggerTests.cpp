@@ -0,0 +1,208 @@
+//
+//  OTAsyncLoggerTests.cpp
+//  tests
+//
+//  Copyright (c) 2026 Vonage. All rights reserved.
+//
+
+#include "OTAsyncLogger.h"
+#include "OTTest.h"
+
+#include <fstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+// In the directory the test runs in, the build directory under ctest.
+static const char *const kLogPath = "OTAsyncLoggerTests.log";
+
+static void remove_log_files(void) {
+    std::remove(kLogPath);
+    for (int i = 1; i <= 4; i++) {
+        std::remove((std::string(kLogPath) + "." + std::to_string(i)).c_str());
+    }
+}
+
+static std::vector<std::string> read_lines(const std::string &path) {
+    std::vector<std::string> lines;
+    std::ifstream file(path);
+    for (std::string line; std::getline(file, line);) {
+        lines.push_back(line);
+    }
+    return lines;
+}
+
+static bool file_exists(const std::string &path) {
+    return std::ifstream(path).good();
+}
+
+static otk_logger *new_file_logger(uint64_t max_file_bytes, uint32_t max_files, uint32_t ring_capacity) {
+    remove_log_files();
+    otk_logger_config config;
+    otk_logger_config_default(&config);
+    config.path = kLogPath;
+    config.max_file_bytes = max_file_bytes;
+    config.max_files = max_files;
+    config.ring_capacity = ring_capacity;
+    config.flush_interval_ms = 5;
+    return otk_logger_new(&config);
+}
+
+// Every message from every thread is written once, each thread's in order.
+static void test_threads_in_order() {
+    const int threads = 4;
+    const int messages = 5000;
+    otk_logger *logger = new_file_logger(0, 0, messages);
+    std::vector<std::thread> loggers;
+    for (int t = 0; t < threads; t++) {
+        loggers.emplace_back([logger, t] {
+            for (int i = 0; i < messages; i++) {
+                otk_logger_log(logger, OTK_LOG_INFO, "thread %d message %d", t, i);
+            }
+        });
+    }
+    for (std::thread &thread : loggers) {
+        thread.join();
+    }
+    otk_logger_flush(logger);
+    otk_logger_stats stats;
+    otk_logger_get_stats(logger, &stats);
+    OTK_CHECK(stats.messages_written == threads * messages);
+    OTK_CHECK(stats.messages_dropped == 0);
+
+    std::vector<std::string> lines = read_lines(kLogPath);
+    OTK_CHECK(lines.size() == threads * messages);
+    std::vector<int> next(threads, 0);
+    int out_of_order = 0;
+    for (const std::string &line : lines) {
+        int t, i;
+        size_t text = line.find("] thread ");
+        if (text == std::string::npos || std::sscanf(line.c_str() + text, "] thread %d message %d", &t, &i) != 2 ||
+            t < 0 || t >= threads) {
+            out_of_order++;
+            continue;
+        }
+        if (line.find("[INFO]") == std::string::npos || i != next[t]) {
+            out_of_order++;
+        }
+        next[t] = i + 1;
+    }
+    OTK_CHECK(out_of_order == 0);
+    otk_logger_delete(logger);
+}
+
+// A thread that outruns the flusher loses messages rather than waiting, and
+// they are counted.
+static void test_full_ring_drops() {
+    otk_logger *logger = new_file_logger(0, 0, 16);
+    for (int i = 0; i < 10000; i++) {
+        otk_logger_log(logger, OTK_LOG_INFO, "message %d", i);
+    }
+    otk_logger_flush(logger);
+    otk_logger_stats stats;
+    otk_logger_get_stats(logger, &stats);
+    OTK_CHECK(stats.messages_written + stats.messages_dropped == 10000);
+    OTK_CHECK(read_lines(kLogPath).size() == stats.messages_written);
+    otk_logger_delete(logger);
+}
+
+static void test_rotation() {
+    const uint64_t max_file_bytes = 20000;
+    otk_logger *logger = new_file_logger(max_file_bytes, 2, 1024);
+    for (int i = 0; i < 2000; i++) {
+        otk_logger_log(logger, OTK_LOG_WARNING, "message %d", i);
+        if (i % 500 == 0) {
+            otk_logger_flush(logger);
+        }
+    }
+    otk_logger_delete(logger);
+
+    OTK_CHECK(file_exists(kLogPath));
+    OTK_CHECK(file_exists(std::string(kLogPath) + ".1"));
+    OTK_CHECK(file_exists(std::string(kLogPath) + ".2"));
+    OTK_CHECK(!file_exists(std::string(kLogPath) + ".3"));
+    // A file is rotated once it reaches the size, so at most one line over.
+    for (const std::string &path : { std::string(kLogPath), std::string(kLogPath) + ".1" }) {
+        std::ifstream file(path, std::ios::ate);
+        OTK_CHECK((uint64_t)file.tellg() < max_file_bytes + 100);
+    }
+    // The last message is in the current file.
+    std::vector<std::string> lines = read_lines(kLogPath);
+    OTK_CHECK(!lines.empty() && lines.back().find("message 1999") != std::string::npos);
+}
+
+static int evaluated = 0;
+
+static int count_evaluation(void) {
+    return ++evaluated;
+}
+
+static void test_levels_and_truncation() {
+    otk_logger *logger = new_file_logger(0, 0, 64);
+    OTK_LOG(logger, OTK_LOG_DEBUG, "debug %d", count_evaluation());
+    OTK_CHECK(evaluated == 0);
+    otk_logger_set_level(logger, OTK_LOG_DEBUG);
+    OTK_LOG(logger, OTK_LOG_DEBUG, "debug %d", count_evaluation());
+    OTK_CHECK(evaluated == 1);
+    OTK_CHECK(!otk_logger_enabled(logger, OTK_LOG_VERBOSE));
+    OTK_CHECK(!otk_logger_enabled(nullptr, OTK_LOG_ERROR));
+
+    std::string long_text(10000, 'x');
+    otk_logger_log(logger, OTK_LOG_ERROR, "%s", long_text.c_str());
+    otk_logger_delete(logger);
+
+    std::vector<std::string> lines = read_lines(kLogPath);
+    OTK_CHECK(lines.size() == 2);
+    if (lines.size() == 2) {
+        OTK_CHECK(lines[0].find("[DEBUG]") != std::string::npos && lines[0].find("debug 1") != std::string::npos);
+        OTK_CHECK(lines[1].find("[ERROR]") != std::string::npos);
+        OTK_CHECK(lines[1].size() < 300);
+    }
+}
+
+// Nanoseconds of wall time per message, logged from 1 to 8 threads and
+// filtered out.
+static void benchmark_logging() {
+    otk_logger *logger = new_file_logger(0, 0, 4096);
+    for (int threads : { 1, 4, 8 }) {
+        const int messages = 20000;
+        std::vector<std::thread> loggers;
+        int64_t start = otk_test_now_ns();
+        for (int t = 0; t < threads; t++) {
+            loggers.emplace_back([logger, t] {
+                for (int i = 0; i < messages; i++) {
+                    OTK_LOG(logger, OTK_LOG_INFO, "thread %d message %d value %f", t, i, i * 0.5);
+                }
+            });
+        }
+        for (std::thread &thread : loggers) {
+            thread.join();
+        }
+        int64_t logged_ns = otk_test_now_ns() - start;
+        start = otk_test_now_ns();
+        for (int i = 0; i < messages; i++) {
+            OTK_LOG(logger, OTK_LOG_DEBUG, "filtered %d", i);
+        }
+        int64_t filtered_ns = otk_test_now_ns() - start;
+        otk_logger_flush(logger);
+        otk_logger_stats stats;
+        otk_logger_get_stats(logger, &stats);
+        std::printf("%d threads: %.1f ns/message, %.1f ns filtered, %llu dropped so far\n", threads,
+                    (double)logged_ns / (threads * messages), (double)filtered_ns / messages,
+                    (unsigned long long)stats.messages_dropped);
+    }
+    otk_logger_delete(logger);
+}
+
+int main(int argc, char **argv) {
+    otk_test_init(argc, argv);
+    test_threads_in_order();
+    test_full_ring_drops();
+    test_rotation();
+    test_levels_and_truncation();
+    if (otk_test_benchmarking) {
+        benchmark_logging();
+    }
+    remove_log_files();
+    return otk_test_result();
+}
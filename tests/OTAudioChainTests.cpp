@@ -0,0 +1,218 @@
+//
+//  OTAudioChainTests.cpp
+//  tests
+//
+//  Copyright (c) 2026 Vonage. All rights reserved.
+//
+
+#include "OTAudioChain.h"
+#include "OTTest.h"
+
+#include <algorithm>
+#include <atomic>
+#include <random>
+#include <thread>
+#include <vector>
+
+static const int kRate = 48000;
+
+static otk_audio_chain_config no_stages(void) {
+    otk_audio_chain_config config = otk_audio_chain_default_config();
+    config.high_pass_enabled = 0;
+    config.agc_enabled = 0;
+    config.gain_enabled = 0;
+    config.limiter_enabled = 0;
+    return config;
+}
+
+// Level in dBFS of the samples from index from on.
+static double rms_dbfs(const std::vector<float> &samples, size_t from) {
+    double sum = 0;
+    for (size_t i = from; i < samples.size(); i++) {
+        sum += samples[i] * samples[i];
+    }
+    return 10 * std::log10(sum / (samples.size() - from) + 1e-20);
+}
+
+// Processes in 10 ms blocks, as the audio device delivers them.
+static std::vector<float> run(otk_audio_chain *chain, std::vector<float> samples, size_t channels = 1) {
+    size_t block = kRate / 100 * channels;
+    for (size_t i = 0; i + block <= samples.size(); i += block) {
+        otk_audio_chain_process_float(chain, samples.data() + i, block / channels, channels, kRate);
+    }
+    return samples;
+}
+
+static std::vector<float> sine(double frequency, double amplitude, double seconds) {
+    std::vector<float> samples((size_t)(kRate * seconds));
+    for (size_t i = 0; i < samples.size(); i++) {
+        samples[i] = (float)(amplitude * std::sin(2 * M_PI * frequency * i / kRate));
+    }
+    return samples;
+}
+
+// With every stage off, int16 samples come back unchanged.
+static void test_identity() {
+    otk_audio_chain_config config = no_stages();
+    otk_audio_chain *chain = otk_audio_chain_new(&config, 65536, 1);
+    std::vector<int16_t> samples(65536);
+    for (int i = 0; i < 65536; i++) {
+        samples[i] = (int16_t)(i - 32768);
+    }
+    std::vector<int16_t> processed = samples;
+    OTK_CHECK(otk_audio_chain_process_int16(chain, processed.data(), 65536, 1, kRate));
+    OTK_CHECK(processed == samples);
+    // More frames or channels than the chain was made for.
+    OTK_CHECK(!otk_audio_chain_process_int16(chain, processed.data(), 65537, 1, kRate));
+    OTK_CHECK(!otk_audio_chain_process_int16(chain, processed.data(), 10, 2, kRate));
+    otk_audio_chain_delete(chain);
+}
+
+static void test_high_pass() {
+    otk_audio_chain_config config = no_stages();
+    config.high_pass_enabled = 1;
+    otk_audio_chain *chain = otk_audio_chain_new(&config, 480, 1);
+    double input = rms_dbfs(sine(20, 0.5, 1), kRate / 2);
+    OTK_CHECK(rms_dbfs(run(chain, sine(20, 0.5, 1)), kRate / 2) - input < -20);
+    OTK_CHECK_NEAR(rms_dbfs(run(chain, sine(1000, 0.5, 1)), kRate / 2) - input, 0, 0.2);
+    std::vector<float> offset = run(chain, std::vector<float>(kRate, 0.3f));
+    OTK_CHECK(std::fabs(offset.back()) < 1e-3);
+    otk_audio_chain_delete(chain);
+}
+
+// Quiet speech is brought up, loud speech down, and silence left alone.
+static void test_agc() {
+    otk_audio_chain_config config = no_stages();
+    config.agc_enabled = 1;
+    otk_audio_chain *chain = otk_audio_chain_new(&config, 480, 1);
+    OTK_CHECK_NEAR(rms_dbfs(run(chain, sine(440, 0.01 * std::sqrt(2), 5)), kRate * 4), -28, 0.5);
+    otk_audio_chain_delete(chain);
+
+    chain = otk_audio_chain_new(&config, 480, 1);
+    OTK_CHECK_NEAR(rms_dbfs(run(chain, sine(440, 0.316 * std::sqrt(2), 3)), kRate * 2), -20, 0.5);
+    otk_audio_chain_delete(chain);
+
+    chain = otk_audio_chain_new(&config, 480, 1);
+    std::vector<float> gated = sine(440, 0.0001, 3);
+    OTK_CHECK_NEAR(rms_dbfs(run(chain, gated), kRate * 2), rms_dbfs(gated, kRate * 2), 0.1);
+    otk_audio_chain_delete(chain);
+}
+
+static void test_limiter() {
+    otk_audio_chain_config config = no_stages();
+    config.limiter_enabled = 1;
+    otk_audio_chain *chain = otk_audio_chain_new(&config, 480, 2);
+    std::vector<float> loud = sine(300, 3.0, 1);
+    std::vector<float> stereo(loud.size() * 2);
+    for (size_t i = 0; i < loud.size(); i++) {
+        stereo[2 * i] = loud[i];
+        stereo[2 * i + 1] = -loud[i] * 0.5f;
+    }
+    float peak = 0;
+    for (float sample : run(chain, stereo, 2)) {
+        peak = std::max(peak, std::fabs(sample));
+    }
+    // -1 dBFS ceiling.
+    OTK_CHECK(peak <= std::pow(10, -1 / 20.0) + 1e-6);
+    // Released afterwards: a quiet signal is untouched.
+    std::vector<float> quiet = sine(300, 0.1, 2);
+    OTK_CHECK_NEAR(rms_dbfs(run(chain, quiet, 2), kRate * 3 / 2), rms_dbfs(quiet, kRate * 3 / 2), 0.1);
+    otk_audio_chain_delete(chain);
+}
+
+// A gain change is ramped over a block rather than stepped.
+static void test_gain_ramp() {
+    otk_audio_chain_config config = no_stages();
+    config.gain_enabled = 1;
+    otk_audio_chain *chain = otk_audio_chain_new(&config, 480, 1);
+    std::vector<float> block(480, 0.5f);
+    otk_audio_chain_process_float(chain, block.data(), 480, 1, kRate);
+    OTK_CHECK_NEAR(block[479], 0.5, 1e-6);
+
+    config.gain_db = 6;
+    otk_audio_chain_configure(chain, &config);
+    block.assign(480, 0.5f);
+    otk_audio_chain_process_float(chain, block.data(), 480, 1, kRate);
+    double largest_step = 0;
+    for (int i = 1; i < 480; i++) {
+        largest_step = std::max(largest_step, (double)std::fabs(block[i] - block[i - 1]));
+    }
+    OTK_CHECK(largest_step < 0.002);
+    OTK_CHECK(block[0] < 0.501f);
+    OTK_CHECK_NEAR(block[479], 0.5 * std::pow(10, 6 / 20.0), 0.01);
+    block.assign(480, 0.5f);
+    otk_audio_chain_process_float(chain, block.data(), 480, 1, kRate);
+    OTK_CHECK_NEAR(block[0], 0.5 * std::pow(10, 6 / 20.0), 1e-4);
+    otk_audio_chain_delete(chain);
+}
+
+// Reconfigured from another thread while the audio thread processes, at
+// changing sample rates.
+static void test_concurrent_configure() {
+    otk_audio_chain *chain = otk_audio_chain_new(nullptr, 480, 2);
+    std::atomic<bool> stop(false);
+    std::thread configurer([&] {
+        otk_audio_chain_config config = otk_audio_chain_default_config();
+        for (int i = 0; !stop; i++) {
+            config.gain_enabled = i & 1;
+            config.gain_db = (float)(i % 7);
+            config.high_pass_hz = (float)(50 + i % 100);
+            otk_audio_chain_configure(chain, &config);
+        }
+    });
+    std::mt19937 random(6);
+    std::vector<int16_t> block(960);
+    const int blocks = 5000;
+    for (int i = 0; i < blocks; i++) {
+        for (int16_t &sample : block) {
+            sample = (int16_t)(random() % 2000);
+        }
+        otk_audio_chain_process_int16(chain, block.data(), 480, 2, i % 2 ? 48000 : 16000);
+    }
+    stop = true;
+    configurer.join();
+    otk_audio_stage_stats stats;
+    otk_audio_chain_get_stage_stats(chain, OTK_AUDIO_STAGE_HIGH_PASS, &stats);
+    OTK_CHECK(stats.blocks == blocks);
+    OTK_CHECK(otk_audio_stage_stats_percentile_ns(&stats, 0.5) > 0);
+    otk_audio_chain_delete(chain);
+}
+
+static void benchmark_stages() {
+    std::mt19937 random(8);
+    for (size_t channels : { 1, 2 }) {
+        otk_audio_chain_config config = otk_audio_chain_default_config();
+        config.gain_enabled = 1;
+        config.gain_db = 3;
+        otk_audio_chain *chain = otk_audio_chain_new(&config, 480, 2);
+        std::vector<int16_t> block(480 * channels);
+        for (int i = 0; i < 20000; i++) {
+            for (int16_t &sample : block) {
+                sample = (int16_t)(random() % 20000 - 10000);
+            }
+            otk_audio_chain_process_int16(chain, block.data(), 480, channels, kRate);
+        }
+        for (int stage = 0; stage < OTK_AUDIO_STAGE_COUNT; stage++) {
+            otk_audio_stage_stats stats;
+            otk_audio_chain_get_stage_stats(chain, (otk_audio_stage)stage, &stats);
+            std::printf("48 kHz, %zu channels, %-9s mean %.2f us, p99 <= %.2f us, max %.2f us\n", channels,
+                        otk_audio_stage_name((otk_audio_stage)stage), stats.total_ns / 1000.0 / stats.blocks,
+                        otk_audio_stage_stats_percentile_ns(&stats, 0.99) / 1000.0, stats.max_ns / 1000.0);
+        }
+        otk_audio_chain_delete(chain);
+    }
+}
+
+int main(int argc, char **argv) {
+    otk_test_init(argc, argv);
+    test_identity();
+    test_high_pass();
+    test_agc();
+    test_limiter();
+    test_gain_ramp();
+    test_concurrent_configure();
+    if (otk_test_benchmarking) {
+        benchmark_stages();
+    }
+    return otk_test_result();
+}
@@ -0,0 +1,154 @@
+//
+//  OTAudioLevelMeterTests.cpp
+//  tests
+//
+//  Copyright (c) 2026 Vonage. All rights reserved.
+//
+
+#include "OTAudioLevelMeter.h"
+#include "OTTest.h"
+
+#include <random>
+#include <vector>
+
+static const uint32_t kSampleRate = 44100;
+static const uint32_t kBlock = 512;
+
+// The vector kernel, with its scalar tail, against the scalar one.
+static void test_kernel_matches_scalar() {
+    std::mt19937 random(1);
+    for (uint32_t length : { 0u, 1u, 7u, 8u, 9u, 15u, 16u, 17u, 511u, 512u, 513u }) {
+        std::vector<int16_t> samples(length);
+        for (int16_t &sample : samples) {
+            sample = (int16_t)(random() % 65536 - 32768);
+        }
+        if (length > 0) {
+            samples[length / 2] = -32768;
+        }
+        uint64_t vector_sum, scalar_sum;
+        int32_t vector_peak, scalar_peak;
+        otk_audio_level_sum_squares(samples.data(), length, &vector_sum, &vector_peak);
+        otk_audio_level_sum_squares_scalar(samples.data(), length, &scalar_sum, &scalar_peak);
+        OTK_CHECK(vector_sum == scalar_sum);
+        OTK_CHECK(vector_peak == scalar_peak);
+    }
+}
+
+// Low noise, then a modulated tone standing for voice, then noise again.
+static void test_voice_activity() {
+    otk_audio_level_meter *meter = otk_audio_level_meter_new(kSampleRate);
+    std::mt19937 random(2);
+    std::normal_distribution<double> noise(0, 1);
+    std::vector<int16_t> block(kBlock);
+    double t = 0;
+    auto process = [&](bool voice) {
+        for (int16_t &sample : block) {
+            double value = noise(random) * 30;
+            if (voice) {
+                value += 6000 * std::sin(2 * M_PI * 200 * t) * (0.6 + 0.4 * std::sin(2 * M_PI * 3 * t));
+            }
+            t += 1.0 / kSampleRate;
+            sample = (int16_t)value;
+        }
+        otk_audio_level_meter_process(meter, block.data(), kBlock);
+        otk_audio_level level;
+        otk_audio_level_meter_get(meter, &level);
+        return level;
+    };
+
+    otk_audio_level level = {};
+    for (int i = 0; i < 80; i++) {
+        level = process(false);
+        OTK_CHECK(!level.voice_active);
+    }
+    OTK_CHECK_NEAR(level.noise_floor_dbfs, -61, 3);
+    OTK_CHECK(level.rms_dbfs < -55);
+    // Detected within the first couple of blocks of voice.
+    process(true);
+    level = process(true);
+    OTK_CHECK(level.voice_active);
+    for (int i = 0; i < 78; i++) {
+        level = process(true);
+        OTK_CHECK(level.voice_active);
+    }
+    OTK_CHECK(level.rms_dbfs > -35);
+    // The noise floor does not follow the voice up.
+    OTK_CHECK(level.noise_floor_dbfs < -55);
+    // Held over for a while, then released.
+    level = process(false);
+    OTK_CHECK(level.voice_active);
+    for (int i = 0; i < 79; i++) {
+        level = process(false);
+    }
+    OTK_CHECK(!level.voice_active);
+    OTK_CHECK(level.blocks == 240);
+    otk_audio_level_meter_delete(meter);
+}
+
+// Loud but steady noise is not voice.
+static void test_steady_noise_is_not_voice() {
+    otk_audio_level_meter *meter = otk_audio_level_meter_new(kSampleRate);
+    std::mt19937 random(3);
+    std::normal_distribution<double> noise(0, 1);
+    std::vector<int16_t> block(kBlock);
+    otk_audio_level level = {};
+    for (int i = 0; i < 200; i++) {
+        for (int16_t &sample : block) {
+            sample = (int16_t)(noise(random) * 3000);
+        }
+        otk_audio_level_meter_process(meter, block.data(), kBlock);
+        otk_audio_level_meter_get(meter, &level);
+    }
+    OTK_CHECK(!level.voice_active);
+    OTK_CHECK(level.rms_dbfs > -25);
+    otk_audio_level_meter_delete(meter);
+}
+
+static void test_silence() {
+    otk_audio_level_meter *meter = otk_audio_level_meter_new(kSampleRate);
+    std::vector<int16_t> block(kBlock, 0);
+    otk_audio_level_meter_process(meter, block.data(), kBlock);
+    otk_audio_level level;
+    otk_audio_level_meter_get(meter, &level);
+    OTK_CHECK(level.rms_dbfs == -100);
+    OTK_CHECK(level.peak_dbfs == -100);
+    OTK_CHECK(!level.voice_active);
+    otk_audio_level_meter_delete(meter);
+}
+
+static void benchmark_kernel() {
+    std::mt19937 random(4);
+    std::vector<int16_t> samples(kBlock);
+    for (int16_t &sample : samples) {
+        sample = (int16_t)(random() % 65536 - 32768);
+    }
+    const int iterations = 200000;
+    uint64_t sum = 0;
+    int32_t peak = 0;
+    int64_t start = otk_test_now_ns();
+    for (int i = 0; i < iterations; i++) {
+        otk_audio_level_sum_squares(samples.data(), kBlock, &sum, &peak);
+        samples[i % kBlock] ^= (int16_t)sum;
+    }
+    int64_t vector_ns = otk_test_now_ns() - start;
+    start = otk_test_now_ns();
+    for (int i = 0; i < iterations; i++) {
+        otk_audio_level_sum_squares_scalar(samples.data(), kBlock, &sum, &peak);
+        samples[i % kBlock] ^= (int16_t)sum;
+    }
+    int64_t scalar_ns = otk_test_now_ns() - start;
+    std::printf("sum of squares, %u samples: %.1f ns vector, %.1f ns scalar\n", kBlock,
+                (double)vector_ns / iterations, (double)scalar_ns / iterations);
+}
+
+int main(int argc, char **argv) {
+    otk_test_init(argc, argv);
+    test_kernel_matches_scalar();
+    test_voice_activity();
+    test_steady_noise_is_not_voice();
+    test_silence();
+    if (otk_test_benchmarking) {
+        benchmark_kernel();
+    }
+    return otk_test_result();
+}
@@ -0,0 +1,215 @@
+//
+//  OTBackgroundBlurTests.cpp
+//  tests
+//
+//  Copyright (c) 2026 Vonage. All rights reserved.
+//
+
+#include "OTBackgroundBlur.h"
+#include "OTTest.h"
+
+#include <algorithm>
+#include <random>
+#include <vector>
+
+// Scalar reference of the filter: passes of a horizontal then a vertical
+// box blur with clamped edges, divided the way the kernels divide.
+static uint8_t box_divide(uint32_t sum, uint32_t window) {
+    uint32_t half = window / 2;
+    uint32_t reciprocal = (65536 + window - 1) / window;
+    return (uint8_t)((((sum + half) & 0xffff) * reciprocal) >> 16);
+}
+
+static void reference_blur(std::vector<uint8_t> &plane, int width, int height, int radius, int passes) {
+    std::vector<uint8_t> rows(plane.size());
+    uint32_t window = 2 * radius + 1;
+    for (int pass = 0; pass < passes; pass++) {
+        for (int y = 0; y < height; y++) {
+            for (int x = 0; x < width; x++) {
+                uint32_t sum = 0;
+                for (int k = -radius; k <= radius; k++) {
+                    sum += plane[y * width + std::clamp(x + k, 0, width - 1)];
+                }
+                rows[y * width + x] = box_divide(sum, window);
+            }
+        }
+        for (int y = 0; y < height; y++) {
+            for (int x = 0; x < width; x++) {
+                uint32_t sum = 0;
+                for (int k = -radius; k <= radius; k++) {
+                    sum += rows[std::clamp(y + k, 0, height - 1) * width + x];
+                }
+                plane[y * width + x] = box_divide(sum, window);
+            }
+        }
+    }
+}
+
+static void reference_blend(std::vector<uint8_t> &plane, const std::vector<uint8_t> &blurred,
+                            const std::vector<uint8_t> &mask) {
+    for (size_t i = 0; i < plane.size(); i++) {
+        uint32_t alpha = mask[i] + (mask[i] >> 7);
+        plane[i] = (uint8_t)((plane[i] * alpha + blurred[i] * (256 - alpha) + 128) >> 8);
+    }
+}
+
+// Nearest neighbour, as the blur scales its mask.
+static void scale_mask(const uint8_t *src, int src_width, int src_height, uint8_t *dst, int width, int height) {
+    for (int y = 0; y < height; y++) {
+        for (int x = 0; x < width; x++) {
+            dst[y * width + x] = src[(size_t)((uint64_t)y * src_height / height) * src_width +
+                                     (uint64_t)x * src_width / width];
+        }
+    }
+}
+
+// Blurs a random frame with padded rows and compares it with the reference.
+// Returns the number of differing bytes, padding included.
+static int compare_with_reference(std::mt19937 &random, int width, int height,
+                                  otk_blur_preset preset, uint32_t threads, bool custom_mask) {
+    const uint8_t kPadding = 0xa5;
+    int chroma_width = (width + 1) / 2;
+    int chroma_height = (height + 1) / 2;
+    int y_stride = width + 7;
+    int c_stride = chroma_width + 3;
+    std::vector<uint8_t> y(y_stride * height, kPadding);
+    std::vector<uint8_t> u(c_stride * chroma_height, kPadding);
+    std::vector<uint8_t> v(c_stride * chroma_height, kPadding);
+    std::vector<uint8_t> expected_y(width * height);
+    std::vector<uint8_t> expected_u(chroma_width * chroma_height);
+    std::vector<uint8_t> expected_v(chroma_width * chroma_height);
+    for (int row = 0; row < height; row++) {
+        for (int x = 0; x < width; x++) {
+            expected_y[row * width + x] = y[row * y_stride + x] = (uint8_t)random();
+        }
+    }
+    for (int row = 0; row < chroma_height; row++) {
+        for (int x = 0; x < chroma_width; x++) {
+            expected_u[row * chroma_width + x] = u[row * c_stride + x] = (uint8_t)random();
+            expected_v[row * chroma_width + x] = v[row * c_stride + x] = (uint8_t)random();
+        }
+    }
+
+    otk_background_blur *blur = otk_background_blur_new(preset, threads);
+    std::vector<uint8_t> mask(width * height);
+    if (custom_mask) {
+        std::vector<uint8_t> small(37 * 23);
+        for (uint8_t &value : small) {
+            value = (uint8_t)random();
+        }
+        otk_background_blur_set_mask(blur, small.data(), 37, 23, 37);
+        scale_mask(small.data(), 37, 23, mask.data(), width, height);
+    } else {
+        otk_background_blur_portrait_mask(mask.data(), width, height);
+    }
+    std::vector<uint8_t> chroma_mask(chroma_width * chroma_height);
+    scale_mask(mask.data(), width, height, chroma_mask.data(), chroma_width, chroma_height);
+
+    int differences = 0;
+    if (!otk_background_blur_process(blur, y.data(), y_stride, u.data(), c_stride, v.data(), c_stride,
+                                     width, height)) {
+        differences++;
+    }
+    otk_blur_stats stats;
+    otk_background_blur_get_stats(blur, &stats);
+    otk_background_blur_delete(blur);
+
+    int passes = preset + 1;
+    int radius = (int)stats.radius;
+    int chroma_radius = std::max(1, radius / 2);
+    std::vector<uint8_t> blurred_y = expected_y, blurred_u = expected_u, blurred_v = expected_v;
+    reference_blur(blurred_y, width, height, radius, passes);
+    reference_blur(blurred_u, chroma_width, chroma_height, chroma_radius, passes);
+    reference_blur(blurred_v, chroma_width, chroma_height, chroma_radius, passes);
+    reference_blend(expected_y, blurred_y, mask);
+    reference_blend(expected_u, blurred_u, chroma_mask);
+    reference_blend(expected_v, blurred_v, chroma_mask);
+
+    for (int row = 0; row < height; row++) {
+        for (int x = 0; x < y_stride; x++) {
+            differences += y[row * y_stride + x] != (x < width ? expected_y[row * width + x] : kPadding);
+        }
+    }
+    for (int row = 0; row < chroma_height; row++) {
+        for (int x = 0; x < c_stride; x++) {
+            differences += u[row * c_stride + x] != (x < chroma_width ? expected_u[row * chroma_width + x] : kPadding);
+            differences += v[row * c_stride + x] != (x < chroma_width ? expected_v[row * chroma_width + x] : kPadding);
+        }
+    }
+    return differences;
+}
+
+// Bit exact against the reference for every preset, band split and mask,
+// on sizes around the vector widths and smaller than the blur radius.
+static void test_matches_reference() {
+    std::mt19937 random(7);
+    const int sizes[][2] = { { 2, 2 }, { 3, 3 }, { 17, 5 }, { 33, 31 }, { 64, 48 }, { 101, 77 }, { 320, 180 } };
+    for (const auto &size : sizes) {
+        for (otk_blur_preset preset : { OTK_BLUR_FAST, OTK_BLUR_BALANCED, OTK_BLUR_QUALITY }) {
+            for (uint32_t threads : { 1u, 3u, 4u }) {
+                for (bool custom_mask : { false, true }) {
+                    int differences = compare_with_reference(random, size[0], size[1], preset, threads, custom_mask);
+                    if (differences != 0) {
+                        std::fprintf(stderr, "%dx%d preset %d, %u threads, %s mask: %d bytes differ\n",
+                                     size[0], size[1], preset, threads, custom_mask ? "custom" : "portrait",
+                                     differences);
+                    }
+                    OTK_CHECK(differences == 0);
+                }
+            }
+        }
+    }
+}
+
+static void test_masks_and_arguments() {
+    // The portrait mask keeps the middle of the lower part and blurs the corners.
+    std::vector<uint8_t> mask(64 * 48);
+    otk_background_blur_portrait_mask(mask.data(), 64, 48);
+    OTK_CHECK(mask[30 * 64 + 32] == 255);
+    OTK_CHECK(mask[0] == 0 && mask[63] == 0);
+
+    otk_background_blur *blur = otk_background_blur_new(OTK_BLUR_BALANCED, 2);
+    std::vector<uint8_t> plane(64 * 48, 128);
+    OTK_CHECK(!otk_background_blur_process(blur, nullptr, 64, plane.data(), 32, plane.data(), 32, 64, 48));
+    OTK_CHECK(!otk_background_blur_process(blur, plane.data(), 10, plane.data(), 32, plane.data(), 32, 64, 48));
+    OTK_CHECK(!otk_background_blur_process(nullptr, plane.data(), 64, plane.data(), 32, plane.data(), 32, 64, 48));
+    otk_blur_stats stats;
+    otk_background_blur_get_stats(blur, &stats);
+    OTK_CHECK(stats.frames == 0);
+    OTK_CHECK(stats.threads == 2);
+    otk_background_blur_delete(blur);
+}
+
+static void benchmark_blur() {
+    const int sizes[][2] = { { 1280, 720 }, { 1920, 1080 } };
+    for (const auto &size : sizes) {
+        int width = size[0], height = size[1];
+        std::vector<uint8_t> y(width * height, 100), u(width * height / 4, 50), v(width * height / 4, 60);
+        for (otk_blur_preset preset : { OTK_BLUR_FAST, OTK_BLUR_BALANCED, OTK_BLUR_QUALITY }) {
+            for (uint32_t threads : { 1u, 2u, 4u, 8u }) {
+                otk_background_blur *blur = otk_background_blur_new(preset, threads);
+                for (int i = 0; i < 5; i++) {
+                    otk_background_blur_process(blur, y.data(), width, u.data(), width / 2, v.data(), width / 2, width, height);
+                }
+                const int iterations = 60;
+                int64_t start = otk_test_now_ns();
+                for (int i = 0; i < iterations; i++) {
+                    otk_background_blur_process(blur, y.data(), width, u.data(), width / 2, v.data(), width / 2, width, height);
+                }
+                std::printf("%dx%d preset %d, %u threads: %.2f ms/frame\n", width, height, preset, threads,
+                            (double)(otk_test_now_ns() - start) / iterations / 1e6);
+                otk_background_blur_delete(blur);
+            }
+        }
+    }
+}
+
+int main(int argc, char **argv) {
+    otk_test_init(argc, argv);
+    test_matches_reference();
+    test_masks_and_arguments();
+    if (otk_test_benchmarking) {
+        benchmark_blur();
+    }
+    return otk_test_result();
+}
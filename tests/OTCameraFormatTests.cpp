@@ -0,0 +1,122 @@
+//
+//  OTCameraFormatTests.cpp
+//  tests
+//
+//  Copyright (c) 2026 Vonage. All rights reserved.
+//
+
+#include "OTCameraFormat.h"
+#include "OTTest.h"
+
+#define V OTK_PIXEL_FORMAT_420V
+#define Y OTK_PIXEL_FORMAT_YUVS
+#define M OTK_PIXEL_FORMAT_DMB1
+
+// Format tables in the shape the capturer flattens a device's formats into,
+// modeled on what these cameras advertise.
+
+// Built-in FaceTime HD camera (720p).
+static const otk_camera_format kFaceTimeHD[] = {
+    { 0, 1280, 720, V, 1, 30 }, { 1, 1280, 720, Y, 1, 30 }, { 2, 1080, 720, V, 1, 30 },
+    { 3, 960, 540, V, 1, 30 }, { 4, 800, 600, V, 1, 30 }, { 5, 640, 480, V, 1, 30 },
+    { 6, 640, 360, V, 1, 30 }, { 7, 320, 240, V, 1, 30 }, { 8, 320, 180, V, 1, 30 },
+};
+
+// USB webcam over UVC: uncompressed frame rates collapse at high resolutions,
+// and one format has two frame rate ranges.
+static const otk_camera_format kUsbWebcam[] = {
+    { 0, 640, 480, Y, 5, 30 }, { 1, 640, 480, M, 5, 30 }, { 2, 1280, 720, Y, 5, 10 },
+    { 3, 1280, 720, M, 5, 30 }, { 4, 1920, 1080, Y, 5, 5 }, { 5, 1920, 1080, M, 5, 30 },
+    { 6, 320, 240, Y, 5, 30 }, { 7, 800, 600, Y, 5, 24 }, { 7, 800, 600, Y, 30, 30 },
+};
+
+// Capture card that only produces 1080p at 59.94 fps.
+static const otk_camera_format kCaptureCard[] = {
+    { 0, 1920, 1080, OTK_PIXEL_FORMAT_2VUY, 59.94, 59.94 },
+};
+
+#undef V
+#undef Y
+#undef M
+
+template <size_t N>
+static otk_camera_format_choice select_format(const otk_camera_format (&formats)[N],
+                                              uint32_t width, uint32_t height, double frame_rate) {
+    otk_camera_format_request request = { width, height, frame_rate };
+    otk_camera_format_choice choice = {};
+    OTK_CHECK(otk_camera_format_select(formats, N, &request, &choice));
+    return choice;
+}
+
+static void test_built_in_camera() {
+    otk_camera_format_choice choice = select_format(kFaceTimeHD, 640, 480, 30);
+    OTK_CHECK(choice.entry == 5);
+    OTK_CHECK(choice.meets_resolution && choice.meets_frame_rate);
+
+    // The frame rate is set within the format's range.
+    choice = select_format(kFaceTimeHD, 1280, 720, 20);
+    OTK_CHECK(choice.entry == 0);
+    OTK_CHECK(choice.frame_rate == 20);
+
+    // Too big for the camera: the biggest size at the frame rate.
+    choice = select_format(kFaceTimeHD, 1920, 1080, 30);
+    OTK_CHECK(choice.entry == 0);
+    OTK_CHECK(!choice.meets_resolution && choice.meets_frame_rate);
+
+    // Too fast for the camera: the size at the highest frame rate.
+    choice = select_format(kFaceTimeHD, 640, 480, 60);
+    OTK_CHECK(choice.entry == 5);
+    OTK_CHECK(choice.meets_resolution && !choice.meets_frame_rate);
+    OTK_CHECK(choice.frame_rate == 30);
+
+    // No exact size: the smallest that covers it.
+    choice = select_format(kFaceTimeHD, 352, 288, 30);
+    OTK_CHECK(choice.entry == 6);
+    OTK_CHECK(choice.meets_resolution);
+}
+
+static void test_usb_webcam() {
+    // MJPEG only where the uncompressed format cannot keep up.
+    OTK_CHECK(select_format(kUsbWebcam, 1280, 720, 30).entry == 3);
+    OTK_CHECK(select_format(kUsbWebcam, 1280, 720, 10).entry == 2);
+    OTK_CHECK(select_format(kUsbWebcam, 640, 480, 30).entry == 0);
+    OTK_CHECK(select_format(kUsbWebcam, 1920, 1080, 30).entry == 5);
+
+    // The range of the format that covers the frame rate.
+    otk_camera_format_choice choice = select_format(kUsbWebcam, 800, 600, 20);
+    OTK_CHECK(choice.entry == 7);
+    OTK_CHECK(choice.frame_rate == 20);
+    choice = select_format(kUsbWebcam, 800, 600, 30);
+    OTK_CHECK(choice.entry == 8);
+    OTK_CHECK(choice.frame_rate == 30);
+}
+
+static void test_capture_card() {
+    // The only format, at the only rate it has.
+    otk_camera_format_choice choice = select_format(kCaptureCard, 1280, 720, 30);
+    OTK_CHECK(choice.entry == 0);
+    OTK_CHECK_NEAR(choice.frame_rate, 59.94, 0.001);
+    OTK_CHECK(choice.meets_resolution && choice.meets_frame_rate);
+
+    otk_camera_format_choice empty;
+    OTK_CHECK(!otk_camera_format_select(kCaptureCard, 0, nullptr, &empty));
+}
+
+static void test_helpers() {
+    OTK_CHECK(otk_camera_pixel_format_cost(OTK_PIXEL_FORMAT_420V) == 1);
+    OTK_CHECK(otk_camera_pixel_format_cost(OTK_PIXEL_FORMAT_420F) == 1);
+    OTK_CHECK(otk_camera_pixel_format_cost(OTK_PIXEL_FORMAT_YUVS) > 1);
+    OTK_CHECK(otk_camera_pixel_format_cost(OTK_PIXEL_FORMAT_DMB1) >
+              otk_camera_pixel_format_cost(OTK_PIXEL_FORMAT_YUVS));
+    OTK_CHECK_NEAR(otk_camera_frame_rate(1001, 30000), 29.97, 0.001);
+    OTK_CHECK(otk_camera_frame_rate(0, 30) == 0);
+}
+
+int main(int argc, char **argv) {
+    otk_test_init(argc, argv);
+    test_built_in_camera();
+    test_usb_webcam();
+    test_capture_card();
+    test_helpers();
+    return otk_test_result();
+}
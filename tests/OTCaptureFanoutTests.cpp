@@ -0,0 +1,408 @@
+//
+//  OTCaptureFanoutTests.cpp
+//  tests
+//
+//  Copyright (c) 2026 Vonage. All rights reserved.
+//
+
+#include "OTCaptureFanout.h"
+#include "OTTest.h"
+
+#include <atomic>
+#include <random>
+#include <thread>
+#include <vector>
+
+// Source frames own their planes and count how many were freed.
+struct source_frame {
+    std::vector<uint8_t> data;
+};
+
+static std::atomic<int> sources_freed(0);
+static const uint8_t *last_source_luma = nullptr;
+
+static void free_source(void *context) {
+    delete (source_frame *)context;
+    sources_freed++;
+}
+
+static otk_fanout_buffer *make_source(uint32_t width, uint32_t height, uint8_t luma, uint8_t chroma) {
+    source_frame *frame = new source_frame{ std::vector<uint8_t>(width * height * 3 / 2, chroma) };
+    std::fill(frame->data.begin(), frame->data.begin() + width * height, luma);
+    last_source_luma = frame->data.data();
+    const uint8_t *planes[2] = { frame->data.data(), frame->data.data() + width * height };
+    int strides[2] = { (int)width, (int)width };
+    return otk_fanout_buffer_wrap(width, height, planes, strides, free_source, frame);
+}
+
+static void push_source(otk_capture_fanout *fanout, uint32_t width, uint32_t height, uint8_t luma,
+                        int64_t timestamp_us) {
+    otk_fanout_buffer *buffer = make_source(width, height, luma, 80);
+    otk_capture_fanout_push(fanout, buffer, timestamp_us, nullptr, 0);
+    otk_fanout_buffer_release(buffer);
+}
+
+// What a consumer was last given.
+struct sink {
+    int frames = 0;
+    uint32_t width = 0, height = 0;
+    uint8_t luma = 0, chroma = 0;
+    const uint8_t *luma_plane = nullptr;
+    bool keep = false;
+    std::vector<otk_fanout_buffer *> kept;
+};
+
+static void deliver(const otk_fanout_frame *frame, otk_fanout_buffer *buffer, void *user_data) {
+    sink *consumer = (sink *)user_data;
+    consumer->frames++;
+    consumer->width = frame->width;
+    consumer->height = frame->height;
+    consumer->luma = frame->planes[0][0];
+    consumer->chroma = frame->planes[1][0];
+    consumer->luma_plane = frame->planes[0];
+    if (consumer->keep) {
+        otk_fanout_buffer_retain(buffer);
+        consumer->kept.push_back(buffer);
+    }
+}
+
+static bool output_size_is(uint32_t source_width, uint32_t source_height, uint32_t max_width,
+                           uint32_t max_height, uint32_t width, uint32_t height) {
+    uint32_t out_width = 0, out_height = 0;
+    otk_capture_fanout_output_size(source_width, source_height, max_width, max_height, &out_width, &out_height);
+    if (out_width != width || out_height != height) {
+        std::fprintf(stderr, "%ux%u in %ux%u: %ux%u\n", source_width, source_height, max_width,
+                     max_height, out_width, out_height);
+    }
+    return out_width == width && out_height == height;
+}
+
+static void test_output_size() {
+    OTK_CHECK(output_size_is(1280, 720, 640, 360, 640, 360));
+    OTK_CHECK(output_size_is(1280, 720, 640, 0, 640, 360));
+    OTK_CHECK(output_size_is(1280, 720, 0, 240, 320, 180));
+    // Never reduced by more than four.
+    OTK_CHECK(output_size_is(1280, 720, 100, 100, 320, 180));
+    OTK_CHECK(output_size_is(1920, 1080, 1280, 720, 960, 540));
+    OTK_CHECK(output_size_is(1282, 722, 640, 360, 640, 360));
+    OTK_CHECK(output_size_is(640, 480, 1280, 720, 640, 480));
+    OTK_CHECK(output_size_is(1280, 720, 0, 0, 1280, 720));
+}
+
+// 720p at 30 fps, with jittered timestamps, to a full size consumer, two
+// at 360p with and without a rate limit and one reduced by four.
+static void test_fanout() {
+    otk_capture_fanout *fanout = otk_capture_fanout_new();
+    sink full, low, low_all, quarter;
+    int full_id = otk_capture_fanout_add_consumer(fanout, 0, 0, 0, deliver, &full);
+    int low_id = otk_capture_fanout_add_consumer(fanout, 640, 360, 15, deliver, &low);
+    int low_all_id = otk_capture_fanout_add_consumer(fanout, 640, 360, 0, deliver, &low_all);
+    int quarter_id = otk_capture_fanout_add_consumer(fanout, 320, 320, 0, deliver, &quarter);
+
+    // Consumers start inactive.
+    int freed = sources_freed;
+    push_source(fanout, 1280, 720, 100, 0);
+    OTK_CHECK(full.frames == 0 && sources_freed == freed + 1);
+    for (int id : { full_id, low_id, low_all_id, quarter_id }) {
+        otk_capture_fanout_set_active(fanout, id, 1);
+    }
+    for (int i = 0; i < 90; i++) {
+        push_source(fanout, 1280, 720, (uint8_t)(i * 2), (int64_t)(i * 1e6 / 30) + (i % 3 - 1) * 2000);
+    }
+    OTK_CHECK(full.frames == 90 && low_all.frames == 90 && quarter.frames == 90);
+    OTK_CHECK(low.frames == 45);
+    OTK_CHECK(full.width == 1280 && full.height == 720);
+    OTK_CHECK(low.width == 640 && low.height == 360);
+    OTK_CHECK(quarter.width == 320 && quarter.height == 180);
+    OTK_CHECK(low_all.luma == 178 && low_all.chroma == 80);
+    OTK_CHECK(quarter.luma == 178 && quarter.chroma == 80);
+
+    // Once per size and frame, from a few pooled buffers.
+    otk_fanout_stats stats;
+    otk_capture_fanout_get_stats(fanout, &stats);
+    OTK_CHECK(stats.scales == 180);
+    OTK_CHECK(stats.buffers_allocated <= 4);
+    otk_fanout_consumer_stats consumer;
+    OTK_CHECK(otk_capture_fanout_get_consumer_stats(fanout, low_id, &consumer));
+    OTK_CHECK(consumer.frames_delivered == 45 && consumer.frames_decimated == 45);
+    OTK_CHECK(consumer.frames_scaled == 45);
+    otk_capture_fanout_get_consumer_stats(fanout, full_id, &consumer);
+    OTK_CHECK(consumer.frames_shared == 90);
+
+    // 30 to 20 fps, also once the timestamps start over.
+    for (int id : { full_id, low_id, low_all_id, quarter_id }) {
+        otk_capture_fanout_set_active(fanout, id, 0);
+    }
+    sink rate;
+    int rate_id = otk_capture_fanout_add_consumer(fanout, 0, 0, 20, deliver, &rate);
+    otk_capture_fanout_set_active(fanout, rate_id, 1);
+    for (int i = 0; i < 300; i++) {
+        push_source(fanout, 64, 64, 1, (int64_t)(i * 1e6 / 30));
+    }
+    OTK_CHECK(rate.frames >= 199 && rate.frames <= 201);
+    int before = rate.frames;
+    for (int i = 0; i < 30; i++) {
+        push_source(fanout, 64, 64, 1, (int64_t)(i * 1e6 / 30));
+    }
+    OTK_CHECK(rate.frames - before >= 19 && rate.frames - before <= 21);
+    otk_capture_fanout_remove_consumer(fanout, rate_id);
+    OTK_CHECK(!otk_capture_fanout_get_consumer_stats(fanout, rate_id, &consumer));
+
+    // Retained buffers outlive the push and the fanout. The full size
+    // consumer gets the source planes themselves.
+    full.keep = low.keep = true;
+    otk_capture_fanout_set_active(fanout, full_id, 1);
+    otk_capture_fanout_set_active(fanout, low_id, 1);
+    freed = sources_freed;
+    push_source(fanout, 1280, 720, 7, 100000000);
+    OTK_CHECK(sources_freed == freed);
+    OTK_CHECK(full.luma_plane == last_source_luma && low.luma_plane != last_source_luma);
+    otk_capture_fanout_delete(fanout);
+    OTK_CHECK(full.kept.size() == 1 && low.kept.size() == 1);
+    OTK_CHECK(low.kept[0] && otk_fanout_buffer_plane(low.kept[0], 0)[0] == 7);
+    otk_fanout_buffer_release(full.kept[0]);
+    OTK_CHECK(sources_freed == freed + 1);
+    otk_fanout_buffer_release(low.kept[0]);
+}
+
+// The average of each factor by factor block, rounded.
+static uint8_t box_average(const uint8_t *plane, int stride, int x, int y, int factor, int channels,
+                           int channel) {
+    int sum = 0;
+    for (int j = 0; j < factor; j++) {
+        for (int i = 0; i < factor; i++) {
+            sum += plane[(y * factor + j) * stride + (x * factor + i) * channels + channel];
+        }
+    }
+    return (uint8_t)((sum + factor * factor / 2) / (factor * factor));
+}
+
+static otk_fanout_buffer *scaled_buffer;
+static otk_fanout_frame scaled_frame;
+
+static void keep_scaled(const otk_fanout_frame *frame, otk_fanout_buffer *buffer, void *) {
+    otk_fanout_buffer_retain(buffer);
+    scaled_buffer = buffer;
+    scaled_frame = *frame;
+}
+
+// The vector kernels match the plain box filter at widths that leave a
+// remainder and strides wider than the frame.
+static void test_box_filter() {
+    std::mt19937 random(1);
+    for (int factor : { 2, 4 }) {
+        for (int width : { 1280, 1284, 1262, 64, 70, 1920 }) {
+            const int height = 720, stride = width + 24;
+            std::vector<uint8_t> data(stride * height * 3 / 2);
+            for (uint8_t &value : data) {
+                value = (uint8_t)random();
+            }
+            const uint8_t *planes[2] = { data.data(), data.data() + stride * height };
+            int strides[2] = { stride, stride };
+            otk_capture_fanout *fanout = otk_capture_fanout_new();
+            int id = otk_capture_fanout_add_consumer(fanout, width / factor, height / factor, 0, keep_scaled, nullptr);
+            otk_capture_fanout_set_active(fanout, id, 1);
+            otk_fanout_buffer *source = otk_fanout_buffer_wrap(width, height, planes, strides, nullptr, nullptr);
+            scaled_buffer = nullptr;
+            otk_capture_fanout_push(fanout, source, 0, nullptr, 0);
+            otk_fanout_buffer_release(source);
+            OTK_CHECK(scaled_buffer != nullptr);
+            if (!scaled_buffer) {
+                otk_capture_fanout_delete(fanout);
+                continue;
+            }
+            int wrong = 0;
+            for (uint32_t y = 0; y < scaled_frame.height; y++) {
+                for (uint32_t x = 0; x < scaled_frame.width; x++) {
+                    wrong += scaled_frame.planes[0][y * scaled_frame.strides[0] + x] !=
+                             box_average(planes[0], stride, x, y, factor, 1, 0);
+                }
+            }
+            for (uint32_t y = 0; y < scaled_frame.height / 2; y++) {
+                for (uint32_t x = 0; x < scaled_frame.width / 2; x++) {
+                    for (int channel = 0; channel < 2; channel++) {
+                        wrong += scaled_frame.planes[1][y * scaled_frame.strides[1] + 2 * x + channel] !=
+                                 box_average(planes[1], stride, x, y, factor, 2, channel);
+                    }
+                }
+            }
+            if (wrong) {
+                std::fprintf(stderr, "factor %d, width %d: %d samples differ\n", factor, width, wrong);
+            }
+            OTK_CHECK(wrong == 0);
+            otk_fanout_buffer_release(scaled_buffer);
+            otk_capture_fanout_delete(fanout);
+        }
+    }
+}
+
+static const uint8_t *seen_metadata;
+static size_t seen_metadata_size;
+
+static void note_metadata(const otk_fanout_frame *frame, otk_fanout_buffer *, void *) {
+    seen_metadata = frame->metadata;
+    seen_metadata_size = frame->metadata_size;
+}
+
+static void test_metadata() {
+    otk_capture_fanout *fanout = otk_capture_fanout_new();
+    int id = otk_capture_fanout_add_consumer(fanout, 0, 0, 0, note_metadata, nullptr);
+    otk_capture_fanout_set_active(fanout, id, 1);
+    uint8_t metadata[5] = { 1, 2, 3, 4, 5 };
+    otk_fanout_buffer *buffer = make_source(64, 64, 0, 0);
+    otk_capture_fanout_push(fanout, buffer, 0, metadata, sizeof(metadata));
+    otk_fanout_buffer_release(buffer);
+    OTK_CHECK(seen_metadata == metadata && seen_metadata_size == 5);
+    otk_capture_fanout_delete(fanout);
+}
+
+struct slow_consumer {
+    std::atomic<bool> entered{ false };
+    std::atomic<bool> returned{ false };
+    std::atomic<int> calls{ 0 };
+};
+
+static void deliver_slowly(const otk_fanout_frame *, otk_fanout_buffer *, void *user_data) {
+    slow_consumer *consumer = (slow_consumer *)user_data;
+    consumer->calls++;
+    consumer->entered = true;
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    consumer->returned = true;
+}
+
+struct removes_itself {
+    otk_capture_fanout *fanout;
+    int id;
+    int calls;
+};
+
+static void deliver_and_remove(const otk_fanout_frame *, otk_fanout_buffer *, void *user_data) {
+    removes_itself *consumer = (removes_itself *)user_data;
+    consumer->calls++;
+    otk_capture_fanout_remove_consumer(consumer->fanout, consumer->id);
+}
+
+static std::atomic<bool> stats_in_callback(false);
+
+static void deliver_and_get_stats(const otk_fanout_frame *, otk_fanout_buffer *, void *user_data) {
+    otk_fanout_stats stats;
+    otk_capture_fanout_get_stats((otk_capture_fanout *)user_data, &stats);
+    stats_in_callback = true;
+}
+
+// Removing waits for a callback in progress; a callback may remove its own
+// consumer and call back into the fanout.
+static void test_remove_during_delivery() {
+    otk_capture_fanout *fanout = otk_capture_fanout_new();
+    slow_consumer slow;
+    int slow_id = otk_capture_fanout_add_consumer(fanout, 0, 0, 0, deliver_slowly, &slow);
+    otk_capture_fanout_set_active(fanout, slow_id, 1);
+    std::thread capture([&] { push_source(fanout, 64, 64, 10, 0); });
+    while (!slow.entered) {
+        std::this_thread::yield();
+    }
+    otk_capture_fanout_remove_consumer(fanout, slow_id);
+    OTK_CHECK(slow.returned);
+    capture.join();
+    push_source(fanout, 64, 64, 10, 33333);
+    OTK_CHECK(slow.calls == 1);
+
+    removes_itself self = { fanout, 0, 0 };
+    self.id = otk_capture_fanout_add_consumer(fanout, 0, 0, 0, deliver_and_remove, &self);
+    otk_capture_fanout_set_active(fanout, self.id, 1);
+    int stats_id = otk_capture_fanout_add_consumer(fanout, 0, 0, 0, deliver_and_get_stats, fanout);
+    otk_capture_fanout_set_active(fanout, stats_id, 1);
+    for (int i = 0; i < 3; i++) {
+        push_source(fanout, 64, 64, 10, 66666 + i * 33333);
+    }
+    OTK_CHECK(self.calls == 1);
+    OTK_CHECK(stats_in_callback);
+    otk_capture_fanout_delete(fanout);
+}
+
+static std::atomic<int> calls_after_remove(0);
+
+static void deliver_checking_removed(const otk_fanout_frame *, otk_fanout_buffer *buffer, void *user_data) {
+    if (((std::atomic<bool> *)user_data)->load()) {
+        calls_after_remove++;
+    }
+    otk_fanout_buffer_retain(buffer);
+    otk_fanout_buffer_release(buffer);
+}
+
+// Consumers come and go while another thread pushes.
+static void test_threads() {
+    otk_capture_fanout *fanout = otk_capture_fanout_new();
+    std::atomic<bool> stop(false);
+    std::thread capture([&] {
+        for (int i = 0; !stop; i++) {
+            push_source(fanout, 320, 240, 1, i * 33333LL);
+        }
+    });
+    for (int r = 0; r < 300; r++) {
+        std::atomic<bool> *removed = new std::atomic<bool>(false);
+        int id = otk_capture_fanout_add_consumer(fanout, 160, 120, 0, deliver_checking_removed, removed);
+        otk_capture_fanout_set_active(fanout, id, 1);
+        std::this_thread::sleep_for(std::chrono::microseconds(200));
+        otk_capture_fanout_remove_consumer(fanout, id);
+        removed->store(true);
+        delete removed;
+    }
+    stop = true;
+    capture.join();
+    otk_capture_fanout_delete(fanout);
+    OTK_CHECK(calls_after_remove == 0);
+}
+
+static void discard(const otk_fanout_frame *, otk_fanout_buffer *, void *) {
+}
+
+// 720p30 to full size, 360p15 and 180p15 consumers, against the three
+// full frame copies separate captures would make at least.
+static void benchmark_fanout() {
+    const int frames = 3000;
+    otk_capture_fanout *fanout = otk_capture_fanout_new();
+    for (uint32_t height : { 0, 360, 180 }) {
+        int id = otk_capture_fanout_add_consumer(fanout, height * 16 / 9, height, height ? 15 : 0, discard, nullptr);
+        otk_capture_fanout_set_active(fanout, id, 1);
+    }
+    int64_t start = otk_test_now_ns();
+    for (int i = 0; i < frames; i++) {
+        push_source(fanout, 1280, 720, (uint8_t)i, (int64_t)(i * 1e6 / 30));
+    }
+    double fanout_us = (otk_test_now_ns() - start) / 1e3 / frames;
+    start = otk_test_now_ns();
+    for (int i = 0; i < frames; i++) {
+        otk_fanout_buffer_release(make_source(1280, 720, (uint8_t)i, 80));
+    }
+    double source_us = (otk_test_now_ns() - start) / 1e3 / frames;
+    otk_fanout_stats stats;
+    otk_capture_fanout_get_stats(fanout, &stats);
+    std::printf("720p30 to 3 consumers: %.1f us/frame, scaling %.1f us/frame\n", fanout_us - source_us,
+                (double)stats.scale_us / frames);
+    otk_capture_fanout_delete(fanout);
+
+    std::vector<uint8_t> source(1280 * 720 * 3 / 2, 1), copy(source.size());
+    start = otk_test_now_ns();
+    for (int i = 0; i < frames; i++) {
+        for (int k = 0; k < 3; k++) {
+            std::memcpy(copy.data(), source.data(), source.size());
+            source[i % source.size()] ^= copy[(i * 7) % copy.size()];
+        }
+    }
+    std::printf("3 full frame copies: %.1f us/frame\n", (otk_test_now_ns() - start) / 1e3 / frames);
+}
+
+int main(int argc, char **argv) {
+    otk_test_init(argc, argv);
+    test_output_size();
+    test_fanout();
+    test_box_filter();
+    test_metadata();
+    test_remove_during_delivery();
+    test_threads();
+    if (otk_test_benchmarking) {
+        benchmark_fanout();
+    }
+    return otk_test_result();
+}
@@ -0,0 +1,226 @@
+//
+//  OTDeviceSwitchTests.cpp
+//  tests
+//
+//  Copyright (c) 2026 Vonage. All rights reserved.
+//
+
+#include "OTDeviceSwitch.h"
+#include "OTTest.h"
+
+#include <algorithm>
+#include <atomic>
+#include <thread>
+#include <vector>
+
+static const int kRate = 48000;
+
+// The SDK side: records captured audio and notices being entered by two
+// callbacks at once.
+struct sdk_side {
+    std::vector<int16_t> captured;
+    std::atomic<int> inside{0};
+    bool overlap = false;
+};
+
+static void sink(void *user_data, const int16_t *samples, size_t frames) {
+    sdk_side *sdk = (sdk_side *)user_data;
+    if (sdk->inside.fetch_add(1)) {
+        sdk->overlap = true;
+    }
+    sdk->captured.insert(sdk->captured.end(), samples, samples + frames);
+    sdk->inside.fetch_sub(1);
+}
+
+// A capture unit delivering a constant level, so the mix is easy to follow.
+struct capture_unit {
+    int slot;
+    size_t block;
+    int16_t level;
+    double start;
+    double stop;
+    double next;
+};
+
+// Fires the callbacks due between from and to, in steps of 0.1 ms. Paced
+// to the wall clock when the switch's own timings are checked.
+static void capture_between(otk_device_switch *device_switch, std::vector<capture_unit> &units,
+                            sdk_side &sdk, double from, double to, bool paced = false) {
+    std::vector<int16_t> block(1024);
+    int64_t origin = otk_test_now_ns() - (int64_t)(from * 1e9);
+    for (double t = from; t < to; t += 1e-4) {
+        while (paced && (otk_test_now_ns() - origin) / 1e9 < t) {
+            std::this_thread::yield();
+        }
+        for (capture_unit &unit : units) {
+            if (t < unit.start || t >= unit.stop) {
+                continue;
+            }
+            unit.next = std::max(unit.next, unit.start);
+            if (t >= unit.next) {
+                std::fill(block.begin(), block.begin() + unit.block, unit.level);
+                otk_device_switch_capture(device_switch, unit.slot, block.data(), unit.block, sink, &sdk);
+                unit.next += (double)unit.block / kRate;
+            }
+        }
+    }
+}
+
+// The old unit keeps capturing until the fade is over: the SDK gets one
+// stream going smoothly from the old level to the new, whether the new
+// unit's callbacks are larger or smaller than the old one's, and when the
+// new unit has delivered less than the old one's next callback needs.
+static void test_capture_crossfade() {
+    const size_t blocks[][2] = { { 512, 480 }, { 512, 128 }, { 512, 64 }, { 128, 1024 } };
+    for (const auto &block : blocks) {
+        otk_device_switch *device_switch = otk_device_switch_new(kRate, 1024, 5);
+        sdk_side sdk;
+        std::vector<capture_unit> units = {
+            { 0, block[0], 1000, 0, 1e9, 0 },
+            { 1, block[1], -1000, 1e9, 1e9, 0 },
+        };
+        capture_between(device_switch, units, sdk, 0, 1.0);
+        OTK_CHECK(otk_device_switch_begin(device_switch) == 1);
+        OTK_CHECK(otk_device_switch_begin(device_switch) == -1);
+        // The new unit's first callback comes just before the old one's.
+        units[1].start = units[0].next + 4.0 * block[0] / kRate - 0.0003;
+        capture_between(device_switch, units, sdk, 1.0, 1.2);
+        OTK_CHECK(otk_device_switch_get_state(device_switch) == OTK_DEVICE_SWITCH_RETIRED);
+        units[0].stop = 1.2;
+        OTK_CHECK(otk_device_switch_finish(device_switch) == 1);
+        OTK_CHECK(otk_device_switch_active_slot(device_switch) == 1);
+        capture_between(device_switch, units, sdk, 1.2, 2.0);
+
+        const std::vector<int16_t> &captured = sdk.captured;
+        OTK_CHECK(std::labs((long)captured.size() - 2 * kRate) < 1024);
+        size_t last_old = 0, first_new = 0;
+        for (size_t i = 0; i < captured.size(); i++) {
+            if (captured[i] == 1000) {
+                last_old = i;
+            } else if (captured[i] == -1000 && first_new == 0) {
+                first_new = i;
+            }
+        }
+        OTK_CHECK_NEAR((first_new - last_old) * 1000.0 / kRate, 5, 1);
+        // No step back to the old level, no plateau, no jump: an equal
+        // power fade over 240 frames moves at most about 9 per frame.
+        int largest_step = 0;
+        bool rising = false;
+        for (size_t i = 1; i < captured.size(); i++) {
+            rising |= captured[i] > captured[i - 1];
+            largest_step = std::max(largest_step, std::abs(captured[i] - captured[i - 1]));
+        }
+        if (largest_step >= 20 || rising) {
+            std::fprintf(stderr, "blocks %zu/%zu: step %d, rising %d\n", block[0], block[1], largest_step, rising);
+        }
+        OTK_CHECK(largest_step < 20);
+        OTK_CHECK(!rising);
+        otk_device_switch_stats stats;
+        otk_device_switch_get_stats(device_switch, &stats);
+        OTK_CHECK(stats.switches == 1);
+        otk_device_switch_delete(device_switch);
+    }
+}
+
+// With the old device unplugged at the switch, the new unit takes over
+// without a fade and the gap is counted, against the wall clock.
+static void test_capture_unplugged() {
+    otk_device_switch *device_switch = otk_device_switch_new(kRate, 1024, 5);
+    sdk_side sdk;
+    std::vector<capture_unit> units = {
+        { 0, 512, 1000, 0, 0.2, 0 },
+        { 1, 512, -1000, 1e9, 1e9, 0 },
+    };
+    capture_between(device_switch, units, sdk, 0, 0.2, true);
+    otk_device_switch_begin(device_switch);
+    units[1].start = 0.3;
+    capture_between(device_switch, units, sdk, 0.2, 0.5, true);
+    OTK_CHECK(otk_device_switch_finish(device_switch) == 1);
+    otk_device_switch_stats stats;
+    otk_device_switch_get_stats(device_switch, &stats);
+    long missing = (long)(0.5 * kRate) - (long)sdk.captured.size();
+    OTK_CHECK(std::labs(missing - kRate / 10) < 1100);
+    OTK_CHECK(std::labs((long)stats.last_dropped_frames - missing) < 1100);
+    OTK_CHECK(stats.last_first_audio_ms >= 0 && stats.last_first_audio_ms <= stats.last_switch_ms);
+    otk_device_switch_delete(device_switch);
+}
+
+static void test_cancel_and_reset() {
+    otk_device_switch *device_switch = otk_device_switch_new(kRate, 1024, 5);
+    sdk_side sdk;
+    std::vector<int16_t> block(512, 1000);
+    otk_device_switch_capture(device_switch, 0, block.data(), 512, sink, &sdk);
+    OTK_CHECK(otk_device_switch_begin(device_switch) == 1);
+    OTK_CHECK(otk_device_switch_cancel(device_switch) == 1);
+    // What the cancelled unit captures goes nowhere.
+    otk_device_switch_capture(device_switch, 1, block.data(), 512, sink, &sdk);
+    OTK_CHECK(sdk.captured.size() == 512);
+    OTK_CHECK(otk_device_switch_active_slot(device_switch) == 0);
+
+    // Too late to cancel once the new unit delivered, and too early to
+    // finish in the middle of the fade; only a reset drops the switch.
+    OTK_CHECK(otk_device_switch_begin(device_switch) == 1);
+    otk_device_switch_capture(device_switch, 1, block.data(), 64, sink, &sdk);
+    OTK_CHECK(otk_device_switch_get_state(device_switch) == OTK_DEVICE_SWITCH_CROSSFADE);
+    OTK_CHECK(otk_device_switch_cancel(device_switch) == 0);
+    OTK_CHECK(otk_device_switch_finish(device_switch) == 0);
+    otk_device_switch_reset(device_switch);
+    OTK_CHECK(otk_device_switch_get_state(device_switch) == OTK_DEVICE_SWITCH_IDLE);
+    OTK_CHECK(otk_device_switch_active_slot(device_switch) == 0);
+    otk_device_switch_stats stats;
+    otk_device_switch_get_stats(device_switch, &stats);
+    OTK_CHECK(stats.cancelled == 1);
+    OTK_CHECK(stats.switches == 0);
+    otk_device_switch_delete(device_switch);
+}
+
+// Two units on their own threads and a control thread switching back and
+// forth between them.
+static void test_switching_threads() {
+    otk_device_switch *device_switch = otk_device_switch_new(kRate, 1024, 2);
+    sdk_side sdk;
+    std::atomic<bool> stop(false);
+    std::atomic<bool> running[2];
+    running[0] = true;
+    running[1] = false;
+    auto unit = [&](int slot) {
+        std::vector<int16_t> block(256, (int16_t)slot);
+        while (!stop) {
+            if (running[slot]) {
+                otk_device_switch_capture(device_switch, slot, block.data(), 256, sink, &sdk);
+            }
+            std::this_thread::sleep_for(std::chrono::microseconds(300));
+        }
+    };
+    std::thread first(unit, 0), second(unit, 1);
+    int switches = 0;
+    for (int i = 0; i < 20; i++) {
+        int incoming = otk_device_switch_begin(device_switch);
+        running[incoming] = true;
+        int64_t deadline = otk_test_now_ns() + 5000000000;
+        while (otk_device_switch_get_state(device_switch) != OTK_DEVICE_SWITCH_RETIRED &&
+               otk_test_now_ns() < deadline) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+        running[1 - incoming] = false;
+        // Let a callback already under way finish before the old unit
+        // counts as stopped.
+        std::this_thread::sleep_for(std::chrono::milliseconds(2));
+        switches += otk_device_switch_finish(device_switch);
+    }
+    stop = true;
+    first.join();
+    second.join();
+    OTK_CHECK(switches == 20);
+    OTK_CHECK(!sdk.overlap);
+    otk_device_switch_delete(device_switch);
+}
+
+int main(int argc, char **argv) {
+    otk_test_init(argc, argv);
+    test_capture_crossfade();
+    test_capture_unplugged();
+    test_cancel_and_reset();
+    test_switching_threads();
+    return otk_test_result();
+}
@@ -0,0 +1,377 @@
+//
+//  OTFrameExportTests.cpp
+//  tests
+//
+//  Copyright (c) 2026 Vonage. All rights reserved.
+//
+
+#include "OTFrameExport.h"
+#include "OTTest.h"
+
+#include <atomic>
+#include <cstdlib>
+#include <random>
+#include <thread>
+#include <vector>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+// Offsets into the ring layout of OTFrameExport.cpp, to damage a ring.
+static const size_t kSlotsOffsetField = 24;
+static const size_t kSlotPlaneOffsetsField = 56;
+static const uint32_t kRingMagic = 0x4f544652;
+
+// Rings of this process only, so tests running at once do not share them.
+static char prefix[16];
+
+static void ring_name(const char *stream_id, char *name) {
+    OTK_CHECK(otk_frame_ring_name(prefix, stream_id, name));
+}
+
+// An I420 frame with a pattern per seed and padded rows filled with 0xee.
+struct image {
+    uint32_t width;
+    uint32_t height;
+    std::vector<uint8_t> data[3];
+    int strides[3];
+    const uint8_t *planes[3];
+};
+
+static image make_image(uint32_t width, uint32_t height, uint32_t seed, int padding) {
+    image frame;
+    frame.width = width;
+    frame.height = height;
+    for (int k = 0; k < 3; k++) {
+        uint32_t plane_width = k ? (width + 1) / 2 : width;
+        uint32_t plane_height = k ? (height + 1) / 2 : height;
+        frame.strides[k] = (int)plane_width + padding;
+        frame.data[k].resize((size_t)frame.strides[k] * plane_height);
+        for (uint32_t y = 0; y < plane_height; y++) {
+            for (uint32_t x = 0; x < (uint32_t)frame.strides[k]; x++) {
+                frame.data[k][y * frame.strides[k] + x] =
+                    (uint8_t)(x < plane_width ? seed * 7 + x * 3 + y * 5 + k * 11 : 0xee);
+            }
+        }
+        frame.planes[k] = frame.data[k].data();
+    }
+    return frame;
+}
+
+static bool same_pixels(const image &frame, const otk_exported_frame &exported) {
+    if (exported.width != frame.width || exported.height != frame.height) {
+        return false;
+    }
+    for (int k = 0; k < 3; k++) {
+        uint32_t plane_width = k ? (frame.width + 1) / 2 : frame.width;
+        uint32_t plane_height = k ? (frame.height + 1) / 2 : frame.height;
+        for (uint32_t y = 0; y < plane_height; y++) {
+            if (std::memcmp(exported.planes[k] + (size_t)y * exported.strides[k],
+                            frame.planes[k] + (size_t)y * frame.strides[k], plane_width) != 0) {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+static int write_frame(otk_frame_exporter *exporter, const char *stream_id, int64_t timestamp, const image &frame) {
+    return otk_frame_exporter_write(exporter, stream_id, timestamp, frame.width, frame.height,
+                                    frame.planes, frame.strides);
+}
+
+static void test_ring_names() {
+    char name[OTK_FRAME_RING_NAME_SIZE];
+    OTK_CHECK(otk_frame_ring_name(nullptr, "stream-1", name));
+    OTK_CHECK(std::strncmp(name, "/otk-", 5) == 0);
+    OTK_CHECK(std::strlen(name) < OTK_FRAME_RING_NAME_SIZE);
+    char again[OTK_FRAME_RING_NAME_SIZE];
+    otk_frame_ring_name(nullptr, "stream-1", again);
+    OTK_CHECK(std::strcmp(name, again) == 0);
+    otk_frame_ring_name(nullptr, "stream-2", again);
+    OTK_CHECK(std::strcmp(name, again) != 0);
+    // An application group fits if it is short enough.
+    OTK_CHECK(otk_frame_ring_name("ABCDE12345.otk/", "stream-1", name));
+    OTK_CHECK(!otk_frame_ring_name("ABCDE12345.com.example.group/", "stream-1", name));
+    otk_frame_exporter *exporter = otk_frame_exporter_new("ABCDE12345.com.example.group/", 4, 64, 48);
+    OTK_CHECK(!otk_frame_exporter_add_stream(exporter, "stream-1"));
+    otk_frame_exporter_delete(exporter);
+}
+
+// Frames read in order, falling behind, skipping to the latest, torn by
+// the exporter lapping the reader, and the ring closing and reopening.
+static void test_export_and_read() {
+    char name[OTK_FRAME_RING_NAME_SIZE];
+    ring_name("stream-1", name);
+    otk_frame_exporter *exporter = otk_frame_exporter_new(prefix, 4, 64, 48);
+    OTK_CHECK(otk_frame_reader_open(name) == nullptr);
+    OTK_CHECK(otk_frame_exporter_add_stream(exporter, "stream-1"));
+    OTK_CHECK(otk_frame_exporter_add_stream(exporter, "stream-1"));
+    otk_frame_reader *reader = otk_frame_reader_open(name);
+    OTK_CHECK(reader != nullptr);
+    OTK_CHECK(std::strcmp(otk_frame_reader_stream_id(reader), "stream-1") == 0);
+
+    otk_exported_frame exported;
+    OTK_CHECK(!otk_frame_reader_next(reader, 0, &exported));
+    image odd = make_image(63, 47, 1, 9);
+    OTK_CHECK(write_frame(exporter, "stream-1", 1234, odd));
+    OTK_CHECK(otk_frame_reader_next(reader, 0, &exported));
+    OTK_CHECK(exported.number == 0 && exported.timestamp == 1234);
+    OTK_CHECK(same_pixels(odd, exported));
+    OTK_CHECK(otk_frame_reader_valid(reader, &exported));
+    OTK_CHECK(!otk_frame_reader_next(reader, 0, &exported));
+
+    // Ten more frames of changing sizes and strides: of the four slots, the
+    // three not being written hold frames 8 to 10.
+    std::vector<image> frames;
+    for (uint32_t i = 1; i <= 10; i++) {
+        frames.push_back(make_image(64 - (i % 3) * 2, 48 - (i % 2), i, i % 5));
+        OTK_CHECK(write_frame(exporter, "stream-1", 0, frames.back()));
+    }
+    std::vector<uint64_t> numbers;
+    while (otk_frame_reader_next(reader, 0, &exported)) {
+        numbers.push_back(exported.number);
+        OTK_CHECK(same_pixels(frames[exported.number - 1], exported));
+        OTK_CHECK(otk_frame_reader_valid(reader, &exported));
+    }
+    OTK_CHECK((numbers == std::vector<uint64_t>{ 8, 9, 10 }));
+    otk_frame_reader_stats reader_stats;
+    otk_frame_reader_get_stats(reader, &reader_stats);
+    OTK_CHECK(reader_stats.skipped == 7);
+
+    for (int i = 0; i < 3; i++) {
+        write_frame(exporter, "stream-1", i, frames[i]);
+    }
+    OTK_CHECK(otk_frame_reader_next(reader, 1, &exported));
+    OTK_CHECK(exported.number == 13 && same_pixels(frames[2], exported));
+    OTK_CHECK(!otk_frame_reader_next(reader, 1, &exported));
+
+    // The slot is only reused on the fourth frame after it.
+    write_frame(exporter, "stream-1", 0, frames[0]);
+    OTK_CHECK(otk_frame_reader_next(reader, 0, &exported));
+    for (int i = 0; i < 3; i++) {
+        write_frame(exporter, "stream-1", 0, frames[1]);
+    }
+    OTK_CHECK(otk_frame_reader_valid(reader, &exported));
+    write_frame(exporter, "stream-1", 0, frames[1]);
+    OTK_CHECK(!otk_frame_reader_valid(reader, &exported));
+    otk_frame_reader_get_stats(reader, &reader_stats);
+    OTK_CHECK(reader_stats.torn == 1);
+
+    image large = make_image(66, 48, 0, 0);
+    OTK_CHECK(!write_frame(exporter, "stream-1", 0, large));
+    OTK_CHECK(!write_frame(exporter, "not-exported", 0, odd));
+    otk_frame_export_stats stats;
+    OTK_CHECK(otk_frame_exporter_get_stats(exporter, "stream-1", &stats));
+    OTK_CHECK(stats.frames == 19 && stats.too_large == 1);
+    OTK_CHECK(!otk_frame_exporter_get_stats(exporter, "not-exported", &stats));
+
+    // Removed: the reader can finish the frames still there, new readers
+    // cannot open it, and a new ring needs a new reader.
+    OTK_CHECK(!otk_frame_reader_closed(reader));
+    otk_frame_exporter_remove_stream(exporter, "stream-1");
+    OTK_CHECK(otk_frame_reader_closed(reader));
+    OTK_CHECK(otk_frame_reader_open(name) == nullptr);
+    int left = 0;
+    while (otk_frame_reader_next(reader, 0, &exported)) {
+        left++;
+    }
+    OTK_CHECK(left == 3);
+    OTK_CHECK(otk_frame_exporter_add_stream(exporter, "stream-1"));
+    otk_frame_reader *reopened = otk_frame_reader_open(name);
+    OTK_CHECK(reopened != nullptr && !otk_frame_reader_closed(reopened));
+    OTK_CHECK(otk_frame_reader_closed(reader));
+    otk_frame_reader_close(reader);
+    otk_frame_reader_close(reopened);
+    otk_frame_exporter_delete(exporter);
+    OTK_CHECK(otk_frame_reader_open(name) == nullptr);
+}
+
+// A reader never reads outside the mapping, whatever is in the ring.
+static void test_damaged_rings() {
+    char name[OTK_FRAME_RING_NAME_SIZE];
+    ring_name("damaged", name);
+    std::mt19937 random(5);
+    for (int trial = 0; trial < 200; trial++) {
+        shm_unlink(name);
+        int fd = shm_open(name, O_RDWR | O_CREAT, S_IRUSR | S_IWUSR);
+        size_t size = 4096 * (1 + trial % 5);
+        OTK_CHECK(ftruncate(fd, (off_t)size) == 0);
+        uint8_t *memory = (uint8_t *)mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+        close(fd);
+        for (size_t i = 0; i < size; i++) {
+            memory[i] = (uint8_t)random();
+        }
+        // With the magic, and half the time the version, right.
+        uint32_t version = 1;
+        std::memcpy(memory, &kRingMagic, 4);
+        if (trial % 2) {
+            std::memcpy(memory + 4, &version, 4);
+        }
+        otk_frame_reader *reader = otk_frame_reader_open(name);
+        if (reader != nullptr) {
+            otk_exported_frame exported;
+            while (otk_frame_reader_next(reader, 0, &exported)) {
+            }
+            otk_frame_reader_close(reader);
+        }
+        munmap(memory, size);
+    }
+    shm_unlink(name);
+
+    // A valid ring with a plane offset pointing far outside it.
+    otk_frame_exporter *exporter = otk_frame_exporter_new(prefix, 4, 64, 48);
+    otk_frame_exporter_add_stream(exporter, "damaged");
+    image frame = make_image(63, 47, 1, 9);
+    write_frame(exporter, "damaged", 0, frame);
+    int fd = shm_open(name, O_RDWR, 0);
+    struct stat status;
+    fstat(fd, &status);
+    uint8_t *memory = (uint8_t *)mmap(nullptr, status.st_size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    close(fd);
+    otk_frame_reader *reader = otk_frame_reader_open(name);
+    OTK_CHECK(reader != nullptr);
+    uint64_t slots_offset, far = 1ull << 40;
+    std::memcpy(&slots_offset, memory + kSlotsOffsetField, 8);
+    std::memcpy(memory + slots_offset + kSlotPlaneOffsetsField + 8, &far, 8);
+    otk_exported_frame exported;
+    OTK_CHECK(!otk_frame_reader_next(reader, 0, &exported));
+    otk_frame_reader_stats stats;
+    otk_frame_reader_get_stats(reader, &stats);
+    OTK_CHECK(stats.skipped == 1);
+    otk_frame_reader_close(reader);
+    munmap(memory, status.st_size);
+    otk_frame_exporter_delete(exporter);
+}
+
+// Streams added and removed while two render threads write to them.
+static void test_streams_change_while_writing() {
+    otk_frame_exporter *exporter = otk_frame_exporter_new(prefix, 3, 64, 64);
+    image frame = make_image(64, 64, 1, 0);
+    std::atomic<bool> stop(false);
+    std::vector<std::thread> writers;
+    for (const char *stream_id : { "a", "b" }) {
+        writers.emplace_back([&, stream_id] {
+            while (!stop) {
+                write_frame(exporter, stream_id, 0, frame);
+                otk_frame_export_stats stats;
+                otk_frame_exporter_get_stats(exporter, "a", &stats);
+            }
+        });
+    }
+    for (int i = 0; i < 500; i++) {
+        otk_frame_exporter_add_stream(exporter, "a");
+        otk_frame_exporter_add_stream(exporter, "b");
+        otk_frame_exporter_remove_stream(exporter, i % 2 ? "a" : "b");
+    }
+    stop = true;
+    for (std::thread &writer : writers) {
+        writer.join();
+    }
+    otk_frame_exporter_delete(exporter);
+}
+
+// A reader in another process, checking that every frame it keeps as valid
+// is the one it was numbered as: all its bytes equal the frame number.
+static void test_reader_process() {
+    const uint32_t width = 320, height = 240;
+    const int frames = 2000;
+    char name[OTK_FRAME_RING_NAME_SIZE];
+    ring_name("process", name);
+    otk_frame_exporter *exporter = otk_frame_exporter_new(prefix, 4, width, height);
+    OTK_CHECK(otk_frame_exporter_add_stream(exporter, "process"));
+    // Opened before forking, so the child reads from the first frame.
+    otk_frame_reader *reader = otk_frame_reader_open(name);
+    OTK_CHECK(reader != nullptr);
+    pid_t child = fork();
+    if (child == 0) {
+        uint64_t valid = 0, inconsistent = 0;
+        otk_exported_frame exported;
+        for (;;) {
+            if (otk_frame_reader_next(reader, 0, &exported)) {
+                uint8_t expected = (uint8_t)exported.number;
+                bool consistent = exported.timestamp == (int64_t)exported.number;
+                for (int k = 0; k < 3; k++) {
+                    uint32_t plane_width = k ? (exported.width + 1) / 2 : exported.width;
+                    uint32_t plane_height = k ? (exported.height + 1) / 2 : exported.height;
+                    for (uint32_t y = 0; y < plane_height; y++) {
+                        const uint8_t *row = exported.planes[k] + (size_t)y * exported.strides[k];
+                        consistent &= row[0] == expected && row[plane_width / 2] == expected &&
+                                      row[plane_width - 1] == expected;
+                    }
+                }
+                if (otk_frame_reader_valid(reader, &exported)) {
+                    valid++;
+                    inconsistent += !consistent;
+                }
+            } else if (otk_frame_reader_closed(reader) && !otk_frame_reader_next(reader, 0, &exported)) {
+                break;
+            }
+        }
+        otk_frame_reader_close(reader);
+        _exit(valid > 0 && inconsistent == 0 ? 0 : 1);
+    }
+    otk_frame_reader_close(reader);
+    std::vector<uint8_t> planes[3];
+    const uint8_t *pointers[3];
+    int strides[3];
+    for (int k = 0; k < 3; k++) {
+        strides[k] = (int)(k ? (width + 1) / 2 : width) + 32;
+        planes[k].resize((size_t)strides[k] * (k ? (height + 1) / 2 : height));
+        pointers[k] = planes[k].data();
+    }
+    for (int i = 0; i < frames; i++) {
+        for (std::vector<uint8_t> &plane : planes) {
+            std::memset(plane.data(), (uint8_t)i, plane.size());
+        }
+        otk_frame_exporter_write(exporter, "process", i, width, height, pointers, strides);
+    }
+    otk_frame_exporter_remove_stream(exporter, "process");
+    int status = 0;
+    OTK_CHECK(waitpid(child, &status, 0) == child);
+    OTK_CHECK(WIFEXITED(status) && WEXITSTATUS(status) == 0);
+    otk_frame_exporter_delete(exporter);
+}
+
+static void benchmark_export() {
+    const uint32_t width = 1280, height = 720;
+    char name[OTK_FRAME_RING_NAME_SIZE];
+    ring_name("benchmark", name);
+    otk_frame_exporter *exporter = otk_frame_exporter_new(prefix, 6, width, height);
+    otk_frame_exporter_add_stream(exporter, "benchmark");
+    otk_frame_reader *reader = otk_frame_reader_open(name);
+    image frame = make_image(width, height, 3, 32);
+    const int frames = 500;
+    int64_t writing = 0, latency = 0;
+    for (int i = 0; i < frames; i++) {
+        int64_t start = otk_test_now_ns();
+        write_frame(exporter, "benchmark", i, frame);
+        writing += otk_test_now_ns() - start;
+        otk_exported_frame exported;
+        otk_frame_reader_next(reader, 1, &exported);
+        latency += otk_test_now_ns() - exported.exported_ns;
+    }
+    otk_frame_export_stats stats;
+    otk_frame_exporter_get_stats(exporter, "benchmark", &stats);
+    std::printf("720p: write %.1f us/frame, %.2f GB/s into the ring, read %.1f us after\n",
+                writing / 1e3 / frames, stats.bytes / (double)writing, latency / 1e3 / frames);
+    otk_frame_reader_close(reader);
+    otk_frame_exporter_delete(exporter);
+}
+
+int main(int argc, char **argv) {
+    otk_test_init(argc, argv);
+    std::snprintf(prefix, sizeof(prefix), "/otkt%d-", (int)getpid());
+    test_ring_names();
+    test_export_and_read();
+    test_damaged_rings();
+    test_streams_change_while_writing();
+    test_reader_process();
+    if (otk_test_benchmarking) {
+        benchmark_export();
+    }
+    return otk_test_result();
+}
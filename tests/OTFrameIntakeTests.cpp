@@ -0,0 +1,92 @@
+//
+//  OTFrameIntakeTests.cpp
+//  tests
+//
+//  Copyright (c) 2026 Vonage. All rights reserved.
+//
+
+#include "OTFrameIntake.h"
+#include "OTTest.h"
+
+#include <thread>
+
+// A 1080p I420 frame.
+static const uint64_t kFrameBytes = 1920 * 1080 * 3 / 2;
+static const int64_t kFrameIntervalUs = 33333;
+
+// Offers a frame every 33 ms from start_us until end_us and returns how many
+// were copied.
+static int offer_frames(otk_frame_intake *intake, int64_t start_us, int64_t end_us) {
+    int copies = 0;
+    for (int64_t now_us = start_us; now_us < end_us; now_us += kFrameIntervalUs) {
+        if (otk_frame_intake_on_frame(intake, kFrameBytes, now_us) == OTK_FRAME_INTAKE_COPY) {
+            copies++;
+        }
+    }
+    return copies;
+}
+
+static void test_hidden_view_keeps_one_frame_a_second() {
+    otk_frame_intake *intake = otk_frame_intake_new(1000000);
+    OTK_CHECK(offer_frames(intake, 0, 1000000) == 31);
+
+    OTK_CHECK(otk_frame_intake_set_hidden_reason(intake, OTK_VIEW_MINIMIZED, 1) == OTK_VIEW_BECAME_HIDDEN);
+    OTK_CHECK(otk_frame_intake_set_hidden_reason(intake, OTK_VIEW_APP_INACTIVE, 1) == OTK_VIEW_VISIBILITY_UNCHANGED);
+    OTK_CHECK(otk_frame_intake_hidden_reasons(intake) == (OTK_VIEW_MINIMIZED | OTK_VIEW_APP_INACTIVE));
+    OTK_CHECK_NEAR(offer_frames(intake, 1000000, 5000000), 4, 1);
+
+    // Visible again only once every reason is cleared.
+    OTK_CHECK(otk_frame_intake_set_hidden_reason(intake, OTK_VIEW_MINIMIZED, 0) == OTK_VIEW_VISIBILITY_UNCHANGED);
+    OTK_CHECK(otk_frame_intake_set_hidden_reason(intake, OTK_VIEW_APP_INACTIVE, 0) == OTK_VIEW_BECAME_VISIBLE);
+    OTK_CHECK(otk_frame_intake_hidden_reasons(intake) == 0);
+    OTK_CHECK(offer_frames(intake, 5000000, 6000000) == 31);
+
+    otk_frame_intake_stats stats;
+    otk_frame_intake_get_stats(intake, &stats);
+    OTK_CHECK(stats.frames_copied + stats.frames_skipped == 31 + 121 + 31);
+    OTK_CHECK(stats.bytes_copied == stats.frames_copied * kFrameBytes);
+    OTK_CHECK(stats.bytes_skipped == stats.frames_skipped * kFrameBytes);
+    OTK_CHECK(stats.resumes == 1);
+    otk_frame_intake_delete(intake);
+}
+
+static void test_no_hidden_refresh() {
+    otk_frame_intake *intake = otk_frame_intake_new(0);
+    otk_frame_intake_set_hidden_reason(intake, OTK_VIEW_ZERO_SIZE, 1);
+    OTK_CHECK(offer_frames(intake, 0, 5000000) == 0);
+    // Setting a reason twice does not need clearing twice.
+    otk_frame_intake_set_hidden_reason(intake, OTK_VIEW_ZERO_SIZE, 1);
+    OTK_CHECK(otk_frame_intake_set_hidden_reason(intake, OTK_VIEW_ZERO_SIZE, 0) == OTK_VIEW_BECAME_VISIBLE);
+    OTK_CHECK(otk_frame_intake_on_frame(intake, kFrameBytes, 5000000) == OTK_FRAME_INTAKE_COPY);
+    otk_frame_intake_delete(intake);
+}
+
+// Reasons changed from another thread while frames are delivered.
+static void test_concurrent_reasons() {
+    otk_frame_intake *intake = otk_frame_intake_new(1000000);
+    std::thread toggler([intake] {
+        for (int i = 0; i < 10000; i++) {
+            otk_frame_intake_set_hidden_reason(intake, OTK_VIEW_OCCLUDED, 1);
+            otk_frame_intake_set_hidden_reason(intake, OTK_VIEW_HIDDEN, i % 2);
+            otk_frame_intake_set_hidden_reason(intake, OTK_VIEW_OCCLUDED, 0);
+        }
+        otk_frame_intake_set_hidden_reason(intake, OTK_VIEW_HIDDEN, 0);
+    });
+    for (int i = 0; i < 10000; i++) {
+        otk_frame_intake_on_frame(intake, kFrameBytes, i * kFrameIntervalUs);
+    }
+    toggler.join();
+    OTK_CHECK(otk_frame_intake_hidden_reasons(intake) == 0);
+    otk_frame_intake_stats stats;
+    otk_frame_intake_get_stats(intake, &stats);
+    OTK_CHECK(stats.frames_copied + stats.frames_skipped == 10000);
+    otk_frame_intake_delete(intake);
+}
+
+int main(int argc, char **argv) {
+    otk_test_init(argc, argv);
+    test_hidden_view_keeps_one_frame_a_second();
+    test_no_hidden_refresh();
+    test_concurrent_reasons();
+    return otk_test_result();
+}
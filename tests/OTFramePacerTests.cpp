@@ -0,0 +1,102 @@
+//
+//  OTFramePacerTests.cpp
+//  tests
+//
+//  Copyright (c) 2026 Vonage. All rights reserved.
+//
+
+#include "OTFramePacer.h"
+#include "OTTest.h"
+
+static const int64_t kRefreshPeriodUs = 16667;
+
+// Drives a pacer on a 60 Hz display for duration_us, with frames arriving
+// every frame_interval_us and each draw taking draw_us.
+static otk_frame_pacer_stats simulate(int64_t frame_interval_us, int64_t draw_us, int64_t duration_us) {
+    otk_frame_pacer *pacer = otk_frame_pacer_new();
+    int64_t next_frame_us = 1000;
+    int64_t next_refresh_us = 0;
+    int64_t draw_done_us = -1;
+    for (int64_t now_us = 0; now_us < duration_us; now_us += 100) {
+        if (now_us >= next_frame_us) {
+            otk_frame_pacer_frame_arrived(pacer, now_us);
+            next_frame_us += frame_interval_us;
+        }
+        if (draw_done_us >= 0 && now_us >= draw_done_us) {
+            otk_frame_pacer_frame_presented(pacer, now_us);
+            draw_done_us = -1;
+        }
+        if (now_us >= next_refresh_us) {
+            if (otk_frame_pacer_on_refresh(pacer, kRefreshPeriodUs)) {
+                draw_done_us = now_us + draw_us;
+            }
+            next_refresh_us += kRefreshPeriodUs;
+        }
+    }
+    otk_frame_pacer_stats stats;
+    otk_frame_pacer_get_stats(pacer, &stats);
+    otk_frame_pacer_delete(pacer);
+    return stats;
+}
+
+// 30 fps on a 60 Hz display with quick draws: every frame is drawn on time
+// and every other refresh has nothing to draw.
+static void test_steady_source() {
+    otk_frame_pacer_stats stats = simulate(33333, 500, 1000000);
+    OTK_CHECK(stats.frames_received == 30);
+    OTK_CHECK(stats.frames_presented == stats.frames_received);
+    OTK_CHECK(stats.frames_dropped == 0);
+    OTK_CHECK(stats.frames_late == 0);
+    OTK_CHECK_NEAR(stats.refreshes_skipped, 30, 1);
+}
+
+// 120 fps on a 60 Hz display: half the frames are replaced before a refresh.
+static void test_fast_source() {
+    otk_frame_pacer_stats stats = simulate(8333, 500, 1000000);
+    OTK_CHECK_NEAR(stats.frames_received, 120, 1);
+    OTK_CHECK_NEAR(stats.frames_presented, 60, 1);
+    // Up to one frame waiting and one being drawn when the run stops.
+    OTK_CHECK(stats.frames_presented + stats.frames_dropped <= stats.frames_received);
+    OTK_CHECK(stats.frames_presented + stats.frames_dropped + 2 >= stats.frames_received);
+    OTK_CHECK(stats.frames_late == 0);
+}
+
+// Draws slower than the refresh: no draw starts while one is in progress,
+// and frames that waited are counted late.
+static void test_slow_draws() {
+    otk_frame_pacer_stats stats = simulate(33333, 40000, 1000000);
+    OTK_CHECK(stats.frames_received == 30);
+    OTK_CHECK(stats.frames_presented <= 1000000 / 40000);
+    OTK_CHECK(stats.frames_dropped > 0);
+    OTK_CHECK(stats.frames_late > 0);
+    OTK_CHECK(stats.frames_presented + stats.frames_dropped <= stats.frames_received);
+}
+
+// A cancelled draw is not counted and does not block the next one.
+static void test_draw_cancelled() {
+    otk_frame_pacer *pacer = otk_frame_pacer_new();
+    otk_frame_pacer_frame_arrived(pacer, 0);
+    OTK_CHECK(otk_frame_pacer_on_refresh(pacer, kRefreshPeriodUs));
+    otk_frame_pacer_draw_cancelled(pacer);
+    // Nothing new to draw yet.
+    OTK_CHECK(!otk_frame_pacer_on_refresh(pacer, kRefreshPeriodUs));
+    otk_frame_pacer_frame_arrived(pacer, 20000);
+    OTK_CHECK(otk_frame_pacer_on_refresh(pacer, kRefreshPeriodUs));
+    otk_frame_pacer_frame_presented(pacer, 21000);
+
+    otk_frame_pacer_stats stats;
+    otk_frame_pacer_get_stats(pacer, &stats);
+    OTK_CHECK(stats.frames_received == 2);
+    OTK_CHECK(stats.frames_presented == 1);
+    OTK_CHECK(stats.frames_dropped == 0);
+    otk_frame_pacer_delete(pacer);
+}
+
+int main(int argc, char **argv) {
+    otk_test_init(argc, argv);
+    test_steady_source();
+    test_fast_source();
+    test_slow_draws();
+    test_draw_cancelled();
+    return otk_test_result();
+}
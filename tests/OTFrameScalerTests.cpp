@@ -0,0 +1,171 @@
+//
+//  OTFrameScalerTests.cpp
+//  tests
+//
+//  Copyright (c) 2026 Vonage. All rights reserved.
+//
+
+#include "OTFrameScaler.h"
+#include "OTTest.h"
+
+#include <random>
+#include <vector>
+
+// Odd sizes and padded chroma rows, so the kernels' tails and strides are
+// exercised.
+static const int kWidth = 1922;
+static const int kHeight = 1082;
+static const int kChromaStride = kWidth / 2 + 5;
+
+struct test_frame {
+    std::vector<uint8_t> y, u, v;
+    const uint8_t *planes[3];
+    int strides[3];
+
+    test_frame() : y(kWidth * kHeight), u(kChromaStride * kHeight / 2), v(kChromaStride * kHeight / 2) {
+        std::mt19937 random(1);
+        // Smooth picture with a little noise in luma, noise in chroma.
+        for (int j = 0; j < kHeight; j++) {
+            for (int i = 0; i < kWidth; i++) {
+                y[j * kWidth + i] = (uint8_t)(128 + 100 * std::sin(i * 0.01) * std::cos(j * 0.013) + random() % 5);
+            }
+        }
+        for (uint8_t &sample : u) {
+            sample = (uint8_t)random();
+        }
+        for (uint8_t &sample : v) {
+            sample = (uint8_t)random();
+        }
+        planes[0] = y.data();
+        planes[1] = u.data();
+        planes[2] = v.data();
+        strides[0] = kWidth;
+        strides[1] = kChromaStride;
+        strides[2] = kChromaStride;
+    }
+};
+
+static double box_average(const uint8_t *src, int stride, int x, int y, int factor) {
+    int sum = 0;
+    for (int j = 0; j < factor; j++) {
+        for (int i = 0; i < factor; i++) {
+            sum += src[(y * factor + j) * stride + x * factor + i];
+        }
+    }
+    return (double)sum / (factor * factor);
+}
+
+static double psnr(double squared_error, int64_t count) {
+    return squared_error == 0 ? INFINITY : 10 * std::log10(255.0 * 255.0 * count / squared_error);
+}
+
+static void test_select_factor() {
+    OTK_CHECK(otk_frame_scaler_select_factor(1920, 1080, 320, 240) == 4);
+    OTK_CHECK(otk_frame_scaler_select_factor(1920, 1080, 640, 360) == 2);
+    OTK_CHECK(otk_frame_scaler_select_factor(1280, 720, 1280, 720) == 1);
+    OTK_CHECK(otk_frame_scaler_select_factor(1920, 1080, 0, 0) == 1);
+    // Half the width would be narrower than the view.
+    OTK_CHECK(otk_frame_scaler_select_factor(1920, 1080, 961, 100) == 1);
+}
+
+// Each output pixel is the box average, rounded: against the exact average
+// the only error is the rounding, and the luma still resembles the source
+// after upsampling it back.
+static void test_kernels_against_box_filter() {
+    test_frame frame;
+    otk_frame_scaler *scaler = otk_frame_scaler_new(3);
+    for (int factor : { 2, 4 }) {
+        otk_scaled_frame *scaled = otk_frame_scaler_scale_i420(scaler, frame.planes, frame.strides,
+                                                               kWidth, kHeight, factor);
+        OTK_CHECK(scaled != nullptr);
+        if (scaled == nullptr) {
+            continue;
+        }
+        OTK_CHECK(scaled->width == (kWidth / factor) / 2 * 2);
+        OTK_CHECK(scaled->height == (kHeight / factor) / 2 * 2);
+
+        double squared_error = 0;
+        int64_t count = 0;
+        int mismatches = 0;
+        for (int plane = 0; plane < 3; plane++) {
+            int width = plane == 0 ? scaled->width : scaled->width / 2;
+            int height = plane == 0 ? scaled->height : scaled->height / 2;
+            for (int j = 0; j < height; j++) {
+                for (int i = 0; i < width; i++) {
+                    double average = box_average(frame.planes[plane], frame.strides[plane], i, j, factor);
+                    int value = scaled->planes[plane][j * scaled->strides[plane] + i];
+                    if (value != (int)(average + 0.5)) {
+                        mismatches++;
+                    }
+                    squared_error += (value - average) * (value - average);
+                    count++;
+                }
+            }
+        }
+        OTK_CHECK(mismatches == 0);
+        OTK_CHECK(psnr(squared_error, count) > 50);
+
+        squared_error = 0;
+        count = 0;
+        for (int j = 0; j < scaled->height * factor; j++) {
+            for (int i = 0; i < scaled->width * factor; i++) {
+                double error = frame.y[j * kWidth + i] - scaled->planes[0][(j / factor) * scaled->strides[0] + i / factor];
+                squared_error += error * error;
+                count++;
+            }
+        }
+        OTK_CHECK(psnr(squared_error, count) > (factor == 2 ? 44 : 42));
+        otk_scaled_frame_release(scaled);
+    }
+    otk_frame_scaler_delete(scaler);
+}
+
+static void test_pool_and_stats() {
+    test_frame frame;
+    otk_frame_scaler *scaler = otk_frame_scaler_new(2);
+    for (int i = 0; i < 10; i++) {
+        otk_scaled_frame_release(otk_frame_scaler_scale_i420(scaler, frame.planes, frame.strides, kWidth, kHeight, 2));
+    }
+    OTK_CHECK(otk_frame_scaler_scale_i420(scaler, frame.planes, frame.strides, kWidth, kHeight, 3) == nullptr);
+    OTK_CHECK(otk_frame_scaler_scale_i420(scaler, frame.planes, frame.strides, 2, 2, 4) == nullptr);
+    OTK_CHECK(otk_frame_scaler_scale_i420(nullptr, frame.planes, frame.strides, kWidth, kHeight, 2) == nullptr);
+
+    otk_frame_scaler_stats stats;
+    otk_frame_scaler_get_stats(scaler, &stats);
+    OTK_CHECK(stats.frames_scaled == 10);
+    OTK_CHECK(stats.buffers_allocated == 1);
+    OTK_CHECK(stats.bytes_out * 4 <= stats.bytes_in);
+
+    // A frame outlives its scaler; OTK_SANITIZE builds catch a use after free.
+    otk_scaled_frame *kept = otk_frame_scaler_scale_i420(scaler, frame.planes, frame.strides, kWidth, kHeight, 4);
+    otk_frame_scaler_delete(scaler);
+    OTK_CHECK(kept->planes[0][0] != 0);
+    otk_scaled_frame_release(kept);
+}
+
+static void benchmark_scale() {
+    test_frame frame;
+    otk_frame_scaler *scaler = otk_frame_scaler_new(3);
+    for (int factor : { 2, 4 }) {
+        const int iterations = 300;
+        int64_t start = otk_test_now_ns();
+        for (int i = 0; i < iterations; i++) {
+            otk_scaled_frame_release(otk_frame_scaler_scale_i420(scaler, frame.planes, frame.strides,
+                                                                 kWidth, kHeight, factor));
+        }
+        std::printf("%dx%d by %d: %.3f ms/frame\n", kWidth, kHeight, factor,
+                    (double)(otk_test_now_ns() - start) / iterations / 1e6);
+    }
+    otk_frame_scaler_delete(scaler);
+}
+
+int main(int argc, char **argv) {
+    otk_test_init(argc, argv);
+    test_select_factor();
+    test_kernels_against_box_filter();
+    test_pool_and_stats();
+    if (otk_test_benchmarking) {
+        benchmark_scale();
+    }
+    return otk_test_result();
+}
@@ -0,0 +1,58 @@
+//
+//  OTFrameStampTests.cpp
+//  tests
+//
+//  Copyright (c) 2026 Vonage. All rights reserved.
+//
+
+#include "OTFrameStamp.h"
+#include "OTTest.h"
+
+static void test_round_trip() {
+    otk_frame_stamp stamp = { 7, 42, 123456789012ull };
+    uint8_t buffer[32];
+    OTK_CHECK(otk_frame_stamp_encode(&stamp, buffer, sizeof(buffer)) == OTK_FRAME_STAMP_SIZE);
+    otk_frame_stamp decoded = {};
+    OTK_CHECK(otk_frame_stamp_decode(buffer, OTK_FRAME_STAMP_SIZE, &decoded));
+    OTK_CHECK(decoded.publisher_id == 7);
+    OTK_CHECK(decoded.sequence == 42);
+    OTK_CHECK(decoded.capture_time_us == stamp.capture_time_us);
+
+    OTK_CHECK(otk_frame_stamp_encode(&stamp, buffer, OTK_FRAME_STAMP_SIZE - 1) == 0);
+    OTK_CHECK(!otk_frame_stamp_decode(buffer, OTK_FRAME_STAMP_SIZE - 1, &decoded));
+    // Metadata someone else put on the frame.
+    buffer[0] ^= 0xff;
+    OTK_CHECK(!otk_frame_stamp_decode(buffer, OTK_FRAME_STAMP_SIZE, &decoded));
+}
+
+static void test_loss_reordering_and_duplicates() {
+    otk_frame_latency_tracker *tracker = otk_frame_latency_tracker_new(100);
+    // 3 arrives after 4, 5 twice, 6 and 7 never.
+    const uint32_t order[] = { 0, 1, 2, 4, 3, 5, 5, 8, 9, 10 };
+    for (uint32_t sequence : order) {
+        otk_frame_stamp stamp = { 7, sequence, 1000 + sequence * 33000ull };
+        // 20 ms plus 0.1 ms per frame.
+        otk_frame_latency_tracker_add(tracker, &stamp, stamp.capture_time_us + 20000 + sequence * 100);
+    }
+    otk_frame_latency_stats stats;
+    otk_frame_latency_tracker_get_stats(tracker, &stats);
+    OTK_CHECK(stats.frames_received == 9);
+    OTK_CHECK(stats.frames_lost == 2);
+    OTK_CHECK(stats.frames_reordered == 1);
+    OTK_CHECK(stats.frames_duplicated == 1);
+    OTK_CHECK(stats.latency_p50_us >= 20000 && stats.latency_p50_us <= 21000);
+    OTK_CHECK(stats.latency_max_us == 21000);
+    OTK_CHECK(stats.relative_p95_us <= 1000);
+
+    otk_frame_latency_tracker_reset(tracker);
+    otk_frame_latency_tracker_get_stats(tracker, &stats);
+    OTK_CHECK(stats.frames_received == 0);
+    otk_frame_latency_tracker_delete(tracker);
+}
+
+int main(int argc, char **argv) {
+    otk_test_init(argc, argv);
+    test_round_trip();
+    test_loss_reordering_and_duplicates();
+    return otk_test_result();
+}
@@ -0,0 +1,166 @@
+//
+//  OTJitterBufferTests.cpp
+//  tests
+//
+//  Copyright (c) 2026 Vonage. All rights reserved.
+//
+
+#include "OTJitterBuffer.h"
+#include "OTTest.h"
+
+#include <cstdlib>
+#include <random>
+#include <utility>
+#include <vector>
+
+static const int64_t kFrameIntervalUs = 33333;
+
+static void count_release(void *, void *user_data) {
+    (*(int *)user_data)++;
+}
+
+struct jitter_run {
+    otk_jitter_buffer_stats stats;
+    int64_t frames_popped;
+    int released;
+    // Judder of presenting each frame as it arrives.
+    double arrival_judder_us;
+};
+
+// 600 frames at 30 fps, each delayed by 50 ms plus an exponentially
+// distributed jitter, presented on a 60 Hz display.
+static jitter_run simulate(double jitter_ms, int64_t first_timestamp) {
+    jitter_run run = {};
+    otk_jitter_buffer_config config;
+    otk_jitter_buffer_config_default(&config);
+    config.release = count_release;
+    config.release_user_data = &run.released;
+    otk_jitter_buffer *buffer = otk_jitter_buffer_new(&config);
+
+    std::mt19937 random(3);
+    std::exponential_distribution<double> jitter(1.0 / (jitter_ms * 1000 + 1));
+    // (arrival, timestamp), in arrival order.
+    std::vector<std::pair<int64_t, int64_t>> frames;
+    for (int i = 0; i < 600; i++) {
+        int64_t timestamp = first_timestamp + i * kFrameIntervalUs;
+        int64_t arrival = i * kFrameIntervalUs + 50000 + (int64_t)jitter(random);
+        if (!frames.empty() && arrival < frames.back().first) {
+            arrival = frames.back().first + 100;
+        }
+        frames.push_back({ arrival, timestamp });
+    }
+    for (size_t i = 1; i < frames.size(); i++) {
+        run.arrival_judder_us += std::abs((frames[i].first - frames[i - 1].first) -
+                                          (frames[i].second - frames[i - 1].second));
+    }
+    run.arrival_judder_us /= frames.size() - 1;
+
+    size_t next = 0;
+    int frame_ids[600];
+    for (int64_t now_us = 0; now_us < 21000000; now_us += 16667) {
+        for (; next < frames.size() && frames[next].first <= now_us; next++) {
+            otk_jitter_buffer_push(buffer, &frame_ids[next], frames[next].second, frames[next].first);
+        }
+        if (otk_jitter_buffer_pop(buffer, now_us) != nullptr) {
+            run.frames_popped++;
+        }
+    }
+    otk_jitter_buffer_get_stats(buffer, &run.stats);
+    otk_jitter_buffer_delete(buffer);
+    return run;
+}
+
+static void test_no_jitter() {
+    jitter_run run = simulate(0, 1000);
+    OTK_CHECK(run.stats.frames_received == 600);
+    OTK_CHECK(run.stats.frames_presented == 600);
+    OTK_CHECK(run.stats.frames_dropped == 0);
+    OTK_CHECK(run.stats.target_delay_us == 5000);
+    // Only the display quantizing the frame interval.
+    OTK_CHECK(run.stats.average_judder_us < 1000);
+}
+
+static void test_jitter_is_smoothed() {
+    // Timestamps from an arbitrary origin, as a publisher's clock would be.
+    for (double jitter_ms : { 5.0, 20.0 }) {
+        jitter_run run = simulate(jitter_ms, jitter_ms == 5.0 ? 123456789012345ll : 0);
+        OTK_CHECK(run.stats.frames_received == 600);
+        OTK_CHECK(run.stats.frames_presented >= 580);
+        OTK_CHECK(run.stats.average_judder_us < run.arrival_judder_us / 4);
+        // The delay follows the jitter, within the margin and the limits.
+        OTK_CHECK(run.stats.target_delay_us >= run.stats.jitter_p95_us);
+        OTK_CHECK(run.stats.target_delay_us <= run.stats.jitter_p95_us + 5000);
+        OTK_CHECK(run.stats.average_added_latency_us < 2 * run.stats.target_delay_us);
+    }
+}
+
+static void test_delay_is_capped() {
+    jitter_run run = simulate(60, 0);
+    OTK_CHECK(run.stats.jitter_p95_us > 100000);
+    OTK_CHECK(run.stats.target_delay_us == 100000);
+    OTK_CHECK(run.stats.average_judder_us < run.arrival_judder_us);
+}
+
+// Every frame is either returned by a pop or released, once.
+static void test_every_frame_is_released_once() {
+    for (double jitter_ms : { 0.0, 20.0, 60.0 }) {
+        jitter_run run = simulate(jitter_ms, 0);
+        OTK_CHECK(run.frames_popped == (int64_t)run.stats.frames_presented);
+        OTK_CHECK(run.frames_popped + run.released == 600);
+    }
+}
+
+// A publisher restarting its clock: the frames queued on the old timeline
+// are dropped and the new one starts right away.
+static void test_timeline_reset() {
+    int released = 0;
+    otk_jitter_buffer_config config;
+    otk_jitter_buffer_config_default(&config);
+    config.release = count_release;
+    config.release_user_data = &released;
+    otk_jitter_buffer *buffer = otk_jitter_buffer_new(&config);
+    int frames[4];
+    for (int i = 0; i < 3; i++) {
+        otk_jitter_buffer_push(buffer, &frames[i], 10000000 + i * kFrameIntervalUs, 1000 + i * kFrameIntervalUs);
+    }
+    // 10 s back.
+    int64_t now_us = 1000 + 3 * kFrameIntervalUs;
+    otk_jitter_buffer_push(buffer, &frames[3], 0, now_us);
+    OTK_CHECK(released == 3);
+    OTK_CHECK(otk_jitter_buffer_pop(buffer, now_us + 200000) == &frames[3]);
+    otk_jitter_buffer_stats stats;
+    otk_jitter_buffer_get_stats(buffer, &stats);
+    OTK_CHECK(stats.frames_dropped == 3);
+    OTK_CHECK(stats.frames_presented == 1);
+    otk_jitter_buffer_delete(buffer);
+    OTK_CHECK(released == 3);
+}
+
+static void test_flush() {
+    int released = 0;
+    otk_jitter_buffer_config config;
+    otk_jitter_buffer_config_default(&config);
+    config.release = count_release;
+    config.release_user_data = &released;
+    otk_jitter_buffer *buffer = otk_jitter_buffer_new(&config);
+    int frames[3];
+    for (int i = 0; i < 3; i++) {
+        otk_jitter_buffer_push(buffer, &frames[i], i * kFrameIntervalUs, i * kFrameIntervalUs);
+    }
+    otk_jitter_buffer_flush(buffer);
+    OTK_CHECK(released == 3);
+    OTK_CHECK(otk_jitter_buffer_pop(buffer, 1000000) == nullptr);
+    otk_jitter_buffer_delete(buffer);
+    OTK_CHECK(released == 3);
+}
+
+int main(int argc, char **argv) {
+    otk_test_init(argc, argv);
+    test_no_jitter();
+    test_jitter_is_smoothed();
+    test_delay_is_capped();
+    test_every_frame_is_released_once();
+    test_timeline_reset();
+    test_flush();
+    return otk_test_result();
+}
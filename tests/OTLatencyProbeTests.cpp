@@ -0,0 +1,225 @@
+//
+//  OTLatencyProbeTests.cpp
+//  tests
+//
+//  Copyright (c) 2026 Vonage. All rights reserved.
+//
+
+#include "OTLatencyProbe.h"
+#include "OTTest.h"
+
+#include <algorithm>
+#include <atomic>
+#include <random>
+#include <thread>
+#include <vector>
+
+static const int kRate = 48000;
+
+// A 100 ms linear chirp from 300 Hz to 6 kHz.
+static std::vector<float> make_chirp() {
+    std::vector<float> chirp(kRate / 10);
+    double sweep = (6000 - 300) / 0.1;
+    for (size_t i = 0; i < chirp.size(); i++) {
+        double t = (double)i / kRate;
+        chirp[i] = (float)(0.25 * std::sin(2 * M_PI * (300 * t + 0.5 * sweep * t * t)));
+    }
+    return chirp;
+}
+
+// The signal at a fractional position, by windowed sinc interpolation.
+static float sample_at(const std::vector<float> &signal, double position) {
+    int center = (int)std::floor(position);
+    double value = 0;
+    for (int k = center - 16; k <= center + 16; k++) {
+        if (k < 0 || k >= (int)signal.size()) {
+            continue;
+        }
+        double distance = position - k;
+        double window = 0.5 + 0.5 * std::cos(M_PI * distance / 17);
+        double sinc = std::fabs(distance) < 1e-9 ? 1 : std::sin(M_PI * distance) / (M_PI * distance);
+        value += signal[k] * sinc * window;
+    }
+    return (float)value;
+}
+
+// Found to a quarter of a sample at fractional delays, in noise as strong
+// as the chirp, inverted, and with a weaker echo behind it.
+static void test_find() {
+    std::mt19937 random(7);
+    std::normal_distribution<float> gaussian(0, 1);
+    std::vector<float> chirp = make_chirp();
+    for (double delay : { 0.0, 123.0, 1000.25, 4567.5, 20000.75, 25000.1 }) {
+        for (int variant = 0; variant < 3; variant++) {
+            std::vector<float> signal(30000);
+            for (float &value : signal) {
+                value = gaussian(random) * (variant == 1 ? 0.177f : 0.02f);
+            }
+            for (size_t i = 0; i < signal.size(); i++) {
+                double position = i - delay;
+                if (position > -20 && position < chirp.size() + 20) {
+                    float value = sample_at(chirp, position);
+                    signal[i] += variant == 1 ? value : variant == 2 ? -0.5f * value : 0.5f * value;
+                }
+                double echo = position - 300;
+                if (variant == 2 && echo > -20 && echo < chirp.size() + 20) {
+                    signal[i] += 0.3f * sample_at(chirp, echo);
+                }
+            }
+            double offset = 0, confidence = 0;
+            int found = otk_latency_find(signal.data(), signal.size(), chirp.data(), chirp.size(), 8,
+                                         &offset, &confidence);
+            if (!found || std::fabs(offset - delay) >= 0.25) {
+                std::fprintf(stderr, "delay %.2f, variant %d: found %d at %.3f, confidence %.1f\n",
+                             delay, variant, found, offset, confidence);
+            }
+            OTK_CHECK(found);
+            OTK_CHECK(std::fabs(offset - delay) < 0.25);
+        }
+    }
+
+    // Noise alone is not mistaken for the chirp.
+    std::vector<float> noise(30000);
+    for (float &value : noise) {
+        value = gaussian(random) * 0.1f;
+    }
+    double offset = 0, confidence = 0;
+    OTK_CHECK(!otk_latency_find(noise.data(), noise.size(), chirp.data(), chirp.size(), 8, &offset, &confidence));
+    OTK_CHECK(confidence < 8);
+}
+
+// A simulated device: jittery callback times, a fixed acoustic path, the
+// chirp played over quiet noise and captured at 30% with a noise floor.
+static void test_probe_measures_path() {
+    std::mt19937 random(9);
+    std::normal_distribution<float> gaussian(0, 1);
+    std::uniform_real_distribution<double> jitter(-0.0002, 0.0002);
+    const int block = 480;
+    const double render_start = 0.0123, capture_start = 0.0071;
+    for (double path_ms : { 37.3, 212.9 }) {
+        otk_latency_probe *probe = otk_latency_probe_new(kRate);
+        otk_latency_probe_start(probe, 10);
+        OTK_CHECK(otk_latency_probe_active(probe));
+        std::vector<float> played;
+        std::vector<int16_t> rendered(block), captured(block);
+        for (int k = 0; k < kRate * 12 / block; k++) {
+            for (int16_t &value : rendered) {
+                value = (int16_t)(gaussian(random) * 300);
+            }
+            double render_time = render_start + (double)k * block / kRate;
+            otk_latency_probe_render(probe, rendered.data(), block, (int64_t)((render_time + jitter(random)) * 1e9));
+            for (int16_t value : rendered) {
+                played.push_back(value / 32768.0f);
+            }
+            double capture_time = capture_start + (double)k * block / kRate;
+            for (int i = 0; i < block; i++) {
+                double position = (capture_time + (double)i / kRate - path_ms / 1000 - render_start) * kRate;
+                float value = position > 0 && position < played.size() - 17 ? 0.3f * sample_at(played, position) : 0;
+                value = std::clamp(value + gaussian(random) * 0.01f, -1.0f, 1.0f);
+                captured[i] = (int16_t)std::lrint(value * 32767);
+            }
+            otk_latency_probe_capture(probe, captured.data(), block, (int64_t)((capture_time + jitter(random)) * 1e9));
+            if (k % 10 == 0) {
+                otk_latency_probe_analyze(probe);
+            }
+        }
+        otk_latency_probe_analyze(probe);
+        otk_latency_stats stats;
+        otk_latency_probe_get_stats(probe, &stats);
+        OTK_CHECK(stats.measurements == 10);
+        OTK_CHECK(stats.failures == 0);
+        OTK_CHECK_NEAR(stats.mean_ms, path_ms, 0.3);
+        OTK_CHECK(stats.stddev_ms < 0.3);
+        OTK_CHECK(stats.min_ms <= stats.mean_ms && stats.mean_ms <= stats.max_ms);
+        OTK_CHECK(!otk_latency_probe_active(probe));
+        otk_latency_probe_delete(probe);
+    }
+}
+
+static void test_stop() {
+    otk_latency_probe *probe = otk_latency_probe_new(kRate);
+    otk_latency_probe_start(probe, 5);
+    std::vector<int16_t> block(480);
+    for (int k = 0; k < 20; k++) {
+        otk_latency_probe_render(probe, block.data(), 480, k * 10000000LL);
+    }
+    OTK_CHECK(otk_latency_probe_active(probe));
+    otk_latency_probe_stop(probe);
+    OTK_CHECK(!otk_latency_probe_active(probe));
+    // Nothing more is played.
+    std::fill(block.begin(), block.end(), 7);
+    otk_latency_probe_render(probe, block.data(), 480, 200000000LL);
+    OTK_CHECK(std::all_of(block.begin(), block.end(), [](int16_t sample) { return sample == 7; }));
+    OTK_CHECK(otk_latency_probe_analyze(probe) == 0);
+    otk_latency_probe_delete(probe);
+}
+
+// Render, capture and analysis on their own threads, with the captured
+// audio looped back from what was rendered.
+static void test_threads() {
+    otk_latency_probe *probe = otk_latency_probe_new(kRate);
+    otk_latency_probe_start(probe, 3);
+    std::atomic<bool> stop(false);
+    std::vector<int16_t> loop(kRate * 10);
+    std::atomic<size_t> written(0);
+    int64_t origin = otk_test_now_ns();
+    std::thread render([&] {
+        std::vector<int16_t> block(480);
+        for (size_t n = 0; !stop && n + 480 < loop.size(); n += 480) {
+            std::fill(block.begin(), block.end(), 0);
+            otk_latency_probe_render(probe, block.data(), 480, otk_test_now_ns() - origin + 1);
+            std::copy(block.begin(), block.end(), loop.begin() + n);
+            written = n + 480;
+            std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        }
+    });
+    std::thread capture([&] {
+        for (size_t n = 0; !stop;) {
+            if (n + 480 <= written) {
+                otk_latency_probe_capture(probe, loop.data() + n, 480, otk_test_now_ns() - origin + 1);
+                n += 480;
+            }
+            std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        }
+    });
+    for (int i = 0; i < 400 && otk_latency_probe_active(probe); i++) {
+        otk_latency_probe_analyze(probe);
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+    stop = true;
+    render.join();
+    capture.join();
+    otk_latency_stats stats;
+    otk_latency_probe_get_stats(probe, &stats);
+    OTK_CHECK(stats.measurements + stats.failures == 3);
+    otk_latency_probe_delete(probe);
+}
+
+static void benchmark_find() {
+    std::mt19937 random(3);
+    std::normal_distribution<float> gaussian(0, 0.1f);
+    std::vector<float> chirp = make_chirp();
+    std::vector<float> signal(kRate * 720 / 1000);
+    for (float &value : signal) {
+        value = gaussian(random);
+    }
+    const int iterations = 10;
+    int64_t start = otk_test_now_ns();
+    for (int i = 0; i < iterations; i++) {
+        double offset, confidence;
+        otk_latency_find(signal.data(), signal.size(), chirp.data(), chirp.size(), 8, &offset, &confidence);
+    }
+    std::printf("find over 720 ms: %.2f ms\n", (double)(otk_test_now_ns() - start) / iterations / 1e6);
+}
+
+int main(int argc, char **argv) {
+    otk_test_init(argc, argv);
+    test_find();
+    test_probe_measures_path();
+    test_stop();
+    test_threads();
+    if (otk_test_benchmarking) {
+        benchmark_find();
+    }
+    return otk_test_result();
+}
@@ -0,0 +1,68 @@
+//
+//  OTPreferredResolutionTests.cpp
+//  tests
+//
+//  Copyright (c) 2026 Vonage. All rights reserved.
+//
+
+#include "OTPreferredResolution.h"
+#include "OTTest.h"
+
+static void test_select_step() {
+    otk_preferred_resolution_config config;
+    otk_preferred_resolution_config_default(&config);
+    OTK_CHECK(config.step_count == 4);
+
+    // The smallest step that covers the view.
+    OTK_CHECK(otk_preferred_resolution_select_step(&config, 200, 100, -1) == 0);
+    OTK_CHECK(otk_preferred_resolution_select_step(&config, 320, 240, -1) == 1);
+    OTK_CHECK(otk_preferred_resolution_select_step(&config, 640, 480, -1) == 2);
+    OTK_CHECK(otk_preferred_resolution_select_step(&config, 4000, 3000, -1) == 3);
+
+    // Moving up is immediate, possibly by several steps.
+    OTK_CHECK(otk_preferred_resolution_select_step(&config, 1300, 700, 1) == 3);
+    // A view within the current step keeps it, and moving down waits for
+    // the view to clear the margin below the step.
+    OTK_CHECK(otk_preferred_resolution_select_step(&config, 600, 340, 1) == 1);
+    OTK_CHECK(otk_preferred_resolution_select_step(&config, 580, 330, 1) == 1);
+    OTK_CHECK(otk_preferred_resolution_select_step(&config, 620, 350, 2) == 2);
+    OTK_CHECK(otk_preferred_resolution_select_step(&config, 280, 150, 2) == 0);
+}
+
+static void test_poll() {
+    otk_preferred_resolution *resolution = otk_preferred_resolution_new(nullptr);
+    otk_preferred_video preferred = {};
+
+    // Nothing until the size has held for the debounce period, and a resize
+    // restarts it.
+    otk_preferred_resolution_set_view(resolution, 640, 480, 60, 0);
+    OTK_CHECK(!otk_preferred_resolution_poll(resolution, 100, &preferred));
+    otk_preferred_resolution_set_view(resolution, 660, 500, 60, 300);
+    OTK_CHECK(!otk_preferred_resolution_poll(resolution, 700, &preferred));
+    OTK_CHECK(otk_preferred_resolution_poll(resolution, 800, &preferred));
+    OTK_CHECK(preferred.width == 1280 && preferred.height == 720);
+    OTK_CHECK(preferred.frame_rate == 30);
+
+    // The same step again is not a new request.
+    otk_preferred_resolution_set_view(resolution, 640, 480, 60, 1000);
+    OTK_CHECK(!otk_preferred_resolution_poll(resolution, 2000, &preferred));
+
+    otk_preferred_resolution_set_view(resolution, 320, 180, 60, 3000);
+    OTK_CHECK(otk_preferred_resolution_poll(resolution, 4000, &preferred));
+    OTK_CHECK(preferred.width == 640 && preferred.height == 360);
+    OTK_CHECK(preferred.frame_rate == 30);
+
+    // The view's frame rate caps the step's.
+    otk_preferred_resolution_set_view(resolution, 320, 180, 10, 5000);
+    OTK_CHECK(otk_preferred_resolution_poll(resolution, 6000, &preferred));
+    OTK_CHECK(preferred.width == 640 && preferred.height == 360);
+    OTK_CHECK(preferred.frame_rate == 10);
+    otk_preferred_resolution_delete(resolution);
+}
+
+int main(int argc, char **argv) {
+    otk_test_init(argc, argv);
+    test_select_step();
+    test_poll();
+    return otk_test_result();
+}
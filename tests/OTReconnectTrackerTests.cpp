@@ -0,0 +1,100 @@
+//
+//  OTReconnectTrackerTests.cpp
+//  tests
+//
+//  Copyright (c) 2026 Vonage. All rights reserved.
+//
+
+#include "OTReconnectTracker.h"
+#include "OTTest.h"
+
+#include <string>
+#include <thread>
+#include <vector>
+
+static void collect_released(const char *stream_id, void *user_data) {
+    ((std::vector<std::string> *)user_data)->push_back(stream_id);
+}
+
+static void test_reconnection() {
+    std::vector<std::string> released;
+    otk_reconnect_tracker *tracker = otk_reconnect_tracker_new(10000);
+    otk_reconnect_tracker_on_connected(tracker);
+    OTK_CHECK(otk_reconnect_tracker_state(tracker) == OTK_SESSION_CONNECTED);
+    for (const char *id : { "a", "b", "c" }) {
+        OTK_CHECK(otk_reconnect_tracker_on_stream_received(tracker, id, 0) == OTK_STREAM_NEW);
+    }
+
+    // Streams dropped during the reconnection are kept, however long it takes.
+    otk_reconnect_tracker_on_reconnecting(tracker, 1000);
+    OTK_CHECK(otk_reconnect_tracker_state(tracker) == OTK_SESSION_RECONNECTING);
+    OTK_CHECK(otk_reconnect_tracker_on_stream_dropped(tracker, "a", 1500) == OTK_STREAM_KEEP);
+    OTK_CHECK(otk_reconnect_tracker_on_stream_dropped(tracker, "b", 1500) == OTK_STREAM_KEEP);
+    OTK_CHECK(otk_reconnect_tracker_release_expired(tracker, 50000, collect_released, &released) == 0);
+
+    // a comes back; b does not and is released once the grace period is over.
+    otk_reconnect_tracker_on_reconnected(tracker, 3000);
+    OTK_CHECK(otk_reconnect_tracker_state(tracker) == OTK_SESSION_CONNECTED);
+    OTK_CHECK(otk_reconnect_tracker_on_stream_received(tracker, "a", 3200) == OTK_STREAM_REATTACH);
+    otk_reconnect_tracker_on_frame(tracker, "a", 3400);
+    otk_reconnect_tracker_on_frame(tracker, "c", 3100);
+    // Only the first frame after the reconnection counts.
+    otk_reconnect_tracker_on_frame(tracker, "c", 9000);
+    OTK_CHECK(otk_reconnect_tracker_release_expired(tracker, 12999, collect_released, &released) == 0);
+    OTK_CHECK(otk_reconnect_tracker_release_expired(tracker, 13000, collect_released, &released) == 1);
+    OTK_CHECK(released.size() == 1 && released[0] == "b");
+    // Dropped while connected: released right away.
+    OTK_CHECK(otk_reconnect_tracker_on_stream_dropped(tracker, "c", 14000) == OTK_STREAM_RELEASE);
+
+    otk_reconnect_stats stats;
+    otk_reconnect_tracker_get_stats(tracker, &stats);
+    OTK_CHECK(stats.reconnections == 1);
+    OTK_CHECK(stats.last_reconnect_ms == 2000);
+    OTK_CHECK(stats.average_reconnect_ms == 2000);
+    OTK_CHECK(stats.streams_reattached == 1);
+    OTK_CHECK(stats.streams_released == 1);
+    OTK_CHECK(stats.first_frames == 2);
+    OTK_CHECK(stats.average_first_frame_ms == 250);
+
+    // Kept streams are released when the session gives up.
+    otk_reconnect_tracker_on_reconnecting(tracker, 20000);
+    OTK_CHECK(otk_reconnect_tracker_on_stream_dropped(tracker, "a", 20100) == OTK_STREAM_KEEP);
+    released.clear();
+    otk_reconnect_tracker_on_disconnected(tracker, collect_released, &released);
+    OTK_CHECK(released.size() == 1 && released[0] == "a");
+    OTK_CHECK(otk_reconnect_tracker_state(tracker) == OTK_SESSION_DISCONNECTED);
+    otk_reconnect_tracker_delete(tracker);
+}
+
+// The sample reports the disconnect from the SDK thread while the main thread
+// still renders frames and expires kept streams.
+static void test_disconnect_from_another_thread() {
+    otk_reconnect_tracker *tracker = otk_reconnect_tracker_new(1000);
+    std::vector<std::string> released_on_main, released_on_sdk;
+    for (int round = 0; round < 200; round++) {
+        otk_reconnect_tracker_on_connected(tracker);
+        otk_reconnect_tracker_on_stream_received(tracker, "a", round * 100);
+        otk_reconnect_tracker_on_stream_received(tracker, "b", round * 100);
+        otk_reconnect_tracker_on_reconnecting(tracker, round * 100 + 10);
+        otk_reconnect_tracker_on_stream_dropped(tracker, "a", round * 100 + 20);
+        otk_reconnect_tracker_on_stream_dropped(tracker, "b", round * 100 + 20);
+        std::thread sdk([&] {
+            otk_reconnect_tracker_on_disconnected(tracker, collect_released, &released_on_sdk);
+        });
+        for (int i = 0; i < 100; i++) {
+            otk_reconnect_tracker_on_frame(tracker, "a", round * 100 + 30);
+            otk_reconnect_tracker_release_expired(tracker, round * 100 + 5000, collect_released, &released_on_main);
+        }
+        sdk.join();
+    }
+    // Every kept stream is released exactly once, by one thread or the other.
+    OTK_CHECK(released_on_main.size() + released_on_sdk.size() == 400);
+    otk_reconnect_tracker_delete(tracker);
+}
+
+int main(int argc, char **argv) {
+    otk_test_init(argc, argv);
+    test_reconnection();
+    test_disconnect_from_another_thread();
+    return otk_test_result();
+}
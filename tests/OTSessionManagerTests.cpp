@@ -0,0 +1,311 @@
+//
+//  OTSessionManagerTests.cpp
+//  tests
+//
+//  Copyright (c) 2026 Vonage. All rights reserved.
+//
+
+#include "OTSessionManager.h"
+#include "OTTest.h"
+
+#include <atomic>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+// Stands in for otc_init and otc_destroy, and checks they alternate.
+static std::atomic<int> sdk_alive(0), sdk_inits(0), sdk_destroys(0);
+static std::atomic<bool> sdk_init_fails(false);
+static void *const kContext = (void *)0x1234;
+
+static int fake_init(void *context) {
+    OTK_CHECK(context == kContext);
+    if (sdk_init_fails) {
+        return 0;
+    }
+    OTK_CHECK(sdk_alive.exchange(1) == 0);
+    sdk_inits++;
+    return 1;
+}
+
+static void fake_destroy(void *) {
+    OTK_CHECK(sdk_alive.exchange(0) == 1);
+    sdk_destroys++;
+}
+
+static const otk_runtime_api kApi = { kContext, fake_init, fake_destroy };
+
+// Tasks of one session record the order they ran in and notice running
+// alongside each other.
+struct session_log {
+    std::vector<int> order;
+    std::atomic<int> running{0};
+    std::atomic<int> overlaps{0};
+};
+
+struct task {
+    session_log *log;
+    int sequence;
+};
+
+static void run_task(void *data) {
+    task *work = (task *)data;
+    if (work->log->running.fetch_add(1) != 0) {
+        work->log->overlaps++;
+    }
+    work->log->order.push_back(work->sequence);
+    work->log->running--;
+    delete work;
+}
+
+static std::atomic<int> devices_created(0), devices_destroyed(0);
+
+static void *create_device(void *context) {
+    devices_created++;
+    return context;
+}
+
+static void destroy_device(void *device, void *context) {
+    OTK_CHECK(device == context);
+    devices_destroyed++;
+}
+
+static void test_runtime_references() {
+    otk_runtime_stats stats;
+    OTK_CHECK(otk_runtime_acquire(&kApi));
+    // Later references keep the first api.
+    OTK_CHECK(otk_runtime_acquire(nullptr));
+    OTK_CHECK(otk_runtime_acquire(&kApi));
+    otk_runtime_get_stats(&stats);
+    OTK_CHECK(stats.references == 3 && stats.inits == 1);
+    otk_runtime_release();
+    otk_runtime_release();
+    OTK_CHECK(sdk_destroys == 0);
+    otk_runtime_release();
+    OTK_CHECK(sdk_destroys == 1);
+    // One release too many is ignored.
+    otk_runtime_release();
+    OTK_CHECK(sdk_destroys == 1);
+
+    OTK_CHECK(!otk_runtime_acquire(nullptr));
+    sdk_init_fails = true;
+    OTK_CHECK(!otk_runtime_acquire(&kApi));
+    sdk_init_fails = false;
+    otk_runtime_get_stats(&stats);
+    OTK_CHECK(stats.init_failures == 2 && stats.references == 0);
+
+    // Taken and dropped from many threads: the SDK is up whenever held.
+    std::vector<std::thread> threads;
+    for (int t = 0; t < 8; t++) {
+        threads.emplace_back([] {
+            for (int i = 0; i < 5000; i++) {
+                OTK_CHECK(otk_runtime_acquire(&kApi));
+                OTK_CHECK(sdk_alive == 1);
+                otk_runtime_release();
+            }
+        });
+    }
+    for (std::thread &thread : threads) {
+        thread.join();
+    }
+    otk_runtime_get_stats(&stats);
+    OTK_CHECK(stats.references == 0 && sdk_alive == 0);
+    OTK_CHECK(stats.inits == stats.destroys);
+}
+
+// Each session's tasks run in order and one at a time, whoever posts them.
+static void test_task_order() {
+    otk_session_manager *manager = otk_session_manager_new(&kApi, 3);
+    int inits = sdk_inits;
+    const int sessions = 4, tasks = 3000;
+    int ids[sessions];
+    session_log logs[sessions];
+    for (int i = 0; i < sessions; i++) {
+        ids[i] = otk_session_manager_add_session(manager, "session");
+        OTK_CHECK(ids[i] > 0);
+    }
+    OTK_CHECK(sdk_inits == inits + 1);
+    OTK_CHECK(otk_session_manager_session_count(manager) == sessions);
+    std::vector<std::thread> posters;
+    for (int i = 0; i < sessions; i++) {
+        posters.emplace_back([&, i] {
+            for (int k = 0; k < tasks; k++) {
+                OTK_CHECK(otk_session_manager_post(manager, ids[i], run_task, new task{ &logs[i], k }));
+            }
+        });
+    }
+    for (std::thread &poster : posters) {
+        poster.join();
+    }
+    for (int i = 0; i < sessions; i++) {
+        otk_session_manager_stop_session(manager, ids[i]);
+    }
+    for (int i = 0; i < sessions; i++) {
+        bool in_order = (int)logs[i].order.size() == tasks;
+        for (int k = 0; in_order && k < tasks; k++) {
+            in_order = logs[i].order[k] == k;
+        }
+        OTK_CHECK(in_order);
+        OTK_CHECK(logs[i].overlaps == 0);
+    }
+    task rejected = { &logs[0], 0 };
+    OTK_CHECK(!otk_session_manager_post(manager, ids[0], run_task, &rejected));
+    otk_session_usage usage;
+    OTK_CHECK(otk_session_manager_get_usage(manager, ids[0], &usage));
+    OTK_CHECK(usage.tasks == tasks && usage.tasks_rejected == 1 && usage.tasks_pending == 0);
+    OTK_CHECK(usage.queue_wait_max_us >= usage.queue_wait_mean_us);
+    otk_session_manager_delete(manager);
+    OTK_CHECK(sdk_alive == 0);
+}
+
+// Shared devices live as long as a session holds them; the SDK as long as
+// a session is left.
+static void test_devices_and_removal() {
+    otk_session_manager *manager = otk_session_manager_new(&kApi, 2);
+    int ids[4];
+    for (int &id : ids) {
+        id = otk_session_manager_add_session(manager, "session");
+    }
+    void *camera = (void *)0x77;
+    OTK_CHECK(otk_session_manager_acquire_device(manager, ids[0], "camera", create_device, destroy_device, camera) == camera);
+    OTK_CHECK(otk_session_manager_acquire_device(manager, ids[1], "camera", create_device, destroy_device, (void *)0x88) == camera);
+    OTK_CHECK(otk_session_manager_acquire_device(manager, ids[1], "camera", nullptr, nullptr, nullptr) == camera);
+    OTK_CHECK(otk_session_manager_acquire_device(manager, ids[2], "microphone", nullptr, nullptr, nullptr) == nullptr);
+    OTK_CHECK(otk_session_manager_acquire_device(manager, 999, "camera", create_device, destroy_device, nullptr) == nullptr);
+    OTK_CHECK(devices_created == 1);
+    otk_session_usage usage;
+    otk_session_manager_get_usage(manager, ids[1], &usage);
+    OTK_CHECK(usage.devices == 1);
+
+    otk_session_manager_release_device(manager, ids[0], "camera");
+    otk_session_manager_release_device(manager, ids[0], "camera");
+    OTK_CHECK(devices_destroyed == 0);
+    // Session 1 acquired it twice.
+    otk_session_manager_release_device(manager, ids[1], "camera");
+    OTK_CHECK(devices_destroyed == 0);
+
+    otk_session_manager_add_count(manager, ids[1], OTK_SESSION_SUBSCRIBERS, 2);
+    otk_session_manager_add_count(manager, ids[1], OTK_SESSION_SUBSCRIBERS, -1);
+    otk_session_manager_get_usage(manager, ids[1], &usage);
+    OTK_CHECK(usage.counts[OTK_SESSION_SUBSCRIBERS] == 1);
+
+    otk_session_manager_remove_session(manager, ids[1]);
+    OTK_CHECK(devices_destroyed == 1);
+    otk_session_manager_remove_session(manager, ids[0]);
+    otk_session_manager_remove_session(manager, ids[2]);
+    OTK_CHECK(sdk_alive == 1);
+    otk_session_manager_remove_session(manager, ids[3]);
+    OTK_CHECK(sdk_alive == 0);
+    OTK_CHECK(otk_session_manager_session_count(manager) == 0);
+    OTK_CHECK(!otk_session_manager_get_usage(manager, ids[3], &usage));
+
+    // Deleted with a session, its queued tasks and a device left.
+    int id = otk_session_manager_add_session(manager, "session");
+    session_log log;
+    for (int k = 0; k < 100; k++) {
+        otk_session_manager_post(manager, id, run_task, new task{ &log, k });
+    }
+    otk_session_manager_acquire_device(manager, id, "camera", create_device, destroy_device, (void *)0x99);
+    otk_session_manager_delete(manager);
+    OTK_CHECK(log.order.size() == 100);
+    OTK_CHECK(devices_destroyed == 2);
+    OTK_CHECK(sdk_alive == 0);
+}
+
+// Tasks of the sessions in the order they ran on the only worker.
+static std::mutex ran_lock;
+static std::vector<std::string> ran;
+static std::atomic<bool> gate_open(false);
+
+struct named_task {
+    const char *name;
+    bool gate;
+};
+
+static void run_named(void *data) {
+    named_task *work = (named_task *)data;
+    while (work->gate && !gate_open) {
+        std::this_thread::yield();
+    }
+    std::lock_guard<std::mutex> guard(ran_lock);
+    ran.push_back(work->name);
+}
+
+// Sessions take turns task by task: a light session's tasks posted behind
+// a busy session's backlog run in between the busy ones.
+static void test_sessions_take_turns() {
+    otk_session_manager *manager = otk_session_manager_new(&kApi, 1);
+    int busy = otk_session_manager_add_session(manager, "busy");
+    int light = otk_session_manager_add_session(manager, "light");
+    std::vector<named_task> busy_tasks(50, named_task{ "busy", false });
+    std::vector<named_task> light_tasks(5, named_task{ "light", false });
+    // The first holds the worker until everything is queued.
+    busy_tasks[0].gate = true;
+    for (named_task &work : busy_tasks) {
+        otk_session_manager_post(manager, busy, run_named, &work);
+    }
+    for (named_task &work : light_tasks) {
+        otk_session_manager_post(manager, light, run_named, &work);
+    }
+    gate_open = true;
+    otk_session_manager_stop_session(manager, light);
+    otk_session_manager_stop_session(manager, busy);
+    size_t last_light = 0;
+    for (size_t i = 0; i < ran.size(); i++) {
+        if (ran[i] == "light") {
+            last_light = i;
+        }
+    }
+    OTK_CHECK(ran.size() == 55);
+    // Alternating after the gate: busy, light, busy, light...
+    OTK_CHECK(last_light <= 11);
+    otk_session_usage usage;
+    otk_session_manager_get_usage(manager, light, &usage);
+    OTK_CHECK(usage.tasks == 5);
+    otk_session_manager_delete(manager);
+}
+
+static void benchmark_throughput() {
+    otk_session_manager *manager = otk_session_manager_new(&kApi, 0);
+    const int sessions = 8, tasks = 50000;
+    std::vector<int> ids;
+    for (int i = 0; i < sessions; i++) {
+        ids.push_back(otk_session_manager_add_session(manager, "session"));
+    }
+    std::vector<session_log> logs(sessions);
+    int64_t start = otk_test_now_ns();
+    std::vector<std::thread> posters;
+    for (int i = 0; i < sessions; i++) {
+        posters.emplace_back([&, i] {
+            for (int k = 0; k < tasks; k++) {
+                otk_session_manager_post(manager, ids[i], run_task, new task{ &logs[i], k });
+            }
+        });
+    }
+    for (std::thread &poster : posters) {
+        poster.join();
+    }
+    for (int id : ids) {
+        otk_session_manager_stop_session(manager, id);
+    }
+    double seconds = (otk_test_now_ns() - start) / 1e9;
+    otk_session_usage usage;
+    otk_session_manager_get_usage(manager, ids[0], &usage);
+    std::printf("%d sessions: %.2f M tasks/s, queue wait mean %lld us, max %lld us\n", sessions,
+                sessions * tasks / seconds / 1e6, (long long)usage.queue_wait_mean_us,
+                (long long)usage.queue_wait_max_us);
+    otk_session_manager_delete(manager);
+}
+
+int main(int argc, char **argv) {
+    otk_test_init(argc, argv);
+    test_runtime_references();
+    test_task_order();
+    test_devices_and_removal();
+    test_sessions_take_turns();
+    if (otk_test_benchmarking) {
+        benchmark_throughput();
+    }
+    return otk_test_result();
+}
@@ -0,0 +1,340 @@
+//
+//  OTSessionTraceTests.cpp
+//  tests
+//
+//  Copyright (c) 2026 Vonage. All rights reserved.
+//
+
+#include "OTSessionTrace.h"
+#include "OTTest.h"
+
+#include <algorithm>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+static const char *kTracePath = "OTSessionTraceTests.trace";
+static const char *kDamagedPath = "OTSessionTraceTests.damaged";
+
+// An I420 frame with a pattern per seed and padded rows filled with 0xee.
+struct image {
+    uint32_t width;
+    uint32_t height;
+    std::vector<uint8_t> data[3];
+    int strides[3];
+    const uint8_t *planes[3];
+};
+
+static image make_image(uint32_t width, uint32_t height, int seed) {
+    image frame;
+    frame.width = width;
+    frame.height = height;
+    uint32_t widths[3] = { width, (width + 1) / 2, (width + 1) / 2 };
+    uint32_t heights[3] = { height, (height + 1) / 2, (height + 1) / 2 };
+    for (int k = 0; k < 3; k++) {
+        frame.strides[k] = (int)widths[k] + (k == 0 ? 16 : 8);
+        frame.data[k].assign((size_t)frame.strides[k] * heights[k], 0xee);
+        for (uint32_t y = 0; y < heights[k]; y++) {
+            for (uint32_t x = 0; x < widths[k]; x++) {
+                frame.data[k][y * frame.strides[k] + x] = (uint8_t)(x * 3 + y * 7 + seed * 13 + k * 50);
+            }
+        }
+        frame.planes[k] = frame.data[k].data();
+    }
+    return frame;
+}
+
+// Writes down every callback of a replay.
+struct replayed {
+    std::vector<std::string> events;
+    std::vector<uint64_t> hashes;
+    std::vector<int64_t> timestamps;
+    std::vector<int16_t> samples;
+    bool pixels_match_hash = true;
+};
+
+static void on_session_event(void *user_data, otk_trace_session_event event) {
+    ((replayed *)user_data)->events.push_back("session " + std::to_string(event));
+}
+
+static void on_stream_received(void *user_data, const char *stream_id) {
+    ((replayed *)user_data)->events.push_back(std::string("received ") + stream_id);
+}
+
+static void on_stream_dropped(void *user_data, const char *stream_id) {
+    ((replayed *)user_data)->events.push_back(std::string("dropped ") + stream_id);
+}
+
+static void on_frame(void *user_data, const char *stream_id, const otk_trace_frame *frame) {
+    replayed *replay = (replayed *)user_data;
+    replay->events.push_back(std::string("frame ") + stream_id + " " + std::to_string(frame->width) + "x" +
+                             std::to_string(frame->height));
+    replay->hashes.push_back(frame->hash);
+    replay->timestamps.push_back(frame->timestamp);
+    if (frame->content == OTK_TRACE_FRAMES_FULL &&
+        otk_trace_hash_i420(frame->planes, frame->strides, frame->width, frame->height) != frame->hash) {
+        replay->pixels_match_hash = false;
+    }
+}
+
+static void on_audio_read(void *user_data, uint32_t requested, uint32_t returned, const int16_t *samples) {
+    replayed *replay = (replayed *)user_data;
+    replay->events.push_back("audio " + std::to_string(requested) + " " + std::to_string(returned));
+    if (samples != nullptr) {
+        replay->samples.assign(samples, samples + returned);
+    }
+}
+
+static otk_trace_replay_callbacks callbacks_for(replayed *replay) {
+    otk_trace_replay_callbacks callbacks = {};
+    callbacks.user_data = replay;
+    callbacks.on_session_event = on_session_event;
+    callbacks.on_stream_received = on_stream_received;
+    callbacks.on_stream_dropped = on_stream_dropped;
+    callbacks.on_frame = on_frame;
+    callbacks.on_audio_read = on_audio_read;
+    return callbacks;
+}
+
+// A short session with two streams of different, odd sizes. Fills in the
+// callbacks and hashes a replay should produce.
+static void record_session(otk_trace_frames content, bool paced, std::vector<std::string> &events,
+                           std::vector<uint64_t> &hashes) {
+    events.clear();
+    hashes.clear();
+    otk_trace_recorder *recorder = otk_trace_recorder_new(kTracePath, content);
+    OTK_CHECK(recorder != nullptr);
+    otk_trace_record_session(recorder, OTK_TRACE_CONNECTED);
+    events.push_back("session 0");
+    otk_trace_record_stream_received(recorder, "stream-A");
+    events.push_back("received stream-A");
+    otk_trace_record_stream_received(recorder, "stream-B");
+    events.push_back("received stream-B");
+    for (int i = 0; i < 20; i++) {
+        image frame = make_image(i % 2 ? 641 : 320, i % 2 ? 361 : 240, i);
+        const char *stream_id = i % 2 ? "stream-B" : "stream-A";
+        otk_trace_record_frame(recorder, stream_id, -5 + i * 33333LL, frame.width, frame.height,
+                               frame.planes, frame.strides);
+        hashes.push_back(content >= OTK_TRACE_FRAMES_HASH
+                             ? otk_trace_hash_i420(frame.planes, frame.strides, frame.width, frame.height) : 0);
+        events.push_back(std::string("frame ") + stream_id + " " + std::to_string(frame.width) + "x" +
+                         std::to_string(frame.height));
+        if (i == 10) {
+            int16_t samples[5] = { -32768, -1, 0, 1, 32767 };
+            otk_trace_record_audio_read(recorder, 441, 5, samples);
+            events.push_back("audio 441 5");
+            otk_trace_record_audio_read(recorder, 441, 441, nullptr);
+            events.push_back("audio 441 441");
+        }
+        if (paced) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        }
+    }
+    otk_trace_record_stream_dropped(recorder, "stream-A");
+    events.push_back("dropped stream-A");
+    otk_trace_record_session(recorder, OTK_TRACE_DISCONNECTED);
+    events.push_back("session 1");
+    otk_trace_recorder_delete(recorder);
+}
+
+// The hash covers the visible pixels only.
+static void test_hash() {
+    image a = make_image(64, 48, 1), b = make_image(64, 48, 2), padded = make_image(64, 48, 1);
+    padded.data[0][64] = 0x11;
+    OTK_CHECK(otk_trace_hash_i420(a.planes, a.strides, 64, 48) != otk_trace_hash_i420(b.planes, b.strides, 64, 48));
+    OTK_CHECK(otk_trace_hash_i420(a.planes, a.strides, 64, 48) ==
+              otk_trace_hash_i420(padded.planes, padded.strides, 64, 48));
+}
+
+// Every content level replays the same callbacks in the same order, twice.
+static void test_record_and_replay() {
+    for (int content = OTK_TRACE_FRAMES_NONE; content <= OTK_TRACE_FRAMES_FULL; content++) {
+        std::vector<std::string> events;
+        std::vector<uint64_t> hashes;
+        // Replayed at the recorded pace once, with the hash.
+        bool paced = content == OTK_TRACE_FRAMES_HASH;
+        record_session((otk_trace_frames)content, paced, events, hashes);
+        otk_trace_replay *replay = otk_trace_replay_open(kTracePath);
+        OTK_CHECK(replay != nullptr);
+        OTK_CHECK(otk_trace_replay_frames(replay) == content);
+        replayed first;
+        otk_trace_replay_callbacks callbacks = callbacks_for(&first);
+        int64_t start = otk_test_now_ns();
+        OTK_CHECK(otk_trace_replay_run(replay, &callbacks, paced ? 1.0 : 0) == 0);
+        int64_t elapsed_us = (otk_test_now_ns() - start) / 1000;
+        OTK_CHECK(first.events == events);
+        OTK_CHECK(first.hashes == hashes);
+        OTK_CHECK(first.pixels_match_hash);
+        OTK_CHECK(first.timestamps.front() == -5 && first.timestamps.back() == -5 + 19 * 33333LL);
+        OTK_CHECK((first.samples == std::vector<int16_t>{ -32768, -1, 0, 1, 32767 }));
+        otk_trace_replay_stats stats;
+        otk_trace_replay_get_stats(replay, &stats);
+        OTK_CHECK(stats.events == events.size());
+        OTK_CHECK(stats.frames == 20);
+        OTK_CHECK(stats.audio_reads == 2);
+        if (paced) {
+            OTK_CHECK(stats.recorded_us > 190000);
+            OTK_CHECK(elapsed_us >= stats.recorded_us - 1000);
+        }
+        replayed second;
+        callbacks = callbacks_for(&second);
+        OTK_CHECK(otk_trace_replay_run(replay, &callbacks, 0) == 0);
+        OTK_CHECK(second.events == events);
+        otk_trace_replay_delete(replay);
+    }
+}
+
+static std::vector<uint8_t> read_file(const char *path) {
+    std::vector<uint8_t> data;
+    FILE *file = std::fopen(path, "rb");
+    for (int c; file != nullptr && (c = std::fgetc(file)) != EOF;) {
+        data.push_back((uint8_t)c);
+    }
+    if (file != nullptr) {
+        std::fclose(file);
+    }
+    return data;
+}
+
+static otk_trace_replay *open_damaged(const uint8_t *data, size_t size) {
+    FILE *file = std::fopen(kDamagedPath, "wb");
+    std::fwrite(data, 1, size, file);
+    std::fclose(file);
+    return otk_trace_replay_open(kDamagedPath);
+}
+
+// A trace cut anywhere or with bytes overwritten is rejected or replayed up
+// to the damage, never read past.
+static void test_damaged_traces() {
+    std::vector<std::string> events;
+    std::vector<uint64_t> hashes;
+    record_session(OTK_TRACE_FRAMES_HASH, false, events, hashes);
+    std::vector<uint8_t> trace = read_file(kTracePath);
+    for (size_t cut = 0; cut < trace.size(); cut++) {
+        otk_trace_replay *replay = open_damaged(trace.data(), cut);
+        if (replay == nullptr) {
+            OTK_CHECK(cut < 16);
+            continue;
+        }
+        replayed partial;
+        otk_trace_replay_callbacks callbacks = callbacks_for(&partial);
+        otk_trace_replay_run(replay, &callbacks, 0);
+        // What was replayed is a prefix of the session.
+        OTK_CHECK(partial.events.size() < events.size());
+        OTK_CHECK(std::equal(partial.events.begin(), partial.events.end(), events.begin()));
+        otk_trace_replay_delete(replay);
+    }
+
+    record_session(OTK_TRACE_FRAMES_SUBSAMPLED, false, events, hashes);
+    trace = read_file(kTracePath);
+    std::mt19937 random(3);
+    for (int i = 0; i < 100; i++) {
+        std::vector<uint8_t> damaged = trace;
+        for (int k = 0; k < 4; k++) {
+            damaged[16 + random() % (damaged.size() - 16)] = (uint8_t)random();
+        }
+        otk_trace_replay *replay = open_damaged(damaged.data(), damaged.size());
+        replayed partial;
+        otk_trace_replay_callbacks callbacks = callbacks_for(&partial);
+        otk_trace_replay_run(replay, &callbacks, 0);
+        otk_trace_replay_delete(replay);
+    }
+    std::remove(kDamagedPath);
+
+    OTK_CHECK(otk_trace_replay_open("/nonexistent") == nullptr);
+    OTK_CHECK(otk_trace_recorder_new("/nonexistent/directory/trace", OTK_TRACE_FRAMES_FULL) == nullptr);
+}
+
+// Four threads recording at once; every record makes it to the file.
+static void test_concurrent_recording() {
+    otk_trace_recorder *recorder = otk_trace_recorder_new(kTracePath, OTK_TRACE_FRAMES_HASH);
+    image frame = make_image(320, 240, 5);
+    std::vector<std::thread> threads;
+    for (int t = 0; t < 4; t++) {
+        threads.emplace_back([&, t] {
+            std::string stream_id = "stream-" + std::to_string(t);
+            otk_trace_record_stream_received(recorder, stream_id.c_str());
+            for (int i = 0; i < 100; i++) {
+                otk_trace_record_frame(recorder, stream_id.c_str(), i, frame.width, frame.height,
+                                       frame.planes, frame.strides);
+            }
+            for (int i = 0; i < 500; i++) {
+                otk_trace_record_audio_read(recorder, 441, 441, nullptr);
+            }
+        });
+    }
+    for (std::thread &thread : threads) {
+        thread.join();
+    }
+    otk_trace_recorder_stats recorder_stats;
+    otk_trace_recorder_get_stats(recorder, &recorder_stats);
+    OTK_CHECK(!recorder_stats.write_failed);
+    otk_trace_recorder_delete(recorder);
+
+    otk_trace_replay *replay = otk_trace_replay_open(kTracePath);
+    replayed all;
+    otk_trace_replay_callbacks callbacks = callbacks_for(&all);
+    OTK_CHECK(otk_trace_replay_run(replay, &callbacks, 0) == 0);
+    otk_trace_replay_stats stats;
+    otk_trace_replay_get_stats(replay, &stats);
+    OTK_CHECK(stats.frames == 400);
+    OTK_CHECK(stats.audio_reads == 2000);
+    OTK_CHECK(stats.events == 2404);
+    otk_trace_replay_delete(replay);
+}
+
+// A paced replay stopped from another thread returns early.
+static void test_stop() {
+    std::vector<std::string> events;
+    std::vector<uint64_t> hashes;
+    record_session(OTK_TRACE_FRAMES_NONE, true, events, hashes);
+    otk_trace_replay *replay = otk_trace_replay_open(kTracePath);
+    replayed partial;
+    otk_trace_replay_callbacks callbacks = callbacks_for(&partial);
+    std::thread stopper([&] {
+        std::this_thread::sleep_for(std::chrono::milliseconds(20));
+        otk_trace_replay_stop(replay);
+    });
+    OTK_CHECK(otk_trace_replay_run(replay, &callbacks, 1.0) == 0);
+    stopper.join();
+    OTK_CHECK(partial.events.size() < events.size());
+    otk_trace_replay_delete(replay);
+}
+
+static void benchmark_trace() {
+    image frame = make_image(1280, 720, 5);
+    for (otk_trace_frames content : { OTK_TRACE_FRAMES_HASH, OTK_TRACE_FRAMES_FULL }) {
+        otk_trace_recorder *recorder = otk_trace_recorder_new(kTracePath, content);
+        const int frames = 100;
+        int64_t start = otk_test_now_ns();
+        for (int i = 0; i < frames; i++) {
+            otk_trace_record_frame(recorder, "stream", i, frame.width, frame.height, frame.planes, frame.strides);
+        }
+        double record_ms = (double)(otk_test_now_ns() - start) / frames / 1e6;
+        otk_trace_recorder_delete(recorder);
+        otk_trace_replay *replay = otk_trace_replay_open(kTracePath);
+        replayed all;
+        otk_trace_replay_callbacks callbacks = callbacks_for(&all);
+        start = otk_test_now_ns();
+        otk_trace_replay_run(replay, &callbacks, 0);
+        std::printf("720p %s: record %.3f ms/frame, replay %.3f ms/frame\n",
+                    content == OTK_TRACE_FRAMES_FULL ? "full" : "hash", record_ms,
+                    (double)(otk_test_now_ns() - start) / frames / 1e6);
+        otk_trace_replay_delete(replay);
+    }
+}
+
+int main(int argc, char **argv) {
+    otk_test_init(argc, argv);
+    test_hash();
+    test_record_and_replay();
+    test_damaged_traces();
+    test_concurrent_recording();
+    test_stop();
+    if (otk_test_benchmarking) {
+        benchmark_trace();
+    }
+    std::remove(kTracePath);
+    return otk_test_result();
+}
@@ -0,0 +1,310 @@
+//
+//  OTSignalChannelTests.cpp
+//  tests
+//
+//  Copyright (c) 2026 Vonage. All rights reserved.
+//
+
+#include "OTSignalChannel.h"
+#include "OTTest.h"
+
+#include <atomic>
+#include <map>
+#include <random>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+// Signals sent, by type and data.
+struct wire {
+    std::vector<std::pair<std::string, std::string>> sent;
+    bool fails = false;
+};
+
+static int send_signal(const char *type, const char *data, void *user_data) {
+    wire *signals = (wire *)user_data;
+    if (signals->fails) {
+        return 0;
+    }
+    signals->sent.emplace_back(type, data);
+    return 1;
+}
+
+// Updates received, by key and data.
+struct received {
+    std::vector<std::pair<std::string, std::string>> updates;
+};
+
+static void handle(const char *key, const uint8_t *data, size_t size, void *user_data) {
+    ((received *)user_data)->updates.emplace_back(key, std::string((const char *)data, size));
+}
+
+static int update(otk_signal_channel *channel, const std::string &key, const std::string &data, int64_t now_us) {
+    return otk_signal_channel_update(channel, key.c_str(), (const uint8_t *)data.data(), data.size(), now_us);
+}
+
+static int append(otk_signal_channel *channel, const std::string &key, const std::string &data, int64_t now_us) {
+    return otk_signal_channel_append(channel, key.c_str(), (const uint8_t *)data.data(), data.size(), now_us);
+}
+
+// prefix followed by number, built by appending: GCC 12 warns about
+// operator+ on a short literal and a temporary at -O3.
+static std::string numbered_key(const char *prefix, int number) {
+    std::string key(prefix);
+    key.append(std::to_string(number));
+    return key;
+}
+
+static const otk_signal_channel_config kConfig = { "otk-batch", 50000, 0 };
+static const int64_t kStart = 1000000;
+
+// A batch of a window's updates, from the sender's side and the receiver's,
+// and what is left of it once damaged.
+static void test_batch() {
+    wire signals;
+    OTK_CHECK(!otk_signal_channel_new(&kConfig, nullptr, nullptr));
+    otk_signal_channel *sender = otk_signal_channel_new(&kConfig, send_signal, &signals);
+    otk_signal_channel *receiver = otk_signal_channel_new(&kConfig, send_signal, &signals);
+    received cursor, others;
+    otk_signal_channel_set_handler(receiver, "cursor", handle, &cursor);
+
+    // A hundred cursor moves are coalesced into the last.
+    int started = 0;
+    for (int i = 0; i < 100; i++) {
+        started += update(sender, "cursor", std::to_string(i), kStart + i * 400);
+    }
+    OTK_CHECK(started == 1);
+    append(sender, "stroke", "s1", kStart + 100);
+    append(sender, "stroke", "s2", kStart + 200);
+    update(sender, "empty", "", kStart + 300);
+    OTK_CHECK(otk_signal_channel_poll(sender, kStart + 10000) == 40000);
+    OTK_CHECK(signals.sent.empty());
+    OTK_CHECK(otk_signal_channel_poll(sender, kStart + 50000) == 0);
+    OTK_CHECK(signals.sent.size() == 1);
+    if (signals.sent.size() != 1) {
+        return;
+    }
+    const std::string batch = signals.sent[0].second;
+
+    // The sender ignores its own batch; other types are left to the app.
+    OTK_CHECK(otk_signal_channel_receive(sender, "otk-batch", batch.c_str()) == 1);
+    OTK_CHECK(otk_signal_channel_receive(receiver, "other", batch.c_str()) == 0);
+    OTK_CHECK(otk_signal_channel_receive(receiver, "otk-batch", batch.c_str()) == 1);
+    OTK_CHECK(cursor.updates.size() == 1 && cursor.updates[0].second == "99");
+    otk_signal_channel_set_handler(receiver, nullptr, handle, &others);
+    otk_signal_channel_receive(receiver, "otk-batch", batch.c_str());
+    OTK_CHECK(cursor.updates.size() == 2 && others.updates.size() == 3);
+    if (others.updates.size() == 3) {
+        OTK_CHECK(others.updates[0].first == "stroke" && others.updates[0].second == "s1");
+        OTK_CHECK(others.updates[1].first == "stroke" && others.updates[1].second == "s2");
+        OTK_CHECK(others.updates[2].first == "empty" && others.updates[2].second.empty());
+    }
+
+    otk_signal_channel_stats stats;
+    otk_signal_channel_get_stats(sender, kStart + 50000, &stats);
+    OTK_CHECK(stats.updates == 103 && stats.updates_coalesced == 99 && stats.signals_sent == 1);
+    OTK_CHECK(stats.added_latency_max_us == 49900);
+    otk_signal_channel_get_stats(receiver, kStart, &stats);
+    OTK_CHECK(stats.signals_received == 2 && stats.updates_received == 8 && stats.updates_unhandled == 3);
+
+    // Damaged batches are taken as the channel's and dropped.
+    for (const char *damaged : { "", "A", "!!!!", "T1RTAQ==", "T1RTAQAAAAAF", "====", "QQ=A" }) {
+        OTK_CHECK(otk_signal_channel_receive(receiver, "otk-batch", damaged) == 1);
+    }
+    otk_signal_channel_get_stats(receiver, kStart, &stats);
+    OTK_CHECK(stats.decode_errors >= 6);
+    for (size_t size = 0; size < batch.size(); size += 4) {
+        otk_signal_channel_receive(receiver, "otk-batch", batch.substr(0, size).c_str());
+    }
+    static const char kBase64[] = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/=";
+    std::mt19937 random(1);
+    for (int i = 0; i < 20000; i++) {
+        std::string damaged = batch;
+        for (int k = 0; k < 3; k++) {
+            damaged[random() % damaged.size()] = kBase64[random() % 65];
+        }
+        otk_signal_channel_receive(receiver, "otk-batch", damaged.c_str());
+    }
+    otk_signal_channel_delete(sender);
+    otk_signal_channel_delete(receiver);
+}
+
+// A batch too large for one signal is split; an update too large for any is
+// dropped. Every length and byte value goes through.
+static void test_split_and_encode() {
+    wire signals;
+    otk_signal_channel *sender = otk_signal_channel_new(&kConfig, send_signal, &signals);
+    otk_signal_channel *receiver = otk_signal_channel_new(&kConfig, send_signal, &signals);
+    received updates;
+    otk_signal_channel_set_handler(receiver, nullptr, handle, &updates);
+
+    const std::string large(3000, 'x');
+    for (int i = 0; i < 10; i++) {
+        update(sender, numbered_key("k", i), large, kStart);
+    }
+    update(sender, "huge", std::string(7000, 'y'), kStart);
+    otk_signal_channel_flush(sender, kStart + 1);
+    OTK_CHECK(signals.sent.size() == 5);
+    for (const auto &signal : signals.sent) {
+        OTK_CHECK(signal.second.size() <= OTK_SIGNAL_CHANNEL_MAX_SIGNAL_SIZE);
+        otk_signal_channel_receive(receiver, signal.first.c_str(), signal.second.c_str());
+    }
+    OTK_CHECK(updates.updates.size() == 10);
+    for (size_t i = 0; i < updates.updates.size(); i++) {
+        OTK_CHECK(updates.updates[i].first == numbered_key("k", (int)i) && updates.updates[i].second == large);
+    }
+    otk_signal_channel_stats stats;
+    otk_signal_channel_get_stats(sender, kStart, &stats);
+    OTK_CHECK(stats.updates_dropped == 1);
+
+    signals.fails = true;
+    update(sender, "x", "1", kStart);
+    otk_signal_channel_flush(sender, kStart);
+    signals.fails = false;
+    otk_signal_channel_get_stats(sender, kStart, &stats);
+    OTK_CHECK(stats.send_failures == 1);
+
+    int mismatches = 0;
+    for (int size = 0; size < 300; size++) {
+        std::string data;
+        for (int i = 0; i < size; i++) {
+            data.push_back((char)(i * 37 + size));
+        }
+        signals.sent.clear();
+        updates.updates.clear();
+        append(sender, "b", data, kStart);
+        otk_signal_channel_flush(sender, kStart);
+        if (signals.sent.size() == 1) {
+            otk_signal_channel_receive(receiver, "otk-batch", signals.sent[0].second.c_str());
+        }
+        mismatches += updates.updates.size() != 1 || updates.updates[0].second != data;
+    }
+    OTK_CHECK(mismatches == 0);
+    otk_signal_channel_delete(sender);
+    otk_signal_channel_delete(receiver);
+}
+
+// The last value of each key and every appended one as received.
+struct replay {
+    std::map<std::string, int> last;
+    int logged = 0;
+};
+
+static void handle_replay(const char *key, const uint8_t *data, size_t size, void *user_data) {
+    replay *state = (replay *)user_data;
+    int value = 0;
+    OTK_CHECK(size == sizeof(value));
+    std::memcpy(&value, data, sizeof(value));
+    if (std::strcmp(key, "log") == 0) {
+        state->logged++;
+    } else {
+        state->last[key] = value;
+    }
+}
+
+static int64_t now_us() {
+    return otk_test_now_ns() / 1000;
+}
+
+// Four threads update and append while another polls: no appended update is
+// lost and each key ends on its last value.
+static void test_threads() {
+    wire signals;
+    otk_signal_channel_config config = { "t", 2000, 0 };
+    otk_signal_channel *sender = otk_signal_channel_new(&config, send_signal, &signals);
+    std::atomic<bool> stop(false);
+    std::thread poller([&] {
+        while (!stop) {
+            otk_signal_channel_poll(sender, now_us());
+            std::this_thread::sleep_for(std::chrono::microseconds(500));
+        }
+        otk_signal_channel_flush(sender, now_us());
+    });
+    std::vector<std::thread> threads;
+    for (int t = 0; t < 4; t++) {
+        threads.emplace_back([sender, t] {
+            std::string key = numbered_key("c", t);
+            for (int i = 0; i < 20000; i++) {
+                otk_signal_channel_update(sender, key.c_str(), (const uint8_t *)&i, sizeof(i), now_us());
+                otk_signal_channel_append(sender, "log", (const uint8_t *)&i, sizeof(i), now_us());
+            }
+        });
+    }
+    for (std::thread &thread : threads) {
+        thread.join();
+    }
+    stop = true;
+    poller.join();
+
+    wire unused;
+    otk_signal_channel *receiver = otk_signal_channel_new(&config, send_signal, &unused);
+    replay state;
+    otk_signal_channel_set_handler(receiver, nullptr, handle_replay, &state);
+    for (const auto &signal : signals.sent) {
+        otk_signal_channel_receive(receiver, signal.first.c_str(), signal.second.c_str());
+    }
+    OTK_CHECK(state.logged == 80000);
+    for (int t = 0; t < 4; t++) {
+        OTK_CHECK(state.last[numbered_key("c", t)] == 19999);
+    }
+    otk_signal_channel_delete(sender);
+    otk_signal_channel_delete(receiver);
+}
+
+// 10 s of a 60 Hz cursor and 200 Hz telemetry under four keys, in simulated
+// time, polled when the channel asks.
+static void benchmark_batching() {
+    wire signals;
+    otk_signal_channel *channel = otk_signal_channel_new(&kConfig, send_signal, &signals);
+    int64_t next_poll = -1;
+    uint64_t updates = 0;
+    float cursor[2];
+    double telemetry[3] = { 0, 0, 0 };
+    int64_t start = otk_test_now_ns();
+    for (int64_t us = 0; us < 10000000; us += 1000) {
+        int64_t now = kStart + us;
+        if (next_poll >= 0 && now >= next_poll) {
+            int64_t left = otk_signal_channel_poll(channel, now);
+            next_poll = left > 0 ? now + left : -1;
+        }
+        if (us % 16667 < 1000) {
+            cursor[0] = (float)us;
+            cursor[1] = (float)-us;
+            if (otk_signal_channel_update(channel, "cursor", (const uint8_t *)cursor, sizeof(cursor), now)) {
+                next_poll = now + kConfig.window_us;
+            }
+            updates++;
+        }
+        if (us % 5000 == 0) {
+            for (int k = 0; k < 4; k++) {
+                std::string key = numbered_key("telemetry", k);
+                telemetry[0] = (double)us;
+                if (otk_signal_channel_update(channel, key.c_str(), (const uint8_t *)telemetry, sizeof(telemetry), now)) {
+                    next_poll = now + kConfig.window_us;
+                }
+                updates++;
+            }
+        }
+    }
+    double us_per_update = (otk_test_now_ns() - start) / 1e3 / updates;
+    otk_signal_channel_stats stats;
+    otk_signal_channel_get_stats(channel, kStart + 10000000, &stats);
+    std::printf("%llu updates in %llu signals of %.0f bytes, added latency mean %lld us, max %lld us, "
+                "%.2f us/update\n",
+                (unsigned long long)stats.updates, (unsigned long long)stats.signals_sent,
+                (double)stats.bytes_sent / stats.signals_sent, (long long)stats.added_latency_mean_us,
+                (long long)stats.added_latency_max_us, us_per_update);
+    otk_signal_channel_delete(channel);
+}
+
+int main(int argc, char **argv) {
+    otk_test_init(argc, argv);
+    test_batch();
+    test_split_and_encode();
+    test_threads();
+    if (otk_test_benchmarking) {
+        benchmark_batching();
+    }
+    return otk_test_result();
+}
@@ -0,0 +1,125 @@
+//
+//  OTStartupTimelineTests.cpp
+//  tests
+//
+//  Copyright (c) 2026 Vonage. All rights reserved.
+//
+
+#include "OTStartupTimeline.h"
+#include "OTTest.h"
+
+#include <atomic>
+#include <string>
+#include <thread>
+
+static void test_marks_and_format() {
+    otk_startup_timeline *timeline = otk_startup_timeline_new();
+    otk_startup_timeline_reset(timeline, 1000000);
+    OTK_CHECK(otk_startup_timeline_mark(timeline, OTK_STARTUP_CONNECT_REQUESTED, 1000000) == 1);
+    // Only the first time counts.
+    OTK_CHECK(otk_startup_timeline_mark(timeline, OTK_STARTUP_CONNECT_REQUESTED, 1000500) == 0);
+    otk_startup_timeline_mark(timeline, OTK_STARTUP_SESSION_CONNECTED, 1250000);
+    otk_startup_timeline_mark(timeline, OTK_STARTUP_MICROPHONE_AUTHORIZED, 1040000);
+    otk_startup_timeline_fail(timeline, OTK_STARTUP_CAMERA_AUTHORIZED, 1016700);
+
+    OTK_CHECK(otk_startup_timeline_elapsed_us(timeline, OTK_STARTUP_CONNECT_REQUESTED) == 0);
+    OTK_CHECK(otk_startup_timeline_elapsed_us(timeline, OTK_STARTUP_SESSION_CONNECTED) == 250000);
+    OTK_CHECK(otk_startup_timeline_elapsed_us(timeline, OTK_STARTUP_CAMERA_AUTHORIZED) == -1);
+    OTK_CHECK(otk_startup_timeline_elapsed_us(timeline, OTK_STARTUP_FIRST_REMOTE_FRAME) == -1);
+
+    char buffer[1024];
+    size_t length = otk_startup_timeline_format(timeline, buffer, sizeof(buffer));
+    OTK_CHECK(length == std::strlen(buffer));
+    OTK_CHECK(std::string(buffer) ==
+              "      0.0 ms  (+    0.0 ms)  connect requested\n"
+              "     16.7 ms  (+   16.7 ms)  camera authorized FAILED\n"
+              "     40.0 ms  (+   23.3 ms)  microphone authorized\n"
+              "    250.0 ms  (+  210.0 ms)  session connected\n");
+    char small[8];
+    OTK_CHECK(otk_startup_timeline_format(timeline, small, sizeof(small)) == length);
+    OTK_CHECK(std::strlen(small) == sizeof(small) - 1);
+
+    otk_startup_timeline_reset(timeline, 2000000);
+    OTK_CHECK(otk_startup_timeline_elapsed_us(timeline, OTK_STARTUP_CONNECT_REQUESTED) == -1);
+    OTK_CHECK(otk_startup_timeline_format(timeline, buffer, sizeof(buffer)) == 0);
+    otk_startup_timeline_delete(timeline);
+}
+
+// Stages that only finish once all of them have started, so they can only
+// succeed if they run at the same time.
+struct rendezvous {
+    std::atomic<int> started{0};
+    int stages;
+};
+
+static int meet(void *user_data) {
+    rendezvous *meeting = (rendezvous *)user_data;
+    meeting->started++;
+    int64_t deadline = otk_startup_now_us() + 5000000;
+    while (meeting->started.load() < meeting->stages) {
+        if (otk_startup_now_us() > deadline) {
+            return 1;
+        }
+        std::this_thread::yield();
+    }
+    return 0;
+}
+
+static int fail(void *) {
+    return 1;
+}
+
+static void test_prewarm_runs_stages_concurrently() {
+    otk_startup_timeline *timeline = otk_startup_timeline_new();
+    otk_startup_timeline_reset(timeline, otk_startup_now_us());
+    rendezvous meeting;
+    meeting.stages = 2;
+    otk_startup_stage stages[3] = {
+        { "camera", OTK_STARTUP_CAPTURE_READY, meet, &meeting },
+        { "microphone", OTK_STARTUP_MICROPHONE_AUTHORIZED, meet, &meeting },
+        { "authorization", OTK_STARTUP_CAMERA_AUTHORIZED, fail, nullptr },
+    };
+    otk_startup_prewarm *prewarm = otk_startup_prewarm_start(timeline, stages, 3);
+    OTK_CHECK(otk_startup_prewarm_wait(prewarm, -1) == 0);
+    OTK_CHECK(otk_startup_prewarm_failed(prewarm) == 1);
+    OTK_CHECK(otk_startup_timeline_elapsed_us(timeline, OTK_STARTUP_CAPTURE_READY) >= 0);
+    OTK_CHECK(otk_startup_timeline_elapsed_us(timeline, OTK_STARTUP_MICROPHONE_AUTHORIZED) >= 0);
+    OTK_CHECK(otk_startup_timeline_elapsed_us(timeline, OTK_STARTUP_CAMERA_AUTHORIZED) == -1);
+    otk_startup_prewarm_delete(prewarm);
+    otk_startup_timeline_delete(timeline);
+}
+
+static std::atomic<bool> stage_may_finish(false);
+
+static int wait_for_test(void *) {
+    while (!stage_may_finish.load()) {
+        std::this_thread::yield();
+    }
+    return 0;
+}
+
+// The handle can go before its stages; they still mark the timeline.
+static void test_prewarm_deleted_early() {
+    otk_startup_timeline *timeline = otk_startup_timeline_new();
+    otk_startup_timeline_reset(timeline, otk_startup_now_us());
+    otk_startup_stage stage = { "slow", OTK_STARTUP_FIRST_REMOTE_FRAME, wait_for_test, nullptr };
+    otk_startup_prewarm *prewarm = otk_startup_prewarm_start(timeline, &stage, 1);
+    OTK_CHECK(otk_startup_prewarm_wait(prewarm, 0) == 1);
+    otk_startup_prewarm_delete(prewarm);
+    stage_may_finish = true;
+    int64_t deadline = otk_startup_now_us() + 5000000;
+    while (otk_startup_timeline_elapsed_us(timeline, OTK_STARTUP_FIRST_REMOTE_FRAME) < 0 &&
+           otk_startup_now_us() < deadline) {
+        std::this_thread::yield();
+    }
+    OTK_CHECK(otk_startup_timeline_elapsed_us(timeline, OTK_STARTUP_FIRST_REMOTE_FRAME) >= 0);
+    otk_startup_timeline_delete(timeline);
+}
+
+int main(int argc, char **argv) {
+    otk_test_init(argc, argv);
+    test_marks_and_format();
+    test_prewarm_runs_stages_concurrently();
+    test_prewarm_deleted_early();
+    return otk_test_result();
+}
@@ -0,0 +1,289 @@
+//
+//  OTStreamStatsTests.cpp
+//  tests
+//
+//  Copyright (c) 2026 Vonage. All rights reserved.
+//
+
+#include "OTStreamStats.h"
+#include "OTTest.h"
+
+#include <cctype>
+#include <cstdlib>
+#include <random>
+#include <sstream>
+#include <string>
+#include <vector>
+
+// Just enough of a JSON parser to tell whether a document is valid.
+struct json_checker {
+    const char *p;
+
+    void skip_space() {
+        while (*p == ' ' || *p == '\n' || *p == '\r' || *p == '\t') {
+            p++;
+        }
+    }
+
+    bool string() {
+        if (*p++ != '"') {
+            return false;
+        }
+        for (; *p != '"'; p++) {
+            if ((unsigned char)*p < 0x20) {
+                return false;
+            }
+            if (*p == '\\') {
+                p++;
+                if (*p == 'u') {
+                    for (int i = 0; i < 4; i++) {
+                        if (!std::isxdigit((unsigned char)*++p)) {
+                            return false;
+                        }
+                    }
+                } else if (std::strchr("\"\\/bfnrt", *p) == nullptr || *p == '\0') {
+                    return false;
+                }
+            }
+        }
+        p++;
+        return true;
+    }
+
+    bool value() {
+        skip_space();
+        if (*p == '{' || *p == '[') {
+            char close = *p == '{' ? '}' : ']';
+            bool object = *p++ == '{';
+            skip_space();
+            if (*p == close) {
+                p++;
+                return true;
+            }
+            for (;;) {
+                skip_space();
+                if (object) {
+                    if (!string()) {
+                        return false;
+                    }
+                    skip_space();
+                    if (*p++ != ':') {
+                        return false;
+                    }
+                }
+                if (!value()) {
+                    return false;
+                }
+                skip_space();
+                if (*p == close) {
+                    p++;
+                    return true;
+                }
+                if (*p++ != ',') {
+                    return false;
+                }
+            }
+        }
+        if (*p == '"') {
+            return string();
+        }
+        for (const char *literal : { "null", "true", "false" }) {
+            if (std::strncmp(p, literal, std::strlen(literal)) == 0) {
+                p += std::strlen(literal);
+                return true;
+            }
+        }
+        char *end;
+        std::strtod(p, &end);
+        if (end == p || std::isalpha((unsigned char)*p)) {
+            return false;
+        }
+        p = end;
+        return true;
+    }
+
+    static bool valid(const char *text) {
+        json_checker checker = { text };
+        if (!checker.value()) {
+            return false;
+        }
+        checker.skip_space();
+        return *checker.p == '\0';
+    }
+};
+
+static std::string export_json(otk_stream_stats *stats, int64_t now_ms) {
+    size_t length = otk_stream_stats_export_json(stats, now_ms, nullptr, 0);
+    std::string text(length, '\0');
+    otk_stream_stats_export_json(stats, now_ms, text.data(), length + 1);
+    return text;
+}
+
+static std::string export_prometheus(otk_stream_stats *stats, int64_t now_ms) {
+    size_t length = otk_stream_stats_export_prometheus(stats, now_ms, nullptr, 0);
+    std::string text(length, '\0');
+    otk_stream_stats_export_prometheus(stats, now_ms, text.data(), length + 1);
+    return text;
+}
+
+// Two minutes of a subscriber at 30 fps, 500 then 1500 kbit/s losing 5
+// packets every 10 s, and a publisher losing 1 packet in 50.
+static void test_windows() {
+    otk_stream_stats *stats = otk_stream_stats_new(4);
+    int64_t now_ms = 1000000;
+    int subscriber = otk_stream_stats_add(stats, "subscriber", OTK_STREAM_SUBSCRIBER, now_ms);
+    int publisher = otk_stream_stats_add(stats, "publisher", OTK_STREAM_PUBLISHER, now_ms);
+    OTK_CHECK(subscriber >= 0 && publisher >= 0);
+    int64_t bytes = 0, packets = 0, lost = 0;
+    for (int i = 0; i < 120 * 30; i++) {
+        now_ms += 33;
+        otk_stream_stats_add_frame(stats, subscriber, now_ms);
+        if (i % 30 == 0) {
+            int kbps = i < 60 * 30 ? 500 : 1500;
+            bytes += kbps * 1000 / 8;
+            packets += 100;
+            lost += (i / 30) % 10 == 0 ? 5 : 0;
+            otk_stream_stats_add_counters(stats, subscriber, OTK_STREAM_VIDEO, packets, lost, bytes, now_ms);
+            otk_stream_stats_add_counters(stats, publisher, OTK_STREAM_VIDEO, i / 30 * 50, i / 30, i / 30 * 40000, now_ms);
+        }
+    }
+
+    // Counters are 990 ms apart, hence the odd bitrates.
+    otk_stats_summary summary;
+    OTK_CHECK(otk_stream_stats_get_summary(stats, subscriber, OTK_METRIC_VIDEO_BITRATE_KBPS, OTK_WINDOW_10S, now_ms, &summary));
+    OTK_CHECK(summary.samples == 10);
+    OTK_CHECK_NEAR(summary.average, 1515.15, 0.01);
+    OTK_CHECK_NEAR(summary.p50, 1515.15, 1515.15 * 0.2);
+    otk_stream_stats_get_summary(stats, subscriber, OTK_METRIC_VIDEO_BITRATE_KBPS, OTK_WINDOW_60S, now_ms, &summary);
+    OTK_CHECK_NEAR(summary.samples, 60, 1);
+    OTK_CHECK_NEAR(summary.minimum, 505.05, 0.01);
+    OTK_CHECK_NEAR(summary.maximum, 1515.15, 0.01);
+
+    otk_stream_stats_get_summary(stats, subscriber, OTK_METRIC_VIDEO_PACKET_LOSS_PERCENT, OTK_WINDOW_10S, now_ms, &summary);
+    OTK_CHECK_NEAR(summary.maximum, 100.0 * 5 / 105, 0.01);
+    OTK_CHECK_NEAR(summary.average, 100.0 * 5 / 105 / 10, 0.01);
+    OTK_CHECK(summary.p50 == 0);
+    otk_stream_stats_get_summary(stats, publisher, OTK_METRIC_VIDEO_PACKET_LOSS_PERCENT, OTK_WINDOW_60S, now_ms, &summary);
+    OTK_CHECK_NEAR(summary.average, 2, 0.01);
+
+    otk_stream_stats_get_summary(stats, subscriber, OTK_METRIC_FRAME_RATE, OTK_WINDOW_1S, now_ms, &summary);
+    OTK_CHECK(summary.samples == 1);
+    OTK_CHECK_NEAR(summary.average, 30, 1);
+    otk_stream_stats_get_summary(stats, subscriber, OTK_METRIC_FRAME_RATE, OTK_WINDOW_60S, now_ms, &summary);
+    OTK_CHECK(summary.samples == 60);
+    OTK_CHECK_NEAR(summary.average, 30, 1);
+
+    otk_stream_stats_get_summary(stats, subscriber, OTK_METRIC_AUDIO_BITRATE_KBPS, OTK_WINDOW_60S, now_ms, &summary);
+    OTK_CHECK(summary.samples == 0);
+    otk_stream_stats_delete(stats);
+}
+
+static void test_slots() {
+    otk_stream_stats *stats = otk_stream_stats_new(2);
+    int first = otk_stream_stats_add(stats, "a", OTK_STREAM_SUBSCRIBER, 0);
+    OTK_CHECK(otk_stream_stats_add(stats, "b", OTK_STREAM_SUBSCRIBER, 0) >= 0);
+    OTK_CHECK(otk_stream_stats_add(stats, "c", OTK_STREAM_SUBSCRIBER, 0) == -1);
+    otk_stream_stats_remove(stats, first);
+    otk_stats_summary summary;
+    OTK_CHECK(!otk_stream_stats_get_summary(stats, first, OTK_METRIC_FRAME_RATE, OTK_WINDOW_1S, 0, &summary));
+    OTK_CHECK(otk_stream_stats_add(stats, "c", OTK_STREAM_SUBSCRIBER, 0) == first);
+    OTK_CHECK(!otk_stream_stats_get_summary(stats, 7, OTK_METRIC_FRAME_RATE, OTK_WINDOW_1S, 0, &summary));
+    otk_stream_stats_delete(stats);
+}
+
+// Stream ids are arbitrary strings; both exports must stay parseable.
+static void test_export_escaping() {
+    otk_stream_stats *stats = otk_stream_stats_new(4);
+    const char *id = "a\"b\\c\nd\x01";
+    int slot = otk_stream_stats_add(stats, id, OTK_STREAM_SUBSCRIBER, 1000);
+    for (int i = 0; i < 90; i++) {
+        otk_stream_stats_add_frame(stats, slot, 1000 + i * 33);
+        otk_stream_stats_add_counters(stats, slot, OTK_STREAM_VIDEO, i * 10, 0, i * 1000, 1000 + i * 33);
+    }
+
+    OTK_CHECK(!json_checker::valid("{\"id\":\"a\nb\"}"));
+    OTK_CHECK(!json_checker::valid("{\"avg\":nan}"));
+    std::string json = export_json(stats, 5000);
+    OTK_CHECK(json_checker::valid(json.c_str()));
+    OTK_CHECK(json.find("\"id\":\"a\\\"b\\\\c\\nd\\u0001\"") != std::string::npos);
+
+    std::string prometheus = export_prometheus(stats, 5000);
+    std::istringstream lines(prometheus);
+    int samples = 0, malformed = 0;
+    for (std::string line; std::getline(lines, line);) {
+        if (line.rfind("# TYPE otk_stream_", 0) == 0) {
+            continue;
+        }
+        samples++;
+        size_t labels = line.find("{stream=\"a\\\"b\\\\c\\nd\x01\",role=\"subscriber\",");
+        size_t value = line.rfind("} ");
+        if (line.rfind("otk_stream_", 0) != 0 || labels == std::string::npos || value == std::string::npos) {
+            malformed++;
+            continue;
+        }
+        char *end;
+        std::strtod(line.c_str() + value + 2, &end);
+        if (*end != '\0') {
+            malformed++;
+        }
+    }
+    OTK_CHECK(samples > 0);
+    OTK_CHECK(malformed == 0);
+
+    // Like snprintf.
+    char small[16];
+    size_t length = otk_stream_stats_export_json(stats, 5000, small, sizeof(small));
+    OTK_CHECK(length == json.size());
+    OTK_CHECK(std::strlen(small) == sizeof(small) - 1);
+    OTK_CHECK(json.compare(0, sizeof(small) - 1, small) == 0);
+    otk_stream_stats_delete(stats);
+}
+
+static void benchmark_updates() {
+    const int streams = 500;
+    otk_stream_stats *stats = otk_stream_stats_new(streams);
+    std::vector<int> slots;
+    for (int i = 0; i < streams; i++) {
+        slots.push_back(otk_stream_stats_add(stats, ("stream-" + std::to_string(i)).c_str(), OTK_STREAM_SUBSCRIBER, 0));
+    }
+    std::mt19937 random(5);
+    std::vector<int64_t> bytes(streams, 0);
+    int64_t updates = 0;
+    int64_t now_ms = 0;
+    int64_t start = otk_test_now_ns();
+    for (int second = 0; second < 120; second++) {
+        for (int frame = 0; frame < 30; frame++) {
+            now_ms = second * 1000 + frame * 33;
+            for (int slot : slots) {
+                otk_stream_stats_add_frame(stats, slot, now_ms);
+                updates++;
+            }
+        }
+        for (int i = 0; i < streams; i++) {
+            bytes[i] += 60000 + random() % 1000;
+            otk_stream_stats_add_counters(stats, slots[i], OTK_STREAM_VIDEO, bytes[i] / 1000, bytes[i] / 100000, bytes[i], now_ms);
+            otk_stream_stats_add_counters(stats, slots[i], OTK_STREAM_AUDIO, bytes[i] / 1000, 0, bytes[i] / 10, now_ms);
+            updates += 2;
+        }
+    }
+    int64_t update_ns = otk_test_now_ns() - start;
+    std::vector<char> buffer(1 << 24);
+    start = otk_test_now_ns();
+    size_t length = otk_stream_stats_export_prometheus(stats, now_ms, buffer.data(), buffer.size());
+    int64_t export_ns = otk_test_now_ns() - start;
+    std::printf("%d streams: %.1f ns/update including the second rollovers, "
+                "Prometheus export of %zu bytes in %.2f ms\n",
+                streams, (double)update_ns / updates, length, export_ns / 1e6);
+    otk_stream_stats_delete(stats);
+}
+
+int main(int argc, char **argv) {
+    otk_test_init(argc, argv);
+    test_windows();
+    test_slots();
+    test_export_escaping();
+    if (otk_test_benchmarking) {
+        benchmark_updates();
+    }
+    return otk_test_result();
+}
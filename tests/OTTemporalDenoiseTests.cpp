@@ -0,0 +1,265 @@
+//
+//  OTTemporalDenoiseTests.cpp
+//  tests
+//
+//  Copyright (c) 2026 Vonage. All rights reserved.
+//
+
+#include "OTTemporalDenoise.h"
+#include "OTTest.h"
+
+#include <algorithm>
+#include <random>
+#include <vector>
+
+// Scalar reference of the filter, updating the previous output as it goes.
+static void reference_denoise(std::vector<uint8_t> &frame, std::vector<uint8_t> &previous,
+                              int threshold, int strength) {
+    uint32_t slope = threshold ? std::min<uint32_t>(65535, 512u * strength / threshold) : 0;
+    for (size_t i = 0; i < frame.size(); i++) {
+        int current = frame[i];
+        int before = previous[i];
+        int difference = std::abs(current - before);
+        uint32_t remaining = difference < threshold ? threshold - difference : 0;
+        uint32_t k = std::min<uint32_t>(strength, (remaining * slope) >> 8);
+        frame[i] = previous[i] = (uint8_t)((current * (256 - k) + before * k + 128) >> 8);
+    }
+}
+
+static double psnr(const std::vector<uint8_t> &a, const std::vector<uint8_t> &b) {
+    double squared_error = 0;
+    for (size_t i = 0; i < a.size(); i++) {
+        double error = a[i] - b[i];
+        squared_error += error * error;
+    }
+    return 10 * std::log10(255.0 * 255.0 / std::max(squared_error / a.size(), 1e-9));
+}
+
+// Mean SSIM over 8x8 blocks.
+static double ssim(const std::vector<uint8_t> &a, const std::vector<uint8_t> &b, int width, int height) {
+    const double c1 = 6.5025, c2 = 58.5225;
+    double total = 0;
+    int blocks = 0;
+    for (int by = 0; by + 8 <= height; by += 8) {
+        for (int bx = 0; bx + 8 <= width; bx += 8) {
+            double mean_a = 0, mean_b = 0;
+            for (int y = 0; y < 8; y++) {
+                for (int x = 0; x < 8; x++) {
+                    mean_a += a[(by + y) * width + bx + x];
+                    mean_b += b[(by + y) * width + bx + x];
+                }
+            }
+            mean_a /= 64;
+            mean_b /= 64;
+            double variance_a = 0, variance_b = 0, covariance = 0;
+            for (int y = 0; y < 8; y++) {
+                for (int x = 0; x < 8; x++) {
+                    double da = a[(by + y) * width + bx + x] - mean_a;
+                    double db = b[(by + y) * width + bx + x] - mean_b;
+                    variance_a += da * da;
+                    variance_b += db * db;
+                    covariance += da * db;
+                }
+            }
+            variance_a /= 63;
+            variance_b /= 63;
+            covariance /= 63;
+            total += ((2 * mean_a * mean_b + c1) * (2 * covariance + c2)) /
+                     ((mean_a * mean_a + mean_b * mean_b + c1) * (variance_a + variance_b + c2));
+            blocks++;
+        }
+    }
+    return total / blocks;
+}
+
+// Six frames of a random walk with padded rows, against the reference.
+// Returns the number of differing bytes, padding included.
+static int compare_with_reference(std::mt19937 &random, int width, int height, uint32_t threads) {
+    const uint8_t kPadding = 0x5a;
+    int chroma_width = (width + 1) / 2;
+    int chroma_height = (height + 1) / 2;
+    int y_stride = width + 5;
+    int c_stride = chroma_width + 3;
+    otk_denoise_params params = otk_temporal_denoise_default_params();
+    otk_temporal_denoise *denoise = otk_temporal_denoise_new(&params, threads);
+    std::vector<uint8_t> previous_y, previous_u, previous_v;
+    int differences = 0;
+    for (int frame = 0; frame < 6; frame++) {
+        std::vector<uint8_t> y(y_stride * height, kPadding);
+        std::vector<uint8_t> u(c_stride * chroma_height, kPadding);
+        std::vector<uint8_t> v(c_stride * chroma_height, kPadding);
+        std::vector<uint8_t> expected_y(width * height);
+        std::vector<uint8_t> expected_u(chroma_width * chroma_height);
+        std::vector<uint8_t> expected_v(chroma_width * chroma_height);
+        for (int row = 0; row < height; row++) {
+            for (int x = 0; x < width; x++) {
+                // Mostly small steps, under the threshold, some over it.
+                int value = frame == 0 ? (int)(random() % 256) : previous_y[row * width + x] + (int)(random() % 41) - 20;
+                expected_y[row * width + x] = y[row * y_stride + x] = (uint8_t)std::clamp(value, 0, 255);
+            }
+        }
+        for (int row = 0; row < chroma_height; row++) {
+            for (int x = 0; x < chroma_width; x++) {
+                expected_u[row * chroma_width + x] = u[row * c_stride + x] = (uint8_t)random();
+                expected_v[row * chroma_width + x] = v[row * c_stride + x] = (uint8_t)random();
+            }
+        }
+        if (frame == 0) {
+            previous_y = expected_y;
+            previous_u = expected_u;
+            previous_v = expected_v;
+        } else {
+            reference_denoise(expected_y, previous_y, params.luma_threshold, params.strength);
+            reference_denoise(expected_u, previous_u, params.chroma_threshold, params.strength);
+            reference_denoise(expected_v, previous_v, params.chroma_threshold, params.strength);
+        }
+        otk_temporal_denoise_process(denoise, y.data(), y_stride, u.data(), c_stride, v.data(), c_stride,
+                                     width, height);
+        for (int row = 0; row < height; row++) {
+            for (int x = 0; x < y_stride; x++) {
+                differences += y[row * y_stride + x] != (x < width ? expected_y[row * width + x] : kPadding);
+            }
+        }
+        for (int row = 0; row < chroma_height; row++) {
+            for (int x = 0; x < c_stride; x++) {
+                differences += u[row * c_stride + x] != (x < chroma_width ? expected_u[row * chroma_width + x] : kPadding);
+                differences += v[row * c_stride + x] != (x < chroma_width ? expected_v[row * chroma_width + x] : kPadding);
+            }
+        }
+    }
+    otk_temporal_denoise_delete(denoise);
+    return differences;
+}
+
+static void test_matches_reference() {
+    std::mt19937 random(11);
+    const int sizes[][2] = { { 1, 1 }, { 2, 2 }, { 15, 3 }, { 17, 9 }, { 33, 31 }, { 640, 360 } };
+    for (const auto &size : sizes) {
+        for (uint32_t threads : { 1u, 3u }) {
+            int differences = compare_with_reference(random, size[0], size[1], threads);
+            if (differences != 0) {
+                std::fprintf(stderr, "%dx%d, %u threads: %d bytes differ\n", size[0], size[1], threads, differences);
+            }
+            OTK_CHECK(differences == 0);
+        }
+    }
+}
+
+// A textured still background with a bright square moving across it, plus
+// Gaussian noise: the background gets cleaner and the square does not ghost.
+static void test_noisy_clip_quality() {
+    const int width = 320, height = 240;
+    std::mt19937 random(1);
+    std::normal_distribution<double> noise(0, 4);
+    otk_temporal_denoise *denoise = otk_temporal_denoise_new(nullptr, 2);
+    std::vector<uint8_t> u(160 * 120, 128), v(160 * 120, 128);
+    double psnr_in = 0, psnr_out = 0, ssim_in = 0, ssim_out = 0, square_error = 0;
+    int measured = 0;
+    for (int frame = 0; frame < 60; frame++) {
+        std::vector<uint8_t> clean(width * height), noisy(width * height);
+        int square_x = (frame * 6) % (width - 40);
+        for (int y = 0; y < height; y++) {
+            for (int x = 0; x < width; x++) {
+                int value = (int)(80 + 40 * std::sin(x * 0.05) * std::cos(y * 0.07));
+                if (x >= square_x && x < square_x + 40 && y >= 100 && y < 140) {
+                    value = 220;
+                }
+                clean[y * width + x] = (uint8_t)value;
+                noisy[y * width + x] = (uint8_t)std::clamp((int)std::lround(value + noise(random)), 0, 255);
+            }
+        }
+        std::vector<uint8_t> out = noisy;
+        otk_temporal_denoise_process(denoise, out.data(), width, u.data(), 160, v.data(), 160, width, height);
+        // Once the filter has settled.
+        if (frame < 10) {
+            continue;
+        }
+        psnr_in += psnr(clean, noisy);
+        psnr_out += psnr(clean, out);
+        ssim_in += ssim(clean, noisy, width, height);
+        ssim_out += ssim(clean, out, width, height);
+        double error = 0;
+        for (int y = 100; y < 140; y++) {
+            for (int x = square_x; x < square_x + 40; x++) {
+                error += std::abs(out[y * width + x] - clean[y * width + x]);
+            }
+        }
+        square_error += error / (40 * 40);
+        measured++;
+    }
+    psnr_in /= measured;
+    psnr_out /= measured;
+    ssim_in /= measured;
+    ssim_out /= measured;
+    square_error /= measured;
+    if (otk_test_benchmarking) {
+        std::printf("noisy clip: PSNR %.2f -> %.2f dB, SSIM %.4f -> %.4f, moving square error %.2f\n",
+                    psnr_in, psnr_out, ssim_in, ssim_out, square_error);
+    }
+    OTK_CHECK(psnr_out > psnr_in + 4);
+    OTK_CHECK(ssim_out > ssim_in + 0.08);
+    // Noise with a sigma of 4 alone is about 3.2 on average.
+    OTK_CHECK(square_error < 3);
+    otk_denoise_stats stats;
+    otk_temporal_denoise_get_stats(denoise, &stats);
+    OTK_CHECK(stats.frames == 60);
+    OTK_CHECK(stats.motion_ratio > 0 && stats.motion_ratio < 0.05);
+    otk_temporal_denoise_delete(denoise);
+}
+
+// The first frame after a reset or a size change, and any frame at strength
+// 0, passes through untouched.
+static void test_pass_through() {
+    std::vector<uint8_t> y(64 * 48), u(32 * 24, 128), v(32 * 24, 128);
+    otk_temporal_denoise *denoise = otk_temporal_denoise_new(nullptr, 1);
+    auto process = [&](uint8_t value, uint32_t width, uint32_t height) {
+        std::fill(y.begin(), y.end(), value);
+        otk_temporal_denoise_process(denoise, y.data(), width, u.data(), width / 2, v.data(), width / 2, width, height);
+        return y[0];
+    };
+    OTK_CHECK(process(100, 64, 48) == 100);
+    OTK_CHECK(process(104, 64, 48) < 104);
+    otk_temporal_denoise_reset(denoise);
+    OTK_CHECK(process(104, 64, 48) == 104);
+    OTK_CHECK(process(100, 32, 24) == 100);
+
+    otk_denoise_params off = { 0, 16, 10 };
+    otk_temporal_denoise_set_params(denoise, &off);
+    OTK_CHECK(process(104, 32, 24) == 104);
+    OTK_CHECK(!otk_temporal_denoise_process(denoise, nullptr, 32, u.data(), 16, v.data(), 16, 32, 24));
+    otk_temporal_denoise_delete(denoise);
+}
+
+static void benchmark_denoise() {
+    std::mt19937 random(3);
+    const int sizes[][2] = { { 1280, 720 }, { 1920, 1080 } };
+    for (const auto &size : sizes) {
+        int width = size[0], height = size[1];
+        std::vector<uint8_t> y(width * height), u(width * height / 4), v(width * height / 4);
+        for (uint8_t &value : y) {
+            value = (uint8_t)random();
+        }
+        for (uint32_t threads : { 1u, 2u, 4u }) {
+            otk_temporal_denoise *denoise = otk_temporal_denoise_new(nullptr, threads);
+            const int iterations = 200;
+            int64_t start = otk_test_now_ns();
+            for (int i = 0; i < iterations; i++) {
+                otk_temporal_denoise_process(denoise, y.data(), width, u.data(), width / 2, v.data(), width / 2, width, height);
+            }
+            std::printf("%dx%d, %u threads: %.3f ms/frame\n", width, height, threads,
+                        (double)(otk_test_now_ns() - start) / iterations / 1e6);
+            otk_temporal_denoise_delete(denoise);
+        }
+    }
+}
+
+int main(int argc, char **argv) {
+    otk_test_init(argc, argv);
+    test_matches_reference();
+    test_noisy_clip_quality();
+    test_pass_through();
+    if (otk_test_benchmarking) {
+        benchmark_denoise();
+    }
+    return otk_test_result();
+}
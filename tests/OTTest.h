@@ -0,0 +1,70 @@
+//
+//  OTTest.h
+//  tests
+//
+//  Copyright (c) 2026 Vonage. All rights reserved.
+//
+
+#ifndef OTTest_h
+#define OTTest_h
+
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+
+/*
+ * Checks for the tests of the samples' portable modules. Each test is its
+ * own executable: a failed check is reported with its line and the test
+ * carries on, and main returns otk_test_result(), non-zero if any failed.
+ * Run a test with --benchmark to also print its timings.
+ */
+
+static int otk_test_failures = 0;
+static bool otk_test_benchmarking = false;
+
+#define OTK_CHECK(condition)                                                   \
+    do {                                                                       \
+        if (!(condition)) {                                                    \
+            std::fprintf(stderr, "%s:%d: check failed: %s\n", __FILE__,        \
+                         __LINE__, #condition);                                \
+            otk_test_failures++;                                               \
+        }                                                                      \
+    } while (0)
+
+#define OTK_CHECK_NEAR(value, expected, tolerance)                             \
+    do {                                                                       \
+        double otk_value_ = (double)(value);                                   \
+        double otk_expected_ = (double)(expected);                             \
+        if (!(std::fabs(otk_value_ - otk_expected_) <= (double)(tolerance))) { \
+            std::fprintf(stderr, "%s:%d: check failed: %s is %g, expected "    \
+                         "%g within %g\n", __FILE__, __LINE__, #value,         \
+                         otk_value_, otk_expected_, (double)(tolerance));      \
+            otk_test_failures++;                                               \
+        }                                                                      \
+    } while (0)
+
+/** Reads the command line; call first in main. */
+static inline void otk_test_init(int argc, char **argv) {
+    for (int i = 1; i < argc; i++) {
+        if (std::strcmp(argv[i], "--benchmark") == 0) {
+            otk_test_benchmarking = true;
+        }
+    }
+}
+
+static inline int otk_test_result(void) {
+    if (otk_test_failures > 0) {
+        std::fprintf(stderr, "%d checks failed\n", otk_test_failures);
+        return 1;
+    }
+    return 0;
+}
+
+/** Monotonic clock in nanoseconds, for benchmarks. */
+static inline int64_t otk_test_now_ns(void) {
+    return (int64_t)std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+#endif /* OTTest_h */
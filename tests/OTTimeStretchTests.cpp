@@ -0,0 +1,246 @@
+//
+//  OTTimeStretchTests.cpp
+//  tests
+//
+//  Copyright (c) 2026 Vonage. All rights reserved.
+//
+
+#include "OTTimeStretch.h"
+#include "OTTest.h"
+
+#include <algorithm>
+#include <deque>
+#include <vector>
+
+static const int kRate = 44100;
+static const size_t kFrames = 512;
+
+// Stands in for the SDK: returns only the audio it has, unless it makes
+// audio on demand.
+struct source {
+    std::deque<int16_t> queue;
+    bool on_demand = false;
+    bool noise = false;
+    size_t generated = 0;
+    uint32_t seed = 1;
+
+    // Noise, or a 220 Hz tone with harmonics like a voice.
+    int16_t sample() {
+        if (noise) {
+            seed = seed * 1664525u + 1013904223u;
+            generated++;
+            return (int16_t)(((int32_t)(seed >> 16) - 32768) / 4);
+        }
+        double t = (double)generated++ / kRate;
+        double value = 0;
+        for (int harmonic = 1; harmonic <= 5; harmonic++) {
+            value += std::sin(2 * M_PI * 220 * harmonic * t) / harmonic;
+        }
+        return (int16_t)(value * 6000);
+    }
+
+    void produce(size_t frames) {
+        for (size_t i = 0; i < frames; i++) {
+            queue.push_back(sample());
+        }
+    }
+
+    size_t read(int16_t *data, size_t frames) {
+        if (on_demand && frames > queue.size()) {
+            produce(frames - queue.size());
+        }
+        size_t count = std::min(frames, queue.size());
+        std::copy(queue.begin(), queue.begin() + count, data);
+        queue.erase(queue.begin(), queue.begin() + count);
+        return count;
+    }
+};
+
+// One device callback, as the audio driver makes it.
+static void render(otk_time_stretch *stretch, source &sdk, std::vector<int16_t> &played) {
+    size_t wanted = otk_time_stretch_wanted(stretch, kFrames);
+    size_t received = wanted ? sdk.read(otk_time_stretch_input(stretch), wanted) : 0;
+    otk_time_stretch_commit(stretch, wanted, received);
+    int16_t out[kFrames];
+    otk_time_stretch_read(stretch, out, kFrames);
+    played.insert(played.end(), out, out + kFrames);
+}
+
+// Fundamental frequency from the autocorrelation peak between 150 and 400 Hz.
+static double pitch(const std::vector<int16_t> &samples, size_t from, size_t count) {
+    int best_lag = 0;
+    double best = -1e300;
+    for (int lag = kRate / 400; lag < kRate / 150; lag++) {
+        double sum = 0;
+        for (size_t i = from; i < from + count; i++) {
+            sum += (double)samples[i] * samples[i + lag];
+        }
+        if (sum > best) {
+            best = sum;
+            best_lag = lag;
+        }
+    }
+    return (double)kRate / best_lag;
+}
+
+// A source keeping up in real time comes out delayed but otherwise exact.
+static void test_steady_source_is_untouched() {
+    source sdk, reference;
+    sdk.noise = reference.noise = true;
+    otk_time_stretch *stretch = otk_time_stretch_new(kRate, kFrames);
+    std::vector<int16_t> played;
+    for (int i = 0; i < 400; i++) {
+        sdk.produce(kFrames);
+        render(stretch, sdk, played);
+    }
+    std::vector<int16_t> input(played.size());
+    for (int16_t &sample : input) {
+        sample = reference.sample();
+    }
+    size_t delay = 0;
+    double best = -1e300;
+    for (size_t lag = 0; lag < 4000; lag++) {
+        double sum = 0;
+        for (size_t i = 20000; i < 24000; i++) {
+            sum += (double)played[i] * input[i - lag];
+        }
+        if (sum > best) {
+            best = sum;
+            delay = lag;
+        }
+    }
+    OTK_CHECK_NEAR(delay * 1000.0 / kRate, 40, 5);
+    size_t mismatches = 0;
+    for (size_t i = delay + 4000; i < played.size(); i++) {
+        mismatches += std::abs(played[i] - input[i - delay]) > 1;
+    }
+    OTK_CHECK(mismatches == 0);
+    otk_time_stretch_stats stats;
+    otk_time_stretch_get_stats(stretch, &stats);
+    OTK_CHECK(stats.ratio == 1.0);
+    OTK_CHECK(stats.underruns == 0);
+    OTK_CHECK(stats.shed_ms == 0);
+    otk_time_stretch_delete(stretch);
+}
+
+// A 300 ms burst is drained at 5% faster without changing the pitch.
+static void test_burst_is_drained() {
+    source sdk;
+    otk_time_stretch *stretch = otk_time_stretch_new(kRate, kFrames);
+    std::vector<int16_t> played;
+    int drained_at = -1;
+    for (int i = 0; i < 1200; i++) {
+        sdk.produce(kFrames);
+        if (i == 200) {
+            sdk.produce(kRate * 3 / 10);
+        }
+        render(stretch, sdk, played);
+        otk_time_stretch_stats stats;
+        otk_time_stretch_get_stats(stretch, &stats);
+        if (i > 200 && drained_at < 0 && stats.shed_ms > 290 && stats.ratio == 1.0) {
+            drained_at = i;
+        }
+    }
+    otk_time_stretch_stats stats;
+    otk_time_stretch_get_stats(stretch, &stats);
+    OTK_CHECK(stats.shed_ms > 280 && stats.shed_ms < 330);
+    // 300 ms at 5% takes 6 s.
+    OTK_CHECK(drained_at > 0);
+    OTK_CHECK_NEAR((drained_at - 200) * (double)kFrames / kRate, 6, 0.5);
+    OTK_CHECK(stats.underruns == 0);
+    OTK_CHECK(sdk.queue.size() < kFrames);
+    OTK_CHECK_NEAR(pitch(played, kRate * 4, 4096), 220, 3);
+    otk_time_stretch_delete(stretch);
+}
+
+// A short stall is covered by stretching, a longer one concealed.
+static void test_stalls() {
+    for (int stall_ms : { 30, 150 }) {
+        source sdk;
+        otk_time_stretch *stretch = otk_time_stretch_new(kRate, kFrames);
+        std::vector<int16_t> played;
+        double produced = 0, elapsed = 0;
+        for (int i = 0; i < 800; i++) {
+            elapsed += kFrames;
+            double ms = elapsed / kRate * 1000;
+            if (ms <= 3000 || ms >= 3000 + stall_ms) {
+                sdk.produce((size_t)(elapsed - produced));
+            }
+            produced = elapsed;
+            render(stretch, sdk, played);
+        }
+        otk_time_stretch_stats stats;
+        otk_time_stretch_get_stats(stretch, &stats);
+        if (stall_ms == 30) {
+            OTK_CHECK(stats.underruns == 0);
+            OTK_CHECK(stats.stretched_ms > 5);
+        } else {
+            OTK_CHECK(stats.underruns == 1);
+            OTK_CHECK(stats.concealed_ms > 50);
+        }
+        OTK_CHECK(stats.ratio == 1.0);
+        otk_time_stretch_delete(stretch);
+    }
+}
+
+// A source that always has more stops being drained once the cap is shed.
+static void test_on_demand_source() {
+    source sdk;
+    sdk.on_demand = true;
+    otk_time_stretch *stretch = otk_time_stretch_new(kRate, kFrames);
+    std::vector<int16_t> played;
+    for (int i = 0; i < 3000; i++) {
+        render(stretch, sdk, played);
+    }
+    otk_time_stretch_stats stats;
+    otk_time_stretch_get_stats(stretch, &stats);
+    OTK_CHECK(stats.shed_ms <= 520);
+    OTK_CHECK(stats.ratio == 1.0);
+    // Reset by the audio thread on its next callback.
+    otk_time_stretch_reset(stretch);
+    size_t wanted = otk_time_stretch_wanted(stretch, kFrames);
+    OTK_CHECK(wanted > kFrames);
+    otk_time_stretch_commit(stretch, wanted, 0);
+    otk_time_stretch_get_stats(stretch, &stats);
+    OTK_CHECK(stats.buffered_ms == 0);
+    otk_time_stretch_delete(stretch);
+}
+
+static void benchmark_callbacks() {
+    source sdk;
+    otk_time_stretch *stretch = otk_time_stretch_new(kRate, kFrames);
+    std::vector<int16_t> played;
+    sdk.produce(kRate);
+    for (int i = 0; i < 50; i++) {
+        render(stretch, sdk, played);
+    }
+    const int callbacks = 2000;
+    for (bool draining : { false, true }) {
+        if (draining) {
+            sdk.produce(kRate * 20);
+        }
+        played.clear();
+        int64_t start = otk_test_now_ns();
+        for (int i = 0; i < callbacks; i++) {
+            sdk.produce(kFrames);
+            render(stretch, sdk, played);
+        }
+        otk_time_stretch_stats stats;
+        otk_time_stretch_get_stats(stretch, &stats);
+        std::printf("%s: %.2f us per %zu frame callback, ratio %.2f\n", draining ? "draining" : "steady",
+                    (double)(otk_test_now_ns() - start) / callbacks / 1000, kFrames, stats.ratio);
+    }
+    otk_time_stretch_delete(stretch);
+}
+
+int main(int argc, char **argv) {
+    otk_test_init(argc, argv);
+    test_steady_source_is_untouched();
+    test_burst_is_drained();
+    test_stalls();
+    test_on_demand_source();
+    if (otk_test_benchmarking) {
+        benchmark_callbacks();
+    }
+    return otk_test_result();
+}
@@ -0,0 +1,117 @@
+//
+//  OTVideoPolicyTests.cpp
+//  tests
+//
+//  Copyright (c) 2026 Vonage. All rights reserved.
+//
+
+#include "OTVideoPolicy.h"
+#include "OTTest.h"
+
+#include <string>
+#include <vector>
+
+struct change {
+    std::string participant_id;
+    int subscribe_to_video;
+    int64_t time_ms;
+};
+
+struct policy_run {
+    otk_video_policy *policy;
+    int64_t now_ms = 0;
+    std::vector<change> changes;
+
+    static void on_change(const char *participant_id, int subscribe_to_video, void *user_data) {
+        policy_run *run = (policy_run *)user_data;
+        run->changes.push_back({ participant_id, subscribe_to_video, run->now_ms });
+    }
+
+    // Updates every 100 ms, as the sample's timer does, up to and including end_ms.
+    void run_until(int64_t end_ms) {
+        for (; now_ms <= end_ms; now_ms += 100) {
+            otk_video_policy_update(policy, now_ms, on_change, this);
+        }
+    }
+};
+
+static bool changed(const std::vector<change> &changes, size_t index,
+                    const char *participant_id, int subscribe_to_video, int64_t time_ms) {
+    return index < changes.size() && changes[index].participant_id == participant_id &&
+           changes[index].subscribe_to_video == subscribe_to_video &&
+           changes[index].time_ms == time_ms;
+}
+
+static void test_speakers_visibility_and_overrides() {
+    otk_video_policy_config config;
+    otk_video_policy_config_default(&config);
+    config.max_active_videos = 2;
+    policy_run run;
+    run.policy = otk_video_policy_new(&config);
+    for (const char *id : { "a", "b", "c" }) {
+        otk_video_policy_add(run.policy, id, 0);
+    }
+
+    // Only two videos: the last to join loses its video once the disable delay passes.
+    run.run_until(2900);
+    OTK_CHECK(run.changes.size() == 1);
+    OTK_CHECK(changed(run.changes, 0, "c", 0, 2000));
+
+    // c speaks: its video is back after the enable delay, and the oldest
+    // speaker, b, gives up its slot after the disable delay.
+    otk_video_policy_set_audio_level(run.policy, "c", 0.5f, 3000);
+    run.run_until(5900);
+    OTK_CHECK(run.changes.size() == 3);
+    OTK_CHECK(changed(run.changes, 1, "c", 1, 3300));
+    OTK_CHECK(changed(run.changes, 2, "b", 0, 5000));
+
+    // Hidden for half a second: nothing changes.
+    otk_video_policy_set_visible(run.policy, "a", 0);
+    run.run_until(6400);
+    otk_video_policy_set_visible(run.policy, "a", 1);
+    run.run_until(8900);
+    OTK_CHECK(run.changes.size() == 3);
+
+    // Hidden for good: a loses its video and b takes the slot.
+    otk_video_policy_set_visible(run.policy, "a", 0);
+    run.run_until(11900);
+    OTK_CHECK(run.changes.size() == 5);
+    OTK_CHECK(changed(run.changes, 3, "a", 0, 11000));
+    OTK_CHECK(changed(run.changes, 4, "b", 1, 11300));
+
+    // Overrides apply on the next update.
+    otk_video_policy_set_override(run.policy, "b", OTK_VIDEO_OVERRIDE_OFF);
+    run.run_until(12000);
+    OTK_CHECK(run.changes.size() == 6);
+    OTK_CHECK(changed(run.changes, 5, "b", 0, 12000));
+
+    OTK_CHECK(!otk_video_policy_is_subscribed(run.policy, "a"));
+    OTK_CHECK(!otk_video_policy_is_subscribed(run.policy, "b"));
+    OTK_CHECK(otk_video_policy_is_subscribed(run.policy, "c"));
+    otk_video_policy_delete(run.policy);
+}
+
+static void test_removed_participant_frees_its_slot() {
+    otk_video_policy_config config;
+    otk_video_policy_config_default(&config);
+    config.max_active_videos = 1;
+    policy_run run;
+    run.policy = otk_video_policy_new(&config);
+    otk_video_policy_add(run.policy, "a", 0);
+    otk_video_policy_add(run.policy, "b", 0);
+    run.run_until(2900);
+    OTK_CHECK(!otk_video_policy_is_subscribed(run.policy, "b"));
+
+    otk_video_policy_remove(run.policy, "a");
+    run.run_until(5000);
+    OTK_CHECK(otk_video_policy_is_subscribed(run.policy, "b"));
+    OTK_CHECK(!otk_video_policy_is_subscribed(run.policy, "a"));
+    otk_video_policy_delete(run.policy);
+}
+
+int main(int argc, char **argv) {
+    otk_test_init(argc, argv);
+    test_speakers_visibility_and_overrides();
+    test_removed_participant_frees_its_slot();
+    return otk_test_result();
+}